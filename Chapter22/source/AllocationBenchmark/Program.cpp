@@ -0,0 +1,222 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "AllocationCounter.h"
+#include "FrameAllocator.h"
+#include "ObjectPool.h"
+#include "GlyphTable.h"
+#include "TextLayout.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: AllocationBenchmark [-frames count] [-warmup count]\n"
+		"Runs the per-frame work converted to FrameAllocator and ObjectPool (FpsComponent's and the demos' labels formatted\n"
+		"and laid out, pooled objects acquired and released, DebugDraw's grid built in a pooled scratch vector) for 600\n"
+		"frames after 60 to warm up, by default, and counts heap allocations with AllocationCounter. It returns 1 unless the\n"
+		"steady state allocates nothing. The same labels built with std::wostringstream, and the grid in a local vector, as\n"
+		"before, are counted for comparison.\n";
+
+	const unsigned int PooledObjectCount = 64;
+	const unsigned int GridSize = 16;
+
+	typedef struct _DrawCommand
+	{
+		unsigned int Mesh;
+		unsigned int Material;
+		float Depth;
+	} DrawCommand;
+
+	typedef struct _Position
+	{
+		float X;
+		float Y;
+		float Z;
+	} Position;
+
+	// DebugDraw::DrawGrid()'s line endpoints, size cells across in the XZ plane
+	void BuildGrid(unsigned int size, std::vector<Position>& positions)
+	{
+		float maxPosition = size / 2.0f;
+		for (unsigned int i = 0; i < size + 1; i++)
+		{
+			float position = maxPosition - i;
+
+			Position endpoints[4] = { { position, 0.0f, maxPosition }, { position, 0.0f, -maxPosition }, { maxPosition, 0.0f, position }, { -maxPosition, 0.0f, position } };
+			positions.insert(positions.end(), endpoints, endpoints + 4);
+		}
+	}
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	// Printable ASCII at fixed metrics; layout cost doesn't depend on the glyphs' shapes
+	void BuildFont(GlyphTable& font)
+	{
+		std::vector<Glyph> glyphs;
+		for (unsigned int character = 32; character < 127; character++)
+		{
+			unsigned int index = character - 32;
+			Glyph glyph = { character, { static_cast<int>(index % 16) * 8, static_cast<int>(index / 16) * 16, static_cast<int>(index % 16) * 8 + 7, static_cast<int>(index / 16) * 16 + 15 }, 0.0f, 0.0f, 8.0f };
+			glyphs.push_back(glyph);
+		}
+
+		font.Build(glyphs, '?', 16.0f, 128, 128);
+	}
+
+	// TextComponent::SetText(): unchanged text keeps its layout
+	void SetText(const GlyphTable& font, const wchar_t* text, std::wstring& currentText, TextRun& run)
+	{
+		if (currentText != text)
+		{
+			currentText.assign(text);
+			TextLayout::Build(font, currentText.c_str(), 1.0f, run);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int frameCount = 600;
+	unsigned int warmupFrameCount = 60;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc)
+		{
+			frameCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-warmup") == 0 && i + 1 < argc)
+		{
+			warmupFrameCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+	}
+
+	if (AllocationCounter::IsEnabled() == false)
+	{
+		fputs("AllocationCounter.cpp must be built into the benchmark with LIBRARY_COUNT_ALLOCATIONS defined\n", stderr);
+		return 1;
+	}
+
+	GlyphTable font;
+	BuildFont(font);
+
+	FrameAllocator frameMemory;
+	ObjectPool<DrawCommand> drawCommands;
+	ObjectPool<std::vector<Position>> scratchVectors;
+	unsigned long long gridLineCount = 0;
+	std::vector<DrawCommand*> acquired;
+	acquired.reserve(PooledObjectCount);
+	std::wstring fpsText;
+	std::wstring helpText;
+	TextRun fpsRun;
+	TextRun helpRun;
+
+	printf("%u frames after %u to warm up\n\n", frameCount, warmupFrameCount);
+	printf("%-20s %12s %12s %10s\n", "path", "warmup", "allocations", "us/frame");
+
+	int result = 0;
+	for (unsigned int pass = 0; pass < 2; pass++)
+	{
+		bool isConverted = (pass == 0);
+		unsigned long long warmupAllocationCount = 0;
+		unsigned long long allocationCount = 0;
+		double elapsed = 0.0;
+
+		for (unsigned int frame = 0; frame < warmupFrameCount + frameCount; frame++)
+		{
+			unsigned long long startCount = AllocationCounter::AllocationCount();
+			auto start = std::chrono::high_resolution_clock::now();
+
+			// Every frame refreshes both labels, where FpsComponent only refreshes its own once a second
+			int frameRate = 55 + static_cast<int>(frame % 10);
+			double totalGameTime = frame / 60.0;
+			float ambientIntensity = (frame % 256) / 255.0f;
+			if (isConverted)
+			{
+				frameMemory.Reset();
+
+				const wchar_t* fpsLabel = frameMemory.Format(L"Frame Rate: %d    Total Elapsed Time: %.4g    Frame Allocations: %llu", frameRate, totalGameTime, allocationCount);
+				SetText(font, fpsLabel, fpsText, fpsRun);
+
+				const wchar_t* helpLabel = frameMemory.Format(L"Ambient Intensity (+PgUp/-PgDn): %g\nPoint Light Intensity (+Home/-End): %g\nMove Point Light (8/2, 4/6, 3/9)\n", ambientIntensity, 1.0f - ambientIntensity);
+				SetText(font, helpLabel, helpText, helpRun);
+
+				for (unsigned int i = 0; i < PooledObjectCount; i++)
+				{
+					DrawCommand* command = drawCommands.Acquire();
+					command->Mesh = i;
+					command->Material = i % 4;
+					command->Depth = static_cast<float>(frame);
+					acquired.push_back(command);
+				}
+
+				for (DrawCommand* command : acquired)
+				{
+					drawCommands.Release(command);
+				}
+
+				acquired.clear();
+
+				std::vector<Position>& positions = *scratchVectors.Acquire();
+				positions.clear();
+				BuildGrid(GridSize, positions);
+				gridLineCount += positions.size() / 2;
+				scratchVectors.Release(&positions);
+			}
+			else
+			{
+				std::wostringstream fpsLabel;
+				fpsLabel << L"Frame Rate: " << frameRate << L"    Total Elapsed Time: " << totalGameTime << L"    Frame Allocations: " << allocationCount;
+				SetText(font, fpsLabel.str().c_str(), fpsText, fpsRun);
+
+				std::wostringstream helpLabel;
+				helpLabel << L"Ambient Intensity (+PgUp/-PgDn): " << ambientIntensity << L"\nPoint Light Intensity (+Home/-End): " << 1.0f - ambientIntensity << L"\nMove Point Light (8/2, 4/6, 3/9)\n";
+				SetText(font, helpLabel.str().c_str(), helpText, helpRun);
+
+				std::vector<Position> positions;
+				positions.reserve(4 * (GridSize + 1));
+				BuildGrid(GridSize, positions);
+				gridLineCount += positions.size() / 2;
+			}
+
+			double frameTime = Milliseconds(std::chrono::high_resolution_clock::now() - start);
+			unsigned long long frameAllocationCount = AllocationCounter::AllocationCount() - startCount;
+			if (frame < warmupFrameCount)
+			{
+				warmupAllocationCount += frameAllocationCount;
+			}
+			else
+			{
+				allocationCount += frameAllocationCount;
+				elapsed += frameTime;
+			}
+		}
+
+		printf("%-20s %12llu %12llu %10.2f\n", (isConverted ? "FrameAllocator" : "wostringstream"), warmupAllocationCount, allocationCount, elapsed * 1000.0 / frameCount);
+
+		if (isConverted && allocationCount > 0)
+		{
+			fprintf(stderr, "The steady state made %llu heap allocations over %u frames; it should make none\n", allocationCount, frameCount);
+			result = 1;
+		}
+	}
+
+	printf("\n%llu grid lines built\n", gridLineCount);
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "BlurKernel.h"
+#include "BlurReference.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: BlurTool [-technique gaussian|kawase|box|auto] [-sigma texels] [-output directory] files...\n"
+		"Blurs binary PPM (P6) and PFM (PF) images with the CPU reference blur. Outputs keep the input's name and format.\n";
+
+	bool ReadImage(const std::string& filename, PostProcessImage& image, bool& isFloat)
+	{
+		FILE* file = fopen(filename.c_str(), "rb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		char magic[3] = { 0 };
+		unsigned int width = 0;
+		unsigned int height = 0;
+		bool isValid = (fscanf(file, "%2s %u %u", magic, &width, &height) == 3 && width > 0 && height > 0);
+
+		float scale = 0.0f;
+		unsigned int maximumValue = 0;
+		isFloat = (strcmp(magic, "PF") == 0);
+		if (isValid && isFloat)
+		{
+			isValid = (fscanf(file, "%f", &scale) == 1);
+		}
+		else if (isValid)
+		{
+			isValid = (strcmp(magic, "P6") == 0 && fscanf(file, "%u", &maximumValue) == 1 && maximumValue == 255);
+		}
+
+		// A single whitespace character separates the header from the texels
+		isValid = isValid && (fgetc(file) != EOF);
+
+		if (isValid)
+		{
+			PostProcessReference::ResizeImage(image, width, height);
+
+			if (isFloat)
+			{
+				// PFM rows run bottom to top; a negative scale means little-endian, which is all this tool reads
+				std::vector<float> row(width * 3);
+				for (unsigned int y = 0; isValid && y < height; y++)
+				{
+					isValid = (scale < 0.0f && fread(&row[0], sizeof(float), row.size(), file) == row.size());
+					float* texels = &image.Texels[(height - 1 - y) * width * 4];
+					for (unsigned int x = 0; isValid && x < width; x++)
+					{
+						texels[x * 4 + 0] = row[x * 3 + 0];
+						texels[x * 4 + 1] = row[x * 3 + 1];
+						texels[x * 4 + 2] = row[x * 3 + 2];
+						texels[x * 4 + 3] = 1.0f;
+					}
+				}
+			}
+			else
+			{
+				std::vector<unsigned char> row(width * 3);
+				for (unsigned int y = 0; isValid && y < height; y++)
+				{
+					isValid = (fread(&row[0], 1, row.size(), file) == row.size());
+					float* texels = &image.Texels[y * width * 4];
+					for (unsigned int x = 0; isValid && x < width; x++)
+					{
+						texels[x * 4 + 0] = row[x * 3 + 0] / 255.0f;
+						texels[x * 4 + 1] = row[x * 3 + 1] / 255.0f;
+						texels[x * 4 + 2] = row[x * 3 + 2] / 255.0f;
+						texels[x * 4 + 3] = 1.0f;
+					}
+				}
+			}
+		}
+
+		fclose(file);
+
+		return isValid;
+	}
+
+	bool WriteImage(const std::string& filename, const PostProcessImage& image, bool isFloat)
+	{
+		FILE* file = fopen(filename.c_str(), "wb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		bool isValid = true;
+		if (isFloat)
+		{
+			fprintf(file, "PF\n%u %u\n-1.0\n", image.Width, image.Height);
+
+			std::vector<float> row(image.Width * 3);
+			for (unsigned int y = 0; isValid && y < image.Height; y++)
+			{
+				const float* texels = &image.Texels[(image.Height - 1 - y) * image.Width * 4];
+				for (unsigned int x = 0; x < image.Width; x++)
+				{
+					row[x * 3 + 0] = texels[x * 4 + 0];
+					row[x * 3 + 1] = texels[x * 4 + 1];
+					row[x * 3 + 2] = texels[x * 4 + 2];
+				}
+
+				isValid = (fwrite(&row[0], sizeof(float), row.size(), file) == row.size());
+			}
+		}
+		else
+		{
+			fprintf(file, "P6\n%u %u\n255\n", image.Width, image.Height);
+
+			std::vector<unsigned char> row(image.Width * 3);
+			for (unsigned int y = 0; isValid && y < image.Height; y++)
+			{
+				const float* texels = &image.Texels[y * image.Width * 4];
+				for (unsigned int x = 0; x < image.Width * 3; x++)
+				{
+					float value = std::min(std::max(texels[(x / 3) * 4 + x % 3], 0.0f), 1.0f);
+					row[x] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+				}
+
+				isValid = (fwrite(&row[0], 1, row.size(), file) == row.size());
+			}
+		}
+
+		return (fclose(file) == 0 && isValid);
+	}
+
+	std::string Filename(const std::string& path)
+	{
+		std::string::size_type separator = path.find_last_of("\\/");
+		return (separator == std::string::npos ? path : path.substr(separator + 1));
+	}
+
+	const char* TechniqueName(BlurTechnique technique)
+	{
+		static const char* const names[] = { "gaussian", "kawase", "box" };
+		return names[technique];
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string techniqueName = "auto";
+	float sigma = 2.0f;
+	std::string outputDirectory = ".";
+	std::vector<std::string> filenames;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-technique") == 0 && i + 1 < argc)
+		{
+			techniqueName = argv[++i];
+		}
+		else if (strcmp(argv[i], "-sigma") == 0 && i + 1 < argc)
+		{
+			sigma = static_cast<float>(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-output") == 0 && i + 1 < argc)
+		{
+			outputDirectory = argv[++i];
+		}
+		else if (argv[i][0] == '-')
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+		else
+		{
+			filenames.push_back(argv[i]);
+		}
+	}
+
+	BlurTechnique requestedTechnique = BlurTechniqueEnd;
+	for (int i = 0; i < BlurTechniqueEnd; i++)
+	{
+		if (techniqueName == TechniqueName(static_cast<BlurTechnique>(i)))
+		{
+			requestedTechnique = static_cast<BlurTechnique>(i);
+		}
+	}
+
+	if (filenames.empty() || sigma <= 0.0f || (requestedTechnique == BlurTechniqueEnd && techniqueName != "auto"))
+	{
+		fputs(Usage, stderr);
+		return 1;
+	}
+
+	int failedCount = 0;
+	for (const std::string& filename : filenames)
+	{
+		PostProcessImage source;
+		bool isFloat;
+		if (ReadImage(filename, source, isFloat) == false)
+		{
+			fprintf(stderr, "%s: not a binary PPM or little-endian PFM image\n", filename.c_str());
+			failedCount++;
+			continue;
+		}
+
+		BlurTechnique technique = (requestedTechnique != BlurTechniqueEnd ? requestedTechnique : BlurKernel::SelectTechnique(sigma, source.Width, source.Height));
+
+		PostProcessImage destination;
+		BlurReference::Blur(technique, source, sigma, destination);
+
+		std::string outputFilename = outputDirectory + "/" + Filename(filename);
+		if (WriteImage(outputFilename, destination, isFloat) == false)
+		{
+			fprintf(stderr, "%s: could not be written\n", outputFilename.c_str());
+			failedCount++;
+			continue;
+		}
+
+		printf("%s: %s, sigma %g, %.0f fetches and writes -> %s\n", filename.c_str(), TechniqueName(technique), sigma,
+			BlurKernel::EstimateCost(technique, sigma, source.Width, source.Height), outputFilename.c_str());
+	}
+
+	return (failedCount > 0 ? 1 : 0);
+}
\ No newline at end of file
@@ -0,0 +1,451 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "DDSFile.h"
+#include "FrameEncoder.h"
+#include "ImageComparison.h"
+#include "PNGWriter.h"
+#include "ThreadPool.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: CaptureTool [-frames count] [-size widthxheight] [-format png|dds] [-pending count] [-threads count] [-output directory]\n"
+		"       CaptureTool -compare [-tolerance steps] [-pixels count] [-difference file.png] expected actual\n"
+		"The first form encodes an animated test pattern as FrameCapture does (120 frames of 1280x720 PNG, at most 8 pending),\n"
+		"reports how long the capturing thread was held up and whether the encoders keep up with 60 fps, and checks the files.\n"
+		"The second compares a capture with its golden image, DDS or binary PPM; images match when no more than -pixels\n"
+		"pixels (default 0) have a channel more than -tolerance steps (default 2) off. It returns 1 when they don't.\n";
+
+	const double TargetFrameTime = 1000.0 / 60.0;
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	bool ReadFile(const std::string& filename, std::vector<unsigned char>& data)
+	{
+		FILE* file = fopen(filename.c_str(), "rb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		data.resize(static_cast<size_t>(std::max(size, 0L)));
+		bool isValid = (size > 0 && fread(&data[0], 1, data.size(), file) == data.size());
+		fclose(file);
+
+		return isValid;
+	}
+
+	// A sky gradient over a scrolling checkerboard, with a ball crossing it: flat areas and hard edges, as rendered frames have
+	void DrawTestPattern(unsigned int frame, unsigned int width, unsigned int height, std::vector<unsigned char>& pixels)
+	{
+		pixels.resize(static_cast<size_t>(width) * height * 4);
+
+		float ballX = width * (0.5f + 0.4f * sinf(frame * 0.05f));
+		float ballY = height * 0.5f;
+		float ballRadius = height * 0.1f;
+		unsigned int horizon = height / 2;
+
+		for (unsigned int y = 0; y < height; y++)
+		{
+			unsigned char* row = &pixels[static_cast<size_t>(y) * width * 4];
+			for (unsigned int x = 0; x < width; x++)
+			{
+				unsigned char* texel = row + x * 4;
+				if (y < horizon)
+				{
+					texel[0] = static_cast<unsigned char>(90 + 60 * y / horizon);
+					texel[1] = static_cast<unsigned char>(140 + 60 * y / horizon);
+					texel[2] = 235;
+				}
+				else
+				{
+					bool isDark = ((((x + frame * 4) / 64) + (y / 32)) & 1) != 0;
+					texel[0] = (isDark ? 60 : 200);
+					texel[1] = (isDark ? 70 : 190);
+					texel[2] = (isDark ? 60 : 170);
+				}
+
+				float dx = x - ballX;
+				float dy = y - ballY;
+				if (dx * dx + dy * dy < ballRadius * ballRadius)
+				{
+					float shade = 1.0f - 0.6f * sqrtf(dx * dx + dy * dy) / ballRadius;
+					texel[0] = static_cast<unsigned char>(230 * shade);
+					texel[1] = static_cast<unsigned char>(60 * shade);
+					texel[2] = static_cast<unsigned char>(40 * shade);
+				}
+
+				texel[3] = 255;
+			}
+		}
+	}
+
+	// Every chunk's CRC, and the chunks in order; the deflate stream itself is checked by any PNG reader
+	bool IsValidPNG(const std::vector<unsigned char>& data)
+	{
+		const unsigned char signature[] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+		if (data.size() < sizeof(signature) || memcmp(&data[0], signature, sizeof(signature)) != 0)
+		{
+			return false;
+		}
+
+		size_t offset = sizeof(signature);
+		std::string lastChunk;
+		while (offset + 12 <= data.size())
+		{
+			size_t length = (static_cast<size_t>(data[offset]) << 24) | (data[offset + 1] << 16) | (data[offset + 2] << 8) | data[offset + 3];
+			if (offset + 12 + length > data.size())
+			{
+				return false;
+			}
+
+			const unsigned char* stored = &data[offset + 8 + length];
+			unsigned int crc = (static_cast<unsigned int>(stored[0]) << 24) | (stored[1] << 16) | (stored[2] << 8) | stored[3];
+			if (PNGWriter::Crc32(&data[offset + 4], length + 4) != crc)
+			{
+				return false;
+			}
+
+			lastChunk.assign(reinterpret_cast<const char*>(&data[offset + 4]), 4);
+			offset += 12 + length;
+		}
+
+		return (offset == data.size() && lastChunk == "IEND");
+	}
+
+	// 8-bit RGBA or BGRA DDS files, as FrameCapture writes them, or binary PPM, as BlurTool writes its CPU references
+	bool ReadImage(const std::string& filename, unsigned int& width, unsigned int& height, std::vector<unsigned char>& pixels)
+	{
+		std::vector<unsigned char> data;
+		if (ReadFile(filename, data) == false)
+		{
+			return false;
+		}
+
+		if (data.size() > 2 && data[0] == 'P' && data[1] == '6')
+		{
+			unsigned int values[3];
+			size_t offset = 2;
+			for (unsigned int i = 0; i < 3; i++)
+			{
+				while (offset < data.size() && (isspace(data[offset]) || data[offset] == '#'))
+				{
+					if (data[offset] == '#')
+					{
+						while (offset < data.size() && data[offset] != '\n')
+						{
+							offset++;
+						}
+					}
+					else
+					{
+						offset++;
+					}
+				}
+
+				values[i] = 0;
+				while (offset < data.size() && isdigit(data[offset]))
+				{
+					values[i] = values[i] * 10 + (data[offset++] - '0');
+				}
+			}
+
+			width = values[0];
+			height = values[1];
+			offset++;
+			if (values[2] != 255 || width == 0 || height == 0 || offset + static_cast<size_t>(width) * height * 3 > data.size())
+			{
+				return false;
+			}
+
+			pixels.resize(static_cast<size_t>(width) * height * 4);
+			for (size_t i = 0; i < static_cast<size_t>(width) * height; i++)
+			{
+				pixels[i * 4 + 0] = data[offset + i * 3 + 0];
+				pixels[i * 4 + 1] = data[offset + i * 3 + 1];
+				pixels[i * 4 + 2] = data[offset + i * 3 + 2];
+				pixels[i * 4 + 3] = 255;
+			}
+
+			return true;
+		}
+
+		try
+		{
+			DDSFile file(&data[0], data.size());
+			if (file.Dimension() != DDSDimensionTexture2D || FrameEncoder::IsSupportedFormat(file.Format()) == false)
+			{
+				return false;
+			}
+
+			width = file.Width();
+			height = file.Height();
+			const DDSSubresource& subresource = file.Subresource(0, 0);
+			const unsigned char* texels = file.SubresourceData(0, 0);
+
+			pixels.resize(static_cast<size_t>(width) * height * 4);
+			for (unsigned int y = 0; y < height; y++)
+			{
+				memcpy(&pixels[static_cast<size_t>(y) * width * 4], texels + static_cast<size_t>(y) * subresource.RowPitch, width * 4);
+			}
+
+			if (file.Format() == DDSFormatB8G8R8A8Unorm || file.Format() == DDSFormatB8G8R8A8UnormSrgb)
+			{
+				ImageComparison::SwapRedBlue(pixels);
+			}
+		}
+		catch (std::runtime_error&)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	int Compare(int argc, char* argv[])
+	{
+		unsigned int tolerance = 2;
+		unsigned int allowedPixelCount = 0;
+		std::string differenceFilename;
+		std::vector<std::string> filenames;
+
+		for (int i = 2; i < argc; i++)
+		{
+			if (strcmp(argv[i], "-tolerance") == 0 && i + 1 < argc)
+			{
+				tolerance = static_cast<unsigned int>(std::max(atoi(argv[++i]), 0));
+			}
+			else if (strcmp(argv[i], "-pixels") == 0 && i + 1 < argc)
+			{
+				allowedPixelCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 0));
+			}
+			else if (strcmp(argv[i], "-difference") == 0 && i + 1 < argc)
+			{
+				differenceFilename = argv[++i];
+			}
+			else if (argv[i][0] != '-')
+			{
+				filenames.push_back(argv[i]);
+			}
+			else
+			{
+				fputs(Usage, stderr);
+				return 1;
+			}
+		}
+
+		if (filenames.size() != 2)
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+
+		unsigned int widths[2];
+		unsigned int heights[2];
+		std::vector<unsigned char> images[2];
+		for (unsigned int i = 0; i < 2; i++)
+		{
+			if (ReadImage(filenames[i], widths[i], heights[i], images[i]) == false)
+			{
+				fprintf(stderr, "Could not read %s as an 8-bit RGBA DDS or PPM image\n", filenames[i].c_str());
+				return 1;
+			}
+		}
+
+		if (widths[0] != widths[1] || heights[0] != heights[1])
+		{
+			fprintf(stderr, "%s is %u x %u but %s is %u x %u\n", filenames[0].c_str(), widths[0], heights[0], filenames[1].c_str(), widths[1], heights[1]);
+			return 1;
+		}
+
+		std::vector<unsigned char> differenceImage;
+		ImageDifference difference = ImageComparison::Compare(&images[0][0], &images[1][0], widths[0], heights[0], tolerance,
+			(differenceFilename.empty() ? nullptr : &differenceImage));
+
+		bool isMatch = (difference.DifferentPixelCount <= allowedPixelCount);
+		printf("%s: %u of %u pixels differ by more than %u, at most by %u, RMS %.3f -> %s\n", filenames[1].c_str(), difference.DifferentPixelCount,
+			widths[0] * heights[0], tolerance, difference.MaximumDifference, difference.RootMeanSquare, (isMatch ? "match" : "MISMATCH"));
+
+		if (differenceFilename.empty() == false)
+		{
+			try
+			{
+				PNGWriter::Write(differenceFilename, &differenceImage[0], widths[0], heights[0], widths[0] * 4, false, true);
+			}
+			catch (std::runtime_error& ex)
+			{
+				fprintf(stderr, "%s: %s\n", differenceFilename.c_str(), ex.what());
+				return 1;
+			}
+		}
+
+		return (isMatch ? 0 : 1);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && strcmp(argv[1], "-compare") == 0)
+	{
+		return Compare(argc, argv);
+	}
+
+	unsigned int frameCount = 120;
+	unsigned int width = 1280;
+	unsigned int height = 720;
+	std::string formatName = "png";
+	unsigned int maximumPendingCount = FrameEncoder::DefaultMaximumPendingCount;
+	unsigned int threadCount = 0;
+	std::string outputDirectory = ".";
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc)
+		{
+			frameCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-size") == 0 && i + 1 < argc)
+		{
+			if (sscanf(argv[++i], "%ux%u", &width, &height) != 2 || width == 0 || height == 0)
+			{
+				fputs(Usage, stderr);
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "-format") == 0 && i + 1 < argc)
+		{
+			formatName = argv[++i];
+		}
+		else if (strcmp(argv[i], "-pending") == 0 && i + 1 < argc)
+		{
+			maximumPendingCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc)
+		{
+			threadCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-output") == 0 && i + 1 < argc)
+		{
+			outputDirectory = argv[++i];
+		}
+		else
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+	}
+
+	if (formatName != "png" && formatName != "dds")
+	{
+		fputs(Usage, stderr);
+		return 1;
+	}
+
+	ThreadPool threadPool(threadCount);
+	std::vector<std::string> filenames;
+	std::vector<unsigned char> pixels;
+	double longestHandOff = 0.0;
+	double totalHandOff = 0.0;
+	double elapsedTime;
+	unsigned int stallCount;
+	unsigned int failedCount;
+	std::string lastError;
+
+	{
+		FrameEncoder encoder(threadPool, maximumPendingCount);
+
+		// Drawing the pattern stands in for rendering; only handing frames over is the capturing thread's cost
+		auto start = std::chrono::high_resolution_clock::now();
+		for (unsigned int frame = 0; frame < frameCount; frame++)
+		{
+			char name[32];
+			sprintf(name, "/frame%05u.", frame);
+			filenames.push_back(outputDirectory + name + formatName);
+
+			DrawTestPattern(frame, width, height, pixels);
+
+			auto handOffStart = std::chrono::high_resolution_clock::now();
+			try
+			{
+				encoder.Encode(filenames.back(), width, height, DDSFormatR8G8B8A8Unorm, pixels);
+			}
+			catch (std::runtime_error& ex)
+			{
+				fprintf(stderr, "%s: %s\n", filenames.back().c_str(), ex.what());
+				return 1;
+			}
+
+			double handOff = Milliseconds(std::chrono::high_resolution_clock::now() - handOffStart);
+			longestHandOff = std::max(longestHandOff, handOff);
+			totalHandOff += handOff;
+		}
+
+		encoder.Wait();
+		elapsedTime = Milliseconds(std::chrono::high_resolution_clock::now() - start);
+		stallCount = encoder.StallCount();
+		failedCount = encoder.FailedCount();
+		lastError = encoder.LastError();
+	}
+
+	double framesPerSecond = frameCount * 1000.0 / elapsedTime;
+	printf("%u frames of %u x %u %s on %u threads, at most %u pending: %.1f frames/s, %s 60 fps\n", frameCount, width, height, formatName.c_str(),
+		threadPool.ThreadCount(), maximumPendingCount, framesPerSecond, (framesPerSecond >= 60.0 ? "sustains" : "can't sustain"));
+	printf("Handing a frame over took %.3f ms on average and %.3f ms at most (budget %.1f ms); %u frames waited for a free encoder\n",
+		totalHandOff / frameCount, longestHandOff, TargetFrameTime, stallCount);
+
+	int result = 0;
+	if (failedCount > 0)
+	{
+		fprintf(stderr, "%u frames failed to encode, the last with %s\n", failedCount, lastError.c_str());
+		result = 1;
+	}
+
+	// Every file is complete, and the last frame reads back exactly as it was drawn
+	unsigned long long totalSize = 0;
+	for (const std::string& filename : filenames)
+	{
+		std::vector<unsigned char> data;
+		if (ReadFile(filename, data) == false || (formatName == "png" && IsValidPNG(data) == false))
+		{
+			fprintf(stderr, "%s isn't a valid %s file\n", filename.c_str(), formatName.c_str());
+			result = 1;
+			continue;
+		}
+
+		totalSize += data.size();
+	}
+
+	printf("%.1f MB written, %.0f KB per frame\n", totalSize / (1024.0 * 1024.0), totalSize / 1024.0 / frameCount);
+
+	if (formatName == "dds")
+	{
+		unsigned int readWidth;
+		unsigned int readHeight;
+		std::vector<unsigned char> readPixels;
+		DrawTestPattern(frameCount - 1, width, height, pixels);
+		if (ReadImage(filenames.back(), readWidth, readHeight, readPixels) == false || readWidth != width || readHeight != height ||
+			ImageComparison::Compare(&pixels[0], &readPixels[0], width, height, 0).DifferentPixelCount != 0)
+		{
+			fprintf(stderr, "%s doesn't read back as the frame captured\n", filenames.back().c_str());
+			result = 1;
+		}
+	}
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,347 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "CascadeFitting.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: CascadeBenchmark [-iterations count] [-cascades count] [-resolution texels] [-verify]\n"
+		"Times a frame's cascade splits and fits, as ShadowCascades::Update does them, for a 45 degree, 16:9 view from 0.5 to\n"
+		"500 (default 4 cascades of 2048 x 2048 texels, best of 1000 updates), and lists each cascade's bounds. -verify also\n"
+		"checks the splits, that every fit contains its slice of the view, and that a camera walking and turning in steps\n"
+		"smaller than a texel only ever moves the sphere-fit projections in whole texels, without changing their size.\n";
+
+	const float FieldOfView = 0.78539816f;
+	const float AspectRatio = 16.0f / 9.0f;
+	const float NearPlaneDistance = 0.5f;
+	const float FarPlaneDistance = 500.0f;
+	const float SplitLambda = 0.75f;
+	const float CasterDistance = 100.0f;
+	const unsigned int SceneCount = 200;
+	const unsigned int WalkFrameCount = 300;
+
+	typedef struct _CameraPose
+	{
+		float Position[3];
+		float Direction[3];
+		float Up[3];
+		float Right[3];
+	} CameraPose;
+
+	// Fixed-seed generator, so every run fits the same views
+	float Random(unsigned int& seed)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		return (seed >> 8) / 16777216.0f;
+	}
+
+	float Dot(const float a[3], const float b[3])
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	void Cross(const float a[3], const float b[3], float result[3])
+	{
+		result[0] = a[1] * b[2] - a[2] * b[1];
+		result[1] = a[2] * b[0] - a[0] * b[2];
+		result[2] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	void Normalize(float vector[3])
+	{
+		float length = sqrtf(Dot(vector, vector));
+		for (int i = 0; i < 3; i++)
+		{
+			vector[i] /= length;
+		}
+	}
+
+	// Camera's right-handed axes: Right is Direction x Up
+	void SetDirection(float yaw, float pitch, CameraPose& pose)
+	{
+		const float worldUp[3] = { 0.0f, 1.0f, 0.0f };
+		pose.Direction[0] = sinf(yaw) * cosf(pitch);
+		pose.Direction[1] = sinf(pitch);
+		pose.Direction[2] = -cosf(yaw) * cosf(pitch);
+		Cross(pose.Direction, worldUp, pose.Right);
+		Normalize(pose.Right);
+		Cross(pose.Right, pose.Direction, pose.Up);
+	}
+
+	void FitCascades(const CameraPose& pose, const CascadeLightBasis& basis, const std::vector<float>& splitDistances, unsigned int resolution,
+		CascadeFitMode fitMode, std::vector<CascadeBounds>& cascades)
+	{
+		for (unsigned int i = 0; i < cascades.size(); i++)
+		{
+			float corners[8][3];
+			CascadeFitting::ComputeSliceCorners(pose.Position, pose.Direction, pose.Up, pose.Right, FieldOfView, AspectRatio, splitDistances[i], splitDistances[i + 1], corners);
+			CascadeFitting::FitBounds(corners, basis, resolution, fitMode, CasterDistance, cascades[i]);
+		}
+	}
+
+	// Every lambda's splits must run from the near plane to the far plane without a gap or an empty cascade, lambda 0
+	// spacing them evenly and lambda 1 by a constant ratio
+	bool VerifySplits()
+	{
+		const float lambdas[] = { 0.0f, 0.5f, 0.75f, 1.0f };
+		for (unsigned int cascadeCount = 1; cascadeCount <= 8; cascadeCount++)
+		{
+			for (float lambda : lambdas)
+			{
+				std::vector<float> splitDistances;
+				CascadeFitting::ComputeSplitDistances(NearPlaneDistance, FarPlaneDistance, cascadeCount, lambda, splitDistances);
+
+				bool isValid = (splitDistances.size() == cascadeCount + 1 && splitDistances.front() == NearPlaneDistance && splitDistances.back() == FarPlaneDistance);
+				for (unsigned int i = 0; isValid && i < cascadeCount; i++)
+				{
+					float uniform = (FarPlaneDistance - NearPlaneDistance) / cascadeCount;
+					float ratio = powf(FarPlaneDistance / NearPlaneDistance, 1.0f / cascadeCount);
+					float width = splitDistances[i + 1] - splitDistances[i];
+
+					isValid = (width > 0.0f &&
+						(lambda != 0.0f || fabs(width - uniform) <= uniform * 1e-4f) &&
+						(lambda != 1.0f || fabs(splitDistances[i + 1] / splitDistances[i] - ratio) <= ratio * 1e-4f));
+				}
+
+				if (isValid == false)
+				{
+					fprintf(stderr, "%u cascades, lambda %g: splits are not ordered from near to far as expected\n", cascadeCount, lambda);
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// Random views and lights, steep ones included: the slice corners must lie at the split distances, and each cascade's
+	// bounds must contain its slice in light space, with at least the caster distance toward the light
+	bool VerifyFits(unsigned int cascadeCount, unsigned int resolution)
+	{
+		unsigned int seed = 12345;
+		std::vector<float> splitDistances;
+		CascadeFitting::ComputeSplitDistances(NearPlaneDistance, FarPlaneDistance, cascadeCount, SplitLambda, splitDistances);
+
+		for (unsigned int scene = 0; scene < SceneCount; scene++)
+		{
+			CameraPose pose;
+			for (int i = 0; i < 3; i++)
+			{
+				pose.Position[i] = (Random(seed) * 2.0f - 1.0f) * 1000.0f;
+			}
+
+			SetDirection(Random(seed) * 6.2831853f, (Random(seed) * 2.0f - 1.0f) * 1.5f, pose);
+
+			float direction[3] = { Random(seed) * 2.0f - 1.0f, -Random(seed) - (scene % 10 == 0 ? 50.0f : 0.05f), Random(seed) * 2.0f - 1.0f };
+			CascadeLightBasis basis;
+			CascadeFitting::ComputeLightBasis(direction, basis);
+
+			const float* axes[3] = { basis.Right, basis.Up, basis.Forward };
+			for (int i = 0; i < 3; i++)
+			{
+				for (int j = 0; j < 3; j++)
+				{
+					if (fabs(Dot(axes[i], axes[j]) - (i == j ? 1.0f : 0.0f)) > 1e-5f)
+					{
+						fprintf(stderr, "scene %u: the light's axes are not orthonormal\n", scene);
+						return false;
+					}
+				}
+			}
+
+			for (unsigned int mode = 0; mode < CascadeFitModeEnd; mode++)
+			{
+				for (unsigned int i = 0; i < cascadeCount; i++)
+				{
+					float corners[8][3];
+					CascadeFitting::ComputeSliceCorners(pose.Position, pose.Direction, pose.Up, pose.Right, FieldOfView, AspectRatio, splitDistances[i], splitDistances[i + 1], corners);
+
+					CascadeBounds bounds;
+					CascadeFitting::FitBounds(corners, basis, resolution, static_cast<CascadeFitMode>(mode), CasterDistance, bounds);
+
+					for (unsigned int corner = 0; corner < 8; corner++)
+					{
+						float offset[3] = { corners[corner][0] - pose.Position[0], corners[corner][1] - pose.Position[1], corners[corner][2] - pose.Position[2] };
+						float distance = splitDistances[i + corner / 4];
+						if (fabs(Dot(offset, pose.Direction) - distance) > distance * 1e-4f + 1e-3f)
+						{
+							fprintf(stderr, "scene %u, cascade %u: corner %u is not at distance %g\n", scene, i, corner, distance);
+							return false;
+						}
+
+						// Light space is centred on the world origin, so allow for the rounding of coordinates near 1000
+						float tolerance = 1e-3f;
+						float point[3] = { Dot(corners[corner], basis.Right), Dot(corners[corner], basis.Up), Dot(corners[corner], basis.Forward) };
+						bool isInside = (point[2] - CasterDistance >= bounds.Minimum[2] - tolerance);
+						for (int axis = 0; axis < 3; axis++)
+						{
+							isInside = isInside && (point[axis] >= bounds.Minimum[axis] - tolerance && point[axis] <= bounds.Maximum[axis] + tolerance);
+						}
+
+						if (isInside == false)
+						{
+							fprintf(stderr, "scene %u, %s fit, cascade %u: corner %u lies outside the bounds\n", scene, (mode == CascadeFitModeSphere ? "sphere" : "box"), i, corner);
+							return false;
+						}
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// Walks and turns the camera in sub-texel steps. Sphere-fit bounds must keep their size exactly and only ever be moved
+	// by a whole number of texels from where they started, so a static shadow's edges never shimmer.
+	bool VerifySnapping(unsigned int cascadeCount, unsigned int resolution)
+	{
+		std::vector<float> splitDistances;
+		CascadeFitting::ComputeSplitDistances(NearPlaneDistance, FarPlaneDistance, cascadeCount, SplitLambda, splitDistances);
+
+		float direction[3] = { 0.3f, -1.0f, 0.4f };
+		CascadeLightBasis basis;
+		CascadeFitting::ComputeLightBasis(direction, basis);
+
+		CameraPose pose = { { 40.0f, 12.0f, -25.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } };
+		SetDirection(0.3f, -0.2f, pose);
+
+		std::vector<CascadeBounds> first(cascadeCount);
+		FitCascades(pose, basis, splitDistances, resolution, CascadeFitModeSphere, first);
+
+		// A seventh of the finest cascade's texel a frame
+		float step = (first[0].Maximum[0] - first[0].Minimum[0]) / resolution / 7.0f;
+		unsigned int movedCount = 0;
+
+		std::vector<CascadeBounds> cascades(cascadeCount);
+		for (unsigned int frame = 1; frame < WalkFrameCount; frame++)
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				pose.Position[i] += (pose.Right[i] * 0.8f + pose.Direction[i] * 0.6f) * step;
+			}
+
+			SetDirection(0.3f + frame * 1e-4f, -0.2f, pose);
+			FitCascades(pose, basis, splitDistances, resolution, CascadeFitModeSphere, cascades);
+
+			for (unsigned int i = 0; i < cascadeCount; i++)
+			{
+				for (int axis = 0; axis < 2; axis++)
+				{
+					float extent = first[i].Maximum[axis] - first[i].Minimum[axis];
+					float texels = (cascades[i].Minimum[axis] - first[i].Minimum[axis]) / (extent / resolution);
+					if (fabs((cascades[i].Maximum[axis] - cascades[i].Minimum[axis]) - extent) > extent * 1e-5f || fabs(texels - floorf(texels + 0.5f)) > 0.01f)
+					{
+						fprintf(stderr, "frame %u, cascade %u: the projection changed size or moved %g texels\n", frame, i, texels);
+						return false;
+					}
+
+					movedCount += (cascades[i].Minimum[axis] != first[i].Minimum[axis] ? 1 : 0);
+				}
+			}
+		}
+
+		// Walking a few dozen texels must move at least the finest cascade, or nothing was tested
+		if (movedCount == 0)
+		{
+			fputs("the walk never moved a projection\n", stderr);
+			return false;
+		}
+
+		return true;
+	}
+
+	double Microseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::micro>(duration).count();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int iterationCount = 1000;
+	unsigned int cascadeCount = 4;
+	unsigned int resolution = 2048;
+	bool isVerifying = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-iterations") == 0 && i + 1 < argc)
+		{
+			iterationCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-cascades") == 0 && i + 1 < argc)
+		{
+			cascadeCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-resolution") == 0 && i + 1 < argc)
+		{
+			resolution = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-verify") == 0)
+		{
+			isVerifying = true;
+		}
+		else
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+	}
+
+	float direction[3] = { 0.3f, -1.0f, 0.4f };
+	CameraPose pose = { { 40.0f, 12.0f, -25.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } };
+	SetDirection(0.3f, -0.2f, pose);
+
+	printf("%u cascades of %u x %u texels, best of %u updates\n\n", cascadeCount, resolution, resolution, iterationCount);
+	printf("%-8s %10s %8s %10s %10s %10s %14s\n", "fit", "update us", "cascade", "near", "far", "width", "units/texel");
+
+	for (unsigned int mode = 0; mode < CascadeFitModeEnd; mode++)
+	{
+		CascadeFitMode fitMode = static_cast<CascadeFitMode>(mode);
+		std::vector<float> splitDistances;
+		std::vector<CascadeBounds> cascades(cascadeCount);
+
+		double updateTime = 1e30;
+		for (unsigned int i = 0; i < iterationCount; i++)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			CascadeFitting::ComputeSplitDistances(NearPlaneDistance, FarPlaneDistance, cascadeCount, SplitLambda, splitDistances);
+
+			CascadeLightBasis basis;
+			CascadeFitting::ComputeLightBasis(direction, basis);
+			FitCascades(pose, basis, splitDistances, resolution, fitMode, cascades);
+			updateTime = std::min(updateTime, Microseconds(std::chrono::high_resolution_clock::now() - start));
+		}
+
+		for (unsigned int i = 0; i < cascadeCount; i++)
+		{
+			float width = std::max(cascades[i].Maximum[0] - cascades[i].Minimum[0], cascades[i].Maximum[1] - cascades[i].Minimum[1]);
+			if (i == 0)
+			{
+				printf("%-8s %10.3f", (fitMode == CascadeFitModeSphere ? "sphere" : "box"), updateTime);
+			}
+			else
+			{
+				printf("%-8s %10s", "", "");
+			}
+
+			printf(" %8u %10.2f %10.2f %10.2f %14.4f\n", i, splitDistances[i], splitDistances[i + 1], width, width / resolution);
+		}
+	}
+
+	int result = 0;
+	if (isVerifying && (VerifySplits() == false || VerifyFits(cascadeCount, resolution) == false || VerifySnapping(cascadeCount, resolution) == false))
+	{
+		fputs("cascade fitting failed verification\n", stderr);
+		result = 1;
+	}
+
+	return result;
+}
\ No newline at end of file
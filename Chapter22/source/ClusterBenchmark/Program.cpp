@@ -0,0 +1,214 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "LightClusters.h"
+#include "ThreadPool.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: ClusterBenchmark [-iterations count] [-verify] [light counts...]\n"
+		"Times LightClusters::Build for random point and spot lights in a 60 degree, 16:9 view (default 100 1000 10000 lights).\n";
+
+	const float FieldOfView = 1.0471976f;
+	const float AspectRatio = 16.0f / 9.0f;
+	const float NearPlaneDistance = 0.5f;
+	const float FarPlaneDistance = 500.0f;
+
+	// Fixed-seed generator, so every run bins the same scene
+	float Random(unsigned int& seed)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		return (seed >> 8) / 16777216.0f;
+	}
+
+	void CreateLights(unsigned int lightCount, std::vector<ClusterLight>& lights)
+	{
+		unsigned int seed = 12345;
+		float tanHalfFieldOfView = tanf(FieldOfView * 0.5f);
+
+		lights.resize(lightCount);
+		for (ClusterLight& light : lights)
+		{
+			// Spread evenly in depth over the first fifth of the view, as scenes cluster their lights near the camera
+			float depth = NearPlaneDistance + Random(seed) * FarPlaneDistance * 0.2f;
+			light.Position[0] = (Random(seed) * 2.0f - 1.0f) * depth * tanHalfFieldOfView * AspectRatio;
+			light.Position[1] = (Random(seed) * 2.0f - 1.0f) * depth * tanHalfFieldOfView;
+			light.Position[2] = depth;
+			light.Radius = 2.0f + Random(seed) * 8.0f;
+
+			float direction[3] = { Random(seed) * 2.0f - 1.0f, Random(seed) * 2.0f - 1.0f, Random(seed) * 2.0f - 1.0f };
+			float length = std::max(sqrtf(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]), 1e-3f);
+			for (int i = 0; i < 3; i++)
+			{
+				light.Direction[i] = direction[i] / length;
+			}
+
+			light.CosineOuterAngle = (Random(seed) < 0.5f ? -1.0f : 0.5f + Random(seed) * 0.45f);
+		}
+	}
+
+	// Checks the binning against a brute-force pass over every light and cluster. Binned lights must reach the cluster's
+	// bounding box; a point light that was left out must not contain any corner or the centre of the froxel itself.
+	bool Verify(const LightClusters& clusters, const std::vector<ClusterLight>& lights)
+	{
+		float tanHalfFieldOfViewY = tanf(FieldOfView * 0.5f);
+		float tanHalfFieldOfViewX = tanHalfFieldOfViewY * AspectRatio;
+		unsigned int tileCountX = clusters.TileCountX();
+		unsigned int tileCountY = clusters.TileCountY();
+		unsigned int sliceCount = clusters.SliceCount();
+
+		for (unsigned int cluster = 0; cluster < clusters.ClusterCount(); cluster++)
+		{
+			unsigned int x = cluster % tileCountX;
+			unsigned int y = (cluster / tileCountX) % tileCountY;
+			unsigned int slice = cluster / (tileCountX * tileCountY);
+
+			float nearDepth = NearPlaneDistance * powf(FarPlaneDistance / NearPlaneDistance, static_cast<float>(slice) / sliceCount);
+			float farDepth = NearPlaneDistance * powf(FarPlaneDistance / NearPlaneDistance, static_cast<float>(slice + 1) / sliceCount);
+			float left = (2.0f * x / tileCountX - 1.0f) * tanHalfFieldOfViewX;
+			float right = (2.0f * (x + 1) / tileCountX - 1.0f) * tanHalfFieldOfViewX;
+			float top = (1.0f - 2.0f * y / tileCountY) * tanHalfFieldOfViewY;
+			float bottom = (1.0f - 2.0f * (y + 1) / tileCountY) * tanHalfFieldOfViewY;
+			float minimum[3] = { std::min(left * nearDepth, left * farDepth), std::min(bottom * nearDepth, bottom * farDepth), nearDepth };
+			float maximum[3] = { std::max(right * nearDepth, right * farDepth), std::max(top * nearDepth, top * farDepth), farDepth };
+
+			float middleDepth = (nearDepth + farDepth) * 0.5f;
+			float points[9][3] =
+			{
+				{ left * nearDepth, top * nearDepth, nearDepth }, { right * nearDepth, top * nearDepth, nearDepth },
+				{ left * nearDepth, bottom * nearDepth, nearDepth }, { right * nearDepth, bottom * nearDepth, nearDepth },
+				{ left * farDepth, top * farDepth, farDepth }, { right * farDepth, top * farDepth, farDepth },
+				{ left * farDepth, bottom * farDepth, farDepth }, { right * farDepth, bottom * farDepth, farDepth },
+				{ (left + right) * 0.5f * middleDepth, (top + bottom) * 0.5f * middleDepth, middleDepth }
+			};
+
+			const ClusterRange& range = clusters.Ranges()[cluster];
+			const unsigned int* binned = clusters.LightIndices().data() + range.Offset;
+
+			for (unsigned int i = 0; i < lights.size(); i++)
+			{
+				float center[3];
+				float radius;
+				LightClusters::BoundingSphere(lights[i], center, radius);
+
+				float boxDistanceSquared = 0.0f;
+				float pointDistanceSquared = 1e30f;
+				for (int axis = 0; axis < 3; axis++)
+				{
+					float distance = std::max(std::max(minimum[axis] - center[axis], center[axis] - maximum[axis]), 0.0f);
+					boxDistanceSquared += distance * distance;
+				}
+
+				for (const float* point : points)
+				{
+					float offset[3] = { point[0] - center[0], point[1] - center[1], point[2] - center[2] };
+					pointDistanceSquared = std::min(pointDistanceSquared, offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2]);
+				}
+
+				bool isBinned = std::binary_search(binned, binned + range.Count, i);
+				bool isPointLight = (lights[i].CosineOuterAngle <= 0.0f);
+				float radiusSquared = radius * radius;
+
+				if ((isBinned && boxDistanceSquared > radiusSquared * 1.001f) || (isPointLight && isBinned == false && pointDistanceSquared < radiusSquared * 0.999f))
+				{
+					fprintf(stderr, "cluster %u, light %u: binned %d, radius squared %g\n", cluster, i, isBinned, radiusSquared);
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int iterationCount = 20;
+	bool isVerifying = false;
+	std::vector<unsigned int> lightCounts;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-iterations") == 0 && i + 1 < argc)
+		{
+			iterationCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-verify") == 0)
+		{
+			isVerifying = true;
+		}
+		else if (argv[i][0] == '-' || atoi(argv[i]) <= 0)
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+		else
+		{
+			lightCounts.push_back(static_cast<unsigned int>(atoi(argv[i])));
+		}
+	}
+
+	if (lightCounts.empty())
+	{
+		unsigned int defaultLightCounts[] = { 100, 1000, 10000 };
+		lightCounts.assign(defaultLightCounts, defaultLightCounts + 3);
+	}
+
+	ThreadPool threadPool;
+	LightClusters clusters;
+	clusters.SetProjection(FieldOfView, AspectRatio, NearPlaneDistance, FarPlaneDistance);
+
+	printf("%u x %u x %u clusters, %u worker threads, best of %u builds\n\n", clusters.TileCountX(), clusters.TileCountY(), clusters.SliceCount(), threadPool.ThreadCount(), iterationCount);
+	printf("%8s %12s %12s %14s %14s %10s\n", "lights", "serial ms", "pooled ms", "mean/cluster", "mean/occupied", "max");
+
+	int result = 0;
+	for (unsigned int lightCount : lightCounts)
+	{
+		std::vector<ClusterLight> lights;
+		CreateLights(lightCount, lights);
+
+		double serialTime = 1e30;
+		double pooledTime = 1e30;
+		for (unsigned int i = 0; i < iterationCount; i++)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			clusters.Build(lights);
+			serialTime = std::min(serialTime, Milliseconds(std::chrono::high_resolution_clock::now() - start));
+
+			start = std::chrono::high_resolution_clock::now();
+			clusters.Build(lights, &threadPool);
+			pooledTime = std::min(pooledTime, Milliseconds(std::chrono::high_resolution_clock::now() - start));
+		}
+
+		// Per-pixel lighting cost follows lights per cluster, not lightCount
+		unsigned int occupiedCount = 0;
+		for (const ClusterRange& range : clusters.Ranges())
+		{
+			occupiedCount += (range.Count > 0 ? 1 : 0);
+		}
+
+		double indexCount = static_cast<double>(clusters.LightIndices().size());
+		printf("%8u %12.3f %12.3f %14.2f %14.2f %10u\n", lightCount, serialTime, pooledTime, indexCount / clusters.ClusterCount(),
+			(occupiedCount > 0 ? indexCount / occupiedCount : 0.0), clusters.MaximumLightsPerCluster());
+
+		if (isVerifying && Verify(clusters, lights) == false)
+		{
+			fprintf(stderr, "%u lights: binning does not match the brute-force test\n", lightCount);
+			result = 1;
+		}
+	}
+
+	return result;
+}
\ No newline at end of file
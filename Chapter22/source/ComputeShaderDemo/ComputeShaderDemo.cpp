@@ -3,12 +3,11 @@
 #include "GameException.h"
 #include "Camera.h"
 #include "Utility.h"
+#include "ContentManager.h"
 #include "ComputeShaderMaterial.h"
 #include "FullScreenQuad.h"
-#include <SpriteBatch.h>
-#include <SpriteFont.h>
-#include <sstream>
-#include <iomanip>
+#include "FrameAllocator.h"
+#include "TextComponent.h"
 
 namespace Rendering
 {
@@ -17,21 +16,19 @@ namespace Rendering
 	const UINT ComputeShaderDemo::ThreadsPerGroup = 32;
 
 	ComputeShaderDemo::ComputeShaderDemo(Game& game, Camera& camera)
-		: DrawableGameComponent(game, camera), mEffect(nullptr), mMaterial(nullptr), mComputePass(nullptr),
+		: DrawableGameComponent(game, camera), mEffect(), mMaterial(nullptr), mComputePass(nullptr),
 		mOutputTexture(nullptr), mTextureSize(0.0f, 0.0f), mBlueColor(0.0f), mFullScreenQuad(nullptr), mColorTexture(nullptr),
-		mRenderStateHelper(game), mSpriteBatch(nullptr), mSpriteFont(nullptr), mTextPosition(0.0f, 40.0f), mThreadGroupCount(0, 0)
+		mRenderStateHelper(game), mHelpText(nullptr), mThreadGroupCount(0, 0)
 	{
 	}
 
 	ComputeShaderDemo::~ComputeShaderDemo()
 	{
-		DeleteObject(mSpriteFont);
-		DeleteObject(mSpriteBatch);
+		DeleteObject(mHelpText);
 		ReleaseObject(mColorTexture);
 		DeleteObject(mFullScreenQuad);
 		ReleaseObject(mOutputTexture);
 		DeleteObject(mMaterial);
-		DeleteObject(mEffect);			
 	}
 
 	void ComputeShaderDemo::Initialize()
@@ -39,8 +36,7 @@ namespace Rendering
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Initialize the material
-		mEffect = new Effect(*mGame);
-		mEffect->LoadCompiledEffect(L"Content\\Effects\\ComputeShader.cso");
+		mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\ComputeShader.cso");
 		mMaterial = new ComputeShaderMaterial();
 		mMaterial->Initialize(*mEffect);
 
@@ -101,8 +97,9 @@ namespace Rendering
 		mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&ComputeShaderDemo::UpdateRenderingMaterial, this));
 		mFullScreenQuad->Initialize();
 
-		mSpriteBatch = new SpriteBatch(mGame->Direct3DDeviceContext());
-		mSpriteFont = new SpriteFont(mGame->Direct3DDevice(), L"Content\\Fonts\\Arial_14_Regular.spritefont");
+		mHelpText = new TextComponent(*mGame);
+		mHelpText->Position() = XMFLOAT2(0.0f, 40.0f);
+		mHelpText->Initialize();
 	}
 
 	void ComputeShaderDemo::Update(const GameTime& gameTime)
@@ -132,14 +129,11 @@ namespace Rendering
 		mGame->UnbindPixelShaderResources(0, 1);
 
 		mRenderStateHelper.SaveAll();
-		mSpriteBatch->Begin();
 
-		std::wostringstream helpLabel;
-		helpLabel << std::setprecision(2) << "Color Offset: " << mBlueColor;
+		const wchar_t* helpLabel = mGame->FrameMemory().Format(L"Color Offset: %.2g", mBlueColor);
 
-		mSpriteFont->DrawString(mSpriteBatch, helpLabel.str().c_str(), mTextPosition);
-
-		mSpriteBatch->End();
+		mHelpText->SetText(helpLabel);
+		mHelpText->Draw(gameTime);
 		mRenderStateHelper.RestoreAll();
 	}
 
@@ -10,12 +10,7 @@ namespace Library
 	class Effect;
 	class Pass;
 	class FullScreenQuad;
-}
-
-namespace DirectX
-{
-	class SpriteBatch;
-	class SpriteFont;
+	class TextComponent;
 }
 
 namespace Rendering
@@ -43,7 +38,7 @@ namespace Rendering
 
 		void UpdateRenderingMaterial();
 
-		Effect* mEffect;
+		std::shared_ptr<Effect> mEffect;
 		ComputeShaderMaterial* mMaterial;		
 		Pass* mComputePass;
 		ID3D11UnorderedAccessView* mOutputTexture;		
@@ -54,9 +49,7 @@ namespace Rendering
 		ID3D11ShaderResourceView* mColorTexture;
 
 		RenderStateHelper mRenderStateHelper;
-		SpriteBatch* mSpriteBatch;
-		SpriteFont* mSpriteFont;
-		XMFLOAT2 mTextPosition;
+		TextComponent* mHelpText;
 
 		XMUINT2 mThreadGroupCount;
 	};
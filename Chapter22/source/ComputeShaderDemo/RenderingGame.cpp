@@ -11,6 +11,8 @@
 #include "SamplerStates.h"
 #include "Skybox.h"
 #include "Grid.h"
+#include "EffectCache.h"
+#include "Utility.h"
 
 #include "ComputeShaderDemo.h"
 
@@ -34,6 +36,14 @@ namespace Rendering
 
     void RenderingGame::Initialize()
     {
+		// Loaded on the worker threads while the components are created, so their Initialize() finds them ready
+		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
+		const std::wstring effectFilenames[] = { L"Content\\Effects\\BasicEffect.cso", L"Content\\Effects\\ComputeShader.cso" };
+		for (const std::wstring& effectFilename : effectFilenames)
+		{
+			mCompiledEffects->Precompile(effectFilename);
+		}
+
         if (FAILED(DirectInput8Create(mInstance, DIRECTINPUT_VERSION, IID_IDirectInput8, (LPVOID*)&mDirectInput, nullptr)))
         {
             throw GameException("DirectInput8Create() failed");
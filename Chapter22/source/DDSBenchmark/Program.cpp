@@ -0,0 +1,258 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "MappedFile.h"
+#include "DDSFile.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: DDSBenchmark [-iterations count] [-size size] [files.dds...]\n"
+		"Times header parsing and loading of DDS files, reading the whole file into memory against mapping it.\n"
+		"Without files, writes and times an uncompressed cube map with a full mip chain (default 2048 per face).\n";
+
+	const char* const SyntheticFilename = "DDSBenchmark.dds";
+	const unsigned int InitialMipSize = 128;
+
+	void WriteCubeMap(const char* filename, unsigned int size)
+	{
+		unsigned int mipCount = 1;
+		while ((size >> mipCount) > 0)
+		{
+			mipCount++;
+		}
+
+		DDSHeader header;
+		memset(&header, 0, sizeof(header));
+		header.Size = sizeof(DDSHeader);
+		header.Flags = 0x0002100F;
+		header.Width = size;
+		header.Height = size;
+		header.PitchOrLinearSize = size * 4;
+		header.MipMapCount = mipCount;
+		header.PixelFormat.Size = sizeof(DDSPixelFormat);
+		header.PixelFormat.Flags = 0x00000041;
+		header.PixelFormat.RGBBitCount = 32;
+		header.PixelFormat.RBitMask = 0x000000FF;
+		header.PixelFormat.GBitMask = 0x0000FF00;
+		header.PixelFormat.BBitMask = 0x00FF0000;
+		header.PixelFormat.ABitMask = 0xFF000000;
+		header.Caps = 0x00401008;
+		header.Caps2 = 0x0000FE00;
+
+		std::ofstream file(filename, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(&DDSFile::MagicNumber), sizeof(DDSFile::MagicNumber));
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		std::vector<unsigned char> row(size * 4);
+		for (unsigned int face = 0; face < 6; face++)
+		{
+			for (unsigned int mip = 0; mip < mipCount; mip++)
+			{
+				unsigned int mipSize = std::max(size >> mip, 1U);
+				for (unsigned int y = 0; y < mipSize; y++)
+				{
+					for (unsigned int x = 0; x < mipSize * 4; x++)
+					{
+						row[x] = static_cast<unsigned char>(face * 40 + mip * 8 + (x ^ y));
+					}
+
+					file.write(reinterpret_cast<const char*>(&row[0]), mipSize * 4);
+				}
+			}
+		}
+
+		if (!file)
+		{
+			throw std::runtime_error("Could not write the synthetic cube map.");
+		}
+	}
+
+	// The old loader's approach: one heap buffer holding the whole file
+	void ReadFile(const char* filename, std::vector<unsigned char>& data)
+	{
+		std::ifstream file(filename, std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			throw std::runtime_error("Could not open file.");
+		}
+
+		std::streamoff size = file.tellg();
+		file.seekg(0);
+		data.resize(static_cast<size_t>(size));
+		if (size > 0 && !file.read(reinterpret_cast<char*>(&data[0]), size))
+		{
+			throw std::runtime_error("Could not read file.");
+		}
+	}
+
+	unsigned int MipForSize(const DDSFile& file, unsigned int size)
+	{
+		unsigned int mip = 0;
+		while (mip + 1 < file.MipCount() && (file.Subresource(0, mip).Width > size || file.Subresource(0, mip).Height > size))
+		{
+			mip++;
+		}
+
+		return mip;
+	}
+
+	unsigned int PrefetchMips(const MappedFile& mappedFile, const DDSFile& file, unsigned int firstMip, unsigned int lastMip)
+	{
+		unsigned int checksum = 0;
+		for (unsigned int item = 0; item < file.ItemCount(); item++)
+		{
+			unsigned long long offset;
+			unsigned long long size;
+			file.MipRangeExtent(item, firstMip, lastMip, offset, size);
+			checksum += mappedFile.Prefetch(offset, size);
+		}
+
+		return checksum;
+	}
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	double MegabytesPerSecond(unsigned long long size, double milliseconds)
+	{
+		return (milliseconds > 0.0 ? size / (milliseconds * 1000.0) : 0.0);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int iterationCount = 10;
+	unsigned int size = 2048;
+	std::vector<std::string> filenames;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-iterations") == 0 && i + 1 < argc)
+		{
+			iterationCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-size") == 0 && i + 1 < argc)
+		{
+			size = static_cast<unsigned int>(std::min(std::max(atoi(argv[++i]), 1), 16384));
+		}
+		else if (argv[i][0] == '-')
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+		else
+		{
+			filenames.push_back(argv[i]);
+		}
+	}
+
+	bool isSynthetic = filenames.empty();
+	if (isSynthetic)
+	{
+		try
+		{
+			WriteCubeMap(SyntheticFilename, size);
+		}
+		catch (std::runtime_error& ex)
+		{
+			fprintf(stderr, "%s\n", ex.what());
+			return 1;
+		}
+
+		filenames.push_back(SyntheticFilename);
+	}
+
+	printf("Best of %u loads; the file is in the OS cache after the first, so these time the loader rather than the disk\n\n", iterationCount);
+	printf("%-24s %8s %6s %10s %10s %12s %12s %12s %12s\n", "file", "MB", "mips", "parse us", "read MB/s", "mapped MB/s", "read ms", "mapped ms", "first mips ms");
+
+	int result = 0;
+	for (const std::string& filename : filenames)
+	{
+		try
+		{
+			std::wstring wideFilename(filename.begin(), filename.end());
+			double parseTime = 1e30;
+			double readTime = 1e30;
+			double mappedTime = 1e30;
+			double firstMipsTime = 1e30;
+			unsigned long long fileSize = 0;
+			unsigned int mipCount = 0;
+			unsigned int checksum = 0;
+
+			for (unsigned int i = 0; i < iterationCount; i++)
+			{
+				auto start = std::chrono::high_resolution_clock::now();
+				{
+					std::vector<unsigned char> data;
+					ReadFile(filename.c_str(), data);
+					DDSFile file(data.empty() ? nullptr : &data[0], data.size());
+					checksum += file.MipCount();
+				}
+				readTime = std::min(readTime, Milliseconds(std::chrono::high_resolution_clock::now() - start));
+
+				start = std::chrono::high_resolution_clock::now();
+				{
+					MappedFile mappedFile(wideFilename);
+					DDSFile file(mappedFile.Data(), mappedFile.Size());
+					checksum += PrefetchMips(mappedFile, file, 0, file.MipCount() - 1);
+				}
+				mappedTime = std::min(mappedTime, Milliseconds(std::chrono::high_resolution_clock::now() - start));
+
+				start = std::chrono::high_resolution_clock::now();
+				{
+					MappedFile mappedFile(wideFilename);
+					DDSFile file(mappedFile.Data(), mappedFile.Size());
+					checksum += PrefetchMips(mappedFile, file, MipForSize(file, InitialMipSize), file.MipCount() - 1);
+				}
+				firstMipsTime = std::min(firstMipsTime, Milliseconds(std::chrono::high_resolution_clock::now() - start));
+
+				MappedFile mappedFile(wideFilename);
+				start = std::chrono::high_resolution_clock::now();
+				DDSFile file(mappedFile.Data(), mappedFile.Size());
+				parseTime = std::min(parseTime, Milliseconds(std::chrono::high_resolution_clock::now() - start));
+
+				fileSize = mappedFile.Size();
+				mipCount = file.MipCount();
+
+				const DDSSubresource& last = file.Subresources().back();
+				if (last.Offset + last.Size != fileSize)
+				{
+					fprintf(stderr, "%s: layout ends at byte %llu of %llu\n", filename.c_str(), last.Offset + last.Size, fileSize);
+					result = 1;
+				}
+			}
+
+			printf("%-24s %8.1f %6u %10.2f %10.0f %12.0f %12.3f %12.3f %12.3f\n", filename.c_str(), fileSize / 1048576.0, mipCount, parseTime * 1000.0,
+				MegabytesPerSecond(fileSize, readTime), MegabytesPerSecond(fileSize, mappedTime), readTime, mappedTime, firstMipsTime);
+
+			// Keeps the reads from being optimized away
+			if (checksum == 0xFFFFFFFF)
+			{
+				printf("\n");
+			}
+		}
+		catch (std::runtime_error& ex)
+		{
+			fprintf(stderr, "%s: %s\n", filename.c_str(), ex.what());
+			result = 1;
+		}
+	}
+
+	if (isSynthetic)
+	{
+		remove(SyntheticFilename);
+	}
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "EffectBinary.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: EffectBenchmark [-iterations count] files.cso...\n"
+		"Checks each compiled effect's layout with EffectBinary, times finding it again the way SharedEffectCache does\n"
+		"(hash, lookup, byte compare) over 2000 iterations by default, and counts the files whose content is already\n"
+		"cached and so would share a parsed effect. Every file must validate and be found again, or it returns 1.\n";
+
+	const unsigned long long Fnv1aOffsetBasis = 14695981039346656037ULL;
+	const unsigned long long Fnv1aPrime = 1099511628211ULL;
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	unsigned long long Fnv1aHash(const unsigned char* data, size_t size)
+	{
+		unsigned long long hash = Fnv1aOffsetBasis;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ data[i]) * Fnv1aPrime;
+		}
+
+		return hash;
+	}
+
+	bool ReadFile(const std::string& filename, std::vector<unsigned char>& data)
+	{
+		FILE* file = fopen(filename.c_str(), "rb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		data.resize(static_cast<size_t>(std::max(size, 0L)));
+		bool isValid = (size > 0 && fread(&data[0], 1, data.size(), file) == data.size());
+		fclose(file);
+
+		return isValid;
+	}
+
+	const char* BaseName(const std::string& filename)
+	{
+		size_t separator = filename.find_last_of("/\\");
+
+		return filename.c_str() + (separator == std::string::npos ? 0 : separator + 1);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int iterationCount = 2000;
+	std::vector<std::string> filenames;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-iterations") == 0 && i + 1 < argc)
+		{
+			iterationCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (argv[i][0] != '-')
+		{
+			filenames.push_back(argv[i]);
+		}
+		else
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+	}
+
+	if (filenames.empty())
+	{
+		fputs(Usage, stderr);
+		return 1;
+	}
+
+	// SharedEffectCache::CreateEffect(): the blob hashed, the map searched, and a match confirmed byte for byte
+	std::map<unsigned long long, std::vector<unsigned char>> cache;
+	double totalLookupTime = 0.0;
+	unsigned int sharedCount = 0;
+
+	printf("%u iterations\n\n", iterationCount);
+	printf("%-24s %8s %4s %5s %6s %8s %5s %7s %10s %7s\n", "effect", "KB", "cbs", "vars", "types", "shaders", "tech", "passes", "lookup us", "shared");
+
+	int result = 0;
+	for (const std::string& filename : filenames)
+	{
+		std::vector<unsigned char> data;
+		if (ReadFile(filename, data) == false)
+		{
+			fprintf(stderr, "%s: could not read the file\n", filename.c_str());
+			result = 1;
+			continue;
+		}
+
+		try
+		{
+			EffectBinary effect(&data[0], data.size());
+
+			unsigned long long key = Fnv1aHash(&data[0], data.size());
+			bool isShared = (cache.find(key) != cache.end());
+			if (isShared == false)
+			{
+				cache[key] = data;
+			}
+
+			auto start = std::chrono::high_resolution_clock::now();
+			unsigned int foundCount = 0;
+			for (unsigned int i = 0; i < iterationCount; i++)
+			{
+				auto entry = cache.find(Fnv1aHash(&data[0], data.size()));
+				foundCount += (entry != cache.end() && entry->second == data ? 1 : 0);
+			}
+
+			double lookupTime = Milliseconds(std::chrono::high_resolution_clock::now() - start) * 1000.0 / iterationCount;
+			if (foundCount != iterationCount)
+			{
+				fprintf(stderr, "%s: not found in the cache\n", filename.c_str());
+				result = 1;
+			}
+
+			printf("%-24s %8.1f %4u %5u %6u %8u %5u %7u %10.2f %7s\n", BaseName(filename), data.size() / 1024.0,
+				static_cast<unsigned int>(effect.ConstantBuffers().size()), static_cast<unsigned int>(effect.Variables().size()),
+				static_cast<unsigned int>(effect.Types().size()), static_cast<unsigned int>(effect.Shaders().size()),
+				static_cast<unsigned int>(effect.Techniques().size()), static_cast<unsigned int>(effect.Passes().size()),
+				lookupTime, (isShared ? "yes" : "no"));
+
+			totalLookupTime += lookupTime;
+			sharedCount += (isShared ? 1 : 0);
+		}
+		catch (std::runtime_error& ex)
+		{
+			fprintf(stderr, "%s: %s\n", filename.c_str(), ex.what());
+			result = 1;
+		}
+	}
+
+	printf("\n%u files, %u distinct: %u loads share a parsed effect\n", static_cast<unsigned int>(filenames.size()),
+		static_cast<unsigned int>(cache.size()), sharedCount);
+	printf("Looking every file up took %.2f us\n", totalLookupTime);
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "DDSFile.h"
+#include "DistanceFieldFont.h"
+#include "SpriteFontFile.h"
+#include "TextLayout.h"
+#include "ThreadPool.h"
+#include "TrueTypeFont.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: FontTool [-size pixels] [-spread texels] [-characters first-last] [-default character] [-width texels]\n"
+		"                [-format r8|bc4] [-output file] font.ttf\n"
+		"Builds a distance field .spritefont from a TrueType font (defaults: 32 pixel em, spread 4, characters 32-126,\n"
+		"default '?', a 256 texel wide R8 atlas), written beside the font unless -output names the file. Draw it at any\n"
+		"size with a scale of size / 32; it checks the file reads back and lays out every character.\n";
+
+	typedef struct _FormatName
+	{
+		const char* Name;
+		unsigned int Format;
+	} FormatName;
+
+	const FormatName FormatNames[] =
+	{
+		{ "r8", DDSFormatR8Unorm },
+		{ "bc4", DDSFormatBC4Unorm }
+	};
+
+	const unsigned int FormatNameCount = sizeof(FormatNames) / sizeof(FormatNames[0]);
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	bool ReadFile(const std::string& filename, std::vector<unsigned char>& data)
+	{
+		FILE* file = fopen(filename.c_str(), "rb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		data.resize(static_cast<size_t>(std::max(size, 0L)));
+		bool isValid = (size > 0 && fread(&data[0], 1, data.size(), file) == data.size());
+		fclose(file);
+
+		return isValid;
+	}
+
+	bool WriteFile(const std::string& filename, const std::vector<unsigned char>& data)
+	{
+		FILE* file = fopen(filename.c_str(), "wb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		bool isValid = (fwrite(&data[0], 1, data.size(), file) == data.size());
+
+		return (fclose(file) == 0 && isValid);
+	}
+
+	std::string OutputFilename(const std::string& path)
+	{
+		std::string::size_type separator = path.find_last_of("\\/");
+		std::string::size_type extension = path.find_last_of('.');
+		if (extension == std::string::npos || (separator != std::string::npos && extension < separator))
+		{
+			extension = path.size();
+		}
+
+		return path.substr(0, extension) + ".spritefont";
+	}
+
+	// A character is a number or, quoted or not, a single letter
+	bool ParseCharacter(const char* text, unsigned int& character)
+	{
+		if (text[0] != '\0' && text[1] == '\0')
+		{
+			character = static_cast<unsigned char>(text[0]);
+			return true;
+		}
+
+		if (text[0] == '\'' && text[1] != '\0' && text[2] == '\'' && text[3] == '\0')
+		{
+			character = static_cast<unsigned char>(text[1]);
+			return true;
+		}
+
+		char* end;
+		unsigned long value = strtoul(text, &end, 0);
+		character = static_cast<unsigned int>(value);
+
+		return (end != text && *end == '\0' && value <= 0x10FFFF);
+	}
+
+	// Every glyph's padding is outside the outline, or a glyph's bounds were clipped
+	unsigned int CountClippedGlyphs(const SpriteFontData& font)
+	{
+		unsigned int count = 0;
+		for (const Glyph& glyph : font.Glyphs)
+		{
+			bool isClipped = false;
+			for (int y = glyph.Subrect[1]; y < glyph.Subrect[3] && isClipped == false; y++)
+			{
+				for (int x = glyph.Subrect[0]; x < glyph.Subrect[2]; x++)
+				{
+					bool isBorder = (x == glyph.Subrect[0] || x == glyph.Subrect[2] - 1 || y == glyph.Subrect[1] || y == glyph.Subrect[3] - 1);
+					if (isBorder && font.TextureData[static_cast<size_t>(y) * font.TextureStride + x] >= 128)
+					{
+						isClipped = true;
+						break;
+					}
+				}
+			}
+
+			count += (isClipped ? 1 : 0);
+		}
+
+		return count;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	DistanceFieldFontSettings settings = DistanceFieldFont::DefaultSettings;
+	std::string formatName = "r8";
+	std::string outputFilename;
+	std::string fontFilename;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-size") == 0 && i + 1 < argc)
+		{
+			settings.Size = static_cast<float>(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-spread") == 0 && i + 1 < argc)
+		{
+			settings.Spread = static_cast<float>(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-characters") == 0 && i + 1 < argc)
+		{
+			std::string range = argv[++i];
+			std::string::size_type separator = range.find('-', 1);
+			if (separator == std::string::npos || ParseCharacter(range.substr(0, separator).c_str(), settings.FirstCharacter) == false ||
+				ParseCharacter(range.substr(separator + 1).c_str(), settings.LastCharacter) == false)
+			{
+				fputs(Usage, stderr);
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "-default") == 0 && i + 1 < argc)
+		{
+			if (ParseCharacter(argv[++i], settings.DefaultCharacter) == false)
+			{
+				fputs(Usage, stderr);
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "-width") == 0 && i + 1 < argc)
+		{
+			settings.TextureWidth = static_cast<unsigned int>(std::max(atoi(argv[++i]), 0));
+		}
+		else if (strcmp(argv[i], "-format") == 0 && i + 1 < argc)
+		{
+			formatName = argv[++i];
+		}
+		else if (strcmp(argv[i], "-output") == 0 && i + 1 < argc)
+		{
+			outputFilename = argv[++i];
+		}
+		else if (argv[i][0] != '-' && fontFilename.empty())
+		{
+			fontFilename = argv[i];
+		}
+		else
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+	}
+
+	const FormatName* format = nullptr;
+	for (unsigned int i = 0; i < FormatNameCount; i++)
+	{
+		if (formatName == FormatNames[i].Name)
+		{
+			format = &FormatNames[i];
+		}
+	}
+
+	if (fontFilename.empty() || format == nullptr)
+	{
+		fputs(Usage, stderr);
+		return 1;
+	}
+
+	settings.TextureFormat = format->Format;
+	if (outputFilename.empty())
+	{
+		outputFilename = OutputFilename(fontFilename);
+	}
+
+	std::vector<unsigned char> fontData;
+	if (ReadFile(fontFilename, fontData) == false)
+	{
+		fprintf(stderr, "Could not read %s\n", fontFilename.c_str());
+		return 1;
+	}
+
+	ThreadPool threadPool;
+	SpriteFontData font;
+	std::vector<unsigned char> fileData;
+	double generateTime;
+	try
+	{
+		TrueTypeFont trueTypeFont(&fontData[0], fontData.size());
+
+		auto start = std::chrono::high_resolution_clock::now();
+		DistanceFieldFont::Generate(trueTypeFont, settings, font, &threadPool);
+		generateTime = Milliseconds(std::chrono::high_resolution_clock::now() - start);
+
+		SpriteFontFile::Write(font, fileData);
+		if (WriteFile(outputFilename, fileData) == false)
+		{
+			fprintf(stderr, "Could not write %s\n", outputFilename.c_str());
+			return 1;
+		}
+	}
+	catch (std::runtime_error& ex)
+	{
+		fprintf(stderr, "%s: %s\n", fontFilename.c_str(), ex.what());
+		return 1;
+	}
+
+	printf("%s: %u glyphs at %.0f pixels, spread %.1f, %u x %u %s atlas, %.0f KB, generated in %.1f ms on %u threads -> %s\n",
+		fontFilename.c_str(), static_cast<unsigned int>(font.Glyphs.size()), settings.Size, settings.Spread, font.TextureWidth, font.TextureHeight,
+		format->Name, fileData.size() / 1024.0, generateTime, threadPool.ThreadCount(), outputFilename.c_str());
+
+	// The file as TextFont will read it: the same glyphs and texture, and every character laid out
+	int result = 0;
+	try
+	{
+		std::vector<unsigned char> writtenData;
+		SpriteFontData written;
+		if (ReadFile(outputFilename, writtenData) == false)
+		{
+			fprintf(stderr, "Could not read %s back\n", outputFilename.c_str());
+			return 1;
+		}
+
+		SpriteFontFile::Read(&writtenData[0], writtenData.size(), written);
+		if (written.Glyphs.size() != font.Glyphs.size() || memcmp(&written.Glyphs[0], &font.Glyphs[0], sizeof(Glyph) * font.Glyphs.size()) != 0 ||
+			written.TextureData != font.TextureData || written.DistanceFieldSize != settings.Size || written.DistanceFieldSpread != settings.Spread)
+		{
+			fprintf(stderr, "%s doesn't read back as written\n", outputFilename.c_str());
+			result = 1;
+		}
+
+		GlyphTable glyphTable;
+		glyphTable.Build(written.Glyphs, written.DefaultCharacter, written.LineSpacing, written.TextureWidth, written.TextureHeight);
+
+		std::wstring text;
+		for (const Glyph& glyph : written.Glyphs)
+		{
+			text.push_back(static_cast<wchar_t>(glyph.Character));
+		}
+
+		TextRun run;
+		TextLayout::Build(glyphTable, text.c_str(), 1.0f, run);
+		printf("All %u characters lay out %.0f pixels wide and %.0f high\n", static_cast<unsigned int>(text.size()), run.Width, run.Height);
+	}
+	catch (std::runtime_error& ex)
+	{
+		fprintf(stderr, "%s: %s\n", outputFilename.c_str(), ex.what());
+		return 1;
+	}
+
+	if (settings.TextureFormat == DDSFormatR8Unorm)
+	{
+		unsigned int clippedCount = CountClippedGlyphs(font);
+		if (clippedCount > 0)
+		{
+			fprintf(stderr, "%u glyphs reach the edge of their padding\n", clippedCount);
+			result = 1;
+		}
+	}
+
+	return result;
+}
\ No newline at end of file
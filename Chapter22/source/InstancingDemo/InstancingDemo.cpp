@@ -8,15 +8,16 @@
 #include "Model.h"
 #include "Mesh.h"
 #include "Utility.h"
+#include "ContentManager.h"
+#include "FrameAllocator.h"
 #include "PointLight.h"
 #include "Keyboard.h"
 #include <WICTextureLoader.h>
 #include <DDSTextureLoader.h>
 #include "ProxyModel.h"
+#include "DebugDraw.h"
 #include "RenderStateHelper.h"
-#include <SpriteBatch.h>
-#include <SpriteFont.h>
-#include <sstream>
+#include "TextComponent.h"
 
 namespace Rendering
 {
@@ -26,24 +27,21 @@ namespace Rendering
 	const float InstancingDemo::LightMovementRate = 10.0f;
 
 	InstancingDemo::InstancingDemo(Game& game, Camera& camera)
-		: DrawableGameComponent(game, camera), mEffect(nullptr), mMaterial(nullptr), mColorTexture(nullptr),
+		: DrawableGameComponent(game, camera), mEffect(), mMaterial(nullptr), mColorTexture(),
 		  mVertexBuffers(), mIndexBuffer(nullptr), mIndexCount(0), mInstanceCount(0),
 		  mKeyboard(nullptr), mAmbientColor(reinterpret_cast<const float*>(&ColorHelper::White)), mPointLight(nullptr), 
-		  mSpecularColor(1.0f, 1.0f, 1.0f, 0.0f), mSpecularPower(25.0f), mProxyModel(nullptr),
-		  mRenderStateHelper(nullptr), mSpriteBatch(nullptr), mSpriteFont(nullptr), mTextPosition(0.0f, 40.0f)
+		  mSpecularColor(1.0f, 1.0f, 1.0f, 0.0f), mSpecularPower(25.0f), mProxyModel(nullptr), mDebugDraw(nullptr),
+		  mRenderStateHelper(nullptr), mHelpText(nullptr)
 	{
 	}
 
 	InstancingDemo::~InstancingDemo()
 	{
-		DeleteObject(mSpriteFont);
-		DeleteObject(mSpriteBatch);
+		DeleteObject(mHelpText);
 		DeleteObject(mRenderStateHelper);
 		DeleteObject(mProxyModel);
 		DeleteObject(mPointLight);
-		ReleaseObject(mColorTexture);
 		DeleteObject(mMaterial);
-		DeleteObject(mEffect);			
 		ReleaseObject(mIndexBuffer);
 
 		for (VertexBufferData& bufferData : mVertexBuffers)
@@ -56,11 +54,10 @@ namespace Rendering
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
-		std::unique_ptr<Model> model(new Model(*mGame, "Content\\Models\\Sphere.obj", true));
+		std::shared_ptr<Model> model = mGame->Content().LoadModel("Content\\Models\\Sphere.obj", true);
 
 		// Initialize the material
-		mEffect = new Effect(*mGame);
-		mEffect->LoadCompiledEffect(L"Content\\Effects\\Instancing.cso");
+		mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\Instancing.cso");
 		mMaterial = new InstancingMaterial();
 		mMaterial->Initialize(*mEffect);
 
@@ -96,12 +93,7 @@ namespace Rendering
 		mesh->CreateIndexBuffer(&mIndexBuffer);
 		mIndexCount = mesh->Indices().size();
 
-		std::wstring textureName = L"Content\\Textures\\EarthComposite.jpg";
-		HRESULT hr = DirectX::CreateWICTextureFromFile(mGame->Direct3DDevice(), mGame->Direct3DDeviceContext(), textureName.c_str(), nullptr, &mColorTexture);
-		if (FAILED(hr))
-		{
-			throw GameException("CreateWICTextureFromFile() failed.", hr);
-		}
+		mColorTexture = mGame->Content().LoadTexture(L"Content\\Textures\\EarthComposite.jpg");
 
 		mPointLight = new PointLight(*mGame);
 		mPointLight->SetRadius(100.0f);
@@ -113,10 +105,13 @@ namespace Rendering
 		mProxyModel = new ProxyModel(*mGame, *mCamera, "Content\\Models\\PointLightProxy.obj", 0.5f);
 		mProxyModel->Initialize();
 
+		mDebugDraw = (DebugDraw*)mGame->Services().GetService(DebugDraw::TypeIdClass());
+
 		mRenderStateHelper = new RenderStateHelper(*mGame);
 
-		mSpriteBatch = new SpriteBatch(mGame->Direct3DDeviceContext());
-		mSpriteFont = new SpriteFont(mGame->Direct3DDevice(), L"Content\\Fonts\\Arial_14_Regular.spritefont");
+		mHelpText = new TextComponent(*mGame);
+		mHelpText->Position() = XMFLOAT2(0.0f, 40.0f);
+		mHelpText->Initialize();
 	}
 
 	void InstancingDemo::Update(const GameTime& gameTime)
@@ -125,6 +120,11 @@ namespace Rendering
 		UpdatePointLight(gameTime);
 
 		mProxyModel->Update(gameTime);
+
+		if (mDebugDraw != nullptr)
+		{
+			mDebugDraw->DrawSphere(mPointLight->PositionVector(), mPointLight->Radius(), ColorHelper::Yellow);
+		}
 	}
 
 	void InstancingDemo::Draw(const GameTime& gameTime)
@@ -148,7 +148,7 @@ namespace Rendering
 		mMaterial->LightColor() << mPointLight->ColorVector();
 		mMaterial->LightPosition() << mPointLight->PositionVector();
 		mMaterial->LightRadius() << mPointLight->Radius();
-		mMaterial->ColorTexture() << mColorTexture;
+		mMaterial->ColorTexture() << mColorTexture.get();
 		mMaterial->CameraPosition() << mCamera->PositionVector();
 	
 		pass->Apply(0, direct3DDeviceContext);		
@@ -158,16 +158,13 @@ namespace Rendering
 		mProxyModel->Draw(gameTime);		
 
 		mRenderStateHelper->SaveAll();
-		mSpriteBatch->Begin();
-
-		std::wostringstream helpLabel;
-		helpLabel << L"Ambient Intensity (+PgUp/-PgDn): " << mAmbientColor.a << "\n";
-		helpLabel << L"Point Light Intensity (+Home/-End): " << mPointLight->Color().a << "\n";
-		helpLabel << L"Move Point Light (8/2, 4/6, 3/9)\n";
 
-		mSpriteFont->DrawString(mSpriteBatch, helpLabel.str().c_str(), mTextPosition);
+		// Laid out again only when an intensity changes
+		const wchar_t* helpLabel = mGame->FrameMemory().Format(L"Ambient Intensity (+PgUp/-PgDn): %g\nPoint Light Intensity (+Home/-End): %g\nMove Point Light (8/2, 4/6, 3/9)\n",
+			mAmbientColor.a, mPointLight->Color().a);
 
-		mSpriteBatch->End();
+		mHelpText->SetText(helpLabel);
+		mHelpText->Draw(gameTime);
 		mRenderStateHelper->RestoreAll();
 	}
 
@@ -11,13 +11,9 @@ namespace Library
 	class PointLight;
 	class Keyboard;
 	class ProxyModel;
+	class DebugDraw;
 	class RenderStateHelper;
-}
-
-namespace DirectX
-{
-	class SpriteBatch;
-	class SpriteFont;
+	class TextComponent;
 }
 
 namespace Rendering
@@ -55,9 +51,9 @@ namespace Rendering
 		static const float LightModulationRate;
 		static const float LightMovementRate;
 
-		Effect* mEffect;
+		std::shared_ptr<Effect> mEffect;
 		InstancingMaterial* mMaterial;		
-		ID3D11ShaderResourceView* mColorTexture;
+		std::shared_ptr<ID3D11ShaderResourceView> mColorTexture;
 		std::vector<VertexBufferData> mVertexBuffers;
 		ID3D11Buffer* mIndexBuffer;
 		UINT mIndexCount;
@@ -70,10 +66,9 @@ namespace Rendering
 		float mSpecularPower;
 
 		ProxyModel* mProxyModel;
+		DebugDraw* mDebugDraw;
 
 		RenderStateHelper* mRenderStateHelper;
-		SpriteBatch* mSpriteBatch;
-		SpriteFont* mSpriteFont;
-		XMFLOAT2 mTextPosition;
+		TextComponent* mHelpText;
 	};
 }
@@ -11,6 +11,12 @@
 #include "SamplerStates.h"
 #include "Skybox.h"
 #include "Grid.h"
+#include "EffectCache.h"
+#include "Utility.h"
+#include "DebugDraw.h"
+#include "FrameCapture.h"
+#include <sstream>
+#include <iomanip>
 
 #include "InstancingDemo.h"
 
@@ -20,7 +26,7 @@ namespace Rendering
 
     RenderingGame::RenderingGame(HINSTANCE instance, const std::wstring& windowClass, const std::wstring& windowTitle, int showCommand)
         :  Game(instance, windowClass, windowTitle, showCommand),
-           mFpsComponent(nullptr), mGrid(nullptr),
+           mFpsComponent(nullptr), mGrid(nullptr), mDebugDraw(nullptr), mFrameCapture(nullptr), mIsRecording(false), mRecordedFrameCount(0),
            mDirectInput(nullptr), mKeyboard(nullptr), mMouse(nullptr), mRenderStateHelper(nullptr), mSkybox(nullptr),
            mInstancingDemo(nullptr)
     {
@@ -34,6 +40,14 @@ namespace Rendering
 
     void RenderingGame::Initialize()
     {
+		// Loaded on the worker threads while the components are created, so their Initialize() finds them ready
+		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
+		const std::wstring effectFilenames[] = { L"Content\\Effects\\BasicEffect.cso", L"Content\\Effects\\Instancing.cso" };
+		for (const std::wstring& effectFilename : effectFilenames)
+		{
+			mCompiledEffects->Precompile(effectFilename);
+		}
+
         if (FAILED(DirectInput8Create(mInstance, DIRECTINPUT_VERSION, IID_IDirectInput8, (LPVOID*)&mDirectInput, nullptr)))
         {
             throw GameException("DirectInput8Create() failed");
@@ -68,6 +82,13 @@ namespace Rendering
 		mInstancingDemo = new InstancingDemo(*this, *mCamera);
 		mComponents.push_back(mInstancingDemo);
 
+		mDebugDraw = new DebugDraw(*this, *mCamera);
+		mComponents.push_back(mDebugDraw);
+		mServices.AddService(DebugDraw::TypeIdClass(), mDebugDraw);
+
+		mFrameCapture = new FrameCapture(*this);
+		mComponents.push_back(mFrameCapture);
+
 		mRenderStateHelper = new RenderStateHelper(*this);
 
 		Game::Initialize();
@@ -77,6 +98,9 @@ namespace Rendering
 
     void RenderingGame::Shutdown()
     {
+		mFrameCapture->Flush();
+		DeleteObject(mFrameCapture);
+		DeleteObject(mDebugDraw);
 		DeleteObject(mInstancingDemo);
         DeleteObject(mRenderStateHelper);
 		DeleteObject(mKeyboard);
@@ -103,6 +127,12 @@ namespace Rendering
             Exit();
         }
 
+		// F12 starts and stops recording every frame to Frame00000.png and on, encoded on the worker threads
+		if (mKeyboard->WasKeyPressedThisFrame(DIK_F12))
+		{
+			mIsRecording = !mIsRecording;
+		}
+
         Game::Update(gameTime);
     }
 
@@ -116,6 +146,13 @@ namespace Rendering
 		mRenderStateHelper->SaveAll();
 		mFpsComponent->Draw(gameTime);		
 		mRenderStateHelper->RestoreAll();
+
+		if (mIsRecording)
+		{
+			std::ostringstream filename;
+			filename << "Frame" << std::setw(5) << std::setfill('0') << mRecordedFrameCount++ << ".png";
+			mFrameCapture->CaptureBackBuffer(filename.str());
+		}
         
         HRESULT hr = mSwapChain->Present(0, 0);
         if (FAILED(hr))
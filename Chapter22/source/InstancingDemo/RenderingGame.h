@@ -14,6 +14,8 @@ namespace Library
 	class RenderStateHelper;
 	class Skybox;
 	class Grid;
+	class DebugDraw;
+	class FrameCapture;
 }
 
 namespace Rendering
@@ -44,6 +46,10 @@ namespace Rendering
 		RenderStateHelper* mRenderStateHelper;
 		Skybox* mSkybox;
 		Grid* mGrid;
+		DebugDraw* mDebugDraw;
+		FrameCapture* mFrameCapture;
+		bool mIsRecording;
+		UINT mRecordedFrameCount;
 
 		InstancingDemo* mInstancingDemo;
     };
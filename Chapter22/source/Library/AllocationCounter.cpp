@@ -0,0 +1,72 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+#if defined(LIBRARY_COUNT_ALLOCATIONS)
+#include <atomic>
+
+namespace
+{
+	std::atomic<unsigned long long> sAllocationCount(0);
+}
+
+void* operator new(size_t size)
+{
+	sAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) throw()
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) throw()
+{
+	free(memory);
+}
+
+// C++14 compilers call these for objects of known size, so they are replaced along with the unsized ones
+void operator delete(void* memory, size_t) throw()
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) throw()
+{
+	free(memory);
+}
+#endif
+
+namespace Library
+{
+	bool AllocationCounter::IsEnabled()
+	{
+#if defined(LIBRARY_COUNT_ALLOCATIONS)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	unsigned long long AllocationCounter::AllocationCount()
+	{
+#if defined(LIBRARY_COUNT_ALLOCATIONS)
+		return sAllocationCount.load(std::memory_order_relaxed);
+#else
+		return 0;
+#endif
+	}
+}
\ No newline at end of file
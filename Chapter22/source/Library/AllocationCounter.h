@@ -0,0 +1,20 @@
+#pragma once
+
+// Portable, like FrameAllocator: AllocationBenchmark counts with it without a device
+
+namespace Library
+{
+	// Counts global operator new calls when the Library is built with LIBRARY_COUNT_ALLOCATIONS defined; a tool defines
+	// it for its own build of AllocationCounter.cpp to count there instead. The count covers every thread.
+	class AllocationCounter
+	{
+	public:
+		static bool IsEnabled();
+		static unsigned long long AllocationCount();
+
+	private:
+		AllocationCounter();
+		AllocationCounter(const AllocationCounter& rhs);
+		AllocationCounter& operator=(const AllocationCounter& rhs);
+	};
+}
\ No newline at end of file
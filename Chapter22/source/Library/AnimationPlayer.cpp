@@ -13,10 +13,19 @@ namespace Library
 
 	AnimationPlayer::AnimationPlayer(Game& game, Model& model, bool interpolationEnabled)
         : GameComponent(game),
-		mModel(&model), mCurrentClip(nullptr), mCurrentTime(0.0f), mCurrentKeyframe(0U), mToRootTransforms(), mFinalTransforms(),
+		mModel(&model), mCurrentClip(nullptr), mCurrentTime(0.0f), mCurrentKeyframe(0U),
+		  mSceneNodes(), mBones(), mParentIndices(), mToRootTransforms(), mFinalTransforms(),
 		  mInverseRootTransform(MatrixHelper::Identity), mInterpolationEnabled(interpolationEnabled), mIsPlayingClip(false), mIsClipLooped(true)
 	{
 		mFinalTransforms.resize(model.Bones().size());
+
+		// Parents precede their children, so poses are computed with a single pass and no per-frame lookups
+		if (model.RootNode() != nullptr)
+		{
+			FlattenHierarchy(*(model.RootNode()), -1);
+		}
+
+		mToRootTransforms.resize(mSceneNodes.size());
 	}
 
 	const Model& AnimationPlayer::GetModel() const
@@ -73,7 +82,7 @@ namespace Library
 
 		XMMATRIX inverseRootTransform = XMMatrixInverse(&XMMatrixDeterminant(mModel->RootNode()->TransformMatrix()), mModel->RootNode()->TransformMatrix());
 		XMStoreFloat4x4(&mInverseRootTransform, inverseRootTransform);
-		GetBindPose(*(mModel->RootNode()));
+		GetBindPose();
 	}
 
 	void AnimationPlayer::PauseClip()
@@ -111,11 +120,11 @@ namespace Library
 
 			if (mInterpolationEnabled)
 			{
-				GetInterpolatedPose(mCurrentTime, *(mModel->RootNode()));
+				GetInterpolatedPose(mCurrentTime);
 			}
 			else
 			{
-				GetPose(mCurrentTime, *(mModel->RootNode()));
+				GetPose(mCurrentTime);
 			}
 		}
 	}
@@ -123,128 +132,97 @@ namespace Library
 	void AnimationPlayer::SetCurrentKeyFrame(UINT keyframe)
 	{
 		mCurrentKeyframe = keyframe;
-		GetPoseAtKeyframe(mCurrentKeyframe, *(mModel->RootNode()));
+		GetPoseAtKeyframe(mCurrentKeyframe);
 	}
 
-	void AnimationPlayer::GetBindPoseBottomUp(SceneNode& sceneNode)
+	void AnimationPlayer::FlattenHierarchy(SceneNode& sceneNode, int parentIndex)
 	{
-		XMMATRIX toRootTransform = sceneNode.TransformMatrix();
-
-		SceneNode* parentNode = sceneNode.Parent();
-		while (parentNode != nullptr)
-		{
-			toRootTransform = toRootTransform * parentNode->TransformMatrix();
-			parentNode = parentNode->Parent();
-		}
-
-		Bone* bone = sceneNode.As<Bone>();
-		if (bone != nullptr)
-		{
-			XMStoreFloat4x4(&(mFinalTransforms[bone->Index()]), bone->OffsetTransformMatrix() *  toRootTransform * XMLoadFloat4x4(&mInverseRootTransform));
-		}
+		int nodeIndex = static_cast<int>(mSceneNodes.size());
+		mSceneNodes.push_back(&sceneNode);
+		mBones.push_back(sceneNode.As<Bone>());
+		mParentIndices.push_back(parentIndex);
 
 		for (SceneNode* childNode : sceneNode.Children())
 		{
-			GetBindPose(*childNode);
+			FlattenHierarchy(*childNode, nodeIndex);
 		}
 	}
 
-	void AnimationPlayer::GetBindPose(SceneNode& sceneNode)
+	void AnimationPlayer::GetBindPose()
 	{
-		XMMATRIX toParentTransform = sceneNode.TransformMatrix();
-		XMMATRIX toRootTransform = (sceneNode.Parent() != nullptr ? toParentTransform * XMLoadFloat4x4(&(mToRootTransforms.at(sceneNode.Parent()))) : toParentTransform);
-		XMStoreFloat4x4(&(mToRootTransforms[&sceneNode]), toRootTransform);		
-
-		Bone* bone = sceneNode.As<Bone>();
-		if (bone != nullptr)
-		{
-			XMStoreFloat4x4(&(mFinalTransforms[bone->Index()]), bone->OffsetTransformMatrix() * toRootTransform * XMLoadFloat4x4(&mInverseRootTransform));
-		}
-
-		for (SceneNode* childNode : sceneNode.Children())
+		for (UINT i = 0; i < mSceneNodes.size(); i++)
 		{
-			GetBindPose(*childNode);
+			UpdateTransforms(i, mSceneNodes[i]->Transform());
 		}
 	}
 
-	void AnimationPlayer::GetPose(float time, SceneNode& sceneNode)
+	void AnimationPlayer::GetPose(float time)
 	{
 		XMFLOAT4X4 toParentTransform;
-		Bone* bone = sceneNode.As<Bone>();
-		if (bone != nullptr)
+		for (UINT i = 0; i < mSceneNodes.size(); i++)
 		{
-			mCurrentKeyframe = mCurrentClip->GetTransform(time, *bone, toParentTransform);
-		}
-		else
-		{
-			toParentTransform = sceneNode.Transform();
-		}
-
-		XMMATRIX toRootTransform = (sceneNode.Parent() != nullptr ? XMLoadFloat4x4(&toParentTransform) * XMLoadFloat4x4(&(mToRootTransforms.at(sceneNode.Parent()))) : XMLoadFloat4x4(&toParentTransform));
-		XMStoreFloat4x4(&(mToRootTransforms[&sceneNode]), toRootTransform);
+			Bone* bone = mBones[i];
+			if (bone != nullptr)
+			{
+				mCurrentKeyframe = mCurrentClip->GetTransform(time, *bone, toParentTransform);
+			}
+			else
+			{
+				toParentTransform = mSceneNodes[i]->Transform();
+			}
 
-		if (bone != nullptr)
-		{
-			XMStoreFloat4x4(&(mFinalTransforms[bone->Index()]), bone->OffsetTransformMatrix() * toRootTransform * XMLoadFloat4x4(&mInverseRootTransform));
-		}
-
-		for (SceneNode* childNode : sceneNode.Children())
-		{
-			GetPose(time, *childNode);
+			UpdateTransforms(i, toParentTransform);
 		}
 	}
 
-	void AnimationPlayer::GetPoseAtKeyframe(UINT keyframe, SceneNode& sceneNode)
+	void AnimationPlayer::GetPoseAtKeyframe(UINT keyframe)
 	{
 		XMFLOAT4X4 toParentTransform;
-		Bone* bone = sceneNode.As<Bone>();
-		if (bone != nullptr)
+		for (UINT i = 0; i < mSceneNodes.size(); i++)
 		{
-			mCurrentClip->GetTransformAtKeyframe(keyframe, *bone, toParentTransform);
-		}
-		else
-		{
-			toParentTransform = sceneNode.Transform();
-		}
-
-		XMMATRIX toRootTransform = (sceneNode.Parent() != nullptr ? XMLoadFloat4x4(&toParentTransform) * XMLoadFloat4x4(&(mToRootTransforms.at(sceneNode.Parent()))) : XMLoadFloat4x4(&toParentTransform));
-		XMStoreFloat4x4(&(mToRootTransforms[&sceneNode]), toRootTransform);
+			Bone* bone = mBones[i];
+			if (bone != nullptr)
+			{
+				mCurrentClip->GetTransformAtKeyframe(keyframe, *bone, toParentTransform);
+			}
+			else
+			{
+				toParentTransform = mSceneNodes[i]->Transform();
+			}
 
-		if (bone != nullptr)
-		{
-			XMStoreFloat4x4(&(mFinalTransforms[bone->Index()]), bone->OffsetTransformMatrix() * toRootTransform * XMLoadFloat4x4(&mInverseRootTransform));
-		}
-
-		for (SceneNode* childNode : sceneNode.Children())
-		{
-			GetPoseAtKeyframe(keyframe, *childNode);
+			UpdateTransforms(i, toParentTransform);
 		}
 	}
 
-	void AnimationPlayer::GetInterpolatedPose(float time, SceneNode& sceneNode)
+	void AnimationPlayer::GetInterpolatedPose(float time)
 	{
 		XMFLOAT4X4 toParentTransform;
-		Bone* bone = sceneNode.As<Bone>();
-		if (bone != nullptr)
-		{
-			mCurrentClip->GetInteropolatedTransform(time, *bone, toParentTransform);
-		}
-		else
+		for (UINT i = 0; i < mSceneNodes.size(); i++)
 		{
-			toParentTransform = sceneNode.Transform();
+			Bone* bone = mBones[i];
+			if (bone != nullptr)
+			{
+				mCurrentClip->GetInteropolatedTransform(time, *bone, toParentTransform);
+			}
+			else
+			{
+				toParentTransform = mSceneNodes[i]->Transform();
+			}
+
+			UpdateTransforms(i, toParentTransform);
 		}
+	}
 
-		XMMATRIX toRootTransform = (sceneNode.Parent() != nullptr ? XMLoadFloat4x4(&toParentTransform) * XMLoadFloat4x4(&(mToRootTransforms.at(sceneNode.Parent()))) : XMLoadFloat4x4(&toParentTransform));
-		XMStoreFloat4x4(&(mToRootTransforms[&sceneNode]), toRootTransform);
+	void AnimationPlayer::UpdateTransforms(UINT nodeIndex, const XMFLOAT4X4& toParentTransform)
+	{
+		int parentIndex = mParentIndices[nodeIndex];
+		XMMATRIX toRootTransform = (parentIndex >= 0 ? XMLoadFloat4x4(&toParentTransform) * XMLoadFloat4x4(&mToRootTransforms[parentIndex]) : XMLoadFloat4x4(&toParentTransform));
+		XMStoreFloat4x4(&mToRootTransforms[nodeIndex], toRootTransform);
 
+		Bone* bone = mBones[nodeIndex];
 		if (bone != nullptr)
 		{
 			XMStoreFloat4x4(&(mFinalTransforms[bone->Index()]), bone->OffsetTransformMatrix() * toRootTransform * XMLoadFloat4x4(&mInverseRootTransform));
 		}
-
-		for (SceneNode* childNode : sceneNode.Children())
-		{
-			GetInterpolatedPose(time, *childNode);
-		}
 	}
 }
@@ -8,6 +8,7 @@ namespace Library
 	class Model;
 	class SceneNode;
 	class AnimationClip;
+	class Bone;
 
     class AnimationPlayer : GameComponent
     {
@@ -39,17 +40,21 @@ namespace Library
         AnimationPlayer(const AnimationPlayer& rhs);
         AnimationPlayer& operator=(const AnimationPlayer& rhs);
 
-		void GetBindPose(SceneNode& sceneNode);
-		void GetBindPoseBottomUp(SceneNode& sceneNode);
-		void GetPose(float time, SceneNode& sceneNode);
-		void GetPoseAtKeyframe(UINT keyframe, SceneNode& sceneNode);
-		void GetInterpolatedPose(float time, SceneNode& sceneNode);		
+		void FlattenHierarchy(SceneNode& sceneNode, int parentIndex);
+		void GetBindPose();
+		void GetPose(float time);
+		void GetPoseAtKeyframe(UINT keyframe);
+		void GetInterpolatedPose(float time);
+		void UpdateTransforms(UINT nodeIndex, const XMFLOAT4X4& toParentTransform);
 
 		Model* mModel;
 		AnimationClip* mCurrentClip;
 		float mCurrentTime;
 		UINT mCurrentKeyframe;
-		std::map<SceneNode*, XMFLOAT4X4> mToRootTransforms;
+		std::vector<SceneNode*> mSceneNodes;
+		std::vector<Bone*> mBones;
+		std::vector<int> mParentIndices;
+		std::vector<XMFLOAT4X4> mToRootTransforms;
 		std::vector<XMFLOAT4X4> mFinalTransforms;
 		XMFLOAT4X4 mInverseRootTransform;
 		bool mInterpolationEnabled;
@@ -0,0 +1,590 @@
+#include "BlockCompressor.h"
+#include "DDSFile.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <xmmintrin.h>
+
+namespace Library
+{
+	namespace
+	{
+		const unsigned int TexelCount = 16;
+		const unsigned int PowerIterationCount = 8;
+
+		// BC7 4-bit index interpolation weights, out of 64
+		const int BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		unsigned char ToByte(float value)
+		{
+			return static_cast<unsigned char>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+		}
+
+		void LoadPoints(const unsigned char texels[64], float points[16][4])
+		{
+			for (unsigned int i = 0; i < TexelCount; i++)
+			{
+				for (unsigned int channel = 0; channel < 4; channel++)
+				{
+					points[i][channel] = texels[i * 4 + channel];
+				}
+			}
+		}
+
+		// Fits a line through the points along their principal axis, by power iteration on the covariance matrix
+		void FitEndpoints(const float points[16][4], unsigned int channelCount, float endpoint0[4], float endpoint1[4])
+		{
+			float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float minimum[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+			float maximum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for (unsigned int i = 0; i < TexelCount; i++)
+			{
+				for (unsigned int channel = 0; channel < channelCount; channel++)
+				{
+					mean[channel] += points[i][channel] / TexelCount;
+					minimum[channel] = std::min(minimum[channel], points[i][channel]);
+					maximum[channel] = std::max(maximum[channel], points[i][channel]);
+				}
+			}
+
+			float covariance[4][4] = { { 0.0f } };
+			for (unsigned int i = 0; i < TexelCount; i++)
+			{
+				for (unsigned int row = 0; row < channelCount; row++)
+				{
+					for (unsigned int column = 0; column < channelCount; column++)
+					{
+						covariance[row][column] += (points[i][row] - mean[row]) * (points[i][column] - mean[column]);
+					}
+				}
+			}
+
+			// The bounding box diagonal is a good first guess, and is never orthogonal to the axis in practice
+			float axis[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for (unsigned int channel = 0; channel < channelCount; channel++)
+			{
+				axis[channel] = maximum[channel] - minimum[channel];
+			}
+
+			for (unsigned int iteration = 0; iteration < PowerIterationCount; iteration++)
+			{
+				float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				float largest = 0.0f;
+				for (unsigned int row = 0; row < channelCount; row++)
+				{
+					for (unsigned int column = 0; column < channelCount; column++)
+					{
+						next[row] += covariance[row][column] * axis[column];
+					}
+
+					largest = std::max(largest, std::abs(next[row]));
+				}
+
+				if (largest == 0.0f)
+				{
+					break;
+				}
+
+				for (unsigned int channel = 0; channel < channelCount; channel++)
+				{
+					axis[channel] = next[channel] / largest;
+				}
+			}
+
+			float lengthSquared = 0.0f;
+			for (unsigned int channel = 0; channel < channelCount; channel++)
+			{
+				lengthSquared += axis[channel] * axis[channel];
+			}
+
+			float minimumProjection = 0.0f;
+			float maximumProjection = 0.0f;
+			if (lengthSquared > 0.0f)
+			{
+				for (unsigned int i = 0; i < TexelCount; i++)
+				{
+					float projection = 0.0f;
+					for (unsigned int channel = 0; channel < channelCount; channel++)
+					{
+						projection += (points[i][channel] - mean[channel]) * axis[channel];
+					}
+
+					minimumProjection = std::min(minimumProjection, projection / lengthSquared);
+					maximumProjection = std::max(maximumProjection, projection / lengthSquared);
+				}
+			}
+
+			for (unsigned int channel = 0; channel < 4; channel++)
+			{
+				endpoint0[channel] = std::min(std::max(mean[channel] + axis[channel] * minimumProjection, 0.0f), 255.0f);
+				endpoint1[channel] = std::min(std::max(mean[channel] + axis[channel] * maximumProjection, 0.0f), 255.0f);
+			}
+		}
+
+		// Solves for the endpoints that best reproduce the points, given each point's interpolation weight toward endpoint1
+		bool RefineEndpoints(const float points[16][4], const float weights[16], unsigned int channelCount, float endpoint0[4], float endpoint1[4])
+		{
+			float a = 0.0f;
+			float b = 0.0f;
+			float c = 0.0f;
+			float x0[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float x1[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for (unsigned int i = 0; i < TexelCount; i++)
+			{
+				float weight0 = 1.0f - weights[i];
+				float weight1 = weights[i];
+				a += weight0 * weight0;
+				b += weight0 * weight1;
+				c += weight1 * weight1;
+				for (unsigned int channel = 0; channel < channelCount; channel++)
+				{
+					x0[channel] += weight0 * points[i][channel];
+					x1[channel] += weight1 * points[i][channel];
+				}
+			}
+
+			float determinant = a * c - b * b;
+			if (fabs(determinant) < 1e-6f)
+			{
+				return false;
+			}
+
+			for (unsigned int channel = 0; channel < channelCount; channel++)
+			{
+				endpoint0[channel] = std::min(std::max((c * x0[channel] - b * x1[channel]) / determinant, 0.0f), 255.0f);
+				endpoint1[channel] = std::min(std::max((a * x1[channel] - b * x0[channel]) / determinant, 0.0f), 255.0f);
+			}
+
+			return true;
+		}
+
+		unsigned int PackRGB565(const float color[4])
+		{
+			unsigned int r = static_cast<unsigned int>(color[0] * 31.0f / 255.0f + 0.5f);
+			unsigned int g = static_cast<unsigned int>(color[1] * 63.0f / 255.0f + 0.5f);
+			unsigned int b = static_cast<unsigned int>(color[2] * 31.0f / 255.0f + 0.5f);
+
+			return (r << 11) | (g << 5) | b;
+		}
+
+		void UnpackRGB565(unsigned int value, int color[3])
+		{
+			int r = (value >> 11) & 31;
+			int g = (value >> 5) & 63;
+			int b = value & 31;
+			color[0] = (r << 3) | (r >> 2);
+			color[1] = (g << 2) | (g >> 4);
+			color[2] = (b << 3) | (b >> 2);
+		}
+
+		// Four-color palette indices for a pair of endpoints, returning the squared error
+		float FitBC1Indices(const float points[16][4], unsigned int color0, unsigned int color1, unsigned int& indices)
+		{
+			int palette[4][3];
+			UnpackRGB565(color0, palette[0]);
+			UnpackRGB565(color1, palette[1]);
+			for (unsigned int channel = 0; channel < 3; channel++)
+			{
+				palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+				palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+			}
+
+			indices = 0;
+			float totalError = 0.0f;
+			for (unsigned int i = 0; i < TexelCount; i++)
+			{
+				unsigned int bestIndex = 0;
+				float bestError = 1e30f;
+				for (unsigned int index = 0; index < 4; index++)
+				{
+					float error = 0.0f;
+					for (unsigned int channel = 0; channel < 3; channel++)
+					{
+						float difference = points[i][channel] - palette[index][channel];
+						error += difference * difference;
+					}
+
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = index;
+					}
+				}
+
+				indices |= bestIndex << (i * 2);
+				totalError += bestError;
+			}
+
+			return totalError;
+		}
+
+		typedef struct _BC7Endpoint
+		{
+			unsigned int Values[4];
+			unsigned int PBit;
+		} BC7Endpoint;
+
+		// Mode 6 stores 7 bits per channel plus one p-bit shared by the endpoint's channels
+		void QuantizeBC7Endpoint(const float endpoint[4], BC7Endpoint& quantized)
+		{
+			float bestError = 1e30f;
+			for (unsigned int pBit = 0; pBit < 2; pBit++)
+			{
+				BC7Endpoint candidate;
+				candidate.PBit = pBit;
+
+				float error = 0.0f;
+				for (unsigned int channel = 0; channel < 4; channel++)
+				{
+					int value = static_cast<int>(floor((endpoint[channel] - pBit) * 0.5f + 0.5f));
+					candidate.Values[channel] = static_cast<unsigned int>(std::min(std::max(value, 0), 127));
+
+					float difference = endpoint[channel] - (candidate.Values[channel] * 2 + pBit);
+					error += difference * difference;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					quantized = candidate;
+				}
+			}
+		}
+
+		float FitBC7Indices(const float points[16][4], const BC7Endpoint& endpoint0, const BC7Endpoint& endpoint1, unsigned int indices[16])
+		{
+			__m128 palette[16];
+			for (unsigned int index = 0; index < 16; index++)
+			{
+				float entry[4];
+				for (unsigned int channel = 0; channel < 4; channel++)
+				{
+					int value0 = endpoint0.Values[channel] * 2 + endpoint0.PBit;
+					int value1 = endpoint1.Values[channel] * 2 + endpoint1.PBit;
+					entry[channel] = static_cast<float>(((64 - BC7Weights[index]) * value0 + BC7Weights[index] * value1 + 32) >> 6);
+				}
+
+				palette[index] = _mm_loadu_ps(entry);
+			}
+
+			float totalError = 0.0f;
+			for (unsigned int i = 0; i < TexelCount; i++)
+			{
+				__m128 point = _mm_loadu_ps(points[i]);
+				unsigned int bestIndex = 0;
+				float bestError = 1e30f;
+				for (unsigned int index = 0; index < 16; index++)
+				{
+					__m128 difference = _mm_sub_ps(point, palette[index]);
+					__m128 squared = _mm_mul_ps(difference, difference);
+					squared = _mm_add_ps(squared, _mm_movehl_ps(squared, squared));
+					float error = _mm_cvtss_f32(_mm_add_ss(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(1, 1, 1, 1))));
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = index;
+					}
+				}
+
+				indices[i] = bestIndex;
+				totalError += bestError;
+			}
+
+			return totalError;
+		}
+
+		void WriteBits(unsigned char* block, unsigned int& position, unsigned int value, unsigned int count)
+		{
+			for (unsigned int bit = 0; bit < count; bit++, position++)
+			{
+				if ((value >> bit) & 1)
+				{
+					block[position / 8] |= static_cast<unsigned char>(1 << (position % 8));
+				}
+			}
+		}
+	}
+
+	void BlockCompressor::Compress(const PostProcessImage& image, unsigned int format, std::vector<unsigned char>& output, ThreadPool* threadPool)
+	{
+		if (IsSupported(format) == false)
+		{
+			throw std::runtime_error("Unsupported block compression format.");
+		}
+
+		if (format == DDSFormatR8G8B8A8Unorm || format == DDSFormatR8G8B8A8UnormSrgb)
+		{
+			output.resize(image.Texels.size());
+			for (size_t i = 0; i < image.Texels.size(); i++)
+			{
+				output[i] = ToByte(image.Texels[i]);
+			}
+
+			return;
+		}
+
+		unsigned int blockSize = (format == DDSFormatBC1Unorm || format == DDSFormatBC1UnormSrgb ? 8 : 16);
+		unsigned int blockCountX = (image.Width + 3) / 4;
+		unsigned int blockCountY = (image.Height + 3) / 4;
+		output.resize(static_cast<size_t>(blockCountX) * blockCountY * blockSize);
+
+		auto compressRows = [&](unsigned int begin, unsigned int end)
+		{
+			unsigned char texels[64];
+			for (unsigned int blockY = begin; blockY < end; blockY++)
+			{
+				for (unsigned int blockX = 0; blockX < blockCountX; blockX++)
+				{
+					for (unsigned int i = 0; i < TexelCount; i++)
+					{
+						unsigned int x = std::min(blockX * 4 + i % 4, image.Width - 1);
+						unsigned int y = std::min(blockY * 4 + i / 4, image.Height - 1);
+						const float* texel = &image.Texels[(static_cast<size_t>(y) * image.Width + x) * 4];
+						for (unsigned int channel = 0; channel < 4; channel++)
+						{
+							texels[i * 4 + channel] = ToByte(texel[channel]);
+						}
+					}
+
+					unsigned char* block = &output[(static_cast<size_t>(blockY) * blockCountX + blockX) * blockSize];
+					switch (format)
+					{
+					case DDSFormatBC1Unorm:
+					case DDSFormatBC1UnormSrgb:
+						CompressBC1(texels, block);
+						break;
+
+					case DDSFormatBC3Unorm:
+					case DDSFormatBC3UnormSrgb:
+						CompressBC3(texels, block);
+						break;
+
+					case DDSFormatBC5Unorm:
+						CompressBC5(texels, block);
+						break;
+
+					default:
+						CompressBC7(texels, block);
+						break;
+					}
+				}
+			}
+		};
+
+		if (threadPool != nullptr)
+		{
+			threadPool->ParallelFor(0, blockCountY, compressRows);
+		}
+		else
+		{
+			compressRows(0, blockCountY);
+		}
+	}
+
+	void BlockCompressor::CompressBC1(const unsigned char texels[64], unsigned char block[8])
+	{
+		float points[16][4];
+		LoadPoints(texels, points);
+
+		float endpoint0[4];
+		float endpoint1[4];
+		FitEndpoints(points, 3, endpoint1, endpoint0);
+
+		unsigned int color0 = PackRGB565(endpoint0);
+		unsigned int color1 = PackRGB565(endpoint1);
+		unsigned int indices;
+		float error = FitBC1Indices(points, color0, color1, indices);
+
+		static const float IndexWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+		float weights[16];
+		for (unsigned int i = 0; i < TexelCount; i++)
+		{
+			weights[i] = IndexWeights[(indices >> (i * 2)) & 3];
+		}
+
+		if (RefineEndpoints(points, weights, 3, endpoint0, endpoint1))
+		{
+			unsigned int refinedColor0 = PackRGB565(endpoint0);
+			unsigned int refinedColor1 = PackRGB565(endpoint1);
+			unsigned int refinedIndices;
+			float refinedError = FitBC1Indices(points, refinedColor0, refinedColor1, refinedIndices);
+			if (refinedError < error)
+			{
+				color0 = refinedColor0;
+				color1 = refinedColor1;
+				indices = refinedIndices;
+			}
+		}
+
+		// Four-color mode needs color0 > color1; swapping the endpoints swaps 0 with 1 and 2 with 3
+		if (color0 < color1)
+		{
+			std::swap(color0, color1);
+			indices ^= 0x55555555;
+		}
+		else if (color0 == color1)
+		{
+			indices = 0;
+		}
+
+		block[0] = static_cast<unsigned char>(color0 & 0xFF);
+		block[1] = static_cast<unsigned char>(color0 >> 8);
+		block[2] = static_cast<unsigned char>(color1 & 0xFF);
+		block[3] = static_cast<unsigned char>(color1 >> 8);
+		memcpy(block + 4, &indices, sizeof(indices));
+	}
+
+	void BlockCompressor::CompressBC3(const unsigned char texels[64], unsigned char block[16])
+	{
+		unsigned char alpha[16];
+		for (unsigned int i = 0; i < TexelCount; i++)
+		{
+			alpha[i] = texels[i * 4 + 3];
+		}
+
+		CompressBC4(alpha, block);
+		CompressBC1(texels, block + 8);
+	}
+
+	void BlockCompressor::CompressBC4(const unsigned char values[16], unsigned char block[8])
+	{
+		unsigned char minimum = *std::min_element(values, values + TexelCount);
+		unsigned char maximum = *std::max_element(values, values + TexelCount);
+
+		memset(block, 0, 8);
+		block[0] = maximum;
+		block[1] = minimum;
+		if (maximum == minimum)
+		{
+			// Equal endpoints select the six-value palette, whose index 0 is still the first endpoint
+			return;
+		}
+
+		int palette[8] = { maximum, minimum };
+		for (int index = 2; index < 8; index++)
+		{
+			palette[index] = ((8 - index) * maximum + (index - 1) * minimum) / 7;
+		}
+
+		unsigned int position = 16;
+		for (unsigned int i = 0; i < TexelCount; i++)
+		{
+			unsigned int bestIndex = 0;
+			int bestError = 256;
+			for (unsigned int index = 0; index < 8; index++)
+			{
+				int error = abs(values[i] - palette[index]);
+				if (error < bestError)
+				{
+					bestError = error;
+					bestIndex = index;
+				}
+			}
+
+			WriteBits(block, position, bestIndex, 3);
+		}
+	}
+
+	void BlockCompressor::CompressBC5(const unsigned char texels[64], unsigned char block[16])
+	{
+		unsigned char red[16];
+		unsigned char green[16];
+		for (unsigned int i = 0; i < TexelCount; i++)
+		{
+			red[i] = texels[i * 4 + 0];
+			green[i] = texels[i * 4 + 1];
+		}
+
+		CompressBC4(red, block);
+		CompressBC4(green, block + 8);
+	}
+
+	void BlockCompressor::CompressBC7(const unsigned char texels[64], unsigned char block[16])
+	{
+		float points[16][4];
+		LoadPoints(texels, points);
+
+		float endpoint0[4];
+		float endpoint1[4];
+		FitEndpoints(points, 4, endpoint0, endpoint1);
+
+		BC7Endpoint quantized0;
+		BC7Endpoint quantized1;
+		QuantizeBC7Endpoint(endpoint0, quantized0);
+		QuantizeBC7Endpoint(endpoint1, quantized1);
+		unsigned int indices[16];
+		float error = FitBC7Indices(points, quantized0, quantized1, indices);
+
+		float weights[16];
+		for (unsigned int i = 0; i < TexelCount; i++)
+		{
+			weights[i] = BC7Weights[indices[i]] / 64.0f;
+		}
+
+		if (RefineEndpoints(points, weights, 4, endpoint0, endpoint1))
+		{
+			BC7Endpoint refined0;
+			BC7Endpoint refined1;
+			QuantizeBC7Endpoint(endpoint0, refined0);
+			QuantizeBC7Endpoint(endpoint1, refined1);
+			unsigned int refinedIndices[16];
+			float refinedError = FitBC7Indices(points, refined0, refined1, refinedIndices);
+			if (refinedError < error)
+			{
+				quantized0 = refined0;
+				quantized1 = refined1;
+				memcpy(indices, refinedIndices, sizeof(indices));
+			}
+		}
+
+		// The first index is stored without its top bit, which must therefore be zero
+		if (indices[0] >= 8)
+		{
+			std::swap(quantized0, quantized1);
+			for (unsigned int i = 0; i < TexelCount; i++)
+			{
+				indices[i] = 15 - indices[i];
+			}
+		}
+
+		memset(block, 0, 16);
+		unsigned int position = 0;
+		WriteBits(block, position, 1 << 6, 7);
+		for (unsigned int channel = 0; channel < 4; channel++)
+		{
+			WriteBits(block, position, quantized0.Values[channel], 7);
+			WriteBits(block, position, quantized1.Values[channel], 7);
+		}
+
+		WriteBits(block, position, quantized0.PBit, 1);
+		WriteBits(block, position, quantized1.PBit, 1);
+		WriteBits(block, position, indices[0], 3);
+		for (unsigned int i = 1; i < TexelCount; i++)
+		{
+			WriteBits(block, position, indices[i], 4);
+		}
+	}
+
+	bool BlockCompressor::IsSupported(unsigned int format)
+	{
+		switch (format)
+		{
+		case DDSFormatR8G8B8A8Unorm:
+		case DDSFormatR8G8B8A8UnormSrgb:
+		case DDSFormatBC1Unorm:
+		case DDSFormatBC1UnormSrgb:
+		case DDSFormatBC3Unorm:
+		case DDSFormatBC3UnormSrgb:
+		case DDSFormatBC5Unorm:
+		case DDSFormatBC7Unorm:
+		case DDSFormatBC7UnormSrgb:
+			return true;
+
+		default:
+			return false;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "PostProcessReference.h"
+
+namespace Library
+{
+	class ThreadPool;
+
+	// Block compression for offline texture builds. Each block is fitted along its principal axis and refined once by
+	// least squares. BC7 uses mode 6 alone, a single RGBA subset with 4-bit indices, which suits smooth color and
+	// alpha and is much faster to search than the partitioned modes.
+	class BlockCompressor
+	{
+	public:
+		// Compresses an image with channels in [0, 1] to a DDSFormat: BC1, BC3, BC5, BC7 or R8G8B8A8, sRGB or not.
+		// Partial blocks at the edges repeat the last row and column. Throws std::runtime_error for other formats.
+		static void Compress(const PostProcessImage& image, unsigned int format, std::vector<unsigned char>& output, ThreadPool* threadPool = nullptr);
+
+		// Blocks are 4 x 4 RGBA texels, row by row
+		static void CompressBC1(const unsigned char texels[64], unsigned char block[8]);
+		static void CompressBC3(const unsigned char texels[64], unsigned char block[16]);
+		static void CompressBC4(const unsigned char values[16], unsigned char block[8]);
+		static void CompressBC5(const unsigned char texels[64], unsigned char block[16]);
+		static void CompressBC7(const unsigned char texels[64], unsigned char block[16]);
+
+		static bool IsSupported(unsigned int format);
+
+	private:
+		BlockCompressor();
+		BlockCompressor(const BlockCompressor& rhs);
+		BlockCompressor& operator=(const BlockCompressor& rhs);
+	};
+}
\ No newline at end of file
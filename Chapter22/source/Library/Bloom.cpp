@@ -9,6 +9,7 @@
 #include "VectorHelper.h"
 #include "MatrixHelper.h"
 #include "Utility.h"
+#include "ContentManager.h"
 #include "ColorHelper.h"
 #include "GaussianBlur.h"
 
@@ -17,29 +18,40 @@ namespace Library
     RTTI_DEFINITIONS(Bloom)
 
 	const std::string Bloom::DrawModeDisplayNames[] = { "Normal", "Extracted Texture", "Blurred Texture" };
-	const BloomSettings Bloom::DefaultBloomSettings = { 0.45f, 2.0f, 1.25f, 1.0f, 1.0f, 1.0f };
+	const BloomSettings Bloom::DefaultBloomSettings = { 0.45f, 2.0f, 1.25f, 1.0f, 1.0f, 1.0f, 0.1f, { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f } };
 
     Bloom::Bloom(Game& game, Camera& camera)
         : DrawableGameComponent(game, camera),
-          mBloomEffect(nullptr), mBloomMaterial(nullptr), mSceneTexture(nullptr), mRenderTarget(nullptr),
-		  mFullScreenQuad(nullptr), mGaussianBlur(nullptr), mBloomSettings(DefaultBloomSettings), mDrawMode(BloomDrawModeNormal), mDrawFunctions()
+          mBloomEffect(), mBloomMaterial(nullptr), mSceneTexture(nullptr), mRenderTarget(nullptr),
+		  mFullScreenQuad(nullptr), mGaussianBlur(nullptr), mBloomSettings(DefaultBloomSettings), mDrawMode(BloomDrawModeNormal), mMode(BloomModeSingleScale), mBloomTexture(nullptr),
+		  mDrawFunctions(), mUpdateMaterial(nullptr), mDownsampleTargets(), mUpsampleTargets(), mLevelTexelSizes(), mLevelWeights(), mLevel(0)
     {
     }
 
     Bloom::Bloom(Game& game, Camera& camera, const BloomSettings& bloomSettings)
         : DrawableGameComponent(game, camera),
-          mBloomEffect(nullptr), mBloomMaterial(nullptr), mSceneTexture(nullptr), mRenderTarget(nullptr),
-		  mFullScreenQuad(nullptr), mGaussianBlur(nullptr),  mBloomSettings(bloomSettings), mDrawMode(BloomDrawModeNormal), mDrawFunctions()
+          mBloomEffect(), mBloomMaterial(nullptr), mSceneTexture(nullptr), mRenderTarget(nullptr),
+		  mFullScreenQuad(nullptr), mGaussianBlur(nullptr),  mBloomSettings(bloomSettings), mDrawMode(BloomDrawModeNormal), mMode(BloomModeSingleScale), mBloomTexture(nullptr),
+		  mDrawFunctions(), mUpdateMaterial(nullptr), mDownsampleTargets(), mUpsampleTargets(), mLevelTexelSizes(), mLevelWeights(), mLevel(0)
     {
     }
 
     Bloom::~Bloom()
     {
+		for (FullScreenRenderTarget* renderTarget : mDownsampleTargets)
+		{
+			DeleteObject(renderTarget);
+		}
+
+		for (FullScreenRenderTarget* renderTarget : mUpsampleTargets)
+		{
+			DeleteObject(renderTarget);
+		}
+
 		DeleteObject(mGaussianBlur);
         DeleteObject(mFullScreenQuad);
         DeleteObject(mRenderTarget);
 		DeleteObject(mBloomMaterial);
-		DeleteObject(mBloomEffect);
     }
 
     ID3D11ShaderResourceView* Bloom::SceneTexture()
@@ -61,14 +73,14 @@ namespace Library
     {
         mBloomSettings = bloomSettings;
 		mGaussianBlur->SetBlurAmount(mBloomSettings.BlurAmount);
+		BloomChain::NormalizeWeights(mBloomSettings.LevelWeights, static_cast<UINT>(mDownsampleTargets.size()), mLevelWeights);
     }
 
     void Bloom::Initialize()
     {
         SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
-        mBloomEffect = new Effect(*mGame);
-        mBloomEffect->LoadCompiledEffect(L"Content\\Effects\\Bloom.cso");
+        mBloomEffect = mGame->Content().LoadEffect(L"Content\\Effects\\Bloom.cso");
 
         mBloomMaterial = new BloomMaterial();
         mBloomMaterial->Initialize(*mBloomEffect);
@@ -76,12 +88,17 @@ namespace Library
         mFullScreenQuad = new FullScreenQuad(*mGame, *mBloomMaterial);		
         mFullScreenQuad->Initialize();
 
+		// Bound once; each pass selects its update through mUpdateMaterial so no callable is rebuilt per frame
+		mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&Bloom::UpdateMaterial, this));
+
         mRenderTarget = new FullScreenRenderTarget(*mGame);
 
 		mGaussianBlur = new GaussianBlur(*mGame, *mCamera, mBloomSettings.BlurAmount);
 		mGaussianBlur->SetSceneTexture(*(mRenderTarget->OutputTexture()));
 		mGaussianBlur->Initialize();
 
+		InitializeMultiScaleChain();
+
 		using namespace std::placeholders;
 		mDrawFunctions[BloomDrawModeNormal] = std::bind(&Bloom::DrawNormal, this, _1);
 		mDrawFunctions[BloomDrawModeExtractedTexture1] = std::bind(&Bloom::DrawExtractedTexture, this, _1);
@@ -95,14 +112,23 @@ namespace Library
 
 	void Bloom::DrawNormal(const GameTime& gameTime)
 	{
-		if (mBloomSettings.BloomThreshold < 1.0f)
+		if (mBloomSettings.BloomThreshold < 1.0f && mMode == BloomModeMultiScale)
+		{
+			DrawMultiScaleChain(gameTime, false);
+
+			mFullScreenQuad->SetMaterial(*mBloomMaterial, "bloom_composite", "p0");
+			mUpdateMaterial = &Bloom::UpdateBloomCompositeMaterial;
+			mFullScreenQuad->Draw(gameTime);
+			mGame->UnbindPixelShaderResources(0, 2);
+		}
+		else if (mBloomSettings.BloomThreshold < 1.0f)
         {
 			// Extract the bright spots in the scene
 			mRenderTarget->Begin();
             mGame->Direct3DDeviceContext()->ClearRenderTargetView(mRenderTarget->RenderTargetView(), reinterpret_cast<const float*>(&ColorHelper::Purple));
             mGame->Direct3DDeviceContext()->ClearDepthStencilView(mRenderTarget->DepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 			mFullScreenQuad->SetMaterial(*mBloomMaterial, "bloom_extract", "p0");
-            mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&Bloom::UpdateBloomExtractMaterial, this));
+            mUpdateMaterial = &Bloom::UpdateBloomExtractMaterial;
             mFullScreenQuad->Draw(gameTime);
 			mRenderTarget->End();
 			mGame->UnbindPixelShaderResources(0, 1);
@@ -110,36 +136,51 @@ namespace Library
 			// Blur the bright spots in the scene
 			mGaussianBlur->DrawToTexture(gameTime);
 			mGame->UnbindPixelShaderResources(0, 1);
+			mBloomTexture = mGaussianBlur->OutputTexture();
 			
 			// Combine the original scene with the blurred bright spot image
 			mFullScreenQuad->SetMaterial(*mBloomMaterial, "bloom_composite", "p0");
-			mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&Bloom::UpdateBloomCompositeMaterial, this));
+			mUpdateMaterial = &Bloom::UpdateBloomCompositeMaterial;
 			mFullScreenQuad->Draw(gameTime);
 			mGame->UnbindPixelShaderResources(0, 2);
         }
         else
         {
 			mFullScreenQuad->SetMaterial(*mBloomMaterial, "no_bloom", "p0");
-            mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&Bloom::UpdateNoBloomMaterial, this));
+            mUpdateMaterial = &Bloom::UpdateNoBloomMaterial;
             mFullScreenQuad->Draw(gameTime);
         }
 	}
 
 	void Bloom::DrawExtractedTexture(const GameTime& gameTime)
 	{
+		if (mMode == BloomModeMultiScale)
+		{
+			DrawMultiScaleChain(gameTime, true);
+			DrawBloomTexture(gameTime);
+			return;
+		}
+
 		mFullScreenQuad->SetMaterial(*mBloomMaterial, "bloom_extract", "p0");
-        mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&Bloom::UpdateBloomExtractMaterial, this));
+        mUpdateMaterial = &Bloom::UpdateBloomExtractMaterial;
         mFullScreenQuad->Draw(gameTime);
 	}
 
 	void Bloom::DrawBlurredTexture(const GameTime& gameTime)
 	{
+		if (mMode == BloomModeMultiScale)
+		{
+			DrawMultiScaleChain(gameTime, false);
+			DrawBloomTexture(gameTime);
+			return;
+		}
+
 		// Extract the bright spots in the scene
 		mRenderTarget->Begin();
         mGame->Direct3DDeviceContext()->ClearRenderTargetView(mRenderTarget->RenderTargetView() , reinterpret_cast<const float*>(&ColorHelper::Purple));
         mGame->Direct3DDeviceContext()->ClearDepthStencilView(mRenderTarget->DepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 		mFullScreenQuad->SetMaterial(*mBloomMaterial, "bloom_extract", "p0");
-        mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&Bloom::UpdateBloomExtractMaterial, this));
+        mUpdateMaterial = &Bloom::UpdateBloomExtractMaterial;
         mFullScreenQuad->Draw(gameTime);			
 		mRenderTarget->End();
 		mGame->UnbindPixelShaderResources(0, 1);
@@ -147,6 +188,84 @@ namespace Library
 		mGaussianBlur->Draw(gameTime);
 	}
 
+	void Bloom::DrawBloomTexture(const GameTime& gameTime)
+	{
+		mFullScreenQuad->SetMaterial(*mBloomMaterial, "no_bloom", "p0");
+		mUpdateMaterial = &Bloom::UpdateBloomCopyMaterial;
+		mFullScreenQuad->Draw(gameTime);
+		mGame->UnbindPixelShaderResources(0, 1);
+	}
+
+	void Bloom::DrawMultiScaleChain(const GameTime& gameTime, bool prefilterOnly)
+	{
+		UINT finestLevel = BloomChain::FinestLevel(mLevelWeights);
+		UINT coarsestLevel = (prefilterOnly ? 0 : BloomChain::CoarsestLevel(mLevelWeights));
+
+		// Every texel of every level is written, so none of the targets need clearing
+		mFullScreenQuad->SetMaterial(*mBloomMaterial, "bloom_prefilter", "p0");
+		mUpdateMaterial = &Bloom::UpdatePrefilterMaterial;
+		mDownsampleTargets[0]->Begin();
+		mFullScreenQuad->Draw(gameTime);
+		mDownsampleTargets[0]->End();
+		mGame->UnbindPixelShaderResources(0, 1);
+
+		mFullScreenQuad->SetMaterial(*mBloomMaterial, "bloom_downsample", "p0");
+		mUpdateMaterial = &Bloom::UpdateDownsampleMaterial;
+		for (mLevel = 1; mLevel <= coarsestLevel; mLevel++)
+		{
+			mDownsampleTargets[mLevel]->Begin();
+			mFullScreenQuad->Draw(gameTime);
+			mDownsampleTargets[mLevel]->End();
+			mGame->UnbindPixelShaderResources(0, 1);
+		}
+
+		if (prefilterOnly || finestLevel == coarsestLevel)
+		{
+			mBloomTexture = mDownsampleTargets[prefilterOnly ? 0 : coarsestLevel]->OutputTexture();
+			return;
+		}
+
+		mFullScreenQuad->SetMaterial(*mBloomMaterial, "bloom_upsample", "p0");
+		mUpdateMaterial = &Bloom::UpdateUpsampleMaterial;
+		for (mLevel = coarsestLevel; mLevel-- > finestLevel;)
+		{
+			mUpsampleTargets[mLevel]->Begin();
+			mFullScreenQuad->Draw(gameTime);
+			mUpsampleTargets[mLevel]->End();
+			mGame->UnbindPixelShaderResources(0, 2);
+		}
+
+		mBloomTexture = mUpsampleTargets[finestLevel]->OutputTexture();
+	}
+
+	void Bloom::InitializeMultiScaleChain()
+	{
+		UINT levelCount = BloomChain::LevelCount(mGame->ScreenWidth(), mGame->ScreenHeight());
+		mLevelTexelSizes.push_back(XMFLOAT2(1.0f / mGame->ScreenWidth(), 1.0f / mGame->ScreenHeight()));
+
+		for (UINT level = 0; level < levelCount; level++)
+		{
+			UINT width;
+			UINT height;
+			BloomChain::LevelSize(mGame->ScreenWidth(), mGame->ScreenHeight(), level, width, height);
+
+			mDownsampleTargets.push_back(new FullScreenRenderTarget(*mGame, width, height));
+			if (level + 1 < levelCount)
+			{
+				mUpsampleTargets.push_back(new FullScreenRenderTarget(*mGame, width, height));
+			}
+
+			mLevelTexelSizes.push_back(XMFLOAT2(1.0f / width, 1.0f / height));
+		}
+
+		BloomChain::NormalizeWeights(mBloomSettings.LevelWeights, levelCount, mLevelWeights);
+	}
+
+	void Bloom::UpdateMaterial()
+	{
+		(this->*mUpdateMaterial)();
+	}
+
 	void Bloom::UpdateBloomExtractMaterial()
 	{
 		mBloomMaterial->ColorTexture() << mSceneTexture;
@@ -156,7 +275,7 @@ namespace Library
 	void Bloom::UpdateBloomCompositeMaterial()
 	{	
 		mBloomMaterial->ColorTexture() << mSceneTexture;
-		mBloomMaterial->BloomTexture() << mGaussianBlur->OutputTexture();
+		mBloomMaterial->BloomTexture() << mBloomTexture;
 		mBloomMaterial->BloomIntensity() << mBloomSettings.BloomIntensity;
 		mBloomMaterial->BloomSaturation() << mBloomSettings.BloomSaturation;
 		mBloomMaterial->SceneIntensity() << mBloomSettings.SceneIntensity;
@@ -168,6 +287,39 @@ namespace Library
 		mBloomMaterial->ColorTexture() << mSceneTexture;
 	}
 
+	void Bloom::UpdateBloomCopyMaterial()
+	{
+		mBloomMaterial->ColorTexture() << mBloomTexture;
+	}
+
+	// mLevelTexelSizes[0] is the scene; level i of the chain is at index i + 1
+	void Bloom::UpdatePrefilterMaterial()
+	{
+		mBloomMaterial->ColorTexture() << mSceneTexture;
+		mBloomMaterial->SourceTexelSize() << XMLoadFloat2(&mLevelTexelSizes[0]);
+		mBloomMaterial->BloomThreshold() << mBloomSettings.BloomThreshold;
+		mBloomMaterial->ThresholdKnee() << mBloomSettings.ThresholdKnee;
+	}
+
+	void Bloom::UpdateDownsampleMaterial()
+	{
+		mBloomMaterial->ColorTexture() << mDownsampleTargets[mLevel - 1]->OutputTexture();
+		mBloomMaterial->SourceTexelSize() << XMLoadFloat2(&mLevelTexelSizes[mLevel]);
+	}
+
+	void Bloom::UpdateUpsampleMaterial()
+	{
+		// The coarsest weighted level enters unaccumulated, so it still needs its own weight
+		bool isCoarsest = (mLevel + 1 == BloomChain::CoarsestLevel(mLevelWeights));
+		FullScreenRenderTarget* coarserTarget = (isCoarsest ? mDownsampleTargets[mLevel + 1] : mUpsampleTargets[mLevel + 1]);
+
+		mBloomMaterial->ColorTexture() << mDownsampleTargets[mLevel]->OutputTexture();
+		mBloomMaterial->BloomTexture() << coarserTarget->OutputTexture();
+		mBloomMaterial->SourceTexelSize() << XMLoadFloat2(&mLevelTexelSizes[mLevel + 2]);
+		mBloomMaterial->LevelWeight() << mLevelWeights[mLevel];
+		mBloomMaterial->CoarserLevelWeight() << (isCoarsest ? mLevelWeights[mLevel + 1] : 1.0f);
+	}
+
 	BloomDrawMode Bloom::DrawMode() const
 	{
 		return mDrawMode;
@@ -182,5 +334,15 @@ namespace Library
 	{
 		mDrawMode = drawMode;
 	}
+
+	BloomMode Bloom::Mode() const
+	{
+		return mMode;
+	}
+
+	void Bloom::SetMode(BloomMode mode)
+	{
+		mMode = mode;
+	}
 }
 
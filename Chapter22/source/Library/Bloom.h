@@ -3,6 +3,7 @@
 #include <functional>
 #include "Common.h"
 #include "DrawableGameComponent.h"
+#include "BloomChain.h"
 
 namespace Library
 {
@@ -20,8 +21,19 @@ namespace Library
 		float BloomSaturation;
 		float SceneIntensity;
 		float SceneSaturation;
+
+		// Multi-scale mode only; BlurAmount applies to single-scale mode only
+		float ThresholdKnee;
+		float LevelWeights[BloomChain::MaximumLevelCount];
 	} BloomSettings;
 
+	enum BloomMode
+	{
+		BloomModeSingleScale = 0,
+		BloomModeMultiScale,
+		BloomModeEnd
+	};
+
 	enum BloomDrawMode
 	{
 		BloomDrawModeNormal = 0,
@@ -49,6 +61,9 @@ namespace Library
 		std::string DrawModeString() const;
 		void SetDrawMode(BloomDrawMode drawMode);
 
+		BloomMode Mode() const;
+		void SetMode(BloomMode mode);
+
 		virtual void Initialize() override;
 		virtual void Draw(const GameTime& gameTime) override;
 
@@ -60,15 +75,23 @@ namespace Library
 		void DrawNormal(const GameTime& gameTime);
 		void DrawExtractedTexture(const GameTime& gameTime);
 		void DrawBlurredTexture(const GameTime& gameTime);
+		void DrawBloomTexture(const GameTime& gameTime);
+		void DrawMultiScaleChain(const GameTime& gameTime, bool prefilterOnly);
+		void InitializeMultiScaleChain();
 
+		void UpdateMaterial();
 		void UpdateBloomExtractMaterial();
 		void UpdateBloomCompositeMaterial();
 		void UpdateNoBloomMaterial();
+		void UpdateBloomCopyMaterial();
+		void UpdatePrefilterMaterial();
+		void UpdateDownsampleMaterial();
+		void UpdateUpsampleMaterial();
 
 		static const std::string DrawModeDisplayNames[];
 		static const BloomSettings DefaultBloomSettings;		
 
-		Effect* mBloomEffect;
+		std::shared_ptr<Effect> mBloomEffect;
 		BloomMaterial* mBloomMaterial;
 		ID3D11ShaderResourceView* mSceneTexture;
 		FullScreenRenderTarget* mRenderTarget;
@@ -76,6 +99,15 @@ namespace Library
 		GaussianBlur* mGaussianBlur;
 		BloomSettings mBloomSettings;
 		BloomDrawMode mDrawMode;
+		BloomMode mMode;
+		ID3D11ShaderResourceView* mBloomTexture;
 		std::function<void(const GameTime& gameTime)> mDrawFunctions[BloomDrawModeEnd];
+		void (Bloom::*mUpdateMaterial)();
+
+		std::vector<FullScreenRenderTarget*> mDownsampleTargets;
+		std::vector<FullScreenRenderTarget*> mUpsampleTargets;
+		std::vector<XMFLOAT2> mLevelTexelSizes;
+		std::vector<float> mLevelWeights;
+		UINT mLevel;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "BloomChain.h"
+#include <algorithm>
+#include <cassert>
+
+namespace Library
+{
+	const unsigned int BloomChain::MinimumLevelSize = 2;
+
+	unsigned int BloomChain::LevelCount(unsigned int width, unsigned int height)
+	{
+		unsigned int shorterSide = std::min(width, height);
+		unsigned int levelCount = 1;
+		while (levelCount < MaximumLevelCount && (shorterSide >> (levelCount + 1)) >= MinimumLevelSize)
+		{
+			levelCount++;
+		}
+
+		return levelCount;
+	}
+
+	void BloomChain::LevelSize(unsigned int width, unsigned int height, unsigned int level, unsigned int& levelWidth, unsigned int& levelHeight)
+	{
+		levelWidth = PostProcessGraph::ScaledSize(width, 2U << level);
+		levelHeight = PostProcessGraph::ScaledSize(height, 2U << level);
+	}
+
+	float BloomChain::SoftThreshold(float brightness, float threshold, float knee)
+	{
+		float soft = std::min(std::max(brightness - threshold + knee, 0.0f), 2.0f * knee);
+		soft = soft * soft / (4.0f * knee + 1e-5f);
+
+		return std::max(soft, brightness - threshold) / std::max(brightness, 1e-5f);
+	}
+
+	void BloomChain::NormalizeWeights(const float* weights, unsigned int levelCount, std::vector<float>& normalizedWeights)
+	{
+		assert(levelCount > 0 && levelCount <= MaximumLevelCount);
+
+		normalizedWeights.assign(weights, weights + levelCount);
+		float totalWeight = 0.0f;
+		for (float& weight : normalizedWeights)
+		{
+			weight = std::max(weight, 0.0f);
+			totalWeight += weight;
+		}
+
+		if (totalWeight <= 0.0f)
+		{
+			normalizedWeights.back() = totalWeight = 1.0f;
+		}
+
+		for (float& weight : normalizedWeights)
+		{
+			weight /= totalWeight;
+		}
+	}
+
+	unsigned int BloomChain::FinestLevel(const std::vector<float>& normalizedWeights)
+	{
+		unsigned int level = 0;
+		while (normalizedWeights[level] <= 0.0f)
+		{
+			level++;
+		}
+
+		return level;
+	}
+
+	unsigned int BloomChain::CoarsestLevel(const std::vector<float>& normalizedWeights)
+	{
+		unsigned int level = static_cast<unsigned int>(normalizedWeights.size() - 1);
+		while (normalizedWeights[level] <= 0.0f)
+		{
+			level--;
+		}
+
+		return level;
+	}
+
+	PostProcessBandwidth BloomChain::Bandwidth(unsigned int width, unsigned int height, const std::vector<float>& normalizedWeights)
+	{
+		auto levelBytes = [&](unsigned int level)
+		{
+			unsigned int levelWidth;
+			unsigned int levelHeight;
+			LevelSize(width, height, level, levelWidth, levelHeight);
+
+			return static_cast<unsigned long long>(levelWidth) * levelHeight * PostProcessGraph::BytesPerTexel;
+		};
+
+		const unsigned long long sceneBytes = static_cast<unsigned long long>(width) * height * PostProcessGraph::BytesPerTexel;
+		unsigned int finestLevel = FinestLevel(normalizedWeights);
+		unsigned int coarsestLevel = CoarsestLevel(normalizedWeights);
+
+		PostProcessBandwidth bandwidth = { 0, 0, 0, 0 };
+
+		// Prefilter from the scene, then each downsample reads the level above it
+		bandwidth.BytesRead += sceneBytes;
+		bandwidth.BytesWritten += levelBytes(0);
+		for (unsigned int level = 1; level <= coarsestLevel; level++)
+		{
+			bandwidth.BytesRead += levelBytes(level - 1);
+			bandwidth.BytesWritten += levelBytes(level);
+		}
+
+		// Each upsample reads its own downsampled level and the coarser result
+		for (unsigned int level = finestLevel; level < coarsestLevel; level++)
+		{
+			bandwidth.BytesRead += levelBytes(level) + levelBytes(level + 1);
+			bandwidth.BytesWritten += levelBytes(level);
+		}
+
+		// The composite reads the scene and the finest rendered level
+		bandwidth.BytesRead += sceneBytes + levelBytes(finestLevel);
+		bandwidth.BytesWritten += sceneBytes;
+
+		// Down and up chains are allocated for every level the screen supports
+		unsigned int levelCount = LevelCount(width, height);
+		for (unsigned int level = 0; level < levelCount; level++)
+		{
+			bandwidth.TransientBytes += levelBytes(level) * (level + 1 < levelCount ? 2 : 1);
+		}
+
+		bandwidth.UnaliasedTransientBytes = bandwidth.TransientBytes;
+
+		return bandwidth;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+// Portable like BlurKernel: sizing and weighting of the multi-scale bloom chain, shared by Bloom and BloomReference
+#include <vector>
+#include "PostProcessGraph.h"
+
+namespace Library
+{
+	// Level 0 is half the screen resolution and each further level halves again. Bright texels are soft-thresholded
+	// into level 0 with a 13-tap filter, filtered down the chain the same way, then recombined bottom-up with 3x3 tent
+	// upsamples: Up[i] = Down[i] * Weight[i] + Tent(Up[i + 1]).
+	class BloomChain
+	{
+	public:
+		static const unsigned int MaximumLevelCount = 6;
+
+		// Levels whose shorter side keeps at least MinimumLevelSize texels, up to MaximumLevelCount
+		static unsigned int LevelCount(unsigned int width, unsigned int height);
+		static void LevelSize(unsigned int width, unsigned int height, unsigned int level, unsigned int& levelWidth, unsigned int& levelHeight);
+
+		// Scale applied to a texel of the given brightness (max of r, g, b). The knee eases the cut-off quadratically
+		// over [threshold - knee, threshold + knee]; a knee of zero is a hard threshold.
+		static float SoftThreshold(float brightness, float threshold, float knee);
+
+		// Truncates to levelCount and normalizes so the weights sum to one; all-zero weights select the coarsest level
+		static void NormalizeWeights(const float* weights, unsigned int levelCount, std::vector<float>& normalizedWeights);
+
+		// Range of levels that must be rendered: the chain stops below the coarsest weighted level, and
+		// unweighted fine levels are skipped by the upsample, which is where wide glows save bandwidth
+		static unsigned int FinestLevel(const std::vector<float>& normalizedWeights);
+		static unsigned int CoarsestLevel(const std::vector<float>& normalizedWeights);
+
+		static PostProcessBandwidth Bandwidth(unsigned int width, unsigned int height, const std::vector<float>& normalizedWeights);
+
+		static const unsigned int MinimumLevelSize;
+
+	private:
+		BloomChain();
+		BloomChain(const BloomChain& rhs);
+		BloomChain& operator=(const BloomChain& rhs);
+	};
+}
\ No newline at end of file
@@ -9,7 +9,9 @@ namespace Library
 		: PostProcessingMaterial(),
 		  MATERIAL_VARIABLE_INITIALIZATION(BloomTexture), MATERIAL_VARIABLE_INITIALIZATION(BloomThreshold),
 		  MATERIAL_VARIABLE_INITIALIZATION(BloomIntensity), MATERIAL_VARIABLE_INITIALIZATION(BloomSaturation),
-		  MATERIAL_VARIABLE_INITIALIZATION(SceneIntensity), MATERIAL_VARIABLE_INITIALIZATION(SceneSaturation)
+		  MATERIAL_VARIABLE_INITIALIZATION(SceneIntensity), MATERIAL_VARIABLE_INITIALIZATION(SceneSaturation),
+		  MATERIAL_VARIABLE_INITIALIZATION(ThresholdKnee), MATERIAL_VARIABLE_INITIALIZATION(SourceTexelSize),
+		  MATERIAL_VARIABLE_INITIALIZATION(LevelWeight), MATERIAL_VARIABLE_INITIALIZATION(CoarserLevelWeight)
 	{
 	}
 
@@ -19,6 +21,10 @@ namespace Library
 	MATERIAL_VARIABLE_DEFINITION(BloomMaterial, BloomSaturation)
 	MATERIAL_VARIABLE_DEFINITION(BloomMaterial, SceneIntensity)
 	MATERIAL_VARIABLE_DEFINITION(BloomMaterial, SceneSaturation)
+	MATERIAL_VARIABLE_DEFINITION(BloomMaterial, ThresholdKnee)
+	MATERIAL_VARIABLE_DEFINITION(BloomMaterial, SourceTexelSize)
+	MATERIAL_VARIABLE_DEFINITION(BloomMaterial, LevelWeight)
+	MATERIAL_VARIABLE_DEFINITION(BloomMaterial, CoarserLevelWeight)
 
 	void BloomMaterial::Initialize(Effect& effect)
 	{
@@ -30,5 +36,9 @@ namespace Library
 		MATERIAL_VARIABLE_RETRIEVE(BloomSaturation)
 		MATERIAL_VARIABLE_RETRIEVE(SceneIntensity)
 		MATERIAL_VARIABLE_RETRIEVE(SceneSaturation)
+		MATERIAL_VARIABLE_RETRIEVE(ThresholdKnee)
+		MATERIAL_VARIABLE_RETRIEVE(SourceTexelSize)
+		MATERIAL_VARIABLE_RETRIEVE(LevelWeight)
+		MATERIAL_VARIABLE_RETRIEVE(CoarserLevelWeight)
 	}
 }
\ No newline at end of file
@@ -15,6 +15,10 @@ namespace Library
 		MATERIAL_VARIABLE_DECLARATION(BloomSaturation)
 		MATERIAL_VARIABLE_DECLARATION(SceneIntensity)
 		MATERIAL_VARIABLE_DECLARATION(SceneSaturation)
+		MATERIAL_VARIABLE_DECLARATION(ThresholdKnee)
+		MATERIAL_VARIABLE_DECLARATION(SourceTexelSize)
+		MATERIAL_VARIABLE_DECLARATION(LevelWeight)
+		MATERIAL_VARIABLE_DECLARATION(CoarserLevelWeight)
 
 	public:
 		BloomMaterial();
@@ -0,0 +1,174 @@
+#include "BloomReference.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <xmmintrin.h>
+
+namespace Library
+{
+	namespace
+	{
+		inline __m128 LoadTexel(const PostProcessImage& image, int x, int y)
+		{
+			x = std::min(std::max(x, 0), static_cast<int>(image.Width) - 1);
+			y = std::min(std::max(y, 0), static_cast<int>(image.Height) - 1);
+
+			return _mm_loadu_ps(&image.Texels[(static_cast<size_t>(y) * image.Width + x) * 4]);
+		}
+
+		inline void StoreTexel(PostProcessImage& image, unsigned int x, unsigned int y, __m128 value)
+		{
+			_mm_storeu_ps(&image.Texels[(static_cast<size_t>(y) * image.Width + x) * 4], value);
+		}
+
+		// Clamped bilinear fetch; (u, v) are in texels with centres at i + 0.5
+		__m128 SampleBilinear(const PostProcessImage& image, float u, float v)
+		{
+			u -= 0.5f;
+			v -= 0.5f;
+			float floorU = std::floor(u);
+			float floorV = std::floor(v);
+			int x = static_cast<int>(floorU);
+			int y = static_cast<int>(floorV);
+			__m128 fractionU = _mm_set1_ps(u - floorU);
+			__m128 fractionV = _mm_set1_ps(v - floorV);
+
+			__m128 top = LoadTexel(image, x, y);
+			top = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(LoadTexel(image, x + 1, y), top), fractionU));
+			__m128 bottom = LoadTexel(image, x, y + 1);
+			bottom = _mm_add_ps(bottom, _mm_mul_ps(_mm_sub_ps(LoadTexel(image, x + 1, y + 1), bottom), fractionU));
+
+			return _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), fractionV));
+		}
+
+		// Jimenez's 13 taps: four overlapping 2x2 boxes at the corners weighted 1/8 each, and the inner box 1/2
+		__m128 Sample13(const PostProcessImage& source, float u, float v)
+		{
+			__m128 a = SampleBilinear(source, u - 2.0f, v - 2.0f);
+			__m128 b = SampleBilinear(source, u, v - 2.0f);
+			__m128 c = SampleBilinear(source, u + 2.0f, v - 2.0f);
+			__m128 d = SampleBilinear(source, u - 1.0f, v - 1.0f);
+			__m128 e = SampleBilinear(source, u + 1.0f, v - 1.0f);
+			__m128 f = SampleBilinear(source, u - 2.0f, v);
+			__m128 g = SampleBilinear(source, u, v);
+			__m128 h = SampleBilinear(source, u + 2.0f, v);
+			__m128 i = SampleBilinear(source, u - 1.0f, v + 1.0f);
+			__m128 j = SampleBilinear(source, u + 1.0f, v + 1.0f);
+			__m128 k = SampleBilinear(source, u - 2.0f, v + 2.0f);
+			__m128 l = SampleBilinear(source, u, v + 2.0f);
+			__m128 m = SampleBilinear(source, u + 2.0f, v + 2.0f);
+
+			__m128 inner = _mm_add_ps(_mm_add_ps(d, e), _mm_add_ps(i, j));
+			__m128 corners = _mm_add_ps(_mm_add_ps(a, c), _mm_add_ps(k, m));
+			__m128 edges = _mm_add_ps(_mm_add_ps(b, f), _mm_add_ps(h, l));
+
+			__m128 sum = _mm_mul_ps(inner, _mm_set1_ps(0.5f / 4.0f));
+			sum = _mm_add_ps(sum, _mm_mul_ps(corners, _mm_set1_ps(0.125f / 4.0f)));
+			sum = _mm_add_ps(sum, _mm_mul_ps(edges, _mm_set1_ps(0.125f * 2.0f / 4.0f)));
+
+			return _mm_add_ps(sum, _mm_mul_ps(g, _mm_set1_ps(0.125f * 4.0f / 4.0f)));
+		}
+
+		template <typename Filter>
+		void Resample(const PostProcessImage& source, unsigned int width, unsigned int height, PostProcessImage& destination, Filter filter)
+		{
+			PostProcessReference::ResizeImage(destination, width, height);
+			float scaleU = static_cast<float>(source.Width) / width;
+			float scaleV = static_cast<float>(source.Height) / height;
+
+			for (unsigned int y = 0; y < height; y++)
+			{
+				for (unsigned int x = 0; x < width; x++)
+				{
+					StoreTexel(destination, x, y, filter((x + 0.5f) * scaleU, (y + 0.5f) * scaleV, x, y));
+				}
+			}
+
+			PostProcessReference::QuantizeImage(destination);
+		}
+	}
+
+	void BloomReference::Execute(const PostProcessImage& scene, float threshold, float knee, const std::vector<float>& normalizedWeights, PostProcessImage& bloom)
+	{
+		unsigned int finestLevel = BloomChain::FinestLevel(normalizedWeights);
+		unsigned int coarsestLevel = BloomChain::CoarsestLevel(normalizedWeights);
+
+		std::vector<PostProcessImage> levels(coarsestLevel + 1);
+		Prefilter(scene, threshold, knee, levels[0]);
+		for (unsigned int level = 1; level <= coarsestLevel; level++)
+		{
+			Downsample(levels[level - 1], levels[level]);
+		}
+
+		if (finestLevel == coarsestLevel)
+		{
+			bloom = levels[coarsestLevel];
+			return;
+		}
+
+		// The coarsest level enters the first upsample with its own weight; later ones carry the accumulated sum
+		PostProcessImage upsampled = levels[coarsestLevel];
+		float coarserWeight = normalizedWeights[coarsestLevel];
+		for (unsigned int level = coarsestLevel; level-- > finestLevel;)
+		{
+			PostProcessImage destination;
+			Upsample(levels[level], normalizedWeights[level], upsampled, coarserWeight, destination);
+			upsampled.Texels.swap(destination.Texels);
+			upsampled.Width = destination.Width;
+			upsampled.Height = destination.Height;
+			coarserWeight = 1.0f;
+		}
+
+		bloom = upsampled;
+	}
+
+	void BloomReference::Prefilter(const PostProcessImage& scene, float threshold, float knee, PostProcessImage& destination)
+	{
+		unsigned int width;
+		unsigned int height;
+		BloomChain::LevelSize(scene.Width, scene.Height, 0, width, height);
+
+		Resample(scene, width, height, destination, [&](float u, float v, unsigned int, unsigned int)
+		{
+			__m128 color = Sample13(scene, u, v);
+
+			float channels[4];
+			_mm_storeu_ps(channels, color);
+			float brightness = std::max(std::max(channels[0], channels[1]), channels[2]);
+
+			return _mm_mul_ps(color, _mm_set1_ps(BloomChain::SoftThreshold(brightness, threshold, knee)));
+		});
+	}
+
+	void BloomReference::Downsample(const PostProcessImage& source, PostProcessImage& destination)
+	{
+		Resample(source, PostProcessGraph::ScaledSize(source.Width, 2), PostProcessGraph::ScaledSize(source.Height, 2), destination, [&](float u, float v, unsigned int, unsigned int)
+		{
+			return Sample13(source, u, v);
+		});
+	}
+
+	void BloomReference::Upsample(const PostProcessImage& level, float levelWeight, const PostProcessImage& coarserLevel, float coarserWeight, PostProcessImage& destination)
+	{
+		float scaleU = static_cast<float>(coarserLevel.Width) / level.Width;
+		float scaleV = static_cast<float>(coarserLevel.Height) / level.Height;
+
+		Resample(level, level.Width, level.Height, destination, [&](float, float, unsigned int x, unsigned int y)
+		{
+			float u = (x + 0.5f) * scaleU;
+			float v = (y + 0.5f) * scaleV;
+
+			// 3x3 tent one coarse texel wide: corners 1, edges 2, centre 4, over 16
+			__m128 corners = _mm_add_ps(_mm_add_ps(SampleBilinear(coarserLevel, u - 1.0f, v - 1.0f), SampleBilinear(coarserLevel, u + 1.0f, v - 1.0f)),
+				_mm_add_ps(SampleBilinear(coarserLevel, u - 1.0f, v + 1.0f), SampleBilinear(coarserLevel, u + 1.0f, v + 1.0f)));
+			__m128 edges = _mm_add_ps(_mm_add_ps(SampleBilinear(coarserLevel, u, v - 1.0f), SampleBilinear(coarserLevel, u - 1.0f, v)),
+				_mm_add_ps(SampleBilinear(coarserLevel, u + 1.0f, v), SampleBilinear(coarserLevel, u, v + 1.0f)));
+			__m128 centre = SampleBilinear(coarserLevel, u, v);
+
+			__m128 tent = _mm_add_ps(corners, _mm_add_ps(_mm_mul_ps(edges, _mm_set1_ps(2.0f)), _mm_mul_ps(centre, _mm_set1_ps(4.0f))));
+			tent = _mm_mul_ps(tent, _mm_set1_ps(coarserWeight / 16.0f));
+
+			return _mm_add_ps(tent, _mm_mul_ps(LoadTexel(level, x, y), _mm_set1_ps(levelWeight)));
+		});
+	}
+}
\ No newline at end of file
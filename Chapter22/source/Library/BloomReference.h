@@ -0,0 +1,25 @@
+#pragma once
+
+#include "BloomChain.h"
+#include "PostProcessReference.h"
+
+namespace Library
+{
+	// CPU execution of the multi-scale bloom chain in Bloom.fx, quantizing each level to RGBA8 as the GPU stores it.
+	// Produces the bloom texture the composite samples; the composite itself matches PostProcessReference.
+	class BloomReference
+	{
+	public:
+		// normalizedWeights come from BloomChain::NormalizeWeights(); the result is at the finest weighted level's size
+		static void Execute(const PostProcessImage& scene, float threshold, float knee, const std::vector<float>& normalizedWeights, PostProcessImage& bloom);
+
+		static void Prefilter(const PostProcessImage& scene, float threshold, float knee, PostProcessImage& destination);
+		static void Downsample(const PostProcessImage& source, PostProcessImage& destination);
+		static void Upsample(const PostProcessImage& level, float levelWeight, const PostProcessImage& coarserLevel, float coarserWeight, PostProcessImage& destination);
+
+	private:
+		BloomReference();
+		BloomReference(const BloomReference& rhs);
+		BloomReference& operator=(const BloomReference& rhs);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "BlurKernel.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Library
+{
+	const unsigned int BlurKernel::AllTechniques = (1 << BlurTechniqueEnd) - 1;
+	const unsigned int BlurKernel::BoxPassCount = 3;
+	const unsigned int BlurKernel::MaximumDualKawaseIterations = 8;
+	const float BlurKernel::DualKawaseTolerance = 0.25f;
+
+	namespace
+	{
+		// Standard deviation, in source texels, of the response of 1..8 dual Kawase iterations (down then up).
+		// Measured with BlurReference::DualKawase on a line impulse 1024 texels wide; the last entry is extrapolated.
+		const float DualKawaseSigmas[] = { 1.68f, 3.76f, 7.71f, 15.5f, 31.1f, 62.2f, 124.4f, 248.8f };
+	}
+
+	unsigned int BlurKernel::GaussianRadius(float sigma)
+	{
+		// Three standard deviations hold 99.7% of the weight
+		return (sigma > 0.0f ? static_cast<unsigned int>(std::ceil(sigma * 3.0f)) : 0);
+	}
+
+	void BlurKernel::ComputeGaussianWeights(float sigma, std::vector<float>& weights)
+	{
+		unsigned int radius = GaussianRadius(sigma);
+		weights.assign(radius * 2 + 1, 0.0f);
+		if (radius == 0)
+		{
+			weights[0] = 1.0f;
+			return;
+		}
+
+		float totalWeight = 0.0f;
+		for (unsigned int i = 0; i < weights.size(); i++)
+		{
+			float x = static_cast<float>(static_cast<int>(i) - static_cast<int>(radius));
+			weights[i] = std::exp(-(x * x) / (2.0f * sigma * sigma));
+			totalWeight += weights[i];
+		}
+
+		for (float& weight : weights)
+		{
+			weight /= totalWeight;
+		}
+	}
+
+	void BlurKernel::ComputeLinearGaussianSamples(float sigma, std::vector<BlurSample>& samples)
+	{
+		std::vector<float> weights;
+		ComputeGaussianWeights(sigma, weights);
+
+		unsigned int radius = static_cast<unsigned int>(weights.size() / 2);
+		samples.clear();
+		samples.reserve(LinearGaussianSampleCount(sigma));
+
+		BlurSample centre = { 0.0f, weights[radius] };
+		samples.push_back(centre);
+
+		// Texels i and i + 1 are fetched together by sampling between them in proportion to their weights
+		for (unsigned int i = 1; i <= radius; i += 2)
+		{
+			float firstWeight = weights[radius + i];
+			float secondWeight = (i + 1 <= radius ? weights[radius + i + 1] : 0.0f);
+
+			BlurSample sample;
+			sample.Weight = firstWeight + secondWeight;
+			sample.Offset = (i * firstWeight + (i + 1) * secondWeight) / sample.Weight;
+
+			samples.push_back(sample);
+			sample.Offset = -sample.Offset;
+			samples.push_back(sample);
+		}
+	}
+
+	unsigned int BlurKernel::LinearGaussianSampleCount(float sigma)
+	{
+		return 1 + ((GaussianRadius(sigma) + 1) / 2) * 2;
+	}
+
+	unsigned int BlurKernel::DualKawaseIterations(float sigma)
+	{
+		// The iteration count whose response is closest in log space
+		unsigned int bestIterations = 1;
+		float bestError = HUGE_VALF;
+		for (unsigned int i = 1; i <= MaximumDualKawaseIterations; i++)
+		{
+			float error = std::fabs(std::log(DualKawaseSigma(i) / std::max(sigma, 0.01f)));
+			if (error < bestError)
+			{
+				bestError = error;
+				bestIterations = i;
+			}
+		}
+
+		return bestIterations;
+	}
+
+	float BlurKernel::DualKawaseSigma(unsigned int iterations)
+	{
+		assert(iterations > 0 && iterations <= MaximumDualKawaseIterations);
+
+		return DualKawaseSigmas[iterations - 1];
+	}
+
+	void BlurKernel::ComputeBoxWidths(float sigma, std::vector<unsigned int>& widths)
+	{
+		// Box widths whose summed variances equal sigma squared (Kovesi, "Fast Almost-Gaussian Filtering")
+		const float passCount = static_cast<float>(BoxPassCount);
+		float idealWidth = std::sqrt(12.0f * sigma * sigma / passCount + 1.0f);
+
+		int lowerWidth = static_cast<int>(std::floor(idealWidth));
+		if (lowerWidth % 2 == 0)
+		{
+			lowerWidth--;
+		}
+
+		lowerWidth = std::max(lowerWidth, 1);
+		int upperWidth = lowerWidth + 2;
+
+		float idealLowerCount = (12.0f * sigma * sigma - passCount * lowerWidth * lowerWidth - 4.0f * passCount * lowerWidth - 3.0f * passCount) / (-4.0f * lowerWidth - 4.0f);
+		int lowerCount = static_cast<int>(std::floor(idealLowerCount + 0.5f));
+
+		widths.resize(BoxPassCount);
+		for (int i = 0; i < static_cast<int>(BoxPassCount); i++)
+		{
+			widths[i] = (i < lowerCount ? lowerWidth : upperWidth);
+		}
+	}
+
+	double BlurKernel::EstimateCost(BlurTechnique technique, float sigma, unsigned int width, unsigned int height)
+	{
+		const double texelCount = static_cast<double>(width) * height;
+
+		switch (technique)
+		{
+		case BlurTechniqueGaussian:
+		{
+			// Horizontal and vertical passes at full resolution
+			double sampleCount = LinearGaussianSampleCount(sigma);
+			return 2.0 * texelCount * (sampleCount + 1.0);
+		}
+
+		case BlurTechniqueDualKawase:
+		{
+			// Level k holds texelCount / 4^k texels; down passes fetch 5 samples, up passes fetch 8
+			unsigned int iterations = DualKawaseIterations(sigma);
+			double cost = 0.0;
+			for (unsigned int level = 1; level <= iterations; level++)
+			{
+				double levelTexels = texelCount / std::pow(4.0, static_cast<double>(level));
+				cost += levelTexels * (5.0 + 1.0);
+				cost += levelTexels * 4.0 * (8.0 + 1.0);
+			}
+
+			return cost;
+		}
+
+		case BlurTechniqueBox:
+			// Running sums: one fetch entering and one leaving the window, per pass and axis
+			return 2.0 * BoxPassCount * texelCount * (2.0 + 1.0);
+
+		default:
+			assert(false);
+			return HUGE_VAL;
+		}
+	}
+
+	BlurTechnique BlurKernel::SelectTechnique(float sigma, unsigned int width, unsigned int height, unsigned int techniqueMask, unsigned int maximumSampleCount)
+	{
+		BlurTechnique bestTechnique = BlurTechniqueGaussian;
+		double bestCost = HUGE_VAL;
+
+		for (int i = 0; i < BlurTechniqueEnd; i++)
+		{
+			BlurTechnique technique = static_cast<BlurTechnique>(i);
+			if ((techniqueMask & (1 << i)) == 0)
+			{
+				continue;
+			}
+
+			if (technique == BlurTechniqueGaussian && maximumSampleCount > 0 && LinearGaussianSampleCount(sigma) > maximumSampleCount)
+			{
+				continue;
+			}
+
+			if (technique == BlurTechniqueDualKawase && std::fabs(DualKawaseSigma(DualKawaseIterations(sigma)) / sigma - 1.0f) > DualKawaseTolerance)
+			{
+				continue;
+			}
+
+			double cost = EstimateCost(technique, sigma, width, height);
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestTechnique = technique;
+			}
+		}
+
+		return bestTechnique;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+// Free of Windows and Direct3D headers, like PostProcessGraph, so the kernels can be checked headlessly
+#include <vector>
+
+namespace Library
+{
+	enum BlurTechnique
+	{
+		BlurTechniqueGaussian = 0,
+		BlurTechniqueDualKawase,
+		BlurTechniqueBox,
+		BlurTechniqueEnd
+	};
+
+	typedef struct _BlurSample
+	{
+		float Offset;
+		float Weight;
+	} BlurSample;
+
+	// Kernel construction and cost estimates for separable and pyramid blurs. Sigma is in texels.
+	class BlurKernel
+	{
+	public:
+		static unsigned int GaussianRadius(float sigma);
+
+		// Discrete weights for taps -radius..radius, normalized to sum to one
+		static void ComputeGaussianWeights(float sigma, std::vector<float>& weights);
+
+		// Adjacent taps merged into single bilinear fetches: the centre sample first, then +/- pairs
+		static void ComputeLinearGaussianSamples(float sigma, std::vector<BlurSample>& samples);
+		static unsigned int LinearGaussianSampleCount(float sigma);
+
+		static unsigned int DualKawaseIterations(float sigma);
+		static float DualKawaseSigma(unsigned int iterations);
+
+		// Widths of successive box passes whose combined variance approximates the Gaussian
+		static void ComputeBoxWidths(float sigma, std::vector<unsigned int>& widths);
+
+		// Texture fetches plus texel writes, for a width x height image
+		static double EstimateCost(BlurTechnique technique, float sigma, unsigned int width, unsigned int height);
+
+		// Picks the cheapest technique among those set in techniqueMask (bit = 1 << technique). Gaussian kernels needing
+		// more than maximumSampleCount bilinear samples, and dual Kawase chains that miss sigma by more than
+		// DualKawaseTolerance, are excluded.
+		static BlurTechnique SelectTechnique(float sigma, unsigned int width, unsigned int height, unsigned int techniqueMask = AllTechniques, unsigned int maximumSampleCount = 0);
+
+		static const unsigned int AllTechniques;
+		static const unsigned int BoxPassCount;
+		static const unsigned int MaximumDualKawaseIterations;
+		static const float DualKawaseTolerance;
+
+	private:
+		BlurKernel();
+		BlurKernel(const BlurKernel& rhs);
+		BlurKernel& operator=(const BlurKernel& rhs);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "BlurReference.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <xmmintrin.h>
+
+namespace Library
+{
+	namespace
+	{
+		inline __m128 LoadTexel(const PostProcessImage& image, int x, int y)
+		{
+			x = std::min(std::max(x, 0), static_cast<int>(image.Width) - 1);
+			y = std::min(std::max(y, 0), static_cast<int>(image.Height) - 1);
+
+			return _mm_loadu_ps(&image.Texels[(static_cast<size_t>(y) * image.Width + x) * 4]);
+		}
+
+		inline void StoreTexel(PostProcessImage& image, unsigned int x, unsigned int y, __m128 value)
+		{
+			_mm_storeu_ps(&image.Texels[(static_cast<size_t>(y) * image.Width + x) * 4], value);
+		}
+
+		// Bilinear fetch at a continuous texel-space position (texel centres at i + 0.5), as a GPU sampler does
+		__m128 SampleBilinear(const PostProcessImage& image, float u, float v)
+		{
+			u -= 0.5f;
+			v -= 0.5f;
+			float floorU = std::floor(u);
+			float floorV = std::floor(v);
+			int x = static_cast<int>(floorU);
+			int y = static_cast<int>(floorV);
+			__m128 fractionU = _mm_set1_ps(u - floorU);
+			__m128 fractionV = _mm_set1_ps(v - floorV);
+
+			__m128 top = LoadTexel(image, x, y);
+			top = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(LoadTexel(image, x + 1, y), top), fractionU));
+			__m128 bottom = LoadTexel(image, x, y + 1);
+			bottom = _mm_add_ps(bottom, _mm_mul_ps(_mm_sub_ps(LoadTexel(image, x + 1, y + 1), bottom), fractionU));
+
+			return _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), fractionV));
+		}
+
+		void ConvolveDiscrete(const PostProcessImage& source, const std::vector<float>& weights, bool horizontal, PostProcessImage& destination)
+		{
+			PostProcessReference::ResizeImage(destination, source.Width, source.Height);
+			int radius = static_cast<int>(weights.size() / 2);
+
+			for (int y = 0; y < static_cast<int>(source.Height); y++)
+			{
+				for (int x = 0; x < static_cast<int>(source.Width); x++)
+				{
+					__m128 sum = _mm_setzero_ps();
+					for (int i = -radius; i <= radius; i++)
+					{
+						__m128 texel = (horizontal ? LoadTexel(source, x + i, y) : LoadTexel(source, x, y + i));
+						sum = _mm_add_ps(sum, _mm_mul_ps(texel, _mm_set1_ps(weights[i + radius])));
+					}
+
+					StoreTexel(destination, x, y, sum);
+				}
+			}
+		}
+
+		void ConvolveLinear(const PostProcessImage& source, const std::vector<BlurSample>& samples, bool horizontal, PostProcessImage& destination)
+		{
+			PostProcessReference::ResizeImage(destination, source.Width, source.Height);
+
+			for (unsigned int y = 0; y < source.Height; y++)
+			{
+				for (unsigned int x = 0; x < source.Width; x++)
+				{
+					float u = x + 0.5f;
+					float v = y + 0.5f;
+
+					__m128 sum = _mm_setzero_ps();
+					for (const BlurSample& sample : samples)
+					{
+						__m128 texel = (horizontal ? SampleBilinear(source, u + sample.Offset, v) : SampleBilinear(source, u, v + sample.Offset));
+						sum = _mm_add_ps(sum, _mm_mul_ps(texel, _mm_set1_ps(sample.Weight)));
+					}
+
+					StoreTexel(destination, x, y, sum);
+				}
+			}
+		}
+
+		void KawaseDownsample(const PostProcessImage& source, PostProcessImage& destination)
+		{
+			PostProcessReference::ResizeImage(destination, std::max(source.Width / 2, 1U), std::max(source.Height / 2, 1U));
+			float scaleX = static_cast<float>(source.Width) / destination.Width;
+			float scaleY = static_cast<float>(source.Height) / destination.Height;
+
+			// Centre weighted 4 plus four diagonal samples one source texel away, over 8
+			for (unsigned int y = 0; y < destination.Height; y++)
+			{
+				for (unsigned int x = 0; x < destination.Width; x++)
+				{
+					float u = (x + 0.5f) * scaleX;
+					float v = (y + 0.5f) * scaleY;
+
+					__m128 sum = _mm_mul_ps(SampleBilinear(source, u, v), _mm_set1_ps(4.0f));
+					sum = _mm_add_ps(sum, SampleBilinear(source, u - 1.0f, v - 1.0f));
+					sum = _mm_add_ps(sum, SampleBilinear(source, u + 1.0f, v - 1.0f));
+					sum = _mm_add_ps(sum, SampleBilinear(source, u - 1.0f, v + 1.0f));
+					sum = _mm_add_ps(sum, SampleBilinear(source, u + 1.0f, v + 1.0f));
+
+					StoreTexel(destination, x, y, _mm_mul_ps(sum, _mm_set1_ps(1.0f / 8.0f)));
+				}
+			}
+		}
+
+		void KawaseUpsample(const PostProcessImage& source, unsigned int width, unsigned int height, PostProcessImage& destination)
+		{
+			PostProcessReference::ResizeImage(destination, width, height);
+			float scaleX = static_cast<float>(source.Width) / destination.Width;
+			float scaleY = static_cast<float>(source.Height) / destination.Height;
+
+			// Axis samples one source texel away weighted 1, diagonal samples half a texel away weighted 2, over 12
+			for (unsigned int y = 0; y < destination.Height; y++)
+			{
+				for (unsigned int x = 0; x < destination.Width; x++)
+				{
+					float u = (x + 0.5f) * scaleX;
+					float v = (y + 0.5f) * scaleY;
+
+					__m128 sum = SampleBilinear(source, u - 1.0f, v);
+					sum = _mm_add_ps(sum, SampleBilinear(source, u + 1.0f, v));
+					sum = _mm_add_ps(sum, SampleBilinear(source, u, v - 1.0f));
+					sum = _mm_add_ps(sum, SampleBilinear(source, u, v + 1.0f));
+
+					__m128 diagonals = SampleBilinear(source, u - 0.5f, v - 0.5f);
+					diagonals = _mm_add_ps(diagonals, SampleBilinear(source, u + 0.5f, v - 0.5f));
+					diagonals = _mm_add_ps(diagonals, SampleBilinear(source, u - 0.5f, v + 0.5f));
+					diagonals = _mm_add_ps(diagonals, SampleBilinear(source, u + 0.5f, v + 0.5f));
+					sum = _mm_add_ps(sum, _mm_mul_ps(diagonals, _mm_set1_ps(2.0f)));
+
+					StoreTexel(destination, x, y, _mm_mul_ps(sum, _mm_set1_ps(1.0f / 12.0f)));
+				}
+			}
+		}
+
+		void BoxPass(const PostProcessImage& source, unsigned int boxWidth, bool horizontal, PostProcessImage& destination)
+		{
+			PostProcessReference::ResizeImage(destination, source.Width, source.Height);
+
+			int radius = static_cast<int>(boxWidth / 2);
+			int lineCount = static_cast<int>(horizontal ? source.Height : source.Width);
+			int lineLength = static_cast<int>(horizontal ? source.Width : source.Height);
+			__m128 inverseWidth = _mm_set1_ps(1.0f / boxWidth);
+
+			for (int line = 0; line < lineCount; line++)
+			{
+				auto load = [&](int i) { return (horizontal ? LoadTexel(source, i, line) : LoadTexel(source, line, i)); };
+
+				__m128 sum = _mm_setzero_ps();
+				for (int i = -radius; i <= radius; i++)
+				{
+					sum = _mm_add_ps(sum, load(i));
+				}
+
+				// O(1) per texel regardless of width: add the texel entering the window, drop the one leaving
+				for (int i = 0; i < lineLength; i++)
+				{
+					__m128 average = _mm_mul_ps(sum, inverseWidth);
+					if (horizontal)
+					{
+						StoreTexel(destination, i, line, average);
+					}
+					else
+					{
+						StoreTexel(destination, line, i, average);
+					}
+
+					sum = _mm_add_ps(sum, _mm_sub_ps(load(i + radius + 1), load(i - radius)));
+				}
+			}
+		}
+	}
+
+	void BlurReference::Blur(BlurTechnique technique, const PostProcessImage& source, float sigma, PostProcessImage& destination)
+	{
+		switch (technique)
+		{
+		case BlurTechniqueGaussian:
+			LinearGaussian(source, sigma, destination);
+			break;
+
+		case BlurTechniqueDualKawase:
+			DualKawase(source, BlurKernel::DualKawaseIterations(sigma), destination);
+			break;
+
+		case BlurTechniqueBox:
+			Box(source, sigma, destination);
+			break;
+
+		default:
+			assert(false);
+			break;
+		}
+	}
+
+	void BlurReference::Gaussian(const PostProcessImage& source, float sigma, PostProcessImage& destination)
+	{
+		std::vector<float> weights;
+		BlurKernel::ComputeGaussianWeights(sigma, weights);
+
+		PostProcessImage intermediate;
+		ConvolveDiscrete(source, weights, true, intermediate);
+		ConvolveDiscrete(intermediate, weights, false, destination);
+	}
+
+	void BlurReference::LinearGaussian(const PostProcessImage& source, float sigma, PostProcessImage& destination)
+	{
+		std::vector<BlurSample> samples;
+		BlurKernel::ComputeLinearGaussianSamples(sigma, samples);
+
+		PostProcessImage intermediate;
+		ConvolveLinear(source, samples, true, intermediate);
+		ConvolveLinear(intermediate, samples, false, destination);
+	}
+
+	void BlurReference::DualKawase(const PostProcessImage& source, unsigned int iterations, PostProcessImage& destination)
+	{
+		assert(iterations > 0);
+
+		std::vector<PostProcessImage> levels(iterations + 1);
+		levels[0] = source;
+		for (unsigned int i = 1; i <= iterations; i++)
+		{
+			KawaseDownsample(levels[i - 1], levels[i]);
+		}
+
+		// Each upsample overwrites the level above it, which its downsample has already consumed
+		for (unsigned int i = iterations; i > 1; i--)
+		{
+			PostProcessImage upsampled;
+			KawaseUpsample(levels[i], levels[i - 1].Width, levels[i - 1].Height, upsampled);
+			levels[i - 1].Texels.swap(upsampled.Texels);
+		}
+
+		KawaseUpsample(levels[1], source.Width, source.Height, destination);
+	}
+
+	void BlurReference::Box(const PostProcessImage& source, float sigma, PostProcessImage& destination)
+	{
+		std::vector<unsigned int> widths;
+		BlurKernel::ComputeBoxWidths(sigma, widths);
+
+		PostProcessImage current = source;
+		PostProcessImage next;
+		for (bool horizontal : { true, false })
+		{
+			for (unsigned int width : widths)
+			{
+				BoxPass(current, width, horizontal, next);
+				current.Texels.swap(next.Texels);
+			}
+		}
+
+		destination.Width = current.Width;
+		destination.Height = current.Height;
+		destination.Texels.swap(current.Texels);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "BlurKernel.h"
+#include "PostProcessReference.h"
+
+namespace Library
+{
+	// CPU implementations of every BlurKernel technique with clamp addressing. Gaussian() convolves with the
+	// discrete kernel directly and is the oracle the others, and the GPU, are compared against.
+	class BlurReference
+	{
+	public:
+		static void Blur(BlurTechnique technique, const PostProcessImage& source, float sigma, PostProcessImage& destination);
+
+		static void Gaussian(const PostProcessImage& source, float sigma, PostProcessImage& destination);
+		static void LinearGaussian(const PostProcessImage& source, float sigma, PostProcessImage& destination);
+		static void DualKawase(const PostProcessImage& source, unsigned int iterations, PostProcessImage& destination);
+		static void Box(const PostProcessImage& source, float sigma, PostProcessImage& destination);
+
+	private:
+		BlurReference();
+		BlurReference(const BlurReference& rhs);
+		BlurReference& operator=(const BlurReference& rhs);
+	};
+}
\ No newline at end of file
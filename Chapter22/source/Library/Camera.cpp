@@ -15,14 +15,14 @@ namespace Library
     Camera::Camera(Game& game)
         : GameComponent(game),
           mFieldOfView(DefaultFieldOfView), mAspectRatio(game.AspectRatio()), mNearPlaneDistance(DefaultNearPlaneDistance), mFarPlaneDistance(DefaultFarPlaneDistance),
-          mPosition(), mDirection(), mUp(), mRight(), mViewMatrix(), mProjectionMatrix()
+          mPosition(), mDirection(), mUp(), mRight(), mViewMatrix(), mProjectionMatrix(), mUnjitteredProjectionMatrix(), mProjectionJitter(0.0f, 0.0f)
     {
     }
 
     Camera::Camera(Game& game, float fieldOfView, float aspectRatio, float nearPlaneDistance, float farPlaneDistance)
         : GameComponent(game),
           mFieldOfView(fieldOfView), mAspectRatio(aspectRatio), mNearPlaneDistance(nearPlaneDistance), mFarPlaneDistance(farPlaneDistance),
-          mPosition(), mDirection(), mUp(), mRight(), mViewMatrix(), mProjectionMatrix()
+          mPosition(), mDirection(), mUp(), mRight(), mViewMatrix(), mProjectionMatrix(), mUnjitteredProjectionMatrix(), mProjectionJitter(0.0f, 0.0f)
     {
     }
 
@@ -108,6 +108,30 @@ namespace Library
         return XMMatrixMultiply(viewMatrix, projectionMatrix);
     }
 
+    XMMATRIX Camera::UnjitteredProjectionMatrix() const
+    {
+        return XMLoadFloat4x4(&mUnjitteredProjectionMatrix);
+    }
+
+    XMMATRIX Camera::UnjitteredViewProjectionMatrix() const
+    {
+        XMMATRIX viewMatrix = XMLoadFloat4x4(&mViewMatrix);
+        XMMATRIX projectionMatrix = XMLoadFloat4x4(&mUnjitteredProjectionMatrix);
+
+        return XMMatrixMultiply(viewMatrix, projectionMatrix);
+    }
+
+    const XMFLOAT2& Camera::ProjectionJitter() const
+    {
+        return mProjectionJitter;
+    }
+
+    void Camera::SetProjectionJitter(float x, float y)
+    {
+        mProjectionJitter = XMFLOAT2(x, y);
+        UpdateProjectionMatrix();
+    }
+
     void Camera::SetPosition(FLOAT x, FLOAT y, FLOAT z)
     {
         XMVECTOR position = XMVectorSet(x, y, z, 1.0f);
@@ -158,6 +182,16 @@ namespace Library
     void Camera::UpdateProjectionMatrix()
     {
         XMMATRIX projectionMatrix = XMMatrixPerspectiveFovRH(mFieldOfView, mAspectRatio, mNearPlaneDistance, mFarPlaneDistance);
+        XMStoreFloat4x4(&mUnjitteredProjectionMatrix, projectionMatrix);
+
+        // A clip-space translation scaled by w shifts every projected point by the same NDC offset
+        if (mProjectionJitter.x != 0.0f || mProjectionJitter.y != 0.0f)
+        {
+            float jitterX = 2.0f * mProjectionJitter.x / mGame->ScreenWidth();
+            float jitterY = -2.0f * mProjectionJitter.y / mGame->ScreenHeight();
+            projectionMatrix = XMMatrixMultiply(projectionMatrix, XMMatrixTranslation(jitterX, jitterY, 0.0f));
+        }
+
         XMStoreFloat4x4(&mProjectionMatrix, projectionMatrix);
     }
 
@@ -35,6 +35,14 @@ namespace Library
         XMMATRIX ProjectionMatrix() const;
         XMMATRIX ViewProjectionMatrix() const;
 
+        // Without the sub-pixel jitter, for culling and for motion that shouldn't include it
+        XMMATRIX UnjitteredProjectionMatrix() const;
+        XMMATRIX UnjitteredViewProjectionMatrix() const;
+
+        // Offset of the projection in pixels of the game's screen, +y down; zero unless TemporalAA is jittering it
+        const XMFLOAT2& ProjectionJitter() const;
+        void SetProjectionJitter(float x, float y);
+
         virtual void SetPosition(FLOAT x, FLOAT y, FLOAT z);
         virtual void SetPosition(FXMVECTOR position);
         virtual void SetPosition(const XMFLOAT3& position);
@@ -64,6 +72,8 @@ namespace Library
 
         XMFLOAT4X4 mViewMatrix;
         XMFLOAT4X4 mProjectionMatrix;
+        XMFLOAT4X4 mUnjitteredProjectionMatrix;
+        XMFLOAT2 mProjectionJitter;
 
     private:
         Camera(const Camera& rhs);
@@ -0,0 +1,158 @@
+#include "CascadeFitting.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Library
+{
+	namespace
+	{
+		float Dot(const float a[3], const float b[3])
+		{
+			return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+		}
+
+		void Cross(const float a[3], const float b[3], float result[3])
+		{
+			result[0] = a[1] * b[2] - a[2] * b[1];
+			result[1] = a[2] * b[0] - a[0] * b[2];
+			result[2] = a[0] * b[1] - a[1] * b[0];
+		}
+
+		void Normalize(float vector[3])
+		{
+			float length = sqrtf(Dot(vector, vector));
+			assert(length > 0.0f);
+
+			for (int i = 0; i < 3; i++)
+			{
+				vector[i] /= length;
+			}
+		}
+	}
+
+	void CascadeFitting::ComputeSplitDistances(float nearDistance, float farDistance, unsigned int cascadeCount, float lambda, std::vector<float>& splitDistances)
+	{
+		assert(nearDistance > 0.0f && farDistance > nearDistance && cascadeCount > 0);
+
+		splitDistances.resize(cascadeCount + 1);
+		splitDistances[0] = nearDistance;
+		for (unsigned int i = 1; i < cascadeCount; i++)
+		{
+			float fraction = static_cast<float>(i) / cascadeCount;
+			float logarithmic = nearDistance * powf(farDistance / nearDistance, fraction);
+			float uniform = nearDistance + (farDistance - nearDistance) * fraction;
+
+			splitDistances[i] = lambda * logarithmic + (1.0f - lambda) * uniform;
+		}
+
+		splitDistances[cascadeCount] = farDistance;
+	}
+
+	void CascadeFitting::ComputeLightBasis(const float direction[3], CascadeLightBasis& basis)
+	{
+		// The light sits at the world origin so that snapping in light space is stable as the camera moves
+		for (int i = 0; i < 3; i++)
+		{
+			basis.Forward[i] = direction[i];
+		}
+
+		Normalize(basis.Forward);
+
+		const float up[3] = { 0.0f, 1.0f, 0.0f };
+		const float forward[3] = { 0.0f, 0.0f, -1.0f };
+		Cross((fabs(basis.Forward[1]) > 0.99f ? forward : up), basis.Forward, basis.Right);
+		Normalize(basis.Right);
+		Cross(basis.Forward, basis.Right, basis.Up);
+	}
+
+	void CascadeFitting::ComputeSliceCorners(const float position[3], const float direction[3], const float up[3], const float right[3], float fieldOfView,
+		float aspectRatio, float nearDistance, float farDistance, float corners[8][3])
+	{
+		float tanHalfFieldOfView = tanf(fieldOfView * 0.5f);
+		float distances[2] = { nearDistance, farDistance };
+		const float signs[4][2] = { { -1.0f, 1.0f }, { 1.0f, 1.0f }, { 1.0f, -1.0f }, { -1.0f, -1.0f } };
+
+		for (unsigned int plane = 0; plane < 2; plane++)
+		{
+			float halfHeight = distances[plane] * tanHalfFieldOfView;
+			float halfWidth = halfHeight * aspectRatio;
+
+			for (unsigned int corner = 0; corner < 4; corner++)
+			{
+				float* point = corners[plane * 4 + corner];
+				for (int i = 0; i < 3; i++)
+				{
+					point[i] = position[i] + direction[i] * distances[plane] + right[i] * halfWidth * signs[corner][0] + up[i] * halfHeight * signs[corner][1];
+				}
+			}
+		}
+	}
+
+	void CascadeFitting::FitBounds(const float corners[8][3], const CascadeLightBasis& basis, unsigned int resolution, CascadeFitMode fitMode, float casterDistance, CascadeBounds& bounds)
+	{
+		assert(resolution > 0);
+
+		float lightSpaceCorners[8][3];
+		for (unsigned int i = 0; i < 8; i++)
+		{
+			lightSpaceCorners[i][0] = Dot(corners[i], basis.Right);
+			lightSpaceCorners[i][1] = Dot(corners[i], basis.Up);
+			lightSpaceCorners[i][2] = Dot(corners[i], basis.Forward);
+		}
+
+		if (fitMode == CascadeFitModeSphere)
+		{
+			float center[3] = { 0.0f, 0.0f, 0.0f };
+			for (unsigned int i = 0; i < 8; i++)
+			{
+				for (int axis = 0; axis < 3; axis++)
+				{
+					center[axis] += lightSpaceCorners[i][axis] / 8.0f;
+				}
+			}
+
+			float radius = 0.0f;
+			for (unsigned int i = 0; i < 8; i++)
+			{
+				float offset[3] = { lightSpaceCorners[i][0] - center[0], lightSpaceCorners[i][1] - center[1], lightSpaceCorners[i][2] - center[2] };
+				radius = std::max(radius, sqrtf(Dot(offset, offset)));
+			}
+
+			// Floating-point noise in the corners must not change the projection's size from frame to frame
+			radius = ceilf(radius * 16.0f) / 16.0f;
+
+			// One texel wider across, so snapping the minimum down a fraction of a texel can't uncover the far side
+			float padding = 2.0f * radius / std::max(resolution - 1, 1U);
+			for (int axis = 0; axis < 3; axis++)
+			{
+				bounds.Minimum[axis] = center[axis] - radius;
+				bounds.Maximum[axis] = center[axis] + radius + (axis < 2 ? padding : 0.0f);
+			}
+		}
+		else
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				bounds.Minimum[axis] = bounds.Maximum[axis] = lightSpaceCorners[0][axis];
+				for (unsigned int i = 1; i < 8; i++)
+				{
+					bounds.Minimum[axis] = std::min(bounds.Minimum[axis], lightSpaceCorners[i][axis]);
+					bounds.Maximum[axis] = std::max(bounds.Maximum[axis], lightSpaceCorners[i][axis]);
+				}
+			}
+		}
+
+		// Move the projection across the light's x and y only in whole shadow-map texels. A sphere keeps its extent, so the
+		// texel size doesn't change either; a box's far edge rounds outward, so the corners stay inside.
+		for (int axis = 0; axis < 2; axis++)
+		{
+			float extent = bounds.Maximum[axis] - bounds.Minimum[axis];
+			float worldUnitsPerTexel = extent / resolution;
+			bounds.Minimum[axis] = floorf(bounds.Minimum[axis] / worldUnitsPerTexel) * worldUnitsPerTexel;
+			bounds.Maximum[axis] = (fitMode == CascadeFitModeSphere ? bounds.Minimum[axis] + extent : ceilf(bounds.Maximum[axis] / worldUnitsPerTexel) * worldUnitsPerTexel);
+		}
+
+		bounds.Minimum[2] -= casterDistance;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+// Portable like LightClusters: cascade splits, frustum fitting and texel snapping, shared by ShadowCascades and CascadeBenchmark
+#include <vector>
+
+namespace Library
+{
+	enum CascadeFitMode
+	{
+		CascadeFitModeSphere = 0,
+		CascadeFitModeBox,
+		CascadeFitModeEnd
+	};
+
+	// Axes of a directional light's view, which sits at the world origin. A point's light-space coordinates are its
+	// dot products with Right, Up and Forward, Forward being the direction the light travels.
+	typedef struct _CascadeLightBasis
+	{
+		float Right[3];
+		float Up[3];
+		float Forward[3];
+	} CascadeLightBasis;
+
+	// Light-space box an orthographic projection covers, z extended toward the light by the caster distance
+	typedef struct _CascadeBounds
+	{
+		float Minimum[3];
+		float Maximum[3];
+	} CascadeBounds;
+
+	class CascadeFitting
+	{
+	public:
+		// Practical split scheme: lambda blends logarithmic (1) and uniform (0) distributions. Returns cascadeCount + 1
+		// distances from nearDistance to farDistance.
+		static void ComputeSplitDistances(float nearDistance, float farDistance, unsigned int cascadeCount, float lambda, std::vector<float>& splitDistances);
+
+		// The same axes XMMatrixLookToLH() gives a light at the origin, with up switched to -z when the light is near vertical
+		static void ComputeLightBasis(const float direction[3], CascadeLightBasis& basis);
+
+		// World-space corners of a perspective camera's view between two distances, as Camera describes it: the near
+		// four, then the far four, each top left, top right, bottom right, bottom left
+		static void ComputeSliceCorners(const float position[3], const float direction[3], const float up[3], const float right[3], float fieldOfView,
+			float aspectRatio, float nearDistance, float farDistance, float corners[8][3]);
+
+		// Sphere fitting keeps the bounds' size constant as the camera turns and, with texel snapping, stops shadow edges
+		// shimmering; box fitting is tighter but its size follows the view. Either way x and y move only in whole texels
+		// of a resolution x resolution shadow map.
+		static void FitBounds(const float corners[8][3], const CascadeLightBasis& basis, unsigned int resolution, CascadeFitMode fitMode, float casterDistance, CascadeBounds& bounds);
+
+	private:
+		CascadeFitting();
+		CascadeFitting(const CascadeFitting& rhs);
+		CascadeFitting& operator=(const CascadeFitting& rhs);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "CascadedShadowMap.h"
+#include "Game.h"
+#include "GameException.h"
+
+namespace Library
+{
+    RTTI_DEFINITIONS(CascadedShadowMap)
+
+    CascadedShadowMap::CascadedShadowMap(Game& game, UINT resolution, UINT cascadeCount)
+        : RenderTarget(), mGame(&game), mDepthStencilViews(cascadeCount, nullptr),
+          mOutputTexture(nullptr), mViewport(), mActiveCascade(0)
+    {
+        D3D11_TEXTURE2D_DESC textureDesc;
+        ZeroMemory(&textureDesc, sizeof(textureDesc));
+        textureDesc.Width = resolution;
+        textureDesc.Height = resolution;
+        textureDesc.MipLevels = 1;
+        textureDesc.ArraySize = cascadeCount;
+        textureDesc.Format = DXGI_FORMAT_R24G8_TYPELESS;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
+
+        HRESULT hr;
+        ID3D11Texture2D* texture = nullptr;
+        if (FAILED(hr = game.Direct3DDevice()->CreateTexture2D(&textureDesc, nullptr, &texture)))
+        {
+            throw GameException("IDXGIDevice::CreateTexture2D() failed.", hr);
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC resourceViewDesc;
+        ZeroMemory(&resourceViewDesc, sizeof(resourceViewDesc));
+        resourceViewDesc.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+        resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+        resourceViewDesc.Texture2DArray.MipLevels = 1;
+        resourceViewDesc.Texture2DArray.ArraySize = cascadeCount;
+
+        if (FAILED(hr = game.Direct3DDevice()->CreateShaderResourceView(texture, &resourceViewDesc, &mOutputTexture)))
+        {
+            ReleaseObject(texture);
+            throw GameException("IDXGIDevice::CreateShaderResourceView() failed.", hr);
+        }
+
+        for (UINT i = 0; i < cascadeCount; i++)
+        {
+            D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc;
+            ZeroMemory(&depthStencilViewDesc, sizeof(depthStencilViewDesc));
+            depthStencilViewDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+            depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DARRAY;
+            depthStencilViewDesc.Texture2DArray.FirstArraySlice = i;
+            depthStencilViewDesc.Texture2DArray.ArraySize = 1;
+
+            if (FAILED(hr = game.Direct3DDevice()->CreateDepthStencilView(texture, &depthStencilViewDesc, &mDepthStencilViews[i])))
+            {
+                ReleaseObject(texture);
+                throw GameException("IDXGIDevice::CreateDepthStencilView() failed.", hr);
+            }
+        }
+
+        ReleaseObject(texture);
+
+        mViewport.TopLeftX = 0.0f;
+        mViewport.TopLeftY = 0.0f;
+        mViewport.Width = static_cast<float>(resolution);
+        mViewport.Height = static_cast<float>(resolution);
+        mViewport.MinDepth = 0.0f;
+        mViewport.MaxDepth = 1.0f;
+    }
+
+    CascadedShadowMap::~CascadedShadowMap()
+    {
+        ReleaseObject(mOutputTexture);
+        for (ID3D11DepthStencilView* depthStencilView : mDepthStencilViews)
+        {
+            ReleaseObject(depthStencilView);
+        }
+    }
+
+    ID3D11ShaderResourceView* CascadedShadowMap::OutputTexture() const
+    {
+        return mOutputTexture;
+    }
+
+    ID3D11DepthStencilView* CascadedShadowMap::DepthStencilView(UINT cascade) const
+    {
+        return mDepthStencilViews.at(cascade);
+    }
+
+    UINT CascadedShadowMap::CascadeCount() const
+    {
+        return static_cast<UINT>(mDepthStencilViews.size());
+    }
+
+    UINT CascadedShadowMap::ActiveCascade() const
+    {
+        return mActiveCascade;
+    }
+
+    void CascadedShadowMap::SetActiveCascade(UINT cascade)
+    {
+        assert(cascade < mDepthStencilViews.size());
+        mActiveCascade = cascade;
+    }
+
+    void CascadedShadowMap::Begin()
+    {
+        static ID3D11RenderTargetView* nullRenderTargetView = nullptr;
+        RenderTarget::Begin(mGame->Direct3DDeviceContext(), 1, &nullRenderTargetView, mDepthStencilViews[mActiveCascade], mViewport);
+    }
+
+    void CascadedShadowMap::End()
+    {
+        RenderTarget::End(mGame->Direct3DDeviceContext());
+    }
+}
\ No newline at end of file
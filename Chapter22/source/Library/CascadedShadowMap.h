@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Common.h"
+#include "RenderTarget.h"
+
+namespace Library
+{
+    class Game;
+
+	// A depth texture array with one slice per cascade. Begin() binds the active cascade's slice.
+    class CascadedShadowMap : public RenderTarget
+    {
+		RTTI_DECLARATIONS(CascadedShadowMap, RenderTarget)
+
+    public:
+        CascadedShadowMap(Game& game, UINT resolution, UINT cascadeCount);
+        ~CascadedShadowMap();
+
+		ID3D11ShaderResourceView* OutputTexture() const;
+		ID3D11DepthStencilView* DepthStencilView(UINT cascade) const;
+
+		UINT CascadeCount() const;
+		UINT ActiveCascade() const;
+		void SetActiveCascade(UINT cascade);
+
+        virtual void Begin() override;
+		virtual void End() override;
+
+    private:
+        CascadedShadowMap();
+        CascadedShadowMap(const CascadedShadowMap& rhs);
+        CascadedShadowMap& operator=(const CascadedShadowMap& rhs);
+
+        Game* mGame;
+		std::vector<ID3D11DepthStencilView*> mDepthStencilViews;
+		ID3D11ShaderResourceView* mOutputTexture;
+		D3D11_VIEWPORT mViewport;
+		UINT mActiveCascade;
+    };
+}
\ No newline at end of file
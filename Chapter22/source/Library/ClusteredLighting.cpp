@@ -0,0 +1,166 @@
+#include "ClusteredLighting.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Camera.h"
+#include "PointLight.h"
+#include "SpotLight.h"
+#include "ThreadPool.h"
+
+namespace Library
+{
+	const UINT ClusteredLighting::InitialBufferCapacity = 256;
+
+	ClusteredLighting::ClusteredLighting(Game& game)
+		: mGame(&game), mClusters(), mProjection(0.0f, 0.0f, 0.0f, 0.0f), mClusterLights(), mLightData(),
+		  mLightBuffer(), mClusterBuffer(), mLightIndexBuffer()
+	{
+	}
+
+	ClusteredLighting::~ClusteredLighting()
+	{
+		ReleaseBuffer(mLightIndexBuffer);
+		ReleaseBuffer(mClusterBuffer);
+		ReleaseBuffer(mLightBuffer);
+	}
+
+	const LightClusters& ClusteredLighting::Clusters() const
+	{
+		return mClusters;
+	}
+
+	UINT ClusteredLighting::LightCount() const
+	{
+		return static_cast<UINT>(mLightData.size());
+	}
+
+	void ClusteredLighting::Update(const Camera& camera, const std::vector<PointLight*>& lights)
+	{
+		XMFLOAT4 projection(camera.FieldOfView(), camera.AspectRatio(), camera.NearPlaneDistance(), camera.FarPlaneDistance());
+		if (memcmp(&projection, &mProjection, sizeof(projection)) != 0)
+		{
+			mClusters.SetProjection(projection.x, projection.y, projection.z, projection.w);
+			mProjection = projection;
+		}
+
+		// The camera's view space is right-handed; the clusters measure depth forward, so z is negated
+		XMMATRIX viewMatrix = camera.ViewMatrix();
+		mClusterLights.resize(lights.size());
+		mLightData.resize(lights.size());
+
+		for (size_t i = 0; i < lights.size(); i++)
+		{
+			PointLight* light = lights[i];
+			SpotLight* spotLight = light->As<SpotLight>();
+
+			ClusteredLightData& lightData = mLightData[i];
+			lightData.Position = light->Position();
+			lightData.Radius = light->Radius();
+			XMStoreFloat4(&lightData.Color, light->ColorVector());
+			lightData.Direction = (spotLight != nullptr ? spotLight->Direction() : XMFLOAT3(0.0f, 0.0f, -1.0f));
+			lightData.OuterAngle = (spotLight != nullptr ? spotLight->OuterAngle() : -1.0f);
+			lightData.InnerAngle = (spotLight != nullptr ? spotLight->InnerAngle() : -1.0f);
+			lightData.Padding = XMFLOAT3(0.0f, 0.0f, 0.0f);
+
+			XMFLOAT3 position;
+			XMFLOAT3 direction;
+			XMStoreFloat3(&position, XMVector3TransformCoord(light->PositionVector(), viewMatrix));
+			XMStoreFloat3(&direction, XMVector3TransformNormal(XMLoadFloat3(&lightData.Direction), viewMatrix));
+
+			ClusterLight& clusterLight = mClusterLights[i];
+			clusterLight.Position[0] = position.x;
+			clusterLight.Position[1] = position.y;
+			clusterLight.Position[2] = -position.z;
+			clusterLight.Radius = lightData.Radius;
+			clusterLight.Direction[0] = direction.x;
+			clusterLight.Direction[1] = direction.y;
+			clusterLight.Direction[2] = -direction.z;
+			clusterLight.CosineOuterAngle = lightData.OuterAngle;
+		}
+
+		mClusters.Build(mClusterLights, &mGame->WorkerThreads());
+
+		UpdateBuffer(mLightBuffer, (mLightData.empty() ? nullptr : &mLightData[0]), sizeof(ClusteredLightData), LightCount());
+		UpdateBuffer(mClusterBuffer, &mClusters.Ranges()[0], sizeof(ClusterRange), mClusters.ClusterCount());
+		UpdateBuffer(mLightIndexBuffer, (mClusters.LightIndices().empty() ? nullptr : &mClusters.LightIndices()[0]), sizeof(UINT), static_cast<UINT>(mClusters.LightIndices().size()));
+	}
+
+	ID3D11ShaderResourceView* ClusteredLighting::LightBuffer() const
+	{
+		return mLightBuffer.ShaderResourceView;
+	}
+
+	ID3D11ShaderResourceView* ClusteredLighting::ClusterBuffer() const
+	{
+		return mClusterBuffer.ShaderResourceView;
+	}
+
+	ID3D11ShaderResourceView* ClusteredLighting::LightIndexBuffer() const
+	{
+		return mLightIndexBuffer.ShaderResourceView;
+	}
+
+	XMVECTOR ClusteredLighting::ClusterParameters() const
+	{
+		const D3D11_VIEWPORT& viewport = mGame->Viewport();
+		return XMVectorSet(mClusters.TileCountX() / viewport.Width, mClusters.TileCountY() / viewport.Height, mClusters.SliceScale(), mClusters.SliceBias());
+	}
+
+	void ClusteredLighting::UpdateBuffer(StructuredBuffer& buffer, const void* data, UINT elementSize, UINT elementCount)
+	{
+		// Buffers grow by doubling and never shrink, so a steady light count stops reallocating after a few frames
+		if (buffer.Buffer == nullptr || elementCount > buffer.Capacity)
+		{
+			UINT capacity = max(max(elementCount, buffer.Capacity * 2), InitialBufferCapacity);
+			ReleaseBuffer(buffer);
+
+			D3D11_BUFFER_DESC bufferDesc;
+			ZeroMemory(&bufferDesc, sizeof(bufferDesc));
+			bufferDesc.ByteWidth = elementSize * capacity;
+			bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+			bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+			bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+			bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+			bufferDesc.StructureByteStride = elementSize;
+
+			HRESULT hr;
+			if (FAILED(hr = mGame->Direct3DDevice()->CreateBuffer(&bufferDesc, nullptr, &buffer.Buffer)))
+			{
+				throw GameException("ID3D11Device::CreateBuffer() failed.", hr);
+			}
+
+			D3D11_SHADER_RESOURCE_VIEW_DESC resourceViewDesc;
+			ZeroMemory(&resourceViewDesc, sizeof(resourceViewDesc));
+			resourceViewDesc.Format = DXGI_FORMAT_UNKNOWN;
+			resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+			resourceViewDesc.Buffer.NumElements = capacity;
+
+			if (FAILED(hr = mGame->Direct3DDevice()->CreateShaderResourceView(buffer.Buffer, &resourceViewDesc, &buffer.ShaderResourceView)))
+			{
+				ReleaseBuffer(buffer);
+				throw GameException("ID3D11Device::CreateShaderResourceView() failed.", hr);
+			}
+
+			buffer.Capacity = capacity;
+		}
+
+		if (elementCount > 0)
+		{
+			D3D11_MAPPED_SUBRESOURCE mappedResource;
+			HRESULT hr;
+			if (FAILED(hr = mGame->Direct3DDeviceContext()->Map(buffer.Buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource)))
+			{
+				throw GameException("ID3D11DeviceContext::Map() failed.", hr);
+			}
+
+			memcpy(mappedResource.pData, data, elementSize * elementCount);
+			mGame->Direct3DDeviceContext()->Unmap(buffer.Buffer, 0);
+		}
+	}
+
+	void ClusteredLighting::ReleaseBuffer(StructuredBuffer& buffer)
+	{
+		ReleaseObject(buffer.ShaderResourceView);
+		ReleaseObject(buffer.Buffer);
+		buffer.Capacity = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Common.h"
+#include "LightClusters.h"
+
+namespace Library
+{
+	class Game;
+	class Camera;
+	class PointLight;
+
+	// Matches CLUSTERED_LIGHT in ClusteredLighting.fxh; point lights carry an OuterAngle of -1
+	typedef struct _ClusteredLightData
+	{
+		XMFLOAT3 Position;
+		float Radius;
+		XMFLOAT4 Color;
+		XMFLOAT3 Direction;
+		float OuterAngle;
+		float InnerAngle;
+		XMFLOAT3 Padding;
+	} ClusteredLightData;
+
+	// Bins point and spot lights into the camera's froxels on the worker threads and uploads them as structured buffers,
+	// so a pixel shades only the lights of its own cluster (see ClusteredLighting.fxh).
+	class ClusteredLighting
+	{
+	public:
+		ClusteredLighting(Game& game);
+		~ClusteredLighting();
+
+		const LightClusters& Clusters() const;
+		UINT LightCount() const;
+
+		// Spot lights are recognized through RTTI and binned by their cones
+		void Update(const Camera& camera, const std::vector<PointLight*>& lights);
+
+		ID3D11ShaderResourceView* LightBuffer() const;
+		ID3D11ShaderResourceView* ClusterBuffer() const;
+		ID3D11ShaderResourceView* LightIndexBuffer() const;
+
+		// Clusters per pixel in x and y, then the slice scale and bias: the ClusterParameters shader variable
+		XMVECTOR ClusterParameters() const;
+
+		static const UINT InitialBufferCapacity;
+
+	private:
+		typedef struct _StructuredBuffer
+		{
+			ID3D11Buffer* Buffer;
+			ID3D11ShaderResourceView* ShaderResourceView;
+			UINT Capacity;
+		} StructuredBuffer;
+
+		ClusteredLighting();
+		ClusteredLighting(const ClusteredLighting& rhs);
+		ClusteredLighting& operator=(const ClusteredLighting& rhs);
+
+		void UpdateBuffer(StructuredBuffer& buffer, const void* data, UINT elementSize, UINT elementCount);
+		static void ReleaseBuffer(StructuredBuffer& buffer);
+
+		Game* mGame;
+		LightClusters mClusters;
+		XMFLOAT4 mProjection;
+		std::vector<ClusterLight> mClusterLights;
+		std::vector<ClusteredLightData> mLightData;
+		StructuredBuffer mLightBuffer;
+		StructuredBuffer mClusterBuffer;
+		StructuredBuffer mLightIndexBuffer;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "ContentManager.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Effect.h"
+#include "EffectCache.h"
+#include "EffectWatcher.h"
+#include "Model.h"
+#include "TextFont.h"
+#include "PrimitiveMesh.h"
+#include "MeshBuffers.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "Utility.h"
+#include <DDSTextureLoader.h>
+#include <WICTextureLoader.h>
+#include <sstream>
+
+namespace Library
+{
+	ContentManager::ContentManager(Game& game)
+		: mGame(game), mEffects(), mModels(), mTextures(), mFonts(), mPrimitives(), mMeshBuffers(), mPending(), mMutex()
+	{
+	}
+
+	ContentManager::~ContentManager()
+	{
+	}
+
+	std::shared_ptr<Effect> ContentManager::LoadEffect(const std::wstring& filename)
+	{
+		return DemandCreate<Effect>(mEffects, filename, [&]()
+		{
+			// Watched so that a rebuilt effect is swapped in between frames; the last owner stops the watch
+			EffectWatcher* effectWatcher = &mGame.WatchedEffects();
+			std::shared_ptr<Effect> effect(new Effect(mGame), [effectWatcher](Effect* effect)
+			{
+				effectWatcher->Unwatch(*effect);
+				delete effect;
+			});
+
+			std::shared_ptr<const CompiledEffect> compiledEffect = mGame.CompiledEffects().Load(*effect, filename);
+			effectWatcher->Watch(*effect, filename, compiledEffect);
+
+			return effect;
+		});
+	}
+
+	std::shared_ptr<Model> ContentManager::LoadModel(const std::string& filename, bool flipUVs)
+	{
+		std::wstring key = Utility::ToWideString(filename) + (flipUVs ? L"|flipUVs" : L"");
+
+		return DemandCreate<Model>(mModels, key, [&]()
+		{
+			return std::shared_ptr<Model>(new Model(mGame, filename, flipUVs));
+		});
+	}
+
+	std::shared_ptr<ID3D11ShaderResourceView> ContentManager::LoadTexture(const std::wstring& filename)
+	{
+		return DemandCreate<ID3D11ShaderResourceView>(mTextures, filename, [&]()
+		{
+			std::wstring extension;
+			Utility::GetPathExtension(filename, extension);
+
+			// TextureTool's output, with its mips and block compression, is used in place of the image it was built from
+			std::wstring builtFilename = filename.substr(0, filename.size() - extension.size()) + L".dds";
+			bool isBuilt = (_wcsicmp(extension.c_str(), L".dds") != 0 && GetFileAttributes(builtFilename.c_str()) != INVALID_FILE_ATTRIBUTES);
+
+			HRESULT hr;
+			ID3D11ShaderResourceView* texture = nullptr;
+			if (isBuilt || _wcsicmp(extension.c_str(), L".dds") == 0)
+			{
+				if (FAILED(hr = DirectX::CreateDDSTextureFromFile(mGame.Direct3DDevice(), (isBuilt ? builtFilename : filename).c_str(), nullptr, &texture)))
+				{
+					throw GameException("CreateDDSTextureFromFile() failed.", hr);
+				}
+			}
+			else
+			{
+				// Generating mips needs the immediate context, which only the render thread may use; loads on the worker
+				// threads get the image's one level, or TextureTool's .dds above
+				ID3D11DeviceContext* context = (mGame.IsRenderThread() ? mGame.Direct3DDeviceContext() : nullptr);
+				if (FAILED(hr = DirectX::CreateWICTextureFromFile(mGame.Direct3DDevice(), context, filename.c_str(), nullptr, &texture)))
+				{
+					throw GameException("CreateWICTextureFromFile() failed.", hr);
+				}
+			}
+
+			return std::shared_ptr<ID3D11ShaderResourceView>(texture, [](ID3D11ShaderResourceView* resource) { resource->Release(); });
+		});
+	}
+
+	std::shared_ptr<TextFont> ContentManager::LoadFont(const std::wstring& filename)
+	{
+		return DemandCreate<TextFont>(mFonts, filename, [&]()
+		{
+			return std::shared_ptr<TextFont>(new TextFont(mGame, filename));
+		});
+	}
+
+	std::shared_ptr<PrimitiveMesh> ContentManager::LoadPrimitive(PrimitiveShape shape, UINT tessellation, bool isRightHanded)
+	{
+		// The cube has no tessellation to tell its meshes apart
+		tessellation = (shape == PrimitiveShapeCube ? 0 : tessellation);
+
+		return DemandCreate<PrimitiveMesh>(mPrimitives, PrimitiveGeometry::CacheKey(shape, tessellation, isRightHanded), [&]()
+		{
+			return std::shared_ptr<PrimitiveMesh>(new PrimitiveMesh(mGame, shape, tessellation, isRightHanded));
+		});
+	}
+
+	std::shared_ptr<MeshBuffers> ContentManager::LoadMeshBuffers(const std::string& modelFilename, bool flipUVs, UINT meshIndex, const Material& material)
+	{
+		std::wostringstream key;
+		key << Utility::ToWideString(modelFilename) << (flipUVs ? L"|flipUVs" : L"") << L"|" << meshIndex << L"|" << material.TypeIdInstance();
+
+		return DemandCreate<MeshBuffers>(mMeshBuffers, key.str(), [&]()
+		{
+			// Released once the buffers exist, unless something else holds the model
+			std::shared_ptr<Model> model = LoadModel(modelFilename, flipUVs);
+
+			return std::shared_ptr<MeshBuffers>(new MeshBuffers(*mGame.Direct3DDevice(), *model->Meshes().at(meshIndex), material));
+		});
+	}
+
+	UINT ContentManager::Count() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		UINT count = 0;
+		for (const std::pair<const std::wstring, std::weak_ptr<Effect>>& effect : mEffects)
+		{
+			count += (effect.second.expired() ? 0 : 1);
+		}
+
+		for (const std::pair<const std::wstring, std::weak_ptr<Model>>& model : mModels)
+		{
+			count += (model.second.expired() ? 0 : 1);
+		}
+
+		for (const std::pair<const std::wstring, std::weak_ptr<ID3D11ShaderResourceView>>& texture : mTextures)
+		{
+			count += (texture.second.expired() ? 0 : 1);
+		}
+
+		for (const std::pair<const std::wstring, std::weak_ptr<TextFont>>& font : mFonts)
+		{
+			count += (font.second.expired() ? 0 : 1);
+		}
+
+		for (const std::pair<const std::wstring, std::weak_ptr<PrimitiveMesh>>& primitive : mPrimitives)
+		{
+			count += (primitive.second.expired() ? 0 : 1);
+		}
+
+		for (const std::pair<const std::wstring, std::weak_ptr<MeshBuffers>>& meshBuffers : mMeshBuffers)
+		{
+			count += (meshBuffers.second.expired() ? 0 : 1);
+		}
+
+		return count;
+	}
+
+	void ContentManager::Purge()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		PurgeExpired(mEffects);
+		PurgeExpired(mModels);
+		PurgeExpired(mTextures);
+		PurgeExpired(mFonts);
+		PurgeExpired(mPrimitives);
+		PurgeExpired(mMeshBuffers);
+	}
+}
\ No newline at end of file
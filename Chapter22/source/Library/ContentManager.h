@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Common.h"
+#include "PrimitiveGeometry.h"
+#include "GameException.h"
+#include <mutex>
+#include <future>
+#include <thread>
+#include <functional>
+
+namespace Library
+{
+	class Game;
+	class Effect;
+	class Model;
+	class TextFont;
+	class PrimitiveMesh;
+	class MeshBuffers;
+	class Material;
+
+	class ContentManager
+	{
+	public:
+		ContentManager(Game& game);
+		~ContentManager();
+
+		std::shared_ptr<Effect> LoadEffect(const std::wstring& filename);
+		std::shared_ptr<Model> LoadModel(const std::string& filename, bool flipUVs = false);
+		std::shared_ptr<ID3D11ShaderResourceView> LoadTexture(const std::wstring& filename);
+		std::shared_ptr<TextFont> LoadFont(const std::wstring& filename);
+
+		// Shared by shape, tessellation (PrimitiveGeometry::DefaultTessellation() for DirectXTK's) and handedness
+		std::shared_ptr<PrimitiveMesh> LoadPrimitive(PrimitiveShape shape, UINT tessellation, bool isRightHanded = true);
+
+		// A model mesh's GPU buffers in the material's vertex layout, shared by model file, mesh and material type. The
+		// model is loaded, through LoadModel(), only while they are built.
+		std::shared_ptr<MeshBuffers> LoadMeshBuffers(const std::string& modelFilename, bool flipUVs, UINT meshIndex, const Material& material);
+
+		UINT Count() const;
+		void Purge();
+
+	private:
+		ContentManager();
+		ContentManager(const ContentManager& rhs);
+		ContentManager& operator=(const ContentManager& rhs);
+
+		typedef std::pair<const void*, std::wstring> PendingKey;
+
+		typedef struct _PendingResource
+		{
+			std::thread::id Thread;
+			std::shared_future<std::shared_ptr<void>> Resource;
+		} PendingResource;
+
+		// The lock only guards the maps: create() runs outside it, so loads of different keys proceed in parallel and
+		// a loader may load other content. A load of a key already being created waits for that creation instead.
+		template <typename T>
+		std::shared_ptr<T> DemandCreate(std::map<std::wstring, std::weak_ptr<T>>& resources, const std::wstring& key, const std::function<std::shared_ptr<T>()>& create)
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+
+			// Live instances are shared; expired entries are simply replaced
+			auto it = resources.find(key);
+			if (it != resources.end())
+			{
+				std::shared_ptr<T> resource = it->second.lock();
+				if (resource != nullptr)
+				{
+					return resource;
+				}
+			}
+
+			PendingKey pendingKey(&resources, key);
+			auto pending = mPending.find(pendingKey);
+			if (pending != mPending.end())
+			{
+				if (pending->second.Thread == std::this_thread::get_id())
+				{
+					throw GameException("Content loads itself.");
+				}
+
+				std::shared_future<std::shared_ptr<void>> resource = pending->second.Resource;
+				lock.unlock();
+
+				// Rethrows the creating thread's exception
+				return std::static_pointer_cast<T>(resource.get());
+			}
+
+			std::promise<std::shared_ptr<void>> promise;
+			PendingResource& pendingResource = mPending[pendingKey];
+			pendingResource.Thread = std::this_thread::get_id();
+			pendingResource.Resource = promise.get_future().share();
+			lock.unlock();
+
+			std::shared_ptr<T> resource;
+			try
+			{
+				resource = create();
+			}
+			catch (...)
+			{
+				promise.set_exception(std::current_exception());
+				lock.lock();
+				mPending.erase(pendingKey);
+				throw;
+			}
+
+			lock.lock();
+			resources[key] = resource;
+			mPending.erase(pendingKey);
+			lock.unlock();
+
+			promise.set_value(resource);
+
+			return resource;
+		}
+
+		template <typename T>
+		static void PurgeExpired(std::map<std::wstring, std::weak_ptr<T>>& resources)
+		{
+			for (auto it = resources.begin(); it != resources.end();)
+			{
+				if (it->second.expired())
+				{
+					it = resources.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+
+		Game& mGame;
+		std::map<std::wstring, std::weak_ptr<Effect>> mEffects;
+		std::map<std::wstring, std::weak_ptr<Model>> mModels;
+		std::map<std::wstring, std::weak_ptr<ID3D11ShaderResourceView>> mTextures;
+		std::map<std::wstring, std::weak_ptr<TextFont>> mFonts;
+		std::map<std::wstring, std::weak_ptr<PrimitiveMesh>> mPrimitives;
+		std::map<std::wstring, std::weak_ptr<MeshBuffers>> mMeshBuffers;
+		std::map<PendingKey, PendingResource> mPending;
+		mutable std::mutex mMutex;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,459 @@
+#include "DDSFile.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace Library
+{
+	const unsigned int DDSFile::MagicNumber = 0x20534444;
+	const unsigned int DDSFile::MaximumMipCount = 15;
+
+	namespace
+	{
+		const unsigned int HeaderFlagsVolume = 0x00800000;
+		const unsigned int PixelFormatAlpha = 0x00000002;
+		const unsigned int PixelFormatFourCC = 0x00000004;
+		const unsigned int PixelFormatRGB = 0x00000040;
+		const unsigned int PixelFormatLuminance = 0x00020000;
+		const unsigned int Caps2CubeMap = 0x00000200;
+		const unsigned int Caps2CubeMapAllFaces = 0x0000FC00;
+
+		// D3D11_RESOURCE_DIMENSION and D3D11_RESOURCE_MISC_TEXTURECUBE
+		const unsigned int ResourceDimensionTexture1D = 2;
+		const unsigned int ResourceDimensionTexture2D = 3;
+		const unsigned int ResourceDimensionTexture3D = 4;
+		const unsigned int ResourceMiscTextureCube = 0x4;
+
+		inline unsigned int MakeFourCC(char a, char b, char c, char d)
+		{
+			return static_cast<unsigned char>(a) | (static_cast<unsigned char>(b) << 8) | (static_cast<unsigned char>(c) << 16) | (static_cast<unsigned int>(static_cast<unsigned char>(d)) << 24);
+		}
+
+		inline bool IsBitMask(const DDSPixelFormat& pixelFormat, unsigned int r, unsigned int g, unsigned int b, unsigned int a)
+		{
+			return (pixelFormat.RBitMask == r && pixelFormat.GBitMask == g && pixelFormat.BBitMask == b && pixelFormat.ABitMask == a);
+		}
+	}
+
+	DDSFile::DDSFile(const unsigned char* data, unsigned long long size)
+		: mData(data), mSize(size), mDimension(DDSDimensionTexture2D), mFormat(DDSFormatUnknown),
+		  mWidth(0), mHeight(0), mDepth(0), mMipCount(0), mArraySize(0), mIsCubeMap(false), mSubresources()
+	{
+		// The headers are tiny, so they're copied out rather than aliased, which needs no alignment guarantees
+		unsigned int magicNumber;
+		DDSHeader header;
+		if (data == nullptr || size < sizeof(magicNumber) + sizeof(header))
+		{
+			throw std::runtime_error("File is too small to be a DDS file.");
+		}
+
+		memcpy(&magicNumber, data, sizeof(magicNumber));
+		memcpy(&header, data + sizeof(magicNumber), sizeof(header));
+		if (magicNumber != MagicNumber || header.Size != sizeof(DDSHeader) || header.PixelFormat.Size != sizeof(DDSPixelFormat))
+		{
+			throw std::runtime_error("Not a DDS file.");
+		}
+
+		unsigned long long dataOffset = sizeof(magicNumber) + sizeof(header);
+		mWidth = header.Width;
+		mHeight = header.Height;
+		mDepth = 1;
+		mMipCount = std::max(header.MipMapCount, 1U);
+		mArraySize = 1;
+
+		if ((header.PixelFormat.Flags & PixelFormatFourCC) && header.PixelFormat.FourCC == MakeFourCC('D', 'X', '1', '0'))
+		{
+			DDSHeaderDXT10 extendedHeader;
+			if (size < dataOffset + sizeof(extendedHeader))
+			{
+				throw std::runtime_error("DDS file is truncated.");
+			}
+
+			memcpy(&extendedHeader, data + dataOffset, sizeof(extendedHeader));
+			dataOffset += sizeof(extendedHeader);
+
+			mFormat = extendedHeader.Format;
+			mArraySize = extendedHeader.ArraySize;
+			if (mArraySize == 0)
+			{
+				throw std::runtime_error("DDS file has no array slices.");
+			}
+
+			switch (extendedHeader.ResourceDimension)
+			{
+			case ResourceDimensionTexture1D:
+				mDimension = DDSDimensionTexture1D;
+				mHeight = 1;
+				break;
+
+			case ResourceDimensionTexture2D:
+				mDimension = DDSDimensionTexture2D;
+				mIsCubeMap = ((extendedHeader.MiscFlag & ResourceMiscTextureCube) != 0);
+				break;
+
+			case ResourceDimensionTexture3D:
+				if (mArraySize > 1 || (header.Flags & HeaderFlagsVolume) == 0)
+				{
+					throw std::runtime_error("Invalid DDS volume texture.");
+				}
+
+				mDimension = DDSDimensionTexture3D;
+				mDepth = header.Depth;
+				break;
+
+			default:
+				throw std::runtime_error("Unsupported DDS resource dimension.");
+			}
+		}
+		else
+		{
+			mFormat = LegacyFormat(header.PixelFormat);
+
+			if (header.Flags & HeaderFlagsVolume)
+			{
+				mDimension = DDSDimensionTexture3D;
+				mDepth = header.Depth;
+			}
+			else if (header.Caps2 & Caps2CubeMap)
+			{
+				// Legacy cube maps may omit faces, which Direct3D 11 can't represent
+				if ((header.Caps2 & Caps2CubeMapAllFaces) != Caps2CubeMapAllFaces)
+				{
+					throw std::runtime_error("DDS cube map is missing faces.");
+				}
+
+				mIsCubeMap = true;
+			}
+		}
+
+		if (BitsPerPixel(mFormat) == 0)
+		{
+			throw std::runtime_error("Unsupported DDS format.");
+		}
+
+		if (mWidth == 0 || mHeight == 0 || mDepth == 0 || mMipCount > MaximumMipCount)
+		{
+			throw std::runtime_error("Invalid DDS dimensions.");
+		}
+
+		mSubresources.resize(ItemCount() * mMipCount);
+		unsigned long long offset = dataOffset;
+		for (unsigned int item = 0; item < ItemCount(); item++)
+		{
+			unsigned int width = mWidth;
+			unsigned int height = mHeight;
+			unsigned int depth = mDepth;
+
+			for (unsigned int mip = 0; mip < mMipCount; mip++)
+			{
+				DDSSubresource& subresource = mSubresources[item * mMipCount + mip];
+				unsigned int rowCount;
+				SurfaceInfo(width, height, mFormat, subresource.RowPitch, rowCount);
+
+				subresource.Width = width;
+				subresource.Height = height;
+				subresource.Depth = depth;
+				subresource.SlicePitch = subresource.RowPitch * rowCount;
+				subresource.Offset = offset;
+				subresource.Size = static_cast<unsigned long long>(subresource.SlicePitch) * depth;
+				offset += subresource.Size;
+
+				width = std::max(width / 2, 1U);
+				height = std::max(height / 2, 1U);
+				depth = std::max(depth / 2, 1U);
+			}
+		}
+
+		if (offset > size)
+		{
+			throw std::runtime_error("DDS file is truncated.");
+		}
+	}
+
+	DDSDimension DDSFile::Dimension() const
+	{
+		return mDimension;
+	}
+
+	unsigned int DDSFile::Format() const
+	{
+		return mFormat;
+	}
+
+	unsigned int DDSFile::Width() const
+	{
+		return mWidth;
+	}
+
+	unsigned int DDSFile::Height() const
+	{
+		return mHeight;
+	}
+
+	unsigned int DDSFile::Depth() const
+	{
+		return mDepth;
+	}
+
+	unsigned int DDSFile::MipCount() const
+	{
+		return mMipCount;
+	}
+
+	unsigned int DDSFile::ArraySize() const
+	{
+		return mArraySize;
+	}
+
+	bool DDSFile::IsCubeMap() const
+	{
+		return mIsCubeMap;
+	}
+
+	unsigned int DDSFile::ItemCount() const
+	{
+		return mArraySize * (mIsCubeMap ? 6 : 1);
+	}
+
+	const DDSSubresource& DDSFile::Subresource(unsigned int item, unsigned int mip) const
+	{
+		assert(item < ItemCount() && mip < mMipCount);
+
+		return mSubresources[item * mMipCount + mip];
+	}
+
+	const std::vector<DDSSubresource>& DDSFile::Subresources() const
+	{
+		return mSubresources;
+	}
+
+	const unsigned char* DDSFile::SubresourceData(unsigned int item, unsigned int mip) const
+	{
+		return mData + Subresource(item, mip).Offset;
+	}
+
+	unsigned long long DDSFile::MipRangeSize(unsigned int firstMip, unsigned int lastMip) const
+	{
+		unsigned long long size = 0;
+		for (unsigned int item = 0; item < ItemCount(); item++)
+		{
+			unsigned long long offset;
+			unsigned long long itemSize;
+			MipRangeExtent(item, firstMip, lastMip, offset, itemSize);
+			size += itemSize;
+		}
+
+		return size;
+	}
+
+	void DDSFile::MipRangeExtent(unsigned int item, unsigned int firstMip, unsigned int lastMip, unsigned long long& offset, unsigned long long& size) const
+	{
+		assert(firstMip <= lastMip);
+
+		// Mips of an item are contiguous, largest first
+		const DDSSubresource& last = Subresource(item, lastMip);
+		offset = Subresource(item, firstMip).Offset;
+		size = last.Offset + last.Size - offset;
+	}
+
+	unsigned int DDSFile::BitsPerPixel(unsigned int format)
+	{
+		if (format >= 1 && format <= 4)
+		{
+			return 128;
+		}
+		else if (format >= 5 && format <= 8)
+		{
+			return 96;
+		}
+		else if (format >= 9 && format <= 22)
+		{
+			return 64;
+		}
+		else if ((format >= 23 && format <= 47) || (format >= 67 && format <= 69) || (format >= 87 && format <= 93))
+		{
+			return 32;
+		}
+		else if ((format >= 48 && format <= 59) || format == 85 || format == 86 || format == 115)
+		{
+			return 16;
+		}
+		else if ((format >= 60 && format <= 65) || (format >= 73 && format <= 78) || (format >= 82 && format <= 84) || (format >= 94 && format <= 99))
+		{
+			return 8;
+		}
+		else if ((format >= 70 && format <= 72) || (format >= 79 && format <= 81))
+		{
+			return 4;
+		}
+
+		// R1_UNORM is deliberately unsupported, as it is by Direct3D 11 texture creation
+		return 0;
+	}
+
+	bool DDSFile::IsBlockCompressed(unsigned int format)
+	{
+		return ((format >= 70 && format <= 84) || (format >= 94 && format <= 99));
+	}
+
+	void DDSFile::SurfaceInfo(unsigned int width, unsigned int height, unsigned int format, unsigned int& rowPitch, unsigned int& rowCount)
+	{
+		if (IsBlockCompressed(format))
+		{
+			// Four bits per pixel means eight bytes per 4x4 block, eight bits means sixteen
+			rowPitch = std::max((width + 3) / 4, 1U) * BitsPerPixel(format) * 2;
+			rowCount = std::max((height + 3) / 4, 1U);
+		}
+		else if (format == DDSFormatR8G8B8G8Unorm || format == DDSFormatG8R8G8B8Unorm)
+		{
+			rowPitch = ((width + 1) / 2) * 4;
+			rowCount = height;
+		}
+		else
+		{
+			rowPitch = (width * BitsPerPixel(format) + 7) / 8;
+			rowCount = height;
+		}
+	}
+
+	unsigned int DDSFile::LegacyFormat(const DDSPixelFormat& pixelFormat)
+	{
+		if (pixelFormat.Flags & PixelFormatRGB)
+		{
+			switch (pixelFormat.RGBBitCount)
+			{
+			case 32:
+				if (IsBitMask(pixelFormat, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000))
+				{
+					return DDSFormatR8G8B8A8Unorm;
+				}
+				else if (IsBitMask(pixelFormat, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000))
+				{
+					return DDSFormatB8G8R8A8Unorm;
+				}
+				else if (IsBitMask(pixelFormat, 0x00FF0000, 0x0000FF00, 0x000000FF, 0x00000000))
+				{
+					return DDSFormatB8G8R8X8Unorm;
+				}
+				else if (IsBitMask(pixelFormat, 0x3FF00000, 0x000FFC00, 0x000003FF, 0xC0000000))
+				{
+					// Written reversed by D3DX; matches DDSTextureLoader
+					return DDSFormatR10G10B10A2Unorm;
+				}
+				else if (IsBitMask(pixelFormat, 0x0000FFFF, 0xFFFF0000, 0x00000000, 0x00000000))
+				{
+					return DDSFormatR16G16Unorm;
+				}
+				else if (IsBitMask(pixelFormat, 0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000))
+				{
+					return DDSFormatR32Float;
+				}
+				break;
+
+			case 16:
+				if (IsBitMask(pixelFormat, 0x7C00, 0x03E0, 0x001F, 0x8000))
+				{
+					return DDSFormatB5G5R5A1Unorm;
+				}
+				else if (IsBitMask(pixelFormat, 0xF800, 0x07E0, 0x001F, 0x0000))
+				{
+					return DDSFormatB5G6R5Unorm;
+				}
+				break;
+			}
+		}
+		else if (pixelFormat.Flags & PixelFormatLuminance)
+		{
+			if (pixelFormat.RGBBitCount == 8 && IsBitMask(pixelFormat, 0x000000FF, 0x00000000, 0x00000000, 0x00000000))
+			{
+				return DDSFormatR8Unorm;
+			}
+			else if (pixelFormat.RGBBitCount == 16 && IsBitMask(pixelFormat, 0x0000FFFF, 0x00000000, 0x00000000, 0x00000000))
+			{
+				return DDSFormatR16Unorm;
+			}
+			else if (pixelFormat.RGBBitCount == 16 && IsBitMask(pixelFormat, 0x000000FF, 0x00000000, 0x00000000, 0x0000FF00))
+			{
+				return DDSFormatR8G8Unorm;
+			}
+		}
+		else if (pixelFormat.Flags & PixelFormatAlpha)
+		{
+			if (pixelFormat.RGBBitCount == 8)
+			{
+				return DDSFormatA8Unorm;
+			}
+		}
+		else if (pixelFormat.Flags & PixelFormatFourCC)
+		{
+			unsigned int fourCC = pixelFormat.FourCC;
+			if (fourCC == MakeFourCC('D', 'X', 'T', '1'))
+			{
+				return DDSFormatBC1Unorm;
+			}
+			else if (fourCC == MakeFourCC('D', 'X', 'T', '2') || fourCC == MakeFourCC('D', 'X', 'T', '3'))
+			{
+				return DDSFormatBC2Unorm;
+			}
+			else if (fourCC == MakeFourCC('D', 'X', 'T', '4') || fourCC == MakeFourCC('D', 'X', 'T', '5'))
+			{
+				return DDSFormatBC3Unorm;
+			}
+			else if (fourCC == MakeFourCC('A', 'T', 'I', '1') || fourCC == MakeFourCC('B', 'C', '4', 'U'))
+			{
+				return DDSFormatBC4Unorm;
+			}
+			else if (fourCC == MakeFourCC('B', 'C', '4', 'S'))
+			{
+				return DDSFormatBC4Snorm;
+			}
+			else if (fourCC == MakeFourCC('A', 'T', 'I', '2') || fourCC == MakeFourCC('B', 'C', '5', 'U'))
+			{
+				return DDSFormatBC5Unorm;
+			}
+			else if (fourCC == MakeFourCC('B', 'C', '5', 'S'))
+			{
+				return DDSFormatBC5Snorm;
+			}
+			else if (fourCC == MakeFourCC('R', 'G', 'B', 'G'))
+			{
+				return DDSFormatR8G8B8G8Unorm;
+			}
+			else if (fourCC == MakeFourCC('G', 'R', 'G', 'B'))
+			{
+				return DDSFormatG8R8G8B8Unorm;
+			}
+
+			// D3DFORMAT values stored directly in the FourCC
+			switch (fourCC)
+			{
+			case 36:
+				return DDSFormatR16G16B16A16Unorm;
+
+			case 110:
+				return DDSFormatR16G16B16A16Snorm;
+
+			case 111:
+				return DDSFormatR16Float;
+
+			case 112:
+				return DDSFormatR16G16Float;
+
+			case 113:
+				return DDSFormatR16G16B16A16Float;
+
+			case 114:
+				return DDSFormatR32Float;
+
+			case 115:
+				return DDSFormatR32G32Float;
+
+			case 116:
+				return DDSFormatR32G32B32A32Float;
+			}
+		}
+
+		return DDSFormatUnknown;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#pragma once
+
+// Portable: formats are DXGI_FORMAT values, so the layout can be computed without Windows or Direct3D headers
+#include <vector>
+
+namespace Library
+{
+	// The DXGI_FORMAT values the parser names, either for legacy headers or because their layout is unusual
+	enum DDSFormat
+	{
+		DDSFormatUnknown = 0,
+		DDSFormatR32G32B32A32Float = 2,
+		DDSFormatR16G16B16A16Float = 10,
+		DDSFormatR16G16B16A16Unorm = 11,
+		DDSFormatR16G16B16A16Snorm = 13,
+		DDSFormatR32G32Float = 16,
+		DDSFormatR10G10B10A2Unorm = 24,
+		DDSFormatR8G8B8A8Unorm = 28,
+		DDSFormatR8G8B8A8UnormSrgb = 29,
+		DDSFormatR16G16Float = 34,
+		DDSFormatR16G16Unorm = 35,
+		DDSFormatR32Float = 41,
+		DDSFormatR8G8Unorm = 49,
+		DDSFormatR16Float = 54,
+		DDSFormatR16Unorm = 56,
+		DDSFormatR8Unorm = 61,
+		DDSFormatA8Unorm = 65,
+		DDSFormatR8G8B8G8Unorm = 68,
+		DDSFormatG8R8G8B8Unorm = 69,
+		DDSFormatBC1Unorm = 71,
+		DDSFormatBC1UnormSrgb = 72,
+		DDSFormatBC2Unorm = 74,
+		DDSFormatBC3Unorm = 77,
+		DDSFormatBC3UnormSrgb = 78,
+		DDSFormatBC4Unorm = 80,
+		DDSFormatBC4Snorm = 81,
+		DDSFormatBC5Unorm = 83,
+		DDSFormatBC5Snorm = 84,
+		DDSFormatB5G6R5Unorm = 85,
+		DDSFormatB5G5R5A1Unorm = 86,
+		DDSFormatB8G8R8A8Unorm = 87,
+		DDSFormatB8G8R8X8Unorm = 88,
+		DDSFormatB8G8R8A8UnormSrgb = 91,
+		DDSFormatBC7Unorm = 98,
+		DDSFormatBC7UnormSrgb = 99
+	};
+
+	enum DDSDimension
+	{
+		DDSDimensionTexture1D = 0,
+		DDSDimensionTexture2D,
+		DDSDimensionTexture3D,
+		DDSDimensionEnd
+	};
+
+	typedef struct _DDSPixelFormat
+	{
+		unsigned int Size;
+		unsigned int Flags;
+		unsigned int FourCC;
+		unsigned int RGBBitCount;
+		unsigned int RBitMask;
+		unsigned int GBitMask;
+		unsigned int BBitMask;
+		unsigned int ABitMask;
+	} DDSPixelFormat;
+
+	typedef struct _DDSHeader
+	{
+		unsigned int Size;
+		unsigned int Flags;
+		unsigned int Height;
+		unsigned int Width;
+		unsigned int PitchOrLinearSize;
+		unsigned int Depth;
+		unsigned int MipMapCount;
+		unsigned int Reserved1[11];
+		DDSPixelFormat PixelFormat;
+		unsigned int Caps;
+		unsigned int Caps2;
+		unsigned int Caps3;
+		unsigned int Caps4;
+		unsigned int Reserved2;
+	} DDSHeader;
+
+	typedef struct _DDSHeaderDXT10
+	{
+		unsigned int Format;
+		unsigned int ResourceDimension;
+		unsigned int MiscFlag;
+		unsigned int ArraySize;
+		unsigned int MiscFlags2;
+	} DDSHeaderDXT10;
+
+	typedef struct _DDSSubresource
+	{
+		unsigned long long Offset;
+		unsigned long long Size;
+		unsigned int Width;
+		unsigned int Height;
+		unsigned int Depth;
+		unsigned int RowPitch;
+		unsigned int SlicePitch;
+	} DDSSubresource;
+
+	// Reads a DDS file's headers and lays out its subresources in place: the pixel data is never copied, and every
+	// subresource is an offset into the caller's buffer (usually a MappedFile), which must outlive the DDSFile.
+	// Subresources are indexed as Direct3D does, item * MipCount + mip, where items are array slices times faces.
+	class DDSFile
+	{
+	public:
+		// Throws std::runtime_error for anything that isn't a complete, supported DDS file
+		DDSFile(const unsigned char* data, unsigned long long size);
+
+		DDSDimension Dimension() const;
+		unsigned int Format() const;
+		unsigned int Width() const;
+		unsigned int Height() const;
+		unsigned int Depth() const;
+		unsigned int MipCount() const;
+		unsigned int ArraySize() const;
+		bool IsCubeMap() const;
+		unsigned int ItemCount() const;
+
+		const DDSSubresource& Subresource(unsigned int item, unsigned int mip) const;
+		const std::vector<DDSSubresource>& Subresources() const;
+		const unsigned char* SubresourceData(unsigned int item, unsigned int mip) const;
+
+		// Bytes of the mips in [firstMip, lastMip] over every item, and the file range holding them in one item
+		unsigned long long MipRangeSize(unsigned int firstMip, unsigned int lastMip) const;
+		void MipRangeExtent(unsigned int item, unsigned int firstMip, unsigned int lastMip, unsigned long long& offset, unsigned long long& size) const;
+
+		static unsigned int BitsPerPixel(unsigned int format);
+		static bool IsBlockCompressed(unsigned int format);
+		static void SurfaceInfo(unsigned int width, unsigned int height, unsigned int format, unsigned int& rowPitch, unsigned int& rowCount);
+
+		static const unsigned int MagicNumber;
+		static const unsigned int MaximumMipCount;
+
+	private:
+		DDSFile();
+
+		static unsigned int LegacyFormat(const DDSPixelFormat& pixelFormat);
+
+		const unsigned char* mData;
+		unsigned long long mSize;
+		DDSDimension mDimension;
+		unsigned int mFormat;
+		unsigned int mWidth;
+		unsigned int mHeight;
+		unsigned int mDepth;
+		unsigned int mMipCount;
+		unsigned int mArraySize;
+		bool mIsCubeMap;
+		std::vector<DDSSubresource> mSubresources;
+	};
+}
\ No newline at end of file
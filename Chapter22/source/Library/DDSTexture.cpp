@@ -0,0 +1,224 @@
+#include "DDSTexture.h"
+#include "Game.h"
+#include "GameException.h"
+#include <stdexcept>
+
+namespace Library
+{
+	DDSTexture::DDSTexture(Game& game, const std::wstring& filename)
+		: mGame(&game), mFilename(filename), mMappedFile(), mFile(nullptr), mTexture(nullptr), mShaderResourceView(nullptr), mResidentMip(0)
+	{
+		try
+		{
+			mMappedFile.Open(filename);
+			mFile = new DDSFile(mMappedFile.Data(), mMappedFile.Size());
+		}
+		catch (std::runtime_error& ex)
+		{
+			const char* message = ex.what();
+			throw GameException(message);
+		}
+
+		mResidentMip = mFile->MipCount();
+		CreateTexture();
+	}
+
+	DDSTexture::~DDSTexture()
+	{
+		ReleaseObject(mShaderResourceView);
+		ReleaseObject(mTexture);
+		DeleteObject(mFile);
+	}
+
+	const std::wstring& DDSTexture::Filename() const
+	{
+		return mFilename;
+	}
+
+	const DDSFile& DDSTexture::File() const
+	{
+		return *mFile;
+	}
+
+	ID3D11ShaderResourceView* DDSTexture::ShaderResourceView() const
+	{
+		return mShaderResourceView;
+	}
+
+	UINT DDSTexture::ResidentMip() const
+	{
+		return mResidentMip;
+	}
+
+	bool DDSTexture::IsResident() const
+	{
+		return (mResidentMip == 0);
+	}
+
+	void DDSTexture::UploadMips(UINT firstMip)
+	{
+		assert(firstMip < mFile->MipCount());
+
+		if (firstMip >= mResidentMip)
+		{
+			return;
+		}
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		UINT mipCount = mFile->MipCount();
+
+		for (UINT item = 0; item < mFile->ItemCount(); item++)
+		{
+			for (UINT mip = firstMip; mip < mResidentMip; mip++)
+			{
+				const DDSSubresource& subresource = mFile->Subresource(item, mip);
+				direct3DDeviceContext->UpdateSubresource(mTexture, D3D11CalcSubresource(mip, item, mipCount), nullptr, mFile->SubresourceData(item, mip), subresource.RowPitch, subresource.SlicePitch);
+			}
+		}
+
+		mResidentMip = firstMip;
+		direct3DDeviceContext->SetResourceMinLOD(mTexture, static_cast<float>(mResidentMip));
+	}
+
+	void DDSTexture::PrefetchMips(UINT firstMip, UINT lastMip) const
+	{
+		for (UINT item = 0; item < mFile->ItemCount(); item++)
+		{
+			unsigned long long offset;
+			unsigned long long size;
+			mFile->MipRangeExtent(item, firstMip, lastMip, offset, size);
+			mMappedFile.Prefetch(offset, size);
+		}
+	}
+
+	UINT DDSTexture::MipForSize(UINT size) const
+	{
+		UINT mip = 0;
+		while (mip + 1 < mFile->MipCount() && (mFile->Subresource(0, mip).Width > size || mFile->Subresource(0, mip).Height > size))
+		{
+			mip++;
+		}
+
+		return mip;
+	}
+
+	void DDSTexture::CreateTexture()
+	{
+		ID3D11Device* direct3DDevice = mGame->Direct3DDevice();
+		DXGI_FORMAT format = static_cast<DXGI_FORMAT>(mFile->Format());
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC resourceViewDesc;
+		ZeroMemory(&resourceViewDesc, sizeof(resourceViewDesc));
+		resourceViewDesc.Format = format;
+
+		HRESULT hr;
+		switch (mFile->Dimension())
+		{
+		case DDSDimensionTexture1D:
+			{
+				D3D11_TEXTURE1D_DESC textureDesc;
+				ZeroMemory(&textureDesc, sizeof(textureDesc));
+				textureDesc.Width = mFile->Width();
+				textureDesc.MipLevels = mFile->MipCount();
+				textureDesc.ArraySize = mFile->ArraySize();
+				textureDesc.Format = format;
+				textureDesc.Usage = D3D11_USAGE_DEFAULT;
+				textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+				ID3D11Texture1D* texture = nullptr;
+				if (FAILED(hr = direct3DDevice->CreateTexture1D(&textureDesc, nullptr, &texture)))
+				{
+					throw GameException("ID3D11Device::CreateTexture1D() failed.", hr);
+				}
+
+				mTexture = texture;
+				resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE1DARRAY;
+				resourceViewDesc.Texture1DArray.MipLevels = textureDesc.MipLevels;
+				resourceViewDesc.Texture1DArray.ArraySize = textureDesc.ArraySize;
+			}
+			break;
+
+		case DDSDimensionTexture2D:
+			{
+				D3D11_TEXTURE2D_DESC textureDesc;
+				ZeroMemory(&textureDesc, sizeof(textureDesc));
+				textureDesc.Width = mFile->Width();
+				textureDesc.Height = mFile->Height();
+				textureDesc.MipLevels = mFile->MipCount();
+				textureDesc.ArraySize = mFile->ItemCount();
+				textureDesc.Format = format;
+				textureDesc.SampleDesc.Count = 1;
+				textureDesc.SampleDesc.Quality = 0;
+				textureDesc.Usage = D3D11_USAGE_DEFAULT;
+				textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+				textureDesc.MiscFlags = (mFile->IsCubeMap() ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0);
+
+				ID3D11Texture2D* texture = nullptr;
+				if (FAILED(hr = direct3DDevice->CreateTexture2D(&textureDesc, nullptr, &texture)))
+				{
+					throw GameException("ID3D11Device::CreateTexture2D() failed.", hr);
+				}
+
+				mTexture = texture;
+				if (mFile->IsCubeMap())
+				{
+					resourceViewDesc.ViewDimension = (mFile->ArraySize() > 1 ? D3D11_SRV_DIMENSION_TEXTURECUBEARRAY : D3D11_SRV_DIMENSION_TEXTURECUBE);
+					resourceViewDesc.TextureCubeArray.MipLevels = textureDesc.MipLevels;
+					resourceViewDesc.TextureCubeArray.NumCubes = mFile->ArraySize();
+				}
+				else
+				{
+					resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+					resourceViewDesc.Texture2DArray.MipLevels = textureDesc.MipLevels;
+					resourceViewDesc.Texture2DArray.ArraySize = textureDesc.ArraySize;
+				}
+			}
+			break;
+
+		case DDSDimensionTexture3D:
+			{
+				D3D11_TEXTURE3D_DESC textureDesc;
+				ZeroMemory(&textureDesc, sizeof(textureDesc));
+				textureDesc.Width = mFile->Width();
+				textureDesc.Height = mFile->Height();
+				textureDesc.Depth = mFile->Depth();
+				textureDesc.MipLevels = mFile->MipCount();
+				textureDesc.Format = format;
+				textureDesc.Usage = D3D11_USAGE_DEFAULT;
+				textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+				ID3D11Texture3D* texture = nullptr;
+				if (FAILED(hr = direct3DDevice->CreateTexture3D(&textureDesc, nullptr, &texture)))
+				{
+					throw GameException("ID3D11Device::CreateTexture3D() failed.", hr);
+				}
+
+				mTexture = texture;
+				resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE3D;
+				resourceViewDesc.Texture3D.MipLevels = textureDesc.MipLevels;
+			}
+			break;
+
+		default:
+			throw GameException("Unsupported DDS resource dimension.");
+		}
+
+		// Array views of single textures sample exactly like plain ones, so one view type covers both
+		if (resourceViewDesc.ViewDimension == D3D11_SRV_DIMENSION_TEXTURE2DARRAY && mFile->ArraySize() == 1)
+		{
+			resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+		}
+		else if (resourceViewDesc.ViewDimension == D3D11_SRV_DIMENSION_TEXTURE1DARRAY && mFile->ArraySize() == 1)
+		{
+			resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE1D;
+		}
+
+		if (FAILED(hr = direct3DDevice->CreateShaderResourceView(mTexture, &resourceViewDesc, &mShaderResourceView)))
+		{
+			throw GameException("ID3D11Device::CreateShaderResourceView() failed.", hr);
+		}
+
+		// Nothing is resident yet; clamp to the smallest mip until the first upload
+		mGame->Direct3DDeviceContext()->SetResourceMinLOD(mTexture, static_cast<float>(mFile->MipCount() - 1));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Common.h"
+#include "MappedFile.h"
+#include "DDSFile.h"
+
+namespace Library
+{
+	class Game;
+
+	// A texture read straight from a memory-mapped DDS file, one mip range at a time. The texture is created with its
+	// full mip chain and nothing resident; UploadMips() fills mips from the smallest up, and the resource's minimum
+	// LOD keeps samplers off mips that haven't arrived, so the shader resource view is usable from the start.
+	class DDSTexture
+	{
+	public:
+		DDSTexture(Game& game, const std::wstring& filename);
+		~DDSTexture();
+
+		const std::wstring& Filename() const;
+		const DDSFile& File() const;
+		ID3D11ShaderResourceView* ShaderResourceView() const;
+
+		// The most detailed resident mip; MipCount() while nothing is
+		UINT ResidentMip() const;
+		bool IsResident() const;
+
+		// Uploads [firstMip, ResidentMip() - 1] of every item; call on the render thread
+		void UploadMips(UINT firstMip);
+
+		// Reads the file pages holding [firstMip, lastMip] of every item, so a later upload doesn't wait on disk.
+		// Only reads the mapping, so worker threads can call it.
+		void PrefetchMips(UINT firstMip, UINT lastMip) const;
+
+		// First mip whose width and height are both at most size, for picking what to load up front
+		UINT MipForSize(UINT size) const;
+
+	private:
+		DDSTexture();
+		DDSTexture(const DDSTexture& rhs);
+		DDSTexture& operator=(const DDSTexture& rhs);
+
+		void CreateTexture();
+
+		Game* mGame;
+		std::wstring mFilename;
+		MappedFile mMappedFile;
+		DDSFile* mFile;
+		ID3D11Resource* mTexture;
+		ID3D11ShaderResourceView* mShaderResourceView;
+		UINT mResidentMip;
+	};
+}
\ No newline at end of file
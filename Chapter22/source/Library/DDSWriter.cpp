@@ -0,0 +1,125 @@
+#include "DDSWriter.h"
+#include "DDSFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace Library
+{
+	namespace
+	{
+		const unsigned int HeaderFlagsTexture = 0x00001007;
+		const unsigned int HeaderFlagsMipMapCount = 0x00020000;
+		const unsigned int HeaderFlagsPitch = 0x00000008;
+		const unsigned int HeaderFlagsLinearSize = 0x00080000;
+		const unsigned int PixelFormatFourCC = 0x00000004;
+		const unsigned int CapsTexture = 0x00001000;
+		const unsigned int CapsComplex = 0x00000008;
+		const unsigned int CapsMipMap = 0x00400000;
+		const unsigned int FourCCDX10 = 0x30315844;
+		const unsigned int ResourceDimensionTexture2D = 3;
+	}
+
+	void DDSWriter::Write(const std::string& filename, unsigned int format, unsigned int width, unsigned int height, const std::vector<std::vector<unsigned char>>& mips)
+	{
+		const std::vector<unsigned char>* slice = (mips.empty() ? nullptr : &mips[0]);
+		WriteSlices(filename, format, width, height, &slice, 1, static_cast<unsigned int>(mips.size()));
+	}
+
+	void DDSWriter::WriteArray(const std::string& filename, unsigned int format, unsigned int width, unsigned int height, const std::vector<std::vector<std::vector<unsigned char>>>& slices)
+	{
+		std::vector<const std::vector<unsigned char>*> slicePointers;
+		for (const std::vector<std::vector<unsigned char>>& slice : slices)
+		{
+			if (slice.size() != slices[0].size())
+			{
+				throw std::runtime_error("DDS array slices need the same mips.");
+			}
+
+			slicePointers.push_back(slice.empty() ? nullptr : &slice[0]);
+		}
+
+		if (slicePointers.empty())
+		{
+			throw std::runtime_error("Invalid DDS texture description.");
+		}
+
+		WriteSlices(filename, format, width, height, &slicePointers[0], static_cast<unsigned int>(slicePointers.size()), static_cast<unsigned int>(slices[0].size()));
+	}
+
+	void DDSWriter::WriteSlices(const std::string& filename, unsigned int format, unsigned int width, unsigned int height, const std::vector<unsigned char>* const* slices, unsigned int sliceCount, unsigned int mipCount)
+	{
+		if (DDSFile::BitsPerPixel(format) == 0 || width == 0 || height == 0 || sliceCount == 0 || mipCount == 0 || mipCount > DDSFile::MaximumMipCount)
+		{
+			throw std::runtime_error("Invalid DDS texture description.");
+		}
+
+		unsigned int mipWidth = width;
+		unsigned int mipHeight = height;
+		for (unsigned int mip = 0; mip < mipCount; mip++)
+		{
+			unsigned int rowPitch;
+			unsigned int rowCount;
+			DDSFile::SurfaceInfo(mipWidth, mipHeight, format, rowPitch, rowCount);
+			for (unsigned int slice = 0; slice < sliceCount; slice++)
+			{
+				if (slices[slice][mip].size() != static_cast<size_t>(rowPitch) * rowCount)
+				{
+					throw std::runtime_error("DDS mip size does not match its format.");
+				}
+			}
+
+			mipWidth = std::max(mipWidth / 2, 1U);
+			mipHeight = std::max(mipHeight / 2, 1U);
+		}
+
+		unsigned int rowPitch;
+		unsigned int rowCount;
+		DDSFile::SurfaceInfo(width, height, format, rowPitch, rowCount);
+		bool isBlockCompressed = DDSFile::IsBlockCompressed(format);
+
+		DDSHeader header;
+		memset(&header, 0, sizeof(header));
+		header.Size = sizeof(DDSHeader);
+		header.Flags = HeaderFlagsTexture | HeaderFlagsMipMapCount | (isBlockCompressed ? HeaderFlagsLinearSize : HeaderFlagsPitch);
+		header.Width = width;
+		header.Height = height;
+		header.PitchOrLinearSize = (isBlockCompressed ? rowPitch * rowCount : rowPitch);
+		header.MipMapCount = mipCount;
+		header.PixelFormat.Size = sizeof(DDSPixelFormat);
+		header.PixelFormat.Flags = PixelFormatFourCC;
+		header.PixelFormat.FourCC = FourCCDX10;
+		header.Caps = CapsTexture | (mipCount > 1 ? CapsComplex | CapsMipMap : 0);
+
+		DDSHeaderDXT10 extendedHeader;
+		memset(&extendedHeader, 0, sizeof(extendedHeader));
+		extendedHeader.Format = format;
+		extendedHeader.ResourceDimension = ResourceDimensionTexture2D;
+		extendedHeader.ArraySize = sliceCount;
+
+		std::ofstream file(filename.c_str(), std::ios::binary);
+		if (!file)
+		{
+			throw std::runtime_error("Could not create the DDS file.");
+		}
+
+		file.write(reinterpret_cast<const char*>(&DDSFile::MagicNumber), sizeof(DDSFile::MagicNumber));
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(&extendedHeader), sizeof(extendedHeader));
+
+		// Slice by slice, each with all of its mips
+		for (unsigned int slice = 0; slice < sliceCount; slice++)
+		{
+			for (unsigned int mip = 0; mip < mipCount; mip++)
+			{
+				file.write(reinterpret_cast<const char*>(&slices[slice][mip][0]), slices[slice][mip].size());
+			}
+		}
+
+		if (!file)
+		{
+			throw std::runtime_error("Could not write the DDS file.");
+		}
+	}
+}
\ No newline at end of file
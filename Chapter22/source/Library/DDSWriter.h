@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Library
+{
+	// Writes 2D textures as DDS files with a DX10 header, which names every format exactly, sRGB and BC7 included.
+	// The mips are packed back to back, the layout DDSFile and DDSTextureLoader both expect.
+	class DDSWriter
+	{
+	public:
+		// Each mip must hold exactly the bytes DDSFile::SurfaceInfo() gives for its size; throws std::runtime_error
+		static void Write(const std::string& filename, unsigned int format, unsigned int width, unsigned int height, const std::vector<std::vector<unsigned char>>& mips);
+
+		// A 2D texture array, slices[slice][mip]; every slice must have the same mips
+		static void WriteArray(const std::string& filename, unsigned int format, unsigned int width, unsigned int height, const std::vector<std::vector<std::vector<unsigned char>>>& slices);
+
+	private:
+		DDSWriter();
+		DDSWriter(const DDSWriter& rhs);
+		DDSWriter& operator=(const DDSWriter& rhs);
+
+		static void WriteSlices(const std::string& filename, unsigned int format, unsigned int width, unsigned int height, const std::vector<unsigned char>* const* slices, unsigned int sliceCount, unsigned int mipCount);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,302 @@
+#include "DebugDraw.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Camera.h"
+#include "ColorHelper.h"
+#include "ContentManager.h"
+#include "Effect.h"
+#include "BasicMaterial.h"
+#include "Technique.h"
+#include "Pass.h"
+#include "Frustum.h"
+#include "AnimationPlayer.h"
+#include "Model.h"
+#include "Bone.h"
+#include <PrimitiveBatch.h>
+
+namespace Library
+{
+	RTTI_DEFINITIONS(DebugDraw)
+
+	const UINT DebugDraw::BatchVertexCount = 32768;
+	const UINT DebugDraw::SphereSegmentCount = 32;
+
+	// Corners 0-3 go around one face and 4-7 the opposite one, as Frustum::Corners() does for the near and far planes
+	const USHORT DebugDraw::BoxIndices[] = {
+											0, 1, 1, 2, 2, 3, 3, 0,
+											0, 4, 1, 5, 2, 6, 3, 7,
+											4, 5, 5, 6, 6, 7, 7, 4
+										};
+
+	const UINT DebugDraw::BoxIndexCount = ARRAYSIZE(BoxIndices);
+
+	DebugDraw::DebugDraw(Game& game, Camera& camera)
+		: DrawableGameComponent(game, camera),
+		  mEffect(), mMaterial(nullptr), mPass(nullptr), mInputLayout(nullptr), mPrimitiveBatch(nullptr), mDepthTestedState(nullptr),
+		  mOverlayState(nullptr), mDepthTestedVertices(), mOverlayVertices(), mSphereIndices(), mMutex()
+	{
+		// Every sphere is the same three circles of SphereSegmentCount lines
+		mSphereIndices.reserve(SphereSegmentCount * 6);
+		for (UINT circle = 0; circle < 3; circle++)
+		{
+			USHORT first = static_cast<USHORT>(circle * SphereSegmentCount);
+			for (UINT i = 0; i < SphereSegmentCount; i++)
+			{
+				mSphereIndices.push_back(static_cast<USHORT>(first + i));
+				mSphereIndices.push_back(static_cast<USHORT>(first + (i + 1) % SphereSegmentCount));
+			}
+		}
+	}
+
+	DebugDraw::~DebugDraw()
+	{
+		ReleaseObject(mOverlayState);
+		ReleaseObject(mDepthTestedState);
+		DeleteObject(mPrimitiveBatch);
+		DeleteObject(mMaterial);
+	}
+
+	void DebugDraw::DrawLine(FXMVECTOR start, FXMVECTOR end, FXMVECTOR color, bool isDepthTested)
+	{
+		XMFLOAT3 positions[2];
+		XMStoreFloat3(&positions[0], start);
+		XMStoreFloat3(&positions[1], end);
+
+		AddLines(positions, 2, nullptr, 0, color, isDepthTested);
+	}
+
+	void DebugDraw::DrawBox(FXMVECTOR minimum, FXMVECTOR maximum, FXMVECTOR color, bool isDepthTested)
+	{
+		XMFLOAT3 low;
+		XMFLOAT3 high;
+		XMStoreFloat3(&low, minimum);
+		XMStoreFloat3(&high, maximum);
+
+		XMFLOAT3 corners[8] =
+		{
+			XMFLOAT3(low.x, low.y, low.z), XMFLOAT3(high.x, low.y, low.z), XMFLOAT3(high.x, high.y, low.z), XMFLOAT3(low.x, high.y, low.z),
+			XMFLOAT3(low.x, low.y, high.z), XMFLOAT3(high.x, low.y, high.z), XMFLOAT3(high.x, high.y, high.z), XMFLOAT3(low.x, high.y, high.z)
+		};
+
+		AddLines(corners, ARRAYSIZE(corners), BoxIndices, BoxIndexCount, color, isDepthTested);
+	}
+
+	void DebugDraw::DrawBox(CXMMATRIX world, FXMVECTOR color, bool isDepthTested)
+	{
+		// A unit cube about the origin, so world carries the box's center, orientation and size
+		XMFLOAT3 corners[8];
+		for (UINT i = 0; i < ARRAYSIZE(corners); i++)
+		{
+			XMVECTOR corner = XMVectorSet((i == 1 || i == 2 || i == 5 || i == 6 ? 0.5f : -0.5f), (i % 4 >= 2 ? 0.5f : -0.5f), (i >= 4 ? 0.5f : -0.5f), 1.0f);
+			XMStoreFloat3(&corners[i], XMVector3Transform(corner, world));
+		}
+
+		AddLines(corners, ARRAYSIZE(corners), BoxIndices, BoxIndexCount, color, isDepthTested);
+	}
+
+	void DebugDraw::DrawSphere(FXMVECTOR center, float radius, FXMVECTOR color, bool isDepthTested)
+	{
+		// A circle about each axis
+		std::vector<XMFLOAT3>& positions = *mGame->AcquirePooled<std::vector<XMFLOAT3>>();
+		positions.resize(SphereSegmentCount * 3);
+
+		XMFLOAT3 origin;
+		XMStoreFloat3(&origin, center);
+		for (UINT i = 0; i < SphereSegmentCount; i++)
+		{
+			float angle = XM_2PI * i / SphereSegmentCount;
+			float sine = radius * sinf(angle);
+			float cosine = radius * cosf(angle);
+
+			positions[i] = XMFLOAT3(origin.x + cosine, origin.y + sine, origin.z);
+			positions[SphereSegmentCount + i] = XMFLOAT3(origin.x + cosine, origin.y, origin.z + sine);
+			positions[SphereSegmentCount * 2 + i] = XMFLOAT3(origin.x, origin.y + cosine, origin.z + sine);
+		}
+
+		AddLines(&positions[0], static_cast<UINT>(positions.size()), &mSphereIndices[0], static_cast<UINT>(mSphereIndices.size()), color, isDepthTested);
+		mGame->ReleasePooled(&positions);
+	}
+
+	void DebugDraw::DrawFrustum(const Frustum& frustum, FXMVECTOR color, bool isDepthTested)
+	{
+		AddLines(frustum.Corners(), 8, BoxIndices, BoxIndexCount, color, isDepthTested);
+	}
+
+	void DebugDraw::DrawGrid(FXMVECTOR center, UINT size, float scale, FXMVECTOR color, bool isDepthTested)
+	{
+		// As Grid lays out its lines, in the XZ plane, size cells across and scale apart
+		XMFLOAT3 origin;
+		XMStoreFloat3(&origin, center);
+
+		std::vector<XMFLOAT3>& positions = *mGame->AcquirePooled<std::vector<XMFLOAT3>>();
+		positions.clear();
+
+		float maxPosition = size * scale / 2;
+		for (UINT i = 0; i < size + 1; i++)
+		{
+			float position = maxPosition - (i * scale);
+
+			positions.push_back(XMFLOAT3(origin.x + position, origin.y, origin.z + maxPosition));
+			positions.push_back(XMFLOAT3(origin.x + position, origin.y, origin.z - maxPosition));
+			positions.push_back(XMFLOAT3(origin.x + maxPosition, origin.y, origin.z + position));
+			positions.push_back(XMFLOAT3(origin.x - maxPosition, origin.y, origin.z + position));
+		}
+
+		AddLines(&positions[0], static_cast<UINT>(positions.size()), nullptr, 0, color, isDepthTested);
+		mGame->ReleasePooled(&positions);
+	}
+
+	void DebugDraw::DrawAxes(CXMMATRIX world, float length, bool isDepthTested)
+	{
+		XMVECTOR origin = XMVector3Transform(XMVectorZero(), world);
+		DrawLine(origin, XMVector3Transform(XMVectorSet(length, 0.0f, 0.0f, 1.0f), world), ColorHelper::Red, isDepthTested);
+		DrawLine(origin, XMVector3Transform(XMVectorSet(0.0f, length, 0.0f, 1.0f), world), ColorHelper::Green, isDepthTested);
+		DrawLine(origin, XMVector3Transform(XMVectorSet(0.0f, 0.0f, length, 1.0f), world), ColorHelper::Blue, isDepthTested);
+	}
+
+	void DebugDraw::DrawSkeleton(const AnimationPlayer& animationPlayer, CXMMATRIX world, FXMVECTOR color, bool isDepthTested)
+	{
+		// A bone's skinning transform is its offset transform followed by its pose, so undoing the offset leaves the joint
+		const std::vector<Bone*>& bones = animationPlayer.GetModel().Bones();
+		const std::vector<XMFLOAT4X4>& boneTransforms = animationPlayer.BoneTransforms();
+		if (bones.empty() || boneTransforms.size() < bones.size())
+		{
+			return;
+		}
+
+		std::vector<XMFLOAT3>& joints = *mGame->AcquirePooled<std::vector<XMFLOAT3>>();
+		joints.resize(bones.size());
+		for (Bone* bone : bones)
+		{
+			XMMATRIX jointTransform = XMMatrixInverse(nullptr, bone->OffsetTransformMatrix()) * XMLoadFloat4x4(&boneTransforms[bone->Index()]) * world;
+			XMStoreFloat3(&joints[bone->Index()], jointTransform.r[3]);
+		}
+
+		// A line from each bone to the nearest bone above it; scene nodes between bones aren't joints
+		std::vector<XMFLOAT3>& positions = *mGame->AcquirePooled<std::vector<XMFLOAT3>>();
+		positions.clear();
+		for (Bone* bone : bones)
+		{
+			SceneNode* parent = bone->Parent();
+			while (parent != nullptr && parent->Is(Bone::TypeIdClass()) == false)
+			{
+				parent = parent->Parent();
+			}
+
+			if (parent != nullptr)
+			{
+				positions.push_back(joints[parent->As<Bone>()->Index()]);
+				positions.push_back(joints[bone->Index()]);
+			}
+		}
+
+		if (positions.empty() == false)
+		{
+			AddLines(&positions[0], static_cast<UINT>(positions.size()), nullptr, 0, color, isDepthTested);
+		}
+
+		mGame->ReleasePooled(&positions);
+		mGame->ReleasePooled(&joints);
+	}
+
+	UINT DebugDraw::LineCount() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		return static_cast<UINT>((mDepthTestedVertices.size() + mOverlayVertices.size()) / 2);
+	}
+
+	void DebugDraw::Initialize()
+	{
+		mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\BasicEffect.cso");
+
+		mMaterial = new BasicMaterial();
+		mMaterial->Initialize(*mEffect);
+
+		mPass = mMaterial->CurrentTechnique()->Passes().at(0);
+		mInputLayout = mMaterial->InputLayouts().at(mPass);
+
+		// Lines are never indexed, so the batch needs no index buffer
+		mPrimitiveBatch = new PrimitiveBatch<VertexPositionColor>(mGame->Direct3DDeviceContext(), 0, BatchVertexCount);
+
+		// Depth tested lines don't write depth, so they never hide one another
+		D3D11_DEPTH_STENCIL_DESC depthStencilDesc;
+		ZeroMemory(&depthStencilDesc, sizeof(depthStencilDesc));
+		depthStencilDesc.DepthEnable = true;
+		depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+		depthStencilDesc.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;
+
+		HRESULT hr;
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateDepthStencilState(&depthStencilDesc, &mDepthTestedState)))
+		{
+			throw GameException("ID3D11Device::CreateDepthStencilState() failed.", hr);
+		}
+
+		depthStencilDesc.DepthEnable = false;
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateDepthStencilState(&depthStencilDesc, &mOverlayState)))
+		{
+			throw GameException("ID3D11Device::CreateDepthStencilState() failed.", hr);
+		}
+	}
+
+	void DebugDraw::Draw(const GameTime& gameTime)
+	{
+		assert(mPass != nullptr);
+		assert(mInputLayout != nullptr);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mDepthTestedVertices.empty() && mOverlayVertices.empty())
+		{
+			return;
+		}
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		direct3DDeviceContext->IASetInputLayout(mInputLayout);
+
+		mMaterial->WorldViewProjection() << mCamera->ViewProjectionMatrix();
+		mPass->Apply(0, direct3DDeviceContext);
+
+		Flush(mDepthTestedVertices, mDepthTestedState);
+		Flush(mOverlayVertices, mOverlayState);
+
+		direct3DDeviceContext->OMSetDepthStencilState(nullptr, 0);
+	}
+
+	void DebugDraw::AddLines(const XMFLOAT3* positions, UINT positionCount, const USHORT* indices, UINT indexCount, FXMVECTOR color, bool isDepthTested)
+	{
+		XMFLOAT4 vertexColor;
+		XMStoreFloat4(&vertexColor, color);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		std::vector<VertexPositionColor>& vertices = (isDepthTested ? mDepthTestedVertices : mOverlayVertices);
+
+		// Without indices, the positions are the lines' end points in pairs
+		UINT vertexCount = (indices != nullptr ? indexCount : positionCount);
+		for (UINT i = 0; i < vertexCount; i++)
+		{
+			const XMFLOAT3& position = positions[indices != nullptr ? indices[i] : i];
+			vertices.push_back(VertexPositionColor(XMFLOAT4(position.x, position.y, position.z, 1.0f), vertexColor));
+		}
+	}
+
+	void DebugDraw::Flush(std::vector<VertexPositionColor>& vertices, ID3D11DepthStencilState* depthStencilState)
+	{
+		if (vertices.empty())
+		{
+			return;
+		}
+
+		mGame->Direct3DDeviceContext()->OMSetDepthStencilState(depthStencilState, 0);
+
+		// PrimitiveBatch only issues a draw when the topology changes, its buffer wraps, or at End()
+		mPrimitiveBatch->Begin();
+		for (size_t i = 0; i < vertices.size(); i += BatchVertexCount)
+		{
+			size_t vertexCount = min(vertices.size() - i, static_cast<size_t>(BatchVertexCount));
+			mPrimitiveBatch->Draw(D3D11_PRIMITIVE_TOPOLOGY_LINELIST, &vertices[i], vertexCount);
+		}
+
+		mPrimitiveBatch->End();
+		vertices.clear();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Common.h"
+#include "DrawableGameComponent.h"
+#include "VertexDeclarations.h"
+#include <mutex>
+
+namespace DirectX
+{
+	template <typename TVertex>
+	class PrimitiveBatch;
+}
+
+namespace Library
+{
+	class Effect;
+	class BasicMaterial;
+	class Pass;
+	class Frustum;
+	class AnimationPlayer;
+
+	// A service for debug visualization: any component, or a job on the worker threads, queues lines, boxes, spheres,
+	// frusta, grids and skeletons while the frame updates, and Draw() flushes them all through one DirectXTK
+	// PrimitiveBatch, a line list per bucket: one depth tested, one drawn over the scene. RenderableFrustum, Grid and
+	// ProxyModel each own their buffers and effect and cost a draw and an effect bind apiece; here the whole frame's
+	// debug geometry costs two draws, more only when a bucket outgrows BatchVertexCount.
+	//
+	// Queued shapes last one frame, so redraw them every Update(); the scratch space they're built in comes from the
+	// game's object pools, so the steady state allocates nothing. Add it to the components after the scene, so it draws
+	// on top, and to the services under DebugDraw::TypeIdClass().
+	class DebugDraw : public DrawableGameComponent
+	{
+		RTTI_DECLARATIONS(DebugDraw, DrawableGameComponent)
+
+	public:
+		DebugDraw(Game& game, Camera& camera);
+		~DebugDraw();
+
+		void DrawLine(FXMVECTOR start, FXMVECTOR end, FXMVECTOR color, bool isDepthTested = true);
+		void DrawBox(FXMVECTOR minimum, FXMVECTOR maximum, FXMVECTOR color, bool isDepthTested = true);
+		void DrawBox(CXMMATRIX world, FXMVECTOR color, bool isDepthTested = true);
+		void DrawSphere(FXMVECTOR center, float radius, FXMVECTOR color, bool isDepthTested = true);
+		void DrawFrustum(const Frustum& frustum, FXMVECTOR color, bool isDepthTested = true);
+		void DrawGrid(FXMVECTOR center, UINT size, float scale, FXMVECTOR color, bool isDepthTested = true);
+		void DrawAxes(CXMMATRIX world, float length, bool isDepthTested = true);
+
+		// Skeletons are drawn over the scene by default, since the skin hides them
+		void DrawSkeleton(const AnimationPlayer& animationPlayer, CXMMATRIX world, FXMVECTOR color, bool isDepthTested = false);
+
+		UINT LineCount() const;
+
+		virtual void Initialize() override;
+		virtual void Draw(const GameTime& gameTime) override;
+
+		static const UINT BatchVertexCount;
+		static const UINT SphereSegmentCount;
+
+	private:
+		DebugDraw();
+		DebugDraw(const DebugDraw& rhs);
+		DebugDraw& operator=(const DebugDraw& rhs);
+
+		void AddLines(const XMFLOAT3* positions, UINT positionCount, const USHORT* indices, UINT indexCount, FXMVECTOR color, bool isDepthTested);
+		void Flush(std::vector<VertexPositionColor>& vertices, ID3D11DepthStencilState* depthStencilState);
+
+		static const USHORT BoxIndices[];
+		static const UINT BoxIndexCount;
+
+		std::shared_ptr<Effect> mEffect;
+		BasicMaterial* mMaterial;
+		Pass* mPass;
+		ID3D11InputLayout* mInputLayout;
+		DirectX::PrimitiveBatch<VertexPositionColor>* mPrimitiveBatch;
+		ID3D11DepthStencilState* mDepthTestedState;
+		ID3D11DepthStencilState* mOverlayState;
+
+		std::vector<VertexPositionColor> mDepthTestedVertices;
+		std::vector<VertexPositionColor> mOverlayVertices;
+		std::vector<USHORT> mSphereIndices;
+		mutable std::mutex mMutex;
+	};
+}
\ No newline at end of file
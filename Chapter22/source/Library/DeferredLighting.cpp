@@ -0,0 +1,247 @@
+#include "DeferredLighting.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Camera.h"
+#include "ContentManager.h"
+#include "DeferredMaterial.h"
+#include "GBuffer.h"
+#include "FullScreenQuad.h"
+#include "RenderStateHelper.h"
+#include "DirectionalLight.h"
+#include "PointLight.h"
+#include "SpotLight.h"
+#include "Utility.h"
+#include <algorithm>
+
+namespace Library
+{
+	RTTI_DEFINITIONS(DeferredLighting)
+
+	DeferredLighting::DeferredLighting(Game& game, Camera& camera)
+		: DrawableGameComponent(game, camera),
+		  mEffect(), mMaterial(nullptr), mGBuffer(nullptr), mFullScreenQuad(nullptr), mRenderStateHelper(nullptr),
+		  mAmbientColor(0.0f, 0.0f, 0.0f, 0.0f), mDirectionalLight(nullptr), mLights(), mActiveLight(nullptr), mDrawnLightCount(0),
+		  mUpdateMaterial(nullptr)
+	{
+	}
+
+	DeferredLighting::~DeferredLighting()
+	{
+		DeleteObject(mRenderStateHelper);
+		DeleteObject(mFullScreenQuad);
+		DeleteObject(mGBuffer);
+		DeleteObject(mMaterial);
+	}
+
+	GBuffer* DeferredLighting::GetGBuffer() const
+	{
+		return mGBuffer;
+	}
+
+	DeferredMaterial* DeferredLighting::GetMaterial() const
+	{
+		return mMaterial;
+	}
+
+	const XMCOLOR& DeferredLighting::AmbientColor() const
+	{
+		return mAmbientColor;
+	}
+
+	void DeferredLighting::SetAmbientColor(const XMCOLOR& ambientColor)
+	{
+		mAmbientColor = ambientColor;
+	}
+
+	DirectionalLight* DeferredLighting::GetDirectionalLight() const
+	{
+		return mDirectionalLight;
+	}
+
+	void DeferredLighting::SetDirectionalLight(DirectionalLight* directionalLight)
+	{
+		mDirectionalLight = directionalLight;
+	}
+
+	const std::vector<PointLight*>& DeferredLighting::Lights() const
+	{
+		return mLights;
+	}
+
+	void DeferredLighting::AddLight(PointLight& light)
+	{
+		mLights.push_back(&light);
+	}
+
+	void DeferredLighting::RemoveLight(PointLight& light)
+	{
+		mLights.erase(std::remove(mLights.begin(), mLights.end(), &light), mLights.end());
+	}
+
+	UINT DeferredLighting::DrawnLightCount() const
+	{
+		return mDrawnLightCount;
+	}
+
+	void DeferredLighting::BeginGeometry()
+	{
+		mGBuffer->Begin();
+		mGBuffer->Clear();
+	}
+
+	void DeferredLighting::EndGeometry()
+	{
+		mGBuffer->End();
+	}
+
+	void DeferredLighting::Initialize()
+	{
+		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
+
+		mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\Deferred.cso");
+
+		mMaterial = new DeferredMaterial();
+		mMaterial->Initialize(*mEffect);
+
+		mGBuffer = new GBuffer(*mGame);
+		mRenderStateHelper = new RenderStateHelper(*mGame);
+
+		mFullScreenQuad = new FullScreenQuad(*mGame, *mMaterial);
+		mFullScreenQuad->Initialize();
+		mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&DeferredLighting::UpdateMaterial, this));
+	}
+
+	void DeferredLighting::Draw(const GameTime& gameTime)
+	{
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		mRenderStateHelper->SaveAll();
+
+		mFullScreenQuad->SetMaterial(*mMaterial, "deferred_directional_light", "p0");
+		mUpdateMaterial = &DeferredLighting::UpdateDirectionalLightMaterial;
+		mFullScreenQuad->Draw(gameTime);
+
+		// Each light only touches the pixels inside its projected bounds, so cost follows covered area rather than light count
+		mDrawnLightCount = 0;
+		mFullScreenQuad->SetActiveTechnique("deferred_point_light", "p0");
+		mUpdateMaterial = &DeferredLighting::UpdatePointLightMaterial;
+		for (PointLight* light : mLights)
+		{
+			D3D11_RECT scissorRect;
+			if (ComputeScissorRect(*light, scissorRect) == false)
+			{
+				continue;
+			}
+
+			direct3DDeviceContext->RSSetScissorRects(1, &scissorRect);
+			mActiveLight = light;
+			mFullScreenQuad->Draw(gameTime);
+			mDrawnLightCount++;
+		}
+
+		mGame->UnbindPixelShaderResources(0, 4);
+		mRenderStateHelper->RestoreAll();
+	}
+
+	bool DeferredLighting::ComputeScissorRect(const PointLight& light, D3D11_RECT& scissorRect) const
+	{
+		XMFLOAT3 center;
+		XMStoreFloat3(&center, XMVector3TransformCoord(light.PositionVector(), mCamera->ViewMatrix()));
+		float radius = light.Radius();
+
+		// View space looks down -z
+		float nearDepth = -center.z - radius;
+		float farDepth = -center.z + radius;
+		if (farDepth <= mCamera->NearPlaneDistance())
+		{
+			return false;
+		}
+
+		float width = static_cast<float>(mGame->ScreenWidth());
+		float height = static_cast<float>(mGame->ScreenHeight());
+		float left = 0.0f;
+		float right = width;
+		float top = 0.0f;
+		float bottom = height;
+
+		// A sphere reaching the near plane can cover any part of the screen
+		if (nearDepth > mCamera->NearPlaneDistance())
+		{
+			float tanHalfFieldOfViewY = tanf(mCamera->FieldOfView() * 0.5f);
+			float tanHalfFieldOfViewX = tanHalfFieldOfViewY * mCamera->AspectRatio();
+
+			float minimumX = min((center.x - radius) / nearDepth, (center.x - radius) / farDepth) / tanHalfFieldOfViewX;
+			float maximumX = max((center.x + radius) / nearDepth, (center.x + radius) / farDepth) / tanHalfFieldOfViewX;
+			float minimumY = min((center.y - radius) / nearDepth, (center.y - radius) / farDepth) / tanHalfFieldOfViewY;
+			float maximumY = max((center.y + radius) / nearDepth, (center.y + radius) / farDepth) / tanHalfFieldOfViewY;
+
+			left = max(floorf((minimumX + 1.0f) * 0.5f * width), 0.0f);
+			right = min(ceilf((maximumX + 1.0f) * 0.5f * width), width);
+			top = max(floorf((1.0f - maximumY) * 0.5f * height), 0.0f);
+			bottom = min(ceilf((1.0f - minimumY) * 0.5f * height), height);
+		}
+
+		if (left >= right || top >= bottom)
+		{
+			return false;
+		}
+
+		scissorRect.left = static_cast<LONG>(left);
+		scissorRect.right = static_cast<LONG>(right);
+		scissorRect.top = static_cast<LONG>(top);
+		scissorRect.bottom = static_cast<LONG>(bottom);
+
+		return true;
+	}
+
+	void DeferredLighting::UpdateMaterial()
+	{
+		float tanHalfFieldOfView = tanf(mCamera->FieldOfView() * 0.5f);
+		XMMATRIX inverseViewMatrix = XMMatrixInverse(nullptr, mCamera->ViewMatrix());
+
+		mMaterial->AlbedoBuffer() << mGBuffer->OutputTexture(GBufferTargetAlbedo);
+		mMaterial->NormalBuffer() << mGBuffer->OutputTexture(GBufferTargetNormal);
+		mMaterial->SpecularBuffer() << mGBuffer->OutputTexture(GBufferTargetSpecular);
+		mMaterial->DepthBuffer() << mGBuffer->DepthTexture();
+		mMaterial->InverseViewMatrix() << inverseViewMatrix;
+		mMaterial->ProjectionParameters() << XMVectorSet(tanHalfFieldOfView * mCamera->AspectRatio(), tanHalfFieldOfView, mCamera->NearPlaneDistance(), mCamera->FarPlaneDistance());
+		mMaterial->CameraPosition() << mCamera->PositionVector();
+
+		(this->*mUpdateMaterial)();
+	}
+
+	void DeferredLighting::UpdateDirectionalLightMaterial()
+	{
+		mMaterial->AmbientColor() << XMLoadColor(&mAmbientColor);
+
+		if (mDirectionalLight != nullptr)
+		{
+			mMaterial->LightColor() << mDirectionalLight->ColorVector();
+			mMaterial->LightDirection() << mDirectionalLight->DirectionVector();
+		}
+		else
+		{
+			mMaterial->LightColor() << XMVectorZero();
+		}
+	}
+
+	void DeferredLighting::UpdatePointLightMaterial()
+	{
+		SpotLight* spotLight = mActiveLight->As<SpotLight>();
+
+		mMaterial->LightColor() << mActiveLight->ColorVector();
+		mMaterial->LightPosition() << mActiveLight->PositionVector();
+		mMaterial->LightRadius() << mActiveLight->Radius();
+
+		if (spotLight != nullptr)
+		{
+			mMaterial->LightDirection() << spotLight->DirectionVector();
+			mMaterial->SpotLightOuterAngle() << spotLight->OuterAngle();
+			mMaterial->SpotLightInnerAngle() << spotLight->InnerAngle();
+		}
+		else
+		{
+			mMaterial->SpotLightOuterAngle() << -1.0f;
+			mMaterial->SpotLightInnerAngle() << -1.0f;
+		}
+	}
+}
\ No newline at end of file
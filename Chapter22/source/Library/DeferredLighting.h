@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Common.h"
+#include "DrawableGameComponent.h"
+
+namespace Library
+{
+	class Effect;
+	class DeferredMaterial;
+	class GBuffer;
+	class FullScreenQuad;
+	class RenderStateHelper;
+	class DirectionalLight;
+	class PointLight;
+
+	// Optional deferred path: geometry drawn between BeginGeometry() and EndGeometry() with GetMaterial()'s deferred_geometry
+	// technique fills the GBuffer once, then Draw() shades it into the bound render target with an ambient and directional
+	// pass plus one additive, scissored full-screen pass per point or spot light.
+	class DeferredLighting : public DrawableGameComponent
+	{
+		RTTI_DECLARATIONS(DeferredLighting, DrawableGameComponent)
+
+	public:
+		DeferredLighting(Game& game, Camera& camera);
+		~DeferredLighting();
+
+		GBuffer* GetGBuffer() const;
+		DeferredMaterial* GetMaterial() const;
+
+		const XMCOLOR& AmbientColor() const;
+		void SetAmbientColor(const XMCOLOR& ambientColor);
+
+		DirectionalLight* GetDirectionalLight() const;
+		void SetDirectionalLight(DirectionalLight* directionalLight);
+
+		// Spot lights are recognized through RTTI
+		const std::vector<PointLight*>& Lights() const;
+		void AddLight(PointLight& light);
+		void RemoveLight(PointLight& light);
+
+		// Lights whose screen bounds were visible in the last Draw()
+		UINT DrawnLightCount() const;
+
+		void BeginGeometry();
+		void EndGeometry();
+
+		virtual void Initialize() override;
+		virtual void Draw(const GameTime& gameTime) override;
+
+	private:
+		DeferredLighting();
+		DeferredLighting(const DeferredLighting& rhs);
+		DeferredLighting& operator=(const DeferredLighting& rhs);
+
+		bool ComputeScissorRect(const PointLight& light, D3D11_RECT& scissorRect) const;
+
+		void UpdateMaterial();
+		void UpdateDirectionalLightMaterial();
+		void UpdatePointLightMaterial();
+
+		std::shared_ptr<Effect> mEffect;
+		DeferredMaterial* mMaterial;
+		GBuffer* mGBuffer;
+		FullScreenQuad* mFullScreenQuad;
+		RenderStateHelper* mRenderStateHelper;
+		XMCOLOR mAmbientColor;
+		DirectionalLight* mDirectionalLight;
+		std::vector<PointLight*> mLights;
+		PointLight* mActiveLight;
+		UINT mDrawnLightCount;
+		void (DeferredLighting::*mUpdateMaterial)();
+	};
+}
\ No newline at end of file
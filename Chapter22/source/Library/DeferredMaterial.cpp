@@ -0,0 +1,130 @@
+#include "DeferredMaterial.h"
+#include "GameException.h"
+#include "Mesh.h"
+
+namespace Library
+{
+	RTTI_DEFINITIONS(DeferredMaterial)
+
+	DeferredMaterial::DeferredMaterial()
+		: Material("deferred_geometry"),
+		  MATERIAL_VARIABLE_INITIALIZATION(WorldViewProjection), MATERIAL_VARIABLE_INITIALIZATION(World),
+		  MATERIAL_VARIABLE_INITIALIZATION(SpecularColor), MATERIAL_VARIABLE_INITIALIZATION(SpecularPower),
+		  MATERIAL_VARIABLE_INITIALIZATION(ColorTexture), MATERIAL_VARIABLE_INITIALIZATION(AmbientColor),
+		  MATERIAL_VARIABLE_INITIALIZATION(LightColor), MATERIAL_VARIABLE_INITIALIZATION(LightPosition),
+		  MATERIAL_VARIABLE_INITIALIZATION(LightRadius), MATERIAL_VARIABLE_INITIALIZATION(LightDirection),
+		  MATERIAL_VARIABLE_INITIALIZATION(SpotLightOuterAngle), MATERIAL_VARIABLE_INITIALIZATION(SpotLightInnerAngle),
+		  MATERIAL_VARIABLE_INITIALIZATION(CameraPosition), MATERIAL_VARIABLE_INITIALIZATION(InverseViewMatrix),
+		  MATERIAL_VARIABLE_INITIALIZATION(ProjectionParameters), MATERIAL_VARIABLE_INITIALIZATION(AlbedoBuffer),
+		  MATERIAL_VARIABLE_INITIALIZATION(NormalBuffer), MATERIAL_VARIABLE_INITIALIZATION(SpecularBuffer),
+		  MATERIAL_VARIABLE_INITIALIZATION(DepthBuffer)
+	{
+	}
+
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, WorldViewProjection)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, World)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, SpecularColor)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, SpecularPower)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, ColorTexture)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, AmbientColor)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, LightColor)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, LightPosition)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, LightRadius)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, LightDirection)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, SpotLightOuterAngle)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, SpotLightInnerAngle)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, CameraPosition)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, InverseViewMatrix)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, ProjectionParameters)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, AlbedoBuffer)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, NormalBuffer)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, SpecularBuffer)
+	MATERIAL_VARIABLE_DEFINITION(DeferredMaterial, DepthBuffer)
+
+	void DeferredMaterial::Initialize(Effect& effect)
+	{
+		Material::Initialize(effect);
+
+		MATERIAL_VARIABLE_RETRIEVE(WorldViewProjection)
+		MATERIAL_VARIABLE_RETRIEVE(World)
+		MATERIAL_VARIABLE_RETRIEVE(SpecularColor)
+		MATERIAL_VARIABLE_RETRIEVE(SpecularPower)
+		MATERIAL_VARIABLE_RETRIEVE(ColorTexture)
+		MATERIAL_VARIABLE_RETRIEVE(AmbientColor)
+		MATERIAL_VARIABLE_RETRIEVE(LightColor)
+		MATERIAL_VARIABLE_RETRIEVE(LightPosition)
+		MATERIAL_VARIABLE_RETRIEVE(LightRadius)
+		MATERIAL_VARIABLE_RETRIEVE(LightDirection)
+		MATERIAL_VARIABLE_RETRIEVE(SpotLightOuterAngle)
+		MATERIAL_VARIABLE_RETRIEVE(SpotLightInnerAngle)
+		MATERIAL_VARIABLE_RETRIEVE(CameraPosition)
+		MATERIAL_VARIABLE_RETRIEVE(InverseViewMatrix)
+		MATERIAL_VARIABLE_RETRIEVE(ProjectionParameters)
+		MATERIAL_VARIABLE_RETRIEVE(AlbedoBuffer)
+		MATERIAL_VARIABLE_RETRIEVE(NormalBuffer)
+		MATERIAL_VARIABLE_RETRIEVE(SpecularBuffer)
+		MATERIAL_VARIABLE_RETRIEVE(DepthBuffer)
+
+		D3D11_INPUT_ELEMENT_DESC geometryInputElementDescriptions[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+		};
+
+		CreateInputLayout("deferred_geometry", "p0", geometryInputElementDescriptions, ARRAYSIZE(geometryInputElementDescriptions));
+
+		// The light passes draw FullScreenQuad's VertexPositionTexture vertices
+		D3D11_INPUT_ELEMENT_DESC quadInputElementDescriptions[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+		};
+
+		CreateInputLayout("deferred_directional_light", "p0", quadInputElementDescriptions, ARRAYSIZE(quadInputElementDescriptions));
+		CreateInputLayout("deferred_point_light", "p0", quadInputElementDescriptions, ARRAYSIZE(quadInputElementDescriptions));
+	}
+
+	void DeferredMaterial::CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
+	{
+		const std::vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
+		std::vector<XMFLOAT3>* textureCoordinates = mesh.TextureCoordinates().at(0);
+		assert(textureCoordinates->size() == sourceVertices.size());
+		const std::vector<XMFLOAT3>& normals = mesh.Normals();
+		assert(normals.size() == sourceVertices.size());
+
+		std::vector<VertexPositionTextureNormal> vertices;
+		vertices.reserve(sourceVertices.size());
+		for (UINT i = 0; i < sourceVertices.size(); i++)
+		{
+			XMFLOAT3 position = sourceVertices.at(i);
+			XMFLOAT3 uv = textureCoordinates->at(i);
+			XMFLOAT3 normal = normals.at(i);
+			vertices.push_back(VertexPositionTextureNormal(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y), normal));
+		}
+
+		CreateVertexBuffer(device, &vertices[0], vertices.size(), vertexBuffer);
+	}
+
+	void DeferredMaterial::CreateVertexBuffer(ID3D11Device* device, VertexPositionTextureNormal* vertices, UINT vertexCount, ID3D11Buffer** vertexBuffer) const
+	{
+		D3D11_BUFFER_DESC vertexBufferDesc;
+		ZeroMemory(&vertexBufferDesc, sizeof(vertexBufferDesc));
+		vertexBufferDesc.ByteWidth = VertexSize() * vertexCount;
+		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+
+		D3D11_SUBRESOURCE_DATA vertexSubResourceData;
+		ZeroMemory(&vertexSubResourceData, sizeof(vertexSubResourceData));
+		vertexSubResourceData.pSysMem = vertices;
+		if (FAILED(device->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, vertexBuffer)))
+		{
+			throw GameException("ID3D11Device::CreateBuffer() failed.");
+		}
+	}
+
+	UINT DeferredMaterial::VertexSize() const
+	{
+		return sizeof(VertexPositionTextureNormal);
+	}
+}
\ No newline at end of file
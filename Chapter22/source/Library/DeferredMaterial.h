@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Common.h"
+#include "Material.h"
+#include "VertexDeclarations.h"
+
+namespace Library
+{
+	// Deferred.fx: deferred_geometry fills a GBuffer from meshes; the light techniques shade it with full-screen quads
+	class DeferredMaterial : public Material
+	{
+		RTTI_DECLARATIONS(DeferredMaterial, Material)
+
+		MATERIAL_VARIABLE_DECLARATION(WorldViewProjection)
+		MATERIAL_VARIABLE_DECLARATION(World)
+		MATERIAL_VARIABLE_DECLARATION(SpecularColor)
+		MATERIAL_VARIABLE_DECLARATION(SpecularPower)
+		MATERIAL_VARIABLE_DECLARATION(ColorTexture)
+
+		MATERIAL_VARIABLE_DECLARATION(AmbientColor)
+		MATERIAL_VARIABLE_DECLARATION(LightColor)
+		MATERIAL_VARIABLE_DECLARATION(LightPosition)
+		MATERIAL_VARIABLE_DECLARATION(LightRadius)
+		MATERIAL_VARIABLE_DECLARATION(LightDirection)
+		MATERIAL_VARIABLE_DECLARATION(SpotLightOuterAngle)
+		MATERIAL_VARIABLE_DECLARATION(SpotLightInnerAngle)
+		MATERIAL_VARIABLE_DECLARATION(CameraPosition)
+		MATERIAL_VARIABLE_DECLARATION(InverseViewMatrix)
+		MATERIAL_VARIABLE_DECLARATION(ProjectionParameters)
+
+		MATERIAL_VARIABLE_DECLARATION(AlbedoBuffer)
+		MATERIAL_VARIABLE_DECLARATION(NormalBuffer)
+		MATERIAL_VARIABLE_DECLARATION(SpecularBuffer)
+		MATERIAL_VARIABLE_DECLARATION(DepthBuffer)
+
+	public:
+		DeferredMaterial();
+
+		virtual void Initialize(Effect& effect) override;
+		virtual void CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const override;
+		void CreateVertexBuffer(ID3D11Device* device, VertexPositionTextureNormal* vertices, UINT vertexCount, ID3D11Buffer** vertexBuffer) const;
+		virtual UINT VertexSize() const override;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,422 @@
+#include "DistanceFieldFont.h"
+#include "BlockCompressor.h"
+#include "DDSFile.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace Library
+{
+	const DistanceFieldFontSettings DistanceFieldFont::DefaultSettings = { 32.0f, 4.0f, 32, 126, '?', 256, DDSFormatR8Unorm };
+	const unsigned int DistanceFieldFont::CurveSubdivisions = 8;
+
+	namespace
+	{
+		const double Pi = 3.14159265358979323846;
+
+		typedef struct _GlyphPlacement
+		{
+			unsigned int Character;
+			GlyphOutline Outline;
+			int Left;
+			int Top;
+			unsigned int Width;
+			unsigned int Height;
+			unsigned int X;
+			unsigned int Y;
+		} GlyphPlacement;
+
+		// Real roots of a t^3 + b t^2 + c t + d
+		unsigned int SolveCubic(double a, double b, double c, double d, double roots[3])
+		{
+			if (fabs(a) < 1e-12)
+			{
+				if (fabs(b) < 1e-12)
+				{
+					if (fabs(c) < 1e-12)
+					{
+						return 0;
+					}
+
+					roots[0] = -d / c;
+					return 1;
+				}
+
+				double discriminant = c * c - 4.0 * b * d;
+				if (discriminant < 0.0)
+				{
+					return 0;
+				}
+
+				double root = sqrt(discriminant);
+				roots[0] = (-c + root) / (2.0 * b);
+				roots[1] = (-c - root) / (2.0 * b);
+				return 2;
+			}
+
+			// Depressed to s^3 + p s + q with t = s - b / 3a
+			b /= a;
+			c /= a;
+			d /= a;
+			double p = c - b * b / 3.0;
+			double q = 2.0 * b * b * b / 27.0 - b * c / 3.0 + d;
+			double offset = -b / 3.0;
+			double discriminant = q * q / 4.0 + p * p * p / 27.0;
+
+			if (discriminant > 0.0)
+			{
+				double root = sqrt(discriminant);
+				roots[0] = cbrt(-q / 2.0 + root) + cbrt(-q / 2.0 - root) + offset;
+				return 1;
+			}
+
+			if (fabs(p) < 1e-12)
+			{
+				roots[0] = cbrt(-q) + offset;
+				return 1;
+			}
+
+			double radius = sqrt(-p / 3.0);
+			double angle = acos(std::max(-1.0, std::min(1.0, -q / (2.0 * radius * radius * radius))));
+			for (unsigned int i = 0; i < 3; i++)
+			{
+				roots[i] = 2.0 * radius * cos((angle - 2.0 * Pi * i) / 3.0) + offset;
+			}
+
+			return 3;
+		}
+
+		void CurvePoint(const OutlineSegment& segment, float t, float point[2])
+		{
+			float u = 1.0f - t;
+			for (unsigned int axis = 0; axis < 2; axis++)
+			{
+				point[axis] = u * u * segment.Points[0][axis] + 2.0f * u * t * segment.Points[1][axis] + t * t * segment.Points[2][axis];
+			}
+		}
+
+		// Dan Sunday's crossing rule: upward edges crossing the ray to +x with the point on their left count +1, downward -1
+		int EdgeWinding(const float start[2], const float end[2], float x, float y)
+		{
+			float side = (end[0] - start[0]) * (y - start[1]) - (x - start[0]) * (end[1] - start[1]);
+			if (start[1] <= y)
+			{
+				return (end[1] > y && side > 0.0f ? 1 : 0);
+			}
+
+			return (end[1] <= y && side < 0.0f ? -1 : 0);
+		}
+	}
+
+	void DistanceFieldFont::Generate(const TrueTypeFont& font, const DistanceFieldFontSettings& settings, SpriteFontData& output, ThreadPool* threadPool)
+	{
+		if (settings.Size <= 0.0f || settings.Spread <= 0.0f || settings.FirstCharacter > settings.LastCharacter || settings.TextureWidth < 4 ||
+			settings.TextureWidth % 4 != 0 || (settings.TextureFormat != DDSFormatR8Unorm && settings.TextureFormat != DDSFormatBC4Unorm))
+		{
+			throw std::runtime_error("Invalid distance field font settings.");
+		}
+
+		float scale = settings.Size / font.UnitsPerEm();
+		int padding = static_cast<int>(ceil(settings.Spread));
+
+		// Each glyph's field covers its outline's bounds in texels, grown by the spread
+		std::vector<GlyphPlacement> placements;
+		for (unsigned int character = settings.FirstCharacter; character <= settings.LastCharacter; character++)
+		{
+			unsigned int glyphIndex = font.GlyphIndex(character);
+			if (glyphIndex == 0)
+			{
+				continue;
+			}
+
+			placements.push_back(GlyphPlacement());
+			GlyphPlacement& placement = placements.back();
+			placement.Character = character;
+			placement.Left = 0;
+			placement.Top = 0;
+			placement.Width = 0;
+			placement.Height = 0;
+			placement.X = 0;
+			placement.Y = 0;
+			font.Outline(glyphIndex, placement.Outline);
+
+			if (placement.Outline.Segments.empty() == false)
+			{
+				const float* bounds = placement.Outline.Bounds;
+				placement.Left = static_cast<int>(floor(bounds[0] * scale)) - padding;
+				placement.Top = static_cast<int>(floor(-bounds[3] * scale)) - padding;
+				placement.Width = static_cast<unsigned int>(static_cast<int>(ceil(bounds[2] * scale)) + padding - placement.Left);
+				placement.Height = static_cast<unsigned int>(static_cast<int>(ceil(-bounds[1] * scale)) + padding - placement.Top);
+				if (placement.Width + 1 > settings.TextureWidth)
+				{
+					throw std::runtime_error("A glyph is wider than the atlas.");
+				}
+			}
+		}
+
+		if (placements.empty())
+		{
+			throw std::runtime_error("The font has none of the characters.");
+		}
+
+		// Shelves of glyphs, tallest first, a texel apart
+		std::vector<unsigned int> order(placements.size());
+		for (unsigned int i = 0; i < order.size(); i++)
+		{
+			order[i] = i;
+		}
+
+		std::stable_sort(order.begin(), order.end(), [&placements](unsigned int lhs, unsigned int rhs)
+		{
+			return placements[lhs].Height > placements[rhs].Height;
+		});
+
+		unsigned int shelfX = 1;
+		unsigned int shelfY = 1;
+		unsigned int shelfHeight = 0;
+		for (unsigned int index : order)
+		{
+			GlyphPlacement& placement = placements[index];
+			if (placement.Width == 0)
+			{
+				continue;
+			}
+
+			if (shelfX + placement.Width + 1 > settings.TextureWidth)
+			{
+				shelfX = 1;
+				shelfY += shelfHeight + 1;
+				shelfHeight = 0;
+			}
+
+			placement.X = shelfX;
+			placement.Y = shelfY;
+			shelfX += placement.Width + 1;
+			shelfHeight = std::max(shelfHeight, placement.Height);
+		}
+
+		unsigned int textureWidth = settings.TextureWidth;
+		unsigned int textureHeight = (shelfY + shelfHeight + 1 + 3) & ~3U;
+		std::vector<unsigned char> field(static_cast<size_t>(textureWidth) * textureHeight, 0);
+
+		auto body = [&](unsigned int begin, unsigned int end)
+		{
+			std::vector<OutlineSegment> segments;
+			for (unsigned int i = begin; i < end; i++)
+			{
+				const GlyphPlacement& placement = placements[i];
+				if (placement.Width == 0)
+				{
+					continue;
+				}
+
+				// To the glyph's texels: scaled, y flipped, and offset to its bounds
+				segments = placement.Outline.Segments;
+				for (OutlineSegment& segment : segments)
+				{
+					for (unsigned int point = 0; point < 3; point++)
+					{
+						segment.Points[point][0] = segment.Points[point][0] * scale - placement.Left;
+						segment.Points[point][1] = -segment.Points[point][1] * scale - placement.Top;
+					}
+				}
+
+				Rasterize(segments, placement.Width, placement.Height, settings.Spread, &field[static_cast<size_t>(placement.Y) * textureWidth + placement.X], textureWidth);
+			}
+		};
+
+		if (threadPool != nullptr)
+		{
+			threadPool->ParallelFor(0, static_cast<unsigned int>(placements.size()), body);
+		}
+		else
+		{
+			body(0, static_cast<unsigned int>(placements.size()));
+		}
+
+		// MakeSpriteFont's metrics: the pen moves by XOffset, draws the glyph, then moves by its width and XAdvance
+		float ascender = font.Ascender() * scale;
+		output.Glyphs.resize(placements.size());
+		output.DefaultCharacter = 0;
+		for (size_t i = 0; i < placements.size(); i++)
+		{
+			const GlyphPlacement& placement = placements[i];
+			Glyph& glyph = output.Glyphs[i];
+			glyph.Character = placement.Character;
+			glyph.Subrect[0] = static_cast<int>(placement.X);
+			glyph.Subrect[1] = static_cast<int>(placement.Y);
+			glyph.Subrect[2] = static_cast<int>(placement.X + placement.Width);
+			glyph.Subrect[3] = static_cast<int>(placement.Y + placement.Height);
+			glyph.XOffset = static_cast<float>(placement.Left);
+			glyph.YOffset = ascender + placement.Top;
+			glyph.XAdvance = placement.Outline.AdvanceWidth * scale - placement.Left - placement.Width;
+
+			if (placement.Character == settings.DefaultCharacter)
+			{
+				output.DefaultCharacter = placement.Character;
+			}
+		}
+
+		output.LineSpacing = (font.Ascender() - font.Descender() + font.LineGap()) * scale;
+		output.TextureWidth = textureWidth;
+		output.TextureHeight = textureHeight;
+		output.TextureFormat = settings.TextureFormat;
+		output.DistanceFieldSize = settings.Size;
+		output.DistanceFieldSpread = settings.Spread;
+
+		if (settings.TextureFormat == DDSFormatR8Unorm)
+		{
+			output.TextureStride = textureWidth;
+			output.TextureRows = textureHeight;
+			output.TextureData.swap(field);
+			return;
+		}
+
+		output.TextureStride = textureWidth / 4 * 8;
+		output.TextureRows = textureHeight / 4;
+		output.TextureData.resize(static_cast<size_t>(output.TextureStride) * output.TextureRows);
+		for (unsigned int blockY = 0; blockY < output.TextureRows; blockY++)
+		{
+			for (unsigned int blockX = 0; blockX < textureWidth / 4; blockX++)
+			{
+				unsigned char values[16];
+				for (unsigned int y = 0; y < 4; y++)
+				{
+					memcpy(&values[y * 4], &field[static_cast<size_t>(blockY * 4 + y) * textureWidth + blockX * 4], 4);
+				}
+
+				BlockCompressor::CompressBC4(values, &output.TextureData[static_cast<size_t>(blockY) * output.TextureStride + blockX * 8]);
+			}
+		}
+	}
+
+	void DistanceFieldFont::Rasterize(const std::vector<OutlineSegment>& segments, unsigned int width, unsigned int height, float spread, unsigned char* output, unsigned int rowPitch)
+	{
+		for (unsigned int y = 0; y < height; y++)
+		{
+			for (unsigned int x = 0; x < width; x++)
+			{
+				float distance = SignedDistance(segments, x + 0.5f, y + 0.5f);
+				float value = std::max(0.0f, std::min(1.0f, 0.5f + distance / (2.0f * spread)));
+				output[static_cast<size_t>(y) * rowPitch + x] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+			}
+		}
+	}
+
+	float DistanceFieldFont::SignedDistance(const std::vector<OutlineSegment>& segments, float x, float y)
+	{
+		float closest = FLT_MAX;
+		for (const OutlineSegment& segment : segments)
+		{
+			// A segment lies within its control points' bounds, so one whose bounds are farther than the closest is skipped
+			float minimumX = std::min(segment.Points[0][0], std::min(segment.Points[1][0], segment.Points[2][0]));
+			float maximumX = std::max(segment.Points[0][0], std::max(segment.Points[1][0], segment.Points[2][0]));
+			float minimumY = std::min(segment.Points[0][1], std::min(segment.Points[1][1], segment.Points[2][1]));
+			float maximumY = std::max(segment.Points[0][1], std::max(segment.Points[1][1], segment.Points[2][1]));
+			float boundsX = std::max(0.0f, std::max(minimumX - x, x - maximumX));
+			float boundsY = std::max(0.0f, std::max(minimumY - y, y - maximumY));
+			if (boundsX * boundsX + boundsY * boundsY >= closest)
+			{
+				continue;
+			}
+
+			closest = std::min(closest, SegmentDistanceSquared(segment, x, y));
+		}
+
+		float distance = sqrtf(closest);
+
+		return (Winding(segments, x, y) != 0 ? distance : -distance);
+	}
+
+	float DistanceFieldFont::SegmentDistanceSquared(const OutlineSegment& segment, float x, float y)
+	{
+		const float* start = segment.Points[0];
+		const float* control = segment.Points[1];
+		const float* end = segment.Points[2];
+
+		// B(t) - P = M + 2tA + t^2 C; the closest t zeroes (B(t) - P) . B'(t), a cubic
+		double a[2] = { control[0] - start[0], control[1] - start[1] };
+		double c[2] = { end[0] - 2.0 * control[0] + start[0], end[1] - 2.0 * control[1] + start[1] };
+		double m[2] = { start[0] - x, start[1] - y };
+
+		double candidates[5] = { 0.0, 1.0 };
+		unsigned int candidateCount = 2;
+		if (segment.IsCurve && c[0] * c[0] + c[1] * c[1] > 1e-12)
+		{
+			double cc = c[0] * c[0] + c[1] * c[1];
+			double ac = a[0] * c[0] + a[1] * c[1];
+			double aa = a[0] * a[0] + a[1] * a[1];
+			double mc = m[0] * c[0] + m[1] * c[1];
+			double ma = m[0] * a[0] + m[1] * a[1];
+			candidateCount += SolveCubic(cc, 3.0 * ac, 2.0 * aa + mc, ma, &candidates[2]);
+		}
+		else
+		{
+			double direction[2] = { end[0] - start[0], end[1] - start[1] };
+			double lengthSquared = direction[0] * direction[0] + direction[1] * direction[1];
+			if (lengthSquared > 0.0)
+			{
+				candidates[2] = -(m[0] * direction[0] + m[1] * direction[1]) / lengthSquared;
+				candidateCount = 3;
+			}
+		}
+
+		float closest = FLT_MAX;
+		for (unsigned int i = 0; i < candidateCount; i++)
+		{
+			float t = static_cast<float>(std::max(0.0, std::min(1.0, candidates[i])));
+			float point[2];
+			if (segment.IsCurve)
+			{
+				CurvePoint(segment, t, point);
+			}
+			else
+			{
+				point[0] = start[0] + (end[0] - start[0]) * t;
+				point[1] = start[1] + (end[1] - start[1]) * t;
+			}
+
+			float dx = point[0] - x;
+			float dy = point[1] - y;
+			closest = std::min(closest, dx * dx + dy * dy);
+		}
+
+		return closest;
+	}
+
+	int DistanceFieldFont::Winding(const std::vector<OutlineSegment>& segments, float x, float y)
+	{
+		// Curves are flattened for the inside test only; the distances above are to the curves themselves
+		int winding = 0;
+		for (const OutlineSegment& segment : segments)
+		{
+			float minimumY = std::min(segment.Points[0][1], std::min(segment.Points[1][1], segment.Points[2][1]));
+			float maximumY = std::max(segment.Points[0][1], std::max(segment.Points[1][1], segment.Points[2][1]));
+			float maximumX = std::max(segment.Points[0][0], std::max(segment.Points[1][0], segment.Points[2][0]));
+			if (y < minimumY || y > maximumY || x > maximumX)
+			{
+				continue;
+			}
+
+			if (segment.IsCurve == false)
+			{
+				winding += EdgeWinding(segment.Points[0], segment.Points[2], x, y);
+				continue;
+			}
+
+			float start[2] = { segment.Points[0][0], segment.Points[0][1] };
+			for (unsigned int i = 1; i <= CurveSubdivisions; i++)
+			{
+				float end[2];
+				CurvePoint(segment, static_cast<float>(i) / CurveSubdivisions, end);
+				winding += EdgeWinding(start, end, x, y);
+				memcpy(start, end, sizeof(start));
+			}
+		}
+
+		return winding;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+// Portable, like TrueTypeFont: fonts are built offline by FontTool, which runs without Windows
+#include "TrueTypeFont.h"
+#include "SpriteFontFile.h"
+
+namespace Library
+{
+	class ThreadPool;
+
+	// Size is the pixels per em the glyph metrics and atlas are built at; Spread the distance, in atlas texels, from the
+	// outline to where the field saturates. Characters the font doesn't map are left out. Format is DDSFormatR8Unorm or
+	// DDSFormatBC4Unorm.
+	typedef struct _DistanceFieldFontSettings
+	{
+		float Size;
+		float Spread;
+		unsigned int FirstCharacter;
+		unsigned int LastCharacter;
+		unsigned int DefaultCharacter;
+		unsigned int TextureWidth;
+		unsigned int TextureFormat;
+	} DistanceFieldFontSettings;
+
+	// Builds a .spritefont whose atlas holds a signed distance field rather than coverage: 0.5 on the outline, rising
+	// inside and falling outside, reaching 1 and 0 at Spread texels. Bilinear filtering of a distance field keeps edges
+	// sharp under magnification, so one small atlas serves every size; sprite.fx's distance_field technique thresholds it.
+	// Distances are exact, to lines and to the quadratic Beziers TrueType outlines are made of, and inside is decided by
+	// the non-zero winding rule, so overlapping contours are fine.
+	class DistanceFieldFont
+	{
+	public:
+		// Throws std::runtime_error for bad settings or a font with none of the characters
+		static void Generate(const TrueTypeFont& font, const DistanceFieldFontSettings& settings, SpriteFontData& output, ThreadPool* threadPool = nullptr);
+
+		// Writes width x height field values for segments already in texel units, y down, texel centers at half texels
+		static void Rasterize(const std::vector<OutlineSegment>& segments, unsigned int width, unsigned int height, float spread, unsigned char* output, unsigned int rowPitch);
+
+		// Distance from (x, y) to the outline, positive inside
+		static float SignedDistance(const std::vector<OutlineSegment>& segments, float x, float y);
+
+		static const DistanceFieldFontSettings DefaultSettings;
+
+	private:
+		DistanceFieldFont();
+		DistanceFieldFont(const DistanceFieldFont& rhs);
+		DistanceFieldFont& operator=(const DistanceFieldFont& rhs);
+
+		static float SegmentDistanceSquared(const OutlineSegment& segment, float x, float y);
+		static int Winding(const std::vector<OutlineSegment>& segments, float x, float y);
+
+		static const unsigned int CurveSubdivisions;
+	};
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "Game.h"
 #include "GameException.h"
 #include "Utility.h"
+#include "SharedEffectCache.h"
 #include "D3Dcompiler.h"
 
 namespace Library
@@ -30,35 +31,33 @@ namespace Library
 
     void Effect::CompileEffectFromFile(ID3D11Device* direct3DDevice, ID3DX11Effect** effect, const std::wstring& filename)
     {
-        UINT shaderFlags = 0;
-
-#if defined( DEBUG ) || defined( _DEBUG )
-    shaderFlags |= D3DCOMPILE_DEBUG;
-    shaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
-#endif
+        std::vector<char> compiledEffect;
+        CompileEffectFromFile(filename, nullptr, DefaultShaderFlags(), compiledEffect);
+        CreateEffectFromMemory(direct3DDevice, effect, compiledEffect);
+    }
 
+    void Effect::CompileEffectFromFile(const std::wstring& filename, const D3D_SHADER_MACRO* defines, UINT shaderFlags, std::vector<char>& compiledEffect)
+    {
         ID3D10Blob* compiledShader = nullptr;
         ID3D10Blob* errorMessages = nullptr;
-        HRESULT hr = D3DCompileFromFile(filename.c_str(), nullptr, nullptr, nullptr, "fx_5_0", shaderFlags, 0, &compiledShader, &errorMessages);
-        if (errorMessages != nullptr)
+        HRESULT hr = D3DCompileFromFile(filename.c_str(), defines, D3D_COMPILE_STANDARD_FILE_INCLUDE, nullptr, "fx_5_0", shaderFlags, 0, &compiledShader, &errorMessages);
+        if (FAILED(hr))
         {
-            GameException ex((char*)errorMessages->GetBufferPointer(), hr);
-            ReleaseObject(errorMessages);
+            if (errorMessages != nullptr)
+            {
+                GameException ex((char*)errorMessages->GetBufferPointer(), hr);
+                ReleaseObject(errorMessages);
 
-            throw ex;
-        }
+                throw ex;
+            }
 
-        if (FAILED(hr))
-        {
-            throw GameException("D3DX11CompileFromFile() failed.", hr);
+            throw GameException("D3DCompileFromFile() failed.", hr);
         }
 
-        hr = D3DX11CreateEffectFromMemory(compiledShader->GetBufferPointer(), compiledShader->GetBufferSize(), NULL, direct3DDevice, effect);
-        if (FAILED(hr))
-        {
-            throw GameException("D3DX11CreateEffectFromMemory() failed.", hr);
-        }
+        ReleaseObject(errorMessages);
 
+        const char* compiledData = reinterpret_cast<const char*>(compiledShader->GetBufferPointer());
+        compiledEffect.assign(compiledData, compiledData + compiledShader->GetBufferSize());
         ReleaseObject(compiledShader);
     }
 
@@ -67,13 +66,35 @@ namespace Library
         std::vector<char> compiledShader;
         Utility::LoadBinaryFile(filename, compiledShader);
 
-        HRESULT hr = D3DX11CreateEffectFromMemory(&compiledShader.front(), compiledShader.size(), NULL, direct3DDevice, effect);
+        CreateEffectFromMemory(direct3DDevice, effect, compiledShader);
+    }
+
+    void Effect::CreateEffectFromMemory(ID3D11Device* direct3DDevice, ID3DX11Effect** effect, const std::vector<char>& compiledEffect)
+    {
+        if (compiledEffect.empty())
+        {
+            throw GameException("Compiled effect is empty.");
+        }
+
+        HRESULT hr = D3DX11CreateEffectFromMemory(&compiledEffect.front(), compiledEffect.size(), NULL, direct3DDevice, effect);
         if (FAILED(hr))
         {
             throw GameException("D3DX11CreateEffectFromMemory() failed.", hr);
         }
     }
 
+    UINT Effect::DefaultShaderFlags()
+    {
+        UINT shaderFlags = 0;
+
+#if defined( DEBUG ) || defined( _DEBUG )
+        shaderFlags |= D3DCOMPILE_DEBUG;
+        shaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+        return shaderFlags;
+    }
+
     Game& Effect::GetGame()
     {
         return mGame;
@@ -86,23 +107,20 @@ namespace Library
 
     void Effect::SetEffect(ID3DX11Effect* effect)
     {
-        if (mEffect != nullptr)
+        if (mEffect == nullptr)
         {
-            for (Technique* technique : mTechniques)
-            {
-                delete technique;
-            }
-            mTechniques.clear();
-
-            for (Variable* variable : mVariables)
-            {
-                delete variable;
-            }
-            mVariables.clear();
+            mEffect = effect;
+            Initialize();
+        }
+        else
+        {
+            // Swap in the new effect while keeping existing Technique/Pass/Variable objects alive,
+            // so materials that cached them pick up the new effect without reinitialization.
+            ID3DX11Effect* previousEffect = mEffect;
+            mEffect = effect;
+            Rebind();
+            ReleaseObject(previousEffect);
         }
-
-        mEffect = effect;
-        Initialize();
     }
 
     const D3DX11_EFFECT_DESC& Effect::EffectDesc() const
@@ -138,8 +156,8 @@ namespace Library
 
     void Effect::LoadCompiledEffect(const std::wstring& filename)
     {
-        LoadCompiledEffect(mGame.Direct3DDevice(), &mEffect, filename);
-        Initialize();
+        // Effects loaded from the same .cso share one parsed copy
+        SetEffect(mGame.SharedEffects().CreateEffect(filename));
     }
 
     void Effect::Initialize()
@@ -164,4 +182,51 @@ namespace Library
             mVariablesByName.insert(std::pair<std::string, Variable*>(variable->Name(), variable));
         }
     }
+
+    void Effect::Rebind()
+    {
+        HRESULT hr = mEffect->GetDesc(&mEffectDesc);
+        if (FAILED(hr))
+        {
+            throw GameException("ID3DX11Effect::GetDesc() failed.", hr);
+        }
+
+        for (Technique* technique : mTechniques)
+        {
+            technique->Rebind(mGame, mEffect->GetTechniqueByName(technique->Name().c_str()));
+        }
+
+        for (UINT i = 0; i < mEffectDesc.Techniques; i++)
+        {
+            ID3DX11EffectTechnique* effectTechnique = mEffect->GetTechniqueByIndex(i);
+            D3DX11_TECHNIQUE_DESC techniqueDesc;
+            effectTechnique->GetDesc(&techniqueDesc);
+
+            if (mTechniquesByName.find(techniqueDesc.Name) == mTechniquesByName.end())
+            {
+                Technique* technique = new Technique(mGame, *this, effectTechnique);
+                mTechniques.push_back(technique);
+                mTechniquesByName.insert(std::pair<std::string, Technique*>(technique->Name(), technique));
+            }
+        }
+
+        for (Variable* variable : mVariables)
+        {
+            variable->Rebind(mEffect->GetVariableByName(variable->Name().c_str()));
+        }
+
+        for (UINT i = 0; i < mEffectDesc.GlobalVariables; i++)
+        {
+            ID3DX11EffectVariable* effectVariable = mEffect->GetVariableByIndex(i);
+            D3DX11_EFFECT_VARIABLE_DESC variableDesc;
+            effectVariable->GetDesc(&variableDesc);
+
+            if (mVariablesByName.find(variableDesc.Name) == mVariablesByName.end())
+            {
+                Variable* variable = new Variable(*this, effectVariable);
+                mVariables.push_back(variable);
+                mVariablesByName.insert(std::pair<std::string, Variable*>(variable->Name(), variable));
+            }
+        }
+    }
 }
\ No newline at end of file
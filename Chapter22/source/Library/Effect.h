@@ -15,7 +15,10 @@ namespace Library
         virtual ~Effect();
 
         static void CompileEffectFromFile(ID3D11Device* direct3DDevice, ID3DX11Effect** effect, const std::wstring& filename);
+        static void CompileEffectFromFile(const std::wstring& filename, const D3D_SHADER_MACRO* defines, UINT shaderFlags, std::vector<char>& compiledEffect);
         static void LoadCompiledEffect(ID3D11Device* direct3DDevice, ID3DX11Effect** effect, const std::wstring& filename);
+        static void CreateEffectFromMemory(ID3D11Device* direct3DDevice, ID3DX11Effect** effect, const std::vector<char>& compiledEffect);
+        static UINT DefaultShaderFlags();
 
         Game& GetGame();
         ID3DX11Effect* GetEffect() const;
@@ -34,6 +37,7 @@ namespace Library
         Effect& operator=(const Effect& rhs);
 
         void Initialize();
+        void Rebind();
 
         Game& mGame;
         ID3DX11Effect* mEffect;
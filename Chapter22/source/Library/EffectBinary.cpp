@@ -0,0 +1,467 @@
+#include "EffectBinary.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Library
+{
+	const unsigned int EffectBinary::Tag = 0xFEFF2001;
+	const unsigned int EffectBinary::NoConstantBuffer = 0xFFFFFFFF;
+
+	namespace
+	{
+		// SBinaryHeader5
+		typedef struct _Header
+		{
+			unsigned int Tag;
+			unsigned int ConstantBufferCount;
+			unsigned int NumericVariableCount;
+			unsigned int ObjectVariableCount;
+			unsigned int PoolCounts[3];
+			unsigned int TechniqueCount;
+			unsigned int UnstructuredSize;
+			unsigned int StringCount;
+			unsigned int ShaderResourceCount;
+			unsigned int DepthStencilBlockCount;
+			unsigned int BlendStateBlockCount;
+			unsigned int RasterizerStateBlockCount;
+			unsigned int SamplerCount;
+			unsigned int RenderTargetViewCount;
+			unsigned int DepthStencilViewCount;
+			unsigned int ShaderCount;
+			unsigned int InlineShaderCount;
+			unsigned int GroupCount;
+			unsigned int UnorderedAccessViewCount;
+			unsigned int InterfaceVariableCount;
+			unsigned int InterfaceVariableElementCount;
+			unsigned int ClassInstanceElementCount;
+		} Header;
+
+		// EObjectType
+		const unsigned int ObjectTypeString = 1;
+		const unsigned int ObjectTypeBlend = 2;
+		const unsigned int ObjectTypeDepthStencil = 3;
+		const unsigned int ObjectTypeRasterizer = 4;
+		const unsigned int ObjectTypePixelShader = 5;
+		const unsigned int ObjectTypeVertexShader = 6;
+		const unsigned int ObjectTypeGeometryShader = 7;
+		const unsigned int ObjectTypeGeometryShaderSO = 8;
+		const unsigned int ObjectTypeSampler = 21;
+		const unsigned int ObjectTypePixelShader5 = 25;
+		const unsigned int ObjectTypeDomainShader5 = 30;
+
+		// ECompilerAssignmentType
+		const unsigned int AssignmentInlineShader = 7;
+		const unsigned int AssignmentInlineShader5 = 8;
+
+		// Sizes of SBinaryConstantBuffer, SBinaryNumericVariable, SBinaryObjectVariable, SBinaryInterfaceVariable,
+		// SBinaryGSSOInitializer, SBinaryShaderData5, SBinaryAssignment, SBinaryType and SBinaryAnnotation
+		const size_t ConstantBufferSize = 20;
+		const size_t NumericVariableSize = 24;
+		const size_t ObjectVariableSize = 16;
+		const size_t InterfaceVariableSize = 16;
+		const size_t StreamOutShaderSize = 8;
+		const size_t Shader5Size = 36;
+		const size_t AssignmentSize = 16;
+		const size_t TypeSize = 24;
+		const size_t AnnotationSize = 8;
+
+		// Named structures are read at arbitrary offsets, so every field is copied out rather than aliased
+		inline unsigned int ReadUInt(const void* data, size_t index)
+		{
+			unsigned int value;
+			memcpy(&value, static_cast<const unsigned char*>(data) + index * sizeof(unsigned int), sizeof(value));
+
+			return value;
+		}
+	}
+
+	EffectBinary::EffectBinary(const unsigned char* data, size_t size)
+		: mData(data), mSize(size), mUnstructured(nullptr), mUnstructuredSize(0), mPosition(0),
+		  mTypes(), mConstantBuffers(), mVariables(), mShaders(), mTechniques(), mPasses(), mAnnotationCount(0)
+	{
+		Header header;
+		if (data == nullptr || size < sizeof(header))
+		{
+			throw std::runtime_error("Buffer is too small to be a compiled effect.");
+		}
+
+		memcpy(&header, data, sizeof(header));
+		if (header.Tag != Tag)
+		{
+			throw std::runtime_error("Not an fx_5_0 effect.");
+		}
+
+		if (header.PoolCounts[0] != 0 || header.PoolCounts[1] != 0 || header.PoolCounts[2] != 0)
+		{
+			throw std::runtime_error("Effect pools are not supported by Effects11.");
+		}
+
+		if (header.UnstructuredSize > size - sizeof(header) || header.InlineShaderCount > header.ShaderCount)
+		{
+			throw std::runtime_error("Compiled effect header is invalid.");
+		}
+
+		mUnstructured = data + sizeof(header);
+		mUnstructuredSize = header.UnstructuredSize;
+		mPosition = sizeof(header) + header.UnstructuredSize;
+
+		// Every count but the passes' comes from the header, so the tables are allocated once
+		unsigned int variableCount = header.NumericVariableCount + header.ObjectVariableCount + header.InterfaceVariableCount;
+		mConstantBuffers.reserve(header.ConstantBufferCount);
+		mVariables.reserve(variableCount);
+		mShaders.reserve(header.ShaderCount);
+		mTechniques.reserve(header.TechniqueCount);
+		mPasses.reserve(header.TechniqueCount);
+		mTypes.reserve(variableCount);
+
+		for (unsigned int i = 0; i < header.ConstantBufferCount; i++)
+		{
+			const void* constantBuffer = ReadStructured(ConstantBufferSize);
+
+			EffectBinaryConstantBuffer entry;
+			entry.Name = ReadString(ReadUInt(constantBuffer, 0));
+			entry.Size = ReadUInt(constantBuffer, 1);
+			entry.IsTextureBuffer = ((ReadUInt(constantBuffer, 2) & 0x1) != 0);
+			entry.FirstVariable = static_cast<unsigned int>(mVariables.size());
+			entry.VariableCount = ReadUInt(constantBuffer, 3);
+			mAnnotationCount += ReadAnnotations();
+
+			if (entry.VariableCount > header.NumericVariableCount - std::min(entry.FirstVariable, header.NumericVariableCount))
+			{
+				throw std::runtime_error("Compiled effect has more numeric variables than its header.");
+			}
+
+			for (unsigned int j = 0; j < entry.VariableCount; j++)
+			{
+				const void* numericVariable = ReadStructured(NumericVariableSize);
+
+				EffectBinaryVariable variable;
+				variable.Name = ReadString(ReadUInt(numericVariable, 0));
+				variable.Type = ReadType(ReadUInt(numericVariable, 1));
+				variable.Semantic = ReadString(ReadUInt(numericVariable, 2));
+				variable.ConstantBuffer = i;
+				variable.Offset = ReadUInt(numericVariable, 3);
+				variable.AnnotationCount = ReadAnnotations();
+
+				if (variable.Offset + mTypes[variable.Type].TotalSize > entry.Size)
+				{
+					throw std::runtime_error("Compiled effect has a variable outside its constant buffer.");
+				}
+
+				mVariables.push_back(variable);
+				mAnnotationCount += variable.AnnotationCount;
+			}
+
+			mConstantBuffers.push_back(entry);
+		}
+
+		for (unsigned int i = 0; i < header.ObjectVariableCount; i++)
+		{
+			const void* objectVariable = ReadStructured(ObjectVariableSize);
+
+			EffectBinaryVariable variable;
+			variable.Name = ReadString(ReadUInt(objectVariable, 0));
+			variable.Type = ReadType(ReadUInt(objectVariable, 1));
+			variable.Semantic = ReadString(ReadUInt(objectVariable, 2));
+			variable.ConstantBuffer = NoConstantBuffer;
+			variable.Offset = 0;
+
+			const EffectBinaryType& type = mTypes[variable.Type];
+			unsigned int elementCount = std::max(type.Elements, 1U);
+			if (type.VariableClass != EffectVariableClassObject)
+			{
+				throw std::runtime_error("Compiled effect has an object variable of a non-object type.");
+			}
+
+			// Initializers, per element, as CEffectLoader::LoadObjectVariables reads them
+			for (unsigned int element = 0; element < elementCount; element++)
+			{
+				switch (type.ObjectType)
+				{
+				case ObjectTypeBlend:
+				case ObjectTypeDepthStencil:
+				case ObjectTypeRasterizer:
+				case ObjectTypeSampler:
+					ReadAssignments(ReadStructured());
+					break;
+
+				case ObjectTypePixelShader:
+				case ObjectTypeVertexShader:
+				case ObjectTypeGeometryShader:
+					ReadShader(ReadStructured(), false);
+					break;
+
+				case ObjectTypeGeometryShaderSO:
+					ReadShader(ReadUInt(ReadStructured(StreamOutShaderSize), 0), false);
+					break;
+
+				case ObjectTypeString:
+					ReadString(ReadStructured());
+					break;
+
+				default:
+					if (type.ObjectType >= ObjectTypePixelShader5 && type.ObjectType <= ObjectTypeDomainShader5)
+					{
+						ReadShader(ReadUInt(ReadStructured(Shader5Size), 0), false);
+					}
+
+					// Textures, buffers and views have no initializers
+					break;
+				}
+			}
+
+			variable.AnnotationCount = ReadAnnotations();
+			mVariables.push_back(variable);
+			mAnnotationCount += variable.AnnotationCount;
+		}
+
+		for (unsigned int i = 0; i < header.InterfaceVariableCount; i++)
+		{
+			const void* interfaceVariable = ReadStructured(InterfaceVariableSize);
+
+			EffectBinaryVariable variable;
+			variable.Name = ReadString(ReadUInt(interfaceVariable, 0));
+			variable.Type = ReadType(ReadUInt(interfaceVariable, 1));
+			variable.Semantic = nullptr;
+			variable.ConstantBuffer = NoConstantBuffer;
+			variable.Offset = 0;
+			variable.AnnotationCount = ReadAnnotations();
+
+			mVariables.push_back(variable);
+			mAnnotationCount += variable.AnnotationCount;
+		}
+
+		for (unsigned int i = 0; i < header.GroupCount; i++)
+		{
+			const void* group = ReadStructured(2 * sizeof(unsigned int));
+			const char* groupName = ReadString(ReadUInt(group, 0));
+			unsigned int techniqueCount = ReadUInt(group, 1);
+			mAnnotationCount += ReadAnnotations();
+
+			for (unsigned int j = 0; j < techniqueCount; j++)
+			{
+				const void* technique = ReadStructured(2 * sizeof(unsigned int));
+
+				EffectBinaryTechnique entry;
+				entry.Name = ReadString(ReadUInt(technique, 0));
+				entry.Group = groupName;
+				entry.FirstPass = static_cast<unsigned int>(mPasses.size());
+				entry.PassCount = ReadUInt(technique, 1);
+				mAnnotationCount += ReadAnnotations();
+
+				for (unsigned int k = 0; k < entry.PassCount; k++)
+				{
+					const void* pass = ReadStructured(2 * sizeof(unsigned int));
+
+					EffectBinaryPass passEntry;
+					passEntry.Name = ReadString(ReadUInt(pass, 0));
+					passEntry.AssignmentCount = ReadUInt(pass, 1);
+					mAnnotationCount += ReadAnnotations();
+					ReadAssignments(passEntry.AssignmentCount);
+
+					mPasses.push_back(passEntry);
+				}
+
+				mTechniques.push_back(entry);
+			}
+		}
+
+		if (mVariables.size() != variableCount || mTechniques.size() != header.TechniqueCount || mPosition != mSize)
+		{
+			throw std::runtime_error("Compiled effect doesn't match the counts in its header.");
+		}
+
+		unsigned int inlineShaderCount = static_cast<unsigned int>(std::count_if(mShaders.begin(), mShaders.end(), [](const EffectBinaryShader& shader) { return shader.IsInline; }));
+		if (mShaders.size() != header.ShaderCount || inlineShaderCount != header.InlineShaderCount)
+		{
+			throw std::runtime_error("Compiled effect doesn't hold the shaders its header counts.");
+		}
+	}
+
+	const std::vector<EffectBinaryType>& EffectBinary::Types() const
+	{
+		return mTypes;
+	}
+
+	const std::vector<EffectBinaryConstantBuffer>& EffectBinary::ConstantBuffers() const
+	{
+		return mConstantBuffers;
+	}
+
+	const std::vector<EffectBinaryVariable>& EffectBinary::Variables() const
+	{
+		return mVariables;
+	}
+
+	const std::vector<EffectBinaryShader>& EffectBinary::Shaders() const
+	{
+		return mShaders;
+	}
+
+	const std::vector<EffectBinaryTechnique>& EffectBinary::Techniques() const
+	{
+		return mTechniques;
+	}
+
+	const std::vector<EffectBinaryPass>& EffectBinary::Passes() const
+	{
+		return mPasses;
+	}
+
+	unsigned int EffectBinary::AnnotationCount() const
+	{
+		return mAnnotationCount;
+	}
+
+	const void* EffectBinary::ReadStructured(size_t size)
+	{
+		if (size > mSize - mPosition)
+		{
+			throw std::runtime_error("Compiled effect is truncated.");
+		}
+
+		const void* data = mData + mPosition;
+		mPosition += size;
+
+		return data;
+	}
+
+	unsigned int EffectBinary::ReadStructured()
+	{
+		return ReadUInt(ReadStructured(sizeof(unsigned int)), 0);
+	}
+
+	const void* EffectBinary::ReadUnstructured(unsigned int offset, size_t size) const
+	{
+		if (offset >= mUnstructuredSize || size > mUnstructuredSize - offset)
+		{
+			throw std::runtime_error("Compiled effect has an offset outside its data.");
+		}
+
+		return mUnstructured + offset;
+	}
+
+	const char* EffectBinary::ReadString(unsigned int offset) const
+	{
+		// Offset 0 is a null name, as for the default group
+		if (offset == 0)
+		{
+			return nullptr;
+		}
+
+		const char* string = static_cast<const char*>(ReadUnstructured(offset, 1));
+		if (memchr(string, '\0', mUnstructuredSize - offset) == nullptr)
+		{
+			throw std::runtime_error("Compiled effect has an unterminated string.");
+		}
+
+		return string;
+	}
+
+	unsigned int EffectBinary::ReadType(unsigned int offset)
+	{
+		// Variables of one type share its offset; effects have a few dozen types at most, so a scan beats a map
+		for (unsigned int i = 0; i < mTypes.size(); i++)
+		{
+			if (mTypes[i].Offset == offset)
+			{
+				return i;
+			}
+		}
+
+		const void* data = ReadUnstructured(offset, TypeSize + sizeof(unsigned int));
+
+		EffectBinaryType type;
+		type.Offset = offset;
+		type.Name = ReadString(ReadUInt(data, 0));
+		type.VariableClass = static_cast<EffectVariableClass>(ReadUInt(data, 1));
+		type.Elements = ReadUInt(data, 2);
+		type.TotalSize = ReadUInt(data, 3);
+		type.Stride = ReadUInt(data, 4);
+		type.PackedSize = ReadUInt(data, 5);
+		type.ObjectType = 0;
+		type.MemberCount = 0;
+
+		switch (type.VariableClass)
+		{
+		case EffectVariableClassObject:
+			type.ObjectType = ReadUInt(data, 6);
+			break;
+
+		case EffectVariableClassStruct:
+			type.MemberCount = ReadUInt(data, 6);
+			break;
+
+		case EffectVariableClassNumeric:
+		case EffectVariableClassInterface:
+			break;
+
+		default:
+			throw std::runtime_error("Compiled effect has a type of unknown class.");
+		}
+
+		mTypes.push_back(type);
+
+		return static_cast<unsigned int>(mTypes.size() - 1);
+	}
+
+	void EffectBinary::ReadShader(unsigned int offset, bool isInline)
+	{
+		// A data block: its size, then the bytecode; a null shader (e.g. SetGeometryShader(NULL)) has size 0
+		EffectBinaryShader shader;
+		shader.Size = ReadUInt(ReadUnstructured(offset, sizeof(unsigned int)), 0);
+		shader.Bytecode = static_cast<const unsigned char*>(ReadUnstructured(offset, sizeof(unsigned int) + shader.Size)) + sizeof(unsigned int);
+		shader.IsInline = isInline;
+
+		mShaders.push_back(shader);
+	}
+
+	unsigned int EffectBinary::ReadAnnotations()
+	{
+		unsigned int count = ReadStructured();
+		for (unsigned int i = 0; i < count; i++)
+		{
+			const void* annotation = ReadStructured(AnnotationSize);
+			ReadString(ReadUInt(annotation, 0));
+			const EffectBinaryType& type = mTypes[ReadType(ReadUInt(annotation, 1))];
+
+			if (type.VariableClass == EffectVariableClassObject && type.ObjectType == ObjectTypeString)
+			{
+				for (unsigned int element = 0; element < std::max(type.Elements, 1U); element++)
+				{
+					ReadString(ReadStructured());
+				}
+			}
+			else if (type.VariableClass == EffectVariableClassNumeric || type.VariableClass == EffectVariableClassStruct)
+			{
+				ReadUnstructured(ReadStructured(), type.PackedSize);
+			}
+			else
+			{
+				throw std::runtime_error("Compiled effect has an annotation of unsupported type.");
+			}
+		}
+
+		return count;
+	}
+
+	void EffectBinary::ReadAssignments(unsigned int count)
+	{
+		const void* assignments = ReadStructured(static_cast<size_t>(count) * AssignmentSize);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			// Shaders declared inline, e.g. SetVertexShader(CompileShader(vs_5_0, vertex_shader())), are anonymous
+			unsigned int assignmentType = ReadUInt(assignments, i * 4 + 2);
+			unsigned int initializer = ReadUInt(assignments, i * 4 + 3);
+			if (assignmentType == AssignmentInlineShader)
+			{
+				ReadShader(ReadUInt(ReadUnstructured(initializer, StreamOutShaderSize), 0), true);
+			}
+			else if (assignmentType == AssignmentInlineShader5)
+			{
+				ReadShader(ReadUInt(ReadUnstructured(initializer, Shader5Size), 0), true);
+			}
+		}
+	}
+}
\ No newline at end of file
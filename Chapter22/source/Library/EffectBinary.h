@@ -0,0 +1,118 @@
+#pragma once
+
+// Portable, like DDSFile: the fx_5_0 layout is plain data, so effects can be validated without Direct3D
+#include <cstddef>
+#include <vector>
+
+namespace Library
+{
+	// EVarType and the EObjectType values the reader tells apart, from Effects11's EffectBinaryFormat.h
+	enum EffectVariableClass
+	{
+		EffectVariableClassNumeric = 1,
+		EffectVariableClassObject,
+		EffectVariableClassStruct,
+		EffectVariableClassInterface
+	};
+
+	typedef struct _EffectBinaryType
+	{
+		unsigned int Offset;
+		const char* Name;
+		EffectVariableClass VariableClass;
+		unsigned int ObjectType;
+		unsigned int Elements;
+		unsigned int TotalSize;
+		unsigned int Stride;
+		unsigned int PackedSize;
+		unsigned int MemberCount;
+	} EffectBinaryType;
+
+	typedef struct _EffectBinaryConstantBuffer
+	{
+		const char* Name;
+		unsigned int Size;
+		bool IsTextureBuffer;
+		unsigned int FirstVariable;
+		unsigned int VariableCount;
+	} EffectBinaryConstantBuffer;
+
+	typedef struct _EffectBinaryVariable
+	{
+		const char* Name;
+		const char* Semantic;
+		unsigned int Type;
+		unsigned int ConstantBuffer;
+		unsigned int Offset;
+		unsigned int AnnotationCount;
+	} EffectBinaryVariable;
+
+	typedef struct _EffectBinaryShader
+	{
+		const unsigned char* Bytecode;
+		unsigned int Size;
+		bool IsInline;
+	} EffectBinaryShader;
+
+	typedef struct _EffectBinaryPass
+	{
+		const char* Name;
+		unsigned int AssignmentCount;
+	} EffectBinaryPass;
+
+	typedef struct _EffectBinaryTechnique
+	{
+		const char* Name;
+		const char* Group;
+		unsigned int FirstPass;
+		unsigned int PassCount;
+	} EffectBinaryTechnique;
+
+	// Layout validator for compiled effects (fxc's fx_5_0 output, the .cso files). The walk follows
+	// CEffectLoader::LoadEffect and the shader counts are checked against the header, so a blob that reads here has
+	// the structure Effects11 expects; the bytecode itself is left to Direct3D. Names and bytecode point into the
+	// caller's buffer, which must outlive the EffectBinary. This is not how the game loads effects, Effects11 is, so
+	// how long a read takes here says nothing about load times.
+	class EffectBinary
+	{
+	public:
+		// Throws std::runtime_error for anything that isn't a complete fx_5_0 effect
+		EffectBinary(const unsigned char* data, size_t size);
+
+		const std::vector<EffectBinaryType>& Types() const;
+		const std::vector<EffectBinaryConstantBuffer>& ConstantBuffers() const;
+		const std::vector<EffectBinaryVariable>& Variables() const;
+		const std::vector<EffectBinaryShader>& Shaders() const;
+		const std::vector<EffectBinaryTechnique>& Techniques() const;
+		const std::vector<EffectBinaryPass>& Passes() const;
+		unsigned int AnnotationCount() const;
+
+		static const unsigned int Tag;
+		static const unsigned int NoConstantBuffer;
+
+	private:
+		EffectBinary();
+
+		const void* ReadStructured(size_t size);
+		unsigned int ReadStructured();
+		const void* ReadUnstructured(unsigned int offset, size_t size) const;
+		const char* ReadString(unsigned int offset) const;
+		unsigned int ReadType(unsigned int offset);
+		void ReadShader(unsigned int offset, bool isInline);
+		unsigned int ReadAnnotations();
+		void ReadAssignments(unsigned int count);
+
+		const unsigned char* mData;
+		size_t mSize;
+		const unsigned char* mUnstructured;
+		size_t mUnstructuredSize;
+		size_t mPosition;
+		std::vector<EffectBinaryType> mTypes;
+		std::vector<EffectBinaryConstantBuffer> mConstantBuffers;
+		std::vector<EffectBinaryVariable> mVariables;
+		std::vector<EffectBinaryShader> mShaders;
+		std::vector<EffectBinaryTechnique> mTechniques;
+		std::vector<EffectBinaryPass> mPasses;
+		unsigned int mAnnotationCount;
+	};
+}
\ No newline at end of file
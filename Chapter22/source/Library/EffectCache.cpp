@@ -0,0 +1,301 @@
+#include "EffectCache.h"
+#include "Effect.h"
+#include "Game.h"
+#include "GameException.h"
+#include "SharedEffectCache.h"
+#include "ThreadPool.h"
+#include "Utility.h"
+#include <fstream>
+#include <sstream>
+
+namespace Library
+{
+	const UINT EffectCache::DefaultShaderFlags = Effect::DefaultShaderFlags();
+	const std::string EffectCache::Target = "fx_5_0";
+
+	EffectCache::EffectCache(Game& game, ThreadPool& threadPool, const std::wstring& cacheDirectory)
+		: mGame(&game), mThreadPool(&threadPool), mCacheDirectory(cacheDirectory), mEntries(), mMutex(), mCompilesCompleted(), mPendingCompileCount(0)
+	{
+		if (mCacheDirectory.empty() == false)
+		{
+			CreateDirectory(mCacheDirectory.c_str(), nullptr);
+		}
+	}
+
+	EffectCache::~EffectCache()
+	{
+		// Outstanding compiles reference this cache
+		std::unique_lock<std::mutex> lock(mMutex);
+		while (mPendingCompileCount > 0)
+		{
+			mCompilesCompleted.wait(lock);
+		}
+	}
+
+	const std::wstring& EffectCache::CacheDirectory() const
+	{
+		return mCacheDirectory;
+	}
+
+	CompiledEffectFuture EffectCache::CompileAsync(const std::wstring& filename, const EffectDefines& defines, UINT shaderFlags, bool forceRecompile)
+	{
+		std::wstring requestKey = RequestKey(filename, defines, shaderFlags);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (forceRecompile == false)
+		{
+			auto entry = mEntries.find(requestKey);
+			if (entry != mEntries.end())
+			{
+				return entry->second;
+			}
+		}
+
+		std::shared_ptr<std::promise<std::shared_ptr<const CompiledEffect>>> promise(new std::promise<std::shared_ptr<const CompiledEffect>>());
+		CompiledEffectFuture future = promise->get_future().share();
+		mEntries[requestKey] = future;
+		mPendingCompileCount++;
+
+		mThreadPool->Enqueue([this, promise, filename, defines, shaderFlags]()
+		{
+			try
+			{
+				promise->set_value(Compile(filename, defines, shaderFlags));
+			}
+			catch (...)
+			{
+				promise->set_exception(std::current_exception());
+			}
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			mPendingCompileCount--;
+			mCompilesCompleted.notify_all();
+		});
+
+		return future;
+	}
+
+	void EffectCache::Precompile(const std::wstring& filename, const EffectDefines& defines, UINT shaderFlags)
+	{
+		CompileAsync(filename, defines, shaderFlags);
+	}
+
+	std::shared_ptr<const CompiledEffect> EffectCache::Load(Effect& effect, const std::wstring& filename, const EffectDefines& defines, UINT shaderFlags)
+	{
+		// Rethrows any exception raised during compilation
+		std::shared_ptr<const CompiledEffect> compiledEffect = CompileAsync(filename, defines, shaderFlags).get();
+
+		effect.SetEffect(CreateEffect(*compiledEffect));
+
+		return compiledEffect;
+	}
+
+	void EffectCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mEntries.clear();
+	}
+
+	ID3DX11Effect* EffectCache::CreateEffect(const CompiledEffect& compiledEffect)
+	{
+		return mGame->SharedEffects().CreateEffect(compiledEffect.Data);
+	}
+
+	void EffectCache::EvictEffect(const CompiledEffect& compiledEffect)
+	{
+		mGame->SharedEffects().Evict(compiledEffect.Data);
+	}
+
+	UINT64 EffectCache::ComputeKey(const std::wstring& filename, const EffectDefines& defines, UINT shaderFlags, std::vector<std::wstring>& dependencies)
+	{
+		UINT64 hash = Utility::Fnv1aOffsetBasis;
+
+		dependencies.clear();
+		HashIncludes(filename, dependencies, hash);
+
+		for (const std::pair<std::string, std::string>& define : defines)
+		{
+			hash = Utility::Fnv1aHash(define.first.c_str(), define.first.size() + 1, hash);
+			hash = Utility::Fnv1aHash(define.second.c_str(), define.second.size() + 1, hash);
+		}
+
+		hash = Utility::Fnv1aHash(&shaderFlags, sizeof(shaderFlags), hash);
+		hash = Utility::Fnv1aHash(Target.c_str(), Target.size(), hash);
+
+		return hash;
+	}
+
+	std::shared_ptr<const CompiledEffect> EffectCache::Compile(const std::wstring& filename, const EffectDefines& defines, UINT shaderFlags)
+	{
+		std::shared_ptr<CompiledEffect> compiledEffect(new CompiledEffect());
+
+		if (FileExists(filename) == false)
+		{
+			throw GameException("Effect file not found.");
+		}
+
+		// Precompiled effects are only read from disk
+		std::wstring extension;
+		Utility::GetPathExtension(filename, extension);
+		if (_wcsicmp(extension.c_str(), L".cso") == 0)
+		{
+			Utility::LoadBinaryFile(filename, compiledEffect->Data);
+			compiledEffect->Dependencies.push_back(filename);
+
+			return compiledEffect;
+		}
+
+		compiledEffect->Key = ComputeKey(filename, defines, shaderFlags, compiledEffect->Dependencies);
+
+		std::wstring cachedFilename;
+		if (mCacheDirectory.empty() == false)
+		{
+			cachedFilename = CachedFilename(compiledEffect->Key);
+			if (FileExists(cachedFilename))
+			{
+				Utility::LoadBinaryFile(cachedFilename, compiledEffect->Data);
+				if (compiledEffect->Data.empty() == false)
+				{
+					return compiledEffect;
+				}
+			}
+		}
+
+		std::vector<D3D_SHADER_MACRO> macros;
+		for (const std::pair<std::string, std::string>& define : defines)
+		{
+			D3D_SHADER_MACRO macro = { define.first.c_str(), define.second.c_str() };
+			macros.push_back(macro);
+		}
+
+		D3D_SHADER_MACRO terminator = { nullptr, nullptr };
+		macros.push_back(terminator);
+
+		Effect::CompileEffectFromFile(filename, &macros.front(), shaderFlags, compiledEffect->Data);
+
+		if (cachedFilename.empty() == false)
+		{
+			// Write to a per-thread temporary and move it into place so readers never see a partial file
+			std::wostringstream temporaryFilename;
+			temporaryFilename << cachedFilename << L"." << GetCurrentThreadId() << L".tmp";
+
+			std::ofstream file(temporaryFilename.str().c_str(), std::ios::binary);
+			if (file.is_open())
+			{
+				file.write(&compiledEffect->Data.front(), compiledEffect->Data.size());
+				file.close();
+
+				if (MoveFileEx(temporaryFilename.str().c_str(), cachedFilename.c_str(), MOVEFILE_REPLACE_EXISTING) == FALSE)
+				{
+					DeleteFile(temporaryFilename.str().c_str());
+				}
+			}
+		}
+
+		return compiledEffect;
+	}
+
+	std::wstring EffectCache::CachedFilename(UINT64 key) const
+	{
+		WCHAR name[32];
+		swprintf_s(name, L"%016llx.cso", key);
+
+		std::wstring cachedFilename;
+		Utility::PathJoin(cachedFilename, mCacheDirectory, name);
+
+		return cachedFilename;
+	}
+
+	std::wstring EffectCache::RequestKey(const std::wstring& filename, const EffectDefines& defines, UINT shaderFlags)
+	{
+		std::wostringstream requestKey;
+		requestKey << filename << L"|" << shaderFlags;
+
+		for (const std::pair<std::string, std::string>& define : defines)
+		{
+			requestKey << L"|" << Utility::ToWideString(define.first) << L"=" << Utility::ToWideString(define.second);
+		}
+
+		return requestKey.str();
+	}
+
+	void EffectCache::HashIncludes(const std::wstring& filename, std::vector<std::wstring>& dependencies, UINT64& hash)
+	{
+		for (const std::wstring& dependency : dependencies)
+		{
+			if (_wcsicmp(dependency.c_str(), filename.c_str()) == 0)
+			{
+				return;
+			}
+		}
+
+		if (FileExists(filename) == false)
+		{
+			// System includes and unresolved paths are left to the compiler
+			return;
+		}
+
+		dependencies.push_back(filename);
+
+		std::vector<char> source;
+		Utility::LoadBinaryFile(filename, source);
+		if (source.empty())
+		{
+			return;
+		}
+
+		hash = Utility::Fnv1aHash(&source.front(), source.size(), hash);
+
+		// D3D_COMPILE_STANDARD_FILE_INCLUDE resolves includes relative to the including file
+		std::wstring directory;
+		std::wstring::size_type lastSlashIndex = filename.find_last_of(L"\\/");
+		if (lastSlashIndex != std::wstring::npos)
+		{
+			directory = filename.substr(0, lastSlashIndex);
+		}
+
+		std::string text(source.begin(), source.end());
+		std::string::size_type position = 0;
+		while ((position = text.find("#include", position)) != std::string::npos)
+		{
+			position += 8;
+
+			std::string::size_type nameBegin = text.find_first_of("\"<\n", position);
+			if (nameBegin == std::string::npos || text[nameBegin] == '\n')
+			{
+				continue;
+			}
+
+			char closingDelimiter = (text[nameBegin] == '"' ? '"' : '>');
+			std::string::size_type nameEnd = text.find_first_of(std::string(1, closingDelimiter) + "\n", nameBegin + 1);
+			if (nameEnd == std::string::npos || text[nameEnd] == '\n')
+			{
+				continue;
+			}
+
+			std::wstring includeFilename = Utility::ToWideString(text.substr(nameBegin + 1, nameEnd - nameBegin - 1));
+
+			// The effects spell separators as escaped backslashes (e.g. "include\\Common.fxh")
+			std::wstring::size_type separatorIndex;
+			while ((separatorIndex = includeFilename.find(L"\\\\")) != std::wstring::npos)
+			{
+				includeFilename.erase(separatorIndex, 1);
+			}
+
+			if (directory.empty() == false)
+			{
+				Utility::PathJoin(includeFilename, directory, includeFilename);
+			}
+
+			HashIncludes(includeFilename, dependencies, hash);
+			position = nameEnd;
+		}
+	}
+
+	bool EffectCache::FileExists(const std::wstring& filename)
+	{
+		DWORD attributes = GetFileAttributes(filename.c_str());
+
+		return (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) == 0);
+	}
+}
\ No newline at end of file
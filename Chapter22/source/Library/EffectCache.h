@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Common.h"
+#include <mutex>
+#include <condition_variable>
+#include <future>
+
+namespace Library
+{
+	class Game;
+	class Effect;
+	class ThreadPool;
+
+	typedef std::map<std::string, std::string> EffectDefines;
+
+	typedef struct _CompiledEffect
+	{
+		UINT64 Key;
+		std::vector<char> Data;
+		std::vector<std::wstring> Dependencies;
+
+		_CompiledEffect()
+			: Key(0), Data(), Dependencies() { }
+	} CompiledEffect;
+
+	typedef std::shared_future<std::shared_ptr<const CompiledEffect>> CompiledEffectFuture;
+
+	class EffectCache
+	{
+	public:
+		EffectCache(Game& game, ThreadPool& threadPool, const std::wstring& cacheDirectory);
+		~EffectCache();
+
+		const std::wstring& CacheDirectory() const;
+
+		CompiledEffectFuture CompileAsync(const std::wstring& filename, const EffectDefines& defines = EffectDefines(), UINT shaderFlags = DefaultShaderFlags, bool forceRecompile = false);
+		void Precompile(const std::wstring& filename, const EffectDefines& defines = EffectDefines(), UINT shaderFlags = DefaultShaderFlags);
+		std::shared_ptr<const CompiledEffect> Load(Effect& effect, const std::wstring& filename, const EffectDefines& defines = EffectDefines(), UINT shaderFlags = DefaultShaderFlags);
+		void Clear();
+
+		ID3DX11Effect* CreateEffect(const CompiledEffect& compiledEffect);
+		void EvictEffect(const CompiledEffect& compiledEffect);
+
+		static UINT64 ComputeKey(const std::wstring& filename, const EffectDefines& defines, UINT shaderFlags, std::vector<std::wstring>& dependencies);
+		static const UINT DefaultShaderFlags;
+
+	private:
+		EffectCache(const EffectCache& rhs);
+		EffectCache& operator=(const EffectCache& rhs);
+
+		std::shared_ptr<const CompiledEffect> Compile(const std::wstring& filename, const EffectDefines& defines, UINT shaderFlags);
+		std::wstring CachedFilename(UINT64 key) const;
+		static std::wstring RequestKey(const std::wstring& filename, const EffectDefines& defines, UINT shaderFlags);
+		static void HashIncludes(const std::wstring& filename, std::vector<std::wstring>& dependencies, UINT64& hash);
+		static bool FileExists(const std::wstring& filename);
+
+		static const std::string Target;
+
+		Game* mGame;
+		ThreadPool* mThreadPool;
+		std::wstring mCacheDirectory;
+		std::map<std::wstring, CompiledEffectFuture> mEntries;
+		std::mutex mMutex;
+		std::condition_variable mCompilesCompleted;
+		UINT mPendingCompileCount;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "EffectWatcher.h"
+#include "Effect.h"
+#include "GameException.h"
+#include <chrono>
+
+namespace Library
+{
+	RTTI_DEFINITIONS(EffectWatcher)
+
+	const UINT EffectWatcher::DefaultPollInterval = 250;
+
+	EffectWatcher::EffectWatcher(Game& game, EffectCache& effectCache)
+		: GameComponent(game), mEffectCache(&effectCache), mWatchedEffects(), mMutex(), mShutdownRequested(), mPollThread(),
+		  mPollInterval(DefaultPollInterval), mIsShuttingDown(false)
+	{
+		mPollThread = std::thread(&EffectWatcher::PollThread, this);
+	}
+
+	EffectWatcher::~EffectWatcher()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mIsShuttingDown = true;
+		}
+
+		mShutdownRequested.notify_all();
+		mPollThread.join();
+	}
+
+	UINT EffectWatcher::PollInterval() const
+	{
+		return mPollInterval;
+	}
+
+	void EffectWatcher::SetPollInterval(UINT pollInterval)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mPollInterval = pollInterval;
+	}
+
+	void EffectWatcher::Watch(Effect& effect, const std::wstring& filename, const std::shared_ptr<const CompiledEffect>& compiledEffect, const EffectDefines& defines, UINT shaderFlags)
+	{
+		WatchedEffect watchedEffect;
+		watchedEffect.Target = &effect;
+		watchedEffect.Filename = filename;
+		watchedEffect.Defines = defines;
+		watchedEffect.ShaderFlags = shaderFlags;
+		watchedEffect.Dependencies = compiledEffect->Dependencies;
+		watchedEffect.CurrentEffect = compiledEffect;
+		UpdateWriteTimes(watchedEffect);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		mWatchedEffects.push_back(watchedEffect);
+	}
+
+	void EffectWatcher::Unwatch(Effect& effect)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (auto it = mWatchedEffects.begin(); it != mWatchedEffects.end();)
+		{
+			if (it->Target == &effect)
+			{
+				it = mWatchedEffects.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	void EffectWatcher::Update(const GameTime& gameTime)
+	{
+		// Completed compiles are swapped in here, between frames, so no draw ever sees a partially rebound effect
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (WatchedEffect& watchedEffect : mWatchedEffects)
+		{
+			if (watchedEffect.PendingCompile.valid() == false || watchedEffect.PendingCompile.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				continue;
+			}
+
+			try
+			{
+				std::shared_ptr<const CompiledEffect> compiledEffect = watchedEffect.PendingCompile.get();
+				watchedEffect.Target->SetEffect(mEffectCache->CreateEffect(*compiledEffect));
+
+				// SharedEffectCache would otherwise keep every replaced blob, and its parsed effect, until shutdown
+				if (watchedEffect.CurrentEffect->Data != compiledEffect->Data)
+				{
+					mEffectCache->EvictEffect(*watchedEffect.CurrentEffect);
+				}
+
+				watchedEffect.CurrentEffect = compiledEffect;
+
+				// Include lists may have changed with the edit
+				watchedEffect.Dependencies = compiledEffect->Dependencies;
+				UpdateWriteTimes(watchedEffect);
+			}
+			catch (std::exception& ex)
+			{
+				// Keep the previous effect; the next save retries
+				OutputDebugStringA(ex.what());
+				OutputDebugStringA("\n");
+			}
+
+			watchedEffect.PendingCompile = CompiledEffectFuture();
+		}
+	}
+
+	void EffectWatcher::PollThread()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		while (mIsShuttingDown == false)
+		{
+			mShutdownRequested.wait_for(lock, std::chrono::milliseconds(mPollInterval));
+			if (mIsShuttingDown)
+			{
+				break;
+			}
+
+			for (WatchedEffect& watchedEffect : mWatchedEffects)
+			{
+				if (watchedEffect.PendingCompile.valid())
+				{
+					continue;
+				}
+
+				bool isModified = false;
+				for (size_t i = 0; i < watchedEffect.Dependencies.size(); i++)
+				{
+					if (LastWriteTime(watchedEffect.Dependencies[i]) != watchedEffect.WriteTimes[i])
+					{
+						isModified = true;
+						break;
+					}
+				}
+
+				if (isModified)
+				{
+					UpdateWriteTimes(watchedEffect);
+					watchedEffect.PendingCompile = mEffectCache->CompileAsync(watchedEffect.Filename, watchedEffect.Defines, watchedEffect.ShaderFlags, true);
+				}
+			}
+		}
+	}
+
+	void EffectWatcher::UpdateWriteTimes(WatchedEffect& watchedEffect)
+	{
+		watchedEffect.WriteTimes.resize(watchedEffect.Dependencies.size());
+		for (size_t i = 0; i < watchedEffect.Dependencies.size(); i++)
+		{
+			watchedEffect.WriteTimes[i] = LastWriteTime(watchedEffect.Dependencies[i]);
+		}
+	}
+
+	UINT64 EffectWatcher::LastWriteTime(const std::wstring& filename)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (GetFileAttributesEx(filename.c_str(), GetFileExInfoStandard, &attributes) == FALSE)
+		{
+			return 0;
+		}
+
+		return (static_cast<UINT64>(attributes.ftLastWriteTime.dwHighDateTime) << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "GameComponent.h"
+#include "EffectCache.h"
+#include <thread>
+
+namespace Library
+{
+	class Effect;
+
+	class EffectWatcher : public GameComponent
+	{
+		RTTI_DECLARATIONS(EffectWatcher, GameComponent)
+
+	public:
+		EffectWatcher(Game& game, EffectCache& effectCache);
+		~EffectWatcher();
+
+		UINT PollInterval() const;
+		void SetPollInterval(UINT pollInterval);
+
+		// compiledEffect is what the effect was loaded from, as EffectCache::Load() returns it
+		void Watch(Effect& effect, const std::wstring& filename, const std::shared_ptr<const CompiledEffect>& compiledEffect, const EffectDefines& defines = EffectDefines(),
+			UINT shaderFlags = EffectCache::DefaultShaderFlags);
+		void Unwatch(Effect& effect);
+
+		virtual void Update(const GameTime& gameTime) override;
+
+		static const UINT DefaultPollInterval;
+
+	private:
+		typedef struct _WatchedEffect
+		{
+			Effect* Target;
+			std::wstring Filename;
+			EffectDefines Defines;
+			UINT ShaderFlags;
+			std::vector<std::wstring> Dependencies;
+			std::vector<UINT64> WriteTimes;
+			std::shared_ptr<const CompiledEffect> CurrentEffect;
+			CompiledEffectFuture PendingCompile;
+		} WatchedEffect;
+
+		EffectWatcher();
+		EffectWatcher(const EffectWatcher& rhs);
+		EffectWatcher& operator=(const EffectWatcher& rhs);
+
+		void PollThread();
+		static void UpdateWriteTimes(WatchedEffect& watchedEffect);
+		static UINT64 LastWriteTime(const std::wstring& filename);
+
+		EffectCache* mEffectCache;
+		std::vector<WatchedEffect> mWatchedEffects;
+		std::mutex mMutex;
+		std::condition_variable mShutdownRequested;
+		std::thread mPollThread;
+		UINT mPollInterval;
+		bool mIsShuttingDown;
+	};
+}
\ No newline at end of file
@@ -1,30 +1,28 @@
 #include "FpsComponent.h"
-#include <sstream>
-#include <iomanip>
-#include <SpriteBatch.h>
-#include <SpriteFont.h>
 #include "Game.h"
-#include "Utility.h"
+#include "TextComponent.h"
+#include "FrameAllocator.h"
+#include "AllocationCounter.h"
 
 namespace Library
 {
     RTTI_DEFINITIONS(FpsComponent)
 
     FpsComponent::FpsComponent(Game& game)
-        : DrawableGameComponent(game), mSpriteBatch(nullptr), mSpriteFont(nullptr), mTextPosition(0.0f, 20.0f),
+        : DrawableGameComponent(game), mText(new TextComponent(game)),
           mFrameCount(0), mFrameRate(0), mLastTotalElapsedTime(0.0)
     {
+        mText->Position() = XMFLOAT2(0.0f, 20.0f);
     }
     
     FpsComponent::~FpsComponent()
     {
-        DeleteObject(mSpriteFont);
-        DeleteObject(mSpriteBatch);
+        DeleteObject(mText);
     }
 
     XMFLOAT2& FpsComponent::TextPosition()
     {
-        return mTextPosition;
+        return mText->Position();
     }
 
     int FpsComponent::FrameRate() const
@@ -34,10 +32,7 @@ namespace Library
 
     void FpsComponent::Initialize()
     {       
-        SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
-
-        mSpriteBatch = new SpriteBatch(mGame->Direct3DDeviceContext());
-        mSpriteFont = new SpriteFont(mGame->Direct3DDevice(), L"Content\\Fonts\\Arial_14_Regular.spritefont");
+        mText->Initialize();
     }
 
     void FpsComponent::Update(const GameTime& gameTime)
@@ -47,6 +42,12 @@ namespace Library
             mLastTotalElapsedTime = gameTime.TotalGameTime();
             mFrameRate = mFrameCount;
             mFrameCount = 0;
+
+            UpdateLabel(gameTime);
+        }
+        else if (mText->Text().empty())
+        {
+            UpdateLabel(gameTime);
         }
 
         mFrameCount++;
@@ -54,12 +55,23 @@ namespace Library
 
     void FpsComponent::Draw(const GameTime& gameTime)
     {
-        mSpriteBatch->Begin();
-            
-        std::wostringstream fpsLabel;
-        fpsLabel << std::setprecision(4) << L"Frame Rate: " << mFrameRate << "    Total Elapsed Time: " << gameTime.TotalGameTime();
-        mSpriteFont->DrawString(mSpriteBatch, fpsLabel.str().c_str(), mTextPosition);
+        mText->Draw(gameTime);
+    }
+
+    void FpsComponent::UpdateLabel(const GameTime& gameTime)
+    {
+        // Refreshed with the frame rate, once a second, so the label is laid out once a second rather than every frame
+        FrameAllocator& frameMemory = mGame->FrameMemory();
+        const wchar_t* fpsLabel;
+        if (AllocationCounter::IsEnabled())
+        {
+            fpsLabel = frameMemory.Format(L"Frame Rate: %d    Total Elapsed Time: %.4g    Frame Allocations: %llu", mFrameRate, gameTime.TotalGameTime(), mGame->FrameAllocationCount());
+        }
+        else
+        {
+            fpsLabel = frameMemory.Format(L"Frame Rate: %d    Total Elapsed Time: %.4g", mFrameRate, gameTime.TotalGameTime());
+        }
 
-        mSpriteBatch->End();
+        mText->SetText(fpsLabel);
     }
 }
\ No newline at end of file
@@ -2,14 +2,10 @@
 
 #include "DrawableGameComponent.h"
 
-namespace DirectX
-{
-    class SpriteBatch;
-    class SpriteFont;
-}
-
 namespace Library
 {
+    class TextComponent;
+
     class FpsComponent : public DrawableGameComponent
     {
         RTTI_DECLARATIONS(FpsComponent, DrawableGameComponent)
@@ -29,10 +25,10 @@ namespace Library
         FpsComponent();
         FpsComponent(const FpsComponent& rhs);
         FpsComponent& operator=(const FpsComponent& rhs);
-        
-        SpriteBatch* mSpriteBatch;
-        SpriteFont* mSpriteFont;
-        XMFLOAT2 mTextPosition;
+
+        void UpdateLabel(const GameTime& gameTime);
+
+        TextComponent* mText;
 
         int mFrameCount;
         int mFrameRate;
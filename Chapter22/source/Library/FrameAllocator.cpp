@@ -0,0 +1,190 @@
+#include "FrameAllocator.h"
+#include <cstdarg>
+#include <cstdlib>
+#include <cwchar>
+#include <cassert>
+#include <algorithm>
+#include <new>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace Library
+{
+	namespace
+	{
+		unsigned char* AlignedAllocate(size_t size, size_t alignment)
+		{
+#if defined(_WIN32)
+			return static_cast<unsigned char*>(_aligned_malloc(size, alignment));
+#else
+			void* memory = nullptr;
+			return static_cast<unsigned char*>(posix_memalign(&memory, alignment, size) == 0 ? memory : nullptr);
+#endif
+		}
+
+		void AlignedFree(unsigned char* memory)
+		{
+#if defined(_WIN32)
+			_aligned_free(memory);
+#else
+			free(memory);
+#endif
+		}
+
+		int FormattedLength(const wchar_t* format, va_list arguments)
+		{
+#if defined(_WIN32)
+			return _vscwprintf(format, arguments);
+#else
+			// vswprintf() can't count without writing, so it writes to a scratch buffer that grows until the text fits;
+			// past MaximumLength the format is taken to be invalid, which vswprintf() reports the same way
+			static const size_t MaximumLength = 1024 * 1024;
+			static thread_local std::vector<wchar_t> scratch(256);
+			for (;;)
+			{
+				va_list copy;
+				va_copy(copy, arguments);
+				int length = vswprintf(&scratch[0], scratch.size(), format, copy);
+				va_end(copy);
+
+				if (length >= 0 || scratch.size() >= MaximumLength)
+				{
+					return length;
+				}
+
+				scratch.resize(scratch.size() * 2);
+			}
+#endif
+		}
+	}
+
+	const size_t FrameAllocator::DefaultCapacity = 256 * 1024;
+	const size_t FrameAllocator::DefaultAlignment = 16;
+
+	FrameAllocator::FrameAllocator(size_t capacity)
+		: mBuffer(nullptr), mCapacity(capacity), mOffset(0), mPeakUsedBytes(0), mOverflowBlocks(), mOverflowBytes(0), mOverflowCount(0)
+	{
+		mBuffer = AlignedAllocate(mCapacity, DefaultAlignment);
+		if (mBuffer == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+	}
+
+	FrameAllocator::~FrameAllocator()
+	{
+		ReleaseOverflowBlocks();
+		AlignedFree(mBuffer);
+	}
+
+	void* FrameAllocator::Allocate(size_t size, size_t alignment)
+	{
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+		size_t alignedOffset = (mOffset + alignment - 1) & ~(alignment - 1);
+		if (alignedOffset + size <= mCapacity)
+		{
+			mOffset = alignedOffset + size;
+			mPeakUsedBytes = std::max(mPeakUsedBytes, mOffset + mOverflowBytes);
+
+			return mBuffer + alignedOffset;
+		}
+
+		// Out of space: satisfy the request from the heap and grow the arena at the next Reset()
+		unsigned char* block = AlignedAllocate(std::max(size, static_cast<size_t>(1)), std::max(alignment, DefaultAlignment));
+		if (block == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		mOverflowBlocks.push_back(block);
+		mOverflowBytes += size;
+		mOverflowCount++;
+		mPeakUsedBytes = std::max(mPeakUsedBytes, mOffset + mOverflowBytes);
+
+		return block;
+	}
+
+	const wchar_t* FrameAllocator::Format(const wchar_t* format, ...)
+	{
+		va_list arguments;
+		va_start(arguments, format);
+		int length = FormattedLength(format, arguments);
+		va_end(arguments);
+
+		if (length < 0)
+		{
+			return L"";
+		}
+
+		wchar_t* text = Allocate<wchar_t>(length + 1);
+
+		va_start(arguments, format);
+#if defined(_WIN32)
+		vswprintf_s(text, length + 1, format, arguments);
+#else
+		vswprintf(text, length + 1, format, arguments);
+#endif
+		va_end(arguments);
+
+		return text;
+	}
+
+	void FrameAllocator::Reset()
+	{
+		if (mOverflowBlocks.size() > 0)
+		{
+			size_t capacity = mCapacity;
+			while (capacity < mPeakUsedBytes)
+			{
+				capacity *= 2;
+			}
+
+			ReleaseOverflowBlocks();
+
+			unsigned char* buffer = AlignedAllocate(capacity, DefaultAlignment);
+			if (buffer == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+
+			AlignedFree(mBuffer);
+			mBuffer = buffer;
+			mCapacity = capacity;
+		}
+
+		mOffset = 0;
+	}
+
+	size_t FrameAllocator::Capacity() const
+	{
+		return mCapacity;
+	}
+
+	size_t FrameAllocator::UsedBytes() const
+	{
+		return mOffset + mOverflowBytes;
+	}
+
+	size_t FrameAllocator::PeakUsedBytes() const
+	{
+		return mPeakUsedBytes;
+	}
+
+	unsigned int FrameAllocator::OverflowCount() const
+	{
+		return mOverflowCount;
+	}
+
+	void FrameAllocator::ReleaseOverflowBlocks()
+	{
+		for (unsigned char* block : mOverflowBlocks)
+		{
+			AlignedFree(block);
+		}
+
+		mOverflowBlocks.clear();
+		mOverflowBytes = 0;
+	}
+}
\ No newline at end of file
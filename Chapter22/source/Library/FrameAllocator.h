@@ -0,0 +1,52 @@
+#pragma once
+
+// Portable, like ObjectPool: AllocationBenchmark checks the per-frame paths that use it without a device
+#include <cstddef>
+#include <vector>
+
+namespace Library
+{
+	// Linear arena for memory that lives until the end of the frame. Reset() rewinds it at frame start.
+	// Not thread-safe; intended for the render thread.
+	class FrameAllocator
+	{
+	public:
+		FrameAllocator(size_t capacity = DefaultCapacity);
+		~FrameAllocator();
+
+		void* Allocate(size_t size, size_t alignment = DefaultAlignment);
+
+		template <typename T>
+		T* Allocate(size_t count)
+		{
+			return static_cast<T*>(Allocate(sizeof(T) * count, __alignof(T)));
+		}
+
+		// Formats into arena memory; the returned string is valid until the next Reset()
+		const wchar_t* Format(const wchar_t* format, ...);
+
+		void Reset();
+
+		size_t Capacity() const;
+		size_t UsedBytes() const;
+		size_t PeakUsedBytes() const;
+		unsigned int OverflowCount() const;
+
+		static const size_t DefaultCapacity;
+		static const size_t DefaultAlignment;
+
+	private:
+		FrameAllocator(const FrameAllocator& rhs);
+		FrameAllocator& operator=(const FrameAllocator& rhs);
+
+		void ReleaseOverflowBlocks();
+
+		unsigned char* mBuffer;
+		size_t mCapacity;
+		size_t mOffset;
+		size_t mPeakUsedBytes;
+		std::vector<unsigned char*> mOverflowBlocks;
+		size_t mOverflowBytes;
+		unsigned int mOverflowCount;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include "FrameCapture.h"
+#include "FrameEncoder.h"
+#include "Game.h"
+#include "GameException.h"
+#include <stdexcept>
+
+namespace Library
+{
+	RTTI_DEFINITIONS(FrameCapture)
+
+	const UINT FrameCapture::DefaultRingSize = 3;
+
+	FrameCapture::FrameCapture(Game& game, UINT ringSize)
+		: GameComponent(game), mEncoder(nullptr), mSlots(max(ringSize, 1U)), mResolveTexture(nullptr), mTextureDesc(), mPixels(),
+		  mNextSlot(0), mPendingCount(0), mCapturedCount(0), mStallCount(0)
+	{
+		mEncoder = new FrameEncoder(game.WorkerThreads());
+
+		for (ReadbackSlot& slot : mSlots)
+		{
+			slot.Texture = nullptr;
+			slot.IsPending = false;
+		}
+
+		ZeroMemory(&mTextureDesc, sizeof(mTextureDesc));
+	}
+
+	FrameCapture::~FrameCapture()
+	{
+		ReleaseTextures();
+		DeleteObject(mEncoder);
+	}
+
+	void FrameCapture::Capture(ID3D11Texture2D* texture, const std::string& filename)
+	{
+		assert(texture != nullptr);
+
+		D3D11_TEXTURE2D_DESC textureDesc;
+		texture->GetDesc(&textureDesc);
+		if (FrameEncoder::IsSupportedFormat(textureDesc.Format) == false || textureDesc.ArraySize != 1)
+		{
+			throw GameException("FrameCapture::Capture() needs a 2D texture of 8-bit RGBA or BGRA.");
+		}
+
+		// A new size or format, after a resize say, needs new staging textures; frames still in flight are read first
+		if (mSlots[0].Texture == nullptr || textureDesc.Width != mTextureDesc.Width || textureDesc.Height != mTextureDesc.Height ||
+			textureDesc.Format != mTextureDesc.Format || textureDesc.SampleDesc.Count != mTextureDesc.SampleDesc.Count)
+		{
+			while (mPendingCount > 0)
+			{
+				Retire(OldestSlot(), true);
+			}
+
+			CreateTextures(textureDesc);
+		}
+
+		// With every slot in flight, the one to reuse is the oldest, and there's nothing to do but wait for it
+		ReadbackSlot& slot = mSlots[mNextSlot];
+		if (slot.IsPending)
+		{
+			mStallCount++;
+			Retire(slot, true);
+		}
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		if (textureDesc.SampleDesc.Count > 1)
+		{
+			direct3DDeviceContext->ResolveSubresource(mResolveTexture, 0, texture, 0, textureDesc.Format);
+			direct3DDeviceContext->CopyResource(slot.Texture, mResolveTexture);
+		}
+		else
+		{
+			direct3DDeviceContext->CopyResource(slot.Texture, texture);
+		}
+
+		slot.Filename = filename;
+		slot.IsPending = true;
+		mNextSlot = (mNextSlot + 1) % RingSize();
+		mPendingCount++;
+		mCapturedCount++;
+	}
+
+	void FrameCapture::CaptureBackBuffer(const std::string& filename)
+	{
+		ID3D11Resource* resource = nullptr;
+		mGame->RenderTargetView()->GetResource(&resource);
+
+		ID3D11Texture2D* texture = nullptr;
+		HRESULT hr = resource->QueryInterface(__uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&texture));
+		ReleaseObject(resource);
+		if (FAILED(hr))
+		{
+			throw GameException("ID3D11Resource::QueryInterface() failed.", hr);
+		}
+
+		try
+		{
+			Capture(texture, filename);
+		}
+		catch (...)
+		{
+			ReleaseObject(texture);
+			throw;
+		}
+
+		ReleaseObject(texture);
+	}
+
+	void FrameCapture::Update(const GameTime& gameTime)
+	{
+		// Slots finish in the order they were queued, so stop at the first still being copied
+		while (mPendingCount > 0 && Retire(OldestSlot(), false))
+		{
+		}
+	}
+
+	void FrameCapture::Flush()
+	{
+		while (mPendingCount > 0)
+		{
+			Retire(OldestSlot(), true);
+		}
+
+		mEncoder->Wait();
+	}
+
+	UINT FrameCapture::RingSize() const
+	{
+		return static_cast<UINT>(mSlots.size());
+	}
+
+	UINT FrameCapture::PendingCount() const
+	{
+		return mPendingCount;
+	}
+
+	UINT FrameCapture::CapturedCount() const
+	{
+		return mCapturedCount;
+	}
+
+	UINT FrameCapture::StallCount() const
+	{
+		return mStallCount;
+	}
+
+	const FrameEncoder& FrameCapture::Encoder() const
+	{
+		return *mEncoder;
+	}
+
+	FrameCapture::ReadbackSlot& FrameCapture::OldestSlot()
+	{
+		return mSlots[(mNextSlot + RingSize() - mPendingCount) % RingSize()];
+	}
+
+	bool FrameCapture::Retire(ReadbackSlot& slot, bool isWaiting)
+	{
+		assert(slot.IsPending);
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		D3D11_MAPPED_SUBRESOURCE mappedResource;
+		HRESULT hr = direct3DDeviceContext->Map(slot.Texture, 0, D3D11_MAP_READ, (isWaiting ? 0 : D3D11_MAP_FLAG_DO_NOT_WAIT), &mappedResource);
+		if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+		{
+			return false;
+		}
+		else if (FAILED(hr))
+		{
+			throw GameException("ID3D11DeviceContext::Map() failed.", hr);
+		}
+
+		// Staging rows are padded; frames are handed over tightly packed
+		UINT rowSize = mTextureDesc.Width * 4;
+		mPixels.resize(static_cast<size_t>(rowSize) * mTextureDesc.Height);
+		for (UINT y = 0; y < mTextureDesc.Height; y++)
+		{
+			memcpy(&mPixels[static_cast<size_t>(y) * rowSize], static_cast<const unsigned char*>(mappedResource.pData) + static_cast<size_t>(y) * mappedResource.RowPitch, rowSize);
+		}
+
+		direct3DDeviceContext->Unmap(slot.Texture, 0);
+		slot.IsPending = false;
+		mPendingCount--;
+
+		try
+		{
+			mEncoder->Encode(slot.Filename, mTextureDesc.Width, mTextureDesc.Height, mTextureDesc.Format, mPixels);
+		}
+		catch (std::runtime_error& ex)
+		{
+			const char* message = ex.what();
+			throw GameException(message);
+		}
+
+		return true;
+	}
+
+	void FrameCapture::CreateTextures(const D3D11_TEXTURE2D_DESC& textureDesc)
+	{
+		ReleaseTextures();
+
+		D3D11_TEXTURE2D_DESC stagingDesc;
+		ZeroMemory(&stagingDesc, sizeof(stagingDesc));
+		stagingDesc.Width = textureDesc.Width;
+		stagingDesc.Height = textureDesc.Height;
+		stagingDesc.MipLevels = 1;
+		stagingDesc.ArraySize = 1;
+		stagingDesc.Format = textureDesc.Format;
+		stagingDesc.SampleDesc.Count = 1;
+		stagingDesc.Usage = D3D11_USAGE_STAGING;
+		stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+		HRESULT hr;
+		for (ReadbackSlot& slot : mSlots)
+		{
+			if (FAILED(hr = mGame->Direct3DDevice()->CreateTexture2D(&stagingDesc, nullptr, &slot.Texture)))
+			{
+				ReleaseTextures();
+				throw GameException("ID3D11Device::CreateTexture2D() failed.", hr);
+			}
+		}
+
+		if (textureDesc.SampleDesc.Count > 1)
+		{
+			D3D11_TEXTURE2D_DESC resolveDesc = stagingDesc;
+			resolveDesc.Usage = D3D11_USAGE_DEFAULT;
+			resolveDesc.CPUAccessFlags = 0;
+
+			if (FAILED(hr = mGame->Direct3DDevice()->CreateTexture2D(&resolveDesc, nullptr, &mResolveTexture)))
+			{
+				ReleaseTextures();
+				throw GameException("ID3D11Device::CreateTexture2D() failed.", hr);
+			}
+		}
+
+		mTextureDesc = textureDesc;
+		mNextSlot = 0;
+	}
+
+	void FrameCapture::ReleaseTextures()
+	{
+		for (ReadbackSlot& slot : mSlots)
+		{
+			ReleaseObject(slot.Texture);
+			slot.IsPending = false;
+		}
+
+		ReleaseObject(mResolveTexture);
+		mPendingCount = 0;
+	}
+}
\ No newline at end of file
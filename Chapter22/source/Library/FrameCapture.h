@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Common.h"
+#include "GameComponent.h"
+
+namespace Library
+{
+	class FrameEncoder;
+
+	// Reads frames back without stalling the pipeline. DirectXTK's ScreenGrab maps its staging texture straight after the
+	// copy, so the CPU waits for the GPU to finish the frame, and the GPU then idles for the next. Capture() only queues
+	// the copy, into the next of a ring of staging textures; Update() maps those whose copies are done, a frame or two
+	// later, and hands the pixels to a FrameEncoder on the worker threads. Capture() blocks only when every staging
+	// texture is still in flight, which StallCount() counts, or when the encoders fall behind (Encoder().StallCount()).
+	//
+	// Add it to the components so Game::Update() retires copies every frame, and Flush() before shutting down, or the
+	// last ringSize frames are lost.
+	class FrameCapture : public GameComponent
+	{
+		RTTI_DECLARATIONS(FrameCapture, GameComponent)
+
+	public:
+		FrameCapture(Game& game, UINT ringSize = DefaultRingSize);
+		~FrameCapture();
+
+		// 8-bit RGBA or BGRA textures, multisampled or not, written as .png or .dds by the filename's extension
+		void Capture(ID3D11Texture2D* texture, const std::string& filename);
+		void CaptureBackBuffer(const std::string& filename);
+
+		virtual void Update(const GameTime& gameTime) override;
+
+		// Blocks until every queued frame has been read back and written
+		void Flush();
+
+		UINT RingSize() const;
+		UINT PendingCount() const;
+		UINT CapturedCount() const;
+		UINT StallCount() const;
+		const FrameEncoder& Encoder() const;
+
+		static const UINT DefaultRingSize;
+
+	private:
+		typedef struct _ReadbackSlot
+		{
+			ID3D11Texture2D* Texture;
+			std::string Filename;
+			bool IsPending;
+		} ReadbackSlot;
+
+		FrameCapture();
+		FrameCapture(const FrameCapture& rhs);
+		FrameCapture& operator=(const FrameCapture& rhs);
+
+		ReadbackSlot& OldestSlot();
+		bool Retire(ReadbackSlot& slot, bool isWaiting);
+		void CreateTextures(const D3D11_TEXTURE2D_DESC& textureDesc);
+		void ReleaseTextures();
+
+		FrameEncoder* mEncoder;
+		std::vector<ReadbackSlot> mSlots;
+		ID3D11Texture2D* mResolveTexture;
+		D3D11_TEXTURE2D_DESC mTextureDesc;
+		std::vector<unsigned char> mPixels;
+		UINT mNextSlot;
+		UINT mPendingCount;
+		UINT mCapturedCount;
+		UINT mStallCount;
+	};
+}
\ No newline at end of file
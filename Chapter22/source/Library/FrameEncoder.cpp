@@ -0,0 +1,182 @@
+#include "FrameEncoder.h"
+#include "ThreadPool.h"
+#include "PNGWriter.h"
+#include "DDSWriter.h"
+#include "DDSFile.h"
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+namespace Library
+{
+	namespace
+	{
+		bool HasExtension(const std::string& filename, const char* extension)
+		{
+			size_t length = strlen(extension);
+			if (filename.size() < length)
+			{
+				return false;
+			}
+
+			for (size_t i = 0; i < length; i++)
+			{
+				if (tolower(static_cast<unsigned char>(filename[filename.size() - length + i])) != extension[i])
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	}
+
+	const unsigned int FrameEncoder::DefaultMaximumPendingCount = 8;
+
+	FrameEncoder::FrameEncoder(ThreadPool& threadPool, unsigned int maximumPendingCount)
+		: mThreadPool(&threadPool), mMaximumPendingCount(maximumPendingCount > 0 ? maximumPendingCount : 1), mFrames(mMaximumPendingCount),
+		  mPendingCount(0), mEncodedCount(0), mFailedCount(0), mStallCount(0), mLastError(), mMutex(), mFrameEncoded()
+	{
+	}
+
+	FrameEncoder::~FrameEncoder()
+	{
+		Wait();
+	}
+
+	void FrameEncoder::Encode(const std::string& filename, unsigned int width, unsigned int height, unsigned int format, std::vector<unsigned char>& pixels)
+	{
+		if (IsSupportedFormat(format) == false)
+		{
+			throw std::runtime_error("Frames must be 8-bit RGBA or BGRA.");
+		}
+
+		if (width == 0 || height == 0 || pixels.size() != static_cast<size_t>(width) * height * 4)
+		{
+			throw std::runtime_error("Frame size does not match its pixels.");
+		}
+
+		if (HasExtension(filename, ".png") == false && HasExtension(filename, ".dds") == false)
+		{
+			throw std::runtime_error("Frames are written as .png or .dds files.");
+		}
+
+		Frame* frame;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			if (mPendingCount >= mMaximumPendingCount)
+			{
+				mStallCount++;
+				mFrameEncoded.wait(lock, [&]() { return mPendingCount < mMaximumPendingCount; });
+			}
+
+			// Never more than the pool's capacity, so it doesn't grow
+			mPendingCount++;
+			frame = mFrames.Acquire();
+		}
+
+		frame->Filename = filename;
+		frame->Width = width;
+		frame->Height = height;
+		frame->Format = format;
+
+		// The caller keeps the frame's previous buffer, sized for the next frame
+		frame->Pixels.swap(pixels);
+		pixels.resize(frame->Pixels.size());
+
+		mThreadPool->Enqueue([this, frame]()
+		{
+			EncodeFrame(*frame);
+		});
+	}
+
+	void FrameEncoder::Wait()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mFrameEncoded.wait(lock, [&]() { return mPendingCount == 0; });
+	}
+
+	unsigned int FrameEncoder::MaximumPendingCount() const
+	{
+		return mMaximumPendingCount;
+	}
+
+	unsigned int FrameEncoder::PendingCount() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mPendingCount;
+	}
+
+	unsigned int FrameEncoder::EncodedCount() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mEncodedCount;
+	}
+
+	unsigned int FrameEncoder::FailedCount() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mFailedCount;
+	}
+
+	unsigned int FrameEncoder::StallCount() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mStallCount;
+	}
+
+	std::string FrameEncoder::LastError() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mLastError;
+	}
+
+	bool FrameEncoder::IsSupportedFormat(unsigned int format)
+	{
+		return (format == DDSFormatR8G8B8A8Unorm || format == DDSFormatR8G8B8A8UnormSrgb || format == DDSFormatB8G8R8A8Unorm || format == DDSFormatB8G8R8A8UnormSrgb);
+	}
+
+	void FrameEncoder::EncodeFrame(Frame& frame)
+	{
+		// DDS keeps the frame exactly, alpha and format included, for golden image comparisons
+		std::vector<std::vector<unsigned char>> mips(1);
+		std::string error;
+		try
+		{
+			if (HasExtension(frame.Filename, ".png"))
+			{
+				bool isBGRA = (frame.Format == DDSFormatB8G8R8A8Unorm || frame.Format == DDSFormatB8G8R8A8UnormSrgb);
+				PNGWriter::Write(frame.Filename, &frame.Pixels[0], frame.Width, frame.Height, frame.Width * 4, isBGRA, true);
+			}
+			else
+			{
+				mips[0].swap(frame.Pixels);
+				DDSWriter::Write(frame.Filename, frame.Format, frame.Width, frame.Height, mips);
+			}
+		}
+		catch (std::runtime_error& ex)
+		{
+			error = frame.Filename + ": " + ex.what();
+		}
+
+		if (mips[0].empty() == false)
+		{
+			mips[0].swap(frame.Pixels);
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (error.empty())
+		{
+			mEncodedCount++;
+		}
+		else
+		{
+			mFailedCount++;
+			mLastError = error;
+		}
+
+		mFrames.Release(&frame);
+		mPendingCount--;
+		mFrameEncoded.notify_all();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+// Portable, like PNGWriter: CaptureTool measures the encode throughput FrameCapture gets, without Direct3D
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include "ObjectPool.h"
+
+namespace Library
+{
+	class ThreadPool;
+
+	// Writes captured frames on a thread pool, as PNG or DDS by the filename's extension, so the thread that captured
+	// them only pays for a copy. Frames are 8-bit RGBA or BGRA, the DDSFormat telling which and whether they're sRGB.
+	// Frames come from a pool and keep their pixel buffers: Encode() swaps the caller's vector with the one in the frame
+	// it acquires, so on the capturing thread a capture at a steady size allocates nothing once every frame in flight
+	// exists. At most maximumPendingCount frames wait or encode at once;
+	// past that, Encode() blocks, which StallCount() counts, rather than letting memory grow while the pool falls behind.
+	class FrameEncoder
+	{
+	public:
+		FrameEncoder(ThreadPool& threadPool, unsigned int maximumPendingCount = DefaultMaximumPendingCount);
+		~FrameEncoder();
+
+		// Pixels are width x height, tightly packed; throws std::runtime_error for anything else or another format.
+		// Encoding failures can't be thrown from the pool, so they are counted, and the latest kept in LastError().
+		void Encode(const std::string& filename, unsigned int width, unsigned int height, unsigned int format, std::vector<unsigned char>& pixels);
+
+		// Blocks until every frame handed over has been written
+		void Wait();
+
+		unsigned int MaximumPendingCount() const;
+		unsigned int PendingCount() const;
+		unsigned int EncodedCount() const;
+		unsigned int FailedCount() const;
+		unsigned int StallCount() const;
+		std::string LastError() const;
+
+		static bool IsSupportedFormat(unsigned int format);
+
+		static const unsigned int DefaultMaximumPendingCount;
+
+	private:
+		typedef struct _Frame
+		{
+			std::string Filename;
+			unsigned int Width;
+			unsigned int Height;
+			unsigned int Format;
+			std::vector<unsigned char> Pixels;
+		} Frame;
+
+		FrameEncoder();
+		FrameEncoder(const FrameEncoder& rhs);
+		FrameEncoder& operator=(const FrameEncoder& rhs);
+
+		void EncodeFrame(Frame& frame);
+
+		ThreadPool* mThreadPool;
+		unsigned int mMaximumPendingCount;
+		ObjectPool<Frame> mFrames;
+		unsigned int mPendingCount;
+		unsigned int mEncodedCount;
+		unsigned int mFailedCount;
+		unsigned int mStallCount;
+		std::string mLastError;
+		mutable std::mutex mMutex;
+		std::condition_variable mFrameEncoded;
+	};
+}
\ No newline at end of file
@@ -7,50 +7,21 @@ namespace Library
 	RTTI_DEFINITIONS(FullScreenRenderTarget)
 
     FullScreenRenderTarget::FullScreenRenderTarget(Game& game)
-        : RenderTarget(), mGame(&game), mRenderTargetView(nullptr), mDepthStencilView(nullptr), mOutputTexture(nullptr)
+        : RenderTarget(), mGame(&game), mRenderTargetView(nullptr), mDepthStencilView(nullptr), mOutputTexture(nullptr), mDepthTexture(nullptr), mViewport(game.Viewport())
     {
-        D3D11_TEXTURE2D_DESC fullScreenTextureDesc;
-        ZeroMemory(&fullScreenTextureDesc, sizeof(fullScreenTextureDesc));
-        fullScreenTextureDesc.Width = game.ScreenWidth();
-        fullScreenTextureDesc.Height = game.ScreenHeight();
-        fullScreenTextureDesc.MipLevels = 1;
-        fullScreenTextureDesc.ArraySize = 1;
-        fullScreenTextureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        fullScreenTextureDesc.SampleDesc.Count = 1;
-        fullScreenTextureDesc.SampleDesc.Quality = 0;
-        fullScreenTextureDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+        CreateColorTarget(game.ScreenWidth(), game.ScreenHeight());
 
         HRESULT hr;
-        ID3D11Texture2D* fullScreenTexture = nullptr;
-        if (FAILED(hr = game.Direct3DDevice()->CreateTexture2D(&fullScreenTextureDesc, nullptr, &fullScreenTexture)))
-        {
-            throw GameException("IDXGIDevice::CreateTexture2D() failed.", hr);
-        }
-
-        if (FAILED(hr = game.Direct3DDevice()->CreateShaderResourceView(fullScreenTexture, nullptr, &mOutputTexture)))
-        {
-			ReleaseObject(fullScreenTexture);
-            throw GameException("IDXGIDevice::CreateShaderResourceView() failed.", hr);
-        }
-
-        if (FAILED(hr = game.Direct3DDevice()->CreateRenderTargetView(fullScreenTexture, nullptr, &mRenderTargetView)))
-        {
-            ReleaseObject(fullScreenTexture);
-            throw GameException("IDXGIDevice::CreateRenderTargetView() failed.", hr);
-        }
-
-        ReleaseObject(fullScreenTexture);
-
         D3D11_TEXTURE2D_DESC depthStencilDesc;
         ZeroMemory(&depthStencilDesc, sizeof(depthStencilDesc));
         depthStencilDesc.Width = game.ScreenWidth();
         depthStencilDesc.Height = game.ScreenHeight();
         depthStencilDesc.MipLevels = 1;
         depthStencilDesc.ArraySize = 1;
-        depthStencilDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+        depthStencilDesc.Format = DXGI_FORMAT_R24G8_TYPELESS;
         depthStencilDesc.SampleDesc.Count = 1;
         depthStencilDesc.SampleDesc.Quality = 0;
-        depthStencilDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+        depthStencilDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
 
         ID3D11Texture2D* depthStencilBuffer = nullptr;
         if (FAILED(hr = game.Direct3DDevice()->CreateTexture2D(&depthStencilDesc, nullptr, &depthStencilBuffer)))
@@ -58,17 +29,46 @@ namespace Library
             throw GameException("IDXGIDevice::CreateTexture2D() failed.", hr);
         }
 
-        if (FAILED(hr = game.Direct3DDevice()->CreateDepthStencilView(depthStencilBuffer, nullptr, &mDepthStencilView)))
+        D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc;
+        ZeroMemory(&depthStencilViewDesc, sizeof(depthStencilViewDesc));
+        depthStencilViewDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+        depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+
+        if (FAILED(hr = game.Direct3DDevice()->CreateDepthStencilView(depthStencilBuffer, &depthStencilViewDesc, &mDepthStencilView)))
         {
             ReleaseObject(depthStencilBuffer);
             throw GameException("IDXGIDevice::CreateDepthStencilView() failed.", hr);
         }
 
+        // Readable depth, for passes such as TemporalAA that reconstruct positions after the scene is drawn
+        D3D11_SHADER_RESOURCE_VIEW_DESC resourceViewDesc;
+        ZeroMemory(&resourceViewDesc, sizeof(resourceViewDesc));
+        resourceViewDesc.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+        resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        resourceViewDesc.Texture2D.MipLevels = 1;
+
+        if (FAILED(hr = game.Direct3DDevice()->CreateShaderResourceView(depthStencilBuffer, &resourceViewDesc, &mDepthTexture)))
+        {
+            ReleaseObject(depthStencilBuffer);
+            throw GameException("IDXGIDevice::CreateShaderResourceView() failed.", hr);
+        }
+
         ReleaseObject(depthStencilBuffer);
     }
 
+    FullScreenRenderTarget::FullScreenRenderTarget(Game& game, UINT width, UINT height)
+        : RenderTarget(), mGame(&game), mRenderTargetView(nullptr), mDepthStencilView(nullptr), mOutputTexture(nullptr), mDepthTexture(nullptr), mViewport()
+    {
+        CreateColorTarget(width, height);
+
+        mViewport.Width = static_cast<float>(width);
+        mViewport.Height = static_cast<float>(height);
+        mViewport.MaxDepth = 1.0f;
+    }
+
     FullScreenRenderTarget::~FullScreenRenderTarget()
     {
+        ReleaseObject(mDepthTexture);
         ReleaseObject(mOutputTexture);
         ReleaseObject(mDepthStencilView);
         ReleaseObject(mRenderTargetView);
@@ -79,6 +79,11 @@ namespace Library
         return mOutputTexture;
     }
 
+    ID3D11ShaderResourceView* FullScreenRenderTarget::DepthTexture() const
+    {
+        return mDepthTexture;
+    }
+
     ID3D11RenderTargetView* FullScreenRenderTarget::RenderTargetView() const
     {
         return mRenderTargetView;
@@ -91,11 +96,46 @@ namespace Library
 
     void FullScreenRenderTarget::Begin()
     {
-		RenderTarget::Begin(mGame->Direct3DDeviceContext(), 1, &mRenderTargetView, mDepthStencilView, mGame->Viewport());
+		RenderTarget::Begin(mGame->Direct3DDeviceContext(), 1, &mRenderTargetView, mDepthStencilView, mViewport);
     }
 
     void FullScreenRenderTarget::End()
     {
 		RenderTarget::End(mGame->Direct3DDeviceContext());
     }
+
+    void FullScreenRenderTarget::CreateColorTarget(UINT width, UINT height)
+    {
+        D3D11_TEXTURE2D_DESC fullScreenTextureDesc;
+        ZeroMemory(&fullScreenTextureDesc, sizeof(fullScreenTextureDesc));
+        fullScreenTextureDesc.Width = width;
+        fullScreenTextureDesc.Height = height;
+        fullScreenTextureDesc.MipLevels = 1;
+        fullScreenTextureDesc.ArraySize = 1;
+        fullScreenTextureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        fullScreenTextureDesc.SampleDesc.Count = 1;
+        fullScreenTextureDesc.SampleDesc.Quality = 0;
+        fullScreenTextureDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+
+        HRESULT hr;
+        ID3D11Texture2D* fullScreenTexture = nullptr;
+        if (FAILED(hr = mGame->Direct3DDevice()->CreateTexture2D(&fullScreenTextureDesc, nullptr, &fullScreenTexture)))
+        {
+            throw GameException("IDXGIDevice::CreateTexture2D() failed.", hr);
+        }
+
+        if (FAILED(hr = mGame->Direct3DDevice()->CreateShaderResourceView(fullScreenTexture, nullptr, &mOutputTexture)))
+        {
+			ReleaseObject(fullScreenTexture);
+            throw GameException("IDXGIDevice::CreateShaderResourceView() failed.", hr);
+        }
+
+        if (FAILED(hr = mGame->Direct3DDevice()->CreateRenderTargetView(fullScreenTexture, nullptr, &mRenderTargetView)))
+        {
+            ReleaseObject(fullScreenTexture);
+            throw GameException("IDXGIDevice::CreateRenderTargetView() failed.", hr);
+        }
+
+        ReleaseObject(fullScreenTexture);
+    }
 }
\ No newline at end of file
@@ -13,9 +13,15 @@ namespace Library
 
     public:
         FullScreenRenderTarget(Game& game);
+
+        // Color-only target with its own viewport, for reduced-resolution passes that draw every texel
+        FullScreenRenderTarget(Game& game, UINT width, UINT height);
         ~FullScreenRenderTarget();
 
         ID3D11ShaderResourceView* OutputTexture() const;
+
+        // Null for color-only targets
+        ID3D11ShaderResourceView* DepthTexture() const;
         ID3D11RenderTargetView* RenderTargetView() const;
         ID3D11DepthStencilView* DepthStencilView() const;
 
@@ -27,9 +33,13 @@ namespace Library
         FullScreenRenderTarget(const FullScreenRenderTarget& rhs);
         FullScreenRenderTarget& operator=(const FullScreenRenderTarget& rhs);
 
+        void CreateColorTarget(UINT width, UINT height);
+
         Game* mGame;
         ID3D11RenderTargetView* mRenderTargetView;
         ID3D11DepthStencilView* mDepthStencilView;
         ID3D11ShaderResourceView* mOutputTexture;
+        ID3D11ShaderResourceView* mDepthTexture;
+        D3D11_VIEWPORT mViewport;
     };
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "GBuffer.h"
+#include "Game.h"
+#include "GameException.h"
+#include "ColorHelper.h"
+
+namespace Library
+{
+	RTTI_DEFINITIONS(GBuffer)
+
+	const DXGI_FORMAT GBuffer::Formats[] = { DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R16G16_SNORM, DXGI_FORMAT_R8G8B8A8_UNORM };
+
+	GBuffer::GBuffer(Game& game)
+		: RenderTarget(), mGame(&game), mRenderTargetViews(), mOutputTextures(), mDepthStencilView(nullptr), mDepthTexture(nullptr), mViewport(game.Viewport())
+	{
+		HRESULT hr;
+		for (UINT i = 0; i < GBufferTargetEnd; i++)
+		{
+			D3D11_TEXTURE2D_DESC textureDesc;
+			ZeroMemory(&textureDesc, sizeof(textureDesc));
+			textureDesc.Width = game.ScreenWidth();
+			textureDesc.Height = game.ScreenHeight();
+			textureDesc.MipLevels = 1;
+			textureDesc.ArraySize = 1;
+			textureDesc.Format = Formats[i];
+			textureDesc.SampleDesc.Count = 1;
+			textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+
+			ID3D11Texture2D* texture = nullptr;
+			if (FAILED(hr = game.Direct3DDevice()->CreateTexture2D(&textureDesc, nullptr, &texture)))
+			{
+				throw GameException("IDXGIDevice::CreateTexture2D() failed.", hr);
+			}
+
+			if (FAILED(hr = game.Direct3DDevice()->CreateShaderResourceView(texture, nullptr, &mOutputTextures[i])))
+			{
+				ReleaseObject(texture);
+				throw GameException("IDXGIDevice::CreateShaderResourceView() failed.", hr);
+			}
+
+			if (FAILED(hr = game.Direct3DDevice()->CreateRenderTargetView(texture, nullptr, &mRenderTargetViews[i])))
+			{
+				ReleaseObject(texture);
+				throw GameException("IDXGIDevice::CreateRenderTargetView() failed.", hr);
+			}
+
+			ReleaseObject(texture);
+		}
+
+		D3D11_TEXTURE2D_DESC depthStencilDesc;
+		ZeroMemory(&depthStencilDesc, sizeof(depthStencilDesc));
+		depthStencilDesc.Width = game.ScreenWidth();
+		depthStencilDesc.Height = game.ScreenHeight();
+		depthStencilDesc.MipLevels = 1;
+		depthStencilDesc.ArraySize = 1;
+		depthStencilDesc.Format = DXGI_FORMAT_R24G8_TYPELESS;
+		depthStencilDesc.SampleDesc.Count = 1;
+		depthStencilDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
+
+		ID3D11Texture2D* depthStencilBuffer = nullptr;
+		if (FAILED(hr = game.Direct3DDevice()->CreateTexture2D(&depthStencilDesc, nullptr, &depthStencilBuffer)))
+		{
+			throw GameException("IDXGIDevice::CreateTexture2D() failed.", hr);
+		}
+
+		D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc;
+		ZeroMemory(&depthStencilViewDesc, sizeof(depthStencilViewDesc));
+		depthStencilViewDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+		depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+
+		if (FAILED(hr = game.Direct3DDevice()->CreateDepthStencilView(depthStencilBuffer, &depthStencilViewDesc, &mDepthStencilView)))
+		{
+			ReleaseObject(depthStencilBuffer);
+			throw GameException("IDXGIDevice::CreateDepthStencilView() failed.", hr);
+		}
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC resourceViewDesc;
+		ZeroMemory(&resourceViewDesc, sizeof(resourceViewDesc));
+		resourceViewDesc.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+		resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+		resourceViewDesc.Texture2D.MipLevels = 1;
+
+		if (FAILED(hr = game.Direct3DDevice()->CreateShaderResourceView(depthStencilBuffer, &resourceViewDesc, &mDepthTexture)))
+		{
+			ReleaseObject(depthStencilBuffer);
+			throw GameException("IDXGIDevice::CreateShaderResourceView() failed.", hr);
+		}
+
+		ReleaseObject(depthStencilBuffer);
+	}
+
+	GBuffer::~GBuffer()
+	{
+		ReleaseObject(mDepthTexture);
+		ReleaseObject(mDepthStencilView);
+
+		for (UINT i = 0; i < GBufferTargetEnd; i++)
+		{
+			ReleaseObject(mOutputTextures[i]);
+			ReleaseObject(mRenderTargetViews[i]);
+		}
+	}
+
+	ID3D11ShaderResourceView* GBuffer::OutputTexture(GBufferTarget target) const
+	{
+		return mOutputTextures[target];
+	}
+
+	ID3D11ShaderResourceView* GBuffer::DepthTexture() const
+	{
+		return mDepthTexture;
+	}
+
+	ID3D11DepthStencilView* GBuffer::DepthStencilView() const
+	{
+		return mDepthStencilView;
+	}
+
+	void GBuffer::Clear()
+	{
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		for (UINT i = 0; i < GBufferTargetEnd; i++)
+		{
+			direct3DDeviceContext->ClearRenderTargetView(mRenderTargetViews[i], reinterpret_cast<const float*>(&ColorHelper::Black));
+		}
+
+		direct3DDeviceContext->ClearDepthStencilView(mDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+	}
+
+	void GBuffer::Begin()
+	{
+		RenderTarget::Begin(mGame->Direct3DDeviceContext(), GBufferTargetEnd, mRenderTargetViews, mDepthStencilView, mViewport);
+	}
+
+	void GBuffer::End()
+	{
+		RenderTarget::End(mGame->Direct3DDeviceContext());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Common.h"
+#include "RenderTarget.h"
+
+namespace Library
+{
+	class Game;
+
+	enum GBufferTarget
+	{
+		GBufferTargetAlbedo = 0,
+		GBufferTargetNormal,
+		GBufferTargetSpecular,
+		GBufferTargetEnd
+	};
+
+	// Screen-sized geometry buffer: albedo (RGBA8), octahedral normal (RG16 SNORM), specular colour and encoded power
+	// (RGBA8), and a readable depth buffer. See GBufferPacking for the encodings.
+	class GBuffer : public RenderTarget
+	{
+		RTTI_DECLARATIONS(GBuffer, RenderTarget)
+
+	public:
+		GBuffer(Game& game);
+		~GBuffer();
+
+		ID3D11ShaderResourceView* OutputTexture(GBufferTarget target) const;
+		ID3D11ShaderResourceView* DepthTexture() const;
+		ID3D11DepthStencilView* DepthStencilView() const;
+
+		void Clear();
+
+		virtual void Begin() override;
+		virtual void End() override;
+
+		static const DXGI_FORMAT Formats[GBufferTargetEnd];
+
+	private:
+		GBuffer();
+		GBuffer(const GBuffer& rhs);
+		GBuffer& operator=(const GBuffer& rhs);
+
+		Game* mGame;
+		ID3D11RenderTargetView* mRenderTargetViews[GBufferTargetEnd];
+		ID3D11ShaderResourceView* mOutputTextures[GBufferTargetEnd];
+		ID3D11DepthStencilView* mDepthStencilView;
+		ID3D11ShaderResourceView* mDepthTexture;
+		D3D11_VIEWPORT mViewport;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "GBufferPacking.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Library
+{
+	const float GBufferPacking::MaximumSpecularPower = 2048.0f;
+
+	void GBufferPacking::EncodeNormal(const float normal[3], float encoded[2])
+	{
+		float length = fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+		float x = normal[0] / length;
+		float y = normal[1] / length;
+
+		if (normal[2] < 0.0f)
+		{
+			float foldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			float foldedY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = foldedX;
+			y = foldedY;
+		}
+
+		encoded[0] = x;
+		encoded[1] = y;
+	}
+
+	void GBufferPacking::DecodeNormal(const float encoded[2], float normal[3])
+	{
+		normal[0] = encoded[0];
+		normal[1] = encoded[1];
+		normal[2] = 1.0f - fabsf(encoded[0]) - fabsf(encoded[1]);
+
+		float unfold = std::max(-normal[2], 0.0f);
+		normal[0] += (normal[0] >= 0.0f ? -unfold : unfold);
+		normal[1] += (normal[1] >= 0.0f ? -unfold : unfold);
+
+		float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		for (int i = 0; i < 3; i++)
+		{
+			normal[i] /= length;
+		}
+	}
+
+	float GBufferPacking::EncodeSpecularPower(float specularPower)
+	{
+		return log2f(std::min(std::max(specularPower, 1.0f), MaximumSpecularPower)) / log2f(MaximumSpecularPower);
+	}
+
+	float GBufferPacking::DecodeSpecularPower(float encoded)
+	{
+		return exp2f(encoded * log2f(MaximumSpecularPower));
+	}
+
+	float GBufferPacking::QuantizeUnorm(float value, unsigned int bits)
+	{
+		float scale = static_cast<float>((1U << bits) - 1);
+		return floorf(std::min(std::max(value, 0.0f), 1.0f) * scale + 0.5f) / scale;
+	}
+
+	float GBufferPacking::QuantizeSnorm(float value, unsigned int bits)
+	{
+		float scale = static_cast<float>((1U << (bits - 1)) - 1);
+		float rounded = std::min(std::max(value, -1.0f), 1.0f) * scale;
+		return (rounded >= 0.0f ? floorf(rounded + 0.5f) : ceilf(rounded - 0.5f)) / scale;
+	}
+
+	float GBufferPacking::LinearDepth(float depth, float nearPlaneDistance, float farPlaneDistance)
+	{
+		return (nearPlaneDistance * farPlaneDistance) / (farPlaneDistance - depth * (farPlaneDistance - nearPlaneDistance));
+	}
+
+	void GBufferPacking::ViewPosition(float u, float v, float depth, float tanHalfFieldOfViewX, float tanHalfFieldOfViewY, float nearPlaneDistance, float farPlaneDistance, float position[3])
+	{
+		float linearDepth = LinearDepth(depth, nearPlaneDistance, farPlaneDistance);
+
+		position[0] = (u * 2.0f - 1.0f) * tanHalfFieldOfViewX * linearDepth;
+		position[1] = (1.0f - v * 2.0f) * tanHalfFieldOfViewY * linearDepth;
+		position[2] = -linearDepth;
+	}
+}
\ No newline at end of file
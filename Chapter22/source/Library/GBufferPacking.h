@@ -0,0 +1,36 @@
+#pragma once
+
+// Portable like BlurKernel: the G-buffer encodings that Deferred.fx mirrors, so their precision can be checked on the CPU
+
+namespace Library
+{
+	// Normals are stored octahedrally in two 16-bit SNORM channels, specular power logarithmically in one 8-bit UNORM
+	// channel, and positions are rebuilt from the hardware depth buffer rather than stored.
+	class GBufferPacking
+	{
+	public:
+		// Folds the unit sphere onto the [-1, 1] square; the lower hemisphere wraps into the corners
+		static void EncodeNormal(const float normal[3], float encoded[2]);
+		static void DecodeNormal(const float encoded[2], float normal[3]);
+
+		static float EncodeSpecularPower(float specularPower);
+		static float DecodeSpecularPower(float encoded);
+
+		// The value a UNORM or SNORM channel of the given width stores for value
+		static float QuantizeUnorm(float value, unsigned int bits);
+		static float QuantizeSnorm(float value, unsigned int bits);
+
+		// For the camera's right-handed projection (XMMatrixPerspectiveFovRH), where depth 0 is the near plane
+		static float LinearDepth(float depth, float nearPlaneDistance, float farPlaneDistance);
+
+		// View-space position of the texel at (u, v) holding depth; view space looks down -z
+		static void ViewPosition(float u, float v, float depth, float tanHalfFieldOfViewX, float tanHalfFieldOfViewY, float nearPlaneDistance, float farPlaneDistance, float position[3]);
+
+		static const float MaximumSpecularPower;
+
+	private:
+		GBufferPacking();
+		GBufferPacking(const GBufferPacking& rhs);
+		GBufferPacking& operator=(const GBufferPacking& rhs);
+	};
+}
\ No newline at end of file
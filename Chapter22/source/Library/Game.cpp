@@ -1,6 +1,14 @@
 #include "Game.h"
 #include "DrawableGameComponent.h"
 #include "GameException.h"
+#include "ThreadPool.h"
+#include "SharedEffectCache.h"
+#include "EffectCache.h"
+#include "EffectWatcher.h"
+#include "ContentManager.h"
+#include "FrameAllocator.h"
+#include "AllocationCounter.h"
+#include "Utility.h"
 
 namespace Library
 {
@@ -16,16 +24,32 @@ namespace Library
           mWindowHandle(), mWindow(),
           mScreenWidth(DefaultScreenWidth), mScreenHeight(DefaultScreenHeight),
           mGameClock(), mGameTime(),
-          mFeatureLevel(D3D_FEATURE_LEVEL_9_1), mDirect3DDevice(nullptr), mDirect3DDeviceContext(nullptr), mSwapChain(nullptr),  
+          mDriverType(D3D_DRIVER_TYPE_HARDWARE), mFeatureLevel(D3D_FEATURE_LEVEL_9_1), mDirect3DDevice(nullptr), mDirect3DDeviceContext(nullptr), mRenderThread(std::this_thread::get_id()), mSwapChain(nullptr),  
           mFrameRate(DefaultFrameRate), mIsFullScreen(false),
           mDepthStencilBufferEnabled(false), mMultiSamplingEnabled(false), mMultiSamplingCount(DefaultMultiSamplingCount), mMultiSamplingQualityLevels(0), 
           mDepthStencilBuffer(nullptr), mRenderTargetView(nullptr), mDepthStencilView(nullptr), mViewport(),
-		  mComponents(), mServices()
+		  mComponents(), mServices(), mWorkerThreads(new ThreadPool()), mSharedEffects(new SharedEffectCache(*this)),
+		  mCompiledEffects(new EffectCache(*this, *mWorkerThreads, Utility::ExecutableDirectory() + L"\\EffectCache")), mEffectWatcher(new EffectWatcher(*this, *mCompiledEffects)),
+		  mContent(new ContentManager(*this)),
+		  mFrameAllocator(new FrameAllocator()), mFrameAllocationCount(0), mObjectPools(), mObjectPoolsMutex()
     {
     }
 
     Game::~Game()
-    {		
+    {
+		// The watcher stops queueing compiles, then the pool runs what is queued, which may still use everything below
+		DeleteObject(mEffectWatcher);
+		DeleteObject(mWorkerThreads);
+
+		for (auto& objectPool : mObjectPools)
+		{
+			DeleteObject(objectPool.second);
+		}
+
+		DeleteObject(mFrameAllocator);
+		DeleteObject(mContent);
+		DeleteObject(mCompiledEffects);
+		DeleteObject(mSharedEffects);
     }
 
     HINSTANCE Game::Instance() const
@@ -73,6 +97,11 @@ namespace Library
         return mDirect3DDeviceContext;
     }
 
+	bool Game::IsRenderThread() const
+	{
+		return (std::this_thread::get_id() == mRenderThread);
+	}
+
 	bool Game::DepthStencilBufferEnabled() const
 	{
 		return mDepthStencilBufferEnabled;
@@ -132,6 +161,41 @@ namespace Library
     {
         return mServices;
     }
+
+	ThreadPool& Game::WorkerThreads() const
+	{
+		return *mWorkerThreads;
+	}
+
+	SharedEffectCache& Game::SharedEffects() const
+	{
+		return *mSharedEffects;
+	}
+
+	EffectCache& Game::CompiledEffects() const
+	{
+		return *mCompiledEffects;
+	}
+
+	EffectWatcher& Game::WatchedEffects() const
+	{
+		return *mEffectWatcher;
+	}
+
+	ContentManager& Game::Content() const
+	{
+		return *mContent;
+	}
+
+	FrameAllocator& Game::FrameMemory() const
+	{
+		return *mFrameAllocator;
+	}
+
+	UINT64 Game::FrameAllocationCount() const
+	{
+		return mFrameAllocationCount;
+	}
         
     void Game::Run()
     {
@@ -154,8 +218,12 @@ namespace Library
             else
             {
                 mGameClock.UpdateGameTime(mGameTime);
+                mFrameAllocator->Reset();
+
+                UINT64 allocationCount = AllocationCounter::AllocationCount();
                 Update(mGameTime);
                 Draw(mGameTime);
+                mFrameAllocationCount = AllocationCounter::AllocationCount() - allocationCount;
             }
         }
 
@@ -169,6 +237,8 @@ namespace Library
 
 	void Game::Shutdown()
     {
+		mSharedEffects->Clear();
+
 		ReleaseObject(mRenderTargetView);
         ReleaseObject(mDepthStencilView);
         ReleaseObject(mSwapChain);
@@ -195,6 +265,9 @@ namespace Library
 
     void Game::Update(const GameTime& gameTime)
     {
+		// Effects recompiled since the last frame are swapped in before any component uses them
+		mEffectWatcher->Update(gameTime);
+
         for (GameComponent* component : mComponents)
         {
             if (component->Enabled())
@@ -279,7 +352,7 @@ namespace Library
 
         ID3D11Device* direct3DDevice = nullptr;
         ID3D11DeviceContext* direct3DDeviceContext = nullptr;
-        if (FAILED(hr = D3D11CreateDevice(NULL, D3D_DRIVER_TYPE_HARDWARE, NULL, createDeviceFlags, featureLevels, ARRAYSIZE(featureLevels), D3D11_SDK_VERSION, &direct3DDevice, &mFeatureLevel, &direct3DDeviceContext)))
+        if (FAILED(hr = D3D11CreateDevice(NULL, mDriverType, NULL, createDeviceFlags, featureLevels, ARRAYSIZE(featureLevels), D3D11_SDK_VERSION, &direct3DDevice, &mFeatureLevel, &direct3DDeviceContext)))
         {
             throw GameException("D3D11CreateDevice() failed", hr);
         }
@@ -297,10 +370,14 @@ namespace Library
 		ReleaseObject(direct3DDevice);
 		ReleaseObject(direct3DDeviceContext);
 
-        mDirect3DDevice->CheckMultisampleQualityLevels(DXGI_FORMAT_R8G8B8A8_UNORM, mMultiSamplingCount, &mMultiSamplingQualityLevels);
-        if (mMultiSamplingQualityLevels == 0)
+        // Only a multi-sampled swap chain needs the quality level; TemporalAA runs on hardware without 4x support
+        if (mMultiSamplingEnabled)
         {
-            throw GameException("Unsupported multi-sampling quality");
+            mDirect3DDevice->CheckMultisampleQualityLevels(DXGI_FORMAT_R8G8B8A8_UNORM, mMultiSamplingCount, &mMultiSamplingQualityLevels);
+            if (mMultiSamplingQualityLevels == 0)
+            {
+                throw GameException("Unsupported multi-sampling quality");
+            }
         }
 
         DXGI_SWAP_CHAIN_DESC1 swapChainDesc;
@@ -6,9 +6,19 @@
 #include "GameComponent.h"
 #include "ServiceContainer.h"
 #include "RenderTarget.h"
+#include "ObjectPool.h"
+#include <thread>
+#include <mutex>
 
 namespace Library
 {
+    class ThreadPool;
+    class SharedEffectCache;
+    class EffectCache;
+    class EffectWatcher;
+    class ContentManager;
+    class FrameAllocator;
+
     class Game : public RenderTarget
     {
 		RTTI_DECLARATIONS(Game, RenderTarget)
@@ -27,6 +37,7 @@ namespace Library
 
         ID3D11Device1* Direct3DDevice() const;
         ID3D11DeviceContext1* Direct3DDeviceContext() const;
+		bool IsRenderThread() const;
         bool DepthStencilBufferEnabled() const;
 		ID3D11RenderTargetView* RenderTargetView() const;
 		ID3D11DepthStencilView* DepthStencilView() const;
@@ -40,6 +51,29 @@ namespace Library
 
 		const std::vector<GameComponent*>& Components() const;
 		const ServiceContainer& Services() const;
+		ThreadPool& WorkerThreads() const;
+		SharedEffectCache& SharedEffects() const;
+		EffectCache& CompiledEffects() const;
+		EffectWatcher& WatchedEffects() const;
+		ContentManager& Content() const;
+		FrameAllocator& FrameMemory() const;
+		UINT64 FrameAllocationCount() const;
+
+		// Objects recycled across frames, a pool per type, e.g. scratch vectors that keep their capacity from one frame
+		// to the next. Callers reinitialize what they acquire. Any thread, a worker job included, may acquire and release.
+		template <typename T>
+		T* AcquirePooled()
+		{
+			std::lock_guard<std::mutex> lock(mObjectPoolsMutex);
+			return Pool<T>().Acquire();
+		}
+
+		template <typename T>
+		void ReleasePooled(T* object)
+		{
+			std::lock_guard<std::mutex> lock(mObjectPoolsMutex);
+			Pool<T>().Release(object);
+		}
 
         virtual void Run();
         virtual void Exit();
@@ -77,10 +111,23 @@ namespace Library
         GameTime mGameTime;
 		std::vector<GameComponent*> mComponents;
 		ServiceContainer mServices;
-
+		ThreadPool* mWorkerThreads;
+		SharedEffectCache* mSharedEffects;
+		EffectCache* mCompiledEffects;
+		EffectWatcher* mEffectWatcher;
+		ContentManager* mContent;
+		FrameAllocator* mFrameAllocator;
+		UINT64 mFrameAllocationCount;
+		std::map<const void*, ObjectPoolBase*> mObjectPools;
+		std::mutex mObjectPoolsMutex;
+
+        // D3D_DRIVER_TYPE_WARP renders on the CPU, the same on every machine, for golden image captures
+        D3D_DRIVER_TYPE mDriverType;
         D3D_FEATURE_LEVEL mFeatureLevel;
         ID3D11Device1* mDirect3DDevice;
         ID3D11DeviceContext1* mDirect3DDeviceContext;
+		// The immediate context isn't thread-safe; only the thread that constructs and runs the game uses it
+		std::thread::id mRenderThread;
         IDXGISwapChain1* mSwapChain;
 
         UINT mFrameRate;
@@ -100,6 +147,20 @@ namespace Library
         Game(const Game& rhs);
         Game& operator=(const Game& rhs);
 
+		// Called with mObjectPoolsMutex held
+		template <typename T>
+		ObjectPool<T>& Pool()
+		{
+			const void* key = ObjectPool<T>::TypeIdClass();
+			auto it = mObjectPools.find(key);
+			if (it == mObjectPools.end())
+			{
+				it = mObjectPools.insert(std::make_pair(key, new ObjectPool<T>())).first;
+			}
+
+			return *static_cast<ObjectPool<T>*>(it->second);
+		}
+
         POINT CenterWindow(int windowWidth, int windowHeight);
         static LRESULT WINAPI WndProc(HWND windowHandle, UINT message, WPARAM wParam, LPARAM lParam);		
     };
@@ -8,6 +8,7 @@
 #include "VectorHelper.h"
 #include "MatrixHelper.h"
 #include "Utility.h"
+#include "ContentManager.h"
 #include "ColorHelper.h"
 
 namespace Library
@@ -18,25 +19,31 @@ namespace Library
 
     GaussianBlur::GaussianBlur(Game& game, Camera& camera)
         : DrawableGameComponent(game, camera),
-          mEffect(nullptr), mMaterial(nullptr), mSceneTexture(nullptr), mOutputTexture(nullptr), mHorizontalBlurTarget(nullptr), mVerticalBlurTarget(nullptr), mFullScreenQuad(nullptr),
-          mHorizontalSampleOffsets(), mVerticalSampleOffsets(), mSampleWeights(), mBlurAmount(DefaultBlurAmount)
+          mEffect(), mMaterial(nullptr), mSceneTexture(nullptr), mOutputTexture(nullptr), mHorizontalBlurTarget(nullptr), mVerticalBlurTarget(nullptr), mFullScreenQuad(nullptr),
+          mHorizontalSampleOffsets(), mVerticalSampleOffsets(), mSampleWeights(), mSampleCount(0), mBlurAmount(DefaultBlurAmount), mTechnique(BlurTechniqueGaussian),
+          mKawaseTargets(), mKawaseTexelSizes(), mKawaseSource(nullptr), mKawaseLevel(0), mUpdateMaterial(nullptr)
     {
     }
 
     GaussianBlur::GaussianBlur(Game& game, Camera& camera, float blurAmount)
         : DrawableGameComponent(game, camera),
-          mEffect(nullptr), mMaterial(nullptr), mSceneTexture(nullptr), mOutputTexture(nullptr), mHorizontalBlurTarget(nullptr), mVerticalBlurTarget(nullptr), mFullScreenQuad(nullptr),
-          mHorizontalSampleOffsets(), mVerticalSampleOffsets(), mSampleWeights(), mBlurAmount(blurAmount)
+          mEffect(), mMaterial(nullptr), mSceneTexture(nullptr), mOutputTexture(nullptr), mHorizontalBlurTarget(nullptr), mVerticalBlurTarget(nullptr), mFullScreenQuad(nullptr),
+          mHorizontalSampleOffsets(), mVerticalSampleOffsets(), mSampleWeights(), mSampleCount(0), mBlurAmount(blurAmount), mTechnique(BlurTechniqueGaussian),
+          mKawaseTargets(), mKawaseTexelSizes(), mKawaseSource(nullptr), mKawaseLevel(0), mUpdateMaterial(nullptr)
     {
     }
 
     GaussianBlur::~GaussianBlur()
     {
+		for (FullScreenRenderTarget* kawaseTarget : mKawaseTargets)
+		{
+			DeleteObject(kawaseTarget);
+		}
+
         DeleteObject(mFullScreenQuad);
         DeleteObject(mVerticalBlurTarget);
 		DeleteObject(mHorizontalBlurTarget);        
         DeleteObject(mMaterial);
-        DeleteObject(mEffect);
     }
 
     ID3D11ShaderResourceView* GaussianBlur::SceneTexture()
@@ -62,15 +69,23 @@ namespace Library
     void GaussianBlur::SetBlurAmount(float blurAmount)
     {
         mBlurAmount = blurAmount;
-        InitializeSampleWeights();
+
+		if (mMaterial != nullptr)
+		{
+			InitializeSamples();
+		}
     }
 
+	BlurTechnique GaussianBlur::Technique() const
+	{
+		return mTechnique;
+	}
+
     void GaussianBlur::Initialize()
     {
         SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
-        mEffect = new Effect(*mGame);
-        mEffect->LoadCompiledEffect(L"Content\\Effects\\GaussianBlur.cso");
+        mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\GaussianBlur.cso");
 
         mMaterial = new GaussianBlurMaterial();
         mMaterial->Initialize(*mEffect);
@@ -78,50 +93,66 @@ namespace Library
         mFullScreenQuad = new FullScreenQuad(*mGame, *mMaterial);
         mFullScreenQuad->Initialize();        
 
-        InitializeSampleWeights();
-        InitializeSampleOffsets();
+		// The blur passes switch mUpdateMaterial rather than rebinding the callback
+		mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&GaussianBlur::UpdateMaterial, this));
 
         mHorizontalBlurTarget = new FullScreenRenderTarget(*mGame);
         mVerticalBlurTarget = new FullScreenRenderTarget(*mGame);
+
+        InitializeSamples();
     }
 
     void GaussianBlur::Draw(const GameTime& gameTime)
     {
 		mOutputTexture = nullptr;
 
-        if (mBlurAmount > 0.0f)
+        if (mBlurAmount > 0.0f && mTechnique == BlurTechniqueDualKawase)
+        {
+			DrawDualKawase(gameTime, nullptr);
+        }
+        else if (mBlurAmount > 0.0f)
         {
             // Horizontal blur
             mHorizontalBlurTarget->Begin();
             mGame->Direct3DDeviceContext()->ClearRenderTargetView(mHorizontalBlurTarget->RenderTargetView(), reinterpret_cast<const float*>(&ColorHelper::Purple));
             mGame->Direct3DDeviceContext()->ClearDepthStencilView(mHorizontalBlurTarget->DepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 			mFullScreenQuad->SetActiveTechnique("blur", "p0");
-            mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&GaussianBlur::UpdateGaussianMaterialWithHorizontalOffsets, this));
+            mUpdateMaterial = &GaussianBlur::UpdateGaussianMaterialWithHorizontalOffsets;
             mFullScreenQuad->Draw(gameTime);
             mHorizontalBlurTarget->End();
 
             // Vertical blur for the final image
-            mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&GaussianBlur::UpdateGaussianMaterialWithVerticalOffsets, this));
+            mUpdateMaterial = &GaussianBlur::UpdateGaussianMaterialWithVerticalOffsets;
             mFullScreenQuad->Draw(gameTime);
         }
         else
         {
 			mFullScreenQuad->SetActiveTechnique("no_blur", "p0");
-            mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&GaussianBlur::UpdateGaussianMaterialNoBlur, this));
+            mUpdateMaterial = &GaussianBlur::UpdateGaussianMaterialNoBlur;
             mFullScreenQuad->Draw(gameTime);
         }
     }
 
 	void GaussianBlur::DrawToTexture(const GameTime& gameTime)
 	{
-		if (mBlurAmount > 0.0f)
+		if (mBlurAmount > 0.0f && mTechnique == BlurTechniqueDualKawase)
+		{
+			mVerticalBlurTarget->Begin();
+			mGame->Direct3DDeviceContext()->ClearRenderTargetView(mVerticalBlurTarget->RenderTargetView(), reinterpret_cast<const float*>(&ColorHelper::Purple));
+			mGame->Direct3DDeviceContext()->ClearDepthStencilView(mVerticalBlurTarget->DepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+			mVerticalBlurTarget->End();
+
+			DrawDualKawase(gameTime, mVerticalBlurTarget);
+			mOutputTexture = mVerticalBlurTarget->OutputTexture();
+		}
+		else if (mBlurAmount > 0.0f)
         {
             // Horizontal blur
             mHorizontalBlurTarget->Begin();
             mGame->Direct3DDeviceContext()->ClearRenderTargetView(mHorizontalBlurTarget->RenderTargetView(), reinterpret_cast<const float*>(&ColorHelper::Purple));
             mGame->Direct3DDeviceContext()->ClearDepthStencilView(mHorizontalBlurTarget->DepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 			mFullScreenQuad->SetActiveTechnique("blur", "p0");
-            mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&GaussianBlur::UpdateGaussianMaterialWithHorizontalOffsets, this));
+            mUpdateMaterial = &GaussianBlur::UpdateGaussianMaterialWithHorizontalOffsets;
             mFullScreenQuad->Draw(gameTime);
             mHorizontalBlurTarget->End();
 
@@ -131,7 +162,7 @@ namespace Library
             mVerticalBlurTarget->Begin();
             mGame->Direct3DDeviceContext()->ClearRenderTargetView(mVerticalBlurTarget->RenderTargetView(), reinterpret_cast<const float*>(&ColorHelper::Purple));
             mGame->Direct3DDeviceContext()->ClearDepthStencilView(mVerticalBlurTarget->DepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
-            mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&GaussianBlur::UpdateGaussianMaterialWithVerticalOffsets, this));
+            mUpdateMaterial = &GaussianBlur::UpdateGaussianMaterialWithVerticalOffsets;
             mFullScreenQuad->Draw(gameTime);
             mVerticalBlurTarget->End();
 
@@ -142,7 +173,7 @@ namespace Library
         {
 			mHorizontalBlurTarget->Begin();
 			mFullScreenQuad->SetActiveTechnique("no_blur", "p0");
-            mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&GaussianBlur::UpdateGaussianMaterialNoBlur, this));
+            mUpdateMaterial = &GaussianBlur::UpdateGaussianMaterialNoBlur;
             mFullScreenQuad->Draw(gameTime);
 			mHorizontalBlurTarget->End();
 
@@ -151,58 +182,124 @@ namespace Library
         }		
 	}
 
-	void GaussianBlur::InitializeSampleOffsets()
+	void GaussianBlur::DrawDualKawase(const GameTime& gameTime, FullScreenRenderTarget* outputTarget)
 	{
-		float horizontalPixelSize = 1.0f / mGame->ScreenWidth();
-		float verticalPixelSize = 1.0f / mGame->ScreenHeight();
+		UINT iterations = static_cast<UINT>(mKawaseTargets.size());
+		mUpdateMaterial = &GaussianBlur::UpdateKawaseMaterial;
 
-		UINT sampleCount = mMaterial->SampleOffsets().TypeDesc().Elements;
+		// Down the chain of half-resolution targets
+		mFullScreenQuad->SetActiveTechnique("kawase_downsample", "p0");
+		mKawaseSource = mSceneTexture;
+		for (UINT i = 0; i < iterations; i++)
+		{
+			mKawaseLevel = i;
+			mKawaseTargets[i]->Begin();
+			mFullScreenQuad->Draw(gameTime);
+			mKawaseTargets[i]->End();
 
-		mHorizontalSampleOffsets.resize(sampleCount);
-		mVerticalSampleOffsets.resize(sampleCount);
-		mHorizontalSampleOffsets[0] = Vector2Helper::Zero;
-		mVerticalSampleOffsets[0] = Vector2Helper::Zero;
+			mGame->UnbindPixelShaderResources(0, 1);
+			mKawaseSource = mKawaseTargets[i]->OutputTexture();
+		}
 
-		for (UINT i = 0; i < sampleCount / 2; i++)
+		// Back up, overwriting each level once its downsample has been consumed
+		mFullScreenQuad->SetActiveTechnique("kawase_upsample", "p0");
+		for (UINT i = iterations - 1; i > 0; i--)
 		{
-			float sampleOffset = i * 2 + 1.5f;
-			float horizontalOffset = horizontalPixelSize * sampleOffset;
-			float verticalOffset = verticalPixelSize * sampleOffset;
+			mKawaseLevel = i + 1;
+			mKawaseTargets[i - 1]->Begin();
+			mFullScreenQuad->Draw(gameTime);
+			mKawaseTargets[i - 1]->End();
+
+			mGame->UnbindPixelShaderResources(0, 1);
+			mKawaseSource = mKawaseTargets[i - 1]->OutputTexture();
+		}
 
-			mHorizontalSampleOffsets[i * 2 + 1] = XMFLOAT2(horizontalOffset, 0.0f);
-			mHorizontalSampleOffsets[i * 2 + 2] = XMFLOAT2(-horizontalOffset, 0.0f);
+		mKawaseLevel = 1;
+		if (outputTarget != nullptr)
+		{
+			outputTarget->Begin();
+			mFullScreenQuad->Draw(gameTime);
+			outputTarget->End();
 
-			mVerticalSampleOffsets[i * 2 + 1] = XMFLOAT2(0.0f, verticalOffset);
-			mVerticalSampleOffsets[i * 2 + 2] = XMFLOAT2(0.0f, -verticalOffset);
+			mGame->UnbindPixelShaderResources(0, 1);
+		}
+		else
+		{
+			mFullScreenQuad->Draw(gameTime);
 		}
 	}
 
-	void GaussianBlur::InitializeSampleWeights()
+	void GaussianBlur::InitializeSamples()
 	{
-		UINT sampleCount = mMaterial->SampleOffsets().TypeDesc().Elements;
+		UINT maximumSampleCount = mMaterial->SampleOffsets().TypeDesc().Elements;
+		UINT techniqueMask = (1 << BlurTechniqueGaussian) | (1 << BlurTechniqueDualKawase);
+		mTechnique = BlurKernel::SelectTechnique(mBlurAmount, mGame->ScreenWidth(), mGame->ScreenHeight(), techniqueMask, maximumSampleCount);
+
+		if (mTechnique == BlurTechniqueDualKawase)
+		{
+			InitializeKawaseTargets();
+			return;
+		}
+
+		std::vector<BlurSample> samples;
+		BlurKernel::ComputeLinearGaussianSamples(mBlurAmount, samples);
+
+		// Amounts too wide for the shader and too far from any Kawase chain lose their outermost pairs
+		float totalWeight = 0.0f;
+		mSampleCount = min(static_cast<UINT>(samples.size()), maximumSampleCount - (maximumSampleCount + 1) % 2);
+		for (UINT i = 0; i < mSampleCount; i++)
+		{
+			totalWeight += samples[i].Weight;
+		}
+
+		float horizontalPixelSize = 1.0f / mGame->ScreenWidth();
+		float verticalPixelSize = 1.0f / mGame->ScreenHeight();
+
+		mHorizontalSampleOffsets.assign(maximumSampleCount, Vector2Helper::Zero);
+		mVerticalSampleOffsets.assign(maximumSampleCount, Vector2Helper::Zero);
+		mSampleWeights.assign(maximumSampleCount, 0.0f);
 
-		mSampleWeights.resize(sampleCount);
-		mSampleWeights[0] = GetWeight(0);
+		for (UINT i = 0; i < mSampleCount; i++)
+		{
+			mHorizontalSampleOffsets[i] = XMFLOAT2(samples[i].Offset * horizontalPixelSize, 0.0f);
+			mVerticalSampleOffsets[i] = XMFLOAT2(0.0f, samples[i].Offset * verticalPixelSize);
+			mSampleWeights[i] = samples[i].Weight / totalWeight;
+		}
+	}
 
-		float totalWeight = mSampleWeights[0];
-		for (UINT i = 0; i < sampleCount / 2; i++)
+	void GaussianBlur::InitializeKawaseTargets()
+	{
+		UINT iterations = BlurKernel::DualKawaseIterations(mBlurAmount);
+		if (iterations == mKawaseTargets.size())
 		{
-			float weight = GetWeight((float)i + 1);
-			mSampleWeights[i * 2 + 1] = weight;
-			mSampleWeights[i * 2 + 2] = weight;
-			totalWeight += weight * 2;
+			return;
 		}
 
-		// Normalize the weights so that they sum to one
-		for (UINT i = 0; i < mSampleWeights.size(); i++)
+		for (FullScreenRenderTarget* kawaseTarget : mKawaseTargets)
 		{
-			mSampleWeights[i] /= totalWeight;
+			DeleteObject(kawaseTarget);
+		}
+
+		mKawaseTargets.clear();
+		mKawaseTexelSizes.clear();
+
+		UINT width = mGame->ScreenWidth();
+		UINT height = mGame->ScreenHeight();
+		mKawaseTexelSizes.push_back(XMFLOAT2(1.0f / width, 1.0f / height));
+
+		for (UINT i = 0; i < iterations; i++)
+		{
+			width = max(width / 2, 1U);
+			height = max(height / 2, 1U);
+
+			mKawaseTargets.push_back(new FullScreenRenderTarget(*mGame, width, height));
+			mKawaseTexelSizes.push_back(XMFLOAT2(1.0f / width, 1.0f / height));
 		}
 	}
 
-	float GaussianBlur::GetWeight(float x) const
+	void GaussianBlur::UpdateMaterial()
 	{
-		return (float)(exp(-(x * x) / (2 * mBlurAmount * mBlurAmount)));
+		(this->*mUpdateMaterial)();
 	}
 
 	void GaussianBlur::UpdateGaussianMaterialWithHorizontalOffsets()
@@ -210,6 +307,7 @@ namespace Library
 		mMaterial->ColorTexture() << mSceneTexture;
 		mMaterial->SampleWeights() << mSampleWeights;
 		mMaterial->SampleOffsets() << mHorizontalSampleOffsets;
+		mMaterial->SampleCount() << static_cast<int>(mSampleCount);
 	}
 
 	void GaussianBlur::UpdateGaussianMaterialWithVerticalOffsets()
@@ -217,10 +315,17 @@ namespace Library
 		mMaterial->ColorTexture() << mHorizontalBlurTarget->OutputTexture();
 		mMaterial->SampleWeights() << mSampleWeights;
 		mMaterial->SampleOffsets() << mVerticalSampleOffsets;
+		mMaterial->SampleCount() << static_cast<int>(mSampleCount);
 	}
 
 	void GaussianBlur::UpdateGaussianMaterialNoBlur()
 	{
 		mMaterial->ColorTexture() << mSceneTexture;
 	}
+
+	void GaussianBlur::UpdateKawaseMaterial()
+	{
+		mMaterial->ColorTexture() << mKawaseSource;
+		mMaterial->SourceTexelSize() << XMLoadFloat2(&mKawaseTexelSizes[mKawaseLevel]);
+	}
 }
\ No newline at end of file
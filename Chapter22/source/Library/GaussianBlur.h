@@ -2,6 +2,7 @@
 
 #include "Common.h"
 #include "DrawableGameComponent.h"
+#include "BlurKernel.h"
 
 namespace Library
 {
@@ -27,6 +28,9 @@ namespace Library
 		float BlurAmount() const;
 		void SetBlurAmount(float blurAmount);
 
+		// Gaussian for small amounts, dual Kawase once the separable kernel costs more than the pyramid
+		BlurTechnique Technique() const;
+
 		virtual void Initialize() override;
 		virtual void Draw(const GameTime& gameTime) override;
 		void DrawToTexture(const GameTime& gameTime);
@@ -36,17 +40,18 @@ namespace Library
 		GaussianBlur(const GaussianBlur& rhs);
 		GaussianBlur& operator=(const GaussianBlur& rhs);
 
-		
-		void InitializeSampleOffsets();
-		void InitializeSampleWeights();		
-		float GetWeight(float x) const;
+		void InitializeSamples();
+		void InitializeKawaseTargets();
+		void DrawDualKawase(const GameTime& gameTime, FullScreenRenderTarget* outputTarget);
+		void UpdateMaterial();
 		void UpdateGaussianMaterialWithHorizontalOffsets();
 		void UpdateGaussianMaterialWithVerticalOffsets();
 		void UpdateGaussianMaterialNoBlur();
+		void UpdateKawaseMaterial();
 
 		static const float DefaultBlurAmount;
 
-		Effect* mEffect;
+		std::shared_ptr<Effect> mEffect;
 		GaussianBlurMaterial* mMaterial;
 		ID3D11ShaderResourceView* mSceneTexture;
 		ID3D11ShaderResourceView* mOutputTexture;
@@ -57,6 +62,14 @@ namespace Library
 		std::vector<XMFLOAT2> mHorizontalSampleOffsets;
 		std::vector<XMFLOAT2> mVerticalSampleOffsets;
 		std::vector<float> mSampleWeights;
+		UINT mSampleCount;
 		float mBlurAmount;
+		BlurTechnique mTechnique;
+
+		std::vector<FullScreenRenderTarget*> mKawaseTargets;
+		std::vector<XMFLOAT2> mKawaseTexelSizes;
+		ID3D11ShaderResourceView* mKawaseSource;
+		UINT mKawaseLevel;
+		void (GaussianBlur::*mUpdateMaterial)();
 	};
 }
\ No newline at end of file
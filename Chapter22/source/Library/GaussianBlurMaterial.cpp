@@ -7,12 +7,15 @@ namespace Library
 
 	GaussianBlurMaterial::GaussianBlurMaterial()
 		: PostProcessingMaterial(),
-		  MATERIAL_VARIABLE_INITIALIZATION(SampleOffsets), MATERIAL_VARIABLE_INITIALIZATION(SampleWeights)
+		  MATERIAL_VARIABLE_INITIALIZATION(SampleOffsets), MATERIAL_VARIABLE_INITIALIZATION(SampleWeights),
+		  MATERIAL_VARIABLE_INITIALIZATION(SampleCount), MATERIAL_VARIABLE_INITIALIZATION(SourceTexelSize)
 	{
 	}
 
 	MATERIAL_VARIABLE_DEFINITION(GaussianBlurMaterial, SampleOffsets)
 	MATERIAL_VARIABLE_DEFINITION(GaussianBlurMaterial, SampleWeights)
+	MATERIAL_VARIABLE_DEFINITION(GaussianBlurMaterial, SampleCount)
+	MATERIAL_VARIABLE_DEFINITION(GaussianBlurMaterial, SourceTexelSize)
 
 	void GaussianBlurMaterial::Initialize(Effect& effect)
 	{
@@ -20,5 +23,7 @@ namespace Library
 
 		MATERIAL_VARIABLE_RETRIEVE(SampleOffsets)
 		MATERIAL_VARIABLE_RETRIEVE(SampleWeights)
+		MATERIAL_VARIABLE_RETRIEVE(SampleCount)
+		MATERIAL_VARIABLE_RETRIEVE(SourceTexelSize)
 	}
 }
\ No newline at end of file
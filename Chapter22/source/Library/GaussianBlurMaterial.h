@@ -11,6 +11,8 @@ namespace Library
 
 		MATERIAL_VARIABLE_DECLARATION(SampleOffsets)
 		MATERIAL_VARIABLE_DECLARATION(SampleWeights)
+		MATERIAL_VARIABLE_DECLARATION(SampleCount)
+		MATERIAL_VARIABLE_DECLARATION(SourceTexelSize)
 
 	public:
 		GaussianBlurMaterial();
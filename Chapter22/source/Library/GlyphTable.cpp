@@ -0,0 +1,108 @@
+#include "GlyphTable.h"
+#include <stdexcept>
+
+namespace Library
+{
+	const unsigned int GlyphTable::NoGlyph = 0xFFFFFFFF;
+	const unsigned int GlyphTable::PageSize = 256;
+	const unsigned int GlyphTable::PageCount = 256;
+
+	GlyphTable::GlyphTable()
+		: mGlyphs(), mPageIndices(PageCount, 0), mPages(PageSize, NoGlyph), mSupplementaryGlyphs(), mDefaultGlyph(nullptr),
+		  mLineSpacing(0.0f), mTextureWidth(0), mTextureHeight(0)
+	{
+	}
+
+	void GlyphTable::Build(const std::vector<Glyph>& glyphs, unsigned int defaultCharacter, float lineSpacing, unsigned int textureWidth, unsigned int textureHeight)
+	{
+		mGlyphs = glyphs;
+		mLineSpacing = lineSpacing;
+		mTextureWidth = textureWidth;
+		mTextureHeight = textureHeight;
+
+		// Page 0 is the empty page every uncovered block shares
+		mPageIndices.assign(PageCount, 0);
+		mPages.assign(PageSize, NoGlyph);
+		mSupplementaryGlyphs.clear();
+		mDefaultGlyph = nullptr;
+
+		for (unsigned int i = 0; i < mGlyphs.size(); i++)
+		{
+			unsigned int character = mGlyphs[i].Character;
+			if (character >= PageSize * PageCount)
+			{
+				mSupplementaryGlyphs[character] = i;
+				continue;
+			}
+
+			unsigned short& pageIndex = mPageIndices[character / PageSize];
+			if (pageIndex == 0)
+			{
+				pageIndex = static_cast<unsigned short>(mPages.size() / PageSize);
+				mPages.resize(mPages.size() + PageSize, NoGlyph);
+			}
+
+			mPages[pageIndex * PageSize + character % PageSize] = i;
+		}
+
+		if (defaultCharacter != 0)
+		{
+			unsigned int index = FindIndex(defaultCharacter);
+			if (index == NoGlyph)
+			{
+				throw std::runtime_error("The default character is not in the font.");
+			}
+
+			mDefaultGlyph = &mGlyphs[index];
+		}
+	}
+
+	const Glyph* GlyphTable::Find(unsigned int character) const
+	{
+		unsigned int index = FindIndex(character);
+
+		return (index != NoGlyph ? &mGlyphs[index] : mDefaultGlyph);
+	}
+
+	bool GlyphTable::Contains(unsigned int character) const
+	{
+		return (FindIndex(character) != NoGlyph);
+	}
+
+	const std::vector<Glyph>& GlyphTable::Glyphs() const
+	{
+		return mGlyphs;
+	}
+
+	const Glyph* GlyphTable::DefaultGlyph() const
+	{
+		return mDefaultGlyph;
+	}
+
+	float GlyphTable::LineSpacing() const
+	{
+		return mLineSpacing;
+	}
+
+	unsigned int GlyphTable::TextureWidth() const
+	{
+		return mTextureWidth;
+	}
+
+	unsigned int GlyphTable::TextureHeight() const
+	{
+		return mTextureHeight;
+	}
+
+	unsigned int GlyphTable::FindIndex(unsigned int character) const
+	{
+		if (character < PageSize * PageCount)
+		{
+			return mPages[mPageIndices[character / PageSize] * PageSize + character % PageSize];
+		}
+
+		auto it = mSupplementaryGlyphs.find(character);
+
+		return (it != mSupplementaryGlyphs.end() ? it->second : NoGlyph);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+// Portable, like SpriteQueue: glyph lookup and text layout run without a device, so they can be benchmarked anywhere
+#include <vector>
+#include <unordered_map>
+
+namespace Library
+{
+	// A MakeSpriteFont glyph, laid out as in the .spritefont file. Subrect is left, top, right and bottom in texels.
+	typedef struct _Glyph
+	{
+		unsigned int Character;
+		int Subrect[4];
+		float XOffset;
+		float YOffset;
+		float XAdvance;
+	} Glyph;
+
+	// Finds a font's glyphs in constant time. The Basic Multilingual Plane is direct-mapped through 256-entry pages,
+	// allocated only for the blocks the font covers, and an empty page shared by the rest; characters beyond it, which
+	// UTF-16 text spells with surrogate pairs, are hashed. Characters the font lacks map to its default glyph, if any.
+	class GlyphTable
+	{
+	public:
+		GlyphTable();
+
+		// glyphs needn't be sorted; a defaultCharacter of 0 leaves missing characters without a glyph
+		void Build(const std::vector<Glyph>& glyphs, unsigned int defaultCharacter, float lineSpacing, unsigned int textureWidth, unsigned int textureHeight);
+
+		// The glyph for character, else the default glyph, else nullptr
+		const Glyph* Find(unsigned int character) const;
+		bool Contains(unsigned int character) const;
+
+		const std::vector<Glyph>& Glyphs() const;
+		const Glyph* DefaultGlyph() const;
+		float LineSpacing() const;
+		unsigned int TextureWidth() const;
+		unsigned int TextureHeight() const;
+
+		static const unsigned int NoGlyph;
+
+	private:
+		GlyphTable(const GlyphTable& rhs);
+		GlyphTable& operator=(const GlyphTable& rhs);
+
+		unsigned int FindIndex(unsigned int character) const;
+
+		static const unsigned int PageSize;
+		static const unsigned int PageCount;
+
+		std::vector<Glyph> mGlyphs;
+		std::vector<unsigned short> mPageIndices;
+		std::vector<unsigned int> mPages;
+		std::unordered_map<unsigned int, unsigned int> mSupplementaryGlyphs;
+		const Glyph* mDefaultGlyph;
+		float mLineSpacing;
+		unsigned int mTextureWidth;
+		unsigned int mTextureHeight;
+	};
+}
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "VectorHelper.h"
 #include "MatrixHelper.h"
 #include "Utility.h"
+#include "ContentManager.h"
 #include "VertexDeclarations.h"
 
 namespace Library
@@ -19,14 +20,14 @@ namespace Library
 	const XMFLOAT4 Grid::DefaultColor = XMFLOAT4(0.961f, 0.871f, 0.702f, 1.0f);
 
 	Grid::Grid(Game& game, Camera& camera)
-		: DrawableGameComponent(game), mMaterial(nullptr), mPass(nullptr), mInputLayout(nullptr), mVertexBuffer(nullptr),
+		: DrawableGameComponent(game), mEffect(), mMaterial(nullptr), mPass(nullptr), mInputLayout(nullptr), mVertexBuffer(nullptr),
 		  mPosition(Vector3Helper::Zero), mSize(DefaultSize), mScale(DefaultScale), mColor(DefaultColor), mWorldMatrix(MatrixHelper::Identity)
 	{
 		mCamera = &camera;
 	}
 
 	Grid::Grid(Game& game, Camera& camera, UINT size, UINT scale, XMFLOAT4 color)
-		: DrawableGameComponent(game), mMaterial(nullptr),  mPass(nullptr), mInputLayout(nullptr), mVertexBuffer(nullptr),
+		: DrawableGameComponent(game), mEffect(), mMaterial(nullptr),  mPass(nullptr), mInputLayout(nullptr), mVertexBuffer(nullptr),
 		  mPosition(Vector3Helper::Zero), mSize(size), mScale(scale), mColor(color), mWorldMatrix(MatrixHelper::Identity)
 	{
 		mCamera = &camera;
@@ -36,12 +37,7 @@ namespace Library
 	{
 		ReleaseObject(mVertexBuffer);
 
-		if (mMaterial != nullptr)
-		{
-			delete mMaterial->GetEffect();
-			delete mMaterial;
-			mMaterial = nullptr;
-		}
+		DeleteObject(mMaterial);
 	}
 
 	const XMFLOAT3& Grid::Position() const
@@ -104,11 +100,10 @@ namespace Library
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
-		Effect* effect = new Effect(*mGame);
-		effect->LoadCompiledEffect(L"Content\\Effects\\BasicEffect.cso");
+		mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\BasicEffect.cso");
 		
 		mMaterial = new BasicMaterial();
-		mMaterial->Initialize(*effect);
+		mMaterial->Initialize(*mEffect);
 
 		mPass = mMaterial->CurrentTechnique()->Passes().at(0);
 		mInputLayout = mMaterial->InputLayouts().at(mPass);
@@ -0,0 +1,371 @@
+#include "HiZCulling.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Utility.h"
+#include "ContentManager.h"
+#include "Effect.h"
+#include "HiZCullingMaterial.h"
+#include "HiZReference.h"
+
+namespace Library
+{
+	const UINT HiZCulling::CullThreadsPerGroup = 64;
+	const UINT HiZCulling::PyramidThreadsPerGroup = 8;
+
+	namespace
+	{
+		// UINTs in each phase's D3D11_DRAW_INDEXED_INSTANCED_INDIRECT_ARGS
+		const UINT ArgumentCount = 5;
+		const UINT MaximumComputeResourceCount = 8;
+	}
+
+	HiZCulling::HiZCulling(Game& game, UINT width, UINT height, UINT instanceStride, UINT maximumInstanceCount)
+		: mGame(&game), mWidth(width), mHeight(height), mInstanceStride(instanceStride), mMaximumInstanceCount(maximumInstanceCount),
+		  mInstanceCount(0), mIndexCount(0), mEffect(), mMaterial(nullptr), mCopyDepthPass(nullptr), mReduceDepthPass(nullptr), mCullPasses(),
+		  mBoundsBuffer(nullptr), mBoundsView(nullptr), mInstanceBuffer(nullptr), mInstanceView(nullptr), mVisibleInstanceBuffers(), mVisibleInstanceViews(),
+		  mArgumentsBuffer(nullptr), mArgumentsView(nullptr), mHistoryBuffer(nullptr), mHistoryView(nullptr),
+		  mPyramidTexture(nullptr), mLevelTextures(), mLevelOutputs()
+	{
+		assert(instanceStride > 0 && instanceStride % 4 == 0 && maximumInstanceCount > 0);
+
+		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
+
+		mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\HiZCulling.cso");
+		mMaterial = new HiZCullingMaterial();
+		mMaterial->Initialize(*mEffect);
+
+		const std::map<std::string, Technique*>& techniques = mEffect->TechniquesByName();
+		mCopyDepthPass = techniques.at("copy_depth")->PassesByName().at("p0");
+		mReduceDepthPass = techniques.at("reduce_depth")->PassesByName().at("p0");
+		mCullPasses[HiZCullingPhaseFirst] = techniques.at("cull_first_phase")->PassesByName().at("p0");
+		mCullPasses[HiZCullingPhaseSecond] = techniques.at("cull_second_phase")->PassesByName().at("p0");
+
+		ID3D11Device* direct3DDevice = mGame->Direct3DDevice();
+		HRESULT hr;
+
+		D3D11_BUFFER_DESC boundsBufferDesc;
+		ZeroMemory(&boundsBufferDesc, sizeof(boundsBufferDesc));
+		boundsBufferDesc.ByteWidth = sizeof(OcclusionBox) * maximumInstanceCount;
+		boundsBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		boundsBufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+		boundsBufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+		boundsBufferDesc.StructureByteStride = sizeof(OcclusionBox);
+
+		if (FAILED(hr = direct3DDevice->CreateBuffer(&boundsBufferDesc, nullptr, &mBoundsBuffer)))
+		{
+			throw GameException("ID3D11Device::CreateBuffer() failed.", hr);
+		}
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC boundsViewDesc;
+		ZeroMemory(&boundsViewDesc, sizeof(boundsViewDesc));
+		boundsViewDesc.Format = DXGI_FORMAT_UNKNOWN;
+		boundsViewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+		boundsViewDesc.Buffer.NumElements = maximumInstanceCount;
+
+		if (FAILED(hr = direct3DDevice->CreateShaderResourceView(mBoundsBuffer, &boundsViewDesc, &mBoundsView)))
+		{
+			throw GameException("ID3D11Device::CreateShaderResourceView() failed.", hr);
+		}
+
+		// Instance data is read and written as raw words, since its layout belongs to the caller's vertex shader
+		UINT instanceByteWidth = instanceStride * maximumInstanceCount;
+		CreateRawBuffer(instanceByteWidth, D3D11_BIND_SHADER_RESOURCE, 0, &mInstanceBuffer);
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC instanceViewDesc;
+		ZeroMemory(&instanceViewDesc, sizeof(instanceViewDesc));
+		instanceViewDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+		instanceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFEREX;
+		instanceViewDesc.BufferEx.NumElements = instanceByteWidth / 4;
+		instanceViewDesc.BufferEx.Flags = D3D11_BUFFEREX_SRV_FLAG_RAW;
+
+		if (FAILED(hr = direct3DDevice->CreateShaderResourceView(mInstanceBuffer, &instanceViewDesc, &mInstanceView)))
+		{
+			throw GameException("ID3D11Device::CreateShaderResourceView() failed.", hr);
+		}
+
+		D3D11_UNORDERED_ACCESS_VIEW_DESC rawViewDesc;
+		ZeroMemory(&rawViewDesc, sizeof(rawViewDesc));
+		rawViewDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+		rawViewDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+		rawViewDesc.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_RAW;
+
+		rawViewDesc.Buffer.NumElements = instanceByteWidth / 4;
+		for (UINT phase = 0; phase < HiZCullingPhaseEnd; phase++)
+		{
+			CreateRawBuffer(instanceByteWidth, D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_UNORDERED_ACCESS, 0, &mVisibleInstanceBuffers[phase]);
+			if (FAILED(hr = direct3DDevice->CreateUnorderedAccessView(mVisibleInstanceBuffers[phase], &rawViewDesc, &mVisibleInstanceViews[phase])))
+			{
+				throw GameException("ID3D11Device::CreateUnorderedAccessView() failed.", hr);
+			}
+		}
+
+		rawViewDesc.Buffer.NumElements = ArgumentCount * HiZCullingPhaseEnd;
+		CreateRawBuffer(sizeof(UINT) * ArgumentCount * HiZCullingPhaseEnd, D3D11_BIND_UNORDERED_ACCESS, D3D11_RESOURCE_MISC_DRAWINDIRECT_ARGS, &mArgumentsBuffer);
+		if (FAILED(hr = direct3DDevice->CreateUnorderedAccessView(mArgumentsBuffer, &rawViewDesc, &mArgumentsView)))
+		{
+			throw GameException("ID3D11Device::CreateUnorderedAccessView() failed.", hr);
+		}
+
+		rawViewDesc.Buffer.NumElements = maximumInstanceCount;
+		CreateRawBuffer(sizeof(UINT) * maximumInstanceCount, D3D11_BIND_UNORDERED_ACCESS, 0, &mHistoryBuffer);
+		if (FAILED(hr = direct3DDevice->CreateUnorderedAccessView(mHistoryBuffer, &rawViewDesc, &mHistoryView)))
+		{
+			throw GameException("ID3D11Device::CreateUnorderedAccessView() failed.", hr);
+		}
+
+		CreatePyramid();
+	}
+
+	HiZCulling::~HiZCulling()
+	{
+		for (ID3D11UnorderedAccessView* levelOutput : mLevelOutputs)
+		{
+			ReleaseObject(levelOutput);
+		}
+
+		for (ID3D11ShaderResourceView* levelTexture : mLevelTextures)
+		{
+			ReleaseObject(levelTexture);
+		}
+
+		ReleaseObject(mPyramidTexture);
+		ReleaseObject(mHistoryView);
+		ReleaseObject(mHistoryBuffer);
+		ReleaseObject(mArgumentsView);
+		ReleaseObject(mArgumentsBuffer);
+
+		for (UINT phase = 0; phase < HiZCullingPhaseEnd; phase++)
+		{
+			ReleaseObject(mVisibleInstanceViews[phase]);
+			ReleaseObject(mVisibleInstanceBuffers[phase]);
+		}
+
+		ReleaseObject(mInstanceView);
+		ReleaseObject(mInstanceBuffer);
+		ReleaseObject(mBoundsView);
+		ReleaseObject(mBoundsBuffer);
+		DeleteObject(mMaterial);
+	}
+
+	UINT HiZCulling::InstanceCount() const
+	{
+		return mInstanceCount;
+	}
+
+	UINT HiZCulling::LevelCount() const
+	{
+		return static_cast<UINT>(mLevelTextures.size());
+	}
+
+	void HiZCulling::SetInstances(const void* instanceData, const std::vector<OcclusionBox>& bounds)
+	{
+		assert(bounds.size() <= mMaximumInstanceCount);
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		mInstanceCount = static_cast<UINT>(bounds.size());
+
+		if (mInstanceCount > 0)
+		{
+			D3D11_BOX boundsBox = { 0, 0, 0, sizeof(OcclusionBox) * mInstanceCount, 1, 1 };
+			direct3DDeviceContext->UpdateSubresource(mBoundsBuffer, 0, &boundsBox, &bounds[0], 0, 0);
+
+			D3D11_BOX instanceBox = { 0, 0, 0, mInstanceStride * mInstanceCount, 1, 1 };
+			direct3DDeviceContext->UpdateSubresource(mInstanceBuffer, 0, &instanceBox, instanceData, 0, 0);
+		}
+
+		// Nothing counts as visible last frame, so the first frame draws everything in the second phase
+		static const UINT zeroes[4] = { 0, 0, 0, 0 };
+		direct3DDeviceContext->ClearUnorderedAccessViewUint(mHistoryView, zeroes);
+	}
+
+	void HiZCulling::SetIndexCount(UINT indexCount)
+	{
+		mIndexCount = indexCount;
+	}
+
+	void HiZCulling::CullFirstPhase(CXMMATRIX viewProjectionMatrix)
+	{
+		ResetArguments();
+		Cull(HiZCullingPhaseFirst, viewProjectionMatrix);
+	}
+
+	void HiZCulling::BuildPyramid(ID3D11ShaderResourceView* depthTexture)
+	{
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+
+		for (UINT level = 0; level < mLevelOutputs.size(); level++)
+		{
+			UINT levelWidth = max(mWidth >> level, 1U);
+			UINT levelHeight = max(mHeight >> level, 1U);
+
+			mMaterial->SourceDepth() << (level == 0 ? depthTexture : mLevelTextures[level - 1]);
+			mMaterial->OutputDepth() << mLevelOutputs[level];
+			(level == 0 ? mCopyDepthPass : mReduceDepthPass)->Apply(0, direct3DDeviceContext);
+
+			direct3DDeviceContext->Dispatch((levelWidth + PyramidThreadsPerGroup - 1) / PyramidThreadsPerGroup, (levelHeight + PyramidThreadsPerGroup - 1) / PyramidThreadsPerGroup, 1);
+			UnbindComputeResources();
+		}
+	}
+
+	void HiZCulling::CullSecondPhase(CXMMATRIX viewProjectionMatrix)
+	{
+		Cull(HiZCullingPhaseSecond, viewProjectionMatrix);
+	}
+
+	void HiZCulling::Draw(HiZCullingPhase phase, UINT instanceSlot)
+	{
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		UINT offset = 0;
+
+		direct3DDeviceContext->IASetVertexBuffers(instanceSlot, 1, &mVisibleInstanceBuffers[phase], &mInstanceStride, &offset);
+		direct3DDeviceContext->DrawIndexedInstancedIndirect(mArgumentsBuffer, ArgumentsOffset(phase));
+	}
+
+	ID3D11Buffer* HiZCulling::VisibleInstanceBuffer(HiZCullingPhase phase) const
+	{
+		return mVisibleInstanceBuffers[phase];
+	}
+
+	ID3D11Buffer* HiZCulling::ArgumentsBuffer() const
+	{
+		return mArgumentsBuffer;
+	}
+
+	UINT HiZCulling::ArgumentsOffset(HiZCullingPhase phase) const
+	{
+		return sizeof(UINT) * ArgumentCount * phase;
+	}
+
+	ID3D11ShaderResourceView* HiZCulling::PyramidTexture() const
+	{
+		return mPyramidTexture;
+	}
+
+	void HiZCulling::CreateRawBuffer(UINT byteWidth, UINT bindFlags, UINT miscFlags, ID3D11Buffer** buffer)
+	{
+		D3D11_BUFFER_DESC bufferDesc;
+		ZeroMemory(&bufferDesc, sizeof(bufferDesc));
+		bufferDesc.ByteWidth = byteWidth;
+		bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		bufferDesc.BindFlags = bindFlags;
+		bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS | miscFlags;
+
+		HRESULT hr;
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateBuffer(&bufferDesc, nullptr, buffer)))
+		{
+			throw GameException("ID3D11Device::CreateBuffer() failed.", hr);
+		}
+	}
+
+	void HiZCulling::CreatePyramid()
+	{
+		UINT levelCount = HiZReference::LevelCount(mWidth, mHeight);
+
+		D3D11_TEXTURE2D_DESC textureDesc;
+		ZeroMemory(&textureDesc, sizeof(textureDesc));
+		textureDesc.Width = mWidth;
+		textureDesc.Height = mHeight;
+		textureDesc.MipLevels = levelCount;
+		textureDesc.ArraySize = 1;
+		textureDesc.Format = DXGI_FORMAT_R32_FLOAT;
+		textureDesc.SampleDesc.Count = 1;
+		textureDesc.SampleDesc.Quality = 0;
+		textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+
+		HRESULT hr;
+		ID3D11Texture2D* texture = nullptr;
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateTexture2D(&textureDesc, nullptr, &texture)))
+		{
+			throw GameException("IDXGIDevice::CreateTexture2D() failed.", hr);
+		}
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC resourceViewDesc;
+		ZeroMemory(&resourceViewDesc, sizeof(resourceViewDesc));
+		resourceViewDesc.Format = DXGI_FORMAT_R32_FLOAT;
+		resourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+		resourceViewDesc.Texture2D.MipLevels = levelCount;
+
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateShaderResourceView(texture, &resourceViewDesc, &mPyramidTexture)))
+		{
+			ReleaseObject(texture);
+			throw GameException("IDXGIDevice::CreateShaderResourceView() failed.", hr);
+		}
+
+		// One view per level, so each reduction reads the level above the one it writes
+		mLevelTextures.resize(levelCount, nullptr);
+		mLevelOutputs.resize(levelCount, nullptr);
+		for (UINT level = 0; level < levelCount; level++)
+		{
+			resourceViewDesc.Texture2D.MostDetailedMip = level;
+			resourceViewDesc.Texture2D.MipLevels = 1;
+
+			if (FAILED(hr = mGame->Direct3DDevice()->CreateShaderResourceView(texture, &resourceViewDesc, &mLevelTextures[level])))
+			{
+				ReleaseObject(texture);
+				throw GameException("IDXGIDevice::CreateShaderResourceView() failed.", hr);
+			}
+
+			D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc;
+			ZeroMemory(&uavDesc, sizeof(uavDesc));
+			uavDesc.Format = DXGI_FORMAT_R32_FLOAT;
+			uavDesc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
+			uavDesc.Texture2D.MipSlice = level;
+
+			if (FAILED(hr = mGame->Direct3DDevice()->CreateUnorderedAccessView(texture, &uavDesc, &mLevelOutputs[level])))
+			{
+				ReleaseObject(texture);
+				throw GameException("IDXGIDevice::CreateUnorderedAccessView() failed.", hr);
+			}
+		}
+
+		ReleaseObject(texture);
+	}
+
+	void HiZCulling::ResetArguments()
+	{
+		UINT arguments[ArgumentCount * HiZCullingPhaseEnd] = { 0 };
+		for (UINT phase = 0; phase < HiZCullingPhaseEnd; phase++)
+		{
+			arguments[phase * ArgumentCount] = mIndexCount;
+		}
+
+		mGame->Direct3DDeviceContext()->UpdateSubresource(mArgumentsBuffer, 0, nullptr, arguments, 0, 0);
+	}
+
+	void HiZCulling::Cull(HiZCullingPhase phase, CXMMATRIX viewProjectionMatrix)
+	{
+		if (mInstanceCount == 0)
+		{
+			return;
+		}
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+
+		mMaterial->ViewProjection() << viewProjectionMatrix;
+		mMaterial->InstanceCount() << static_cast<int>(mInstanceCount);
+		mMaterial->InstanceStride() << static_cast<int>(mInstanceStride);
+		mMaterial->HiZSize() << XMVectorSet(static_cast<float>(mWidth), static_cast<float>(mHeight), 0.0f, 0.0f);
+		mMaterial->HiZLevelCount() << static_cast<int>(LevelCount());
+		mMaterial->HiZTexture() << mPyramidTexture;
+		mMaterial->InstanceBounds() << mBoundsView;
+		mMaterial->Instances() << mInstanceView;
+		mMaterial->VisibleInstances() << mVisibleInstanceViews[phase];
+		mMaterial->DrawArguments() << mArgumentsView;
+		mMaterial->VisibilityHistory() << mHistoryView;
+		mCullPasses[phase]->Apply(0, direct3DDeviceContext);
+
+		direct3DDeviceContext->Dispatch((mInstanceCount + CullThreadsPerGroup - 1) / CullThreadsPerGroup, 1, 1);
+		UnbindComputeResources();
+	}
+
+	void HiZCulling::UnbindComputeResources()
+	{
+		// Unbind everything the passes used, so the visible instances can be drawn and the next level written
+		static ID3D11UnorderedAccessView* emptyUAVs[MaximumComputeResourceCount] = { nullptr };
+		static ID3D11ShaderResourceView* emptySRVs[MaximumComputeResourceCount] = { nullptr };
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		direct3DDeviceContext->CSSetUnorderedAccessViews(0, MaximumComputeResourceCount, emptyUAVs, nullptr);
+		direct3DDeviceContext->CSSetShaderResources(0, MaximumComputeResourceCount, emptySRVs);
+	}
+}
\ No newline at end of file
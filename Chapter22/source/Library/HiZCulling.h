@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Common.h"
+#include "OcclusionBuffer.h"
+
+namespace Library
+{
+	class Game;
+	class Effect;
+	class Pass;
+	class HiZCullingMaterial;
+
+	enum HiZCullingPhase
+	{
+		HiZCullingPhaseFirst = 0,
+		HiZCullingPhaseSecond,
+		HiZCullingPhaseEnd
+	};
+
+	// Culls an instanced draw on the GPU in two phases, following HiZReference:
+	//
+	//	CullFirstPhase(viewProjection);		last frame's visible instances, frustum tested
+	//	Draw(HiZCullingPhaseFirst, ...);	into the depth buffer the pyramid is built from
+	//	BuildPyramid(depthTexture);
+	//	CullSecondPhase(viewProjection);	everything, tested against the pyramid
+	//	Draw(HiZCullingPhaseSecond, ...);	instances that just became visible
+	//
+	// Each phase copies its visible instances' raw data into a buffer bound as an instance vertex buffer, so existing
+	// per-instance input layouts (such as InstancingMaterial's) draw them unchanged, and counts them straight into the
+	// arguments of DrawIndexedInstancedIndirect. The CPU never sees the visible set.
+	class HiZCulling
+	{
+	public:
+		HiZCulling(Game& game, UINT width, UINT height, UINT instanceStride, UINT maximumInstanceCount);
+		~HiZCulling();
+
+		UINT InstanceCount() const;
+		UINT LevelCount() const;
+
+		// Instance data is instanceStride bytes per instance; bounds are world-space boxes. Visibility history restarts.
+		void SetInstances(const void* instanceData, const std::vector<OcclusionBox>& bounds);
+		void SetIndexCount(UINT indexCount);
+
+		void CullFirstPhase(CXMMATRIX viewProjectionMatrix);
+		void BuildPyramid(ID3D11ShaderResourceView* depthTexture);
+		void CullSecondPhase(CXMMATRIX viewProjectionMatrix);
+
+		// Binds the phase's visible instances to instanceSlot and draws them; the caller sets up everything else
+		void Draw(HiZCullingPhase phase, UINT instanceSlot);
+
+		ID3D11Buffer* VisibleInstanceBuffer(HiZCullingPhase phase) const;
+		ID3D11Buffer* ArgumentsBuffer() const;
+		UINT ArgumentsOffset(HiZCullingPhase phase) const;
+		ID3D11ShaderResourceView* PyramidTexture() const;
+
+		static const UINT CullThreadsPerGroup;
+		static const UINT PyramidThreadsPerGroup;
+
+	private:
+		HiZCulling();
+		HiZCulling(const HiZCulling& rhs);
+		HiZCulling& operator=(const HiZCulling& rhs);
+
+		void CreateRawBuffer(UINT byteWidth, UINT bindFlags, UINT miscFlags, ID3D11Buffer** buffer);
+		void CreatePyramid();
+		void ResetArguments();
+		void Cull(HiZCullingPhase phase, CXMMATRIX viewProjectionMatrix);
+		void UnbindComputeResources();
+
+		Game* mGame;
+		UINT mWidth;
+		UINT mHeight;
+		UINT mInstanceStride;
+		UINT mMaximumInstanceCount;
+		UINT mInstanceCount;
+		UINT mIndexCount;
+
+		std::shared_ptr<Effect> mEffect;
+		HiZCullingMaterial* mMaterial;
+		Pass* mCopyDepthPass;
+		Pass* mReduceDepthPass;
+		Pass* mCullPasses[HiZCullingPhaseEnd];
+
+		ID3D11Buffer* mBoundsBuffer;
+		ID3D11ShaderResourceView* mBoundsView;
+		ID3D11Buffer* mInstanceBuffer;
+		ID3D11ShaderResourceView* mInstanceView;
+		ID3D11Buffer* mVisibleInstanceBuffers[HiZCullingPhaseEnd];
+		ID3D11UnorderedAccessView* mVisibleInstanceViews[HiZCullingPhaseEnd];
+		ID3D11Buffer* mArgumentsBuffer;
+		ID3D11UnorderedAccessView* mArgumentsView;
+		ID3D11Buffer* mHistoryBuffer;
+		ID3D11UnorderedAccessView* mHistoryView;
+
+		ID3D11ShaderResourceView* mPyramidTexture;
+		std::vector<ID3D11ShaderResourceView*> mLevelTextures;
+		std::vector<ID3D11UnorderedAccessView*> mLevelOutputs;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "HiZCullingMaterial.h"
+#include "GameException.h"
+
+namespace Library
+{
+	RTTI_DEFINITIONS(HiZCullingMaterial)
+
+	HiZCullingMaterial::HiZCullingMaterial()
+		: Material("cull_second_phase"),
+		  MATERIAL_VARIABLE_INITIALIZATION(ViewProjection), MATERIAL_VARIABLE_INITIALIZATION(InstanceCount),
+		  MATERIAL_VARIABLE_INITIALIZATION(InstanceStride), MATERIAL_VARIABLE_INITIALIZATION(HiZSize),
+		  MATERIAL_VARIABLE_INITIALIZATION(HiZLevelCount), MATERIAL_VARIABLE_INITIALIZATION(SourceDepth),
+		  MATERIAL_VARIABLE_INITIALIZATION(OutputDepth), MATERIAL_VARIABLE_INITIALIZATION(HiZTexture),
+		  MATERIAL_VARIABLE_INITIALIZATION(InstanceBounds), MATERIAL_VARIABLE_INITIALIZATION(Instances),
+		  MATERIAL_VARIABLE_INITIALIZATION(VisibleInstances), MATERIAL_VARIABLE_INITIALIZATION(DrawArguments),
+		  MATERIAL_VARIABLE_INITIALIZATION(VisibilityHistory)
+	{
+	}
+
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, ViewProjection)
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, InstanceCount)
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, InstanceStride)
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, HiZSize)
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, HiZLevelCount)
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, SourceDepth)
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, OutputDepth)
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, HiZTexture)
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, InstanceBounds)
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, Instances)
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, VisibleInstances)
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, DrawArguments)
+	MATERIAL_VARIABLE_DEFINITION(HiZCullingMaterial, VisibilityHistory)
+
+	void HiZCullingMaterial::Initialize(Effect& effect)
+	{
+		Material::Initialize(effect);
+
+		MATERIAL_VARIABLE_RETRIEVE(ViewProjection)
+		MATERIAL_VARIABLE_RETRIEVE(InstanceCount)
+		MATERIAL_VARIABLE_RETRIEVE(InstanceStride)
+		MATERIAL_VARIABLE_RETRIEVE(HiZSize)
+		MATERIAL_VARIABLE_RETRIEVE(HiZLevelCount)
+		MATERIAL_VARIABLE_RETRIEVE(SourceDepth)
+		MATERIAL_VARIABLE_RETRIEVE(OutputDepth)
+		MATERIAL_VARIABLE_RETRIEVE(HiZTexture)
+		MATERIAL_VARIABLE_RETRIEVE(InstanceBounds)
+		MATERIAL_VARIABLE_RETRIEVE(Instances)
+		MATERIAL_VARIABLE_RETRIEVE(VisibleInstances)
+		MATERIAL_VARIABLE_RETRIEVE(DrawArguments)
+		MATERIAL_VARIABLE_RETRIEVE(VisibilityHistory)
+	}
+
+	void HiZCullingMaterial::CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
+	{
+		throw GameException("HiZCullingMaterial has no vertex shaders.");
+	}
+
+	UINT HiZCullingMaterial::VertexSize() const
+	{
+		return 0;
+	}
+}
\ No newline at end of file
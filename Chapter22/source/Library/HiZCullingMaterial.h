@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Common.h"
+#include "Material.h"
+
+namespace Library
+{
+	// HiZCulling.fx has only compute shaders, so there are no input layouts or vertex buffers to create
+	class HiZCullingMaterial : public Material
+	{
+		RTTI_DECLARATIONS(HiZCullingMaterial, Material)
+
+		MATERIAL_VARIABLE_DECLARATION(ViewProjection)
+		MATERIAL_VARIABLE_DECLARATION(InstanceCount)
+		MATERIAL_VARIABLE_DECLARATION(InstanceStride)
+		MATERIAL_VARIABLE_DECLARATION(HiZSize)
+		MATERIAL_VARIABLE_DECLARATION(HiZLevelCount)
+
+		MATERIAL_VARIABLE_DECLARATION(SourceDepth)
+		MATERIAL_VARIABLE_DECLARATION(OutputDepth)
+		MATERIAL_VARIABLE_DECLARATION(HiZTexture)
+
+		MATERIAL_VARIABLE_DECLARATION(InstanceBounds)
+		MATERIAL_VARIABLE_DECLARATION(Instances)
+		MATERIAL_VARIABLE_DECLARATION(VisibleInstances)
+		MATERIAL_VARIABLE_DECLARATION(DrawArguments)
+		MATERIAL_VARIABLE_DECLARATION(VisibilityHistory)
+
+	public:
+		HiZCullingMaterial();
+
+		virtual void Initialize(Effect& effect) override;
+		virtual void CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const override;
+		virtual UINT VertexSize() const override;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "HiZReference.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Library
+{
+	void HiZReference::BuildPyramid(const std::vector<float>& depth, unsigned int width, unsigned int height, std::vector<HiZLevel>& levels)
+	{
+		assert(depth.size() == width * height);
+
+		levels.resize(LevelCount(width, height));
+		levels[0].Width = width;
+		levels[0].Height = height;
+		levels[0].Depth = depth;
+
+		for (size_t level = 1; level < levels.size(); level++)
+		{
+			const HiZLevel& source = levels[level - 1];
+			HiZLevel& destination = levels[level];
+			destination.Width = std::max(source.Width / 2, 1U);
+			destination.Height = std::max(source.Height / 2, 1U);
+			destination.Depth.resize(destination.Width * destination.Height);
+
+			for (unsigned int y = 0; y < destination.Height; y++)
+			{
+				unsigned int lastY = (y == destination.Height - 1 ? source.Height - 1 : y * 2 + 1);
+				for (unsigned int x = 0; x < destination.Width; x++)
+				{
+					unsigned int lastX = (x == destination.Width - 1 ? source.Width - 1 : x * 2 + 1);
+
+					float farthest = 0.0f;
+					for (unsigned int sourceY = y * 2; sourceY <= lastY; sourceY++)
+					{
+						for (unsigned int sourceX = x * 2; sourceX <= lastX; sourceX++)
+						{
+							farthest = std::max(farthest, source.Depth[sourceY * source.Width + sourceX]);
+						}
+					}
+
+					destination.Depth[y * destination.Width + x] = farthest;
+				}
+			}
+		}
+	}
+
+	OcclusionResult HiZReference::TestBox(const std::vector<HiZLevel>& levels, const OcclusionBox& box, const float* viewProjectionMatrix)
+	{
+		OcclusionResult result;
+		unsigned int rectangle[4];
+		float minimumDepth;
+		if (ProjectBox(box, viewProjectionMatrix, levels[0].Width, levels[0].Height, result, rectangle, minimumDepth) == false)
+		{
+			return result;
+		}
+
+		// The smallest level where the rectangle spans at most two texels each way
+		unsigned int span = std::max(rectangle[2] - rectangle[0], rectangle[3] - rectangle[1]) + 1;
+		unsigned int level = 0;
+		while ((1U << level) < span)
+		{
+			level++;
+		}
+
+		level = std::min(level, static_cast<unsigned int>(levels.size()) - 1);
+		const HiZLevel& hiZ = levels[level];
+		unsigned int minimumX = std::min(rectangle[0] >> level, hiZ.Width - 1);
+		unsigned int minimumY = std::min(rectangle[1] >> level, hiZ.Height - 1);
+		unsigned int maximumX = std::min(rectangle[2] >> level, hiZ.Width - 1);
+		unsigned int maximumY = std::min(rectangle[3] >> level, hiZ.Height - 1);
+
+		float farthest = 0.0f;
+		for (unsigned int y = minimumY; y <= maximumY; y++)
+		{
+			for (unsigned int x = minimumX; x <= maximumX; x++)
+			{
+				farthest = std::max(farthest, hiZ.Depth[y * hiZ.Width + x]);
+			}
+		}
+
+		return (minimumDepth > farthest ? OcclusionResultOccluded : OcclusionResultVisible);
+	}
+
+	void HiZReference::CullFirstPhase(const std::vector<OcclusionBox>& boxes, const float* viewProjectionMatrix, const std::vector<unsigned char>& history, std::vector<unsigned int>& visibleInstances)
+	{
+		assert(history.size() == boxes.size());
+		visibleInstances.clear();
+
+		for (unsigned int i = 0; i < boxes.size(); i++)
+		{
+			OcclusionResult result = OcclusionResultVisible;
+			unsigned int rectangle[4];
+			float minimumDepth;
+			if (history[i] != 0 && (ProjectBox(boxes[i], viewProjectionMatrix, 1, 1, result, rectangle, minimumDepth) || result == OcclusionResultVisible))
+			{
+				visibleInstances.push_back(i);
+			}
+		}
+	}
+
+	void HiZReference::CullSecondPhase(const std::vector<HiZLevel>& levels, const std::vector<OcclusionBox>& boxes, const float* viewProjectionMatrix,
+		std::vector<unsigned char>& history, std::vector<unsigned int>& visibleInstances)
+	{
+		assert(history.size() == boxes.size());
+		visibleInstances.clear();
+
+		for (unsigned int i = 0; i < boxes.size(); i++)
+		{
+			bool isVisible = (TestBox(levels, boxes[i], viewProjectionMatrix) == OcclusionResultVisible);
+			if (isVisible && history[i] == 0)
+			{
+				visibleInstances.push_back(i);
+			}
+
+			history[i] = (isVisible ? 1 : 0);
+		}
+	}
+
+	unsigned int HiZReference::LevelCount(unsigned int width, unsigned int height)
+	{
+		unsigned int levelCount = 1;
+		for (unsigned int size = std::max(width, height); size > 1; size /= 2)
+		{
+			levelCount++;
+		}
+
+		return levelCount;
+	}
+
+	bool HiZReference::ProjectBox(const OcclusionBox& box, const float* viewProjectionMatrix, unsigned int width, unsigned int height, OcclusionResult& result,
+		unsigned int rectangle[4], float& minimumDepth)
+	{
+		float minimumX = 1e30f;
+		float minimumY = 1e30f;
+		float maximumX = -1e30f;
+		float maximumY = -1e30f;
+		unsigned int outside[4] = { 0, 0, 0, 0 };
+		minimumDepth = 1e30f;
+
+		for (unsigned int corner = 0; corner < 8; corner++)
+		{
+			float position[3] = { (corner & 1 ? box.Maximum[0] : box.Minimum[0]), (corner & 2 ? box.Maximum[1] : box.Minimum[1]), (corner & 4 ? box.Maximum[2] : box.Minimum[2]) };
+			float clip[4];
+			for (int i = 0; i < 4; i++)
+			{
+				clip[i] = position[0] * viewProjectionMatrix[i] + position[1] * viewProjectionMatrix[4 + i] + position[2] * viewProjectionMatrix[8 + i] + viewProjectionMatrix[12 + i];
+			}
+
+			if (clip[2] <= 0.0f)
+			{
+				result = OcclusionResultVisible;
+				return false;
+			}
+
+			outside[0] += (clip[0] < -clip[3] ? 1 : 0);
+			outside[1] += (clip[0] > clip[3] ? 1 : 0);
+			outside[2] += (clip[1] < -clip[3] ? 1 : 0);
+			outside[3] += (clip[1] > clip[3] ? 1 : 0);
+
+			float x = clip[0] / clip[3] * 0.5f + 0.5f;
+			float y = 0.5f - clip[1] / clip[3] * 0.5f;
+			minimumX = std::min(minimumX, x);
+			maximumX = std::max(maximumX, x);
+			minimumY = std::min(minimumY, y);
+			maximumY = std::max(maximumY, y);
+			minimumDepth = std::min(minimumDepth, clip[2] / clip[3]);
+		}
+
+		if (outside[0] == 8 || outside[1] == 8 || outside[2] == 8 || outside[3] == 8 || minimumDepth > 1.0f)
+		{
+			result = OcclusionResultViewCulled;
+			return false;
+		}
+
+		// Inclusive texel rectangle of level 0, clamped to the screen
+		rectangle[0] = static_cast<unsigned int>(std::min(std::max(minimumX * width, 0.0f), width - 1.0f));
+		rectangle[1] = static_cast<unsigned int>(std::min(std::max(minimumY * height, 0.0f), height - 1.0f));
+		rectangle[2] = std::max(static_cast<unsigned int>(std::min(std::max(ceilf(maximumX * width) - 1.0f, 0.0f), width - 1.0f)), rectangle[0]);
+		rectangle[3] = std::max(static_cast<unsigned int>(std::min(std::max(ceilf(maximumY * height) - 1.0f, 0.0f), height - 1.0f)), rectangle[1]);
+		result = OcclusionResultVisible;
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+// CPU version of HiZCulling.fx, portable like BlurReference; GPU results can be compared against it instance for instance
+#include <vector>
+#include "OcclusionBuffer.h"
+
+namespace Library
+{
+	typedef struct _HiZLevel
+	{
+		unsigned int Width;
+		unsigned int Height;
+		std::vector<float> Depth;
+	} HiZLevel;
+
+	// Level sizes follow D3D11 mip sizes, halving with truncation down to 1x1. Each texel holds the farthest depth
+	// of the texels below it, and the last row and column of an odd-sized level fold into their neighbours.
+	//
+	// Culling runs in two phases. The first draws last frame's visible instances, which are only frustum tested;
+	// the pyramid is then built from that depth, and the second phase tests every instance against it, draws
+	// the ones that became visible and records the visibility for the next frame.
+	class HiZReference
+	{
+	public:
+		static void BuildPyramid(const std::vector<float>& depth, unsigned int width, unsigned int height, std::vector<HiZLevel>& levels);
+		static OcclusionResult TestBox(const std::vector<HiZLevel>& levels, const OcclusionBox& box, const float* viewProjectionMatrix);
+
+		static void CullFirstPhase(const std::vector<OcclusionBox>& boxes, const float* viewProjectionMatrix, const std::vector<unsigned char>& history, std::vector<unsigned int>& visibleInstances);
+		static void CullSecondPhase(const std::vector<HiZLevel>& levels, const std::vector<OcclusionBox>& boxes, const float* viewProjectionMatrix,
+			std::vector<unsigned char>& history, std::vector<unsigned int>& visibleInstances);
+
+		static unsigned int LevelCount(unsigned int width, unsigned int height);
+
+	private:
+		HiZReference();
+		HiZReference(const HiZReference& rhs);
+		HiZReference& operator=(const HiZReference& rhs);
+
+		static bool ProjectBox(const OcclusionBox& box, const float* viewProjectionMatrix, unsigned int width, unsigned int height, OcclusionResult& result,
+			unsigned int rectangle[4], float& minimumDepth);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "ImageComparison.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace Library
+{
+	ImageDifference ImageComparison::Compare(const unsigned char* expected, const unsigned char* actual, unsigned int width, unsigned int height,
+		unsigned int tolerance, std::vector<unsigned char>* differenceImage)
+	{
+		ImageDifference difference = { 0, 0, 0.0 };
+		size_t pixelCount = static_cast<size_t>(width) * height;
+		if (differenceImage != nullptr)
+		{
+			differenceImage->resize(pixelCount * 4);
+		}
+
+		unsigned long long sumOfSquares = 0;
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			const unsigned char* expectedPixel = expected + i * 4;
+			const unsigned char* actualPixel = actual + i * 4;
+
+			unsigned int pixelDifference = 0;
+			for (unsigned int channel = 0; channel < 4; channel++)
+			{
+				unsigned int channelDifference = static_cast<unsigned int>(abs(static_cast<int>(expectedPixel[channel]) - actualPixel[channel]));
+				pixelDifference = std::max(pixelDifference, channelDifference);
+				sumOfSquares += channelDifference * channelDifference;
+			}
+
+			bool isDifferent = (pixelDifference > tolerance);
+			difference.MaximumDifference = std::max(difference.MaximumDifference, pixelDifference);
+			difference.DifferentPixelCount += (isDifferent ? 1 : 0);
+
+			if (differenceImage != nullptr)
+			{
+				unsigned char* output = &(*differenceImage)[i * 4];
+				unsigned char grey = static_cast<unsigned char>((actualPixel[0] + actualPixel[1] * 2 + actualPixel[2]) / 16);
+				output[0] = (isDifferent ? 255 : grey);
+				output[1] = grey;
+				output[2] = grey;
+				output[3] = 255;
+			}
+		}
+
+		difference.RootMeanSquare = (pixelCount > 0 ? sqrt(static_cast<double>(sumOfSquares) / (pixelCount * 4)) : 0.0);
+
+		return difference;
+	}
+
+	void ImageComparison::SwapRedBlue(std::vector<unsigned char>& pixels)
+	{
+		for (size_t i = 0; i + 3 < pixels.size(); i += 4)
+		{
+			std::swap(pixels[i], pixels[i + 2]);
+		}
+	}
+}
\ No newline at end of file
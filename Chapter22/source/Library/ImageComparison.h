@@ -0,0 +1,33 @@
+#pragma once
+
+// Portable, like PNGWriter: golden images are compared by CaptureTool, on Linux as well as Windows
+#include <vector>
+
+namespace Library
+{
+	// Channel differences are in 8-bit steps, over red, green, blue and alpha
+	typedef struct _ImageDifference
+	{
+		unsigned int MaximumDifference;
+		unsigned int DifferentPixelCount;
+		double RootMeanSquare;
+	} ImageDifference;
+
+	// Compares a rendered frame with its golden image. A pixel differs when any channel is more than tolerance steps off,
+	// which absorbs the rounding GPUs and WARP are allowed to differ by, while the count and maximum still catch a
+	// broken pass. Both images are width x height 8-bit RGBA, tightly packed; convert BGRA captures first.
+	class ImageComparison
+	{
+	public:
+		// The difference image, if asked for, is RGBA: the actual image dimmed to grey, with differing pixels in red
+		static ImageDifference Compare(const unsigned char* expected, const unsigned char* actual, unsigned int width, unsigned int height,
+			unsigned int tolerance, std::vector<unsigned char>* differenceImage = nullptr);
+
+		static void SwapRedBlue(std::vector<unsigned char>& pixels);
+
+	private:
+		ImageComparison();
+		ImageComparison(const ImageComparison& rhs);
+		ImageComparison& operator=(const ImageComparison& rhs);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,350 @@
+#include "LightClusters.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <xmmintrin.h>
+
+namespace Library
+{
+	const unsigned int LightClusters::DefaultTileCountX = 16;
+	const unsigned int LightClusters::DefaultTileCountY = 9;
+	const unsigned int LightClusters::DefaultSliceCount = 24;
+
+	LightClusters::LightClusters(unsigned int tileCountX, unsigned int tileCountY, unsigned int sliceCount)
+		: mTileCountX(tileCountX), mTileCountY(tileCountY), mSliceCount(sliceCount), mTanHalfFieldOfViewX(0.0f), mTanHalfFieldOfViewY(0.0f),
+		  mNearPlaneDistance(0.0f), mFarPlaneDistance(0.0f), mSliceScale(0.0f), mSliceBias(0.0f),
+		  mMinimumX(), mMinimumY(), mMinimumZ(), mMaximumX(), mMaximumY(), mMaximumZ(),
+		  mLightRanges(), mSliceHits(sliceCount), mSliceIndices(sliceCount), mRanges(ClusterCount()), mLightIndices(), mMaximumLightsPerCluster(0)
+	{
+		assert(tileCountX > 0 && tileCountY > 0 && sliceCount > 0);
+	}
+
+	unsigned int LightClusters::TileCountX() const
+	{
+		return mTileCountX;
+	}
+
+	unsigned int LightClusters::TileCountY() const
+	{
+		return mTileCountY;
+	}
+
+	unsigned int LightClusters::SliceCount() const
+	{
+		return mSliceCount;
+	}
+
+	unsigned int LightClusters::ClusterCount() const
+	{
+		return mTileCountX * mTileCountY * mSliceCount;
+	}
+
+	void LightClusters::SetProjection(float fieldOfView, float aspectRatio, float nearPlaneDistance, float farPlaneDistance)
+	{
+		assert(nearPlaneDistance > 0.0f && farPlaneDistance > nearPlaneDistance);
+
+		mTanHalfFieldOfViewY = tanf(fieldOfView * 0.5f);
+		mTanHalfFieldOfViewX = mTanHalfFieldOfViewY * aspectRatio;
+		mNearPlaneDistance = nearPlaneDistance;
+		mFarPlaneDistance = farPlaneDistance;
+
+		float depthRange = log2f(farPlaneDistance / nearPlaneDistance);
+		mSliceScale = mSliceCount / depthRange;
+		mSliceBias = -(mSliceCount * log2f(nearPlaneDistance)) / depthRange;
+
+		unsigned int paddedCount = ClusterCount() + 3;
+		mMinimumX.assign(paddedCount, 0.0f);
+		mMinimumY.assign(paddedCount, 0.0f);
+		mMinimumZ.assign(paddedCount, 0.0f);
+		mMaximumX.assign(paddedCount, 0.0f);
+		mMaximumY.assign(paddedCount, 0.0f);
+		mMaximumZ.assign(paddedCount, 0.0f);
+
+		for (unsigned int slice = 0; slice < mSliceCount; slice++)
+		{
+			float nearDepth = SliceDepth(slice);
+			float farDepth = SliceDepth(slice + 1);
+
+			for (unsigned int y = 0; y < mTileCountY; y++)
+			{
+				float top = (1.0f - 2.0f * y / mTileCountY) * mTanHalfFieldOfViewY;
+				float bottom = (1.0f - 2.0f * (y + 1) / mTileCountY) * mTanHalfFieldOfViewY;
+
+				for (unsigned int x = 0; x < mTileCountX; x++)
+				{
+					float left = (2.0f * x / mTileCountX - 1.0f) * mTanHalfFieldOfViewX;
+					float right = (2.0f * (x + 1) / mTileCountX - 1.0f) * mTanHalfFieldOfViewX;
+
+					// The froxel widens with depth, so its box spans the tile at both ends of the slice
+					unsigned int cluster = (slice * mTileCountY + y) * mTileCountX + x;
+					mMinimumX[cluster] = std::min(left * nearDepth, left * farDepth);
+					mMaximumX[cluster] = std::max(right * nearDepth, right * farDepth);
+					mMinimumY[cluster] = std::min(bottom * nearDepth, bottom * farDepth);
+					mMaximumY[cluster] = std::max(top * nearDepth, top * farDepth);
+					mMinimumZ[cluster] = nearDepth;
+					mMaximumZ[cluster] = farDepth;
+				}
+			}
+		}
+	}
+
+	float LightClusters::SliceScale() const
+	{
+		return mSliceScale;
+	}
+
+	float LightClusters::SliceBias() const
+	{
+		return mSliceBias;
+	}
+
+	unsigned int LightClusters::SliceIndex(float depth) const
+	{
+		if (depth <= mNearPlaneDistance)
+		{
+			return 0;
+		}
+
+		float slice = log2f(depth) * mSliceScale + mSliceBias;
+		return std::min(static_cast<unsigned int>(slice), mSliceCount - 1);
+	}
+
+	void LightClusters::Build(const std::vector<ClusterLight>& lights, ThreadPool* threadPool)
+	{
+		assert(mMinimumX.empty() == false);
+
+		unsigned int lightCount = static_cast<unsigned int>(lights.size());
+		mLightRanges.resize(lightCount);
+
+		auto computeLightRanges = [this, &lights](unsigned int begin, unsigned int end)
+		{
+			for (unsigned int i = begin; i < end; i++)
+			{
+				LightSliceRange& range = mLightRanges[i];
+				BoundingSphere(lights[i], range.Center, range.Radius);
+
+				float nearDepth = range.Center[2] - range.Radius;
+				float farDepth = range.Center[2] + range.Radius;
+				if (farDepth < mNearPlaneDistance || nearDepth > mFarPlaneDistance)
+				{
+					range.SliceBegin = range.SliceEnd = 0;
+				}
+				else
+				{
+					range.SliceBegin = SliceIndex(nearDepth);
+					range.SliceEnd = SliceIndex(std::min(farDepth, mFarPlaneDistance)) + 1;
+				}
+			}
+		};
+
+		auto buildSlices = [this, &lights](unsigned int begin, unsigned int end)
+		{
+			BuildSlices(lights, begin, end);
+		};
+
+		if (threadPool != nullptr)
+		{
+			threadPool->ParallelFor(0, lightCount, computeLightRanges, 256);
+			threadPool->ParallelFor(0, mSliceCount, buildSlices);
+		}
+		else
+		{
+			computeLightRanges(0, lightCount);
+			buildSlices(0, mSliceCount);
+		}
+
+		// Slices were compacted independently; rebase their offsets onto one index list
+		unsigned int clustersPerSlice = mTileCountX * mTileCountY;
+		unsigned int indexCount = 0;
+		mMaximumLightsPerCluster = 0;
+		for (unsigned int slice = 0; slice < mSliceCount; slice++)
+		{
+			for (unsigned int cluster = slice * clustersPerSlice; cluster < (slice + 1) * clustersPerSlice; cluster++)
+			{
+				mRanges[cluster].Offset += indexCount;
+				mMaximumLightsPerCluster = std::max(mMaximumLightsPerCluster, mRanges[cluster].Count);
+			}
+
+			indexCount += static_cast<unsigned int>(mSliceIndices[slice].size());
+		}
+
+		mLightIndices.resize(indexCount);
+		for (unsigned int slice = 0; slice < mSliceCount; slice++)
+		{
+			if (mSliceIndices[slice].empty() == false)
+			{
+				std::copy(mSliceIndices[slice].begin(), mSliceIndices[slice].end(), mLightIndices.begin() + mRanges[slice * clustersPerSlice].Offset);
+			}
+		}
+	}
+
+	const std::vector<ClusterRange>& LightClusters::Ranges() const
+	{
+		return mRanges;
+	}
+
+	const std::vector<unsigned int>& LightClusters::LightIndices() const
+	{
+		return mLightIndices;
+	}
+
+	unsigned int LightClusters::MaximumLightsPerCluster() const
+	{
+		return mMaximumLightsPerCluster;
+	}
+
+	void LightClusters::BoundingSphere(const ClusterLight& light, float center[3], float& radius)
+	{
+		float cosine = light.CosineOuterAngle;
+		float distance = 0.0f;
+		radius = light.Radius;
+
+		if (cosine > 0.70710678f)
+		{
+			distance = radius = light.Radius / (2.0f * cosine);
+		}
+		else if (cosine > 0.0f)
+		{
+			distance = light.Radius * cosine;
+			radius = light.Radius * sqrtf(1.0f - cosine * cosine);
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			center[i] = light.Position[i] + light.Direction[i] * distance;
+		}
+	}
+
+	void LightClusters::BuildSlices(const std::vector<ClusterLight>& lights, unsigned int sliceBegin, unsigned int sliceEnd)
+	{
+		unsigned int clustersPerSlice = mTileCountX * mTileCountY;
+		unsigned int lightCount = static_cast<unsigned int>(lights.size());
+
+		for (unsigned int slice = sliceBegin; slice < sliceEnd; slice++)
+		{
+			std::vector<ClusterHit>& hits = mSliceHits[slice];
+			hits.clear();
+
+			float sliceNearDepth = SliceDepth(slice);
+			float sliceFarDepth = SliceDepth(slice + 1);
+
+			for (unsigned int i = 0; i < lightCount; i++)
+			{
+				const LightSliceRange& range = mLightRanges[i];
+				if (slice < range.SliceBegin || slice >= range.SliceEnd)
+				{
+					continue;
+				}
+
+				// Projected extent of the sphere within this slice's depth range; x / z is monotonic in z for a fixed x
+				float nearDepth = std::max(sliceNearDepth, range.Center[2] - range.Radius);
+				float farDepth = std::min(sliceFarDepth, range.Center[2] + range.Radius);
+
+				float leftX = range.Center[0] - range.Radius;
+				float rightX = range.Center[0] + range.Radius;
+				float bottomY = range.Center[1] - range.Radius;
+				float topY = range.Center[1] + range.Radius;
+
+				float minimumX = std::min(leftX / nearDepth, leftX / farDepth) / mTanHalfFieldOfViewX;
+				float maximumX = std::max(rightX / nearDepth, rightX / farDepth) / mTanHalfFieldOfViewX;
+				float minimumY = std::min(bottomY / nearDepth, bottomY / farDepth) / mTanHalfFieldOfViewY;
+				float maximumY = std::max(topY / nearDepth, topY / farDepth) / mTanHalfFieldOfViewY;
+				if (maximumX < -1.0f || minimumX > 1.0f || maximumY < -1.0f || minimumY > 1.0f)
+				{
+					continue;
+				}
+
+				int tileBeginX = std::max(static_cast<int>((minimumX + 1.0f) * 0.5f * mTileCountX), 0);
+				int tileEndX = std::min(static_cast<int>((maximumX + 1.0f) * 0.5f * mTileCountX), static_cast<int>(mTileCountX) - 1);
+				int tileBeginY = std::max(static_cast<int>((1.0f - maximumY) * 0.5f * mTileCountY), 0);
+				int tileEndY = std::min(static_cast<int>((1.0f - minimumY) * 0.5f * mTileCountY), static_cast<int>(mTileCountY) - 1);
+
+				bool isSpotLight = (lights[i].CosineOuterAngle > 0.0f);
+				__m128 centerX = _mm_set1_ps(range.Center[0]);
+				__m128 centerY = _mm_set1_ps(range.Center[1]);
+				__m128 centerZ = _mm_set1_ps(range.Center[2]);
+				__m128 radiusSquared = _mm_set1_ps(range.Radius * range.Radius);
+				__m128 zero = _mm_setzero_ps();
+
+				for (int y = tileBeginY; y <= tileEndY; y++)
+				{
+					unsigned int rowCluster = (slice * mTileCountY + y) * mTileCountX;
+
+					// Sphere against four cluster boxes at a time: squared distance from the centre to each box
+					for (int x = tileBeginX; x <= tileEndX; x += 4)
+					{
+						unsigned int cluster = rowCluster + x;
+						__m128 distanceX = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&mMinimumX[cluster]), centerX), _mm_sub_ps(centerX, _mm_loadu_ps(&mMaximumX[cluster]))), zero);
+						__m128 distanceY = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&mMinimumY[cluster]), centerY), _mm_sub_ps(centerY, _mm_loadu_ps(&mMaximumY[cluster]))), zero);
+						__m128 distanceZ = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&mMinimumZ[cluster]), centerZ), _mm_sub_ps(centerZ, _mm_loadu_ps(&mMaximumZ[cluster]))), zero);
+						__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(distanceX, distanceX), _mm_mul_ps(distanceY, distanceY)), _mm_mul_ps(distanceZ, distanceZ));
+
+						int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, radiusSquared));
+						mask &= (1 << std::min(tileEndX - x + 1, 4)) - 1;
+
+						for (int lane = 0; mask != 0; lane++, mask >>= 1)
+						{
+							if ((mask & 1) && (isSpotLight == false || IntersectsCone(lights[i], cluster + lane)))
+							{
+								ClusterHit hit = { cluster + lane - slice * clustersPerSlice, i };
+								hits.push_back(hit);
+							}
+						}
+					}
+				}
+			}
+
+			// Counting sort by cluster; lights were visited in order, so every cluster's list stays sorted
+			ClusterRange* ranges = &mRanges[slice * clustersPerSlice];
+			for (unsigned int cluster = 0; cluster < clustersPerSlice; cluster++)
+			{
+				ranges[cluster].Count = 0;
+			}
+
+			for (const ClusterHit& hit : hits)
+			{
+				ranges[hit.Cluster].Count++;
+			}
+
+			unsigned int offset = 0;
+			for (unsigned int cluster = 0; cluster < clustersPerSlice; cluster++)
+			{
+				ranges[cluster].Offset = offset;
+				offset += ranges[cluster].Count;
+				ranges[cluster].Count = 0;
+			}
+
+			std::vector<unsigned int>& indices = mSliceIndices[slice];
+			indices.resize(hits.size());
+			for (const ClusterHit& hit : hits)
+			{
+				ClusterRange& range = ranges[hit.Cluster];
+				indices[range.Offset + range.Count++] = hit.Light;
+			}
+		}
+	}
+
+	bool LightClusters::IntersectsCone(const ClusterLight& light, unsigned int cluster) const
+	{
+		// Cone against the cluster's bounding sphere (Wronski's test)
+		float center[3] = { (mMinimumX[cluster] + mMaximumX[cluster]) * 0.5f, (mMinimumY[cluster] + mMaximumY[cluster]) * 0.5f, (mMinimumZ[cluster] + mMaximumZ[cluster]) * 0.5f };
+		float extent[3] = { mMaximumX[cluster] - center[0], mMaximumY[cluster] - center[1], mMaximumZ[cluster] - center[2] };
+		float clusterRadius = sqrtf(extent[0] * extent[0] + extent[1] * extent[1] + extent[2] * extent[2]);
+
+		float offset[3] = { center[0] - light.Position[0], center[1] - light.Position[1], center[2] - light.Position[2] };
+		float lengthSquared = offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2];
+		float axialDistance = offset[0] * light.Direction[0] + offset[1] * light.Direction[1] + offset[2] * light.Direction[2];
+
+		float cosine = light.CosineOuterAngle;
+		float sine = sqrtf(1.0f - cosine * cosine);
+		float closestDistance = cosine * sqrtf(std::max(lengthSquared - axialDistance * axialDistance, 0.0f)) - axialDistance * sine;
+
+		return (closestDistance <= clusterRadius && axialDistance <= clusterRadius + light.Radius && axialDistance >= -clusterRadius);
+	}
+
+	float LightClusters::SliceDepth(unsigned int slice) const
+	{
+		return mNearPlaneDistance * powf(mFarPlaneDistance / mNearPlaneDistance, static_cast<float>(slice) / mSliceCount);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+// Portable like BlurKernel: froxel construction and light binning, shared by ClusteredLighting and ClusterBenchmark
+#include <vector>
+
+namespace Library
+{
+	class ThreadPool;
+
+	// Bounding volume of a point or spot light in view space, with depth measured positive in front of the camera.
+	// Point lights use a CosineOuterAngle of -1; cones wider than a hemisphere are binned by their range sphere alone.
+	typedef struct _ClusterLight
+	{
+		float Position[3];
+		float Radius;
+		float Direction[3];
+		float CosineOuterAngle;
+	} ClusterLight;
+
+	typedef struct _ClusterRange
+	{
+		unsigned int Offset;
+		unsigned int Count;
+	} ClusterRange;
+
+	// Screen tiles split into exponential depth slices. Cluster (x, y, slice) is numbered (slice * TileCountY + y) * TileCountX + x,
+	// with tile y = 0 at the top of the screen, and owns Ranges()[cluster].Count entries of LightIndices() from Ranges()[cluster].Offset.
+	class LightClusters
+	{
+	public:
+		LightClusters(unsigned int tileCountX = DefaultTileCountX, unsigned int tileCountY = DefaultTileCountY, unsigned int sliceCount = DefaultSliceCount);
+
+		unsigned int TileCountX() const;
+		unsigned int TileCountY() const;
+		unsigned int SliceCount() const;
+		unsigned int ClusterCount() const;
+
+		// Rebuilds cluster bounds; only needed when the camera's projection changes
+		void SetProjection(float fieldOfView, float aspectRatio, float nearPlaneDistance, float farPlaneDistance);
+
+		// Slice of a view depth is log2(depth) * SliceScale() + SliceBias(), which the shaders evaluate per pixel
+		float SliceScale() const;
+		float SliceBias() const;
+		unsigned int SliceIndex(float depth) const;
+
+		// Lights are binned slice by slice, so the pool splits the work without sharing any output
+		void Build(const std::vector<ClusterLight>& lights, ThreadPool* threadPool = nullptr);
+
+		const std::vector<ClusterRange>& Ranges() const;
+		const std::vector<unsigned int>& LightIndices() const;
+		unsigned int MaximumLightsPerCluster() const;
+
+		// A spot light's cone is bounded by whichever is smaller of its range sphere and the sphere around the cone's cap
+		static void BoundingSphere(const ClusterLight& light, float center[3], float& radius);
+
+		static const unsigned int DefaultTileCountX;
+		static const unsigned int DefaultTileCountY;
+		static const unsigned int DefaultSliceCount;
+
+	private:
+		typedef struct _LightSliceRange
+		{
+			unsigned int SliceBegin;
+			unsigned int SliceEnd;
+			float Center[3];
+			float Radius;
+		} LightSliceRange;
+
+		typedef struct _ClusterHit
+		{
+			unsigned int Cluster;
+			unsigned int Light;
+		} ClusterHit;
+
+		LightClusters(const LightClusters& rhs);
+		LightClusters& operator=(const LightClusters& rhs);
+
+		void BuildSlices(const std::vector<ClusterLight>& lights, unsigned int sliceBegin, unsigned int sliceEnd);
+		bool IntersectsCone(const ClusterLight& light, unsigned int cluster) const;
+		float SliceDepth(unsigned int slice) const;
+
+		unsigned int mTileCountX;
+		unsigned int mTileCountY;
+		unsigned int mSliceCount;
+		float mTanHalfFieldOfViewX;
+		float mTanHalfFieldOfViewY;
+		float mNearPlaneDistance;
+		float mFarPlaneDistance;
+		float mSliceScale;
+		float mSliceBias;
+
+		// Cluster bounds as separate arrays, padded so four clusters load at once from any tile
+		std::vector<float> mMinimumX;
+		std::vector<float> mMinimumY;
+		std::vector<float> mMinimumZ;
+		std::vector<float> mMaximumX;
+		std::vector<float> mMaximumY;
+		std::vector<float> mMaximumZ;
+
+		std::vector<LightSliceRange> mLightRanges;
+		std::vector<std::vector<ClusterHit>> mSliceHits;
+		std::vector<std::vector<unsigned int>> mSliceIndices;
+		std::vector<ClusterRange> mRanges;
+		std::vector<unsigned int> mLightIndices;
+		unsigned int mMaximumLightsPerCluster;
+	};
+}
\ No newline at end of file
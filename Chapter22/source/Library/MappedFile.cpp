@@ -0,0 +1,221 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <vector>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace Library
+{
+	const unsigned int MappedFile::PageSize = 4096;
+
+#if defined(_WIN32)
+	MappedFile::MappedFile()
+		: mData(nullptr), mSize(0), mFile(INVALID_HANDLE_VALUE), mMapping(nullptr)
+	{
+	}
+
+	MappedFile::MappedFile(const std::wstring& filename)
+		: mData(nullptr), mSize(0), mFile(INVALID_HANDLE_VALUE), mMapping(nullptr)
+	{
+		Open(filename);
+	}
+#else
+	MappedFile::MappedFile()
+		: mData(nullptr), mSize(0), mFile(-1)
+	{
+	}
+
+	MappedFile::MappedFile(const std::wstring& filename)
+		: mData(nullptr), mSize(0), mFile(-1)
+	{
+		Open(filename);
+	}
+#endif
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::IsOpen() const
+	{
+#if defined(_WIN32)
+		return (mFile != INVALID_HANDLE_VALUE);
+#else
+		return (mFile >= 0);
+#endif
+	}
+
+	const unsigned char* MappedFile::Data() const
+	{
+		return mData;
+	}
+
+	unsigned long long MappedFile::Size() const
+	{
+		return mSize;
+	}
+
+	unsigned int MappedFile::Prefetch(unsigned long long offset, unsigned long long size) const
+	{
+		if (offset >= mSize || size == 0)
+		{
+			return 0;
+		}
+
+		unsigned long long end = (size > mSize - offset ? mSize : offset + size);
+
+#if !defined(_WIN32)
+		unsigned long long pageStart = offset - offset % PageSize;
+		madvise(const_cast<unsigned char*>(mData) + pageStart, static_cast<size_t>(end - pageStart), MADV_WILLNEED);
+#endif
+
+		unsigned int checksum = 0;
+		for (unsigned long long position = offset; position < end; position += PageSize - position % PageSize)
+		{
+			checksum += mData[position];
+		}
+
+		return checksum + mData[end - 1];
+	}
+
+#if defined(_WIN32)
+	void MappedFile::Open(const std::wstring& filename)
+	{
+		Close();
+
+		mFile = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (mFile == INVALID_HANDLE_VALUE)
+		{
+			throw std::runtime_error("CreateFile() failed.");
+		}
+
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(mFile, &fileSize) == FALSE)
+		{
+			Close();
+			throw std::runtime_error("GetFileSizeEx() failed.");
+		}
+
+		mSize = static_cast<unsigned long long>(fileSize.QuadPart);
+		if (mSize == 0)
+		{
+			// Zero-length files can't be mapped, but are still valid and empty
+			return;
+		}
+
+		if (mSize > static_cast<size_t>(-1))
+		{
+			Close();
+			throw std::runtime_error("File is too large to map in a 32-bit process.");
+		}
+
+		mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mMapping == nullptr)
+		{
+			Close();
+			throw std::runtime_error("CreateFileMapping() failed.");
+		}
+
+		mData = static_cast<const unsigned char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+		if (mData == nullptr)
+		{
+			Close();
+			throw std::runtime_error("MapViewOfFile() failed.");
+		}
+	}
+
+	void MappedFile::Close()
+	{
+		if (mData != nullptr)
+		{
+			UnmapViewOfFile(mData);
+			mData = nullptr;
+		}
+
+		if (mMapping != nullptr)
+		{
+			CloseHandle(mMapping);
+			mMapping = nullptr;
+		}
+
+		if (mFile != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(mFile);
+			mFile = INVALID_HANDLE_VALUE;
+		}
+
+		mSize = 0;
+	}
+#else
+	void MappedFile::Open(const std::wstring& filename)
+	{
+		Close();
+
+		std::vector<char> narrowFilename(filename.size() * MB_CUR_MAX + 1);
+		if (wcstombs(&narrowFilename[0], filename.c_str(), narrowFilename.size()) == static_cast<size_t>(-1))
+		{
+			throw std::runtime_error("Invalid file name.");
+		}
+
+		mFile = open(&narrowFilename[0], O_RDONLY);
+		if (mFile < 0)
+		{
+			throw std::runtime_error("open() failed.");
+		}
+
+		struct stat fileStatus;
+		if (fstat(mFile, &fileStatus) != 0)
+		{
+			Close();
+			throw std::runtime_error("fstat() failed.");
+		}
+
+		mSize = static_cast<unsigned long long>(fileStatus.st_size);
+		if (mSize == 0)
+		{
+			return;
+		}
+
+		if (mSize > static_cast<size_t>(-1))
+		{
+			Close();
+			throw std::runtime_error("File is too large to map in a 32-bit process.");
+		}
+
+		void* data = mmap(nullptr, static_cast<size_t>(mSize), PROT_READ, MAP_PRIVATE, mFile, 0);
+		if (data == MAP_FAILED)
+		{
+			Close();
+			throw std::runtime_error("mmap() failed.");
+		}
+
+		mData = static_cast<const unsigned char*>(data);
+	}
+
+	void MappedFile::Close()
+	{
+		if (mData != nullptr)
+		{
+			munmap(const_cast<unsigned char*>(mData), static_cast<size_t>(mSize));
+			mData = nullptr;
+		}
+
+		if (mFile >= 0)
+		{
+			close(mFile);
+			mFile = -1;
+		}
+
+		mSize = 0;
+	}
+#endif
+}
\ No newline at end of file
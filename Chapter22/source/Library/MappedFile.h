@@ -0,0 +1,44 @@
+#pragma once
+
+// Portable: Win32 file mappings on Windows, mmap elsewhere
+#include <string>
+
+namespace Library
+{
+	// A read-only view of a whole file. Pages are read from disk when first touched, so opening is cheap whatever
+	// the file's size, and Prefetch() lets a worker thread take the page faults instead of the caller.
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		explicit MappedFile(const std::wstring& filename);
+		~MappedFile();
+
+		// Throws std::runtime_error if the file can't be opened or mapped
+		void Open(const std::wstring& filename);
+		void Close();
+
+		bool IsOpen() const;
+		const unsigned char* Data() const;
+		unsigned long long Size() const;
+
+		// Touches every page of the range; returns a checksum only so the reads can't be optimized away
+		unsigned int Prefetch(unsigned long long offset, unsigned long long size) const;
+
+		static const unsigned int PageSize;
+
+	private:
+		MappedFile(const MappedFile& rhs);
+		MappedFile& operator=(const MappedFile& rhs);
+
+		const unsigned char* mData;
+		unsigned long long mSize;
+
+#if defined(_WIN32)
+		void* mFile;
+		void* mMapping;
+#else
+		int mFile;
+#endif
+	};
+}
\ No newline at end of file
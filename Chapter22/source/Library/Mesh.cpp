@@ -4,13 +4,14 @@
 #include "Bone.h"
 #include "Game.h"
 #include "GameException.h"
+#include "TextureResidency.h"
 #include <assimp/scene.h>
 
 namespace Library
 {
     Mesh::Mesh(Model& model, aiMesh& mesh)
         : mModel(model), mMaterial(nullptr), mName(mesh.mName.C_Str()), mVertices(), mNormals(), mTangents(), mBiNormals(), mTextureCoordinates(), mVertexColors(),
-		  mFaceCount(0), mIndices(), mBoneWeights(), mVertexBuffer(), mIndexBuffer()
+		  mFaceCount(0), mIndices(), mUVDensity(0.0f), mBoneWeights(), mVertexBuffer(), mIndexBuffer()
     {
 		mMaterial = mModel.Materials().at(mesh.mMaterialIndex);
 
@@ -88,6 +89,11 @@ namespace Library
             }
         }
 
+		if (mTextureCoordinates.size() > 0 && mIndices.size() > 0 && mIndices.size() == mFaceCount * 3)
+		{
+			mUVDensity = TextureResidency::UVDensity(&mVertices[0].x, sizeof(XMFLOAT3), &mTextureCoordinates[0]->at(0).x, sizeof(XMFLOAT3), &mIndices[0], mFaceCount);
+		}
+
 		// Bones
 		if (mesh.HasBones())
 		{
@@ -202,6 +208,39 @@ namespace Library
 		return mBoneWeights;
 	}
 
+	float Mesh::UVDensity() const
+	{
+		return mUVDensity;
+	}
+
+	bool Mesh::PackTextureCoordinates(UINT channel, const XMFLOAT4& scaleOffset)
+	{
+		std::vector<XMFLOAT3>& textureCoordinates = *mTextureCoordinates.at(channel);
+		for (const XMFLOAT3& textureCoordinate : textureCoordinates)
+		{
+			if (textureCoordinate.x < 0.0f || textureCoordinate.x > 1.0f || textureCoordinate.y < 0.0f || textureCoordinate.y > 1.0f)
+			{
+				return false;
+			}
+		}
+
+		for (XMFLOAT3& textureCoordinate : textureCoordinates)
+		{
+			textureCoordinate.x = textureCoordinate.x * scaleOffset.x + scaleOffset.z;
+			textureCoordinate.y = textureCoordinate.y * scaleOffset.y + scaleOffset.w;
+		}
+
+		// The same surface now covers less UV space
+		if (channel == 0 && scaleOffset.x > 0.0f && scaleOffset.y > 0.0f)
+		{
+			mUVDensity /= sqrt(scaleOffset.x * scaleOffset.y);
+		}
+
+		mVertexBuffer.ReleaseBuffer();
+
+		return true;
+	}
+
 	BufferContainer& Mesh::VertexBuffer()
 	{
 		return mVertexBuffer;
@@ -32,6 +32,13 @@ namespace Library
         const std::vector<UINT>& Indices() const;
 		const std::vector<BoneVertexWeights>& BoneWeights() const;
 
+		// World units per unit of the first UV channel, for texture streaming; 0 without texture coordinates
+		float UVDensity() const;
+
+		// Moves a UV channel into an atlas rectangle, uv * scaleOffset.xy + scaleOffset.zw, dropping the cached
+		// vertex buffer. Returns false, changing nothing, when coordinates leave [0, 1] and would sample the neighbours.
+		bool PackTextureCoordinates(UINT channel, const XMFLOAT4& scaleOffset);
+
 		BufferContainer& VertexBuffer();
 		BufferContainer& IndexBuffer();
 
@@ -57,6 +64,7 @@ namespace Library
         std::vector<std::vector<XMFLOAT4>*> mVertexColors;
         UINT mFaceCount;
         std::vector<UINT> mIndices;
+		float mUVDensity;
 		std::vector<BoneVertexWeights> mBoneWeights;
 
 		BufferContainer mVertexBuffer;
@@ -0,0 +1,48 @@
+#include "MeshBuffers.h"
+#include "Mesh.h"
+#include "Material.h"
+
+namespace Library
+{
+	MeshBuffers::MeshBuffers(ID3D11Device& device, Mesh& mesh, const Material& material)
+		: mVertexBuffer(nullptr), mIndexBuffer(nullptr), mVertexSize(material.VertexSize()), mIndexCount(static_cast<UINT>(mesh.Indices().size()))
+	{
+		material.CreateVertexBuffer(&device, mesh, &mVertexBuffer);
+
+		try
+		{
+			mesh.CreateIndexBuffer(&mIndexBuffer);
+		}
+		catch (...)
+		{
+			ReleaseObject(mVertexBuffer);
+			throw;
+		}
+	}
+
+	MeshBuffers::~MeshBuffers()
+	{
+		ReleaseObject(mIndexBuffer);
+		ReleaseObject(mVertexBuffer);
+	}
+
+	ID3D11Buffer* MeshBuffers::VertexBuffer() const
+	{
+		return mVertexBuffer;
+	}
+
+	ID3D11Buffer* MeshBuffers::IndexBuffer() const
+	{
+		return mIndexBuffer;
+	}
+
+	UINT MeshBuffers::VertexSize() const
+	{
+		return mVertexSize;
+	}
+
+	UINT MeshBuffers::IndexCount() const
+	{
+		return mIndexCount;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Common.h"
+
+namespace Library
+{
+	class Mesh;
+	class Material;
+
+	// A model mesh's vertex buffer, in one material's vertex layout, and its index buffer, immutable. Load it through
+	// ContentManager::LoadMeshBuffers() so every proxy or instance of a mesh draws from one pair of buffers; the Model
+	// they were built from is only needed while they are created.
+	class MeshBuffers
+	{
+	public:
+		MeshBuffers(ID3D11Device& device, Mesh& mesh, const Material& material);
+		~MeshBuffers();
+
+		ID3D11Buffer* VertexBuffer() const;
+		ID3D11Buffer* IndexBuffer() const;
+		UINT VertexSize() const;
+		UINT IndexCount() const;
+
+	private:
+		MeshBuffers();
+		MeshBuffers(const MeshBuffers& rhs);
+		MeshBuffers& operator=(const MeshBuffers& rhs);
+
+		ID3D11Buffer* mVertexBuffer;
+		ID3D11Buffer* mIndexBuffer;
+		UINT mVertexSize;
+		UINT mIndexCount;
+	};
+}
\ No newline at end of file
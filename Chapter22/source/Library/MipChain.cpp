@@ -0,0 +1,281 @@
+#include "MipChain.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <xmmintrin.h>
+
+namespace Library
+{
+	const float MipChain::KaiserRadius = 3.0f;
+	const float MipChain::KaiserAlpha = 4.0f;
+
+	namespace
+	{
+		const float Pi = 3.14159265f;
+
+		// Resampling weights for one axis: every destination texel reads TapCount source texels, clamped to the edge
+		typedef struct _FilterKernel
+		{
+			unsigned int TapCount;
+			std::vector<unsigned int> Indices;
+			std::vector<float> Weights;
+		} FilterKernel;
+
+		float BesselI0(float x)
+		{
+			float halfX = x * 0.5f;
+			float term = 1.0f;
+			float sum = 1.0f;
+			for (int k = 1; k < 32 && term > sum * 1e-7f; k++)
+			{
+				term *= (halfX / k) * (halfX / k);
+				sum += term;
+			}
+
+			return sum;
+		}
+
+		float Sinc(float x)
+		{
+			if (fabs(x) < 1e-6f)
+			{
+				return 1.0f;
+			}
+
+			x *= Pi;
+			return sin(x) / x;
+		}
+
+		// t is in destination texels
+		float KaiserWeight(float t)
+		{
+			float x = t / MipChain::KaiserRadius;
+			if (x * x >= 1.0f)
+			{
+				return 0.0f;
+			}
+
+			return Sinc(t) * BesselI0(MipChain::KaiserAlpha * sqrt(1.0f - x * x)) / BesselI0(MipChain::KaiserAlpha);
+		}
+
+		void CreateKernel(unsigned int sourceSize, unsigned int destinationSize, MipFilter filter, FilterKernel& kernel)
+		{
+			float scale = static_cast<float>(sourceSize) / destinationSize;
+			float support = (filter == MipFilterBox ? 0.5f : MipChain::KaiserRadius) * scale;
+
+			kernel.TapCount = static_cast<unsigned int>(ceil(support * 2.0f)) + 1;
+			kernel.Indices.resize(destinationSize * kernel.TapCount);
+			kernel.Weights.resize(destinationSize * kernel.TapCount);
+
+			for (unsigned int x = 0; x < destinationSize; x++)
+			{
+				float center = (x + 0.5f) * scale;
+				int first = static_cast<int>(floor(center - support));
+				unsigned int* indices = &kernel.Indices[x * kernel.TapCount];
+				float* weights = &kernel.Weights[x * kernel.TapCount];
+
+				float total = 0.0f;
+				for (unsigned int tap = 0; tap < kernel.TapCount; tap++)
+				{
+					int source = first + static_cast<int>(tap);
+					if (filter == MipFilterBox)
+					{
+						// The fraction of the source texel the destination texel covers
+						weights[tap] = std::max(std::min(source + 1.0f, center + support) - std::max(static_cast<float>(source), center - support), 0.0f);
+					}
+					else
+					{
+						weights[tap] = KaiserWeight((source + 0.5f - center) / scale);
+					}
+
+					indices[tap] = static_cast<unsigned int>(std::min(std::max(source, 0), static_cast<int>(sourceSize) - 1));
+					total += weights[tap];
+				}
+
+				for (unsigned int tap = 0; tap < kernel.TapCount; tap++)
+				{
+					weights[tap] /= total;
+				}
+			}
+		}
+
+		void ForEachRow(unsigned int height, ThreadPool* threadPool, const std::function<void(unsigned int begin, unsigned int end)>& body)
+		{
+			if (threadPool != nullptr)
+			{
+				threadPool->ParallelFor(0, height, body, 8);
+			}
+			else
+			{
+				body(0, height);
+			}
+		}
+
+		void ResampleRows(const PostProcessImage& source, const FilterKernel& kernel, PostProcessImage& destination, unsigned int begin, unsigned int end)
+		{
+			for (unsigned int y = begin; y < end; y++)
+			{
+				const float* sourceRow = &source.Texels[static_cast<size_t>(y) * source.Width * 4];
+				float* destinationRow = &destination.Texels[static_cast<size_t>(y) * destination.Width * 4];
+
+				for (unsigned int x = 0; x < destination.Width; x++)
+				{
+					const unsigned int* indices = &kernel.Indices[x * kernel.TapCount];
+					const float* weights = &kernel.Weights[x * kernel.TapCount];
+
+					__m128 sum = _mm_setzero_ps();
+					for (unsigned int tap = 0; tap < kernel.TapCount; tap++)
+					{
+						sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(sourceRow + indices[tap] * 4), _mm_set1_ps(weights[tap])));
+					}
+
+					_mm_storeu_ps(destinationRow + x * 4, sum);
+				}
+			}
+		}
+
+		// Accumulates whole source rows, so the inner loop streams through memory
+		void ResampleColumns(const PostProcessImage& source, const FilterKernel& kernel, PostProcessImage& destination, unsigned int begin, unsigned int end)
+		{
+			unsigned int valueCount = destination.Width * 4;
+			for (unsigned int y = begin; y < end; y++)
+			{
+				const unsigned int* indices = &kernel.Indices[y * kernel.TapCount];
+				const float* weights = &kernel.Weights[y * kernel.TapCount];
+				float* destinationRow = &destination.Texels[static_cast<size_t>(y) * valueCount];
+
+				for (unsigned int i = 0; i < valueCount; i += 4)
+				{
+					_mm_storeu_ps(destinationRow + i, _mm_setzero_ps());
+				}
+
+				for (unsigned int tap = 0; tap < kernel.TapCount; tap++)
+				{
+					const float* sourceRow = &source.Texels[static_cast<size_t>(indices[tap]) * valueCount];
+					__m128 weight = _mm_set1_ps(weights[tap]);
+					for (unsigned int i = 0; i < valueCount; i += 4)
+					{
+						__m128 sum = _mm_add_ps(_mm_loadu_ps(destinationRow + i), _mm_mul_ps(_mm_loadu_ps(sourceRow + i), weight));
+						_mm_storeu_ps(destinationRow + i, sum);
+					}
+				}
+			}
+		}
+
+		void ConvertColor(PostProcessImage& image, float (*convert)(float), unsigned int begin, unsigned int end)
+		{
+			for (size_t i = static_cast<size_t>(begin) * image.Width * 4; i < static_cast<size_t>(end) * image.Width * 4; i += 4)
+			{
+				image.Texels[i + 0] = convert(image.Texels[i + 0]);
+				image.Texels[i + 1] = convert(image.Texels[i + 1]);
+				image.Texels[i + 2] = convert(image.Texels[i + 2]);
+			}
+		}
+
+		// The Kaiser filter's negative lobes can ring past the source's range, which every output format clamps anyway
+		void Saturate(PostProcessImage& image, unsigned int begin, unsigned int end)
+		{
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.0f);
+			for (size_t i = static_cast<size_t>(begin) * image.Width * 4; i < static_cast<size_t>(end) * image.Width * 4; i += 4)
+			{
+				_mm_storeu_ps(&image.Texels[i], _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&image.Texels[i]), zero), one));
+			}
+		}
+
+		void Renormalize(PostProcessImage& image, unsigned int begin, unsigned int end)
+		{
+			for (size_t i = static_cast<size_t>(begin) * image.Width * 4; i < static_cast<size_t>(end) * image.Width * 4; i += 4)
+			{
+				float* texel = &image.Texels[i];
+				float x = texel[0] * 2.0f - 1.0f;
+				float y = texel[1] * 2.0f - 1.0f;
+				float z = texel[2] * 2.0f - 1.0f;
+				float length = sqrt(x * x + y * y + z * z);
+				if (length > 1e-6f)
+				{
+					x /= length;
+					y /= length;
+					z /= length;
+				}
+				else
+				{
+					x = 0.0f;
+					y = 0.0f;
+					z = 1.0f;
+				}
+
+				texel[0] = x * 0.5f + 0.5f;
+				texel[1] = y * 0.5f + 0.5f;
+				texel[2] = z * 0.5f + 0.5f;
+			}
+		}
+	}
+
+	void MipChain::Generate(const PostProcessImage& source, TextureContent content, MipFilter filter, std::vector<PostProcessImage>& mips, ThreadPool* threadPool)
+	{
+		mips.resize(MipCount(source.Width, source.Height));
+		mips[0] = source;
+
+		PostProcessImage level = source;
+		if (content == TextureContentColor)
+		{
+			ForEachRow(level.Height, threadPool, [&](unsigned int begin, unsigned int end) { ConvertColor(level, SrgbToLinear, begin, end); });
+		}
+
+		PostProcessImage intermediate;
+		PostProcessImage next;
+		FilterKernel horizontalKernel;
+		FilterKernel verticalKernel;
+		for (unsigned int mip = 1; mip < mips.size(); mip++)
+		{
+			unsigned int width = std::max(level.Width / 2, 1U);
+			unsigned int height = std::max(level.Height / 2, 1U);
+			CreateKernel(level.Width, width, filter, horizontalKernel);
+			CreateKernel(level.Height, height, filter, verticalKernel);
+
+			PostProcessReference::ResizeImage(intermediate, width, level.Height);
+			PostProcessReference::ResizeImage(next, width, height);
+			ForEachRow(level.Height, threadPool, [&](unsigned int begin, unsigned int end) { ResampleRows(level, horizontalKernel, intermediate, begin, end); });
+			ForEachRow(height, threadPool, [&](unsigned int begin, unsigned int end)
+			{
+				ResampleColumns(intermediate, verticalKernel, next, begin, end);
+				Saturate(next, begin, end);
+				if (content == TextureContentNormal)
+				{
+					Renormalize(next, begin, end);
+				}
+			});
+
+			std::swap(level, next);
+			mips[mip] = level;
+			if (content == TextureContentColor)
+			{
+				PostProcessImage& encoded = mips[mip];
+				ForEachRow(height, threadPool, [&](unsigned int begin, unsigned int end) { ConvertColor(encoded, LinearToSrgb, begin, end); });
+			}
+		}
+	}
+
+	unsigned int MipChain::MipCount(unsigned int width, unsigned int height)
+	{
+		unsigned int count = 1;
+		for (unsigned int size = std::max(width, height); size > 1; size /= 2)
+		{
+			count++;
+		}
+
+		return count;
+	}
+
+	float MipChain::SrgbToLinear(float value)
+	{
+		return (value <= 0.04045f ? value / 12.92f : pow((value + 0.055f) / 1.055f, 2.4f));
+	}
+
+	float MipChain::LinearToSrgb(float value)
+	{
+		return (value <= 0.0031308f ? value * 12.92f : 1.055f * pow(value, 1.0f / 2.4f) - 0.055f);
+	}
+}
\ No newline at end of file
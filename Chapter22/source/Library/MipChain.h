@@ -0,0 +1,48 @@
+#pragma once
+
+#include "PostProcessReference.h"
+
+namespace Library
+{
+	class ThreadPool;
+
+	// How texel values are interpreted, which decides how they're filtered
+	enum TextureContent
+	{
+		TextureContentColor = 0,
+		TextureContentLinear,
+		TextureContentNormal,
+		TextureContentEnd
+	};
+
+	enum MipFilter
+	{
+		MipFilterBox = 0,
+		MipFilterKaiser,
+		MipFilterEnd
+	};
+
+	// Builds complete mip chains on the CPU with SSE. Each level is filtered from the one above it, with separable
+	// weights that also cover odd sizes. Color is filtered in linear space and returned sRGB-encoded, like its
+	// source; normal maps are decoded and renormalized at every level.
+	class MipChain
+	{
+	public:
+		// mips[0] is a copy of the source and the last level is 1 x 1
+		static void Generate(const PostProcessImage& source, TextureContent content, MipFilter filter, std::vector<PostProcessImage>& mips, ThreadPool* threadPool = nullptr);
+
+		static unsigned int MipCount(unsigned int width, unsigned int height);
+
+		static float SrgbToLinear(float value);
+		static float LinearToSrgb(float value);
+
+		// Kaiser-windowed sinc: support in destination texels and the window's shape parameter
+		static const float KaiserRadius;
+		static const float KaiserAlpha;
+
+	private:
+		MipChain();
+		MipChain(const MipChain& rhs);
+		MipChain& operator=(const MipChain& rhs);
+	};
+}
\ No newline at end of file
@@ -138,7 +138,7 @@ namespace Library
 		return mAnimationsByName;
 	}
 
-	const std::vector<Bone*> Model::Bones() const
+	const std::vector<Bone*>& Model::Bones() const
 	{
 		return mBones;
 	}
@@ -30,7 +30,7 @@ namespace Library
         const std::vector<ModelMaterial*>& Materials() const;
 		const std::vector<AnimationClip*>& Animations() const;
 		const std::map<std::string, AnimationClip*>& AnimationsbyName() const;
-		const std::vector<Bone*> Bones() const;
+		const std::vector<Bone*>& Bones() const;
 		const std::map<std::string, UINT> BoneIndexMapping() const;
 		SceneNode* RootNode();
 
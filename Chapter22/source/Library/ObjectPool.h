@@ -0,0 +1,102 @@
+#pragma once
+
+// Portable, like ThreadPool: FrameEncoder recycles its frames through a pool without Direct3D
+#include <vector>
+#include <cassert>
+#include <algorithm>
+
+namespace Library
+{
+	class ObjectPoolBase
+	{
+	public:
+		virtual ~ObjectPoolBase() { }
+	};
+
+	// Recycles default-constructed objects. Released objects are not destroyed; callers reinitialize what they acquire.
+	// Not thread-safe. TypeIdClass() tells pools of different types apart without compiler RTTI, which the Library
+	// builds without; like RTTI_DEFINITIONS, the id is the address of a static that every type gets its own of.
+	template <typename T>
+	class ObjectPool : public ObjectPoolBase
+	{
+	public:
+		ObjectPool(unsigned int capacity = 0)
+			: mObjects(), mFreeObjects()
+		{
+			Reserve(capacity);
+		}
+
+		~ObjectPool()
+		{
+			for (T* object : mObjects)
+			{
+				delete object;
+			}
+		}
+
+		T* Acquire()
+		{
+			if (mFreeObjects.empty())
+			{
+				Reserve((std::max)(static_cast<unsigned int>(mObjects.size()) * 2, 8U));
+			}
+
+			T* object = mFreeObjects.back();
+			mFreeObjects.pop_back();
+
+			return object;
+		}
+
+		void Release(T* object)
+		{
+			assert(object != nullptr);
+			mFreeObjects.push_back(object);
+		}
+
+		void Reserve(unsigned int capacity)
+		{
+			if (capacity <= mObjects.size())
+			{
+				return;
+			}
+
+			// The free list never outgrows the object list, so Release() does not reallocate
+			mObjects.reserve(capacity);
+			mFreeObjects.reserve(capacity);
+			while (mObjects.size() < capacity)
+			{
+				T* object = new T();
+				mObjects.push_back(object);
+				mFreeObjects.push_back(object);
+			}
+		}
+
+		unsigned int Capacity() const
+		{
+			return static_cast<unsigned int>(mObjects.size());
+		}
+
+		unsigned int FreeCount() const
+		{
+			return static_cast<unsigned int>(mFreeObjects.size());
+		}
+
+		static const void* TypeIdClass()
+		{
+			return &sTypeId;
+		}
+
+	private:
+		ObjectPool(const ObjectPool& rhs);
+		ObjectPool& operator=(const ObjectPool& rhs);
+
+		std::vector<T*> mObjects;
+		std::vector<T*> mFreeObjects;
+
+		static char sTypeId;
+	};
+
+	// Not const, so the linker can't fold the ids of different types together
+	template <typename T>
+	char ObjectPool<T>::sTypeId = 0;
+}
\ No newline at end of file
@@ -0,0 +1,629 @@
+#include "OcclusionBuffer.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <xmmintrin.h>
+
+namespace Library
+{
+	const unsigned int OcclusionBuffer::TileWidth = 8;
+	const unsigned int OcclusionBuffer::TileHeight = 4;
+	const unsigned int OcclusionBuffer::BandHeight = 8;
+	const unsigned int OcclusionBuffer::SetupBatchSize = 256;
+
+	namespace
+	{
+		const unsigned int FullCoverage = 0xFFFFFFFF;
+
+		// Clipping to a guard band twice the screen keeps edge functions precise without clipping every triangle at the screen edges
+		const float GuardBand = 2.0f;
+		const unsigned int ClipPlaneCount = 5;
+		const unsigned int MaximumClippedVertexCount = 3 + ClipPlaneCount;
+
+		void Transform(const float* position, const float* matrix, float result[4])
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				result[i] = position[0] * matrix[i] + position[1] * matrix[4 + i] + position[2] * matrix[8 + i] + matrix[12 + i];
+			}
+		}
+
+		float ClipDistance(const float vertex[4], unsigned int plane)
+		{
+			switch (plane)
+			{
+			case 0:
+				return vertex[2];
+			case 1:
+				return vertex[0] + GuardBand * vertex[3];
+			case 2:
+				return GuardBand * vertex[3] - vertex[0];
+			case 3:
+				return vertex[1] + GuardBand * vertex[3];
+			default:
+				return GuardBand * vertex[3] - vertex[1];
+			}
+		}
+	}
+
+	OcclusionBuffer::OcclusionBuffer(unsigned int width, unsigned int height)
+		: mWidth(0), mHeight(0), mTileCountX(0), mTileCountY(0), mFarDepth(), mWorkingDepth(), mCoverage(),
+		  mOccluders(), mTriangleOffsets(), mBatchTriangles(), mBandTriangles(), mStatistics()
+	{
+		Resize(width, height);
+	}
+
+	unsigned int OcclusionBuffer::Width() const
+	{
+		return mWidth;
+	}
+
+	unsigned int OcclusionBuffer::Height() const
+	{
+		return mHeight;
+	}
+
+	unsigned int OcclusionBuffer::TileCountX() const
+	{
+		return mTileCountX;
+	}
+
+	unsigned int OcclusionBuffer::TileCountY() const
+	{
+		return mTileCountY;
+	}
+
+	void OcclusionBuffer::Resize(unsigned int width, unsigned int height)
+	{
+		assert(width > 0 && height > 0);
+
+		mWidth = width;
+		mHeight = height;
+		mTileCountX = (width + TileWidth - 1) / TileWidth;
+		mTileCountY = (height + TileHeight - 1) / TileHeight;
+
+		unsigned int paddedCount = mTileCountX * mTileCountY + 3;
+		mFarDepth.resize(paddedCount);
+		mWorkingDepth.resize(paddedCount);
+		mCoverage.resize(paddedCount);
+		mBandTriangles.resize(BandCount());
+
+		Clear();
+	}
+
+	void OcclusionBuffer::Clear()
+	{
+		std::fill(mFarDepth.begin(), mFarDepth.end(), 1.0f);
+		std::fill(mWorkingDepth.begin(), mWorkingDepth.end(), 0.0f);
+		std::fill(mCoverage.begin(), mCoverage.end(), 0U);
+		mOccluders.clear();
+		memset(&mStatistics, 0, sizeof(mStatistics));
+	}
+
+	void OcclusionBuffer::AddOccluder(const float* vertices, unsigned int vertexStride, const unsigned int* indices, unsigned int triangleCount, const float* worldViewProjectionMatrix)
+	{
+		Occluder occluder = { vertices, vertexStride, indices, triangleCount, worldViewProjectionMatrix };
+		mOccluders.push_back(occluder);
+	}
+
+	void OcclusionBuffer::Rasterize(ThreadPool* threadPool)
+	{
+		mTriangleOffsets.resize(mOccluders.size() + 1);
+		mTriangleOffsets[0] = 0;
+		for (size_t i = 0; i < mOccluders.size(); i++)
+		{
+			mTriangleOffsets[i + 1] = mTriangleOffsets[i] + mOccluders[i].TriangleCount;
+		}
+
+		unsigned int triangleCount = mTriangleOffsets.back();
+		unsigned int batchCount = (triangleCount + SetupBatchSize - 1) / SetupBatchSize;
+		if (mBatchTriangles.size() < batchCount)
+		{
+			mBatchTriangles.resize(batchCount);
+		}
+
+		auto setupBatches = [&](unsigned int begin, unsigned int end)
+		{
+			for (unsigned int batch = begin; batch < end; batch++)
+			{
+				mBatchTriangles[batch].clear();
+				SetupTriangles(batch * SetupBatchSize, std::min((batch + 1) * SetupBatchSize, triangleCount), mBatchTriangles[batch]);
+			}
+		};
+
+		if (threadPool != nullptr)
+		{
+			threadPool->ParallelFor(0, batchCount, setupBatches);
+		}
+		else
+		{
+			setupBatches(0, batchCount);
+		}
+
+		// Binning walks the batches in order, so every band sees its triangles in submission order
+		for (std::vector<const SetupTriangle*>& bandTriangles : mBandTriangles)
+		{
+			bandTriangles.clear();
+		}
+
+		unsigned int rasterizedCount = 0;
+		for (unsigned int batch = 0; batch < batchCount; batch++)
+		{
+			for (const SetupTriangle& triangle : mBatchTriangles[batch])
+			{
+				for (unsigned int band = triangle.TileMinimumY / BandHeight; band <= triangle.TileMaximumY / BandHeight; band++)
+				{
+					mBandTriangles[band].push_back(&triangle);
+				}
+			}
+
+			rasterizedCount += static_cast<unsigned int>(mBatchTriangles[batch].size());
+		}
+
+		std::vector<unsigned int> bandTileUpdates(BandCount(), 0);
+		auto rasterizeBands = [&](unsigned int begin, unsigned int end)
+		{
+			for (unsigned int band = begin; band < end; band++)
+			{
+				bandTileUpdates[band] = RasterizeBand(band);
+			}
+		};
+
+		if (threadPool != nullptr)
+		{
+			threadPool->ParallelFor(0, BandCount(), rasterizeBands);
+		}
+		else
+		{
+			rasterizeBands(0, BandCount());
+		}
+
+		mStatistics.OccluderCount += static_cast<unsigned int>(mOccluders.size());
+		mStatistics.SubmittedTriangleCount += triangleCount;
+		mStatistics.RasterizedTriangleCount += rasterizedCount;
+		for (unsigned int tileUpdates : bandTileUpdates)
+		{
+			mStatistics.TileUpdateCount += tileUpdates;
+		}
+
+		mOccluders.clear();
+	}
+
+	OcclusionResult OcclusionBuffer::TestBox(const OcclusionBox& box, const float* viewProjectionMatrix) const
+	{
+		float minimumX = 1e30f;
+		float minimumY = 1e30f;
+		float maximumX = -1e30f;
+		float maximumY = -1e30f;
+		float minimumDepth = 1e30f;
+		unsigned int outsideLeft = 0;
+		unsigned int outsideRight = 0;
+		unsigned int outsideBottom = 0;
+		unsigned int outsideTop = 0;
+
+		for (unsigned int corner = 0; corner < 8; corner++)
+		{
+			float position[3] = { (corner & 1 ? box.Maximum[0] : box.Minimum[0]), (corner & 2 ? box.Maximum[1] : box.Minimum[1]), (corner & 4 ? box.Maximum[2] : box.Minimum[2]) };
+			float clip[4];
+			Transform(position, viewProjectionMatrix, clip);
+
+			// A box reaching past the near plane surrounds the camera as far as the buffer can tell
+			if (clip[2] <= 0.0f)
+			{
+				return OcclusionResultVisible;
+			}
+
+			outsideLeft += (clip[0] < -clip[3] ? 1 : 0);
+			outsideRight += (clip[0] > clip[3] ? 1 : 0);
+			outsideBottom += (clip[1] < -clip[3] ? 1 : 0);
+			outsideTop += (clip[1] > clip[3] ? 1 : 0);
+
+			float reciprocalW = 1.0f / clip[3];
+			float x = (clip[0] * reciprocalW * 0.5f + 0.5f) * mWidth;
+			float y = (0.5f - clip[1] * reciprocalW * 0.5f) * mHeight;
+			minimumX = std::min(minimumX, x);
+			maximumX = std::max(maximumX, x);
+			minimumY = std::min(minimumY, y);
+			maximumY = std::max(maximumY, y);
+			minimumDepth = std::min(minimumDepth, clip[2] * reciprocalW);
+		}
+
+		if (outsideLeft == 8 || outsideRight == 8 || outsideBottom == 8 || outsideTop == 8 || minimumDepth > 1.0f)
+		{
+			return OcclusionResultViewCulled;
+		}
+
+		// Every pixel the box's rectangle touches, clamped to the screen
+		unsigned int pixelMinimumX = static_cast<unsigned int>(std::max(floorf(minimumX), 0.0f));
+		unsigned int pixelMinimumY = static_cast<unsigned int>(std::max(floorf(minimumY), 0.0f));
+		unsigned int pixelMaximumX = static_cast<unsigned int>(std::min(ceilf(maximumX), static_cast<float>(mWidth)));
+		unsigned int pixelMaximumY = static_cast<unsigned int>(std::min(ceilf(maximumY), static_cast<float>(mHeight)));
+		if (pixelMinimumX >= pixelMaximumX || pixelMinimumY >= pixelMaximumY)
+		{
+			return OcclusionResultViewCulled;
+		}
+
+		return (IsOccluded(pixelMinimumX, pixelMinimumY, pixelMaximumX - 1, pixelMaximumY - 1, minimumDepth) ? OcclusionResultOccluded : OcclusionResultVisible);
+	}
+
+	void OcclusionBuffer::TestBoxes(const std::vector<OcclusionBox>& boxes, const float* viewProjectionMatrix, std::vector<OcclusionResult>& results, ThreadPool* threadPool) const
+	{
+		results.resize(boxes.size());
+
+		auto testBoxes = [&](unsigned int begin, unsigned int end)
+		{
+			for (unsigned int i = begin; i < end; i++)
+			{
+				results[i] = TestBox(boxes[i], viewProjectionMatrix);
+			}
+		};
+
+		if (threadPool != nullptr)
+		{
+			threadPool->ParallelFor(0, static_cast<unsigned int>(boxes.size()), testBoxes, 64);
+		}
+		else
+		{
+			testBoxes(0, static_cast<unsigned int>(boxes.size()));
+		}
+	}
+
+	void OcclusionBuffer::ResolveDepth(std::vector<float>& depth) const
+	{
+		depth.resize(mWidth * mHeight);
+
+		for (unsigned int y = 0; y < mHeight; y++)
+		{
+			for (unsigned int x = 0; x < mWidth; x++)
+			{
+				unsigned int tile = (y / TileHeight) * mTileCountX + x / TileWidth;
+				unsigned int bit = (y % TileHeight) * TileWidth + x % TileWidth;
+				depth[y * mWidth + x] = ((mCoverage[tile] >> bit) & 1 ? mWorkingDepth[tile] : mFarDepth[tile]);
+			}
+		}
+	}
+
+	const OcclusionStatistics& OcclusionBuffer::Statistics() const
+	{
+		return mStatistics;
+	}
+
+	void OcclusionBuffer::SetupTriangles(unsigned int begin, unsigned int end, std::vector<SetupTriangle>& triangles) const
+	{
+		unsigned int occluderIndex = static_cast<unsigned int>(std::upper_bound(mTriangleOffsets.begin(), mTriangleOffsets.end(), begin) - mTriangleOffsets.begin()) - 1;
+
+		for (unsigned int i = begin; i < end; i++)
+		{
+			while (i >= mTriangleOffsets[occluderIndex + 1])
+			{
+				occluderIndex++;
+			}
+
+			const Occluder& occluder = mOccluders[occluderIndex];
+			const unsigned int* indices = occluder.Indices + (i - mTriangleOffsets[occluderIndex]) * 3;
+
+			float vertices[MaximumClippedVertexCount][4];
+			unsigned int clipMask = 0;
+			for (int j = 0; j < 3; j++)
+			{
+				const float* position = reinterpret_cast<const float*>(reinterpret_cast<const char*>(occluder.Vertices) + indices[j] * occluder.VertexStride);
+				Transform(position, occluder.Matrix, vertices[j]);
+
+				for (unsigned int plane = 0; plane < ClipPlaneCount; plane++)
+				{
+					clipMask |= (ClipDistance(vertices[j], plane) < 0.0f ? 1U << plane : 0U);
+				}
+			}
+
+			unsigned int vertexCount = 3;
+			for (unsigned int plane = 0; plane < ClipPlaneCount && vertexCount > 0; plane++)
+			{
+				if ((clipMask & (1U << plane)) == 0)
+				{
+					continue;
+				}
+
+				// Sutherland-Hodgman against one plane; a convex polygon gains at most one vertex per plane
+				float clipped[MaximumClippedVertexCount][4];
+				unsigned int clippedCount = 0;
+				for (unsigned int j = 0; j < vertexCount; j++)
+				{
+					const float* current = vertices[j];
+					const float* next = vertices[(j + 1) % vertexCount];
+					float currentDistance = ClipDistance(current, plane);
+					float nextDistance = ClipDistance(next, plane);
+
+					if (currentDistance >= 0.0f)
+					{
+						memcpy(clipped[clippedCount++], current, sizeof(float) * 4);
+					}
+
+					if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+					{
+						float t = currentDistance / (currentDistance - nextDistance);
+						for (int k = 0; k < 4; k++)
+						{
+							clipped[clippedCount][k] = current[k] + (next[k] - current[k]) * t;
+						}
+
+						clippedCount++;
+					}
+				}
+
+				memcpy(vertices, clipped, sizeof(float) * 4 * clippedCount);
+				vertexCount = clippedCount;
+			}
+
+			if (vertexCount >= 3)
+			{
+				SetupPolygon(vertices, vertexCount, triangles);
+			}
+		}
+	}
+
+	void OcclusionBuffer::SetupPolygon(const float (*vertices)[4], unsigned int vertexCount, std::vector<SetupTriangle>& triangles) const
+	{
+		float screen[MaximumClippedVertexCount][3];
+		for (unsigned int i = 0; i < vertexCount; i++)
+		{
+			float reciprocalW = 1.0f / vertices[i][3];
+			screen[i][0] = (vertices[i][0] * reciprocalW * 0.5f + 0.5f) * mWidth;
+			screen[i][1] = (0.5f - vertices[i][1] * reciprocalW * 0.5f) * mHeight;
+			screen[i][2] = vertices[i][2] * reciprocalW;
+		}
+
+		for (unsigned int i = 1; i + 1 < vertexCount; i++)
+		{
+			const float* p0 = screen[0];
+			const float* p1 = screen[i];
+			const float* p2 = screen[i + 1];
+
+			// With y running down the screen, clockwise triangles have a positive area; that also rejects degenerate ones
+			float area = (p1[0] - p0[0]) * (p2[1] - p0[1]) - (p2[0] - p0[0]) * (p1[1] - p0[1]);
+			if (area <= 0.0f)
+			{
+				continue;
+			}
+
+			// Pixels whose centres can fall inside the triangle
+			float minimumX = std::min(std::min(p0[0], p1[0]), p2[0]);
+			float maximumX = std::max(std::max(p0[0], p1[0]), p2[0]);
+			float minimumY = std::min(std::min(p0[1], p1[1]), p2[1]);
+			float maximumY = std::max(std::max(p0[1], p1[1]), p2[1]);
+			int pixelMinimumX = std::max(static_cast<int>(ceilf(minimumX - 0.5f)), 0);
+			int pixelMinimumY = std::max(static_cast<int>(ceilf(minimumY - 0.5f)), 0);
+			int pixelMaximumX = std::min(static_cast<int>(floorf(maximumX - 0.5f)), static_cast<int>(mWidth) - 1);
+			int pixelMaximumY = std::min(static_cast<int>(floorf(maximumY - 0.5f)), static_cast<int>(mHeight) - 1);
+			if (pixelMinimumX > pixelMaximumX || pixelMinimumY > pixelMaximumY)
+			{
+				continue;
+			}
+
+			SetupTriangle triangle;
+			const float* edgeVertices[4] = { p0, p1, p2, p0 };
+			for (int edge = 0; edge < 3; edge++)
+			{
+				const float* from = edgeVertices[edge];
+				const float* to = edgeVertices[edge + 1];
+				triangle.EdgeA[edge] = from[1] - to[1];
+				triangle.EdgeB[edge] = to[0] - from[0];
+				triangle.EdgeC[edge] = -(triangle.EdgeA[edge] * from[0] + triangle.EdgeB[edge] * from[1]);
+			}
+
+			float reciprocalArea = 1.0f / area;
+			triangle.DepthA = ((p1[2] - p0[2]) * (p2[1] - p0[1]) - (p2[2] - p0[2]) * (p1[1] - p0[1])) * reciprocalArea;
+			triangle.DepthB = ((p2[2] - p0[2]) * (p1[0] - p0[0]) - (p1[2] - p0[2]) * (p2[0] - p0[0])) * reciprocalArea;
+			triangle.DepthC = p0[2] - triangle.DepthA * p0[0] - triangle.DepthB * p0[1];
+			triangle.MaximumDepth = std::max(std::max(p0[2], p1[2]), p2[2]);
+			triangle.TileMinimumX = pixelMinimumX / TileWidth;
+			triangle.TileMinimumY = pixelMinimumY / TileHeight;
+			triangle.TileMaximumX = pixelMaximumX / TileWidth;
+			triangle.TileMaximumY = pixelMaximumY / TileHeight;
+
+			triangles.push_back(triangle);
+		}
+	}
+
+	unsigned int OcclusionBuffer::RasterizeBand(unsigned int band)
+	{
+		unsigned int bandMinimumY = band * BandHeight;
+		unsigned int bandMaximumY = std::min(bandMinimumY + BandHeight, mTileCountY) - 1;
+		unsigned int tileUpdateCount = 0;
+		const __m128 pixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		const __m128 zero = _mm_setzero_ps();
+
+		for (const SetupTriangle* triangle : mBandTriangles[band])
+		{
+			__m128 edgeA[3];
+			__m128 edgeB[3];
+			__m128 edgeStepX[3];
+			__m128 edgeOffsets[3];
+			for (int edge = 0; edge < 3; edge++)
+			{
+				edgeA[edge] = _mm_set1_ps(triangle->EdgeA[edge]);
+				edgeB[edge] = _mm_set1_ps(triangle->EdgeB[edge]);
+				edgeStepX[edge] = _mm_set1_ps(triangle->EdgeA[edge] * 4.0f);
+				edgeOffsets[edge] = _mm_mul_ps(edgeA[edge], pixelOffsets);
+			}
+
+			unsigned int tileMinimumY = std::max(triangle->TileMinimumY, bandMinimumY);
+			unsigned int tileMaximumY = std::min(triangle->TileMaximumY, bandMaximumY);
+
+			for (unsigned int tileY = tileMinimumY; tileY <= tileMaximumY; tileY++)
+			{
+				float y = static_cast<float>(tileY * TileHeight);
+
+				for (unsigned int tileX = triangle->TileMinimumX; tileX <= triangle->TileMaximumX; tileX++)
+				{
+					float x = static_cast<float>(tileX * TileWidth);
+
+					unsigned int tile = tileY * mTileCountX + tileX;
+
+					// Farthest the depth plane gets over the tile's pixel centres, never past the triangle's own vertices
+					float depthX = x + (triangle->DepthA > 0.0f ? TileWidth - 0.5f : 0.5f);
+					float depthY = y + (triangle->DepthB > 0.0f ? TileHeight - 0.5f : 0.5f);
+					float depth = std::min(triangle->DepthA * depthX + triangle->DepthB * depthY + triangle->DepthC, triangle->MaximumDepth);
+					if (depth >= mFarDepth[tile])
+					{
+						continue;
+					}
+
+					// Each edge's extremes over the tile's pixel centres reject the tile or accept it whole without testing pixels
+					bool isOutside = false;
+					bool isInside = true;
+					for (int edge = 0; edge < 3 && isOutside == false; edge++)
+					{
+						float a = triangle->EdgeA[edge];
+						float b = triangle->EdgeB[edge];
+						float centre = a * (x + TileWidth * 0.5f) + b * (y + TileHeight * 0.5f) + triangle->EdgeC[edge];
+						float extent = fabsf(a) * (TileWidth - 1) * 0.5f + fabsf(b) * (TileHeight - 1) * 0.5f;
+						isOutside = (centre + extent < 0.0f);
+						isInside = isInside && (centre - extent >= 0.0f);
+					}
+
+					if (isOutside)
+					{
+						continue;
+					}
+
+					// Coverage of the 32 pixel centres, four at a time; bit (row * TileWidth + column)
+					unsigned int coverage = FullCoverage;
+					if (isInside == false)
+					{
+						coverage = 0;
+						__m128 rowValues[3];
+						for (int edge = 0; edge < 3; edge++)
+						{
+							float value = triangle->EdgeA[edge] * x + triangle->EdgeB[edge] * (y + 0.5f) + triangle->EdgeC[edge];
+							rowValues[edge] = _mm_add_ps(_mm_set1_ps(value), edgeOffsets[edge]);
+						}
+
+						for (unsigned int row = 0; row < TileHeight; row++)
+						{
+							__m128 values[3] = { rowValues[0], rowValues[1], rowValues[2] };
+							for (unsigned int column = 0; column < TileWidth; column += 4)
+							{
+								__m128 inside = _mm_and_ps(_mm_cmpge_ps(values[0], zero), _mm_and_ps(_mm_cmpge_ps(values[1], zero), _mm_cmpge_ps(values[2], zero)));
+								coverage |= static_cast<unsigned int>(_mm_movemask_ps(inside)) << (row * TileWidth + column);
+
+								for (int edge = 0; edge < 3; edge++)
+								{
+									values[edge] = _mm_add_ps(values[edge], edgeStepX[edge]);
+								}
+							}
+
+							for (int edge = 0; edge < 3; edge++)
+							{
+								rowValues[edge] = _mm_add_ps(rowValues[edge], edgeB[edge]);
+							}
+						}
+
+						if (coverage == 0)
+						{
+							continue;
+						}
+					}
+
+					// Pixels off the right or bottom edge of the screen count as covered, so edge tiles can still fill up
+					unsigned int visibleColumns = std::min(mWidth - tileX * TileWidth, TileWidth);
+					unsigned int visibleRows = std::min(mHeight - tileY * TileHeight, TileHeight);
+					if (visibleColumns < TileWidth || visibleRows < TileHeight)
+					{
+						unsigned int rowMask = (0xFFU << visibleColumns) & 0xFFU;
+						for (unsigned int row = 0; row < TileHeight; row++)
+						{
+							coverage |= (row < visibleRows ? rowMask : 0xFFU) << (row * TileWidth);
+						}
+					}
+
+					UpdateTile(tile, coverage, depth);
+					tileUpdateCount++;
+				}
+			}
+		}
+
+		return tileUpdateCount;
+	}
+
+	void OcclusionBuffer::UpdateTile(unsigned int tile, unsigned int coverage, float depth)
+	{
+		// A triangle behind the tile's farthest depth cannot hide anything more
+		if (depth >= mFarDepth[tile])
+		{
+			return;
+		}
+
+		// Start a new working layer when the triangle is much nearer than the current one, rather than pushing it back
+		float workingDistance = mWorkingDepth[tile] - depth;
+		float layerDistance = mFarDepth[tile] - mWorkingDepth[tile];
+		if (workingDistance > layerDistance)
+		{
+			mWorkingDepth[tile] = 0.0f;
+			mCoverage[tile] = 0;
+		}
+
+		mWorkingDepth[tile] = std::max(mWorkingDepth[tile], depth);
+		mCoverage[tile] |= coverage;
+
+		if (mCoverage[tile] == FullCoverage)
+		{
+			mFarDepth[tile] = mWorkingDepth[tile];
+			mWorkingDepth[tile] = 0.0f;
+			mCoverage[tile] = 0;
+		}
+	}
+
+	bool OcclusionBuffer::IsOccluded(unsigned int minimumX, unsigned int minimumY, unsigned int maximumX, unsigned int maximumY, float depth) const
+	{
+		unsigned int tileMinimumX = minimumX / TileWidth;
+		unsigned int tileMaximumX = maximumX / TileWidth;
+		__m128 depths = _mm_set1_ps(depth);
+
+		for (unsigned int tileY = minimumY / TileHeight; tileY <= maximumY / TileHeight; tileY++)
+		{
+			unsigned int firstRow = (tileY * TileHeight > minimumY ? 0 : minimumY - tileY * TileHeight);
+			unsigned int lastRow = std::min(maximumY - tileY * TileHeight, TileHeight - 1);
+
+			for (unsigned int tileX = tileMinimumX; tileX <= tileMaximumX; tileX += 4)
+			{
+				unsigned int tile = tileY * mTileCountX + tileX;
+				unsigned int laneCount = std::min(tileMaximumX - tileX + 1, 4U);
+				int nearer = _mm_movemask_ps(_mm_cmple_ps(depths, _mm_loadu_ps(&mFarDepth[tile]))) & ((1 << laneCount) - 1);
+
+				// Tiles that fail on their farthest depth can still hide the box if it only overlaps their working layer
+				for (unsigned int lane = 0; nearer != 0; lane++, nearer >>= 1)
+				{
+					if ((nearer & 1) == 0)
+					{
+						continue;
+					}
+
+					unsigned int x = (tileX + lane) * TileWidth;
+					unsigned int firstColumn = (x > minimumX ? 0 : minimumX - x);
+					unsigned int lastColumn = std::min(maximumX - x, TileWidth - 1);
+					unsigned int rowMask = (0xFFU << firstColumn) & (0xFFU >> (TileWidth - 1 - lastColumn));
+
+					unsigned int overlap = 0;
+					for (unsigned int row = firstRow; row <= lastRow; row++)
+					{
+						overlap |= rowMask << (row * TileWidth);
+					}
+
+					if ((overlap & ~mCoverage[tile + lane]) != 0 || depth <= mWorkingDepth[tile + lane])
+					{
+						return false;
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	unsigned int OcclusionBuffer::BandCount() const
+	{
+		return (mTileCountY + BandHeight - 1) / BandHeight;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+// Portable like LightClusters: occluder rasterization and box queries, shared by OcclusionCulling and OcclusionBenchmark
+#include <vector>
+
+namespace Library
+{
+	class ThreadPool;
+
+	enum OcclusionResult
+	{
+		OcclusionResultVisible = 0,
+		OcclusionResultOccluded,
+		OcclusionResultViewCulled,
+		OcclusionResultEnd
+	};
+
+	typedef struct _OcclusionBox
+	{
+		float Minimum[3];
+		float Maximum[3];
+	} OcclusionBox;
+
+	typedef struct _OcclusionStatistics
+	{
+		unsigned int OccluderCount;
+		unsigned int SubmittedTriangleCount;
+		unsigned int RasterizedTriangleCount;
+		unsigned int TileUpdateCount;
+	} OcclusionStatistics;
+
+	// Hierarchical depth buffer in the style of masked software occlusion culling. The screen is split into 8x4 pixel
+	// tiles, each holding a farthest depth for the whole tile, a working-layer depth and a coverage mask of the pixels
+	// that working layer reaches; no per-pixel depth is stored. Depth is the projection's z / w, so occluders and
+	// queries must use a D3D-style projection with 0 at the near plane and 1 at the far plane.
+	//
+	// Matrices are 16 floats laid out like XMFLOAT4X4 and transform row vectors, so &matrix._11 can be passed directly.
+	class OcclusionBuffer
+	{
+	public:
+		OcclusionBuffer(unsigned int width, unsigned int height);
+
+		unsigned int Width() const;
+		unsigned int Height() const;
+		unsigned int TileCountX() const;
+		unsigned int TileCountY() const;
+
+		void Resize(unsigned int width, unsigned int height);
+		void Clear();
+
+		// Queues a mesh of float3 positions spaced vertexStride bytes apart. Vertices, indices and the matrix are referenced,
+		// not copied, until Rasterize(). Clockwise triangles face the viewer, as with D3D11's default rasterizer state.
+		void AddOccluder(const float* vertices, unsigned int vertexStride, const unsigned int* indices, unsigned int triangleCount, const float* worldViewProjectionMatrix);
+
+		// Triangles are set up in parallel batches and then rasterized in bands of tile rows, so the result does not
+		// depend on the thread count
+		void Rasterize(ThreadPool* threadPool = nullptr);
+
+		OcclusionResult TestBox(const OcclusionBox& box, const float* viewProjectionMatrix) const;
+		void TestBoxes(const std::vector<OcclusionBox>& boxes, const float* viewProjectionMatrix, std::vector<OcclusionResult>& results, ThreadPool* threadPool = nullptr) const;
+
+		// Farthest depth each pixel can have, expanded from the tiles; for debugging views and verification
+		void ResolveDepth(std::vector<float>& depth) const;
+
+		const OcclusionStatistics& Statistics() const;
+
+		static const unsigned int TileWidth;
+		static const unsigned int TileHeight;
+		static const unsigned int BandHeight;
+		static const unsigned int SetupBatchSize;
+
+	private:
+		typedef struct _Occluder
+		{
+			const float* Vertices;
+			unsigned int VertexStride;
+			const unsigned int* Indices;
+			unsigned int TriangleCount;
+			const float* Matrix;
+		} Occluder;
+
+		// Screen-space triangle: edge functions are positive inside, depth is a plane over pixel coordinates
+		typedef struct _SetupTriangle
+		{
+			float EdgeA[3];
+			float EdgeB[3];
+			float EdgeC[3];
+			float DepthA;
+			float DepthB;
+			float DepthC;
+			float MaximumDepth;
+			unsigned int TileMinimumX;
+			unsigned int TileMinimumY;
+			unsigned int TileMaximumX;
+			unsigned int TileMaximumY;
+		} SetupTriangle;
+
+		OcclusionBuffer(const OcclusionBuffer& rhs);
+		OcclusionBuffer& operator=(const OcclusionBuffer& rhs);
+
+		void SetupTriangles(unsigned int begin, unsigned int end, std::vector<SetupTriangle>& triangles) const;
+		void SetupPolygon(const float (*vertices)[4], unsigned int vertexCount, std::vector<SetupTriangle>& triangles) const;
+		unsigned int RasterizeBand(unsigned int band);
+		void UpdateTile(unsigned int tile, unsigned int coverage, float depth);
+		bool IsOccluded(unsigned int minimumX, unsigned int minimumY, unsigned int maximumX, unsigned int maximumY, float depth) const;
+		unsigned int BandCount() const;
+
+		unsigned int mWidth;
+		unsigned int mHeight;
+		unsigned int mTileCountX;
+		unsigned int mTileCountY;
+
+		// Tile layers as separate arrays, padded so four tiles of a row load at once
+		std::vector<float> mFarDepth;
+		std::vector<float> mWorkingDepth;
+		std::vector<unsigned int> mCoverage;
+
+		std::vector<Occluder> mOccluders;
+		std::vector<unsigned int> mTriangleOffsets;
+		std::vector<std::vector<SetupTriangle>> mBatchTriangles;
+		std::vector<std::vector<const SetupTriangle*>> mBandTriangles;
+		OcclusionStatistics mStatistics;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "OcclusionCulling.h"
+#include "Game.h"
+#include "Camera.h"
+#include "Frustum.h"
+#include "Mesh.h"
+#include "ThreadPool.h"
+
+namespace Library
+{
+	const UINT OcclusionCulling::DefaultWidth = 640;
+	const UINT OcclusionCulling::DefaultHeight = 360;
+
+	OcclusionCulling::OcclusionCulling(Game& game, UINT width, UINT height)
+		: mGame(&game), mBuffer(width, height), mOccluders(), mNextOccluder(0),
+		  mFrustumVisibleBoxes(), mFrustumVisibleObjects(), mResults(), mStatistics()
+	{
+	}
+
+	UINT OcclusionCulling::AddOccluder(const Mesh& mesh, CXMMATRIX worldMatrix)
+	{
+		return AddOccluder(mesh.Vertices(), mesh.Indices(), worldMatrix);
+	}
+
+	UINT OcclusionCulling::AddOccluder(const std::vector<XMFLOAT3>& vertices, const std::vector<UINT>& indices, CXMMATRIX worldMatrix)
+	{
+		Occluder& occluder = mOccluders[mNextOccluder];
+		occluder.Vertices = vertices;
+		occluder.Indices = indices;
+
+		XMVECTOR minimum = g_XMFltMax;
+		XMVECTOR maximum = -g_XMFltMax;
+		for (const XMFLOAT3& vertex : vertices)
+		{
+			XMVECTOR position = XMLoadFloat3(&vertex);
+			minimum = XMVectorMin(minimum, position);
+			maximum = XMVectorMax(maximum, position);
+		}
+
+		XMStoreFloat3(&occluder.Minimum, minimum);
+		XMStoreFloat3(&occluder.Maximum, maximum);
+		XMStoreFloat4x4(&occluder.WorldMatrix, worldMatrix);
+
+		return mNextOccluder++;
+	}
+
+	void OcclusionCulling::RemoveOccluder(UINT occluder)
+	{
+		mOccluders.erase(occluder);
+	}
+
+	void OcclusionCulling::SetOccluderWorldMatrix(UINT occluder, CXMMATRIX worldMatrix)
+	{
+		auto it = mOccluders.find(occluder);
+		if (it != mOccluders.end())
+		{
+			XMStoreFloat4x4(&it->second.WorldMatrix, worldMatrix);
+		}
+	}
+
+	void OcclusionCulling::Cull(const Camera& camera, const std::vector<OcclusionBox>& boxes, std::vector<UINT>& visibleObjects)
+	{
+		ZeroMemory(&mStatistics, sizeof(mStatistics));
+		mStatistics.ObjectCount = static_cast<UINT>(boxes.size());
+
+		XMMATRIX viewProjectionMatrix = camera.ViewProjectionMatrix();
+		XMFLOAT4X4 viewProjection;
+		XMStoreFloat4x4(&viewProjection, viewProjectionMatrix);
+		Frustum frustum(viewProjectionMatrix);
+
+		mBuffer.Clear();
+		for (auto& occluder : mOccluders)
+		{
+			Occluder& value = occluder.second;
+			if (value.Indices.empty() || Intersects(frustum, value) == false)
+			{
+				continue;
+			}
+
+			XMStoreFloat4x4(&value.WorldViewProjectionMatrix, XMLoadFloat4x4(&value.WorldMatrix) * viewProjectionMatrix);
+			mBuffer.AddOccluder(&value.Vertices[0].x, sizeof(XMFLOAT3), &value.Indices[0], static_cast<UINT>(value.Indices.size() / 3), &value.WorldViewProjectionMatrix._11);
+			mStatistics.DrawnOccluderCount++;
+			mStatistics.OccluderTriangleCount += static_cast<UINT>(value.Indices.size() / 3);
+		}
+
+		mBuffer.Rasterize(&mGame->WorkerThreads());
+
+		// Only boxes inside the frustum reach the depth buffer
+		mFrustumVisibleBoxes.clear();
+		mFrustumVisibleObjects.clear();
+		for (UINT i = 0; i < boxes.size(); i++)
+		{
+			const OcclusionBox& box = boxes[i];
+			if (Intersects(frustum, XMFLOAT3(box.Minimum), XMFLOAT3(box.Maximum)))
+			{
+				mFrustumVisibleBoxes.push_back(box);
+				mFrustumVisibleObjects.push_back(i);
+			}
+		}
+
+		mStatistics.FrustumCulledCount = static_cast<UINT>(boxes.size() - mFrustumVisibleBoxes.size());
+		mBuffer.TestBoxes(mFrustumVisibleBoxes, &viewProjection._11, mResults, &mGame->WorkerThreads());
+
+		visibleObjects.clear();
+		for (UINT i = 0; i < mResults.size(); i++)
+		{
+			if (mResults[i] == OcclusionResultVisible)
+			{
+				visibleObjects.push_back(mFrustumVisibleObjects[i]);
+			}
+			else if (mResults[i] == OcclusionResultOccluded)
+			{
+				mStatistics.OcclusionCulledCount++;
+			}
+			else
+			{
+				mStatistics.FrustumCulledCount++;
+			}
+		}
+	}
+
+	const OcclusionBuffer& OcclusionCulling::Buffer() const
+	{
+		return mBuffer;
+	}
+
+	const OcclusionCullingStatistics& OcclusionCulling::Statistics() const
+	{
+		return mStatistics;
+	}
+
+	bool OcclusionCulling::Intersects(const Frustum& frustum, const XMFLOAT3& minimum, const XMFLOAT3& maximum)
+	{
+		// Frustum planes face outward, so a box is outside when its corner farthest against a plane's normal is in front of it
+		XMVECTOR boxMinimum = XMLoadFloat3(&minimum);
+		XMVECTOR boxMaximum = XMLoadFloat3(&maximum);
+		XMVECTOR planes[] = { frustum.NearVector(), frustum.FarVector(), frustum.LeftVector(), frustum.RightVector(), frustum.TopVector(), frustum.BottomVector() };
+		for (const XMVECTOR& plane : planes)
+		{
+			XMVECTOR corner = XMVectorSelect(boxMaximum, boxMinimum, XMVectorGreater(plane, XMVectorZero()));
+			if (XMVectorGetX(XMPlaneDotCoord(plane, corner)) > 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool OcclusionCulling::Intersects(const Frustum& frustum, const Occluder& occluder)
+	{
+		XMMATRIX worldMatrix = XMLoadFloat4x4(&occluder.WorldMatrix);
+		XMVECTOR minimum = g_XMFltMax;
+		XMVECTOR maximum = -g_XMFltMax;
+		for (UINT corner = 0; corner < 8; corner++)
+		{
+			XMVECTOR position = XMVectorSet((corner & 1 ? occluder.Maximum.x : occluder.Minimum.x), (corner & 2 ? occluder.Maximum.y : occluder.Minimum.y), (corner & 4 ? occluder.Maximum.z : occluder.Minimum.z), 1.0f);
+			position = XMVector3TransformCoord(position, worldMatrix);
+			minimum = XMVectorMin(minimum, position);
+			maximum = XMVectorMax(maximum, position);
+		}
+
+		XMFLOAT3 worldMinimum;
+		XMFLOAT3 worldMaximum;
+		XMStoreFloat3(&worldMinimum, minimum);
+		XMStoreFloat3(&worldMaximum, maximum);
+
+		return Intersects(frustum, worldMinimum, worldMaximum);
+	}
+}
\ No newline at end of file
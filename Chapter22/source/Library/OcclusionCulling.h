@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Common.h"
+#include "OcclusionBuffer.h"
+
+namespace Library
+{
+	class Game;
+	class Camera;
+	class Frustum;
+	class Mesh;
+
+	typedef struct _OcclusionCullingStatistics
+	{
+		UINT ObjectCount;
+		UINT FrustumCulledCount;
+		UINT OcclusionCulledCount;
+		UINT DrawnOccluderCount;
+		UINT OccluderTriangleCount;
+	} OcclusionCullingStatistics;
+
+	// Culls object bounding boxes against the camera's frustum and then against a software depth buffer of the
+	// registered occluders. Occluders should be cheap, closed stand-ins for large objects (building shells, terrain
+	// chunks); their meshes are copied when added, so only the world matrix needs updating afterwards.
+	class OcclusionCulling
+	{
+	public:
+		OcclusionCulling(Game& game, UINT width = DefaultWidth, UINT height = DefaultHeight);
+
+		UINT AddOccluder(const Mesh& mesh, CXMMATRIX worldMatrix);
+		UINT AddOccluder(const std::vector<XMFLOAT3>& vertices, const std::vector<UINT>& indices, CXMMATRIX worldMatrix);
+		void RemoveOccluder(UINT occluder);
+		void SetOccluderWorldMatrix(UINT occluder, CXMMATRIX worldMatrix);
+
+		// Fills visibleObjects with the indices of the boxes that survive both tests, in order
+		void Cull(const Camera& camera, const std::vector<OcclusionBox>& boxes, std::vector<UINT>& visibleObjects);
+
+		const OcclusionBuffer& Buffer() const;
+		const OcclusionCullingStatistics& Statistics() const;
+
+		static const UINT DefaultWidth;
+		static const UINT DefaultHeight;
+
+	private:
+		typedef struct _Occluder
+		{
+			std::vector<XMFLOAT3> Vertices;
+			std::vector<UINT> Indices;
+			XMFLOAT3 Minimum;
+			XMFLOAT3 Maximum;
+			XMFLOAT4X4 WorldMatrix;
+			XMFLOAT4X4 WorldViewProjectionMatrix;
+		} Occluder;
+
+		OcclusionCulling();
+		OcclusionCulling(const OcclusionCulling& rhs);
+		OcclusionCulling& operator=(const OcclusionCulling& rhs);
+
+		static bool Intersects(const Frustum& frustum, const XMFLOAT3& minimum, const XMFLOAT3& maximum);
+		static bool Intersects(const Frustum& frustum, const Occluder& occluder);
+
+		Game* mGame;
+		OcclusionBuffer mBuffer;
+		std::map<UINT, Occluder> mOccluders;
+		UINT mNextOccluder;
+		std::vector<OcclusionBox> mFrustumVisibleBoxes;
+		std::vector<UINT> mFrustumVisibleObjects;
+		std::vector<OcclusionResult> mResults;
+		OcclusionCullingStatistics mStatistics;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,382 @@
+#include "PNGWriter.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace Library
+{
+	namespace
+	{
+		const unsigned char Signature[] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+		const unsigned char ColorTypeRGB = 2;
+		const unsigned char ColorTypeRGBA = 6;
+		const unsigned char FilterPaeth = 4;
+		const unsigned int AdlerModulus = 65521;
+		const unsigned int AdlerBlockSize = 5552;
+
+		const unsigned short LengthBases[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		const unsigned char LengthExtraBits[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		const unsigned short DistanceBases[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+			4097, 6145, 8193, 12289, 16385, 24577 };
+		const unsigned char DistanceExtraBits[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+		unsigned int ReverseBits(unsigned int code, unsigned int length)
+		{
+			unsigned int reversed = 0;
+			for (unsigned int i = 0; i < length; i++)
+			{
+				reversed = (reversed << 1) | ((code >> i) & 1);
+			}
+
+			return reversed;
+		}
+
+		// Built before main(), so encoders on several threads never race to fill them in
+		typedef struct _DeflateTables
+		{
+			unsigned short LiteralCodes[288];
+			unsigned char LiteralLengths[288];
+			unsigned short DistanceCodes[30];
+			unsigned char LengthIndices[259];
+			unsigned char DistanceIndices[512];
+			unsigned int Crc[256];
+
+			_DeflateTables()
+			{
+				// The fixed Huffman code, bit reversed, since deflate packs Huffman codes most significant bit first
+				for (unsigned int symbol = 0; symbol < 288; symbol++)
+				{
+					unsigned int code;
+					unsigned int length;
+					if (symbol < 144)
+					{
+						code = 0x30 + symbol;
+						length = 8;
+					}
+					else if (symbol < 256)
+					{
+						code = 0x190 + symbol - 144;
+						length = 9;
+					}
+					else if (symbol < 280)
+					{
+						code = symbol - 256;
+						length = 7;
+					}
+					else
+					{
+						code = 0xC0 + symbol - 280;
+						length = 8;
+					}
+
+					LiteralCodes[symbol] = static_cast<unsigned short>(ReverseBits(code, length));
+					LiteralLengths[symbol] = static_cast<unsigned char>(length);
+				}
+
+				for (unsigned int i = 0; i < 30; i++)
+				{
+					DistanceCodes[i] = static_cast<unsigned short>(ReverseBits(i, 5));
+				}
+
+				for (unsigned int i = 0; i < 29; i++)
+				{
+					unsigned int last = (i == 28 ? 258 : LengthBases[i] + (1U << LengthExtraBits[i]) - 1);
+					for (unsigned int length = LengthBases[i]; length <= last; length++)
+					{
+						LengthIndices[length] = static_cast<unsigned char>(i);
+					}
+				}
+
+				// zlib's lookup: distances to 256 directly, longer ones by their high bits
+				for (unsigned int i = 0; i < 30; i++)
+				{
+					for (unsigned int distance = DistanceBases[i]; distance < DistanceBases[i] + (1U << DistanceExtraBits[i]); distance++)
+					{
+						unsigned int offset = distance - 1;
+						DistanceIndices[offset < 256 ? offset : 256 + (offset >> 7)] = static_cast<unsigned char>(i);
+					}
+				}
+
+				for (unsigned int i = 0; i < 256; i++)
+				{
+					unsigned int crc = i;
+					for (unsigned int bit = 0; bit < 8; bit++)
+					{
+						crc = ((crc & 1) != 0 ? 0xEDB88320 ^ (crc >> 1) : crc >> 1);
+					}
+
+					Crc[i] = crc;
+				}
+			}
+		} DeflateTables;
+
+		const DeflateTables Tables;
+
+		// Deflate packs bits from the least significant end of each byte
+		class BitWriter
+		{
+		public:
+			BitWriter(std::vector<unsigned char>& output)
+				: mOutput(&output), mBits(0), mBitCount(0)
+			{
+			}
+
+			void Write(unsigned int bits, unsigned int count)
+			{
+				mBits |= static_cast<unsigned long long>(bits) << mBitCount;
+				mBitCount += count;
+				while (mBitCount >= 8)
+				{
+					mOutput->push_back(static_cast<unsigned char>(mBits));
+					mBits >>= 8;
+					mBitCount -= 8;
+				}
+			}
+
+			void Flush()
+			{
+				if (mBitCount > 0)
+				{
+					mOutput->push_back(static_cast<unsigned char>(mBits));
+				}
+
+				mBits = 0;
+				mBitCount = 0;
+			}
+
+		private:
+			std::vector<unsigned char>* mOutput;
+			unsigned long long mBits;
+			unsigned int mBitCount;
+		};
+
+		void AppendBigEndian(std::vector<unsigned char>& output, unsigned int value)
+		{
+			output.push_back(static_cast<unsigned char>(value >> 24));
+			output.push_back(static_cast<unsigned char>(value >> 16));
+			output.push_back(static_cast<unsigned char>(value >> 8));
+			output.push_back(static_cast<unsigned char>(value));
+		}
+
+		unsigned char Paeth(int left, int up, int upLeft)
+		{
+			int estimate = left + up - upLeft;
+			int leftDistance = abs(estimate - left);
+			int upDistance = abs(estimate - up);
+			int upLeftDistance = abs(estimate - upLeft);
+
+			if (leftDistance <= upDistance && leftDistance <= upLeftDistance)
+			{
+				return static_cast<unsigned char>(left);
+			}
+
+			return static_cast<unsigned char>(upDistance <= upLeftDistance ? up : upLeft);
+		}
+	}
+
+	const unsigned int PNGWriter::HashBits = 15;
+	const unsigned int PNGWriter::WindowSize = 32768;
+	const unsigned int PNGWriter::MaximumMatchLength = 258;
+
+	void PNGWriter::Encode(const unsigned char* pixels, unsigned int width, unsigned int height, unsigned int rowPitch, bool isBGRA, bool isOpaque, std::vector<unsigned char>& output)
+	{
+		unsigned int channelCount = (isOpaque ? 3 : 4);
+		if (pixels == nullptr || width == 0 || height == 0 || rowPitch < width * 4 || width > 0x7FFFFFFF / 4)
+		{
+			throw std::runtime_error("Invalid PNG image description.");
+		}
+
+		// Each row is its filter type and then the Paeth differences; the first row's "up" neighbours are zero
+		size_t filteredRowSize = 1 + static_cast<size_t>(width) * channelCount;
+		std::vector<unsigned char> filtered(filteredRowSize * height);
+		std::vector<unsigned char> previousRow(width * channelCount, 0);
+		std::vector<unsigned char> row(width * channelCount);
+		unsigned int red = (isBGRA ? 2 : 0);
+		unsigned int blue = (isBGRA ? 0 : 2);
+
+		for (unsigned int y = 0; y < height; y++)
+		{
+			const unsigned char* source = pixels + static_cast<size_t>(y) * rowPitch;
+			for (unsigned int x = 0; x < width; x++)
+			{
+				unsigned char* texel = &row[x * channelCount];
+				texel[0] = source[x * 4 + red];
+				texel[1] = source[x * 4 + 1];
+				texel[2] = source[x * 4 + blue];
+				if (isOpaque == false)
+				{
+					texel[3] = source[x * 4 + 3];
+				}
+			}
+
+			unsigned char* destination = &filtered[y * filteredRowSize];
+			destination[0] = FilterPaeth;
+			for (unsigned int i = 0; i < row.size(); i++)
+			{
+				int left = (i >= channelCount ? row[i - channelCount] : 0);
+				int upLeft = (i >= channelCount ? previousRow[i - channelCount] : 0);
+				destination[1 + i] = static_cast<unsigned char>(row[i] - Paeth(left, previousRow[i], upLeft));
+			}
+
+			row.swap(previousRow);
+		}
+
+		std::vector<unsigned char> compressed;
+		compressed.reserve(filtered.size() / 4 + 1024);
+		compressed.push_back(0x78);
+		compressed.push_back(0x01);
+		Deflate(filtered, compressed);
+		AppendBigEndian(compressed, Adler32(&filtered[0], filtered.size()));
+
+		unsigned char header[13];
+		header[0] = static_cast<unsigned char>(width >> 24);
+		header[1] = static_cast<unsigned char>(width >> 16);
+		header[2] = static_cast<unsigned char>(width >> 8);
+		header[3] = static_cast<unsigned char>(width);
+		header[4] = static_cast<unsigned char>(height >> 24);
+		header[5] = static_cast<unsigned char>(height >> 16);
+		header[6] = static_cast<unsigned char>(height >> 8);
+		header[7] = static_cast<unsigned char>(height);
+		header[8] = 8;
+		header[9] = (isOpaque ? ColorTypeRGB : ColorTypeRGBA);
+		header[10] = 0;
+		header[11] = 0;
+		header[12] = 0;
+
+		output.clear();
+		output.reserve(sizeof(Signature) + 3 * 12 + sizeof(header) + compressed.size());
+		output.insert(output.end(), Signature, Signature + sizeof(Signature));
+		WriteChunk("IHDR", header, sizeof(header), output);
+		WriteChunk("IDAT", &compressed[0], compressed.size(), output);
+		WriteChunk("IEND", nullptr, 0, output);
+	}
+
+	void PNGWriter::Write(const std::string& filename, const unsigned char* pixels, unsigned int width, unsigned int height, unsigned int rowPitch, bool isBGRA, bool isOpaque)
+	{
+		std::vector<unsigned char> data;
+		Encode(pixels, width, height, rowPitch, isBGRA, isOpaque, data);
+
+		std::ofstream file(filename.c_str(), std::ios::binary);
+		if (!file)
+		{
+			throw std::runtime_error("Could not create the PNG file.");
+		}
+
+		file.write(reinterpret_cast<const char*>(&data[0]), data.size());
+		if (!file)
+		{
+			throw std::runtime_error("Could not write the PNG file.");
+		}
+	}
+
+	unsigned int PNGWriter::Crc32(const unsigned char* data, size_t size, unsigned int crc)
+	{
+		crc = ~crc;
+		for (size_t i = 0; i < size; i++)
+		{
+			crc = Tables.Crc[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		}
+
+		return ~crc;
+	}
+
+	unsigned int PNGWriter::Adler32(const unsigned char* data, size_t size)
+	{
+		unsigned int a = 1;
+		unsigned int b = 0;
+		while (size > 0)
+		{
+			size_t blockSize = (size < AdlerBlockSize ? size : AdlerBlockSize);
+			for (size_t i = 0; i < blockSize; i++)
+			{
+				a += data[i];
+				b += a;
+			}
+
+			a %= AdlerModulus;
+			b %= AdlerModulus;
+			data += blockSize;
+			size -= blockSize;
+		}
+
+		return (b << 16) | a;
+	}
+
+	void PNGWriter::Deflate(const std::vector<unsigned char>& input, std::vector<unsigned char>& output)
+	{
+		BitWriter writer(output);
+
+		// One final block with the fixed Huffman code
+		writer.Write(1, 1);
+		writer.Write(1, 2);
+
+		// The latest position, plus one, each hash of three bytes was seen at
+		std::vector<unsigned int> head(static_cast<size_t>(1) << HashBits, 0);
+		const unsigned char* data = &input[0];
+		size_t size = input.size();
+		size_t position = 0;
+
+		while (position < size)
+		{
+			unsigned int matchLength = 0;
+			size_t matchDistance = 0;
+			if (position + 3 <= size)
+			{
+				unsigned int hash = ((data[position] << 16) | (data[position + 1] << 8) | data[position + 2]) * 2654435761U >> (32 - HashBits);
+				size_t candidate = head[hash];
+				head[hash] = static_cast<unsigned int>(position + 1);
+
+				if (candidate != 0 && position - (candidate - 1) <= WindowSize)
+				{
+					const unsigned char* match = data + candidate - 1;
+					const unsigned char* current = data + position;
+					size_t longest = (size - position < MaximumMatchLength ? size - position : MaximumMatchLength);
+					while (matchLength < longest && match[matchLength] == current[matchLength])
+					{
+						matchLength++;
+					}
+
+					matchDistance = position - (candidate - 1);
+				}
+			}
+
+			if (matchLength >= 3)
+			{
+				unsigned int lengthIndex = Tables.LengthIndices[matchLength];
+				unsigned int lengthSymbol = 257 + lengthIndex;
+				writer.Write(Tables.LiteralCodes[lengthSymbol], Tables.LiteralLengths[lengthSymbol]);
+				writer.Write(matchLength - LengthBases[lengthIndex], LengthExtraBits[lengthIndex]);
+
+				size_t offset = matchDistance - 1;
+				unsigned int distanceIndex = Tables.DistanceIndices[offset < 256 ? offset : 256 + (offset >> 7)];
+				writer.Write(Tables.DistanceCodes[distanceIndex], 5);
+				writer.Write(static_cast<unsigned int>(matchDistance - DistanceBases[distanceIndex]), DistanceExtraBits[distanceIndex]);
+
+				position += matchLength;
+			}
+			else
+			{
+				writer.Write(Tables.LiteralCodes[data[position]], Tables.LiteralLengths[data[position]]);
+				position++;
+			}
+		}
+
+		writer.Write(Tables.LiteralCodes[256], Tables.LiteralLengths[256]);
+		writer.Flush();
+	}
+
+	void PNGWriter::WriteChunk(const char* type, const unsigned char* data, size_t size, std::vector<unsigned char>& output)
+	{
+		AppendBigEndian(output, static_cast<unsigned int>(size));
+
+		size_t typeOffset = output.size();
+		output.insert(output.end(), type, type + 4);
+		if (size > 0)
+		{
+			output.insert(output.end(), data, data + size);
+		}
+
+		AppendBigEndian(output, Crc32(&output[typeOffset], size + 4));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+// Portable, like DDSWriter: frame captures are encoded on worker threads, and CaptureTool runs without Windows
+#include <string>
+#include <vector>
+
+namespace Library
+{
+	// Writes 8-bit images as PNG files, every row Paeth filtered and compressed as one fixed-Huffman deflate block. The
+	// LZ77 pass keeps only the latest position for each hash and takes the first match it finds, so it is many times
+	// quicker than zlib's default level, which a 60 fps capture can't wait for, at the cost of larger files.
+	class PNGWriter
+	{
+	public:
+		// Rows of width RGBA pixels, rowPitch bytes apart, or BGRA when isBGRA is set. Opaque images are written without
+		// their alpha channel, as back buffers' alpha means nothing. Throws std::runtime_error.
+		static void Encode(const unsigned char* pixels, unsigned int width, unsigned int height, unsigned int rowPitch, bool isBGRA, bool isOpaque, std::vector<unsigned char>& output);
+		static void Write(const std::string& filename, const unsigned char* pixels, unsigned int width, unsigned int height, unsigned int rowPitch, bool isBGRA, bool isOpaque);
+
+		static unsigned int Crc32(const unsigned char* data, size_t size, unsigned int crc = 0);
+		static unsigned int Adler32(const unsigned char* data, size_t size);
+
+	private:
+		PNGWriter();
+		PNGWriter(const PNGWriter& rhs);
+		PNGWriter& operator=(const PNGWriter& rhs);
+
+		static void Deflate(const std::vector<unsigned char>& input, std::vector<unsigned char>& output);
+		static void WriteChunk(const char* type, const unsigned char* data, size_t size, std::vector<unsigned char>& output);
+
+		static const unsigned int HashBits;
+		static const unsigned int WindowSize;
+		static const unsigned int MaximumMatchLength;
+	};
+}
\ No newline at end of file
@@ -44,4 +44,17 @@ namespace Library
 	{
 		mPass->Apply(flags, context);
 	}
+
+	void Pass::Rebind(ID3DX11EffectPass* pass)
+	{
+		mPass = pass;
+		if (mPass->IsValid())
+		{
+			mPass->GetDesc(&mPassDesc);
+		}
+		else
+		{
+			ZeroMemory(&mPassDesc, sizeof(mPassDesc));
+		}
+	}
 }
\ No newline at end of file
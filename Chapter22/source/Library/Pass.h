@@ -19,6 +19,7 @@ namespace Library
 
         void CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC* inputElementDesc, UINT numElements,  ID3D11InputLayout **inputLayout);
         void Apply(UINT flags, ID3D11DeviceContext* context);
+        void Rebind(ID3DX11EffectPass* pass);
 
     private:
         Pass(const Pass& rhs);
@@ -0,0 +1,227 @@
+#include "PostProcessExecutor.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Utility.h"
+#include "ContentManager.h"
+#include "Effect.h"
+#include "PostProcessMaterial.h"
+#include "FullScreenQuad.h"
+
+namespace Library
+{
+	RTTI_DEFINITIONS(PostProcessExecutor)
+
+	const UINT PostProcessExecutor::ThreadsPerGroup = 16;
+
+	PostProcessExecutor::PostProcessExecutor(Game& game, const PostProcessGraph& graph)
+		: DrawableGameComponent(game),
+		  mGraph(graph), mEffect(), mMaterial(nullptr), mComputePasses(), mFullScreenQuad(nullptr), mSlots(), mBlurWeights(),
+		  mSceneTexture(nullptr), mBloomTexture(nullptr)
+	{
+		if (mGraph.IsCompiled() == false)
+		{
+			mGraph.Compile();
+		}
+
+		PostProcessGraph::ComputeBlurWeights(mGraph.Settings().BlurAmount, mBlurWeights);
+	}
+
+	PostProcessExecutor::~PostProcessExecutor()
+	{
+		for (SlotResources& slot : mSlots)
+		{
+			ReleaseObject(slot.UnorderedAccessView);
+			ReleaseObject(slot.ShaderResourceView);
+		}
+
+		DeleteObject(mFullScreenQuad);
+		DeleteObject(mMaterial);
+	}
+
+	const PostProcessGraph& PostProcessExecutor::Graph() const
+	{
+		return mGraph;
+	}
+
+	const PostProcessSettings& PostProcessExecutor::Settings() const
+	{
+		return mGraph.Settings();
+	}
+
+	void PostProcessExecutor::SetSettings(const PostProcessSettings& settings)
+	{
+		mGraph.SetSettings(settings);
+		PostProcessGraph::ComputeBlurWeights(settings.BlurAmount, mBlurWeights);
+	}
+
+	ID3D11ShaderResourceView* PostProcessExecutor::SceneTexture() const
+	{
+		return mSceneTexture;
+	}
+
+	void PostProcessExecutor::SetSceneTexture(ID3D11ShaderResourceView& sceneTexture)
+	{
+		mSceneTexture = &sceneTexture;
+	}
+
+	PostProcessBandwidth PostProcessExecutor::Bandwidth() const
+	{
+		return mGraph.Bandwidth(mGame->ScreenWidth(), mGame->ScreenHeight());
+	}
+
+	void PostProcessExecutor::Initialize()
+	{
+		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
+
+		mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\PostProcess.cso");
+
+		mMaterial = new PostProcessMaterial();
+		mMaterial->Initialize(*mEffect);
+
+		const std::map<std::string, Technique*>& techniques = mEffect->TechniquesByName();
+		mComputePasses[PostProcessPassTypeExtract] = techniques.at("extract")->PassesByName().at("p0");
+		mComputePasses[PostProcessPassTypeDownsample] = techniques.at("downsample")->PassesByName().at("p0");
+		mComputePasses[PostProcessPassTypeHorizontalBlur] = techniques.at("horizontal_blur")->PassesByName().at("p0");
+		mComputePasses[PostProcessPassTypeVerticalBlur] = techniques.at("vertical_blur")->PassesByName().at("p0");
+
+		mFullScreenQuad = new FullScreenQuad(*mGame, *mMaterial);
+		mFullScreenQuad->Initialize();
+		mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&PostProcessExecutor::UpdateCompositeMaterial, this));
+
+		// One texture per aliased slot rather than per pass
+		mSlots.resize(mGraph.SlotDivisors().size());
+		for (UINT i = 0; i < mSlots.size(); i++)
+		{
+			CreateSlot(mGraph.SlotDivisors()[i], mSlots[i]);
+		}
+	}
+
+	void PostProcessExecutor::Draw(const GameTime& gameTime)
+	{
+		assert(mSceneTexture != nullptr);
+
+		if (mGraph.Settings().BloomThreshold >= 1.0f)
+		{
+			mBloomTexture = nullptr;
+			mFullScreenQuad->SetActiveTechnique("copy", "p0");
+			mFullScreenQuad->Draw(gameTime);
+			mGame->UnbindPixelShaderResources(0, 1);
+
+			return;
+		}
+
+		for (const PostProcessPass& pass : mGraph.Passes())
+		{
+			if (pass.Output == PostProcessGraph::OutputTexture)
+			{
+				DrawComposite(pass, gameTime);
+			}
+			else
+			{
+				DispatchPass(pass);
+			}
+		}
+	}
+
+	void PostProcessExecutor::CreateSlot(UINT divisor, SlotResources& slot)
+	{
+		// Written by compute shaders and only ever read by later passes: no render target view, depth buffer or clear
+		D3D11_TEXTURE2D_DESC textureDesc;
+		ZeroMemory(&textureDesc, sizeof(textureDesc));
+		textureDesc.Width = PostProcessGraph::ScaledSize(mGame->ScreenWidth(), divisor);
+		textureDesc.Height = PostProcessGraph::ScaledSize(mGame->ScreenHeight(), divisor);
+		textureDesc.MipLevels = 1;
+		textureDesc.ArraySize = 1;
+		textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		textureDesc.SampleDesc.Count = 1;
+		textureDesc.SampleDesc.Quality = 0;
+		textureDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE;
+
+		HRESULT hr;
+		ID3D11Texture2D* texture = nullptr;
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateTexture2D(&textureDesc, nullptr, &texture)))
+		{
+			throw GameException("IDXGIDevice::CreateTexture2D() failed.", hr);
+		}
+
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateUnorderedAccessView(texture, nullptr, &slot.UnorderedAccessView)))
+		{
+			ReleaseObject(texture);
+			throw GameException("IDXGIDevice::CreateUnorderedAccessView() failed.", hr);
+		}
+
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateShaderResourceView(texture, nullptr, &slot.ShaderResourceView)))
+		{
+			ReleaseObject(texture);
+			throw GameException("IDXGIDevice::CreateShaderResourceView() failed.", hr);
+		}
+
+		ReleaseObject(texture);
+
+		slot.Width = textureDesc.Width;
+		slot.Height = textureDesc.Height;
+	}
+
+	ID3D11ShaderResourceView* PostProcessExecutor::ShaderResourceView(int texture) const
+	{
+		if (texture == PostProcessGraph::SceneTexture)
+		{
+			return mSceneTexture;
+		}
+
+		int slot = mGraph.Textures()[texture].Slot;
+		assert(slot >= 0);
+
+		return mSlots[slot].ShaderResourceView;
+	}
+
+	void PostProcessExecutor::DispatchPass(const PostProcessPass& pass)
+	{
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		const std::vector<PostProcessTexture>& textures = mGraph.Textures();
+		const PostProcessTexture& source = textures[pass.Inputs[0]];
+		const SlotResources& destination = mSlots[textures[pass.Output].Slot];
+
+		float sourceWidth = static_cast<float>(PostProcessGraph::ScaledSize(mGame->ScreenWidth(), source.Divisor));
+		float sourceHeight = static_cast<float>(PostProcessGraph::ScaledSize(mGame->ScreenHeight(), source.Divisor));
+
+		mMaterial->SourceSize() << XMVectorSet(sourceWidth, sourceHeight, 0.0f, 0.0f);
+		mMaterial->DestinationSize() << XMVectorSet(static_cast<float>(destination.Width), static_cast<float>(destination.Height), 0.0f, 0.0f);
+		mMaterial->Ratio() << static_cast<int>(textures[pass.Output].Divisor / source.Divisor);
+		mMaterial->BloomThreshold() << mGraph.Settings().BloomThreshold;
+		mMaterial->BlurWeights() << mBlurWeights;
+		mMaterial->ColorTexture() << ShaderResourceView(pass.Inputs[0]);
+		mMaterial->OutputTexture() << destination.UnorderedAccessView;
+		mComputePasses[pass.Type]->Apply(0, direct3DDeviceContext);
+
+		direct3DDeviceContext->Dispatch((destination.Width + ThreadsPerGroup - 1) / ThreadsPerGroup, (destination.Height + ThreadsPerGroup - 1) / ThreadsPerGroup, 1);
+
+		// Unbind the UAV and the source so the next pass can read this slot or write the one just read
+		static ID3D11UnorderedAccessView* emptyUAV = nullptr;
+		static ID3D11ShaderResourceView* emptySRVs[] = { nullptr, nullptr };
+		direct3DDeviceContext->CSSetUnorderedAccessViews(0, 1, &emptyUAV, nullptr);
+		direct3DDeviceContext->CSSetShaderResources(0, ARRAYSIZE(emptySRVs), emptySRVs);
+	}
+
+	void PostProcessExecutor::DrawComposite(const PostProcessPass& pass, const GameTime& gameTime)
+	{
+		assert(pass.Inputs[0] == PostProcessGraph::SceneTexture);
+
+		mBloomTexture = ShaderResourceView(pass.Inputs[1]);
+		mFullScreenQuad->SetActiveTechnique("composite", "p0");
+		mFullScreenQuad->Draw(gameTime);
+		mGame->UnbindPixelShaderResources(0, 2);
+	}
+
+	void PostProcessExecutor::UpdateCompositeMaterial()
+	{
+		const PostProcessSettings& settings = mGraph.Settings();
+
+		mMaterial->ColorTexture() << mSceneTexture;
+		mMaterial->BloomTexture() << mBloomTexture;
+		mMaterial->BloomIntensity() << settings.BloomIntensity;
+		mMaterial->BloomSaturation() << settings.BloomSaturation;
+		mMaterial->SceneIntensity() << settings.SceneIntensity;
+		mMaterial->SceneSaturation() << settings.SceneSaturation;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "DrawableGameComponent.h"
+#include "PostProcessGraph.h"
+
+namespace Library
+{
+	class Effect;
+	class Pass;
+	class FullScreenQuad;
+	class PostProcessMaterial;
+
+	// Runs a PostProcessGraph on the GPU. Intermediate passes are compute shaders writing to aliased, depth-less
+	// RGBA8 slots; the pass that writes the graph's output draws straight into the currently bound render target.
+	class PostProcessExecutor : public DrawableGameComponent
+	{
+		RTTI_DECLARATIONS(PostProcessExecutor, DrawableGameComponent)
+
+	public:
+		PostProcessExecutor(Game& game, const PostProcessGraph& graph);
+		~PostProcessExecutor();
+
+		const PostProcessGraph& Graph() const;
+		const PostProcessSettings& Settings() const;
+		void SetSettings(const PostProcessSettings& settings);
+
+		ID3D11ShaderResourceView* SceneTexture() const;
+		void SetSceneTexture(ID3D11ShaderResourceView& sceneTexture);
+
+		PostProcessBandwidth Bandwidth() const;
+
+		virtual void Initialize() override;
+		virtual void Draw(const GameTime& gameTime) override;
+
+		static const UINT ThreadsPerGroup;
+
+	private:
+		typedef struct _SlotResources
+		{
+			ID3D11ShaderResourceView* ShaderResourceView;
+			ID3D11UnorderedAccessView* UnorderedAccessView;
+			UINT Width;
+			UINT Height;
+		} SlotResources;
+
+		PostProcessExecutor();
+		PostProcessExecutor(const PostProcessExecutor& rhs);
+		PostProcessExecutor& operator=(const PostProcessExecutor& rhs);
+
+		void CreateSlot(UINT divisor, SlotResources& slot);
+		ID3D11ShaderResourceView* ShaderResourceView(int texture) const;
+		void DispatchPass(const PostProcessPass& pass);
+		void DrawComposite(const PostProcessPass& pass, const GameTime& gameTime);
+		void UpdateCompositeMaterial();
+
+		PostProcessGraph mGraph;
+		std::shared_ptr<Effect> mEffect;
+		PostProcessMaterial* mMaterial;
+		Pass* mComputePasses[PostProcessPassTypeEnd];
+		FullScreenQuad* mFullScreenQuad;
+		std::vector<SlotResources> mSlots;
+		std::vector<float> mBlurWeights;
+		ID3D11ShaderResourceView* mSceneTexture;
+		ID3D11ShaderResourceView* mBloomTexture;
+	};
+}
\ No newline at end of file
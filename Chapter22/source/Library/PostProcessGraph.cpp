@@ -0,0 +1,267 @@
+#include "PostProcessGraph.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Library
+{
+	const int PostProcessGraph::SceneTexture = 0;
+	const int PostProcessGraph::OutputTexture = 1;
+	const unsigned int PostProcessGraph::BytesPerTexel = 4;
+	const unsigned int PostProcessGraph::BlurRadius = 4;
+	const PostProcessSettings PostProcessGraph::DefaultSettings = { 0.45f, 2.0f, 1.25f, 1.0f, 1.0f, 1.0f };
+
+	PostProcessGraph::PostProcessGraph()
+		: mTextures(), mPasses(), mSlotDivisors(), mSettings(DefaultSettings), mIsCompiled(false)
+	{
+		// The scene and the output are supplied by the caller and never aliased
+		AddTexture("Scene", 1);
+		AddTexture("Output", 1);
+	}
+
+	int PostProcessGraph::AddTexture(const std::string& name, unsigned int divisor)
+	{
+		assert(divisor > 0);
+
+		PostProcessTexture texture;
+		texture.Name = name;
+		texture.Divisor = divisor;
+		texture.FirstPass = -1;
+		texture.LastPass = -1;
+		texture.Slot = -1;
+
+		mTextures.push_back(texture);
+		mIsCompiled = false;
+
+		return static_cast<int>(mTextures.size()) - 1;
+	}
+
+	void PostProcessGraph::AddPass(PostProcessPassType type, int input, int output)
+	{
+		AddPass(type, input, -1, output);
+	}
+
+	void PostProcessGraph::AddPass(PostProcessPassType type, int input, int secondInput, int output)
+	{
+		assert(input >= 0 && input < static_cast<int>(mTextures.size()));
+		assert(secondInput < static_cast<int>(mTextures.size()));
+		assert(output > SceneTexture && output < static_cast<int>(mTextures.size()));
+		assert(type != PostProcessPassTypeComposite || secondInput >= 0);
+
+		PostProcessPass pass;
+		pass.Type = type;
+		pass.Inputs[0] = input;
+		pass.Inputs[1] = secondInput;
+		pass.Output = output;
+
+		mPasses.push_back(pass);
+		mIsCompiled = false;
+	}
+
+	void PostProcessGraph::Compile()
+	{
+		for (PostProcessTexture& texture : mTextures)
+		{
+			texture.FirstPass = -1;
+			texture.LastPass = -1;
+			texture.Slot = -1;
+		}
+
+		int passCount = static_cast<int>(mPasses.size());
+		for (int i = 0; i < passCount; i++)
+		{
+			const PostProcessPass& pass = mPasses[i];
+			for (int input : pass.Inputs)
+			{
+				if (input >= 0)
+				{
+					// Transient textures must be written before they are read
+					assert(IsTransient(input) == false || mTextures[input].FirstPass >= 0);
+					mTextures[input].LastPass = i;
+				}
+			}
+
+			PostProcessTexture& output = mTextures[pass.Output];
+			if (output.FirstPass < 0)
+			{
+				output.FirstPass = i;
+			}
+
+			output.LastPass = std::max(output.LastPass, i);
+		}
+
+		// Greedy interval allocation: a slot is reused once the texture occupying it has been read for the last time
+		mSlotDivisors.clear();
+		std::vector<int> freeSlots;
+		for (int i = 0; i < passCount; i++)
+		{
+			int output = mPasses[i].Output;
+			PostProcessTexture& outputTexture = mTextures[output];
+			if (IsTransient(output) && outputTexture.Slot < 0)
+			{
+				auto freeSlot = std::find_if(freeSlots.begin(), freeSlots.end(), [&](int slot) { return mSlotDivisors[slot] == outputTexture.Divisor; });
+				if (freeSlot != freeSlots.end())
+				{
+					outputTexture.Slot = *freeSlot;
+					freeSlots.erase(freeSlot);
+				}
+				else
+				{
+					outputTexture.Slot = static_cast<int>(mSlotDivisors.size());
+					mSlotDivisors.push_back(outputTexture.Divisor);
+				}
+			}
+
+			for (int texture = 0; texture < static_cast<int>(mTextures.size()); texture++)
+			{
+				if (IsTransient(texture) && mTextures[texture].LastPass == i && mTextures[texture].Slot >= 0)
+				{
+					freeSlots.push_back(mTextures[texture].Slot);
+				}
+			}
+		}
+
+		mIsCompiled = true;
+	}
+
+	bool PostProcessGraph::IsCompiled() const
+	{
+		return mIsCompiled;
+	}
+
+	const std::vector<PostProcessTexture>& PostProcessGraph::Textures() const
+	{
+		return mTextures;
+	}
+
+	const std::vector<PostProcessPass>& PostProcessGraph::Passes() const
+	{
+		return mPasses;
+	}
+
+	const std::vector<unsigned int>& PostProcessGraph::SlotDivisors() const
+	{
+		return mSlotDivisors;
+	}
+
+	const PostProcessSettings& PostProcessGraph::Settings() const
+	{
+		return mSettings;
+	}
+
+	void PostProcessGraph::SetSettings(const PostProcessSettings& settings)
+	{
+		mSettings = settings;
+	}
+
+	PostProcessBandwidth PostProcessGraph::Bandwidth(unsigned int width, unsigned int height) const
+	{
+		assert(mIsCompiled);
+
+		PostProcessBandwidth bandwidth = { 0, 0, 0, 0 };
+		auto textureBytes = [&](unsigned int divisor)
+		{
+			return static_cast<unsigned long long>(ScaledSize(width, divisor)) * ScaledSize(height, divisor) * BytesPerTexel;
+		};
+
+		// Each pass reads its inputs and writes its output once; filter taps are assumed to hit the texture cache
+		for (const PostProcessPass& pass : mPasses)
+		{
+			for (int input : pass.Inputs)
+			{
+				if (input >= 0)
+				{
+					bandwidth.BytesRead += textureBytes(mTextures[input].Divisor);
+				}
+			}
+
+			bandwidth.BytesWritten += textureBytes(mTextures[pass.Output].Divisor);
+		}
+
+		for (unsigned int divisor : mSlotDivisors)
+		{
+			bandwidth.TransientBytes += textureBytes(divisor);
+		}
+
+		for (int texture = 0; texture < static_cast<int>(mTextures.size()); texture++)
+		{
+			if (IsTransient(texture) && mTextures[texture].Slot >= 0)
+			{
+				bandwidth.UnaliasedTransientBytes += textureBytes(mTextures[texture].Divisor);
+			}
+		}
+
+		return bandwidth;
+	}
+
+	PostProcessGraph PostProcessGraph::CreateBloomGraph(const PostProcessSettings& settings)
+	{
+		PostProcessGraph graph;
+		graph.SetSettings(settings);
+
+		int brightTexture = graph.AddTexture("Bright", 2);
+		int downsampledTexture = graph.AddTexture("Downsampled", 4);
+		int horizontalBlurTexture = graph.AddTexture("HorizontalBlur", 4);
+		int verticalBlurTexture = graph.AddTexture("VerticalBlur", 4);
+
+		graph.AddPass(PostProcessPassTypeExtract, SceneTexture, brightTexture);
+		graph.AddPass(PostProcessPassTypeDownsample, brightTexture, downsampledTexture);
+		graph.AddPass(PostProcessPassTypeHorizontalBlur, downsampledTexture, horizontalBlurTexture);
+		graph.AddPass(PostProcessPassTypeVerticalBlur, horizontalBlurTexture, verticalBlurTexture);
+		graph.AddPass(PostProcessPassTypeComposite, SceneTexture, verticalBlurTexture, OutputTexture);
+		graph.Compile();
+
+		return graph;
+	}
+
+	PostProcessBandwidth PostProcessGraph::LegacyBloomBandwidth(unsigned int width, unsigned int height)
+	{
+		// Bloom with GaussianBlur: three full-screen RGBA8 targets, each with a D24S8 depth buffer that is
+		// cleared and depth-tested on every pass, followed by a full-resolution composite
+		const unsigned long long texelCount = static_cast<unsigned long long>(width) * height;
+		const unsigned long long colorBytes = texelCount * BytesPerTexel;
+		const unsigned long long depthBytes = texelCount * 4;
+		const unsigned long long targetPassCount = 3;
+
+		PostProcessBandwidth bandwidth;
+		bandwidth.BytesRead = targetPassCount * (colorBytes + depthBytes) + 2 * colorBytes;
+		bandwidth.BytesWritten = targetPassCount * (2 * (colorBytes + depthBytes)) + colorBytes;
+		bandwidth.TransientBytes = targetPassCount * (colorBytes + depthBytes);
+		bandwidth.UnaliasedTransientBytes = bandwidth.TransientBytes;
+
+		return bandwidth;
+	}
+
+	void PostProcessGraph::ComputeBlurWeights(float blurAmount, std::vector<float>& weights)
+	{
+		weights.assign(BlurRadius * 2 + 1, 0.0f);
+		if (blurAmount <= 0.0f)
+		{
+			weights[BlurRadius] = 1.0f;
+			return;
+		}
+
+		float totalWeight = 0.0f;
+		for (unsigned int i = 0; i < weights.size(); i++)
+		{
+			float x = static_cast<float>(static_cast<int>(i) - static_cast<int>(BlurRadius));
+			weights[i] = std::exp(-(x * x) / (2 * blurAmount * blurAmount));
+			totalWeight += weights[i];
+		}
+
+		for (float& weight : weights)
+		{
+			weight /= totalWeight;
+		}
+	}
+
+	unsigned int PostProcessGraph::ScaledSize(unsigned int size, unsigned int divisor)
+	{
+		return std::max(size / divisor, 1U);
+	}
+
+	bool PostProcessGraph::IsTransient(int texture) const
+	{
+		return (texture != SceneTexture && texture != OutputTexture);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+// Deliberately free of Windows and Direct3D headers so the graph and its CPU reference executor build anywhere
+#include <string>
+#include <vector>
+
+namespace Library
+{
+	enum PostProcessPassType
+	{
+		PostProcessPassTypeExtract = 0,
+		PostProcessPassTypeDownsample,
+		PostProcessPassTypeHorizontalBlur,
+		PostProcessPassTypeVerticalBlur,
+		PostProcessPassTypeComposite,
+		PostProcessPassTypeEnd
+	};
+
+	typedef struct _PostProcessSettings
+	{
+		float BloomThreshold;
+		float BlurAmount;
+		float BloomIntensity;
+		float BloomSaturation;
+		float SceneIntensity;
+		float SceneSaturation;
+	} PostProcessSettings;
+
+	typedef struct _PostProcessTexture
+	{
+		std::string Name;
+		unsigned int Divisor;
+		int FirstPass;
+		int LastPass;
+		int Slot;
+	} PostProcessTexture;
+
+	typedef struct _PostProcessPass
+	{
+		PostProcessPassType Type;
+		int Inputs[2];
+		int Output;
+	} PostProcessPass;
+
+	typedef struct _PostProcessBandwidth
+	{
+		unsigned long long BytesRead;
+		unsigned long long BytesWritten;
+		unsigned long long TransientBytes;
+		unsigned long long UnaliasedTransientBytes;
+	} PostProcessBandwidth;
+
+	// A declarative chain of post-processing passes. Textures are described by their resolution divisor;
+	// Compile() computes lifetimes and aliases transient textures of equal size onto shared slots.
+	class PostProcessGraph
+	{
+	public:
+		PostProcessGraph();
+
+		int AddTexture(const std::string& name, unsigned int divisor);
+		void AddPass(PostProcessPassType type, int input, int output);
+		void AddPass(PostProcessPassType type, int input, int secondInput, int output);
+		void Compile();
+
+		bool IsCompiled() const;
+		const std::vector<PostProcessTexture>& Textures() const;
+		const std::vector<PostProcessPass>& Passes() const;
+		const std::vector<unsigned int>& SlotDivisors() const;
+
+		const PostProcessSettings& Settings() const;
+		void SetSettings(const PostProcessSettings& settings);
+
+		PostProcessBandwidth Bandwidth(unsigned int width, unsigned int height) const;
+
+		static PostProcessGraph CreateBloomGraph(const PostProcessSettings& settings = DefaultSettings);
+		static PostProcessBandwidth LegacyBloomBandwidth(unsigned int width, unsigned int height);
+		static void ComputeBlurWeights(float blurAmount, std::vector<float>& weights);
+		static unsigned int ScaledSize(unsigned int size, unsigned int divisor);
+
+		static const int SceneTexture;
+		static const int OutputTexture;
+		static const unsigned int BytesPerTexel;
+		static const unsigned int BlurRadius;
+		static const PostProcessSettings DefaultSettings;
+
+	private:
+		bool IsTransient(int texture) const;
+
+		std::vector<PostProcessTexture> mTextures;
+		std::vector<PostProcessPass> mPasses;
+		std::vector<unsigned int> mSlotDivisors;
+		PostProcessSettings mSettings;
+		bool mIsCompiled;
+	};
+}
\ No newline at end of file
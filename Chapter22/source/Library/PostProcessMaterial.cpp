@@ -0,0 +1,100 @@
+#include "PostProcessMaterial.h"
+#include "GameException.h"
+#include "Mesh.h"
+
+namespace Library
+{
+	RTTI_DEFINITIONS(PostProcessMaterial)
+
+	PostProcessMaterial::PostProcessMaterial()
+		: Material("composite"),
+		  MATERIAL_VARIABLE_INITIALIZATION(SourceSize), MATERIAL_VARIABLE_INITIALIZATION(DestinationSize),
+		  MATERIAL_VARIABLE_INITIALIZATION(Ratio), MATERIAL_VARIABLE_INITIALIZATION(BloomThreshold),
+		  MATERIAL_VARIABLE_INITIALIZATION(BlurWeights), MATERIAL_VARIABLE_INITIALIZATION(OutputTexture),
+		  MATERIAL_VARIABLE_INITIALIZATION(ColorTexture), MATERIAL_VARIABLE_INITIALIZATION(BloomTexture),
+		  MATERIAL_VARIABLE_INITIALIZATION(BloomIntensity), MATERIAL_VARIABLE_INITIALIZATION(BloomSaturation),
+		  MATERIAL_VARIABLE_INITIALIZATION(SceneIntensity), MATERIAL_VARIABLE_INITIALIZATION(SceneSaturation)
+	{
+	}
+
+	MATERIAL_VARIABLE_DEFINITION(PostProcessMaterial, SourceSize)
+	MATERIAL_VARIABLE_DEFINITION(PostProcessMaterial, DestinationSize)
+	MATERIAL_VARIABLE_DEFINITION(PostProcessMaterial, Ratio)
+	MATERIAL_VARIABLE_DEFINITION(PostProcessMaterial, BloomThreshold)
+	MATERIAL_VARIABLE_DEFINITION(PostProcessMaterial, BlurWeights)
+	MATERIAL_VARIABLE_DEFINITION(PostProcessMaterial, OutputTexture)
+	MATERIAL_VARIABLE_DEFINITION(PostProcessMaterial, ColorTexture)
+	MATERIAL_VARIABLE_DEFINITION(PostProcessMaterial, BloomTexture)
+	MATERIAL_VARIABLE_DEFINITION(PostProcessMaterial, BloomIntensity)
+	MATERIAL_VARIABLE_DEFINITION(PostProcessMaterial, BloomSaturation)
+	MATERIAL_VARIABLE_DEFINITION(PostProcessMaterial, SceneIntensity)
+	MATERIAL_VARIABLE_DEFINITION(PostProcessMaterial, SceneSaturation)
+
+	void PostProcessMaterial::Initialize(Effect& effect)
+	{
+		Material::Initialize(effect);
+
+		MATERIAL_VARIABLE_RETRIEVE(SourceSize)
+		MATERIAL_VARIABLE_RETRIEVE(DestinationSize)
+		MATERIAL_VARIABLE_RETRIEVE(Ratio)
+		MATERIAL_VARIABLE_RETRIEVE(BloomThreshold)
+		MATERIAL_VARIABLE_RETRIEVE(BlurWeights)
+		MATERIAL_VARIABLE_RETRIEVE(OutputTexture)
+		MATERIAL_VARIABLE_RETRIEVE(ColorTexture)
+		MATERIAL_VARIABLE_RETRIEVE(BloomTexture)
+		MATERIAL_VARIABLE_RETRIEVE(BloomIntensity)
+		MATERIAL_VARIABLE_RETRIEVE(BloomSaturation)
+		MATERIAL_VARIABLE_RETRIEVE(SceneIntensity)
+		MATERIAL_VARIABLE_RETRIEVE(SceneSaturation)
+
+		D3D11_INPUT_ELEMENT_DESC inputElementDescriptions[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+		};
+
+		// Only the full-screen techniques have a vertex shader
+		CreateInputLayout("composite", "p0", inputElementDescriptions, ARRAYSIZE(inputElementDescriptions));
+		CreateInputLayout("copy", "p0", inputElementDescriptions, ARRAYSIZE(inputElementDescriptions));
+	}
+
+	void PostProcessMaterial::CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
+	{
+		const std::vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
+		std::vector<XMFLOAT3>* textureCoordinates = mesh.TextureCoordinates().at(0);
+		assert(textureCoordinates->size() == sourceVertices.size());
+
+		std::vector<VertexPositionTexture> vertices;
+		vertices.reserve(sourceVertices.size());
+		for (UINT i = 0; i < sourceVertices.size(); i++)
+		{
+			XMFLOAT3 position = sourceVertices.at(i);
+			XMFLOAT3 uv = textureCoordinates->at(i);
+			vertices.push_back(VertexPositionTexture(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y)));
+		}
+
+		CreateVertexBuffer(device, &vertices[0], vertices.size(), vertexBuffer);
+	}
+
+	void PostProcessMaterial::CreateVertexBuffer(ID3D11Device* device, VertexPositionTexture* vertices, UINT vertexCount, ID3D11Buffer** vertexBuffer) const
+	{
+		D3D11_BUFFER_DESC vertexBufferDesc;
+		ZeroMemory(&vertexBufferDesc, sizeof(vertexBufferDesc));
+		vertexBufferDesc.ByteWidth = VertexSize() * vertexCount;
+		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+
+		D3D11_SUBRESOURCE_DATA vertexSubResourceData;
+		ZeroMemory(&vertexSubResourceData, sizeof(vertexSubResourceData));
+		vertexSubResourceData.pSysMem = vertices;
+		if (FAILED(device->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, vertexBuffer)))
+		{
+			throw GameException("ID3D11Device::CreateBuffer() failed.");
+		}
+	}
+
+	UINT PostProcessMaterial::VertexSize() const
+	{
+		return sizeof(VertexPositionTexture);
+	}
+}
\ No newline at end of file
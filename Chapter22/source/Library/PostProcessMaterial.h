@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Common.h"
+#include "Material.h"
+#include "VertexDeclarations.h"
+
+namespace Library
+{
+	class PostProcessMaterial : public Material
+	{
+		RTTI_DECLARATIONS(PostProcessMaterial, Material)
+
+		// Variables for the compute shaders
+		MATERIAL_VARIABLE_DECLARATION(SourceSize)
+		MATERIAL_VARIABLE_DECLARATION(DestinationSize)
+		MATERIAL_VARIABLE_DECLARATION(Ratio)
+		MATERIAL_VARIABLE_DECLARATION(BloomThreshold)
+		MATERIAL_VARIABLE_DECLARATION(BlurWeights)
+		MATERIAL_VARIABLE_DECLARATION(OutputTexture)
+
+		// Variables for the compute and composite shaders
+		MATERIAL_VARIABLE_DECLARATION(ColorTexture)
+		MATERIAL_VARIABLE_DECLARATION(BloomTexture)
+		MATERIAL_VARIABLE_DECLARATION(BloomIntensity)
+		MATERIAL_VARIABLE_DECLARATION(BloomSaturation)
+		MATERIAL_VARIABLE_DECLARATION(SceneIntensity)
+		MATERIAL_VARIABLE_DECLARATION(SceneSaturation)
+
+	public:
+		PostProcessMaterial();
+
+		virtual void Initialize(Effect& effect) override;
+		virtual void CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const override;
+		void CreateVertexBuffer(ID3D11Device* device, VertexPositionTexture* vertices, UINT vertexCount, ID3D11Buffer** vertexBuffer) const;
+		virtual UINT VertexSize() const override;
+	};
+}
\ No newline at end of file
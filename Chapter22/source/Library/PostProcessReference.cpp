@@ -0,0 +1,281 @@
+#include "PostProcessReference.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <emmintrin.h>
+
+namespace Library
+{
+	namespace
+	{
+		const __m128 GrayScaleIntensity = _mm_setr_ps(0.299f, 0.587f, 0.114f, 0.0f);
+		const __m128 ColorChannelMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+
+		inline __m128 LoadTexel(const PostProcessImage& image, unsigned int x, unsigned int y)
+		{
+			return _mm_loadu_ps(&image.Texels[(static_cast<size_t>(y) * image.Width + x) * 4]);
+		}
+
+		inline void StoreTexel(PostProcessImage& image, unsigned int x, unsigned int y, __m128 value)
+		{
+			_mm_storeu_ps(&image.Texels[(static_cast<size_t>(y) * image.Width + x) * 4], value);
+		}
+
+		inline __m128 Saturate(__m128 value)
+		{
+			return _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		}
+
+		inline __m128 AdjustSaturation(__m128 color, float saturation)
+		{
+			__m128 weighted = _mm_mul_ps(color, GrayScaleIntensity);
+			__m128 shuffled = _mm_shuffle_ps(weighted, weighted, _MM_SHUFFLE(2, 3, 0, 1));
+			__m128 sums = _mm_add_ps(weighted, shuffled);
+			__m128 intensity = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+			intensity = _mm_shuffle_ps(intensity, intensity, _MM_SHUFFLE(0, 0, 0, 0));
+
+			__m128 adjusted = _mm_add_ps(intensity, _mm_mul_ps(_mm_sub_ps(color, intensity), _mm_set1_ps(saturation)));
+
+			// Alpha passes through unchanged
+			return _mm_or_ps(_mm_and_ps(ColorChannelMask, adjusted), _mm_andnot_ps(ColorChannelMask, color));
+		}
+	}
+
+	PostProcessReference::PostProcessReference(const PostProcessGraph& graph)
+		: mGraph(&graph), mSlots(graph.SlotDivisors().size()), mBlurWeights()
+	{
+		assert(graph.IsCompiled());
+	}
+
+	void PostProcessReference::Execute(const PostProcessImage& scene, PostProcessImage& output)
+	{
+		const PostProcessSettings& settings = mGraph->Settings();
+		ResizeImage(output, scene.Width, scene.Height);
+
+		if (settings.BloomThreshold >= 1.0f)
+		{
+			// Matches the GPU's copy technique
+			output.Texels = scene.Texels;
+			QuantizeImage(output);
+			return;
+		}
+
+		const std::vector<unsigned int>& slotDivisors = mGraph->SlotDivisors();
+		for (unsigned int i = 0; i < slotDivisors.size(); i++)
+		{
+			ResizeImage(mSlots[i], PostProcessGraph::ScaledSize(scene.Width, slotDivisors[i]), PostProcessGraph::ScaledSize(scene.Height, slotDivisors[i]));
+		}
+
+		PostProcessGraph::ComputeBlurWeights(settings.BlurAmount, mBlurWeights);
+
+		const std::vector<PostProcessTexture>& textures = mGraph->Textures();
+		for (const PostProcessPass& pass : mGraph->Passes())
+		{
+			const PostProcessImage& source = Resolve(pass.Inputs[0], scene, output);
+			PostProcessImage& destination = ResolveOutput(pass.Output, output);
+			unsigned int ratio = textures[pass.Output].Divisor / textures[pass.Inputs[0]].Divisor;
+
+			switch (pass.Type)
+			{
+			case PostProcessPassTypeExtract:
+				BoxFilter(source, destination, ratio, true);
+				break;
+
+			case PostProcessPassTypeDownsample:
+				BoxFilter(source, destination, ratio, false);
+				break;
+
+			case PostProcessPassTypeHorizontalBlur:
+				Blur(source, destination, true);
+				break;
+
+			case PostProcessPassTypeVerticalBlur:
+				Blur(source, destination, false);
+				break;
+
+			case PostProcessPassTypeComposite:
+				Composite(source, Resolve(pass.Inputs[1], scene, output), destination);
+				break;
+
+			default:
+				assert(false);
+				break;
+			}
+
+			QuantizeImage(destination);
+		}
+	}
+
+	const PostProcessImage& PostProcessReference::Slot(unsigned int slot) const
+	{
+		return mSlots.at(slot);
+	}
+
+	void PostProcessReference::ResizeImage(PostProcessImage& image, unsigned int width, unsigned int height)
+	{
+		image.Width = width;
+		image.Height = height;
+		image.Texels.resize(static_cast<size_t>(width) * height * 4);
+	}
+
+	void PostProcessReference::QuantizeImage(PostProcessImage& image)
+	{
+		const __m128 scale = _mm_set1_ps(255.0f);
+		const __m128 inverseScale = _mm_set1_ps(1.0f / 255.0f);
+
+		// UNORM conversion: saturate, then round to the nearest of 256 levels
+		for (size_t i = 0; i + 4 <= image.Texels.size(); i += 4)
+		{
+			__m128 value = Saturate(_mm_loadu_ps(&image.Texels[i]));
+			__m128i levels = _mm_cvtps_epi32(_mm_mul_ps(value, scale));
+			_mm_storeu_ps(&image.Texels[i], _mm_mul_ps(_mm_cvtepi32_ps(levels), inverseScale));
+		}
+	}
+
+	float PostProcessReference::MaximumDifference(const PostProcessImage& lhs, const PostProcessImage& rhs)
+	{
+		if (lhs.Width != rhs.Width || lhs.Height != rhs.Height)
+		{
+			return HUGE_VALF;
+		}
+
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		__m128 maximum = _mm_setzero_ps();
+		for (size_t i = 0; i + 4 <= lhs.Texels.size(); i += 4)
+		{
+			__m128 difference = _mm_sub_ps(_mm_loadu_ps(&lhs.Texels[i]), _mm_loadu_ps(&rhs.Texels[i]));
+			maximum = _mm_max_ps(maximum, _mm_and_ps(difference, signMask));
+		}
+
+		maximum = _mm_max_ps(maximum, _mm_movehl_ps(maximum, maximum));
+		maximum = _mm_max_ss(maximum, _mm_shuffle_ps(maximum, maximum, _MM_SHUFFLE(1, 1, 1, 1)));
+
+		return _mm_cvtss_f32(maximum);
+	}
+
+	const PostProcessImage& PostProcessReference::Resolve(int texture, const PostProcessImage& scene, const PostProcessImage& output) const
+	{
+		if (texture == PostProcessGraph::SceneTexture)
+		{
+			return scene;
+		}
+		else if (texture == PostProcessGraph::OutputTexture)
+		{
+			return output;
+		}
+
+		return mSlots[mGraph->Textures()[texture].Slot];
+	}
+
+	PostProcessImage& PostProcessReference::ResolveOutput(int texture, PostProcessImage& output)
+	{
+		if (texture == PostProcessGraph::OutputTexture)
+		{
+			return output;
+		}
+
+		return mSlots[mGraph->Textures()[texture].Slot];
+	}
+
+	void PostProcessReference::BoxFilter(const PostProcessImage& source, PostProcessImage& destination, unsigned int ratio, bool extract) const
+	{
+		const float threshold = mGraph->Settings().BloomThreshold;
+		const __m128 thresholdVector = _mm_set1_ps(threshold);
+		const __m128 inverseRange = _mm_set1_ps(1.0f / (1.0f - threshold));
+
+		for (unsigned int y = 0; y < destination.Height; y++)
+		{
+			unsigned int blockEndY = std::min((y + 1) * ratio, source.Height);
+			for (unsigned int x = 0; x < destination.Width; x++)
+			{
+				unsigned int blockEndX = std::min((x + 1) * ratio, source.Width);
+
+				__m128 sum = _mm_setzero_ps();
+				for (unsigned int sourceY = y * ratio; sourceY < blockEndY; sourceY++)
+				{
+					for (unsigned int sourceX = x * ratio; sourceX < blockEndX; sourceX++)
+					{
+						__m128 color = LoadTexel(source, sourceX, sourceY);
+						if (extract)
+						{
+							color = Saturate(_mm_mul_ps(_mm_sub_ps(color, thresholdVector), inverseRange));
+						}
+
+						sum = _mm_add_ps(sum, color);
+					}
+				}
+
+				float count = static_cast<float>((blockEndX - x * ratio) * (blockEndY - y * ratio));
+				StoreTexel(destination, x, y, _mm_div_ps(sum, _mm_set1_ps(count)));
+			}
+		}
+	}
+
+	void PostProcessReference::Blur(const PostProcessImage& source, PostProcessImage& destination, bool horizontal) const
+	{
+		const int radius = static_cast<int>(PostProcessGraph::BlurRadius);
+		const int maximumX = static_cast<int>(source.Width) - 1;
+		const int maximumY = static_cast<int>(source.Height) - 1;
+
+		for (int y = 0; y < static_cast<int>(destination.Height); y++)
+		{
+			for (int x = 0; x < static_cast<int>(destination.Width); x++)
+			{
+				__m128 sum = _mm_setzero_ps();
+				for (int i = -radius; i <= radius; i++)
+				{
+					int sourceX = (horizontal ? std::min(std::max(x + i, 0), maximumX) : x);
+					int sourceY = (horizontal ? y : std::min(std::max(y + i, 0), maximumY));
+					__m128 weight = _mm_set1_ps(mBlurWeights[i + radius]);
+					sum = _mm_add_ps(sum, _mm_mul_ps(LoadTexel(source, sourceX, sourceY), weight));
+				}
+
+				StoreTexel(destination, x, y, sum);
+			}
+		}
+	}
+
+	void PostProcessReference::Composite(const PostProcessImage& scene, const PostProcessImage& bloom, PostProcessImage& destination) const
+	{
+		const PostProcessSettings& settings = mGraph->Settings();
+		const __m128 bloomIntensity = _mm_set1_ps(settings.BloomIntensity);
+		const __m128 sceneIntensity = _mm_set1_ps(settings.SceneIntensity);
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		const float scaleX = static_cast<float>(bloom.Width) / destination.Width;
+		const float scaleY = static_cast<float>(bloom.Height) / destination.Height;
+		const int maximumX = static_cast<int>(bloom.Width) - 1;
+		const int maximumY = static_cast<int>(bloom.Height) - 1;
+
+		for (unsigned int y = 0; y < destination.Height; y++)
+		{
+			// Bilinear sample at the destination texel centre with clamp addressing
+			float v = (y + 0.5f) * scaleY - 0.5f;
+			float floorV = std::floor(v);
+			int y0 = std::min(std::max(static_cast<int>(floorV), 0), maximumY);
+			int y1 = std::min(std::max(static_cast<int>(floorV) + 1, 0), maximumY);
+			__m128 fractionY = _mm_set1_ps(v - floorV);
+
+			for (unsigned int x = 0; x < destination.Width; x++)
+			{
+				float u = (x + 0.5f) * scaleX - 0.5f;
+				float floorU = std::floor(u);
+				int x0 = std::min(std::max(static_cast<int>(floorU), 0), maximumX);
+				int x1 = std::min(std::max(static_cast<int>(floorU) + 1, 0), maximumX);
+				__m128 fractionX = _mm_set1_ps(u - floorU);
+
+				__m128 top = LoadTexel(bloom, x0, y0);
+				top = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(LoadTexel(bloom, x1, y0), top), fractionX));
+				__m128 bottom = LoadTexel(bloom, x0, y1);
+				bottom = _mm_add_ps(bottom, _mm_mul_ps(_mm_sub_ps(LoadTexel(bloom, x1, y1), bottom), fractionX));
+				__m128 bloomColor = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), fractionY));
+
+				__m128 sceneColor = _mm_mul_ps(AdjustSaturation(LoadTexel(scene, x, y), settings.SceneSaturation), sceneIntensity);
+				bloomColor = _mm_mul_ps(AdjustSaturation(bloomColor, settings.BloomSaturation), bloomIntensity);
+				sceneColor = _mm_mul_ps(sceneColor, _mm_sub_ps(one, Saturate(bloomColor)));
+
+				StoreTexel(destination, x, y, _mm_add_ps(sceneColor, bloomColor));
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "PostProcessGraph.h"
+
+namespace Library
+{
+	// RGBA image with four floats per texel, rows stored top to bottom
+	typedef struct _PostProcessImage
+	{
+		unsigned int Width;
+		unsigned int Height;
+		std::vector<float> Texels;
+	} PostProcessImage;
+
+	// Executes a PostProcessGraph on the CPU with SSE, mirroring PostProcess.fx texel for texel. Intermediate
+	// results are quantized to 8 bits per channel, as they are when stored in the GPU's RGBA8 slots.
+	class PostProcessReference
+	{
+	public:
+		PostProcessReference(const PostProcessGraph& graph);
+
+		void Execute(const PostProcessImage& scene, PostProcessImage& output);
+
+		// Contents of an aliased slot after the last Execute()
+		const PostProcessImage& Slot(unsigned int slot) const;
+
+		static void ResizeImage(PostProcessImage& image, unsigned int width, unsigned int height);
+		static void QuantizeImage(PostProcessImage& image);
+		static float MaximumDifference(const PostProcessImage& lhs, const PostProcessImage& rhs);
+
+	private:
+		PostProcessReference();
+		PostProcessReference(const PostProcessReference& rhs);
+		PostProcessReference& operator=(const PostProcessReference& rhs);
+
+		const PostProcessImage& Resolve(int texture, const PostProcessImage& scene, const PostProcessImage& output) const;
+		PostProcessImage& ResolveOutput(int texture, PostProcessImage& output);
+
+		void BoxFilter(const PostProcessImage& source, PostProcessImage& destination, unsigned int ratio, bool extract) const;
+		void Blur(const PostProcessImage& source, PostProcessImage& destination, bool horizontal) const;
+		void Composite(const PostProcessImage& scene, const PostProcessImage& bloom, PostProcessImage& destination) const;
+
+		const PostProcessGraph* mGraph;
+		std::vector<PostProcessImage> mSlots;
+		std::vector<float> mBlurWeights;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,801 @@
+#include "PrimitiveGeometry.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <stdexcept>
+
+namespace Library
+{
+	const char* const PrimitiveGeometry::ShapeNames[] = { "cube", "sphere", "geosphere", "cylinder", "cone", "torus", "teapot" };
+	const unsigned int PrimitiveGeometry::MinimumParallelVertexCount = 16384;
+	const unsigned int PrimitiveGeometry::MaximumGeoSphereTessellation = 14;
+
+	namespace
+	{
+		const float Pi = 3.14159265358979f;
+		const float TwoPi = 6.28318530717959f;
+
+		// A piece's vertices and indices are written by one thread; indices are absolute, so a band may join its own
+		// ring to the next piece's
+		typedef struct _PrimitivePiece
+		{
+			unsigned long long FirstVertex;
+			unsigned long long VertexCount;
+			unsigned long long FirstIndex;
+			unsigned long long IndexCount;
+		} PrimitivePiece;
+
+		// DirectXTK's TeapotData.inc: ten Bezier patches of 16 control points, every one mirrored in x, and those flagged
+		// mirrored in z as well
+		typedef struct _TeapotPatch
+		{
+			bool IsMirroredInZ;
+			unsigned int Indices[16];
+		} TeapotPatch;
+
+		const TeapotPatch TeapotPatches[] =
+		{
+			{ true, { 102, 103, 104, 105, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 } },
+			{ true, { 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27 } },
+			{ true, { 24, 25, 26, 27, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40 } },
+			{ true, { 96, 96, 96, 96, 97, 98, 99, 100, 101, 101, 101, 101, 0, 1, 2, 3 } },
+			{ true, { 0, 1, 2, 3, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117 } },
+			{ false, { 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56 } },
+			{ false, { 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 28, 65, 66, 67 } },
+			{ false, { 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83 } },
+			{ false, { 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95 } },
+			{ true, { 118, 118, 118, 118, 124, 122, 119, 121, 123, 126, 125, 120, 40, 39, 38, 37 } }
+		};
+
+		const float TeapotControlPoints[][3] =
+		{
+			{ 0.0f, 0.345f, -0.05f },
+			{ -0.028f, 0.345f, -0.05f },
+			{ -0.05f, 0.345f, -0.028f },
+			{ -0.05f, 0.345f, 0.0f },
+			{ 0.0f, 0.3028125f, -0.334375f },
+			{ -0.18725f, 0.3028125f, -0.334375f },
+			{ -0.334375f, 0.3028125f, -0.18725f },
+			{ -0.334375f, 0.3028125f, 0.0f },
+			{ 0.0f, 0.3028125f, -0.359375f },
+			{ -0.20125f, 0.3028125f, -0.359375f },
+			{ -0.359375f, 0.3028125f, -0.20125f },
+			{ -0.359375f, 0.3028125f, 0.0f },
+			{ 0.0f, 0.27f, -0.375f },
+			{ -0.21f, 0.27f, -0.375f },
+			{ -0.375f, 0.27f, -0.21f },
+			{ -0.375f, 0.27f, 0.0f },
+			{ 0.0f, 0.13875f, -0.4375f },
+			{ -0.245f, 0.13875f, -0.4375f },
+			{ -0.4375f, 0.13875f, -0.245f },
+			{ -0.4375f, 0.13875f, 0.0f },
+			{ 0.0f, 0.007499993f, -0.5f },
+			{ -0.28f, 0.007499993f, -0.5f },
+			{ -0.5f, 0.007499993f, -0.28f },
+			{ -0.5f, 0.007499993f, 0.0f },
+			{ 0.0f, -0.105f, -0.5f },
+			{ -0.28f, -0.105f, -0.5f },
+			{ -0.5f, -0.105f, -0.28f },
+			{ -0.5f, -0.105f, 0.0f },
+			{ 0.0f, -0.105f, 0.5f },
+			{ 0.0f, -0.2175f, -0.5f },
+			{ -0.28f, -0.2175f, -0.5f },
+			{ -0.5f, -0.2175f, -0.28f },
+			{ -0.5f, -0.2175f, 0.0f },
+			{ 0.0f, -0.27375f, -0.375f },
+			{ -0.21f, -0.27375f, -0.375f },
+			{ -0.375f, -0.27375f, -0.21f },
+			{ -0.375f, -0.27375f, 0.0f },
+			{ 0.0f, -0.2925f, -0.375f },
+			{ -0.21f, -0.2925f, -0.375f },
+			{ -0.375f, -0.2925f, -0.21f },
+			{ -0.375f, -0.2925f, 0.0f },
+			{ 0.0f, 0.17625f, 0.4f },
+			{ -0.075f, 0.17625f, 0.4f },
+			{ -0.075f, 0.2325f, 0.375f },
+			{ 0.0f, 0.2325f, 0.375f },
+			{ 0.0f, 0.17625f, 0.575f },
+			{ -0.075f, 0.17625f, 0.575f },
+			{ -0.075f, 0.2325f, 0.625f },
+			{ 0.0f, 0.2325f, 0.625f },
+			{ 0.0f, 0.17625f, 0.675f },
+			{ -0.075f, 0.17625f, 0.675f },
+			{ -0.075f, 0.2325f, 0.75f },
+			{ 0.0f, 0.2325f, 0.75f },
+			{ 0.0f, 0.12f, 0.675f },
+			{ -0.075f, 0.12f, 0.675f },
+			{ -0.075f, 0.12f, 0.75f },
+			{ 0.0f, 0.12f, 0.75f },
+			{ 0.0f, 0.06375f, 0.675f },
+			{ -0.075f, 0.06375f, 0.675f },
+			{ -0.075f, 0.007499993f, 0.75f },
+			{ 0.0f, 0.007499993f, 0.75f },
+			{ 0.0f, -0.04875001f, 0.625f },
+			{ -0.075f, -0.04875001f, 0.625f },
+			{ -0.075f, -0.09562501f, 0.6625f },
+			{ 0.0f, -0.09562501f, 0.6625f },
+			{ -0.075f, -0.105f, 0.5f },
+			{ -0.075f, -0.18f, 0.475f },
+			{ 0.0f, -0.18f, 0.475f },
+			{ 0.0f, 0.02624997f, -0.425f },
+			{ -0.165f, 0.02624997f, -0.425f },
+			{ -0.165f, -0.18f, -0.425f },
+			{ 0.0f, -0.18f, -0.425f },
+			{ 0.0f, 0.02624997f, -0.65f },
+			{ -0.165f, 0.02624997f, -0.65f },
+			{ -0.165f, -0.12375f, -0.775f },
+			{ 0.0f, -0.12375f, -0.775f },
+			{ 0.0f, 0.195f, -0.575f },
+			{ -0.0625f, 0.195f, -0.575f },
+			{ -0.0625f, 0.17625f, -0.6f },
+			{ 0.0f, 0.17625f, -0.6f },
+			{ 0.0f, 0.27f, -0.675f },
+			{ -0.0625f, 0.27f, -0.675f },
+			{ -0.0625f, 0.27f, -0.825f },
+			{ 0.0f, 0.27f, -0.825f },
+			{ 0.0f, 0.28875f, -0.7f },
+			{ -0.0625f, 0.28875f, -0.7f },
+			{ -0.0625f, 0.2934375f, -0.88125f },
+			{ 0.0f, 0.2934375f, -0.88125f },
+			{ 0.0f, 0.28875f, -0.725f },
+			{ -0.0375f, 0.28875f, -0.725f },
+			{ -0.0375f, 0.298125f, -0.8625f },
+			{ 0.0f, 0.298125f, -0.8625f },
+			{ 0.0f, 0.27f, -0.7f },
+			{ -0.0375f, 0.27f, -0.7f },
+			{ -0.0375f, 0.27f, -0.8f },
+			{ 0.0f, 0.27f, -0.8f },
+			{ 0.0f, 0.4575f, 0.0f },
+			{ 0.0f, 0.4575f, -0.2f },
+			{ -0.1125f, 0.4575f, -0.2f },
+			{ -0.2f, 0.4575f, -0.1125f },
+			{ -0.2f, 0.4575f, 0.0f },
+			{ 0.0f, 0.3825f, 0.0f },
+			{ 0.0f, 0.27f, -0.35f },
+			{ -0.196f, 0.27f, -0.35f },
+			{ -0.35f, 0.27f, -0.196f },
+			{ -0.35f, 0.27f, 0.0f },
+			{ 0.0f, 0.3075f, -0.1f },
+			{ -0.056f, 0.3075f, -0.1f },
+			{ -0.1f, 0.3075f, -0.056f },
+			{ -0.1f, 0.3075f, 0.0f },
+			{ 0.0f, 0.3075f, -0.325f },
+			{ -0.182f, 0.3075f, -0.325f },
+			{ -0.325f, 0.3075f, -0.182f },
+			{ -0.325f, 0.3075f, 0.0f },
+			{ 0.0f, 0.27f, -0.325f },
+			{ -0.182f, 0.27f, -0.325f },
+			{ -0.325f, 0.27f, -0.182f },
+			{ -0.325f, 0.27f, 0.0f },
+			{ 0.0f, -0.33f, 0.0f },
+			{ -0.1995f, -0.33f, -0.35625f },
+			{ 0.0f, -0.31125f, -0.375f },
+			{ 0.0f, -0.33f, -0.35625f },
+			{ -0.35625f, -0.33f, -0.1995f },
+			{ -0.375f, -0.31125f, 0.0f },
+			{ -0.35625f, -0.33f, 0.0f },
+			{ -0.21f, -0.31125f, -0.375f },
+			{ -0.375f, -0.31125f, -0.21f }
+		};
+
+		void SetVertex(PrimitiveVertex& vertex, float x, float y, float z, float normalX, float normalY, float normalZ, float u, float v)
+		{
+			vertex.Position[0] = x;
+			vertex.Position[1] = y;
+			vertex.Position[2] = z;
+			vertex.Normal[0] = normalX;
+			vertex.Normal[1] = normalY;
+			vertex.Normal[2] = normalZ;
+			vertex.TextureCoordinates[0] = u;
+			vertex.TextureCoordinates[1] = v;
+		}
+
+		void Cross(const float lhs[3], const float rhs[3], float result[3])
+		{
+			result[0] = lhs[1] * rhs[2] - lhs[2] * rhs[1];
+			result[1] = lhs[2] * rhs[0] - lhs[0] * rhs[2];
+			result[2] = lhs[0] * rhs[1] - lhs[1] * rhs[0];
+		}
+
+		void Normalize(float vector[3])
+		{
+			float length = sqrtf(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+			if (length > 0.0f)
+			{
+				vector[0] /= length;
+				vector[1] /= length;
+				vector[2] /= length;
+			}
+		}
+
+		float CubicInterpolate(float p1, float p2, float p3, float p4, float t)
+		{
+			return p1 * (1 - t) * (1 - t) * (1 - t) + p2 * 3 * t * (1 - t) * (1 - t) + p3 * 3 * t * t * (1 - t) + p4 * t * t * t;
+		}
+
+		float CubicTangent(float p1, float p2, float p3, float p4, float t)
+		{
+			return p1 * (-1 + 2 * t - t * t) + p2 * (1 - 4 * t + 3 * t * t) + p3 * (2 * t - 3 * t * t) + p4 * (t * t);
+		}
+
+		void Cube(PrimitiveVertex* vertices, unsigned int* indices)
+		{
+			static const float FaceNormals[6][3] = { { 0, 0, 1 }, { 0, 0, -1 }, { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 } };
+			static const float TextureCoordinates[4][2] = { { 1, 0 }, { 1, 1 }, { 0, 1 }, { 0, 0 } };
+			static const float Signs[4][2] = { { -1, -1 }, { -1, 1 }, { 1, 1 }, { 1, -1 } };
+			static const unsigned int FaceIndices[6] = { 0, 1, 2, 0, 2, 3 };
+
+			for (unsigned int face = 0; face < 6; face++)
+			{
+				// Two vectors perpendicular to the face normal and to each other
+				const float* normal = FaceNormals[face];
+				float basis[3] = { 0.0f, (face >= 4 ? 0.0f : 1.0f), (face >= 4 ? 1.0f : 0.0f) };
+				float side1[3];
+				float side2[3];
+				Cross(normal, basis, side1);
+				Cross(normal, side1, side2);
+
+				for (unsigned int i = 0; i < 4; i++)
+				{
+					float position[3];
+					for (unsigned int axis = 0; axis < 3; axis++)
+					{
+						position[axis] = (normal[axis] + Signs[i][0] * side1[axis] + Signs[i][1] * side2[axis]) * 0.5f;
+					}
+
+					SetVertex(vertices[face * 4 + i], position[0], position[1], position[2], normal[0], normal[1], normal[2], TextureCoordinates[i][0], TextureCoordinates[i][1]);
+				}
+
+				for (unsigned int i = 0; i < 6; i++)
+				{
+					indices[face * 6 + i] = face * 4 + FaceIndices[i];
+				}
+			}
+		}
+
+		// A ring of latitude, and the band of triangles joining it to the next
+		void SphereRing(unsigned int tessellation, unsigned int ring, PrimitiveVertex* vertices, unsigned int* indices)
+		{
+			unsigned int verticalSegments = tessellation;
+			unsigned int horizontalSegments = tessellation * 2;
+			unsigned int stride = horizontalSegments + 1;
+
+			float v = 1.0f - static_cast<float>(ring) / verticalSegments;
+			float latitude = ring * Pi / verticalSegments - Pi / 2.0f;
+			float dy = sinf(latitude);
+			float dxz = cosf(latitude);
+
+			PrimitiveVertex* ringVertices = vertices + ring * stride;
+			for (unsigned int j = 0; j <= horizontalSegments; j++)
+			{
+				float longitude = j * TwoPi / horizontalSegments;
+				float dx = sinf(longitude) * dxz;
+				float dz = cosf(longitude) * dxz;
+				SetVertex(ringVertices[j], dx * 0.5f, dy * 0.5f, dz * 0.5f, dx, dy, dz, static_cast<float>(j) / horizontalSegments, v);
+			}
+
+			if (ring == verticalSegments)
+			{
+				return;
+			}
+
+			unsigned int* bandIndices = indices + ring * horizontalSegments * 6;
+			for (unsigned int j = 0; j < horizontalSegments; j++)
+			{
+				unsigned int current = ring * stride + j;
+				unsigned int next = current + stride;
+				unsigned int* triangle = bandIndices + j * 6;
+				triangle[0] = current;
+				triangle[1] = next;
+				triangle[2] = current + 1;
+				triangle[3] = current + 1;
+				triangle[4] = next;
+				triangle[5] = next + 1;
+			}
+		}
+
+		// One face of the octahedron, split as a grid of (2^tessellation)^2 triangles projected onto the sphere. Texture
+		// coordinates are the sphere's longitude and latitude, taken on the face's side of the seam, and at the poles
+		// the longitude of the face's center.
+		void GeoSphereFace(unsigned int tessellation, unsigned int face, unsigned int firstVertex, PrimitiveVertex* vertices, unsigned int* indices)
+		{
+			static const float OctahedronVertices[6][3] = { { 0, 1, 0 }, { 0, 0, -1 }, { 1, 0, 0 }, { 0, 0, 1 }, { -1, 0, 0 }, { 0, -1, 0 } };
+			static const unsigned int OctahedronIndices[8][3] =
+			{
+				{ 0, 1, 2 }, { 0, 2, 3 }, { 0, 3, 4 }, { 0, 4, 1 }, { 5, 1, 4 }, { 5, 4, 3 }, { 5, 3, 2 }, { 5, 2, 1 }
+			};
+
+			unsigned int size = 1U << tessellation;
+			const float* a = OctahedronVertices[OctahedronIndices[face][0]];
+			const float* b = OctahedronVertices[OctahedronIndices[face][1]];
+			const float* c = OctahedronVertices[OctahedronIndices[face][2]];
+
+			float center[3] = { a[0] + b[0] + c[0], a[1] + b[1] + c[1], a[2] + b[2] + c[2] };
+			float centerU = atan2f(center[0], center[2]) / TwoPi;
+
+			PrimitiveVertex* vertex = vertices + firstVertex;
+			for (unsigned int i = 0; i <= size; i++)
+			{
+				for (unsigned int j = 0; j <= size - i; j++)
+				{
+					float s = static_cast<float>(i) / size;
+					float t = static_cast<float>(j) / size;
+					float normal[3];
+					for (unsigned int axis = 0; axis < 3; axis++)
+					{
+						normal[axis] = a[axis] + (b[axis] - a[axis]) * s + (c[axis] - a[axis]) * t;
+					}
+
+					Normalize(normal);
+
+					float u = centerU;
+					if (fabsf(normal[0]) > 1e-6f || fabsf(normal[2]) > 1e-6f)
+					{
+						u = atan2f(normal[0], normal[2]) / TwoPi;
+						u += (u - centerU > 0.5f ? -1.0f : (u - centerU < -0.5f ? 1.0f : 0.0f));
+					}
+
+					float v = 0.5f - asinf(std::max(-1.0f, std::min(1.0f, normal[1]))) / Pi;
+					SetVertex(*vertex++, normal[0] * 0.5f, normal[1] * 0.5f, normal[2] * 0.5f, normal[0], normal[1], normal[2], (u < 0.0f ? u + 1.0f : u), v);
+				}
+			}
+
+			// Row i of the grid holds size + 1 - i vertices
+			unsigned int* index = indices;
+			unsigned int rowStart = firstVertex;
+			for (unsigned int i = 0; i < size; i++)
+			{
+				unsigned int nextRowStart = rowStart + size + 1 - i;
+				for (unsigned int j = 0; j < size - i; j++)
+				{
+					*index++ = rowStart + j;
+					*index++ = nextRowStart + j;
+					*index++ = rowStart + j + 1;
+
+					if (j + 1 < size - i)
+					{
+						*index++ = nextRowStart + j;
+						*index++ = nextRowStart + j + 1;
+						*index++ = rowStart + j + 1;
+					}
+				}
+
+				rowStart = nextRowStart;
+			}
+		}
+
+		void CircleVector(unsigned int i, unsigned int tessellation, float offset, float vector[3])
+		{
+			float angle = i * TwoPi / tessellation + offset;
+			vector[0] = sinf(angle);
+			vector[1] = 0.0f;
+			vector[2] = cosf(angle);
+		}
+
+		// A triangle fan closing an end of the cylinder or cone
+		void CylinderCap(unsigned int tessellation, float height, float radius, bool isTop, unsigned int firstVertex, PrimitiveVertex* vertices, unsigned int* indices)
+		{
+			for (unsigned int i = 0; i < tessellation - 2; i++)
+			{
+				unsigned int i1 = (i + 1) % tessellation;
+				unsigned int i2 = (i + 2) % tessellation;
+				if (isTop)
+				{
+					std::swap(i1, i2);
+				}
+
+				indices[i * 3] = firstVertex;
+				indices[i * 3 + 1] = firstVertex + i1;
+				indices[i * 3 + 2] = firstVertex + i2;
+			}
+
+			float normalY = (isTop ? 1.0f : -1.0f);
+			float textureScaleX = (isTop ? -0.5f : 0.5f);
+			for (unsigned int i = 0; i < tessellation; i++)
+			{
+				float circle[3];
+				CircleVector(i, tessellation, 0.0f, circle);
+				SetVertex(vertices[firstVertex + i], circle[0] * radius, normalY * height, circle[2] * radius, 0.0f, normalY, 0.0f,
+					circle[0] * textureScaleX + 0.5f, circle[2] * -0.5f + 0.5f);
+			}
+		}
+
+		void CylinderSide(unsigned int tessellation, PrimitiveVertex* vertices, unsigned int* indices)
+		{
+			for (unsigned int i = 0; i <= tessellation; i++)
+			{
+				float normal[3];
+				CircleVector(i, tessellation, 0.0f, normal);
+				float u = static_cast<float>(i) / tessellation;
+				SetVertex(vertices[i * 2], normal[0] * 0.5f, 0.5f, normal[2] * 0.5f, normal[0], 0.0f, normal[2], u, 0.0f);
+				SetVertex(vertices[i * 2 + 1], normal[0] * 0.5f, -0.5f, normal[2] * 0.5f, normal[0], 0.0f, normal[2], u, 1.0f);
+
+				if (i < tessellation)
+				{
+					unsigned int* quad = indices + i * 6;
+					quad[0] = i * 2;
+					quad[1] = i * 2 + 2;
+					quad[2] = i * 2 + 1;
+					quad[3] = i * 2 + 1;
+					quad[4] = i * 2 + 2;
+					quad[5] = i * 2 + 3;
+				}
+			}
+		}
+
+		// The apex is repeated for every edge, so each keeps the normal of its side
+		void ConeSide(unsigned int tessellation, PrimitiveVertex* vertices, unsigned int* indices)
+		{
+			for (unsigned int i = 0; i <= tessellation; i++)
+			{
+				float circle[3];
+				float tangent[3];
+				CircleVector(i, tessellation, 0.0f, circle);
+				CircleVector(i, tessellation, Pi / 2.0f, tangent);
+
+				float edge[3] = { -circle[0] * 0.5f, 1.0f, -circle[2] * 0.5f };
+				float normal[3];
+				Cross(tangent, edge, normal);
+				Normalize(normal);
+
+				float u = static_cast<float>(i) / tessellation;
+				SetVertex(vertices[i * 2], 0.0f, 0.5f, 0.0f, normal[0], normal[1], normal[2], 0.0f, 0.0f);
+				SetVertex(vertices[i * 2 + 1], circle[0] * 0.5f, -0.5f, circle[2] * 0.5f, normal[0], normal[1], normal[2], u, 1.0f);
+
+				if (i < tessellation)
+				{
+					indices[i * 3] = i * 2;
+					indices[i * 3 + 1] = i * 2 + 3;
+					indices[i * 3 + 2] = i * 2 + 1;
+				}
+			}
+		}
+
+		// A ring around the tube, and the band joining it to the next
+		void TorusRing(unsigned int tessellation, unsigned int ring, PrimitiveVertex* vertices, unsigned int* indices)
+		{
+			static const float Thickness = 0.333f;
+
+			unsigned int stride = tessellation + 1;
+			float u = static_cast<float>(ring) / tessellation;
+			float outerAngle = ring * TwoPi / tessellation - Pi / 2.0f;
+			float outerSin = sinf(outerAngle);
+			float outerCos = cosf(outerAngle);
+
+			// Rotated about y by the outer angle, as XMMatrixRotationY() does
+			PrimitiveVertex* ringVertices = vertices + ring * stride;
+			for (unsigned int j = 0; j <= tessellation; j++)
+			{
+				float innerAngle = j * TwoPi / tessellation + Pi;
+				float dx = cosf(innerAngle);
+				float dy = sinf(innerAngle);
+				float x = dx * Thickness / 2.0f + 0.5f;
+				SetVertex(ringVertices[j], x * outerCos, dy * Thickness / 2.0f, -x * outerSin, dx * outerCos, dy, -dx * outerSin, u,
+					1.0f - static_cast<float>(j) / tessellation);
+			}
+
+			if (ring == tessellation)
+			{
+				return;
+			}
+
+			unsigned int* bandIndices = indices + ring * tessellation * 6;
+			for (unsigned int j = 0; j < tessellation; j++)
+			{
+				unsigned int current = ring * stride + j;
+				unsigned int next = current + stride;
+				unsigned int* triangle = bandIndices + j * 6;
+				triangle[0] = current;
+				triangle[1] = current + 1;
+				triangle[2] = next;
+				triangle[3] = current + 1;
+				triangle[4] = next + 1;
+				triangle[5] = next;
+			}
+		}
+
+		// Copy 0 of a patch is as stored, 1 mirrored in x, and for patches mirrored in z, 2 in z and 3 in both
+		void TeapotPatchCopy(unsigned int tessellation, unsigned int patchIndex, unsigned int copy, unsigned int firstVertex, PrimitiveVertex* vertices, unsigned int* indices)
+		{
+			static const float Scales[4][3] = { { 1, 1, 1 }, { -1, 1, 1 }, { 1, 1, -1 }, { -1, 1, -1 } };
+			static const bool IsMirrored[4] = { false, true, true, false };
+
+			const TeapotPatch& patch = TeapotPatches[patchIndex];
+			bool isMirrored = IsMirrored[copy];
+			float controlPoints[16][3];
+			for (unsigned int i = 0; i < 16; i++)
+			{
+				for (unsigned int axis = 0; axis < 3; axis++)
+				{
+					controlPoints[i][axis] = TeapotControlPoints[patch.Indices[i]][axis] * Scales[copy][axis];
+				}
+			}
+
+			unsigned int stride = tessellation + 1;
+			unsigned int* index = indices;
+			for (unsigned int i = 0; i < tessellation; i++)
+			{
+				for (unsigned int j = 0; j < tessellation; j++)
+				{
+					unsigned int quad[6] =
+					{
+						i * stride + j, (i + 1) * stride + j, (i + 1) * stride + j + 1,
+						i * stride + j, (i + 1) * stride + j + 1, i * stride + j + 1
+					};
+
+					if (isMirrored)
+					{
+						std::reverse(quad, quad + 6);
+					}
+
+					for (unsigned int k = 0; k < 6; k++)
+					{
+						*index++ = firstVertex + quad[k];
+					}
+				}
+			}
+
+			PrimitiveVertex* vertex = vertices + firstVertex;
+			for (unsigned int i = 0; i <= tessellation; i++)
+			{
+				float u = static_cast<float>(i) / tessellation;
+				for (unsigned int j = 0; j <= tessellation; j++)
+				{
+					float v = static_cast<float>(j) / tessellation;
+					float position[3];
+					float tangent1[3];
+					float tangent2[3];
+					for (unsigned int axis = 0; axis < 3; axis++)
+					{
+						const float (*p)[3] = controlPoints;
+						float p1 = CubicInterpolate(p[0][axis], p[1][axis], p[2][axis], p[3][axis], u);
+						float p2 = CubicInterpolate(p[4][axis], p[5][axis], p[6][axis], p[7][axis], u);
+						float p3 = CubicInterpolate(p[8][axis], p[9][axis], p[10][axis], p[11][axis], u);
+						float p4 = CubicInterpolate(p[12][axis], p[13][axis], p[14][axis], p[15][axis], u);
+						float q1 = CubicInterpolate(p[0][axis], p[4][axis], p[8][axis], p[12][axis], v);
+						float q2 = CubicInterpolate(p[1][axis], p[5][axis], p[9][axis], p[13][axis], v);
+						float q3 = CubicInterpolate(p[2][axis], p[6][axis], p[10][axis], p[14][axis], v);
+						float q4 = CubicInterpolate(p[3][axis], p[7][axis], p[11][axis], p[15][axis], v);
+
+						position[axis] = CubicInterpolate(p1, p2, p3, p4, v);
+						tangent1[axis] = CubicTangent(p1, p2, p3, p4, v);
+						tangent2[axis] = CubicTangent(q1, q2, q3, q4, u);
+					}
+
+					float normal[3];
+					Cross(tangent1, tangent2, normal);
+					if (fabsf(normal[0]) > FLT_EPSILON || fabsf(normal[1]) > FLT_EPSILON || fabsf(normal[2]) > FLT_EPSILON)
+					{
+						Normalize(normal);
+						if (isMirrored)
+						{
+							normal[0] = -normal[0];
+							normal[1] = -normal[1];
+							normal[2] = -normal[2];
+						}
+					}
+					else
+					{
+						// The lid's and base's control points meet at their centers, so they point straight up or down
+						normal[0] = 0.0f;
+						normal[1] = (position[1] < 0.0f ? -1.0f : 1.0f);
+						normal[2] = 0.0f;
+					}
+
+					SetVertex(*vertex++, position[0], position[1], position[2], normal[0], normal[1], normal[2], (isMirrored ? 1.0f - u : u), v);
+				}
+			}
+		}
+
+		void Pieces(PrimitiveShape shape, unsigned int tessellation, std::vector<PrimitivePiece>& pieces)
+		{
+			pieces.clear();
+			auto add = [&pieces](unsigned long long vertexCount, unsigned long long indexCount)
+			{
+				PrimitivePiece piece = { 0, vertexCount, 0, indexCount };
+				if (pieces.empty() == false)
+				{
+					piece.FirstVertex = pieces.back().FirstVertex + pieces.back().VertexCount;
+					piece.FirstIndex = pieces.back().FirstIndex + pieces.back().IndexCount;
+				}
+
+				pieces.push_back(piece);
+			};
+
+			unsigned long long t = tessellation;
+			switch (shape)
+			{
+				case PrimitiveShapeCube:
+					add(24, 36);
+					break;
+
+				case PrimitiveShapeSphere:
+					for (unsigned int ring = 0; ring <= tessellation; ring++)
+					{
+						add(t * 2 + 1, (ring < tessellation ? t * 2 * 6 : 0));
+					}
+					break;
+
+				case PrimitiveShapeGeoSphere:
+				{
+					unsigned long long size = 1ULL << tessellation;
+					for (unsigned int face = 0; face < 8; face++)
+					{
+						add((size + 1) * (size + 2) / 2, size * size * 3);
+					}
+					break;
+				}
+
+				case PrimitiveShapeCylinder:
+					add((t + 1) * 2, t * 6);
+					add(t, (t - 2) * 3);
+					add(t, (t - 2) * 3);
+					break;
+
+				case PrimitiveShapeCone:
+					add((t + 1) * 2, t * 3);
+					add(t, (t - 2) * 3);
+					break;
+
+				case PrimitiveShapeTorus:
+					for (unsigned int ring = 0; ring <= tessellation; ring++)
+					{
+						add(t + 1, (ring < tessellation ? t * 6 : 0));
+					}
+					break;
+
+				case PrimitiveShapeTeapot:
+					for (const TeapotPatch& patch : TeapotPatches)
+					{
+						for (unsigned int copy = 0; copy < (patch.IsMirroredInZ ? 4U : 2U); copy++)
+						{
+							add((t + 1) * (t + 1), t * t * 6);
+						}
+					}
+					break;
+
+				default:
+					throw std::runtime_error("Invalid primitive shape.");
+			}
+		}
+	}
+
+	void PrimitiveGeometry::Generate(PrimitiveShape shape, unsigned int tessellation, bool isRightHanded, std::vector<PrimitiveVertex>& vertices,
+		std::vector<unsigned int>& indices, ThreadPool* threadPool)
+	{
+		if (shape < 0 || shape >= PrimitiveShapeEnd || tessellation < MinimumTessellation(shape) ||
+			(shape == PrimitiveShapeGeoSphere && tessellation > MaximumGeoSphereTessellation))
+		{
+			throw std::runtime_error("Invalid primitive shape or tessellation.");
+		}
+
+		std::vector<PrimitivePiece> pieces;
+		Pieces(shape, tessellation, pieces);
+
+		unsigned long long vertexCount = pieces.back().FirstVertex + pieces.back().VertexCount;
+		unsigned long long indexCount = pieces.back().FirstIndex + pieces.back().IndexCount;
+		if (vertexCount > UINT_MAX || indexCount > UINT_MAX)
+		{
+			throw std::runtime_error("The primitive is tessellated too finely for 32-bit indices.");
+		}
+
+		vertices.resize(static_cast<size_t>(vertexCount));
+		indices.resize(static_cast<size_t>(indexCount));
+
+		// The teapot's pieces are its patches' copies, in Pieces()' order
+		std::vector<unsigned int> teapotCopies;
+		if (shape == PrimitiveShapeTeapot)
+		{
+			for (unsigned int patch = 0; patch < sizeof(TeapotPatches) / sizeof(TeapotPatches[0]); patch++)
+			{
+				for (unsigned int copy = 0; copy < (TeapotPatches[patch].IsMirroredInZ ? 4U : 2U); copy++)
+				{
+					teapotCopies.push_back(patch * 4 + copy);
+				}
+			}
+		}
+
+		auto body = [&](unsigned int begin, unsigned int end)
+		{
+			for (unsigned int i = begin; i < end; i++)
+			{
+				const PrimitivePiece& piece = pieces[i];
+				unsigned int firstVertex = static_cast<unsigned int>(piece.FirstVertex);
+				unsigned int* pieceIndices = (piece.IndexCount > 0 ? &indices[static_cast<size_t>(piece.FirstIndex)] : nullptr);
+
+				switch (shape)
+				{
+					case PrimitiveShapeCube:
+						Cube(&vertices[0], pieceIndices);
+						break;
+
+					case PrimitiveShapeSphere:
+						SphereRing(tessellation, i, &vertices[0], &indices[0]);
+						break;
+
+					case PrimitiveShapeGeoSphere:
+						GeoSphereFace(tessellation, i, firstVertex, &vertices[0], pieceIndices);
+						break;
+
+					case PrimitiveShapeCylinder:
+						if (i == 0)
+						{
+							CylinderSide(tessellation, &vertices[0], pieceIndices);
+						}
+						else
+						{
+							CylinderCap(tessellation, 0.5f, 0.5f, (i == 1), firstVertex, &vertices[0], pieceIndices);
+						}
+						break;
+
+					case PrimitiveShapeCone:
+						if (i == 0)
+						{
+							ConeSide(tessellation, &vertices[0], pieceIndices);
+						}
+						else
+						{
+							CylinderCap(tessellation, 0.5f, 0.5f, false, firstVertex, &vertices[0], pieceIndices);
+						}
+						break;
+
+					case PrimitiveShapeTorus:
+						TorusRing(tessellation, i, &vertices[0], &indices[0]);
+						break;
+
+					case PrimitiveShapeTeapot:
+						TeapotPatchCopy(tessellation, teapotCopies[i] / 4, teapotCopies[i] % 4, firstVertex, &vertices[0], pieceIndices);
+						break;
+
+					default:
+						break;
+				}
+
+				// DirectXTK builds right-handed meshes and reverses them for left-handed coordinates
+				if (isRightHanded == false)
+				{
+					for (unsigned long long index = 0; index < piece.IndexCount; index += 3)
+					{
+						std::swap(pieceIndices[index], pieceIndices[index + 2]);
+					}
+
+					for (unsigned long long vertex = 0; vertex < piece.VertexCount; vertex++)
+					{
+						float& u = vertices[static_cast<size_t>(piece.FirstVertex + vertex)].TextureCoordinates[0];
+						u = 1.0f - u;
+					}
+				}
+			}
+		};
+
+		if (threadPool != nullptr && vertexCount >= MinimumParallelVertexCount)
+		{
+			threadPool->ParallelFor(0, static_cast<unsigned int>(pieces.size()), body);
+		}
+		else
+		{
+			body(0, static_cast<unsigned int>(pieces.size()));
+		}
+	}
+
+	unsigned int PrimitiveGeometry::DefaultTessellation(PrimitiveShape shape)
+	{
+		static const unsigned int DefaultTessellations[] = { 0, 16, 3, 32, 32, 32, 8 };
+
+		return (shape >= 0 && shape < PrimitiveShapeEnd ? DefaultTessellations[shape] : 0);
+	}
+
+	unsigned int PrimitiveGeometry::MinimumTessellation(PrimitiveShape shape)
+	{
+		static const unsigned int MinimumTessellations[] = { 0, 3, 0, 3, 3, 3, 1 };
+
+		return (shape >= 0 && shape < PrimitiveShapeEnd ? MinimumTessellations[shape] : 0);
+	}
+
+	std::wstring PrimitiveGeometry::CacheKey(PrimitiveShape shape, unsigned int tessellation, bool isRightHanded)
+	{
+		return L"primitive|" + std::to_wstring(static_cast<int>(shape)) + L"|" + std::to_wstring(tessellation) + (isRightHanded ? L"|rh" : L"|lh");
+	}
+}
\ No newline at end of file
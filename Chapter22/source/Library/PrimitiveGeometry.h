@@ -0,0 +1,65 @@
+#pragma once
+
+// Portable, like SpriteQueue: generation is timed and checked by PrimitiveBenchmark, which runs without Direct3D
+#include <string>
+#include <vector>
+
+namespace Library
+{
+	class ThreadPool;
+
+	enum PrimitiveShape
+	{
+		PrimitiveShapeCube = 0,
+		PrimitiveShapeSphere,
+		PrimitiveShapeGeoSphere,
+		PrimitiveShapeCylinder,
+		PrimitiveShapeCone,
+		PrimitiveShapeTorus,
+		PrimitiveShapeTeapot,
+		PrimitiveShapeEnd
+	};
+
+	// The layout of DirectXTK's VertexPositionNormalTexture
+	typedef struct _PrimitiveVertex
+	{
+		float Position[3];
+		float Normal[3];
+		float TextureCoordinates[2];
+	} PrimitiveVertex;
+
+	// DirectXTK's GeometricPrimitive shapes at unit size: a cube of side 1; spheres, cylinder, cone and torus of
+	// diameter 1, the cylinder and cone of height 1 and the torus of thickness 0.333; and the teapot at size 1. Sizes are
+	// left to world transforms, so one mesh serves every light proxy or bounds volume of a shape.
+	//
+	// Tessellation means what it does for DirectXTK, except for the geosphere: there it is the number of times the
+	// octahedron's edges are halved, but each face is split as a grid and projected onto the sphere, rather than
+	// subdivided level by level through an edge map. Every shape is generated in pieces whose vertex and index ranges are
+	// known up front (rings of the sphere and torus, octahedron faces, teapot patches), so a thread pool generates the
+	// pieces in parallel into the same arrays, and the result doesn't depend on the thread count.
+	class PrimitiveGeometry
+	{
+	public:
+		// Throws std::runtime_error for tessellations below the shape's minimum, or meshes of more than 2^32 vertices.
+		// Meshes too small to gain from it aren't split across the thread pool.
+		static void Generate(PrimitiveShape shape, unsigned int tessellation, bool isRightHanded, std::vector<PrimitiveVertex>& vertices,
+			std::vector<unsigned int>& indices, ThreadPool* threadPool = nullptr);
+
+		// DirectXTK's defaults, and the least each shape accepts; the cube ignores tessellation
+		static unsigned int DefaultTessellation(PrimitiveShape shape);
+		static unsigned int MinimumTessellation(PrimitiveShape shape);
+
+		// What ContentManager::LoadPrimitive() shares meshes by
+		static std::wstring CacheKey(PrimitiveShape shape, unsigned int tessellation, bool isRightHanded);
+
+		static const char* const ShapeNames[];
+
+	private:
+		PrimitiveGeometry();
+		PrimitiveGeometry(const PrimitiveGeometry& rhs);
+		PrimitiveGeometry& operator=(const PrimitiveGeometry& rhs);
+
+		static const unsigned int MinimumParallelVertexCount;
+		static const unsigned int MaximumGeoSphereTessellation;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "PrimitiveMaterial.h"
+#include "GameException.h"
+#include "PrimitiveGeometry.h"
+
+namespace Library
+{
+	RTTI_DEFINITIONS(PrimitiveMaterial)
+
+	PrimitiveMaterial::PrimitiveMaterial()
+		: Material("solid"),
+		  MATERIAL_VARIABLE_INITIALIZATION(ViewProjection), MATERIAL_VARIABLE_INITIALIZATION(LightDirection),
+		  MATERIAL_VARIABLE_INITIALIZATION(AmbientIntensity)
+	{
+	}
+
+	MATERIAL_VARIABLE_DEFINITION(PrimitiveMaterial, ViewProjection)
+	MATERIAL_VARIABLE_DEFINITION(PrimitiveMaterial, LightDirection)
+	MATERIAL_VARIABLE_DEFINITION(PrimitiveMaterial, AmbientIntensity)
+
+	void PrimitiveMaterial::Initialize(Effect& effect)
+	{
+		Material::Initialize(effect);
+
+		MATERIAL_VARIABLE_RETRIEVE(ViewProjection)
+		MATERIAL_VARIABLE_RETRIEVE(LightDirection)
+		MATERIAL_VARIABLE_RETRIEVE(AmbientIntensity)
+
+		// PrimitiveVertex in slot 0, and PrimitiveInstance in slot 1
+		D3D11_INPUT_ELEMENT_DESC inputElementDescriptions[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 64, D3D11_INPUT_PER_INSTANCE_DATA, 1 }
+		};
+
+		CreateInputLayout("solid", "p0", inputElementDescriptions, ARRAYSIZE(inputElementDescriptions));
+		CreateInputLayout("wireframe", "p0", inputElementDescriptions, ARRAYSIZE(inputElementDescriptions));
+	}
+
+	void PrimitiveMaterial::CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
+	{
+		throw GameException("PrimitiveMaterial has no mesh vertex buffers.");
+	}
+
+	UINT PrimitiveMaterial::VertexSize() const
+	{
+		return sizeof(PrimitiveVertex);
+	}
+}
\ No newline at end of file
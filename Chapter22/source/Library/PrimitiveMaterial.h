@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Common.h"
+#include "Material.h"
+
+namespace Library
+{
+	// Primitive vertices come from PrimitiveMesh's buffers, and per-instance worlds and colors from PrimitiveRenderer's
+	// instance buffer, so there are no mesh vertex buffers to create
+	class PrimitiveMaterial : public Material
+	{
+		RTTI_DECLARATIONS(PrimitiveMaterial, Material)
+
+		MATERIAL_VARIABLE_DECLARATION(ViewProjection)
+		MATERIAL_VARIABLE_DECLARATION(LightDirection)
+		MATERIAL_VARIABLE_DECLARATION(AmbientIntensity)
+
+	public:
+		PrimitiveMaterial();
+
+		virtual void Initialize(Effect& effect) override;
+		virtual void CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const override;
+		virtual UINT VertexSize() const override;
+	};
+}
\ No newline at end of file
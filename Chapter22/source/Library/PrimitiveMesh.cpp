@@ -0,0 +1,99 @@
+#include "PrimitiveMesh.h"
+#include "Game.h"
+#include "GameException.h"
+#include <stdexcept>
+
+namespace Library
+{
+	PrimitiveMesh::PrimitiveMesh(Game& game, PrimitiveShape shape, UINT tessellation, bool isRightHanded)
+		: mShape(shape), mTessellation(tessellation), mIsRightHanded(isRightHanded), mVertexBuffer(nullptr), mIndexBuffer(nullptr),
+		  mVertexCount(0), mIndexCount(0)
+	{
+		std::vector<PrimitiveVertex> vertices;
+		std::vector<unsigned int> indices;
+		try
+		{
+			PrimitiveGeometry::Generate(shape, tessellation, isRightHanded, vertices, indices, &game.WorkerThreads());
+		}
+		catch (std::runtime_error& ex)
+		{
+			const char* message = ex.what();
+			throw GameException(message);
+		}
+
+		mVertexCount = static_cast<UINT>(vertices.size());
+		mIndexCount = static_cast<UINT>(indices.size());
+
+		D3D11_BUFFER_DESC vertexBufferDesc;
+		ZeroMemory(&vertexBufferDesc, sizeof(vertexBufferDesc));
+		vertexBufferDesc.ByteWidth = sizeof(PrimitiveVertex) * mVertexCount;
+		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+
+		D3D11_SUBRESOURCE_DATA vertexSubResourceData;
+		ZeroMemory(&vertexSubResourceData, sizeof(vertexSubResourceData));
+		vertexSubResourceData.pSysMem = &vertices[0];
+
+		HRESULT hr;
+		if (FAILED(hr = game.Direct3DDevice()->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, &mVertexBuffer)))
+		{
+			throw GameException("ID3D11Device::CreateBuffer() failed.", hr);
+		}
+
+		D3D11_BUFFER_DESC indexBufferDesc;
+		ZeroMemory(&indexBufferDesc, sizeof(indexBufferDesc));
+		indexBufferDesc.ByteWidth = sizeof(UINT) * mIndexCount;
+		indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+
+		D3D11_SUBRESOURCE_DATA indexSubResourceData;
+		ZeroMemory(&indexSubResourceData, sizeof(indexSubResourceData));
+		indexSubResourceData.pSysMem = &indices[0];
+		if (FAILED(hr = game.Direct3DDevice()->CreateBuffer(&indexBufferDesc, &indexSubResourceData, &mIndexBuffer)))
+		{
+			ReleaseObject(mVertexBuffer);
+			throw GameException("ID3D11Device::CreateBuffer() failed.", hr);
+		}
+	}
+
+	PrimitiveMesh::~PrimitiveMesh()
+	{
+		ReleaseObject(mIndexBuffer);
+		ReleaseObject(mVertexBuffer);
+	}
+
+	PrimitiveShape PrimitiveMesh::Shape() const
+	{
+		return mShape;
+	}
+
+	UINT PrimitiveMesh::Tessellation() const
+	{
+		return mTessellation;
+	}
+
+	bool PrimitiveMesh::IsRightHanded() const
+	{
+		return mIsRightHanded;
+	}
+
+	ID3D11Buffer* PrimitiveMesh::VertexBuffer() const
+	{
+		return mVertexBuffer;
+	}
+
+	ID3D11Buffer* PrimitiveMesh::IndexBuffer() const
+	{
+		return mIndexBuffer;
+	}
+
+	UINT PrimitiveMesh::VertexCount() const
+	{
+		return mVertexCount;
+	}
+
+	UINT PrimitiveMesh::IndexCount() const
+	{
+		return mIndexCount;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Common.h"
+#include "PrimitiveGeometry.h"
+
+namespace Library
+{
+	class Game;
+
+	// A GeometricPrimitive shape's vertex and index buffers, immutable, at unit size. Load it through
+	// ContentManager::LoadPrimitive() so light proxies and bounds volumes of a shape share one, and draw instances of it
+	// with PrimitiveRenderer. Fine tessellations are generated on the game's worker threads.
+	class PrimitiveMesh
+	{
+	public:
+		PrimitiveMesh(Game& game, PrimitiveShape shape, UINT tessellation, bool isRightHanded = true);
+		~PrimitiveMesh();
+
+		PrimitiveShape Shape() const;
+		UINT Tessellation() const;
+		bool IsRightHanded() const;
+
+		ID3D11Buffer* VertexBuffer() const;
+		ID3D11Buffer* IndexBuffer() const;
+		UINT VertexCount() const;
+		UINT IndexCount() const;
+
+	private:
+		PrimitiveMesh();
+		PrimitiveMesh(const PrimitiveMesh& rhs);
+		PrimitiveMesh& operator=(const PrimitiveMesh& rhs);
+
+		PrimitiveShape mShape;
+		UINT mTessellation;
+		bool mIsRightHanded;
+		ID3D11Buffer* mVertexBuffer;
+		ID3D11Buffer* mIndexBuffer;
+		UINT mVertexCount;
+		UINT mIndexCount;
+	};
+}
\ No newline at end of file
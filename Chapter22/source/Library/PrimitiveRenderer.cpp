@@ -0,0 +1,197 @@
+#include "PrimitiveRenderer.h"
+#include "Game.h"
+#include "GameException.h"
+#include "ContentManager.h"
+#include "Effect.h"
+#include "PrimitiveMaterial.h"
+#include "PrimitiveMesh.h"
+#include "Technique.h"
+#include "Pass.h"
+
+namespace Library
+{
+	const UINT PrimitiveRenderer::DefaultCapacity = 256;
+
+	PrimitiveRenderer::PrimitiveRenderer(Game& game, UINT initialCapacity)
+		: mGame(&game), mEffect(), mMaterial(nullptr), mSolidPass(nullptr), mWireframePass(nullptr), mInstanceBuffer(nullptr), mCapacity(0),
+		  mInstances(), mInstanceMeshes(), mSortedInstances(), mMeshOffsets(), mMeshes(), mMeshIndices(), mViewProjection(),
+		  mLightDirection(-0.3f, -0.8f, -0.5f), mAmbientIntensity(0.35f), mIsWireframe(false), mIsDrawing(false)
+	{
+		mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\Primitive.cso");
+		mMaterial = new PrimitiveMaterial();
+		mMaterial->Initialize(*mEffect);
+
+		const std::map<std::string, Technique*>& techniques = mEffect->TechniquesByName();
+		mSolidPass = techniques.at("solid")->PassesByName().at("p0");
+		mWireframePass = techniques.at("wireframe")->PassesByName().at("p0");
+
+		CreateInstanceBuffer(max(initialCapacity, 1U));
+	}
+
+	PrimitiveRenderer::~PrimitiveRenderer()
+	{
+		ReleaseObject(mInstanceBuffer);
+		DeleteObject(mMaterial);
+	}
+
+	void PrimitiveRenderer::Begin(CXMMATRIX viewProjection, bool isWireframe)
+	{
+		if (mIsDrawing)
+		{
+			throw GameException("PrimitiveRenderer::Begin() called twice without End().");
+		}
+
+		mInstances.clear();
+		mInstanceMeshes.clear();
+		mMeshes.clear();
+		mMeshIndices.clear();
+		XMStoreFloat4x4(&mViewProjection, viewProjection);
+		mIsWireframe = isWireframe;
+		mIsDrawing = true;
+	}
+
+	void PrimitiveRenderer::Draw(const PrimitiveMesh& mesh, CXMMATRIX world, FXMVECTOR color)
+	{
+		assert(mIsDrawing);
+
+		PrimitiveInstance instance;
+		XMStoreFloat4x4(&instance.World, world);
+		XMStoreFloat4(&instance.Color, color);
+		mInstances.push_back(instance);
+		mInstanceMeshes.push_back(MeshIndex(mesh));
+	}
+
+	void PrimitiveRenderer::End()
+	{
+		if (mIsDrawing == false)
+		{
+			throw GameException("PrimitiveRenderer::End() called without Begin().");
+		}
+
+		mIsDrawing = false;
+		if (mInstances.empty())
+		{
+			return;
+		}
+
+		// A counting sort by mesh, keeping the order instances were drawn in within each
+		mMeshOffsets.assign(mMeshes.size() + 1, 0);
+		for (UINT mesh : mInstanceMeshes)
+		{
+			mMeshOffsets[mesh + 1]++;
+		}
+
+		for (UINT i = 1; i < mMeshOffsets.size(); i++)
+		{
+			mMeshOffsets[i] += mMeshOffsets[i - 1];
+		}
+
+		mSortedInstances.resize(mInstances.size());
+		std::vector<UINT> nextInstance(mMeshOffsets.begin(), mMeshOffsets.end() - 1);
+		for (UINT i = 0; i < mInstances.size(); i++)
+		{
+			mSortedInstances[nextInstance[mInstanceMeshes[i]]++] = mInstances[i];
+		}
+
+		if (mInstances.size() > mCapacity)
+		{
+			CreateInstanceBuffer(max(static_cast<UINT>(mInstances.size()), mCapacity * 2));
+		}
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		D3D11_MAPPED_SUBRESOURCE mappedResource;
+		HRESULT hr;
+		if (FAILED(hr = direct3DDeviceContext->Map(mInstanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource)))
+		{
+			throw GameException("ID3D11DeviceContext::Map() failed.", hr);
+		}
+
+		memcpy(mappedResource.pData, &mSortedInstances[0], sizeof(PrimitiveInstance) * mSortedInstances.size());
+		direct3DDeviceContext->Unmap(mInstanceBuffer, 0);
+
+		Pass* pass = (mIsWireframe ? mWireframePass : mSolidPass);
+		direct3DDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		direct3DDeviceContext->IASetInputLayout(mMaterial->InputLayouts().at(pass));
+
+		mMaterial->ViewProjection() << XMLoadFloat4x4(&mViewProjection);
+		mMaterial->LightDirection() << XMLoadFloat3(&mLightDirection);
+		mMaterial->AmbientIntensity() << mAmbientIntensity;
+		pass->Apply(0, direct3DDeviceContext);
+
+		UINT strides[2] = { sizeof(PrimitiveVertex), sizeof(PrimitiveInstance) };
+		UINT offsets[2] = { 0, 0 };
+		for (UINT i = 0; i < mMeshes.size(); i++)
+		{
+			const PrimitiveMesh& mesh = *mMeshes[i];
+			ID3D11Buffer* vertexBuffers[2] = { mesh.VertexBuffer(), mInstanceBuffer };
+			direct3DDeviceContext->IASetVertexBuffers(0, 2, vertexBuffers, strides, offsets);
+			direct3DDeviceContext->IASetIndexBuffer(mesh.IndexBuffer(), DXGI_FORMAT_R32_UINT, 0);
+			direct3DDeviceContext->DrawIndexedInstanced(mesh.IndexCount(), mMeshOffsets[i + 1] - mMeshOffsets[i], 0, 0, mMeshOffsets[i]);
+		}
+	}
+
+	UINT PrimitiveRenderer::Capacity() const
+	{
+		return mCapacity;
+	}
+
+	const XMFLOAT3& PrimitiveRenderer::LightDirection() const
+	{
+		return mLightDirection;
+	}
+
+	void PrimitiveRenderer::SetLightDirection(const XMFLOAT3& lightDirection)
+	{
+		mLightDirection = lightDirection;
+	}
+
+	float PrimitiveRenderer::AmbientIntensity() const
+	{
+		return mAmbientIntensity;
+	}
+
+	void PrimitiveRenderer::SetAmbientIntensity(float ambientIntensity)
+	{
+		mAmbientIntensity = ambientIntensity;
+	}
+
+	UINT PrimitiveRenderer::MeshIndex(const PrimitiveMesh& mesh)
+	{
+		if (mMeshes.empty() == false && mMeshes.back() == &mesh)
+		{
+			return static_cast<UINT>(mMeshes.size() - 1);
+		}
+
+		auto it = mMeshIndices.find(&mesh);
+		if (it != mMeshIndices.end())
+		{
+			return it->second;
+		}
+
+		UINT index = static_cast<UINT>(mMeshes.size());
+		mMeshes.push_back(&mesh);
+		mMeshIndices[&mesh] = index;
+
+		return index;
+	}
+
+	void PrimitiveRenderer::CreateInstanceBuffer(UINT capacity)
+	{
+		ReleaseObject(mInstanceBuffer);
+
+		D3D11_BUFFER_DESC instanceBufferDesc;
+		ZeroMemory(&instanceBufferDesc, sizeof(instanceBufferDesc));
+		instanceBufferDesc.ByteWidth = sizeof(PrimitiveInstance) * capacity;
+		instanceBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+		instanceBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		instanceBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+		HRESULT hr;
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateBuffer(&instanceBufferDesc, nullptr, &mInstanceBuffer)))
+		{
+			throw GameException("ID3D11Device::CreateBuffer() failed.", hr);
+		}
+
+		mCapacity = capacity;
+	}
+}
\ No newline at end of file
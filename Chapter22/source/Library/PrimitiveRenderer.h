@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Common.h"
+#include "ColorHelper.h"
+
+namespace Library
+{
+	class Game;
+	class Effect;
+	class Pass;
+	class PrimitiveMaterial;
+	class PrimitiveMesh;
+
+	typedef struct _PrimitiveInstance
+	{
+		XMFLOAT4X4 World;
+		XMFLOAT4 Color;
+	} PrimitiveInstance;
+
+	// Draws light proxies and bounds volumes as instances of shared PrimitiveMeshes: Draw() only queues a world matrix
+	// and a color, and End() writes every instance into one dynamic buffer, grouped by mesh, and issues a single
+	// DrawIndexedInstanced() per mesh, where each GeometricPrimitive::Draw() would set its effect and buffers again. The
+	// meshes must outlive End(). The instance buffer starts at initialCapacity and grows to the busiest frame.
+	//
+	// primitive.fx sets its own rasterizer state, solid or wireframe, so save and restore it around Begin() and End().
+	class PrimitiveRenderer
+	{
+	public:
+		PrimitiveRenderer(Game& game, UINT initialCapacity = DefaultCapacity);
+		~PrimitiveRenderer();
+
+		void Begin(CXMMATRIX viewProjection, bool isWireframe = false);
+		void Draw(const PrimitiveMesh& mesh, CXMMATRIX world, FXMVECTOR color = ColorHelper::White);
+		void End();
+
+		UINT Capacity() const;
+
+		const XMFLOAT3& LightDirection() const;
+		void SetLightDirection(const XMFLOAT3& lightDirection);
+		float AmbientIntensity() const;
+		void SetAmbientIntensity(float ambientIntensity);
+
+		static const UINT DefaultCapacity;
+
+	private:
+		PrimitiveRenderer();
+		PrimitiveRenderer(const PrimitiveRenderer& rhs);
+		PrimitiveRenderer& operator=(const PrimitiveRenderer& rhs);
+
+		UINT MeshIndex(const PrimitiveMesh& mesh);
+		void CreateInstanceBuffer(UINT capacity);
+
+		Game* mGame;
+		std::shared_ptr<Effect> mEffect;
+		PrimitiveMaterial* mMaterial;
+		Pass* mSolidPass;
+		Pass* mWireframePass;
+		ID3D11Buffer* mInstanceBuffer;
+		UINT mCapacity;
+
+		std::vector<PrimitiveInstance> mInstances;
+		std::vector<UINT> mInstanceMeshes;
+		std::vector<PrimitiveInstance> mSortedInstances;
+		std::vector<UINT> mMeshOffsets;
+		std::vector<const PrimitiveMesh*> mMeshes;
+		std::map<const PrimitiveMesh*, UINT> mMeshIndices;
+		XMFLOAT4X4 mViewProjection;
+		XMFLOAT3 mLightDirection;
+		float mAmbientIntensity;
+		bool mIsWireframe;
+		bool mIsDrawing;
+	};
+}
\ No newline at end of file
@@ -5,10 +5,10 @@
 #include "Camera.h"
 #include "MatrixHelper.h"
 #include "VectorHelper.h"
-#include "Model.h"
-#include "Mesh.h"
+#include "MeshBuffers.h"
 #include "Utility.h"
 #include "RasterizerStates.h"
+#include "ContentManager.h"
 
 namespace Library
 {
@@ -16,8 +16,7 @@ namespace Library
 
 	ProxyModel::ProxyModel(Game& game, Camera& camera, const std::string& modelFileName, float scale)
 		: DrawableGameComponent(game, camera),
-		  mModelFileName(modelFileName), mEffect(nullptr), mMaterial(nullptr),
-		  mVertexBuffer(nullptr), mIndexBuffer(nullptr), mIndexCount(0),
+		  mModelFileName(modelFileName), mEffect(), mMaterial(nullptr), mMeshBuffers(),
 		  mWorldMatrix(MatrixHelper::Identity), mScaleMatrix(MatrixHelper::Identity), mDisplayWireframe(true),
 		  mPosition(Vector3Helper::Zero), mDirection(Vector3Helper::Forward), mUp(Vector3Helper::Up), mRight(Vector3Helper::Right)
 	{
@@ -27,9 +26,6 @@ namespace Library
 	ProxyModel::~ProxyModel()
 	{
 		DeleteObject(mMaterial);
-		DeleteObject(mEffect);
-		ReleaseObject(mVertexBuffer);
-		ReleaseObject(mIndexBuffer);
 	}
 
 	const XMFLOAT3& ProxyModel::Position() const
@@ -122,18 +118,13 @@ namespace Library
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
-		std::unique_ptr<Model> model(new Model(*mGame, mModelFileName, true));
-
-		mEffect = new Effect(*mGame);
-		mEffect->LoadCompiledEffect(L"Content\\Effects\\BasicEffect.cso");
+		mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\BasicEffect.cso");
 
 		mMaterial = new BasicMaterial();
 		mMaterial->Initialize(*mEffect);
 
-		Mesh* mesh = model->Meshes().at(0);
-		mMaterial->CreateVertexBuffer(mGame->Direct3DDevice(), *mesh, &mVertexBuffer);
-		mesh->CreateIndexBuffer(&mIndexBuffer);
-		mIndexCount = mesh->Indices().size();
+		// Proxies of a file draw from one pair of buffers, and the model itself isn't kept once they are built
+		mMeshBuffers = mGame->Content().LoadMeshBuffers(mModelFileName, true, 0, *mMaterial);
 	}
 
 	void ProxyModel::Update(const GameTime& gameTime)
@@ -156,10 +147,11 @@ namespace Library
 		ID3D11InputLayout* inputLayout = mMaterial->InputLayouts().at(pass);
 		direct3DDeviceContext->IASetInputLayout(inputLayout);
 
-		UINT stride = mMaterial->VertexSize();
+		ID3D11Buffer* vertexBuffer = mMeshBuffers->VertexBuffer();
+		UINT stride = mMeshBuffers->VertexSize();
 		UINT offset = 0;
-		direct3DDeviceContext->IASetVertexBuffers(0, 1, &mVertexBuffer, &stride, &offset);
-		direct3DDeviceContext->IASetIndexBuffer(mIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+		direct3DDeviceContext->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+		direct3DDeviceContext->IASetIndexBuffer(mMeshBuffers->IndexBuffer(), DXGI_FORMAT_R32_UINT, 0);
 
 		XMMATRIX wvp = XMLoadFloat4x4(&mWorldMatrix) * mCamera->ViewMatrix() * mCamera->ProjectionMatrix();		
 		mMaterial->WorldViewProjection() << wvp;
@@ -169,12 +161,12 @@ namespace Library
 		if (mDisplayWireframe)
 		{
 			mGame->Direct3DDeviceContext()->RSSetState(RasterizerStates::Wireframe);
-			direct3DDeviceContext->DrawIndexed(mIndexCount, 0, 0);
+			direct3DDeviceContext->DrawIndexed(mMeshBuffers->IndexCount(), 0, 0);
 			mGame->Direct3DDeviceContext()->RSSetState(nullptr);
 		}
 		else
 		{
-			direct3DDeviceContext->DrawIndexed(mIndexCount, 0, 0);
+			direct3DDeviceContext->DrawIndexed(mMeshBuffers->IndexCount(), 0, 0);
 		}
 	}
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 namespace Library
 {
 	class Effect;
+	class MeshBuffers;
 	class BasicMaterial;
 
 	class ProxyModel : public DrawableGameComponent
@@ -45,11 +46,9 @@ namespace Library
 		ProxyModel& operator=(const ProxyModel& rhs);
 
 		std::string mModelFileName;
-		Effect* mEffect;
+		std::shared_ptr<Effect> mEffect;
 		BasicMaterial* mMaterial;
-		ID3D11Buffer* mVertexBuffer;
-		ID3D11Buffer* mIndexBuffer;
-		UINT mIndexCount;
+		std::shared_ptr<MeshBuffers> mMeshBuffers;
         
 		XMFLOAT4X4 mWorldMatrix;
 		XMFLOAT4X4 mScaleMatrix;
@@ -0,0 +1,128 @@
+#include "ShadowCascades.h"
+#include "Camera.h"
+#include "MatrixHelper.h"
+
+namespace Library
+{
+	const UINT ShadowCascades::MaximumCascadeCount = 4;
+	const UINT ShadowCascades::DefaultCascadeCount = 4;
+	const UINT ShadowCascades::DefaultResolution = 2048;
+	const float ShadowCascades::DefaultSplitLambda = 0.75f;
+	const float ShadowCascades::DefaultCasterDistance = 100.0f;
+
+	ShadowCascades::ShadowCascades(UINT cascadeCount, UINT resolution)
+		: mCascades(cascadeCount), mSplitDistances(cascadeCount + 1), mResolution(resolution), mSplitLambda(DefaultSplitLambda),
+		  mCasterDistance(DefaultCasterDistance), mFitMode(CascadeFitModeSphere), mLightViewMatrix(MatrixHelper::Identity)
+	{
+		assert(cascadeCount > 0 && cascadeCount <= MaximumCascadeCount);
+	}
+
+	UINT ShadowCascades::CascadeCount() const
+	{
+		return static_cast<UINT>(mCascades.size());
+	}
+
+	UINT ShadowCascades::Resolution() const
+	{
+		return mResolution;
+	}
+
+	float ShadowCascades::SplitLambda() const
+	{
+		return mSplitLambda;
+	}
+
+	void ShadowCascades::SetSplitLambda(float splitLambda)
+	{
+		mSplitLambda = splitLambda;
+	}
+
+	float ShadowCascades::CasterDistance() const
+	{
+		return mCasterDistance;
+	}
+
+	void ShadowCascades::SetCasterDistance(float casterDistance)
+	{
+		mCasterDistance = casterDistance;
+	}
+
+	CascadeFitMode ShadowCascades::FitMode() const
+	{
+		return mFitMode;
+	}
+
+	void ShadowCascades::SetFitMode(CascadeFitMode fitMode)
+	{
+		mFitMode = fitMode;
+	}
+
+	const ShadowCascade& ShadowCascades::Cascade(UINT index) const
+	{
+		return mCascades.at(index);
+	}
+
+	XMMATRIX ShadowCascades::LightViewMatrix() const
+	{
+		return XMLoadFloat4x4(&mLightViewMatrix);
+	}
+
+	void ShadowCascades::Update(const Camera& camera, FXMVECTOR lightDirection)
+	{
+		CascadeFitting::ComputeSplitDistances(camera.NearPlaneDistance(), camera.FarPlaneDistance(), CascadeCount(), mSplitLambda, mSplitDistances);
+
+		XMFLOAT3 direction;
+		XMStoreFloat3(&direction, lightDirection);
+		CascadeLightBasis basis;
+		CascadeFitting::ComputeLightBasis(&direction.x, basis);
+
+		// The basis vectors are the view matrix's columns; the light sits at the origin, so there is no translation
+		XMMATRIX lightViewMatrix = XMMatrixSet(basis.Right[0], basis.Up[0], basis.Forward[0], 0.0f,
+			basis.Right[1], basis.Up[1], basis.Forward[1], 0.0f,
+			basis.Right[2], basis.Up[2], basis.Forward[2], 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f);
+		XMStoreFloat4x4(&mLightViewMatrix, lightViewMatrix);
+
+		for (UINT i = 0; i < mCascades.size(); i++)
+		{
+			float corners[8][3];
+			CascadeFitting::ComputeSliceCorners(&camera.Position().x, &camera.Direction().x, &camera.Up().x, &camera.Right().x, camera.FieldOfView(),
+				camera.AspectRatio(), mSplitDistances[i], mSplitDistances[i + 1], corners);
+
+			CascadeBounds bounds;
+			CascadeFitting::FitBounds(corners, basis, mResolution, mFitMode, mCasterDistance, bounds);
+
+			ShadowCascade& cascade = mCascades[i];
+			cascade.NearDistance = mSplitDistances[i];
+			cascade.FarDistance = mSplitDistances[i + 1];
+			SetProjection(lightViewMatrix, bounds, cascade);
+		}
+	}
+
+	bool ShadowCascades::IntersectsCaster(UINT cascade, const XMFLOAT3& center, float radius) const
+	{
+		const ShadowCascade& shadowCascade = mCascades.at(cascade);
+
+		XMFLOAT3 lightSpaceCenter;
+		XMStoreFloat3(&lightSpaceCenter, XMVector3TransformCoord(XMLoadFloat3(&center), XMLoadFloat4x4(&mLightViewMatrix)));
+
+		return (lightSpaceCenter.x + radius >= shadowCascade.LightSpaceMinimum.x && lightSpaceCenter.x - radius <= shadowCascade.LightSpaceMaximum.x &&
+			lightSpaceCenter.y + radius >= shadowCascade.LightSpaceMinimum.y && lightSpaceCenter.y - radius <= shadowCascade.LightSpaceMaximum.y &&
+			lightSpaceCenter.z + radius >= shadowCascade.LightSpaceMinimum.z && lightSpaceCenter.z - radius <= shadowCascade.LightSpaceMaximum.z);
+	}
+
+	void ShadowCascades::SetProjection(CXMMATRIX lightViewMatrix, const CascadeBounds& bounds, ShadowCascade& cascade)
+	{
+		cascade.LightSpaceMinimum = XMFLOAT3(bounds.Minimum);
+		cascade.LightSpaceMaximum = XMFLOAT3(bounds.Maximum);
+
+		XMMATRIX projectionMatrix = XMMatrixOrthographicOffCenterLH(cascade.LightSpaceMinimum.x, cascade.LightSpaceMaximum.x, cascade.LightSpaceMinimum.y,
+			cascade.LightSpaceMaximum.y, cascade.LightSpaceMinimum.z, cascade.LightSpaceMaximum.z);
+		XMMATRIX viewProjectionMatrix = lightViewMatrix * projectionMatrix;
+		XMStoreFloat4x4(&cascade.ViewProjection, viewProjectionMatrix);
+
+		// Clip space to texture space
+		XMMATRIX textureScalingMatrix = XMMatrixScaling(0.5f, -0.5f, 1.0f) * XMMatrixTranslation(0.5f, 0.5f, 0.0f);
+		XMStoreFloat4x4(&cascade.TextureMatrix, viewProjectionMatrix * textureScalingMatrix);
+	}
+}
\ No newline at end of file
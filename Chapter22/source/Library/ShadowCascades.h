@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Common.h"
+#include "CascadeFitting.h"
+
+namespace Library
+{
+	class Camera;
+
+	typedef struct _ShadowCascade
+	{
+		float NearDistance;
+		float FarDistance;
+		XMFLOAT3 LightSpaceMinimum;
+		XMFLOAT3 LightSpaceMaximum;
+		XMFLOAT4X4 ViewProjection;
+		XMFLOAT4X4 TextureMatrix;
+	} ShadowCascade;
+
+	// Splits the camera frustum for a directional light and fits an orthographic projection to each slice, with the
+	// split, fit and snapping math in CascadeFitting.
+	class ShadowCascades
+	{
+	public:
+		ShadowCascades(UINT cascadeCount = DefaultCascadeCount, UINT resolution = DefaultResolution);
+
+		UINT CascadeCount() const;
+		UINT Resolution() const;
+
+		float SplitLambda() const;
+		void SetSplitLambda(float splitLambda);
+
+		// How far toward the light each cascade's volume extends to keep casters outside the view
+		float CasterDistance() const;
+		void SetCasterDistance(float casterDistance);
+
+		CascadeFitMode FitMode() const;
+		void SetFitMode(CascadeFitMode fitMode);
+
+		const ShadowCascade& Cascade(UINT index) const;
+		XMMATRIX LightViewMatrix() const;
+
+		void Update(const Camera& camera, FXMVECTOR lightDirection);
+
+		// True if a caster bounded by the sphere can throw a shadow into the cascade
+		bool IntersectsCaster(UINT cascade, const XMFLOAT3& center, float radius) const;
+
+		static const UINT MaximumCascadeCount;
+		static const UINT DefaultCascadeCount;
+		static const UINT DefaultResolution;
+		static const float DefaultSplitLambda;
+		static const float DefaultCasterDistance;
+
+	private:
+		ShadowCascades(const ShadowCascades& rhs);
+		ShadowCascades& operator=(const ShadowCascades& rhs);
+
+		static void SetProjection(CXMMATRIX lightViewMatrix, const CascadeBounds& bounds, ShadowCascade& cascade);
+
+		std::vector<ShadowCascade> mCascades;
+		std::vector<float> mSplitDistances;
+		UINT mResolution;
+		float mSplitLambda;
+		float mCasterDistance;
+		CascadeFitMode mFitMode;
+		XMFLOAT4X4 mLightViewMatrix;
+	};
+}
\ No newline at end of file
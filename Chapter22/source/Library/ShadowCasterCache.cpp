@@ -0,0 +1,171 @@
+#include "ShadowCasterCache.h"
+#include "Game.h"
+#include "GameException.h"
+#include "DepthMap.h"
+#include "Frustum.h"
+
+namespace Library
+{
+	ShadowCasterCache::ShadowCasterCache(Game& game, UINT resolution)
+		: mGame(&game), mStaticDepthMap(nullptr), mDepthMap(nullptr), mStaticTexture(nullptr), mTexture(nullptr),
+		  mCasters(), mNextCaster(0), mIsStaticLayerValid(false), mStaticLightViewProjectionMatrix(), mStatistics()
+	{
+		mStaticDepthMap = new DepthMap(game, resolution, resolution);
+		mDepthMap = new DepthMap(game, resolution, resolution);
+
+		mStaticDepthMap->OutputTexture()->GetResource(&mStaticTexture);
+		mDepthMap->OutputTexture()->GetResource(&mTexture);
+	}
+
+	ShadowCasterCache::~ShadowCasterCache()
+	{
+		ReleaseObject(mTexture);
+		ReleaseObject(mStaticTexture);
+		DeleteObject(mDepthMap);
+		DeleteObject(mStaticDepthMap);
+	}
+
+	UINT ShadowCasterCache::AddCaster(const XMFLOAT3& center, float radius, bool isStatic, const ShadowCasterDraw& draw)
+	{
+		ShadowCaster caster = { center, radius, isStatic, draw };
+		mCasters[mNextCaster] = caster;
+
+		if (isStatic)
+		{
+			mIsStaticLayerValid = false;
+		}
+
+		return mNextCaster++;
+	}
+
+	void ShadowCasterCache::RemoveCaster(UINT caster)
+	{
+		auto it = mCasters.find(caster);
+		if (it == mCasters.end())
+		{
+			throw GameException("Shadow caster not found.");
+		}
+
+		if (it->second.IsStatic)
+		{
+			mIsStaticLayerValid = false;
+		}
+
+		mCasters.erase(it);
+	}
+
+	void ShadowCasterCache::SetCasterBounds(UINT caster, const XMFLOAT3& center, float radius)
+	{
+		auto it = mCasters.find(caster);
+		if (it == mCasters.end())
+		{
+			throw GameException("Shadow caster not found.");
+		}
+
+		it->second.Center = center;
+		it->second.Radius = radius;
+
+		if (it->second.IsStatic)
+		{
+			mIsStaticLayerValid = false;
+		}
+	}
+
+	void ShadowCasterCache::Invalidate()
+	{
+		mIsStaticLayerValid = false;
+	}
+
+	void ShadowCasterCache::Draw(CXMMATRIX lightViewProjectionMatrix)
+	{
+		ZeroMemory(&mStatistics, sizeof(mStatistics));
+
+		XMFLOAT4X4 lightViewProjection;
+		XMStoreFloat4x4(&lightViewProjection, lightViewProjectionMatrix);
+		if (memcmp(&lightViewProjection, &mStaticLightViewProjectionMatrix, sizeof(lightViewProjection)) != 0)
+		{
+			mIsStaticLayerValid = false;
+		}
+
+		Frustum frustum(lightViewProjectionMatrix);
+		if (mIsStaticLayerValid == false)
+		{
+			DrawCasters(*mStaticDepthMap, frustum, lightViewProjectionMatrix, true);
+			mStaticLightViewProjectionMatrix = lightViewProjection;
+			mIsStaticLayerValid = true;
+			mStatistics.StaticLayerRefreshed = true;
+		}
+
+		mGame->Direct3DDeviceContext()->CopyResource(mTexture, mStaticTexture);
+		DrawCasters(*mDepthMap, frustum, lightViewProjectionMatrix, false);
+
+		for (const auto& caster : mCasters)
+		{
+			if (caster.second.IsStatic)
+			{
+				mStatistics.StaticCasterCount++;
+			}
+			else
+			{
+				mStatistics.DynamicCasterCount++;
+			}
+		}
+	}
+
+	ID3D11ShaderResourceView* ShadowCasterCache::OutputTexture() const
+	{
+		return mDepthMap->OutputTexture();
+	}
+
+	const ShadowCasterStatistics& ShadowCasterCache::Statistics() const
+	{
+		return mStatistics;
+	}
+
+	void ShadowCasterCache::DrawCasters(DepthMap& depthMap, const Frustum& frustum, CXMMATRIX lightViewProjectionMatrix, bool isStatic)
+	{
+		depthMap.Begin();
+
+		// The dynamic layer starts from a copy of the static one
+		if (isStatic)
+		{
+			mGame->Direct3DDeviceContext()->ClearDepthStencilView(depthMap.DepthStencilView(), D3D11_CLEAR_DEPTH, 1.0f, 0);
+		}
+
+		for (const auto& caster : mCasters)
+		{
+			if (caster.second.IsStatic != isStatic)
+			{
+				continue;
+			}
+
+			if (Intersects(frustum, caster.second))
+			{
+				caster.second.Draw(lightViewProjectionMatrix);
+				mStatistics.DrawnCasterCount++;
+			}
+			else
+			{
+				mStatistics.CulledCasterCount++;
+			}
+		}
+
+		depthMap.End();
+	}
+
+	bool ShadowCasterCache::Intersects(const Frustum& frustum, const ShadowCaster& caster)
+	{
+		// Frustum planes face outward
+		XMVECTOR center = XMLoadFloat3(&caster.Center);
+		XMVECTOR planes[] = { frustum.NearVector(), frustum.FarVector(), frustum.LeftVector(), frustum.RightVector(), frustum.TopVector(), frustum.BottomVector() };
+		for (const XMVECTOR& plane : planes)
+		{
+			if (XMVectorGetX(XMPlaneDotCoord(plane, center)) > caster.Radius)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
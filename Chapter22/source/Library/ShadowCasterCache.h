@@ -0,0 +1,71 @@
+#pragma once
+
+#include <functional>
+#include "Common.h"
+
+namespace Library
+{
+	class Game;
+	class DepthMap;
+	class Frustum;
+
+	// Draws one caster with its depth material, given the light's view-projection matrix
+	typedef std::function<void(CXMMATRIX lightViewProjectionMatrix)> ShadowCasterDraw;
+
+	typedef struct _ShadowCasterStatistics
+	{
+		UINT StaticCasterCount;
+		UINT DynamicCasterCount;
+		UINT DrawnCasterCount;
+		UINT CulledCasterCount;
+		bool StaticLayerRefreshed;
+	} ShadowCasterStatistics;
+
+	// Renders a shadow depth map from casters culled against the light frustum rather than the view, so casters
+	// outside the view still shadow into it. Static casters go into a cached layer that is redrawn only when the
+	// light moves, a static caster changes or Invalidate() is called; each frame copies that layer and adds the
+	// dynamic casters on top.
+	class ShadowCasterCache
+	{
+	public:
+		ShadowCasterCache(Game& game, UINT resolution);
+		~ShadowCasterCache();
+
+		UINT AddCaster(const XMFLOAT3& center, float radius, bool isStatic, const ShadowCasterDraw& draw);
+		void RemoveCaster(UINT caster);
+		void SetCasterBounds(UINT caster, const XMFLOAT3& center, float radius);
+
+		void Invalidate();
+		void Draw(CXMMATRIX lightViewProjectionMatrix);
+
+		ID3D11ShaderResourceView* OutputTexture() const;
+		const ShadowCasterStatistics& Statistics() const;
+
+	private:
+		typedef struct _ShadowCaster
+		{
+			XMFLOAT3 Center;
+			float Radius;
+			bool IsStatic;
+			ShadowCasterDraw Draw;
+		} ShadowCaster;
+
+		ShadowCasterCache();
+		ShadowCasterCache(const ShadowCasterCache& rhs);
+		ShadowCasterCache& operator=(const ShadowCasterCache& rhs);
+
+		void DrawCasters(DepthMap& depthMap, const Frustum& frustum, CXMMATRIX lightViewProjectionMatrix, bool isStatic);
+		static bool Intersects(const Frustum& frustum, const ShadowCaster& caster);
+
+		Game* mGame;
+		DepthMap* mStaticDepthMap;
+		DepthMap* mDepthMap;
+		ID3D11Resource* mStaticTexture;
+		ID3D11Resource* mTexture;
+		std::map<UINT, ShadowCaster> mCasters;
+		UINT mNextCaster;
+		bool mIsStaticLayerValid;
+		XMFLOAT4X4 mStaticLightViewProjectionMatrix;
+		ShadowCasterStatistics mStatistics;
+	};
+}
\ No newline at end of file
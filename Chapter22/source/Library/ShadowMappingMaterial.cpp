@@ -14,7 +14,10 @@ namespace Library
 		  MATERIAL_VARIABLE_INITIALIZATION(LightPosition), MATERIAL_VARIABLE_INITIALIZATION(LightRadius),
 		  MATERIAL_VARIABLE_INITIALIZATION(CameraPosition), MATERIAL_VARIABLE_INITIALIZATION(ColorTexture),
 		  MATERIAL_VARIABLE_INITIALIZATION(ProjectiveTextureMatrix), MATERIAL_VARIABLE_INITIALIZATION(ShadowMap),
-		  MATERIAL_VARIABLE_INITIALIZATION(ShadowMapSize)
+		  MATERIAL_VARIABLE_INITIALIZATION(ShadowMapSize), MATERIAL_VARIABLE_INITIALIZATION(LightDirection),
+		  MATERIAL_VARIABLE_INITIALIZATION(CameraDirection), MATERIAL_VARIABLE_INITIALIZATION(CascadeDistances),
+		  MATERIAL_VARIABLE_INITIALIZATION(CascadeTextureMatrices), MATERIAL_VARIABLE_INITIALIZATION(CascadeCount),
+		  MATERIAL_VARIABLE_INITIALIZATION(CascadedShadowMap)
     {
     }
 
@@ -31,6 +34,12 @@ namespace Library
 	MATERIAL_VARIABLE_DEFINITION(ShadowMappingMaterial, ProjectiveTextureMatrix)
 	MATERIAL_VARIABLE_DEFINITION(ShadowMappingMaterial, ShadowMap)
 	MATERIAL_VARIABLE_DEFINITION(ShadowMappingMaterial, ShadowMapSize)
+	MATERIAL_VARIABLE_DEFINITION(ShadowMappingMaterial, LightDirection)
+	MATERIAL_VARIABLE_DEFINITION(ShadowMappingMaterial, CameraDirection)
+	MATERIAL_VARIABLE_DEFINITION(ShadowMappingMaterial, CascadeDistances)
+	MATERIAL_VARIABLE_DEFINITION(ShadowMappingMaterial, CascadeTextureMatrices)
+	MATERIAL_VARIABLE_DEFINITION(ShadowMappingMaterial, CascadeCount)
+	MATERIAL_VARIABLE_DEFINITION(ShadowMappingMaterial, CascadedShadowMap)
 
     void ShadowMappingMaterial::Initialize(Effect& effect)
     {
@@ -49,6 +58,12 @@ namespace Library
 		MATERIAL_VARIABLE_RETRIEVE(ProjectiveTextureMatrix)
 		MATERIAL_VARIABLE_RETRIEVE(ShadowMap)
 		MATERIAL_VARIABLE_RETRIEVE(ShadowMapSize)
+		MATERIAL_VARIABLE_RETRIEVE(LightDirection)
+		MATERIAL_VARIABLE_RETRIEVE(CameraDirection)
+		MATERIAL_VARIABLE_RETRIEVE(CascadeDistances)
+		MATERIAL_VARIABLE_RETRIEVE(CascadeTextureMatrices)
+		MATERIAL_VARIABLE_RETRIEVE(CascadeCount)
+		MATERIAL_VARIABLE_RETRIEVE(CascadedShadowMap)
 
         D3D11_INPUT_ELEMENT_DESC inputElementDescriptions[] =
         {
@@ -60,6 +75,7 @@ namespace Library
 		CreateInputLayout("shadow_mapping", "p0", inputElementDescriptions, ARRAYSIZE(inputElementDescriptions));
 		CreateInputLayout("shadow_mapping_manual_pcf", "p0", inputElementDescriptions, ARRAYSIZE(inputElementDescriptions));
 		CreateInputLayout("shadow_mapping_pcf", "p0", inputElementDescriptions, ARRAYSIZE(inputElementDescriptions));
+		CreateInputLayout("shadow_mapping_cascaded", "p0", inputElementDescriptions, ARRAYSIZE(inputElementDescriptions));
     }
 
     void ShadowMappingMaterial::CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
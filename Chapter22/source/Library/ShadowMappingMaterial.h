@@ -25,6 +25,13 @@ namespace Library
 		MATERIAL_VARIABLE_DECLARATION(ShadowMap)
 		MATERIAL_VARIABLE_DECLARATION(ShadowMapSize)
 
+		MATERIAL_VARIABLE_DECLARATION(LightDirection)
+		MATERIAL_VARIABLE_DECLARATION(CameraDirection)
+		MATERIAL_VARIABLE_DECLARATION(CascadeDistances)
+		MATERIAL_VARIABLE_DECLARATION(CascadeTextureMatrices)
+		MATERIAL_VARIABLE_DECLARATION(CascadeCount)
+		MATERIAL_VARIABLE_DECLARATION(CascadedShadowMap)
+
     public:
         ShadowMappingMaterial();
 
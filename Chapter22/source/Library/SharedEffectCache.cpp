@@ -0,0 +1,211 @@
+#include "SharedEffectCache.h"
+#include "Effect.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Utility.h"
+
+namespace Library
+{
+	SharedEffectCache::SharedEffectCache(Game& game)
+		: mGame(game), mEffects(), mFiles(), mPending(), mMutex()
+	{
+	}
+
+	SharedEffectCache::~SharedEffectCache()
+	{
+		Clear();
+	}
+
+	ID3DX11Effect* SharedEffectCache::CreateEffect(const std::wstring& filename)
+	{
+		UINT64 writeTime = LastWriteTime(filename);
+
+		{
+			// Unchanged files skip both the read and the hash
+			std::unique_lock<std::mutex> lock(mMutex);
+			auto file = mFiles.find(filename);
+			if (file != mFiles.end() && file->second.WriteTime == writeTime)
+			{
+				auto effect = mEffects.find(file->second.Key);
+				if (effect != mEffects.end())
+				{
+					return CloneEffect(lock, effect->second.Effect);
+				}
+			}
+		}
+
+		std::vector<char> compiledEffect;
+		Utility::LoadBinaryFile(filename, compiledEffect);
+		if (compiledEffect.empty())
+		{
+			throw GameException("Compiled effect is empty.");
+		}
+
+		ID3DX11Effect* effect = CreateEffect(compiledEffect);
+
+		SharedEffectFile file = { writeTime, Utility::Fnv1aHash(&compiledEffect.front(), compiledEffect.size()) };
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFiles[filename] = file;
+
+		return effect;
+	}
+
+	ID3DX11Effect* SharedEffectCache::CreateEffect(const std::vector<char>& compiledEffect)
+	{
+		if (compiledEffect.empty())
+		{
+			throw GameException("Compiled effect is empty.");
+		}
+
+		UINT64 key = Utility::Fnv1aHash(&compiledEffect.front(), compiledEffect.size());
+
+		// The lock only guards the maps, as in ContentManager::DemandCreate(): effects are parsed outside it, and a
+		// request for a blob that is being parsed waits for that parse instead of repeating it
+		std::unique_lock<std::mutex> lock(mMutex);
+		for (auto pending = mPending.find(key); pending != mPending.end(); pending = mPending.find(key))
+		{
+			std::shared_future<void> parsed = pending->second;
+			lock.unlock();
+			parsed.wait();
+			lock.lock();
+		}
+
+		auto entry = mEffects.find(key);
+		if (entry != mEffects.end())
+		{
+			if (entry->second.CompiledEffect == compiledEffect)
+			{
+				return CloneEffect(lock, entry->second.Effect);
+			}
+
+			// Hash collision; don't share
+			lock.unlock();
+
+			ID3DX11Effect* effect = nullptr;
+			Effect::CreateEffectFromMemory(mGame.Direct3DDevice(), &effect, compiledEffect);
+
+			return effect;
+		}
+
+		std::promise<void> parsed;
+		mPending[key] = parsed.get_future().share();
+		lock.unlock();
+
+		// The parsed effect is kept untouched and every caller receives a clone. A clone skips parsing the blob, shares
+		// the shader and state objects, and with D3DX11_EFFECT_CLONE_SHARE_TYPES points at the parsed effect's types
+		// and type names too. Effects11 still copies the variables, and the reflection names and annotations, into
+		// each clone, which is what lets clones hold their own variable values.
+		ID3DX11Effect* sharedEffect = nullptr;
+		ID3DX11Effect* clonedEffect = nullptr;
+		try
+		{
+			Effect::CreateEffectFromMemory(mGame.Direct3DDevice(), &sharedEffect, compiledEffect);
+			clonedEffect = CloneEffect(lock, sharedEffect);
+		}
+		catch (...)
+		{
+			ReleaseObject(sharedEffect);
+
+			// Waiting requests find neither entry and parse the blob themselves
+			lock.lock();
+			mPending.erase(key);
+			lock.unlock();
+			parsed.set_value();
+			throw;
+		}
+
+		lock.lock();
+		SharedEffect& sharedEntry = mEffects[key];
+		sharedEntry.CompiledEffect = compiledEffect;
+		sharedEntry.Effect = sharedEffect;
+		mPending.erase(key);
+		lock.unlock();
+
+		parsed.set_value();
+
+		return clonedEffect;
+	}
+
+	void SharedEffectCache::Evict(const std::vector<char>& compiledEffect)
+	{
+		if (compiledEffect.empty())
+		{
+			return;
+		}
+
+		UINT64 key = Utility::Fnv1aHash(&compiledEffect.front(), compiledEffect.size());
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto entry = mEffects.find(key);
+		if (entry == mEffects.end() || entry->second.CompiledEffect != compiledEffect)
+		{
+			return;
+		}
+
+		ReleaseObject(entry->second.Effect);
+		mEffects.erase(entry);
+
+		for (auto file = mFiles.begin(); file != mFiles.end();)
+		{
+			if (file->second.Key == key)
+			{
+				file = mFiles.erase(file);
+			}
+			else
+			{
+				++file;
+			}
+		}
+	}
+
+	UINT SharedEffectCache::Count() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		return static_cast<UINT>(mEffects.size());
+	}
+
+	void SharedEffectCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		for (std::pair<const UINT64, SharedEffect>& entry : mEffects)
+		{
+			ReleaseObject(entry.second.Effect);
+		}
+
+		mEffects.clear();
+		mFiles.clear();
+	}
+
+	ID3DX11Effect* SharedEffectCache::CloneEffect(std::unique_lock<std::mutex>& lock, ID3DX11Effect* effect)
+	{
+		// Held across the clone, which runs outside the lock, so an Evict() or Clear() meanwhile can't release it
+		effect->AddRef();
+		if (lock.owns_lock())
+		{
+			lock.unlock();
+		}
+
+		ID3DX11Effect* clonedEffect = nullptr;
+		HRESULT hr = effect->CloneEffect(D3DX11_EFFECT_CLONE_SHARE_TYPES, &clonedEffect);
+		effect->Release();
+		if (FAILED(hr))
+		{
+			throw GameException("ID3DX11Effect::CloneEffect() failed.", hr);
+		}
+
+		return clonedEffect;
+	}
+
+	UINT64 SharedEffectCache::LastWriteTime(const std::wstring& filename)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (GetFileAttributesEx(filename.c_str(), GetFileExInfoStandard, &attributes) == FALSE)
+		{
+			throw GameException("Could not open file.");
+		}
+
+		return (static_cast<UINT64>(attributes.ftLastWriteTime.dwHighDateTime) << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+	}
+}
\ No newline at end of file
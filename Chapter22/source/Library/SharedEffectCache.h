@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Common.h"
+#include <mutex>
+#include <future>
+
+namespace Library
+{
+	class Game;
+
+	class SharedEffectCache
+	{
+	public:
+		SharedEffectCache(Game& game);
+		~SharedEffectCache();
+
+		ID3DX11Effect* CreateEffect(const std::wstring& filename);
+		ID3DX11Effect* CreateEffect(const std::vector<char>& compiledEffect);
+
+		// Releases the parsed effect kept for the blob, e.g. once a reload has replaced it; clones already handed out
+		// are unaffected, as they hold their own references to the shaders
+		void Evict(const std::vector<char>& compiledEffect);
+
+		UINT Count() const;
+		void Clear();
+
+	private:
+		// The blob is kept so a hash match is confirmed byte for byte before the parsed effect is shared
+		typedef struct _SharedEffect
+		{
+			std::vector<char> CompiledEffect;
+			ID3DX11Effect* Effect;
+		} SharedEffect;
+
+		typedef struct _SharedEffectFile
+		{
+			UINT64 WriteTime;
+			UINT64 Key;
+		} SharedEffectFile;
+
+		SharedEffectCache();
+		SharedEffectCache(const SharedEffectCache& rhs);
+		SharedEffectCache& operator=(const SharedEffectCache& rhs);
+
+		ID3DX11Effect* CloneEffect(std::unique_lock<std::mutex>& lock, ID3DX11Effect* effect);
+		static UINT64 LastWriteTime(const std::wstring& filename);
+
+		Game& mGame;
+		std::map<UINT64, SharedEffect> mEffects;
+		std::map<std::wstring, SharedEffectFile> mFiles;
+		std::map<UINT64, std::shared_future<void>> mPending;
+		mutable std::mutex mMutex;
+	};
+}
\ No newline at end of file
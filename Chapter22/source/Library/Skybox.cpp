@@ -7,16 +7,20 @@
 #include "Model.h"
 #include "Mesh.h"
 #include "Utility.h"
-#include <DDSTextureLoader.h>
+#include "ContentManager.h"
+#include "DDSTexture.h"
+#include "ThreadPool.h"
 
 namespace Library
 {
 	RTTI_DEFINITIONS(Skybox)
 
+	const UINT Skybox::InitialMipSize = 128;
+
 	Skybox::Skybox(Game& game, Camera& camera, const std::wstring& cubeMapFileName, float scale)
 		: DrawableGameComponent(game, camera),
-		  mCubeMapFileName(cubeMapFileName), mEffect(nullptr), mMaterial(nullptr),
-		  mCubeMapShaderResourceView(nullptr), mVertexBuffer(nullptr), mIndexBuffer(nullptr), mIndexCount(0),
+		  mCubeMapFileName(cubeMapFileName), mEffect(), mMaterial(nullptr),
+		  mCubeMap(), mPrefetch(), mPrefetchMip(0), mVertexBuffer(nullptr), mIndexBuffer(nullptr), mIndexCount(0),
 		  mWorldMatrix(MatrixHelper::Identity), mScaleMatrix(MatrixHelper::Identity)
 	{
 		XMStoreFloat4x4(&mScaleMatrix, XMMatrixScaling(scale, scale, scale));
@@ -24,9 +28,12 @@ namespace Library
 
 	Skybox::~Skybox()
 	{
-		ReleaseObject(mCubeMapShaderResourceView);
+		if (mPrefetch.valid())
+		{
+			mPrefetch.wait();
+		}
+
 		DeleteObject(mMaterial);
-		DeleteObject(mEffect);
 		ReleaseObject(mVertexBuffer);
 		ReleaseObject(mIndexBuffer);
 	}
@@ -35,10 +42,9 @@ namespace Library
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
-		std::unique_ptr<Model> model(new Model(*mGame, "Content\\Models\\Sphere.obj", true));
+		std::shared_ptr<Model> model = mGame->Content().LoadModel("Content\\Models\\Sphere.obj", true);
 
-		mEffect = new Effect(*mGame);
-		mEffect->LoadCompiledEffect(L"Content\\Effects\\Skybox.cso");
+		mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\Skybox.cso");
 
 		mMaterial = new SkyboxMaterial();
 		mMaterial->Initialize(*mEffect);
@@ -48,15 +54,21 @@ namespace Library
 		mesh->CreateIndexBuffer(&mIndexBuffer);
 		mIndexCount = mesh->Indices().size();
 
-		HRESULT hr = DirectX::CreateDDSTextureFromFile(mGame->Direct3DDevice(), mCubeMapFileName.c_str(), nullptr, &mCubeMapShaderResourceView);
-		if (FAILED(hr))
-		{
-			throw GameException("CreateDDSTextureFromFile() failed.", hr);
-		}
+		// Startup only waits for the small mips; the rest are read from the mapped file by worker threads
+		mCubeMap = std::make_shared<DDSTexture>(*mGame, mCubeMapFileName);
+		mCubeMap->UploadMips(mCubeMap->MipForSize(InitialMipSize));
+		PrefetchNextMip();
 	}
 
 	void Skybox::Update(const GameTime& gameTime)
 	{
+		if (mPrefetch.valid() && mPrefetch.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			mPrefetch.get();
+			mCubeMap->UploadMips(mPrefetchMip);
+			PrefetchNextMip();
+		}
+
 		const XMFLOAT3& position = mCamera->Position();
 
 		XMStoreFloat4x4(&mWorldMatrix, XMLoadFloat4x4(&mScaleMatrix) * XMMatrixTranslation(position.x, position.y, position.z));
@@ -78,10 +90,27 @@ namespace Library
 
 		XMMATRIX wvp = XMLoadFloat4x4(&mWorldMatrix) * mCamera->ViewMatrix() * mCamera->ProjectionMatrix();		
 		mMaterial->WorldViewProjection() << wvp;
-		mMaterial->SkyboxTexture() << mCubeMapShaderResourceView;
+		mMaterial->SkyboxTexture() << mCubeMap->ShaderResourceView();
 		
 		pass->Apply(0, direct3DDeviceContext);
 
 		direct3DDeviceContext->DrawIndexed(mIndexCount, 0, 0);
 	}
+
+	void Skybox::PrefetchNextMip()
+	{
+		if (mCubeMap->IsResident())
+		{
+			return;
+		}
+
+		mPrefetchMip = mCubeMap->ResidentMip() - 1;
+
+		// The task holds its own reference, so the texture outlives a prefetch that's still running
+		std::shared_ptr<DDSTexture> cubeMap = mCubeMap;
+		UINT mip = mPrefetchMip;
+		std::shared_ptr<std::packaged_task<void()>> task = std::make_shared<std::packaged_task<void()>>([cubeMap, mip]() { cubeMap->PrefetchMips(mip, mip); });
+		mPrefetch = task->get_future();
+		mGame->WorkerThreads().Enqueue([task]() { (*task)(); });
+	}
 }
\ No newline at end of file
@@ -2,11 +2,13 @@
 
 #include "Common.h"
 #include "DrawableGameComponent.h"
+#include <future>
 
 namespace Library
 {
 	class Effect;
 	class SkyboxMaterial;
+	class DDSTexture;
 
 	class Skybox : public DrawableGameComponent
 	{
@@ -20,15 +22,22 @@ namespace Library
 		virtual void Update(const GameTime& gameTime) override;		
 		virtual void Draw(const GameTime& gameTime) override;
 
+		// Mips up to this size are loaded by Initialize(); larger ones stream in afterwards, one per update
+		static const UINT InitialMipSize;
+
 	private:
 		Skybox();
 		Skybox(const Skybox& rhs);
 		Skybox& operator=(const Skybox& rhs);
 
+		void PrefetchNextMip();
+
 		std::wstring mCubeMapFileName;
-		Effect* mEffect;
+		std::shared_ptr<Effect> mEffect;
 		SkyboxMaterial* mMaterial;
-		ID3D11ShaderResourceView* mCubeMapShaderResourceView;
+		std::shared_ptr<DDSTexture> mCubeMap;
+		std::future<void> mPrefetch;
+		UINT mPrefetchMip;
 		ID3D11Buffer* mVertexBuffer;
 		ID3D11Buffer* mIndexBuffer;
 		UINT mIndexCount;
@@ -0,0 +1,154 @@
+#include "SpriteFontFile.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace Library
+{
+	const char SpriteFontFile::Magic[] = "DXTKfont";
+	const char SpriteFontFile::DistanceFieldMagic[] = "DXTKsdf1";
+
+	namespace
+	{
+		class Reader
+		{
+		public:
+			Reader(const unsigned char* data, size_t size)
+				: mData(data), mSize(size), mPosition(0)
+			{
+			}
+
+			void Read(void* destination, size_t size)
+			{
+				if (size > mSize - mPosition)
+				{
+					throw std::runtime_error("The sprite font file is truncated.");
+				}
+
+				memcpy(destination, mData + mPosition, size);
+				mPosition += size;
+			}
+
+			unsigned int ReadUInt()
+			{
+				unsigned int value;
+				Read(&value, sizeof(value));
+
+				return value;
+			}
+
+			size_t Remaining() const
+			{
+				return mSize - mPosition;
+			}
+
+		private:
+			const unsigned char* mData;
+			size_t mSize;
+			size_t mPosition;
+		};
+
+		void Append(std::vector<unsigned char>& data, const void* source, size_t size)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(source);
+			data.insert(data.end(), bytes, bytes + size);
+		}
+
+		void AppendUInt(std::vector<unsigned char>& data, unsigned int value)
+		{
+			Append(data, &value, sizeof(value));
+		}
+	}
+
+	void SpriteFontFile::Read(const unsigned char* data, size_t size, SpriteFontData& font)
+	{
+		Reader reader(data, size);
+
+		char magic[sizeof(Magic) - 1];
+		reader.Read(magic, sizeof(magic));
+		if (memcmp(magic, Magic, sizeof(magic)) != 0)
+		{
+			throw std::runtime_error("Not a sprite font file.");
+		}
+
+		unsigned int glyphCount = reader.ReadUInt();
+		if (glyphCount > size / sizeof(Glyph))
+		{
+			throw std::runtime_error("The sprite font file is truncated.");
+		}
+
+		font.Glyphs.resize(glyphCount);
+		if (glyphCount > 0)
+		{
+			reader.Read(&font.Glyphs[0], sizeof(Glyph) * glyphCount);
+		}
+
+		reader.Read(&font.LineSpacing, sizeof(font.LineSpacing));
+		font.DefaultCharacter = reader.ReadUInt();
+		font.TextureWidth = reader.ReadUInt();
+		font.TextureHeight = reader.ReadUInt();
+		font.TextureFormat = reader.ReadUInt();
+		font.TextureStride = reader.ReadUInt();
+		font.TextureRows = reader.ReadUInt();
+
+		unsigned long long textureSize = static_cast<unsigned long long>(font.TextureStride) * font.TextureRows;
+		if (textureSize > size)
+		{
+			throw std::runtime_error("The sprite font file is truncated.");
+		}
+
+		font.TextureData.resize(static_cast<size_t>(textureSize));
+		if (textureSize > 0)
+		{
+			reader.Read(&font.TextureData[0], static_cast<size_t>(textureSize));
+		}
+
+		font.DistanceFieldSize = 0.0f;
+		font.DistanceFieldSpread = 0.0f;
+
+		char trailer[sizeof(DistanceFieldMagic) - 1];
+		if (reader.Remaining() >= sizeof(trailer) + 2 * sizeof(float))
+		{
+			reader.Read(trailer, sizeof(trailer));
+			if (memcmp(trailer, DistanceFieldMagic, sizeof(trailer)) == 0)
+			{
+				reader.Read(&font.DistanceFieldSize, sizeof(font.DistanceFieldSize));
+				reader.Read(&font.DistanceFieldSpread, sizeof(font.DistanceFieldSpread));
+			}
+		}
+	}
+
+	void SpriteFontFile::Write(const SpriteFontData& font, std::vector<unsigned char>& data)
+	{
+		if (font.TextureData.size() != static_cast<size_t>(font.TextureStride) * font.TextureRows)
+		{
+			throw std::runtime_error("The sprite font's texture data doesn't match its stride and rows.");
+		}
+
+		data.clear();
+		Append(data, Magic, sizeof(Magic) - 1);
+		AppendUInt(data, static_cast<unsigned int>(font.Glyphs.size()));
+		if (font.Glyphs.empty() == false)
+		{
+			Append(data, &font.Glyphs[0], sizeof(Glyph) * font.Glyphs.size());
+		}
+
+		Append(data, &font.LineSpacing, sizeof(font.LineSpacing));
+		AppendUInt(data, font.DefaultCharacter);
+		AppendUInt(data, font.TextureWidth);
+		AppendUInt(data, font.TextureHeight);
+		AppendUInt(data, font.TextureFormat);
+		AppendUInt(data, font.TextureStride);
+		AppendUInt(data, font.TextureRows);
+		if (font.TextureData.empty() == false)
+		{
+			Append(data, &font.TextureData[0], font.TextureData.size());
+		}
+
+		if (font.DistanceFieldSize > 0.0f)
+		{
+			Append(data, DistanceFieldMagic, sizeof(DistanceFieldMagic) - 1);
+			Append(data, &font.DistanceFieldSize, sizeof(font.DistanceFieldSize));
+			Append(data, &font.DistanceFieldSpread, sizeof(font.DistanceFieldSpread));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+// Portable, like DDSFile: the texture format is a DXGI_FORMAT value, so the file can be read without Direct3D headers
+#include <cstddef>
+#include <vector>
+#include "GlyphTable.h"
+
+namespace Library
+{
+	// TextureData holds TextureRows rows of TextureStride bytes; for block-compressed formats a row is a row of blocks.
+	// DistanceFieldSize and DistanceFieldSpread are 0 for coverage fonts; see DistanceFieldFont.
+	typedef struct _SpriteFontData
+	{
+		std::vector<Glyph> Glyphs;
+		float LineSpacing;
+		unsigned int DefaultCharacter;
+		unsigned int TextureWidth;
+		unsigned int TextureHeight;
+		unsigned int TextureFormat;
+		unsigned int TextureStride;
+		unsigned int TextureRows;
+		std::vector<unsigned char> TextureData;
+		float DistanceFieldSize;
+		float DistanceFieldSpread;
+	} SpriteFontData;
+
+	// Reads the .spritefont files MakeSpriteFont writes, and writes FontTool's. A distance field font appends a trailer
+	// after the texture, which DirectXTK's SpriteFont doesn't read, so the files stay loadable by it.
+	class SpriteFontFile
+	{
+	public:
+		// Throws std::runtime_error for anything that isn't a complete .spritefont file
+		static void Read(const unsigned char* data, size_t size, SpriteFontData& font);
+		static void Write(const SpriteFontData& font, std::vector<unsigned char>& data);
+
+		static const char Magic[];
+		static const char DistanceFieldMagic[];
+
+	private:
+		SpriteFontFile();
+		SpriteFontFile(const SpriteFontFile& rhs);
+		SpriteFontFile& operator=(const SpriteFontFile& rhs);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "SpriteMaterial.h"
+#include "GameException.h"
+#include "SpriteQueue.h"
+
+namespace Library
+{
+	RTTI_DEFINITIONS(SpriteMaterial)
+
+	SpriteMaterial::SpriteMaterial()
+		: Material("sprite"),
+		  MATERIAL_VARIABLE_INITIALIZATION(Transform), MATERIAL_VARIABLE_INITIALIZATION(SpriteTexture)
+	{
+	}
+
+	MATERIAL_VARIABLE_DEFINITION(SpriteMaterial, Transform)
+	MATERIAL_VARIABLE_DEFINITION(SpriteMaterial, SpriteTexture)
+
+	void SpriteMaterial::Initialize(Effect& effect)
+	{
+		Material::Initialize(effect);
+
+		MATERIAL_VARIABLE_RETRIEVE(Transform)
+		MATERIAL_VARIABLE_RETRIEVE(SpriteTexture)
+
+		// Matches SpriteVertex: position, RGBA8 color and texture coordinates
+		D3D11_INPUT_ELEMENT_DESC inputElementDescriptions[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+		};
+
+		CreateInputLayout("sprite", "p0", inputElementDescriptions, ARRAYSIZE(inputElementDescriptions));
+		CreateInputLayout("distance_field", "p0", inputElementDescriptions, ARRAYSIZE(inputElementDescriptions));
+	}
+
+	void SpriteMaterial::CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
+	{
+		throw GameException("SpriteMaterial has no mesh vertex buffers.");
+	}
+
+	UINT SpriteMaterial::VertexSize() const
+	{
+		return sizeof(SpriteVertex);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Common.h"
+#include "Material.h"
+
+namespace Library
+{
+	// Sprite vertices are written every frame by SpriteRenderer, straight into a dynamic buffer, so there are no
+	// mesh vertex buffers to create
+	class SpriteMaterial : public Material
+	{
+		RTTI_DECLARATIONS(SpriteMaterial, Material)
+
+		MATERIAL_VARIABLE_DECLARATION(Transform)
+		MATERIAL_VARIABLE_DECLARATION(SpriteTexture)
+
+	public:
+		SpriteMaterial();
+
+		virtual void Initialize(Effect& effect) override;
+		virtual void CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const override;
+		virtual UINT VertexSize() const override;
+	};
+}
\ No newline at end of file
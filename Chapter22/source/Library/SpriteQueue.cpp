@@ -0,0 +1,298 @@
+#include "SpriteQueue.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+namespace Library
+{
+	const unsigned int SpriteQueue::MaximumBatchSize = 65536;
+
+	namespace
+	{
+		const size_t Alignment = 16;
+
+		size_t AlignedSize(size_t size)
+		{
+			return (size + Alignment - 1) & ~(Alignment - 1);
+		}
+
+		// Maps a float's bits to an unsigned integer with the same ordering, negative values included
+		unsigned int OrderedDepth(float depth)
+		{
+			unsigned int bits;
+			memcpy(&bits, &depth, sizeof(bits));
+
+			return ((bits & 0x80000000) != 0 ? ~bits : bits | 0x80000000);
+		}
+	}
+
+	SpriteQueue::SpriteQueue()
+		: mSprites(nullptr), mKeys(nullptr), mKeyScratch(nullptr), mOrder(nullptr), mOrderScratch(nullptr), mSortedOrder(nullptr),
+		  mCount(0), mCapacity(0), mSortMode(SpriteSortModeDeferred), mBatches()
+	{
+	}
+
+	size_t SpriteQueue::MemorySize(unsigned int capacity)
+	{
+		return AlignedSize(sizeof(Sprite) * capacity) + AlignedSize(sizeof(unsigned long long) * capacity) * 2 + AlignedSize(sizeof(unsigned int) * capacity) * 2;
+	}
+
+	void SpriteQueue::Reset(void* memory, unsigned int capacity, SpriteSortMode sortMode)
+	{
+		assert(sortMode < SpriteSortModeEnd);
+
+		Assign(memory, capacity);
+		mCount = 0;
+		mSortMode = sortMode;
+		mSortedOrder = nullptr;
+		mBatches.clear();
+	}
+
+	void SpriteQueue::Grow(void* memory, unsigned int capacity)
+	{
+		assert(capacity >= mCount);
+
+		Sprite* sprites = mSprites;
+		Assign(memory, capacity);
+		if (mCount > 0)
+		{
+			memcpy(mSprites, sprites, sizeof(Sprite) * mCount);
+		}
+
+		mSortedOrder = nullptr;
+	}
+
+	bool SpriteQueue::Push(const Sprite& sprite)
+	{
+		if (mCount == mCapacity)
+		{
+			return false;
+		}
+
+		mSprites[mCount++] = sprite;
+
+		return true;
+	}
+
+	unsigned int SpriteQueue::Count() const
+	{
+		return mCount;
+	}
+
+	unsigned int SpriteQueue::Capacity() const
+	{
+		return mCapacity;
+	}
+
+	SpriteSortMode SpriteQueue::SortMode() const
+	{
+		return mSortMode;
+	}
+
+	void SpriteQueue::Sort(unsigned int maximumBatchSize)
+	{
+		assert(maximumBatchSize > 0);
+
+		for (unsigned int i = 0; i < mCount; i++)
+		{
+			const Sprite& sprite = mSprites[i];
+			unsigned long long key = 0;
+			switch (mSortMode)
+			{
+				case SpriteSortModeTexture:
+					key = sprite.Texture;
+					break;
+
+				case SpriteSortModeBackToFront:
+					key = (static_cast<unsigned long long>(~OrderedDepth(sprite.Depth)) << 32) | sprite.Texture;
+					break;
+
+				case SpriteSortModeFrontToBack:
+					key = (static_cast<unsigned long long>(OrderedDepth(sprite.Depth)) << 32) | sprite.Texture;
+					break;
+
+				default:
+					break;
+			}
+
+			mKeys[i] = key;
+			mOrder[i] = i;
+		}
+
+		mSortedOrder = mOrder;
+		if (mSortMode != SpriteSortModeDeferred && RadixSort(mKeys, mOrder, mKeyScratch, mOrderScratch, mCount))
+		{
+			mSortedOrder = mOrderScratch;
+		}
+
+		mBatches.clear();
+		for (unsigned int i = 0; i < mCount; i++)
+		{
+			unsigned int texture = mSprites[mSortedOrder[i]].Texture;
+			if (mBatches.empty() || mBatches.back().Texture != texture || mBatches.back().Count == maximumBatchSize)
+			{
+				SpriteBatchRange batch = { texture, i, 0 };
+				mBatches.push_back(batch);
+			}
+
+			mBatches.back().Count++;
+		}
+	}
+
+	const std::vector<SpriteBatchRange>& SpriteQueue::Batches() const
+	{
+		return mBatches;
+	}
+
+	void SpriteQueue::GenerateVertices(unsigned int first, unsigned int count, SpriteVertex* vertices) const
+	{
+		assert(mSortedOrder != nullptr && first + count <= mCount);
+
+		const unsigned int PrefetchDistance = 8;
+		const __m128 cornerX = _mm_setr_ps(0.0f, 1.0f, 0.0f, 1.0f);
+		const __m128 cornerY = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+		float* output = reinterpret_cast<float*>(vertices);
+
+		for (unsigned int i = first; i < first + count; i++)
+		{
+			// Sorted sprites are scattered through the queue, so fetch ahead
+			if (i + PrefetchDistance < mCount)
+			{
+				_mm_prefetch(reinterpret_cast<const char*>(&mSprites[mSortedOrder[i + PrefetchDistance]]), _MM_HINT_T0);
+			}
+
+			const Sprite& sprite = mSprites[mSortedOrder[i]];
+			__m128 destination = _mm_loadu_ps(sprite.Destination);
+			__m128 source = _mm_loadu_ps(sprite.Source);
+
+			// Corner offsets from the origin, one corner a lane
+			__m128 offsetX = _mm_mul_ps(_mm_sub_ps(cornerX, _mm_set1_ps(sprite.Origin[0])), _mm_shuffle_ps(destination, destination, _MM_SHUFFLE(2, 2, 2, 2)));
+			__m128 offsetY = _mm_mul_ps(_mm_sub_ps(cornerY, _mm_set1_ps(sprite.Origin[1])), _mm_shuffle_ps(destination, destination, _MM_SHUFFLE(3, 3, 3, 3)));
+
+			__m128 x;
+			__m128 y;
+			if (sprite.Rotation != 0.0f)
+			{
+				__m128 cosine = _mm_set1_ps(cosf(sprite.Rotation));
+				__m128 sine = _mm_set1_ps(sinf(sprite.Rotation));
+				x = _mm_sub_ps(_mm_mul_ps(offsetX, cosine), _mm_mul_ps(offsetY, sine));
+				y = _mm_add_ps(_mm_mul_ps(offsetX, sine), _mm_mul_ps(offsetY, cosine));
+			}
+			else
+			{
+				x = offsetX;
+				y = offsetY;
+			}
+
+			x = _mm_add_ps(x, _mm_shuffle_ps(destination, destination, _MM_SHUFFLE(0, 0, 0, 0)));
+			y = _mm_add_ps(y, _mm_shuffle_ps(destination, destination, _MM_SHUFFLE(1, 1, 1, 1)));
+
+			__m128 left = _mm_shuffle_ps(source, source, _MM_SHUFFLE(0, 0, 0, 0));
+			__m128 top = _mm_shuffle_ps(source, source, _MM_SHUFFLE(1, 1, 1, 1));
+			__m128 right = _mm_shuffle_ps(source, source, _MM_SHUFFLE(2, 2, 2, 2));
+			__m128 bottom = _mm_shuffle_ps(source, source, _MM_SHUFFLE(3, 3, 3, 3));
+			__m128 u = _mm_add_ps(left, _mm_mul_ps(_mm_sub_ps(right, left), cornerX));
+			__m128 v = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), cornerY));
+
+			// Transposed to one vertex a register: x, y, depth and the color's bits, then the texture coordinates
+			__m128 z = _mm_set1_ps(sprite.Depth);
+			__m128 color = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(sprite.Color)));
+			_MM_TRANSPOSE4_PS(x, y, z, color);
+			__m128 uv01 = _mm_unpacklo_ps(u, v);
+			__m128 uv23 = _mm_unpackhi_ps(u, v);
+
+			_mm_storeu_ps(output, x);
+			_mm_storel_pi(reinterpret_cast<__m64*>(output + 4), uv01);
+			_mm_storeu_ps(output + 6, y);
+			_mm_storeh_pi(reinterpret_cast<__m64*>(output + 10), uv01);
+			_mm_storeu_ps(output + 12, z);
+			_mm_storel_pi(reinterpret_cast<__m64*>(output + 16), uv23);
+			_mm_storeu_ps(output + 18, color);
+			_mm_storeh_pi(reinterpret_cast<__m64*>(output + 22), uv23);
+			output += 24;
+		}
+	}
+
+	void SpriteQueue::QuadIndices(unsigned int spriteCount, std::vector<unsigned int>& indices)
+	{
+		indices.resize(static_cast<size_t>(spriteCount) * 6);
+		for (unsigned int i = 0; i < spriteCount; i++)
+		{
+			unsigned int vertex = i * 4;
+			unsigned int* quad = &indices[static_cast<size_t>(i) * 6];
+			quad[0] = vertex;
+			quad[1] = vertex + 1;
+			quad[2] = vertex + 2;
+			quad[3] = vertex + 1;
+			quad[4] = vertex + 3;
+			quad[5] = vertex + 2;
+		}
+	}
+
+	bool SpriteQueue::RadixSort(unsigned long long* keys, unsigned int* values, unsigned long long* keyScratch, unsigned int* valueScratch, unsigned int count)
+	{
+		// Every byte's histogram in one read of the keys
+		unsigned int histograms[8][256];
+		memset(histograms, 0, sizeof(histograms));
+		for (unsigned int i = 0; i < count; i++)
+		{
+			unsigned long long key = keys[i];
+			for (unsigned int pass = 0; pass < 8; pass++)
+			{
+				histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+			}
+		}
+
+		bool isInScratch = false;
+		for (unsigned int pass = 0; pass < 8; pass++)
+		{
+			unsigned int* histogram = histograms[pass];
+			unsigned int shift = pass * 8;
+			if (count == 0 || histogram[(keys[0] >> shift) & 0xFF] == count)
+			{
+				continue;
+			}
+
+			unsigned int offset = 0;
+			for (unsigned int bucket = 0; bucket < 256; bucket++)
+			{
+				unsigned int bucketCount = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += bucketCount;
+			}
+
+			for (unsigned int i = 0; i < count; i++)
+			{
+				unsigned int destination = histogram[(keys[i] >> shift) & 0xFF]++;
+				keyScratch[destination] = keys[i];
+				valueScratch[destination] = values[i];
+			}
+
+			std::swap(keys, keyScratch);
+			std::swap(values, valueScratch);
+			isInScratch = !isInScratch;
+		}
+
+		return isInScratch;
+	}
+
+	void SpriteQueue::Assign(void* memory, unsigned int capacity)
+	{
+		assert((reinterpret_cast<size_t>(memory) & (Alignment - 1)) == 0);
+
+		unsigned char* bytes = static_cast<unsigned char*>(memory);
+		mSprites = reinterpret_cast<Sprite*>(bytes);
+		bytes += AlignedSize(sizeof(Sprite) * capacity);
+		mKeys = reinterpret_cast<unsigned long long*>(bytes);
+		bytes += AlignedSize(sizeof(unsigned long long) * capacity);
+		mKeyScratch = reinterpret_cast<unsigned long long*>(bytes);
+		bytes += AlignedSize(sizeof(unsigned long long) * capacity);
+		mOrder = reinterpret_cast<unsigned int*>(bytes);
+		bytes += AlignedSize(sizeof(unsigned int) * capacity);
+		mOrderScratch = reinterpret_cast<unsigned int*>(bytes);
+		mCapacity = capacity;
+	}
+}
\ No newline at end of file
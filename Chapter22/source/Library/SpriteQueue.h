@@ -0,0 +1,104 @@
+#pragma once
+
+// Portable, like OcclusionBuffer: sorting and vertex generation run without a device, so they can be benchmarked anywhere
+#include <cstddef>
+#include <vector>
+
+namespace Library
+{
+	enum SpriteSortMode
+	{
+		SpriteSortModeDeferred = 0,
+		SpriteSortModeTexture,
+		SpriteSortModeBackToFront,
+		SpriteSortModeFrontToBack,
+		SpriteSortModeEnd
+	};
+
+	// Destination is x, y, width and height in pixels; Source is the left, top, right and bottom texture coordinates.
+	// Origin is the point placed at x, y and rotated about, as a fraction of the size. Color is RGBA8, red in the low byte.
+	typedef struct _Sprite
+	{
+		float Destination[4];
+		float Source[4];
+		float Origin[2];
+		float Rotation;
+		float Depth;
+		unsigned int Color;
+		unsigned int Texture;
+	} Sprite;
+
+	typedef struct _SpriteVertex
+	{
+		float Position[3];
+		unsigned int Color;
+		float TextureCoordinates[2];
+	} SpriteVertex;
+
+	// Sprites First to First + Count - 1 of the sorted queue, all with one texture
+	typedef struct _SpriteBatchRange
+	{
+		unsigned int Texture;
+		unsigned int First;
+		unsigned int Count;
+	} SpriteBatchRange;
+
+	// Queues sprites in memory the caller provides, typically from the frame arena, so a frame of sprites never
+	// reallocates. Sort() orders them with a stable LSD radix sort over 64-bit keys: the texture alone, or the depth
+	// with the texture below it, so equal depths still batch. Radix passes over bytes every key shares are skipped.
+	// GenerateVertices() then writes four vertices a sprite, the corners computed together in SSE registers, in the
+	// order TL, TR, BL, BR that QuadIndices() expects.
+	class SpriteQueue
+	{
+	public:
+		SpriteQueue();
+
+		// Bytes Reset() needs for capacity sprites
+		static size_t MemorySize(unsigned int capacity);
+
+		// memory must be 16-byte aligned and hold MemorySize(capacity) bytes until the queue is reset again
+		void Reset(void* memory, unsigned int capacity, SpriteSortMode sortMode);
+
+		// Moves the queued sprites to a larger block
+		void Grow(void* memory, unsigned int capacity);
+
+		// Returns false, queuing nothing, when the queue is full
+		bool Push(const Sprite& sprite);
+
+		unsigned int Count() const;
+		unsigned int Capacity() const;
+		SpriteSortMode SortMode() const;
+
+		// Orders the sprites and splits them into batches of one texture, none larger than maximumBatchSize
+		void Sort(unsigned int maximumBatchSize = MaximumBatchSize);
+		const std::vector<SpriteBatchRange>& Batches() const;
+
+		// Vertices for sorted sprites [first, first + count)
+		void GenerateVertices(unsigned int first, unsigned int count, SpriteVertex* vertices) const;
+
+		// Six 32-bit indices a sprite, two triangles over its corners
+		static void QuadIndices(unsigned int spriteCount, std::vector<unsigned int>& indices);
+
+		// Sorts values by key, stable; scratch buffers hold count of each. Returns true if the result is in the scratch buffers.
+		static bool RadixSort(unsigned long long* keys, unsigned int* values, unsigned long long* keyScratch, unsigned int* valueScratch, unsigned int count);
+
+		static const unsigned int MaximumBatchSize;
+
+	private:
+		SpriteQueue(const SpriteQueue& rhs);
+		SpriteQueue& operator=(const SpriteQueue& rhs);
+
+		void Assign(void* memory, unsigned int capacity);
+
+		Sprite* mSprites;
+		unsigned long long* mKeys;
+		unsigned long long* mKeyScratch;
+		unsigned int* mOrder;
+		unsigned int* mOrderScratch;
+		const unsigned int* mSortedOrder;
+		unsigned int mCount;
+		unsigned int mCapacity;
+		SpriteSortMode mSortMode;
+		std::vector<SpriteBatchRange> mBatches;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "SpriteRenderer.h"
+#include "Game.h"
+#include "GameException.h"
+#include "ContentManager.h"
+#include "FrameAllocator.h"
+#include "SpriteMaterial.h"
+#include "TextFont.h"
+#include "Technique.h"
+#include "Pass.h"
+#include <stdexcept>
+
+namespace Library
+{
+	const UINT SpriteRenderer::DefaultCapacity = 4096;
+
+	SpriteRenderer::SpriteRenderer(Game& game, UINT initialCapacity)
+		: mGame(&game), mEffect(), mMaterial(nullptr), mPass(nullptr), mDistanceFieldPass(nullptr), mVertexBuffer(nullptr), mIndexBuffer(nullptr), mVertexPosition(0), mBatchSize(0),
+		  mQueue(), mCapacity(max(initialCapacity, 1U)), mTextures(), mTexturePasses(), mTextureIndices(), mLayouts(), mTransform(), mIsDrawing(false)
+	{
+		mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\Sprite.cso");
+		mMaterial = new SpriteMaterial();
+		mMaterial->Initialize(*mEffect);
+		mPass = mMaterial->CurrentTechnique()->Passes().at(0);
+		mDistanceFieldPass = mEffect->TechniquesByName().at("distance_field")->PassesByName().at("p0");
+		mBatchSize = min(mCapacity, SpriteQueue::MaximumBatchSize);
+
+		D3D11_BUFFER_DESC vertexBufferDesc;
+		ZeroMemory(&vertexBufferDesc, sizeof(vertexBufferDesc));
+		vertexBufferDesc.ByteWidth = sizeof(SpriteVertex) * mBatchSize * 4;
+		vertexBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		vertexBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+		HRESULT hr;
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateBuffer(&vertexBufferDesc, nullptr, &mVertexBuffer)))
+		{
+			throw GameException("ID3D11Device::CreateBuffer() failed.", hr);
+		}
+
+		// Every batch draws from the start of one shared index buffer, offset by its base vertex
+		std::vector<UINT> indices;
+		SpriteQueue::QuadIndices(mBatchSize, indices);
+
+		D3D11_BUFFER_DESC indexBufferDesc;
+		ZeroMemory(&indexBufferDesc, sizeof(indexBufferDesc));
+		indexBufferDesc.ByteWidth = sizeof(UINT) * indices.size();
+		indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+
+		D3D11_SUBRESOURCE_DATA indexSubResourceData;
+		ZeroMemory(&indexSubResourceData, sizeof(indexSubResourceData));
+		indexSubResourceData.pSysMem = &indices[0];
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateBuffer(&indexBufferDesc, &indexSubResourceData, &mIndexBuffer)))
+		{
+			ReleaseObject(mVertexBuffer);
+			throw GameException("ID3D11Device::CreateBuffer() failed.", hr);
+		}
+	}
+
+	SpriteRenderer::~SpriteRenderer()
+	{
+		ReleaseObject(mIndexBuffer);
+		ReleaseObject(mVertexBuffer);
+		DeleteObject(mMaterial);
+	}
+
+	void SpriteRenderer::Begin(SpriteSortMode sortMode, CXMMATRIX transform)
+	{
+		if (mIsDrawing)
+		{
+			throw GameException("SpriteRenderer::Begin() called twice without End().");
+		}
+
+		void* memory = mGame->FrameMemory().Allocate(SpriteQueue::MemorySize(mCapacity), 16);
+		mQueue.Reset(memory, mCapacity, sortMode);
+		mTextures.clear();
+		mTexturePasses.clear();
+		mTextureIndices.clear();
+
+		// Pixels of the bound viewport, y down, to clip space
+		UINT viewportCount = 1;
+		D3D11_VIEWPORT viewport;
+		mGame->Direct3DDeviceContext()->RSGetViewports(&viewportCount, &viewport);
+		if (viewportCount == 0)
+		{
+			throw GameException("SpriteRenderer::Begin() needs a bound viewport.");
+		}
+
+		XMMATRIX projection = XMMatrixOrthographicOffCenterLH(0.0f, viewport.Width, viewport.Height, 0.0f, 0.0f, 1.0f);
+		XMStoreFloat4x4(&mTransform, transform * projection);
+		mIsDrawing = true;
+	}
+
+	void SpriteRenderer::Draw(ID3D11ShaderResourceView* texture, const XMFLOAT4& destination, FXMVECTOR color)
+	{
+		Draw(texture, destination, XMFLOAT4(0.0f, 0.0f, 1.0f, 1.0f), color);
+	}
+
+	void SpriteRenderer::Draw(ID3D11ShaderResourceView* texture, const XMFLOAT4& destination, const XMFLOAT4& source, FXMVECTOR color, float rotation, const XMFLOAT2& origin, float depth)
+	{
+		assert(mIsDrawing && texture != nullptr);
+
+		Sprite sprite;
+		memcpy(sprite.Destination, &destination, sizeof(sprite.Destination));
+		memcpy(sprite.Source, &source, sizeof(sprite.Source));
+		sprite.Origin[0] = origin.x;
+		sprite.Origin[1] = origin.y;
+		sprite.Rotation = rotation;
+		sprite.Depth = depth;
+
+		PackedVector::XMUBYTEN4 packedColor;
+		PackedVector::XMStoreUByteN4(&packedColor, color);
+		sprite.Color = packedColor.v;
+		sprite.Texture = TextureIndex(texture, mPass);
+		Push(sprite);
+	}
+
+	void SpriteRenderer::DrawString(const TextFont& font, const wchar_t* text, const XMFLOAT2& position, FXMVECTOR color, float scale, float depth)
+	{
+		const TextRun* run;
+		try
+		{
+			run = &mLayouts.Find(font.Glyphs(), text, scale);
+		}
+		catch (std::runtime_error& ex)
+		{
+			const char* message = ex.what();
+			throw GameException(message);
+		}
+
+		DrawString(font, *run, position, color, depth);
+	}
+
+	void SpriteRenderer::DrawString(const TextFont& font, const TextRun& run, const XMFLOAT2& position, FXMVECTOR color, float depth)
+	{
+		assert(mIsDrawing);
+
+		PackedVector::XMUBYTEN4 packedColor;
+		PackedVector::XMStoreUByteN4(&packedColor, color);
+		UINT texture = TextureIndex(font.Texture(), (font.IsDistanceField() ? mDistanceFieldPass : mPass));
+
+		for (const Sprite& glyph : run.Glyphs)
+		{
+			Sprite sprite = glyph;
+			sprite.Destination[0] += position.x;
+			sprite.Destination[1] += position.y;
+			sprite.Depth = depth;
+			sprite.Color = packedColor.v;
+			sprite.Texture = texture;
+			Push(sprite);
+		}
+	}
+
+	void SpriteRenderer::End()
+	{
+		if (mIsDrawing == false)
+		{
+			throw GameException("SpriteRenderer::End() called without Begin().");
+		}
+
+		mIsDrawing = false;
+		if (mQueue.Count() == 0)
+		{
+			return;
+		}
+
+		mQueue.Sort(mBatchSize);
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		direct3DDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		direct3DDeviceContext->IASetInputLayout(mMaterial->InputLayouts().at(mPass));
+
+		UINT stride = sizeof(SpriteVertex);
+		UINT offset = 0;
+		direct3DDeviceContext->IASetVertexBuffers(0, 1, &mVertexBuffer, &stride, &offset);
+		direct3DDeviceContext->IASetIndexBuffer(mIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+		mMaterial->Transform() << XMLoadFloat4x4(&mTransform);
+
+		const std::vector<SpriteBatchRange>& batches = mQueue.Batches();
+		UINT ringSize = mBatchSize * 4;
+		for (UINT firstBatch = 0; firstBatch < batches.size();)
+		{
+			// Discard only when the ring is full; otherwise append behind the vertices the GPU may still be reading
+			D3D11_MAP mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+			if (mVertexPosition + batches[firstBatch].Count * 4 > ringSize)
+			{
+				mapType = D3D11_MAP_WRITE_DISCARD;
+				mVertexPosition = 0;
+			}
+
+			// As many consecutive batches as fit, sorted sprites being contiguous, in one map
+			UINT lastBatch = firstBatch;
+			UINT spriteCount = batches[firstBatch].Count;
+			while (lastBatch + 1 < batches.size() && mVertexPosition + (spriteCount + batches[lastBatch + 1].Count) * 4 <= ringSize)
+			{
+				lastBatch++;
+				spriteCount += batches[lastBatch].Count;
+			}
+
+			D3D11_MAPPED_SUBRESOURCE mappedResource;
+			HRESULT hr;
+			if (FAILED(hr = direct3DDeviceContext->Map(mVertexBuffer, 0, mapType, 0, &mappedResource)))
+			{
+				throw GameException("ID3D11DeviceContext::Map() failed.", hr);
+			}
+
+			UINT firstSprite = batches[firstBatch].First;
+			mQueue.GenerateVertices(firstSprite, spriteCount, static_cast<SpriteVertex*>(mappedResource.pData) + mVertexPosition);
+			direct3DDeviceContext->Unmap(mVertexBuffer, 0);
+
+			for (UINT i = firstBatch; i <= lastBatch; i++)
+			{
+				const SpriteBatchRange& batch = batches[i];
+				mMaterial->SpriteTexture() << mTextures[batch.Texture];
+				mTexturePasses[batch.Texture]->Apply(0, direct3DDeviceContext);
+				direct3DDeviceContext->DrawIndexed(batch.Count * 6, 0, mVertexPosition + (batch.First - firstSprite) * 4);
+			}
+
+			mVertexPosition += spriteCount * 4;
+			firstBatch = lastBatch + 1;
+		}
+	}
+
+	UINT SpriteRenderer::Capacity() const
+	{
+		return mCapacity;
+	}
+
+	TextLayoutCache& SpriteRenderer::Layouts()
+	{
+		return mLayouts;
+	}
+
+	// A texture is drawn by one pass, so batches, which never span textures, don't span passes either
+	UINT SpriteRenderer::TextureIndex(ID3D11ShaderResourceView* texture, Pass* pass)
+	{
+		if (mTextures.empty() == false && mTextures.back() == texture)
+		{
+			return static_cast<UINT>(mTextures.size() - 1);
+		}
+
+		auto it = mTextureIndices.find(texture);
+		if (it != mTextureIndices.end())
+		{
+			return it->second;
+		}
+
+		UINT index = static_cast<UINT>(mTextures.size());
+		mTextures.push_back(texture);
+		mTexturePasses.push_back(pass);
+		mTextureIndices[texture] = index;
+
+		return index;
+	}
+
+	void SpriteRenderer::Push(const Sprite& sprite)
+	{
+		// A busier frame than any before it; the next Begin() starts at the larger size
+		if (mQueue.Push(sprite) == false)
+		{
+			mCapacity = mQueue.Capacity() * 2;
+			mQueue.Grow(mGame->FrameMemory().Allocate(SpriteQueue::MemorySize(mCapacity), 16), mCapacity);
+			mQueue.Push(sprite);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Common.h"
+#include "SpriteQueue.h"
+#include "TextLayout.h"
+#include "ColorHelper.h"
+
+namespace Library
+{
+	class Game;
+	class Effect;
+	class Pass;
+	class SpriteMaterial;
+	class TextFont;
+
+	// A SpriteBatch for large sprite counts: overlays, particles and HUDs of 100,000 sprites and more. Each Begin()
+	// takes its queue from the game's frame arena, sized by the busiest frame so far, and End() sorts it with
+	// SpriteQueue's radix sort. Vertices are generated straight into a ring of dynamic vertex buffer space, mapped
+	// with no-overwrite until it wraps, and drawn with 32-bit indices. The ring holds initialCapacity sprites, up to
+	// SpriteQueue::MaximumBatchSize, and that bounds the batches too, so a renderer for a few labels stays small.
+	//
+	// DrawString() lays strings out through a TextLayoutCache, so a label that doesn't change costs a hash and a copy of
+	// its glyph quads a frame; a TextRun the caller keeps, as TextComponent does, skips the cache as well. Distance
+	// field fonts from FontTool draw with sprite.fx's distance_field technique, and scale up without blurring.
+	//
+	// Destinations are in pixels of the bound viewport and sprite.fx sets its own blend (premultiplied alpha),
+	// rasterizer and depth states, so save and restore them around it as with SpriteBatch.
+	class SpriteRenderer
+	{
+	public:
+		SpriteRenderer(Game& game, UINT initialCapacity = DefaultCapacity);
+		~SpriteRenderer();
+
+		void Begin(SpriteSortMode sortMode = SpriteSortModeDeferred, CXMMATRIX transform = XMMatrixIdentity());
+
+		// destination is x, y, width and height; source is left, top, right and bottom texture coordinates, and origin
+		// the fraction of the size placed at x, y
+		void Draw(ID3D11ShaderResourceView* texture, const XMFLOAT4& destination, FXMVECTOR color = ColorHelper::White);
+		void Draw(ID3D11ShaderResourceView* texture, const XMFLOAT4& destination, const XMFLOAT4& source, FXMVECTOR color,
+			float rotation = 0.0f, const XMFLOAT2& origin = XMFLOAT2(0.0f, 0.0f), float depth = 0.0f);
+
+		// position is the text's top left in pixels
+		void DrawString(const TextFont& font, const wchar_t* text, const XMFLOAT2& position, FXMVECTOR color = ColorHelper::White, float scale = 1.0f, float depth = 0.0f);
+		void DrawString(const TextFont& font, const TextRun& run, const XMFLOAT2& position, FXMVECTOR color = ColorHelper::White, float depth = 0.0f);
+
+		void End();
+
+		// Sprites a Begin() makes room for before it has to grow the queue
+		UINT Capacity() const;
+
+		// Layouts DrawString() has cached; Clear() it when a font is released
+		TextLayoutCache& Layouts();
+
+		static const UINT DefaultCapacity;
+
+	private:
+		SpriteRenderer();
+		SpriteRenderer(const SpriteRenderer& rhs);
+		SpriteRenderer& operator=(const SpriteRenderer& rhs);
+
+		UINT TextureIndex(ID3D11ShaderResourceView* texture, Pass* pass);
+		void Push(const Sprite& sprite);
+
+		Game* mGame;
+		std::shared_ptr<Effect> mEffect;
+		SpriteMaterial* mMaterial;
+		Pass* mPass;
+		Pass* mDistanceFieldPass;
+		ID3D11Buffer* mVertexBuffer;
+		ID3D11Buffer* mIndexBuffer;
+		UINT mVertexPosition;
+		UINT mBatchSize;
+
+		SpriteQueue mQueue;
+		UINT mCapacity;
+		std::vector<ID3D11ShaderResourceView*> mTextures;
+		std::vector<Pass*> mTexturePasses;
+		std::map<ID3D11ShaderResourceView*, UINT> mTextureIndices;
+		TextLayoutCache mLayouts;
+		XMFLOAT4X4 mTransform;
+		bool mIsDrawing;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "StreamingLoader.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Camera.h"
+#include "ThreadPool.h"
+
+namespace Library
+{
+	RTTI_DEFINITIONS(StreamingLoader)
+
+	StreamingLoader::StreamingLoader(Game& game, Camera& camera)
+		: GameComponent(game), mCamera(&camera), mPlaceholder(nullptr), mQueue(game.WorkerThreads())
+	{
+	}
+
+	StreamingLoader::~StreamingLoader()
+	{
+		ReleaseObject(mPlaceholder);
+	}
+
+	UINT StreamingLoader::UploadBudget() const
+	{
+		return mQueue.UploadBudget();
+	}
+
+	void StreamingLoader::SetUploadBudget(UINT uploadBudget)
+	{
+		mQueue.SetUploadBudget(uploadBudget);
+	}
+
+	std::shared_ptr<StreamingTexture> StreamingLoader::LoadTexture(const std::wstring& filename, const XMFLOAT3& position)
+	{
+		std::shared_ptr<StreamingTexture> texture(new StreamingTexture(*mGame, filename, position, Placeholder()));
+		mQueue.Enqueue(texture, Priority(*texture));
+
+		return texture;
+	}
+
+	std::shared_ptr<StreamingModel> StreamingLoader::LoadModel(const std::string& filename, bool flipUVs, const XMFLOAT3& position)
+	{
+		std::shared_ptr<StreamingModel> model(new StreamingModel(*mGame, filename, flipUVs, position));
+		mQueue.Enqueue(model, Priority(*model));
+
+		return model;
+	}
+
+	bool StreamingLoader::IsIdle() const
+	{
+		return mQueue.IsIdle();
+	}
+
+	StreamingStatistics StreamingLoader::Statistics() const
+	{
+		return mQueue.Statistics();
+	}
+
+	double StreamingLoader::LatencyPercentile(double percentile) const
+	{
+		return mQueue.LatencyPercentile(percentile);
+	}
+
+	void StreamingLoader::Update(const GameTime& gameTime)
+	{
+		// Positions are only written on the render thread, so reading them under the queue's lock is safe
+		mQueue.UpdatePriorities([&](const StreamingItem& item)
+		{
+			return Priority(item);
+		});
+
+		for (const std::shared_ptr<StreamingItem>& item : mQueue.Update())
+		{
+			if (item->State() == StreamingStateFailed)
+			{
+				OutputDebugStringA(item->Error().c_str());
+				OutputDebugStringA("\n");
+			}
+		}
+	}
+
+	float StreamingLoader::Priority(const StreamingItem& item) const
+	{
+		// Everything the loader queues is a StreamingResource
+		XMVECTOR offset = XMLoadFloat3(&static_cast<const StreamingResource&>(item).Position()) - mCamera->PositionVector();
+
+		return XMVectorGetX(XMVector3LengthSq(offset));
+	}
+
+	ID3D11ShaderResourceView* StreamingLoader::Placeholder()
+	{
+		if (mPlaceholder == nullptr)
+		{
+			// 1x1 mid-grey stands in for textures that haven't arrived
+			static const UINT PlaceholderColor = 0xFF808080;
+
+			D3D11_TEXTURE2D_DESC textureDesc;
+			ZeroMemory(&textureDesc, sizeof(textureDesc));
+			textureDesc.Width = 1;
+			textureDesc.Height = 1;
+			textureDesc.MipLevels = 1;
+			textureDesc.ArraySize = 1;
+			textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+			textureDesc.SampleDesc.Count = 1;
+			textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
+			textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+			D3D11_SUBRESOURCE_DATA textureData;
+			ZeroMemory(&textureData, sizeof(textureData));
+			textureData.pSysMem = &PlaceholderColor;
+			textureData.SysMemPitch = sizeof(PlaceholderColor);
+
+			HRESULT hr;
+			ID3D11Texture2D* texture = nullptr;
+			if (FAILED(hr = mGame->Direct3DDevice()->CreateTexture2D(&textureDesc, &textureData, &texture)))
+			{
+				throw GameException("IDXGIDevice::CreateTexture2D() failed.", hr);
+			}
+
+			if (FAILED(hr = mGame->Direct3DDevice()->CreateShaderResourceView(texture, nullptr, &mPlaceholder)))
+			{
+				ReleaseObject(texture);
+				throw GameException("IDXGIDevice::CreateShaderResourceView() failed.", hr);
+			}
+
+			ReleaseObject(texture);
+		}
+
+		return mPlaceholder;
+	}
+}
\ No newline at end of file
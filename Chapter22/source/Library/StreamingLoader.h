@@ -0,0 +1,45 @@
+#pragma once
+
+#include "GameComponent.h"
+#include "StreamingQueue.h"
+#include "StreamingResource.h"
+
+namespace Library
+{
+	class Camera;
+
+	// Streams textures and models through a StreamingQueue on the game's worker threads, prioritized by squared
+	// distance from the camera, and uploads them in Update() within the per-frame budget.
+	class StreamingLoader : public GameComponent
+	{
+		RTTI_DECLARATIONS(StreamingLoader, GameComponent)
+
+	public:
+		StreamingLoader(Game& game, Camera& camera);
+		~StreamingLoader();
+
+		UINT UploadBudget() const;
+		void SetUploadBudget(UINT uploadBudget);
+
+		std::shared_ptr<StreamingTexture> LoadTexture(const std::wstring& filename, const XMFLOAT3& position);
+		std::shared_ptr<StreamingModel> LoadModel(const std::string& filename, bool flipUVs, const XMFLOAT3& position);
+
+		bool IsIdle() const;
+		StreamingStatistics Statistics() const;
+		double LatencyPercentile(double percentile) const;
+
+		virtual void Update(const GameTime& gameTime) override;
+
+	private:
+		StreamingLoader();
+		StreamingLoader(const StreamingLoader& rhs);
+		StreamingLoader& operator=(const StreamingLoader& rhs);
+
+		float Priority(const StreamingItem& item) const;
+		ID3D11ShaderResourceView* Placeholder();
+
+		Camera* mCamera;
+		ID3D11ShaderResourceView* mPlaceholder;
+		StreamingQueue mQueue;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "StreamingQueue.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+namespace Library
+{
+	const unsigned int StreamingQueue::DefaultUploadBudget = 4 * 1024 * 1024;
+
+	StreamingItem::StreamingItem()
+		: mState(StreamingStateQueued), mError(), mPriority(0.0f), mRequestTime()
+	{
+	}
+
+	StreamingItem::~StreamingItem()
+	{
+	}
+
+	StreamingState StreamingItem::State() const
+	{
+		return mState;
+	}
+
+	bool StreamingItem::IsReady() const
+	{
+		return (mState == StreamingStateReady);
+	}
+
+	const std::string& StreamingItem::Error() const
+	{
+		return mError;
+	}
+
+	StreamingQueue::StreamingQueue(ThreadPool& threadPool)
+		: mThreadPool(&threadPool), mUploadBudget(DefaultUploadBudget), mQueued(), mLoaded(), mUploaded(), mLoadingCount(0), mMutex(), mLoadCompleted(),
+		  mRequestedCount(0), mFailedCount(0), mCancelledCount(0), mLatencies(), mUploadTimeLastFrame(0.0), mUploadTimeMaximum(0.0), mUploadedBytesLastFrame(0)
+	{
+	}
+
+	StreamingQueue::~StreamingQueue()
+	{
+		// Pending worker tasks find an empty queue and exit; in-flight loads are waited on
+		std::unique_lock<std::mutex> lock(mMutex);
+		mQueued.clear();
+		while (mLoadingCount > 0)
+		{
+			mLoadCompleted.wait(lock);
+		}
+
+		mLoaded.clear();
+	}
+
+	unsigned int StreamingQueue::UploadBudget() const
+	{
+		return mUploadBudget;
+	}
+
+	void StreamingQueue::SetUploadBudget(unsigned int uploadBudget)
+	{
+		mUploadBudget = uploadBudget;
+	}
+
+	void StreamingQueue::Enqueue(const std::shared_ptr<StreamingItem>& item, float priority)
+	{
+		item->mRequestTime = std::chrono::high_resolution_clock::now();
+		item->mPriority = priority;
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mQueued.push_back(item);
+			mLoadingCount++;
+			mRequestedCount++;
+		}
+
+		// Each task loads whichever queued item is most important when it starts, not necessarily this one
+		mThreadPool->Enqueue(std::bind(&StreamingQueue::LoadNext, this));
+	}
+
+	void StreamingQueue::UpdatePriorities(const std::function<float(const StreamingItem& item)>& priority)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (std::shared_ptr<StreamingItem>& item : mQueued)
+		{
+			item->mPriority = priority(*item);
+		}
+
+		for (std::shared_ptr<StreamingItem>& item : mLoaded)
+		{
+			item->mPriority = priority(*item);
+		}
+	}
+
+	const std::vector<std::shared_ptr<StreamingItem>>& StreamingQueue::Update()
+	{
+		auto uploadStartTime = std::chrono::high_resolution_clock::now();
+
+		// Take the most important loaded items that fit in this frame's budget
+		mUploaded.clear();
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			std::sort(mLoaded.begin(), mLoaded.end(), ComparePriority);
+
+			unsigned int uploadSize = 0;
+			auto it = mLoaded.begin();
+			for (; it != mLoaded.end(); ++it)
+			{
+				unsigned int size = ((*it)->mError.empty() ? (*it)->UploadSize() : 0);
+				if (mUploaded.empty() == false && uploadSize + size > mUploadBudget)
+				{
+					break;
+				}
+
+				uploadSize += size;
+				mUploaded.push_back(*it);
+			}
+
+			mLoaded.erase(mLoaded.begin(), it);
+			mUploadedBytesLastFrame = uploadSize;
+		}
+
+		for (std::shared_ptr<StreamingItem>& item : mUploaded)
+		{
+			if (item->mError.empty())
+			{
+				try
+				{
+					item->Upload();
+				}
+				catch (std::exception& ex)
+				{
+					item->mError = ex.what();
+				}
+			}
+
+			if (item->mError.empty())
+			{
+				item->mState = StreamingStateReady;
+
+				std::lock_guard<std::mutex> lock(mMutex);
+				mLatencies.push_back(ElapsedMilliseconds(item->mRequestTime));
+			}
+			else
+			{
+				item->mState = StreamingStateFailed;
+
+				std::lock_guard<std::mutex> lock(mMutex);
+				mFailedCount++;
+			}
+		}
+
+		double uploadTime = ElapsedMilliseconds(uploadStartTime);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		mUploadTimeLastFrame = uploadTime;
+		mUploadTimeMaximum = std::max(mUploadTimeMaximum, uploadTime);
+
+		return mUploaded;
+	}
+
+	bool StreamingQueue::IsIdle() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		return (mQueued.empty() && mLoaded.empty() && mLoadingCount == 0);
+	}
+
+	StreamingStatistics StreamingQueue::Statistics() const
+	{
+		StreamingStatistics statistics;
+		statistics.LatencyPercentile50 = LatencyPercentile(50.0);
+		statistics.LatencyPercentile95 = LatencyPercentile(95.0);
+		statistics.LatencyPercentile99 = LatencyPercentile(99.0);
+		statistics.LatencyMaximum = LatencyPercentile(100.0);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		statistics.RequestedCount = mRequestedCount;
+		statistics.CompletedCount = static_cast<unsigned int>(mLatencies.size());
+		statistics.FailedCount = mFailedCount;
+		statistics.CancelledCount = mCancelledCount;
+		statistics.QueuedCount = static_cast<unsigned int>(mQueued.size());
+		statistics.AwaitingUploadCount = static_cast<unsigned int>(mLoaded.size());
+		statistics.UploadTimeLastFrame = mUploadTimeLastFrame;
+		statistics.UploadTimeMaximum = mUploadTimeMaximum;
+		statistics.UploadedBytesLastFrame = mUploadedBytesLastFrame;
+
+		return statistics;
+	}
+
+	double StreamingQueue::LatencyPercentile(double percentile) const
+	{
+		std::vector<double> latencies;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			latencies = mLatencies;
+		}
+
+		if (latencies.empty())
+		{
+			return 0.0;
+		}
+
+		// Nearest-rank percentile
+		size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * latencies.size()));
+		size_t index = (rank > 0 ? std::min(rank, latencies.size()) - 1 : 0);
+		std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+
+		return latencies[index];
+	}
+
+	void StreamingQueue::LoadNext()
+	{
+		std::shared_ptr<StreamingItem> item;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mQueued.empty() == false)
+			{
+				auto next = std::min_element(mQueued.begin(), mQueued.end(), ComparePriority);
+				item = *next;
+				mQueued.erase(next);
+			}
+		}
+
+		// Skip items whose only remaining owner is the queue
+		if (item != nullptr && item.use_count() > 1)
+		{
+			try
+			{
+				item->Load();
+			}
+			catch (std::exception& ex)
+			{
+				item->mError = ex.what();
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (item != nullptr)
+		{
+			if (item.use_count() > 1)
+			{
+				mLoaded.push_back(item);
+			}
+			else
+			{
+				mCancelledCount++;
+			}
+		}
+
+		mLoadingCount--;
+		mLoadCompleted.notify_all();
+	}
+
+	double StreamingQueue::ElapsedMilliseconds(std::chrono::high_resolution_clock::time_point startTime)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	}
+
+	bool StreamingQueue::ComparePriority(const std::shared_ptr<StreamingItem>& lhs, const std::shared_ptr<StreamingItem>& rhs)
+	{
+		return (lhs->mPriority < rhs->mPriority);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+// Portable, like TextureResidency: the load ordering and upload budget run without a device
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+namespace Library
+{
+	class ThreadPool;
+
+	enum StreamingState
+	{
+		StreamingStateQueued = 0,
+		StreamingStateReady,
+		StreamingStateFailed,
+		StreamingStateEnd
+	};
+
+	typedef struct _StreamingStatistics
+	{
+		unsigned int RequestedCount;
+		unsigned int CompletedCount;
+		unsigned int FailedCount;
+		unsigned int CancelledCount;
+		unsigned int QueuedCount;
+		unsigned int AwaitingUploadCount;
+		double LatencyPercentile50;
+		double LatencyPercentile95;
+		double LatencyPercentile99;
+		double LatencyMaximum;
+		double UploadTimeLastFrame;
+		double UploadTimeMaximum;
+		unsigned int UploadedBytesLastFrame;
+	} StreamingStatistics;
+
+	// One streamed resource. Load() runs on a worker thread and does the file I/O and decoding; UploadSize() and
+	// Upload() run on the thread calling StreamingQueue::Update() and should only hand the decoded data over. Any of
+	// them may throw a std::exception to fail the item.
+	class StreamingItem
+	{
+		friend class StreamingQueue;
+
+	public:
+		virtual ~StreamingItem();
+
+		StreamingState State() const;
+		bool IsReady() const;
+		const std::string& Error() const;
+
+	protected:
+		StreamingItem();
+
+		virtual void Load() = 0;
+		virtual unsigned int UploadSize() const = 0;
+		virtual void Upload() = 0;
+
+	private:
+		StreamingItem(const StreamingItem& rhs);
+		StreamingItem& operator=(const StreamingItem& rhs);
+
+		StreamingState mState;
+		std::string mError;
+		float mPriority;
+		std::chrono::high_resolution_clock::time_point mRequestTime;
+	};
+
+	// Loads items on a thread pool and uploads them on the thread calling Update(). Each worker task takes whichever
+	// queued item is most important when it starts, and each Update() uploads the most important loaded items that fit
+	// the per-frame byte budget, always at least one so an item larger than the budget still completes. Smaller
+	// priorities are more important, so a squared camera distance serves as one. Items whose only remaining owner is
+	// the queue are dropped, before or after loading, and counted as cancelled. Latencies run from Enqueue() to the end of the item's Upload(), in milliseconds.
+	class StreamingQueue
+	{
+	public:
+		StreamingQueue(ThreadPool& threadPool);
+		~StreamingQueue();
+
+		unsigned int UploadBudget() const;
+		void SetUploadBudget(unsigned int uploadBudget);
+
+		void Enqueue(const std::shared_ptr<StreamingItem>& item, float priority);
+
+		// Recomputes the priority of every item not yet uploaded; priority() is called under the queue's lock
+		void UpdatePriorities(const std::function<float(const StreamingItem& item)>& priority);
+
+		// Uploads this frame's items and returns them, ready or failed
+		const std::vector<std::shared_ptr<StreamingItem>>& Update();
+
+		bool IsIdle() const;
+		StreamingStatistics Statistics() const;
+		double LatencyPercentile(double percentile) const;
+
+		static const unsigned int DefaultUploadBudget;
+
+	private:
+		StreamingQueue();
+		StreamingQueue(const StreamingQueue& rhs);
+		StreamingQueue& operator=(const StreamingQueue& rhs);
+
+		void LoadNext();
+
+		static double ElapsedMilliseconds(std::chrono::high_resolution_clock::time_point startTime);
+		static bool ComparePriority(const std::shared_ptr<StreamingItem>& lhs, const std::shared_ptr<StreamingItem>& rhs);
+
+		ThreadPool* mThreadPool;
+		unsigned int mUploadBudget;
+
+		std::vector<std::shared_ptr<StreamingItem>> mQueued;
+		std::vector<std::shared_ptr<StreamingItem>> mLoaded;
+		std::vector<std::shared_ptr<StreamingItem>> mUploaded;
+		unsigned int mLoadingCount;
+		mutable std::mutex mMutex;
+		std::condition_variable mLoadCompleted;
+
+		unsigned int mRequestedCount;
+		unsigned int mFailedCount;
+		unsigned int mCancelledCount;
+		std::vector<double> mLatencies;
+		double mUploadTimeLastFrame;
+		double mUploadTimeMaximum;
+		unsigned int mUploadedBytesLastFrame;
+	};
+}
\ No newline at end of file
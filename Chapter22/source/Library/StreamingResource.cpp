@@ -0,0 +1,224 @@
+#include "StreamingResource.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Model.h"
+#include "Utility.h"
+#include <DDSTextureLoader.h>
+#include <wincodec.h>
+
+namespace Library
+{
+	StreamingResource::StreamingResource(Game& game, const XMFLOAT3& position)
+		: StreamingItem(), mGame(&game), mPosition(position)
+	{
+	}
+
+	StreamingResource::~StreamingResource()
+	{
+	}
+
+	const XMFLOAT3& StreamingResource::Position() const
+	{
+		return mPosition;
+	}
+
+	void StreamingResource::SetPosition(const XMFLOAT3& position)
+	{
+		mPosition = position;
+	}
+
+	StreamingTexture::StreamingTexture(Game& game, const std::wstring& filename, const XMFLOAT3& position, ID3D11ShaderResourceView* placeholder)
+		: StreamingResource(game, position), mFilename(filename), mIsDDS(false), mData(), mWidth(0), mHeight(0),
+		  mPlaceholder(placeholder), mShaderResourceView(nullptr)
+	{
+		if (mPlaceholder != nullptr)
+		{
+			mPlaceholder->AddRef();
+		}
+
+		std::wstring extension;
+		Utility::GetPathExtension(mFilename, extension);
+		mIsDDS = (_wcsicmp(extension.c_str(), L".dds") == 0);
+	}
+
+	StreamingTexture::~StreamingTexture()
+	{
+		ReleaseObject(mShaderResourceView);
+		ReleaseObject(mPlaceholder);
+	}
+
+	const std::wstring& StreamingTexture::Filename() const
+	{
+		return mFilename;
+	}
+
+	ID3D11ShaderResourceView* StreamingTexture::ShaderResourceView() const
+	{
+		return (mShaderResourceView != nullptr ? mShaderResourceView : mPlaceholder);
+	}
+
+	void StreamingTexture::Load()
+	{
+		if (GetFileAttributes(mFilename.c_str()) == INVALID_FILE_ATTRIBUTES)
+		{
+			throw GameException("Texture file not found.");
+		}
+
+		if (mIsDDS)
+		{
+			Utility::LoadBinaryFile(mFilename, mData);
+			if (mData.empty())
+			{
+				throw GameException("Could not read texture file.");
+			}
+		}
+		else
+		{
+			DecodeImage();
+		}
+	}
+
+	UINT StreamingTexture::UploadSize() const
+	{
+		return static_cast<UINT>(mData.size());
+	}
+
+	void StreamingTexture::Upload()
+	{
+		if (mIsDDS)
+		{
+			// The loader only reads the header; the mips are copied as they are
+			HRESULT hr;
+			if (FAILED(hr = DirectX::CreateDDSTextureFromMemory(mGame->Direct3DDevice(), reinterpret_cast<const uint8_t*>(&mData.front()), mData.size(), nullptr, &mShaderResourceView)))
+			{
+				throw GameException("CreateDDSTextureFromMemory() failed.", hr);
+			}
+		}
+		else
+		{
+			UploadImage();
+		}
+
+		// The file contents and pixels are no longer needed once the texture exists
+		std::vector<char>().swap(mData);
+	}
+
+	void StreamingTexture::DecodeImage()
+	{
+		// Worker threads don't initialize COM themselves; a thread already in another apartment can still use WIC
+		HRESULT coInitialize = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+		IWICImagingFactory* factory = nullptr;
+		IWICBitmapDecoder* decoder = nullptr;
+		IWICBitmapFrameDecode* frame = nullptr;
+		IWICFormatConverter* converter = nullptr;
+
+		HRESULT hr;
+		if (SUCCEEDED(hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory)))
+			&& SUCCEEDED(hr = factory->CreateDecoderFromFilename(mFilename.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder))
+			&& SUCCEEDED(hr = decoder->GetFrame(0, &frame))
+			&& SUCCEEDED(hr = factory->CreateFormatConverter(&converter))
+			&& SUCCEEDED(hr = converter->Initialize(frame, GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom))
+			&& SUCCEEDED(hr = converter->GetSize(&mWidth, &mHeight)))
+		{
+			if (mWidth == 0 || mHeight == 0 || mWidth > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION || mHeight > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION)
+			{
+				hr = E_INVALIDARG;
+			}
+			else
+			{
+				mData.resize(static_cast<size_t>(mWidth) * mHeight * 4);
+				hr = converter->CopyPixels(nullptr, mWidth * 4, static_cast<UINT>(mData.size()), reinterpret_cast<BYTE*>(&mData.front()));
+			}
+		}
+
+		ReleaseObject(converter);
+		ReleaseObject(frame);
+		ReleaseObject(decoder);
+		ReleaseObject(factory);
+
+		if (SUCCEEDED(coInitialize))
+		{
+			CoUninitialize();
+		}
+
+		if (FAILED(hr))
+		{
+			std::vector<char>().swap(mData);
+			throw GameException("Could not decode texture file.", hr);
+		}
+	}
+
+	void StreamingTexture::UploadImage()
+	{
+		// Created with its full mip chain, which the GPU fills from the top mip, as CreateWICTextureFromFile() does
+		D3D11_TEXTURE2D_DESC textureDesc;
+		ZeroMemory(&textureDesc, sizeof(textureDesc));
+		textureDesc.Width = mWidth;
+		textureDesc.Height = mHeight;
+		textureDesc.MipLevels = 0;
+		textureDesc.ArraySize = 1;
+		textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		textureDesc.SampleDesc.Count = 1;
+		textureDesc.Usage = D3D11_USAGE_DEFAULT;
+		textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+		textureDesc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+
+		HRESULT hr;
+		ID3D11Texture2D* texture = nullptr;
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateTexture2D(&textureDesc, nullptr, &texture)))
+		{
+			throw GameException("IDXGIDevice::CreateTexture2D() failed.", hr);
+		}
+
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateShaderResourceView(texture, nullptr, &mShaderResourceView)))
+		{
+			ReleaseObject(texture);
+			throw GameException("IDXGIDevice::CreateShaderResourceView() failed.", hr);
+		}
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		direct3DDeviceContext->UpdateSubresource(texture, 0, nullptr, &mData.front(), mWidth * 4, static_cast<UINT>(mData.size()));
+		direct3DDeviceContext->GenerateMips(mShaderResourceView);
+
+		ReleaseObject(texture);
+	}
+
+	StreamingModel::StreamingModel(Game& game, const std::string& filename, bool flipUVs, const XMFLOAT3& position)
+		: StreamingResource(game, position), mFilename(filename), mFlipUVs(flipUVs), mLoadedModel(nullptr), mModel(nullptr)
+	{
+	}
+
+	StreamingModel::~StreamingModel()
+	{
+		DeleteObject(mLoadedModel);
+		DeleteObject(mModel);
+	}
+
+	const std::string& StreamingModel::Filename() const
+	{
+		return mFilename;
+	}
+
+	Model* StreamingModel::GetModel() const
+	{
+		return mModel;
+	}
+
+	void StreamingModel::Load()
+	{
+		mLoadedModel = new Model(*mGame, mFilename, mFlipUVs);
+	}
+
+	UINT StreamingModel::UploadSize() const
+	{
+		// Models carry no GPU resources of their own; meshes create buffers through their materials
+		return 0;
+	}
+
+	void StreamingModel::Upload()
+	{
+		mModel = mLoadedModel;
+		mLoadedModel = nullptr;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Common.h"
+#include "StreamingQueue.h"
+
+namespace Library
+{
+	class Game;
+	class Model;
+
+	class StreamingResource : public StreamingItem
+	{
+	public:
+		StreamingResource(Game& game, const XMFLOAT3& position);
+		virtual ~StreamingResource();
+
+		const XMFLOAT3& Position() const;
+		void SetPosition(const XMFLOAT3& position);
+
+	protected:
+		Game* mGame;
+		XMFLOAT3 mPosition;
+
+	private:
+		StreamingResource();
+		StreamingResource(const StreamingResource& rhs);
+		StreamingResource& operator=(const StreamingResource& rhs);
+	};
+
+	class StreamingTexture : public StreamingResource
+	{
+	public:
+		StreamingTexture(Game& game, const std::wstring& filename, const XMFLOAT3& position, ID3D11ShaderResourceView* placeholder);
+		~StreamingTexture();
+
+		const std::wstring& Filename() const;
+
+		// Returns the placeholder until the texture is ready
+		ID3D11ShaderResourceView* ShaderResourceView() const;
+
+	protected:
+		// DDS files are read as they are; anything else is decoded by WIC to 32-bit RGBA here, on the worker
+		virtual void Load() override;
+		virtual UINT UploadSize() const override;
+		virtual void Upload() override;
+
+	private:
+		StreamingTexture();
+		StreamingTexture(const StreamingTexture& rhs);
+		StreamingTexture& operator=(const StreamingTexture& rhs);
+
+		void DecodeImage();
+		void UploadImage();
+
+		std::wstring mFilename;
+		bool mIsDDS;
+		std::vector<char> mData;
+		UINT mWidth;
+		UINT mHeight;
+		ID3D11ShaderResourceView* mPlaceholder;
+		ID3D11ShaderResourceView* mShaderResourceView;
+	};
+
+	class StreamingModel : public StreamingResource
+	{
+	public:
+		StreamingModel(Game& game, const std::string& filename, bool flipUVs, const XMFLOAT3& position);
+		~StreamingModel();
+
+		const std::string& Filename() const;
+
+		// Returns nullptr until the model is ready
+		Model* GetModel() const;
+
+	protected:
+		virtual void Load() override;
+		virtual UINT UploadSize() const override;
+		virtual void Upload() override;
+
+	private:
+		StreamingModel();
+		StreamingModel(const StreamingModel& rhs);
+		StreamingModel& operator=(const StreamingModel& rhs);
+
+		std::string mFilename;
+		bool mFlipUVs;
+		Model* mLoadedModel;
+		Model* mModel;
+	};
+}
\ No newline at end of file
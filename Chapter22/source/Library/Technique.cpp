@@ -54,4 +54,38 @@ namespace Library
     {
         return mPassesByName;
     }
+
+    void Technique::Rebind(Game& game, ID3DX11EffectTechnique* technique)
+    {
+        mTechnique = technique;
+        if (mTechnique->IsValid())
+        {
+            mTechnique->GetDesc(&mTechniqueDesc);
+        }
+        else
+        {
+            ZeroMemory(&mTechniqueDesc, sizeof(mTechniqueDesc));
+        }
+
+        // Existing passes are rebound in place (by name) so callers holding Pass pointers stay valid.
+        // Passes removed from the technique bind to an invalid pass.
+        for (Pass* pass : mPasses)
+        {
+            pass->Rebind(mTechnique->GetPassByName(pass->Name().c_str()));
+        }
+
+        for (UINT i = 0; i < mTechniqueDesc.Passes; i++)
+        {
+            ID3DX11EffectPass* effectPass = mTechnique->GetPassByIndex(i);
+            D3DX11_PASS_DESC passDesc;
+            effectPass->GetDesc(&passDesc);
+
+            if (mPassesByName.find(passDesc.Name) == mPassesByName.end())
+            {
+                Pass* pass = new Pass(game, *this, effectPass);
+                mPasses.push_back(pass);
+                mPassesByName.insert(std::pair<std::string, Pass*>(pass->Name(), pass));
+            }
+        }
+    }
 }
\ No newline at end of file
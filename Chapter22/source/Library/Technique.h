@@ -21,6 +21,8 @@ namespace Library
         const std::vector<Pass*>& Passes() const;
         const std::map<std::string, Pass*>& PassesByName() const;
 
+        void Rebind(Game& game, ID3DX11EffectTechnique* technique);
+
     private:
         Technique(const Technique& rhs);
         Technique& operator=(const Technique& rhs);
@@ -0,0 +1,238 @@
+#include "TemporalAA.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Camera.h"
+#include "Utility.h"
+#include "ContentManager.h"
+#include "Effect.h"
+#include "TemporalAAMaterial.h"
+#include "FullScreenQuad.h"
+
+namespace Library
+{
+	RTTI_DEFINITIONS(TemporalAA)
+
+	const UINT TemporalAA::ThreadsPerGroup = 16;
+
+	TemporalAA::TemporalAA(Game& game, Camera& camera)
+		: DrawableGameComponent(game, camera),
+		  mEffect(), mMaterial(nullptr), mVelocityPass(nullptr), mResolvePass(nullptr), mFullScreenQuad(nullptr), mSettings(TemporalAAReference::DefaultSettings),
+		  mSceneTexture(nullptr), mDepthTexture(nullptr), mVelocityTexture(nullptr), mVelocityOutputTexture(nullptr), mVelocityOutput(nullptr),
+		  mHistoryTextures(), mHistoryOutputs(), mHistoryIndex(0), mIsHistoryValid(false),
+		  mFrame(0), mJitter(0.0f, 0.0f), mPreviousViewProjectionMatrix()
+	{
+	}
+
+	TemporalAA::TemporalAA(Game& game, Camera& camera, const TemporalAASettings& settings)
+		: DrawableGameComponent(game, camera),
+		  mEffect(), mMaterial(nullptr), mVelocityPass(nullptr), mResolvePass(nullptr), mFullScreenQuad(nullptr), mSettings(settings),
+		  mSceneTexture(nullptr), mDepthTexture(nullptr), mVelocityTexture(nullptr), mVelocityOutputTexture(nullptr), mVelocityOutput(nullptr),
+		  mHistoryTextures(), mHistoryOutputs(), mHistoryIndex(0), mIsHistoryValid(false),
+		  mFrame(0), mJitter(0.0f, 0.0f), mPreviousViewProjectionMatrix()
+	{
+	}
+
+	TemporalAA::~TemporalAA()
+	{
+		for (UINT i = 0; i < ARRAYSIZE(mHistoryTextures); i++)
+		{
+			ReleaseObject(mHistoryOutputs[i]);
+			ReleaseObject(mHistoryTextures[i]);
+		}
+
+		ReleaseObject(mVelocityOutput);
+		ReleaseObject(mVelocityOutputTexture);
+		DeleteObject(mFullScreenQuad);
+		DeleteObject(mMaterial);
+	}
+
+	const TemporalAASettings& TemporalAA::Settings() const
+	{
+		return mSettings;
+	}
+
+	void TemporalAA::SetSettings(const TemporalAASettings& settings)
+	{
+		mSettings = settings;
+	}
+
+	ID3D11ShaderResourceView* TemporalAA::SceneTexture() const
+	{
+		return mSceneTexture;
+	}
+
+	void TemporalAA::SetSceneTexture(ID3D11ShaderResourceView& sceneTexture)
+	{
+		mSceneTexture = &sceneTexture;
+	}
+
+	ID3D11ShaderResourceView* TemporalAA::DepthTexture() const
+	{
+		return mDepthTexture;
+	}
+
+	void TemporalAA::SetDepthTexture(ID3D11ShaderResourceView& depthTexture)
+	{
+		mDepthTexture = &depthTexture;
+	}
+
+	ID3D11ShaderResourceView* TemporalAA::VelocityTexture() const
+	{
+		return mVelocityTexture;
+	}
+
+	void TemporalAA::SetVelocityTexture(ID3D11ShaderResourceView* velocityTexture)
+	{
+		mVelocityTexture = velocityTexture;
+	}
+
+	ID3D11ShaderResourceView* TemporalAA::OutputTexture() const
+	{
+		return mHistoryTextures[mHistoryIndex];
+	}
+
+	void TemporalAA::Reset()
+	{
+		mIsHistoryValid = false;
+	}
+
+	void TemporalAA::Initialize()
+	{
+		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
+
+		mEffect = mGame->Content().LoadEffect(L"Content\\Effects\\TemporalAA.cso");
+
+		mMaterial = new TemporalAAMaterial();
+		mMaterial->Initialize(*mEffect);
+
+		const std::map<std::string, Technique*>& techniques = mEffect->TechniquesByName();
+		mVelocityPass = techniques.at("velocity")->PassesByName().at("p0");
+		mResolvePass = techniques.at("resolve")->PassesByName().at("p0");
+
+		mFullScreenQuad = new FullScreenQuad(*mGame, *mMaterial);
+		mFullScreenQuad->Initialize();
+		mFullScreenQuad->SetCustomUpdateMaterial(std::bind(&TemporalAA::UpdateCopyMaterial, this));
+
+		// Half floats for the history, so the small steps of a 10% blend aren't lost to 8-bit rounding
+		CreateTexture(DXGI_FORMAT_R16G16_FLOAT, &mVelocityOutputTexture, &mVelocityOutput);
+		for (UINT i = 0; i < ARRAYSIZE(mHistoryTextures); i++)
+		{
+			CreateTexture(DXGI_FORMAT_R16G16B16A16_FLOAT, &mHistoryTextures[i], &mHistoryOutputs[i]);
+		}
+	}
+
+	void TemporalAA::Update(const GameTime& gameTime)
+	{
+		assert(mCamera != nullptr);
+
+		TemporalAAReference::JitterOffset(mFrame++, mSettings.JitterSampleCount, mJitter.x, mJitter.y);
+		mCamera->SetProjectionJitter(mJitter.x, mJitter.y);
+	}
+
+	void TemporalAA::Draw(const GameTime& gameTime)
+	{
+		assert(mSceneTexture != nullptr && (mDepthTexture != nullptr || mVelocityTexture != nullptr));
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		UINT width = mGame->ScreenWidth();
+		UINT height = mGame->ScreenHeight();
+		UINT groupCountX = (width + ThreadsPerGroup - 1) / ThreadsPerGroup;
+		UINT groupCountY = (height + ThreadsPerGroup - 1) / ThreadsPerGroup;
+
+		XMMATRIX viewProjectionMatrix = mCamera->UnjitteredViewProjectionMatrix();
+		if (mIsHistoryValid == false)
+		{
+			XMStoreFloat4x4(&mPreviousViewProjectionMatrix, viewProjectionMatrix);
+		}
+
+		XMMATRIX reprojectionMatrix = XMMatrixMultiply(XMMatrixInverse(nullptr, mCamera->ViewProjectionMatrix()), XMLoadFloat4x4(&mPreviousViewProjectionMatrix));
+
+		mMaterial->Reprojection() << reprojectionMatrix;
+		mMaterial->JitterOffset() << XMVectorSet(mJitter.x / width, mJitter.y / height, 0.0f, 0.0f);
+		mMaterial->ScreenSize() << XMVectorSet(static_cast<float>(width), static_cast<float>(height), 0.0f, 0.0f);
+		mMaterial->BlendFactor() << mSettings.BlendFactor;
+		mMaterial->HistoryValid() << (mIsHistoryValid ? 1 : 0);
+
+		ID3D11ShaderResourceView* velocityTexture = mVelocityTexture;
+		if (velocityTexture == nullptr)
+		{
+			mMaterial->DepthTexture() << mDepthTexture;
+			mMaterial->OutputVelocity() << mVelocityOutput;
+			mVelocityPass->Apply(0, direct3DDeviceContext);
+
+			direct3DDeviceContext->Dispatch(groupCountX, groupCountY, 1);
+			UnbindComputeResources();
+
+			velocityTexture = mVelocityOutputTexture;
+		}
+
+		UINT previousHistoryIndex = mHistoryIndex;
+		mHistoryIndex = 1 - mHistoryIndex;
+
+		mMaterial->ColorTexture() << mSceneTexture;
+		mMaterial->HistoryTexture() << mHistoryTextures[previousHistoryIndex];
+		mMaterial->VelocityTexture() << velocityTexture;
+		mMaterial->OutputColor() << mHistoryOutputs[mHistoryIndex];
+		mResolvePass->Apply(0, direct3DDeviceContext);
+
+		direct3DDeviceContext->Dispatch(groupCountX, groupCountY, 1);
+		UnbindComputeResources();
+
+		mFullScreenQuad->Draw(gameTime);
+		mGame->UnbindPixelShaderResources(0, 1);
+
+		XMStoreFloat4x4(&mPreviousViewProjectionMatrix, viewProjectionMatrix);
+		mIsHistoryValid = true;
+	}
+
+	void TemporalAA::CreateTexture(DXGI_FORMAT format, ID3D11ShaderResourceView** shaderResourceView, ID3D11UnorderedAccessView** unorderedAccessView)
+	{
+		D3D11_TEXTURE2D_DESC textureDesc;
+		ZeroMemory(&textureDesc, sizeof(textureDesc));
+		textureDesc.Width = mGame->ScreenWidth();
+		textureDesc.Height = mGame->ScreenHeight();
+		textureDesc.MipLevels = 1;
+		textureDesc.ArraySize = 1;
+		textureDesc.Format = format;
+		textureDesc.SampleDesc.Count = 1;
+		textureDesc.SampleDesc.Quality = 0;
+		textureDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE;
+
+		HRESULT hr;
+		ID3D11Texture2D* texture = nullptr;
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateTexture2D(&textureDesc, nullptr, &texture)))
+		{
+			throw GameException("IDXGIDevice::CreateTexture2D() failed.", hr);
+		}
+
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateUnorderedAccessView(texture, nullptr, unorderedAccessView)))
+		{
+			ReleaseObject(texture);
+			throw GameException("IDXGIDevice::CreateUnorderedAccessView() failed.", hr);
+		}
+
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateShaderResourceView(texture, nullptr, shaderResourceView)))
+		{
+			ReleaseObject(texture);
+			throw GameException("IDXGIDevice::CreateShaderResourceView() failed.", hr);
+		}
+
+		ReleaseObject(texture);
+	}
+
+	void TemporalAA::UnbindComputeResources()
+	{
+		// The resolve reads the velocity just written, and the copy reads the history just written
+		static ID3D11UnorderedAccessView* emptyUAV = nullptr;
+		static ID3D11ShaderResourceView* emptySRVs[] = { nullptr, nullptr, nullptr, nullptr };
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		direct3DDeviceContext->CSSetUnorderedAccessViews(0, 1, &emptyUAV, nullptr);
+		direct3DDeviceContext->CSSetShaderResources(0, ARRAYSIZE(emptySRVs), emptySRVs);
+	}
+
+	void TemporalAA::UpdateCopyMaterial()
+	{
+		mMaterial->ColorTexture() << mHistoryTextures[mHistoryIndex];
+	}
+}
\ No newline at end of file
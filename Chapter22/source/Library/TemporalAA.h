@@ -0,0 +1,80 @@
+#pragma once
+
+#include "DrawableGameComponent.h"
+#include "TemporalAAReference.h"
+
+namespace Library
+{
+	class Effect;
+	class Pass;
+	class FullScreenQuad;
+	class TemporalAAMaterial;
+
+	// Anti-aliasing by accumulating jittered frames, in place of a multi-sampled swap chain. Update() jitters the
+	// camera's projection by a sub-pixel Halton offset; Draw() resolves the scene against the reprojected history
+	// and writes the result to the currently bound render target, so it goes last in the post-processing chain.
+	//
+	// Velocity is derived from depth and the camera's motion unless SetVelocityTexture() supplies one (R16G16_FLOAT,
+	// as TemporalAAReference describes it) that also covers moving objects. Reset() after camera cuts; disabling the
+	// component leaves the last jitter on the camera, so clear it with Camera::SetProjectionJitter(0, 0).
+	class TemporalAA : public DrawableGameComponent
+	{
+		RTTI_DECLARATIONS(TemporalAA, DrawableGameComponent)
+
+	public:
+		TemporalAA(Game& game, Camera& camera);
+		TemporalAA(Game& game, Camera& camera, const TemporalAASettings& settings);
+		~TemporalAA();
+
+		const TemporalAASettings& Settings() const;
+		void SetSettings(const TemporalAASettings& settings);
+
+		ID3D11ShaderResourceView* SceneTexture() const;
+		void SetSceneTexture(ID3D11ShaderResourceView& sceneTexture);
+		ID3D11ShaderResourceView* DepthTexture() const;
+		void SetDepthTexture(ID3D11ShaderResourceView& depthTexture);
+		ID3D11ShaderResourceView* VelocityTexture() const;
+		void SetVelocityTexture(ID3D11ShaderResourceView* velocityTexture);
+
+		// The resolved image, which is also next frame's history
+		ID3D11ShaderResourceView* OutputTexture() const;
+
+		void Reset();
+
+		virtual void Initialize() override;
+		virtual void Update(const GameTime& gameTime) override;
+		virtual void Draw(const GameTime& gameTime) override;
+
+		static const UINT ThreadsPerGroup;
+
+	private:
+		TemporalAA();
+		TemporalAA(const TemporalAA& rhs);
+		TemporalAA& operator=(const TemporalAA& rhs);
+
+		void CreateTexture(DXGI_FORMAT format, ID3D11ShaderResourceView** shaderResourceView, ID3D11UnorderedAccessView** unorderedAccessView);
+		void UnbindComputeResources();
+		void UpdateCopyMaterial();
+
+		std::shared_ptr<Effect> mEffect;
+		TemporalAAMaterial* mMaterial;
+		Pass* mVelocityPass;
+		Pass* mResolvePass;
+		FullScreenQuad* mFullScreenQuad;
+		TemporalAASettings mSettings;
+
+		ID3D11ShaderResourceView* mSceneTexture;
+		ID3D11ShaderResourceView* mDepthTexture;
+		ID3D11ShaderResourceView* mVelocityTexture;
+		ID3D11ShaderResourceView* mVelocityOutputTexture;
+		ID3D11UnorderedAccessView* mVelocityOutput;
+		ID3D11ShaderResourceView* mHistoryTextures[2];
+		ID3D11UnorderedAccessView* mHistoryOutputs[2];
+		UINT mHistoryIndex;
+		bool mIsHistoryValid;
+
+		UINT mFrame;
+		XMFLOAT2 mJitter;
+		XMFLOAT4X4 mPreviousViewProjectionMatrix;
+	};
+}
\ No newline at end of file
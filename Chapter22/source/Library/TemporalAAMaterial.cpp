@@ -0,0 +1,96 @@
+#include "TemporalAAMaterial.h"
+#include "GameException.h"
+#include "Mesh.h"
+
+namespace Library
+{
+	RTTI_DEFINITIONS(TemporalAAMaterial)
+
+	TemporalAAMaterial::TemporalAAMaterial()
+		: Material("copy"),
+		  MATERIAL_VARIABLE_INITIALIZATION(Reprojection), MATERIAL_VARIABLE_INITIALIZATION(JitterOffset),
+		  MATERIAL_VARIABLE_INITIALIZATION(ScreenSize), MATERIAL_VARIABLE_INITIALIZATION(BlendFactor),
+		  MATERIAL_VARIABLE_INITIALIZATION(HistoryValid), MATERIAL_VARIABLE_INITIALIZATION(ColorTexture),
+		  MATERIAL_VARIABLE_INITIALIZATION(HistoryTexture), MATERIAL_VARIABLE_INITIALIZATION(DepthTexture),
+		  MATERIAL_VARIABLE_INITIALIZATION(VelocityTexture), MATERIAL_VARIABLE_INITIALIZATION(OutputVelocity),
+		  MATERIAL_VARIABLE_INITIALIZATION(OutputColor)
+	{
+	}
+
+	MATERIAL_VARIABLE_DEFINITION(TemporalAAMaterial, Reprojection)
+	MATERIAL_VARIABLE_DEFINITION(TemporalAAMaterial, JitterOffset)
+	MATERIAL_VARIABLE_DEFINITION(TemporalAAMaterial, ScreenSize)
+	MATERIAL_VARIABLE_DEFINITION(TemporalAAMaterial, BlendFactor)
+	MATERIAL_VARIABLE_DEFINITION(TemporalAAMaterial, HistoryValid)
+	MATERIAL_VARIABLE_DEFINITION(TemporalAAMaterial, ColorTexture)
+	MATERIAL_VARIABLE_DEFINITION(TemporalAAMaterial, HistoryTexture)
+	MATERIAL_VARIABLE_DEFINITION(TemporalAAMaterial, DepthTexture)
+	MATERIAL_VARIABLE_DEFINITION(TemporalAAMaterial, VelocityTexture)
+	MATERIAL_VARIABLE_DEFINITION(TemporalAAMaterial, OutputVelocity)
+	MATERIAL_VARIABLE_DEFINITION(TemporalAAMaterial, OutputColor)
+
+	void TemporalAAMaterial::Initialize(Effect& effect)
+	{
+		Material::Initialize(effect);
+
+		MATERIAL_VARIABLE_RETRIEVE(Reprojection)
+		MATERIAL_VARIABLE_RETRIEVE(JitterOffset)
+		MATERIAL_VARIABLE_RETRIEVE(ScreenSize)
+		MATERIAL_VARIABLE_RETRIEVE(BlendFactor)
+		MATERIAL_VARIABLE_RETRIEVE(HistoryValid)
+		MATERIAL_VARIABLE_RETRIEVE(ColorTexture)
+		MATERIAL_VARIABLE_RETRIEVE(HistoryTexture)
+		MATERIAL_VARIABLE_RETRIEVE(DepthTexture)
+		MATERIAL_VARIABLE_RETRIEVE(VelocityTexture)
+		MATERIAL_VARIABLE_RETRIEVE(OutputVelocity)
+		MATERIAL_VARIABLE_RETRIEVE(OutputColor)
+
+		D3D11_INPUT_ELEMENT_DESC inputElementDescriptions[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+		};
+
+		CreateInputLayout("copy", "p0", inputElementDescriptions, ARRAYSIZE(inputElementDescriptions));
+	}
+
+	void TemporalAAMaterial::CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const
+	{
+		const std::vector<XMFLOAT3>& sourceVertices = mesh.Vertices();
+		std::vector<XMFLOAT3>* textureCoordinates = mesh.TextureCoordinates().at(0);
+		assert(textureCoordinates->size() == sourceVertices.size());
+
+		std::vector<VertexPositionTexture> vertices;
+		vertices.reserve(sourceVertices.size());
+		for (UINT i = 0; i < sourceVertices.size(); i++)
+		{
+			XMFLOAT3 position = sourceVertices.at(i);
+			XMFLOAT3 uv = textureCoordinates->at(i);
+			vertices.push_back(VertexPositionTexture(XMFLOAT4(position.x, position.y, position.z, 1.0f), XMFLOAT2(uv.x, uv.y)));
+		}
+
+		CreateVertexBuffer(device, &vertices[0], vertices.size(), vertexBuffer);
+	}
+
+	void TemporalAAMaterial::CreateVertexBuffer(ID3D11Device* device, VertexPositionTexture* vertices, UINT vertexCount, ID3D11Buffer** vertexBuffer) const
+	{
+		D3D11_BUFFER_DESC vertexBufferDesc;
+		ZeroMemory(&vertexBufferDesc, sizeof(vertexBufferDesc));
+		vertexBufferDesc.ByteWidth = VertexSize() * vertexCount;
+		vertexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+
+		D3D11_SUBRESOURCE_DATA vertexSubResourceData;
+		ZeroMemory(&vertexSubResourceData, sizeof(vertexSubResourceData));
+		vertexSubResourceData.pSysMem = vertices;
+		if (FAILED(device->CreateBuffer(&vertexBufferDesc, &vertexSubResourceData, vertexBuffer)))
+		{
+			throw GameException("ID3D11Device::CreateBuffer() failed.");
+		}
+	}
+
+	UINT TemporalAAMaterial::VertexSize() const
+	{
+		return sizeof(VertexPositionTexture);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Common.h"
+#include "Material.h"
+#include "VertexDeclarations.h"
+
+namespace Library
+{
+	class TemporalAAMaterial : public Material
+	{
+		RTTI_DECLARATIONS(TemporalAAMaterial, Material)
+
+		MATERIAL_VARIABLE_DECLARATION(Reprojection)
+		MATERIAL_VARIABLE_DECLARATION(JitterOffset)
+		MATERIAL_VARIABLE_DECLARATION(ScreenSize)
+		MATERIAL_VARIABLE_DECLARATION(BlendFactor)
+		MATERIAL_VARIABLE_DECLARATION(HistoryValid)
+		MATERIAL_VARIABLE_DECLARATION(ColorTexture)
+		MATERIAL_VARIABLE_DECLARATION(HistoryTexture)
+		MATERIAL_VARIABLE_DECLARATION(DepthTexture)
+		MATERIAL_VARIABLE_DECLARATION(VelocityTexture)
+		MATERIAL_VARIABLE_DECLARATION(OutputVelocity)
+		MATERIAL_VARIABLE_DECLARATION(OutputColor)
+
+	public:
+		TemporalAAMaterial();
+
+		virtual void Initialize(Effect& effect) override;
+		virtual void CreateVertexBuffer(ID3D11Device* device, const Mesh& mesh, ID3D11Buffer** vertexBuffer) const override;
+		void CreateVertexBuffer(ID3D11Device* device, VertexPositionTexture* vertices, UINT vertexCount, ID3D11Buffer** vertexBuffer) const;
+		virtual UINT VertexSize() const override;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "TemporalAAReference.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <xmmintrin.h>
+
+namespace Library
+{
+	const TemporalAASettings TemporalAAReference::DefaultSettings = { 0.1f, 8 };
+
+	namespace
+	{
+		inline __m128 LoadTexel(const PostProcessImage& image, int x, int y)
+		{
+			x = std::min(std::max(x, 0), static_cast<int>(image.Width) - 1);
+			y = std::min(std::max(y, 0), static_cast<int>(image.Height) - 1);
+
+			return _mm_loadu_ps(&image.Texels[(static_cast<size_t>(y) * image.Width + x) * 4]);
+		}
+
+		// Clamped bilinear fetch at a texture coordinate, as BilinearClampSampler does it
+		__m128 SampleBilinear(const PostProcessImage& image, float u, float v)
+		{
+			u = u * image.Width - 0.5f;
+			v = v * image.Height - 0.5f;
+			float floorU = std::floor(u);
+			float floorV = std::floor(v);
+			int x = static_cast<int>(floorU);
+			int y = static_cast<int>(floorV);
+			__m128 fractionU = _mm_set1_ps(u - floorU);
+			__m128 fractionV = _mm_set1_ps(v - floorV);
+
+			__m128 top = LoadTexel(image, x, y);
+			top = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(LoadTexel(image, x + 1, y), top), fractionU));
+			__m128 bottom = LoadTexel(image, x, y + 1);
+			bottom = _mm_add_ps(bottom, _mm_mul_ps(_mm_sub_ps(LoadTexel(image, x + 1, y + 1), bottom), fractionU));
+
+			return _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), fractionV));
+		}
+	}
+
+	void TemporalAAReference::JitterOffset(unsigned int frame, unsigned int sampleCount, float& x, float& y)
+	{
+		assert(sampleCount > 0);
+
+		// Index 0 of both sequences is zero, so start at 1 to keep every sample off the pixel centre's axes
+		unsigned int index = frame % sampleCount + 1;
+		x = Halton(index, 2) - 0.5f;
+		y = Halton(index, 3) - 0.5f;
+	}
+
+	float TemporalAAReference::Halton(unsigned int index, unsigned int base)
+	{
+		float result = 0.0f;
+		float fraction = 1.0f / base;
+		for (; index > 0; index /= base)
+		{
+			result += (index % base) * fraction;
+			fraction /= base;
+		}
+
+		return result;
+	}
+
+	void TemporalAAReference::ComputeVelocity(const std::vector<float>& depth, unsigned int width, unsigned int height, const float* reprojectionMatrix,
+		float jitterX, float jitterY, TemporalAAVelocity& velocity)
+	{
+		assert(depth.size() == static_cast<size_t>(width) * height);
+
+		velocity.Width = width;
+		velocity.Height = height;
+		velocity.Texels.resize(static_cast<size_t>(width) * height * 2);
+
+		float jitterU = jitterX / width;
+		float jitterV = jitterY / height;
+
+		for (unsigned int y = 0; y < height; y++)
+		{
+			for (unsigned int x = 0; x < width; x++)
+			{
+				size_t index = static_cast<size_t>(y) * width + x;
+				float u = (x + 0.5f) / width;
+				float v = (y + 0.5f) / height;
+				float position[4] = { u * 2.0f - 1.0f, 1.0f - v * 2.0f, depth[index], 1.0f };
+
+				float clip[4];
+				for (int i = 0; i < 4; i++)
+				{
+					clip[i] = position[0] * reprojectionMatrix[i] + position[1] * reprojectionMatrix[4 + i] + position[2] * reprojectionMatrix[8 + i] + position[3] * reprojectionMatrix[12 + i];
+				}
+
+				float previousU = clip[0] / clip[3] * 0.5f + 0.5f;
+				float previousV = 0.5f - clip[1] / clip[3] * 0.5f;
+
+				velocity.Texels[index * 2] = (u - jitterU) - previousU;
+				velocity.Texels[index * 2 + 1] = (v - jitterV) - previousV;
+			}
+		}
+	}
+
+	void TemporalAAReference::Resolve(const PostProcessImage& current, const PostProcessImage& history, const TemporalAAVelocity& velocity,
+		const TemporalAASettings& settings, PostProcessImage& output)
+	{
+		assert(velocity.Width == current.Width && velocity.Height == current.Height);
+
+		PostProcessReference::ResizeImage(output, current.Width, current.Height);
+
+		bool isHistoryValid = (history.Width > 0 && history.Height > 0);
+		__m128 blendFactor = _mm_set1_ps(settings.BlendFactor);
+
+		for (unsigned int y = 0; y < current.Height; y++)
+		{
+			for (unsigned int x = 0; x < current.Width; x++)
+			{
+				size_t index = static_cast<size_t>(y) * current.Width + x;
+				__m128 color = LoadTexel(current, x, y);
+
+				float u = (x + 0.5f) / current.Width - velocity.Texels[index * 2];
+				float v = (y + 0.5f) / current.Height - velocity.Texels[index * 2 + 1];
+				if (isHistoryValid == false || u < 0.0f || u > 1.0f || v < 0.0f || v > 1.0f)
+				{
+					_mm_storeu_ps(&output.Texels[index * 4], color);
+					continue;
+				}
+
+				__m128 minimum = color;
+				__m128 maximum = color;
+				for (int offsetY = -1; offsetY <= 1; offsetY++)
+				{
+					for (int offsetX = -1; offsetX <= 1; offsetX++)
+					{
+						__m128 neighbour = LoadTexel(current, x + offsetX, y + offsetY);
+						minimum = _mm_min_ps(minimum, neighbour);
+						maximum = _mm_max_ps(maximum, neighbour);
+					}
+				}
+
+				__m128 previousColor = _mm_min_ps(_mm_max_ps(SampleBilinear(history, u, v), minimum), maximum);
+				_mm_storeu_ps(&output.Texels[index * 4], _mm_add_ps(previousColor, _mm_mul_ps(_mm_sub_ps(color, previousColor), blendFactor)));
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "PostProcessReference.h"
+
+namespace Library
+{
+	typedef struct _TemporalAASettings
+	{
+		// Weight of the current frame; the history keeps the rest
+		float BlendFactor;
+		unsigned int JitterSampleCount;
+	} TemporalAASettings;
+
+	// Two floats per texel: this frame's unjittered texture coordinate minus last frame's, rows top to bottom
+	typedef struct _TemporalAAVelocity
+	{
+		unsigned int Width;
+		unsigned int Height;
+		std::vector<float> Texels;
+	} TemporalAAVelocity;
+
+	// CPU version of TemporalAA.fx: the jitter sequence, camera velocity from depth and the history resolve
+	class TemporalAAReference
+	{
+	public:
+		// Halton(2, 3) offsets in pixels within [-0.5, 0.5), repeating every sampleCount frames
+		static void JitterOffset(unsigned int frame, unsigned int sampleCount, float& x, float& y);
+		static float Halton(unsigned int index, unsigned int base);
+
+		// reprojectionMatrix takes this frame's jittered NDC to last frame's unjittered clip space (row vectors, as
+		// XMFLOAT4X4); jitter is in pixels, as passed to Camera::SetProjectionJitter()
+		static void ComputeVelocity(const std::vector<float>& depth, unsigned int width, unsigned int height, const float* reprojectionMatrix,
+			float jitterX, float jitterY, TemporalAAVelocity& velocity);
+
+		// Clamps the reprojected history to the current frame's 3x3 neighbourhood and blends the two. An empty
+		// history, or a texel whose history lies off screen, takes the current frame unchanged.
+		static void Resolve(const PostProcessImage& current, const PostProcessImage& history, const TemporalAAVelocity& velocity,
+			const TemporalAASettings& settings, PostProcessImage& output);
+
+		static const TemporalAASettings DefaultSettings;
+
+	private:
+		TemporalAAReference();
+		TemporalAAReference(const TemporalAAReference& rhs);
+		TemporalAAReference& operator=(const TemporalAAReference& rhs);
+	};
+}
\ No newline at end of file
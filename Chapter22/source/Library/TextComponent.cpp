@@ -0,0 +1,116 @@
+#include "TextComponent.h"
+#include "Game.h"
+#include "GameException.h"
+#include "ContentManager.h"
+#include "SpriteRenderer.h"
+#include "TextFont.h"
+#include "Utility.h"
+#include <stdexcept>
+
+namespace Library
+{
+	RTTI_DEFINITIONS(TextComponent)
+
+	const UINT TextComponent::RendererCapacity = 1024;
+
+	TextComponent::TextComponent(Game& game, const std::wstring& fontFilename)
+		: DrawableGameComponent(game), mFontFilename(fontFilename), mFont(), mRenderer(nullptr), mText(), mRun(),
+		  mPosition(0.0f, 0.0f), mColor(1.0f, 1.0f, 1.0f, 1.0f), mScale(1.0f), mIsLayoutDirty(false), mLayoutCount(0)
+	{
+		mRun.Width = 0.0f;
+		mRun.Height = 0.0f;
+	}
+
+	TextComponent::~TextComponent()
+	{
+		DeleteObject(mRenderer);
+	}
+
+	const std::wstring& TextComponent::Text() const
+	{
+		return mText;
+	}
+
+	bool TextComponent::SetText(const wchar_t* text)
+	{
+		if (mText == text)
+		{
+			return false;
+		}
+
+		mText.assign(text);
+		mIsLayoutDirty = true;
+
+		return true;
+	}
+
+	XMFLOAT2& TextComponent::Position()
+	{
+		return mPosition;
+	}
+
+	XMFLOAT4& TextComponent::Color()
+	{
+		return mColor;
+	}
+
+	float TextComponent::Scale() const
+	{
+		return mScale;
+	}
+
+	void TextComponent::SetScale(float scale)
+	{
+		if (scale != mScale)
+		{
+			mScale = scale;
+			mIsLayoutDirty = true;
+		}
+	}
+
+	const TextRun& TextComponent::Run() const
+	{
+		return mRun;
+	}
+
+	UINT TextComponent::LayoutCount() const
+	{
+		return mLayoutCount;
+	}
+
+	void TextComponent::Initialize()
+	{
+		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
+
+		mFont = mGame->Content().LoadFont(mFontFilename);
+		mRenderer = new SpriteRenderer(*mGame, RendererCapacity);
+	}
+
+	void TextComponent::Draw(const GameTime& gameTime)
+	{
+		if (mIsLayoutDirty)
+		{
+			try
+			{
+				TextLayout::Build(mFont->Glyphs(), mText.c_str(), mScale, mRun);
+			}
+			catch (std::runtime_error& ex)
+			{
+				const char* message = ex.what();
+				throw GameException(message);
+			}
+
+			mIsLayoutDirty = false;
+			mLayoutCount++;
+		}
+
+		if (mRun.Glyphs.empty())
+		{
+			return;
+		}
+
+		mRenderer->Begin();
+		mRenderer->DrawString(*mFont, mRun, mPosition, XMLoadFloat4(&mColor));
+		mRenderer->End();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "DrawableGameComponent.h"
+#include "TextLayout.h"
+
+namespace Library
+{
+	class SpriteRenderer;
+	class TextFont;
+
+	// A label drawn with SpriteRenderer. SetText() compares the new text with the current one and lays it out again
+	// only when it differs, so a label set every frame to the same text costs a string compare and its glyph quads.
+	class TextComponent : public DrawableGameComponent
+	{
+		RTTI_DECLARATIONS(TextComponent, DrawableGameComponent)
+
+	public:
+		TextComponent(Game& game, const std::wstring& fontFilename = L"Content\\Fonts\\Arial_14_Regular.spritefont");
+		~TextComponent();
+
+		const std::wstring& Text() const;
+
+		// Returns true if the text changed
+		bool SetText(const wchar_t* text);
+
+		XMFLOAT2& Position();
+		XMFLOAT4& Color();
+
+		float Scale() const;
+		void SetScale(float scale);
+
+		// The measured size, once the text has been laid out
+		const TextRun& Run() const;
+
+		// Layouts built so far, for checking that a label isn't rebuilt every frame
+		UINT LayoutCount() const;
+
+		virtual void Initialize() override;
+		virtual void Draw(const GameTime& gameTime) override;
+
+	private:
+		TextComponent();
+		TextComponent(const TextComponent& rhs);
+		TextComponent& operator=(const TextComponent& rhs);
+
+		static const UINT RendererCapacity;
+
+		std::wstring mFontFilename;
+		std::shared_ptr<TextFont> mFont;
+		SpriteRenderer* mRenderer;
+		std::wstring mText;
+		TextRun mRun;
+		XMFLOAT2 mPosition;
+		XMFLOAT4 mColor;
+		float mScale;
+		bool mIsLayoutDirty;
+		UINT mLayoutCount;
+	};
+}
\ No newline at end of file
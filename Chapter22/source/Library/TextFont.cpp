@@ -0,0 +1,83 @@
+#include "TextFont.h"
+#include "Game.h"
+#include "GameException.h"
+#include "MappedFile.h"
+#include "SpriteFontFile.h"
+#include <stdexcept>
+
+namespace Library
+{
+	TextFont::TextFont(Game& game, const std::wstring& filename)
+		: mGlyphs(), mTexture(nullptr), mDistanceFieldSize(0.0f)
+	{
+		SpriteFontData font;
+		try
+		{
+			MappedFile file;
+			file.Open(filename);
+			SpriteFontFile::Read(file.Data(), static_cast<size_t>(file.Size()), font);
+			mGlyphs.Build(font.Glyphs, font.DefaultCharacter, font.LineSpacing, font.TextureWidth, font.TextureHeight);
+			mDistanceFieldSize = font.DistanceFieldSize;
+		}
+		catch (std::runtime_error& ex)
+		{
+			const char* message = ex.what();
+			throw GameException(message);
+		}
+
+		D3D11_TEXTURE2D_DESC textureDesc;
+		ZeroMemory(&textureDesc, sizeof(textureDesc));
+		textureDesc.Width = font.TextureWidth;
+		textureDesc.Height = font.TextureHeight;
+		textureDesc.MipLevels = 1;
+		textureDesc.ArraySize = 1;
+		textureDesc.Format = static_cast<DXGI_FORMAT>(font.TextureFormat);
+		textureDesc.SampleDesc.Count = 1;
+		textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
+		textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+		D3D11_SUBRESOURCE_DATA subResourceData;
+		ZeroMemory(&subResourceData, sizeof(subResourceData));
+		subResourceData.pSysMem = &font.TextureData[0];
+		subResourceData.SysMemPitch = font.TextureStride;
+
+		HRESULT hr;
+		ID3D11Texture2D* texture = nullptr;
+		if (FAILED(hr = game.Direct3DDevice()->CreateTexture2D(&textureDesc, &subResourceData, &texture)))
+		{
+			throw GameException("ID3D11Device::CreateTexture2D() failed.", hr);
+		}
+
+		hr = game.Direct3DDevice()->CreateShaderResourceView(texture, nullptr, &mTexture);
+		ReleaseObject(texture);
+		if (FAILED(hr))
+		{
+			throw GameException("ID3D11Device::CreateShaderResourceView() failed.", hr);
+		}
+	}
+
+	TextFont::~TextFont()
+	{
+		ReleaseObject(mTexture);
+	}
+
+	const GlyphTable& TextFont::Glyphs() const
+	{
+		return mGlyphs;
+	}
+
+	ID3D11ShaderResourceView* TextFont::Texture() const
+	{
+		return mTexture;
+	}
+
+	bool TextFont::IsDistanceField() const
+	{
+		return (mDistanceFieldSize > 0.0f);
+	}
+
+	float TextFont::Size() const
+	{
+		return mDistanceFieldSize;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Common.h"
+#include "GlyphTable.h"
+
+namespace Library
+{
+	class Game;
+
+	// A .spritefont for SpriteRenderer::DrawString(): the font texture, and its glyphs in a GlyphTable rather than the
+	// sorted vector SpriteFont searches for every character. Load it through ContentManager::LoadFont() to share it.
+	// FontTool's distance field fonts load the same way; Size() is the pixel size their metrics are in, 0 for bitmap
+	// fonts, so a scale of desired size / Size() draws them at any size.
+	class TextFont
+	{
+	public:
+		TextFont(Game& game, const std::wstring& filename);
+		~TextFont();
+
+		const GlyphTable& Glyphs() const;
+		ID3D11ShaderResourceView* Texture() const;
+		bool IsDistanceField() const;
+		float Size() const;
+
+	private:
+		TextFont();
+		TextFont(const TextFont& rhs);
+		TextFont& operator=(const TextFont& rhs);
+
+		GlyphTable mGlyphs;
+		ID3D11ShaderResourceView* mTexture;
+		float mDistanceFieldSize;
+	};
+}
\ No newline at end of file
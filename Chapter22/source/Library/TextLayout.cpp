@@ -0,0 +1,201 @@
+#include "TextLayout.h"
+#include <algorithm>
+#include <cstring>
+#include <cwctype>
+#include <stdexcept>
+
+namespace Library
+{
+	const unsigned int TextLayoutCache::DefaultCapacity = 256;
+
+	namespace
+	{
+		const unsigned long long Fnv1aOffsetBasis = 14695981039346656037ULL;
+		const unsigned long long Fnv1aPrime = 1099511628211ULL;
+
+		unsigned long long Fnv1a(unsigned long long value, unsigned long long hash)
+		{
+			for (unsigned int i = 0; i < 8; i++)
+			{
+				hash = (hash ^ ((value >> (i * 8)) & 0xFF)) * Fnv1aPrime;
+			}
+
+			return hash;
+		}
+	}
+
+	void TextLayout::Build(const GlyphTable& font, const wchar_t* text, float scale, TextRun& run)
+	{
+		float textureWidth = static_cast<float>(std::max(font.TextureWidth(), 1U));
+		float textureHeight = static_cast<float>(std::max(font.TextureHeight(), 1U));
+		float x = 0.0f;
+		float y = 0.0f;
+		float width = 0.0f;
+		float height = 0.0f;
+
+		run.Glyphs.clear();
+		for (; *text != L'\0'; text++)
+		{
+			unsigned int character = static_cast<unsigned int>(*text);
+			if (character == L'\r')
+			{
+				continue;
+			}
+
+			if (character == L'\n')
+			{
+				x = 0.0f;
+				y += font.LineSpacing();
+				continue;
+			}
+
+			unsigned int next = static_cast<unsigned int>(text[1]);
+			if (character >= 0xD800 && character < 0xDC00 && next >= 0xDC00 && next < 0xE000)
+			{
+				character = 0x10000 + ((character - 0xD800) << 10) + (next - 0xDC00);
+				text++;
+			}
+
+			const Glyph* glyph = font.Find(character);
+			if (glyph == nullptr)
+			{
+				throw std::runtime_error("The character is not in the font.");
+			}
+
+			x = std::max(x + glyph->XOffset, 0.0f);
+			float glyphWidth = static_cast<float>(glyph->Subrect[2] - glyph->Subrect[0]);
+			float glyphHeight = static_cast<float>(glyph->Subrect[3] - glyph->Subrect[1]);
+
+			if (iswspace(static_cast<wint_t>(character)) == 0)
+			{
+				Sprite sprite;
+				memset(&sprite, 0, sizeof(sprite));
+				sprite.Destination[0] = x * scale;
+				sprite.Destination[1] = (y + glyph->YOffset) * scale;
+				sprite.Destination[2] = glyphWidth * scale;
+				sprite.Destination[3] = glyphHeight * scale;
+				sprite.Source[0] = glyph->Subrect[0] / textureWidth;
+				sprite.Source[1] = glyph->Subrect[1] / textureHeight;
+				sprite.Source[2] = glyph->Subrect[2] / textureWidth;
+				sprite.Source[3] = glyph->Subrect[3] / textureHeight;
+				sprite.Color = 0xFFFFFFFF;
+				run.Glyphs.push_back(sprite);
+
+				width = std::max(width, x + glyphWidth);
+				height = std::max(height, y + std::max(glyphHeight + glyph->YOffset, font.LineSpacing()));
+			}
+
+			x += glyphWidth + glyph->XAdvance;
+		}
+
+		run.Width = width * scale;
+		run.Height = height * scale;
+	}
+
+	TextLayoutCache::TextLayoutCache(unsigned int capacity)
+		: mEntries(), mEntryIndices(), mCapacity(std::max(capacity, 1U)), mUseCount(0), mHitCount(0), mMissCount(0)
+	{
+		mEntries.reserve(mCapacity);
+	}
+
+	const TextRun& TextLayoutCache::Find(const GlyphTable& font, const wchar_t* text, float scale)
+	{
+		unsigned long long key = Key(font, text, scale);
+		mUseCount++;
+
+		auto it = mEntryIndices.find(key);
+		if (it != mEntryIndices.end())
+		{
+			Entry& entry = mEntries[it->second];
+			if (entry.Font == &font && entry.Scale == scale && entry.Text == text)
+			{
+				entry.LastUse = mUseCount;
+				mHitCount++;
+
+				return entry.Run;
+			}
+		}
+
+		// A colliding key takes over its entry; otherwise grow, or reuse the least recently used entry
+		unsigned int index;
+		if (it != mEntryIndices.end())
+		{
+			index = it->second;
+		}
+		else if (mEntries.size() < mCapacity)
+		{
+			index = static_cast<unsigned int>(mEntries.size());
+			mEntries.push_back(Entry());
+			mEntryIndices[key] = index;
+		}
+		else
+		{
+			index = 0;
+			for (unsigned int i = 1; i < mEntries.size(); i++)
+			{
+				if (mEntries[i].LastUse < mEntries[index].LastUse)
+				{
+					index = i;
+				}
+			}
+
+			mEntryIndices.erase(mEntries[index].Key);
+			mEntryIndices[key] = index;
+		}
+
+		// Matches nothing until the layout succeeds
+		Entry& entry = mEntries[index];
+		entry.Key = key;
+		entry.Font = nullptr;
+		entry.LastUse = mUseCount;
+		mMissCount++;
+
+		TextLayout::Build(font, text, scale, entry.Run);
+		entry.Font = &font;
+		entry.Scale = scale;
+		entry.Text.assign(text);
+
+		return entry.Run;
+	}
+
+	void TextLayoutCache::Clear()
+	{
+		mEntries.clear();
+		mEntryIndices.clear();
+	}
+
+	unsigned int TextLayoutCache::Count() const
+	{
+		return static_cast<unsigned int>(mEntries.size());
+	}
+
+	unsigned int TextLayoutCache::Capacity() const
+	{
+		return mCapacity;
+	}
+
+	unsigned long long TextLayoutCache::HitCount() const
+	{
+		return mHitCount;
+	}
+
+	unsigned long long TextLayoutCache::MissCount() const
+	{
+		return mMissCount;
+	}
+
+	unsigned long long TextLayoutCache::Key(const GlyphTable& font, const wchar_t* text, float scale)
+	{
+		unsigned int scaleBits;
+		memcpy(&scaleBits, &scale, sizeof(scaleBits));
+
+		unsigned long long hash = Fnv1a(reinterpret_cast<size_t>(&font), Fnv1aOffsetBasis);
+		hash = Fnv1a(scaleBits, hash);
+		for (; *text != L'\0'; text++)
+		{
+			hash = (hash ^ static_cast<unsigned long long>(*text)) * Fnv1aPrime;
+		}
+
+		return hash;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+// Portable, like GlyphTable: layouts are built and cached without a device
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "GlyphTable.h"
+#include "SpriteQueue.h"
+
+namespace Library
+{
+	// A string's glyph quads, ready for SpriteRenderer: destinations in pixels from the text's top left, sources in
+	// the font texture's coordinates. Width and Height are the string's measured size.
+	typedef struct _TextRun
+	{
+		std::vector<Sprite> Glyphs;
+		float Width;
+		float Height;
+	} TextRun;
+
+	// Lays text out as SpriteFont::DrawString does: '\r' is skipped, '\n' starts a new line, whitespace advances without
+	// a quad, and surrogate pairs are decoded to the characters beyond the Basic Multilingual Plane
+	class TextLayout
+	{
+	public:
+		// Throws std::runtime_error for a character the font has no glyph for, as SpriteFont does
+		static void Build(const GlyphTable& font, const wchar_t* text, float scale, TextRun& run);
+
+	private:
+		TextLayout();
+		TextLayout(const TextLayout& rhs);
+		TextLayout& operator=(const TextLayout& rhs);
+	};
+
+	// Keeps the runs of recently drawn strings, keyed by string, font and scale, so text that doesn't change between
+	// frames is laid out once. A hit hashes and compares the string, without allocating; when the cache is full a miss
+	// reuses the least recently used entry. Fonts are keyed by address, so Clear() the cache when one is released.
+	class TextLayoutCache
+	{
+	public:
+		TextLayoutCache(unsigned int capacity = DefaultCapacity);
+
+		// The run stays valid until the next Find() or Clear()
+		const TextRun& Find(const GlyphTable& font, const wchar_t* text, float scale = 1.0f);
+		void Clear();
+
+		unsigned int Count() const;
+		unsigned int Capacity() const;
+		unsigned long long HitCount() const;
+		unsigned long long MissCount() const;
+
+		static const unsigned int DefaultCapacity;
+
+	private:
+		typedef struct _Entry
+		{
+			unsigned long long Key;
+			const GlyphTable* Font;
+			float Scale;
+			std::wstring Text;
+			TextRun Run;
+			unsigned long long LastUse;
+		} Entry;
+
+		TextLayoutCache(const TextLayoutCache& rhs);
+		TextLayoutCache& operator=(const TextLayoutCache& rhs);
+
+		static unsigned long long Key(const GlyphTable& font, const wchar_t* text, float scale);
+
+		std::vector<Entry> mEntries;
+		std::unordered_map<unsigned long long, unsigned int> mEntryIndices;
+		unsigned int mCapacity;
+		unsigned long long mUseCount;
+		unsigned long long mHitCount;
+		unsigned long long mMissCount;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include "TexturePacker.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace Library
+{
+	const TexturePackerSettings TexturePacker::DefaultSettings = { 2048, 8, 2048 };
+	const unsigned int TexturePacker::NotPacked = 0xFFFFFFFF;
+
+	void TexturePacker::Pack(const std::vector<PostProcessImage>& sources, TexturePackMode mode, TextureContent content, MipFilter filter, const TexturePackerSettings& settings,
+		std::vector<TexturePage>& pages, std::vector<TexturePlacement>& placements, ThreadPool* threadPool)
+	{
+		bool isGutterPowerOfTwo = (settings.Gutter > 0 && (settings.Gutter & (settings.Gutter - 1)) == 0);
+		if (mode >= TexturePackModeEnd || isGutterPowerOfTwo == false || settings.PageSize < settings.Gutter * 3 || settings.PageSize % settings.Gutter != 0 || settings.MaximumArraySize == 0)
+		{
+			throw std::runtime_error("Invalid texture packer settings.");
+		}
+
+		std::vector<std::vector<PostProcessImage>> mips(sources.size());
+		for (size_t i = 0; i < sources.size(); i++)
+		{
+			MipChain::Generate(sources[i], content, filter, mips[i], threadPool);
+		}
+
+		pages.clear();
+		placements.resize(sources.size());
+		for (TexturePlacement& placement : placements)
+		{
+			placement.Page = NotPacked;
+			placement.Slice = 0;
+			placement.ScaleOffset[0] = 1.0f;
+			placement.ScaleOffset[1] = 1.0f;
+			placement.ScaleOffset[2] = 0.0f;
+			placement.ScaleOffset[3] = 0.0f;
+		}
+
+		if (mode == TexturePackModeArray)
+		{
+			PackArrays(mips, settings, pages, placements);
+		}
+		else
+		{
+			PackAtlases(mips, settings, pages, placements);
+		}
+	}
+
+	unsigned int TexturePacker::AtlasMipCount(const TexturePackerSettings& settings)
+	{
+		unsigned int mipCount = 1;
+		while ((1U << (mipCount - 1)) < settings.Gutter)
+		{
+			mipCount++;
+		}
+
+		return std::min(mipCount, MipChain::MipCount(settings.PageSize, settings.PageSize));
+	}
+
+	void TexturePacker::WritePlacements(const std::string& filename, const std::vector<std::string>& names, const std::vector<TexturePlacement>& placements)
+	{
+		if (names.size() != placements.size())
+		{
+			throw std::runtime_error("Every texture placement needs a name.");
+		}
+
+		FILE* file = fopen(filename.c_str(), "w");
+		if (file == nullptr)
+		{
+			throw std::runtime_error("Could not create the texture placement file.");
+		}
+
+		bool isValid = true;
+		for (size_t i = 0; i < placements.size(); i++)
+		{
+			const TexturePlacement& placement = placements[i];
+			isValid = isValid && fprintf(file, "%s %d %u %.9g %.9g %.9g %.9g\n", names[i].c_str(), static_cast<int>(placement.Page), placement.Slice,
+				placement.ScaleOffset[0], placement.ScaleOffset[1], placement.ScaleOffset[2], placement.ScaleOffset[3]) > 0;
+		}
+
+		isValid = (fclose(file) == 0) && isValid;
+		if (isValid == false)
+		{
+			throw std::runtime_error("Could not write the texture placement file.");
+		}
+	}
+
+	void TexturePacker::ReadPlacements(const std::string& filename, std::vector<std::string>& names, std::vector<TexturePlacement>& placements)
+	{
+		FILE* file = fopen(filename.c_str(), "r");
+		if (file == nullptr)
+		{
+			throw std::runtime_error("Could not open the texture placement file.");
+		}
+
+		names.clear();
+		placements.clear();
+
+		char name[1024];
+		int page;
+		TexturePlacement placement;
+		int fieldCount;
+		while ((fieldCount = fscanf(file, "%1023s %d %u %f %f %f %f", name, &page, &placement.Slice,
+			&placement.ScaleOffset[0], &placement.ScaleOffset[1], &placement.ScaleOffset[2], &placement.ScaleOffset[3])) == 7)
+		{
+			placement.Page = static_cast<unsigned int>(page);
+			names.push_back(name);
+			placements.push_back(placement);
+		}
+
+		fclose(file);
+		if (fieldCount != EOF)
+		{
+			throw std::runtime_error("Invalid texture placement file.");
+		}
+	}
+
+	void TexturePacker::PackArrays(const std::vector<std::vector<PostProcessImage>>& mips, const TexturePackerSettings& settings, std::vector<TexturePage>& pages, std::vector<TexturePlacement>& placements)
+	{
+		// Textures of the same size share an array until it's full, in the order they were given
+		for (size_t i = 0; i < mips.size(); i++)
+		{
+			const PostProcessImage& source = mips[i][0];
+			unsigned int page = NotPacked;
+			for (unsigned int j = 0; j < pages.size(); j++)
+			{
+				if (pages[j].Width == source.Width && pages[j].Height == source.Height && pages[j].Slices.size() < settings.MaximumArraySize)
+				{
+					page = j;
+					break;
+				}
+			}
+
+			if (page == NotPacked)
+			{
+				TexturePage newPage;
+				newPage.Width = source.Width;
+				newPage.Height = source.Height;
+				pages.push_back(newPage);
+				page = static_cast<unsigned int>(pages.size() - 1);
+			}
+
+			placements[i].Page = page;
+			placements[i].Slice = static_cast<unsigned int>(pages[page].Slices.size());
+			pages[page].Slices.push_back(mips[i]);
+		}
+	}
+
+	void TexturePacker::PackAtlases(const std::vector<std::vector<PostProcessImage>>& mips, const TexturePackerSettings& settings, std::vector<TexturePage>& pages, std::vector<TexturePlacement>& placements)
+	{
+		unsigned int gutter = settings.Gutter;
+		unsigned int mipCount = AtlasMipCount(settings);
+
+		// Tallest first onto shelves; every padded size is a multiple of the gutter, so every rectangle stays aligned to it
+		std::vector<unsigned int> order;
+		for (unsigned int i = 0; i < mips.size(); i++)
+		{
+			const PostProcessImage& source = mips[i][0];
+			if (source.Width % gutter == 0 && source.Height % gutter == 0 && source.Width + gutter * 2 <= settings.PageSize && source.Height + gutter * 2 <= settings.PageSize)
+			{
+				order.push_back(i);
+			}
+		}
+
+		std::stable_sort(order.begin(), order.end(), [&mips](unsigned int lhs, unsigned int rhs)
+		{
+			const PostProcessImage& left = mips[lhs][0];
+			const PostProcessImage& right = mips[rhs][0];
+			return (left.Height != right.Height ? left.Height > right.Height : left.Width > right.Width);
+		});
+
+		std::vector<unsigned int> positions(mips.size() * 2);
+		unsigned int shelfX = 0;
+		unsigned int shelfY = 0;
+		unsigned int shelfHeight = 0;
+		for (unsigned int i : order)
+		{
+			unsigned int width = mips[i][0].Width + gutter * 2;
+			unsigned int height = mips[i][0].Height + gutter * 2;
+
+			if (shelfX + width > settings.PageSize)
+			{
+				shelfX = 0;
+				shelfY += shelfHeight;
+				shelfHeight = 0;
+			}
+
+			if (pages.empty() || shelfY + height > settings.PageSize)
+			{
+				TexturePage page;
+				page.Width = 0;
+				page.Height = 0;
+				page.Slices.resize(1);
+				pages.push_back(page);
+				shelfX = 0;
+				shelfY = 0;
+				shelfHeight = 0;
+			}
+
+			TexturePage& page = pages.back();
+			placements[i].Page = static_cast<unsigned int>(pages.size() - 1);
+			positions[i * 2] = shelfX;
+			positions[i * 2 + 1] = shelfY;
+
+			shelfX += width;
+			shelfHeight = std::max(shelfHeight, height);
+			page.Width = std::max(page.Width, shelfX);
+			page.Height = std::max(page.Height, shelfY + height);
+		}
+
+		for (TexturePage& page : pages)
+		{
+			page.Slices[0].resize(mipCount);
+			for (unsigned int mip = 0; mip < mipCount; mip++)
+			{
+				PostProcessReference::ResizeImage(page.Slices[0][mip], page.Width >> mip, page.Height >> mip);
+				std::fill(page.Slices[0][mip].Texels.begin(), page.Slices[0][mip].Texels.end(), 0.0f);
+			}
+		}
+
+		for (unsigned int i : order)
+		{
+			TexturePlacement& placement = placements[i];
+			TexturePage& page = pages[placement.Page];
+			for (unsigned int mip = 0; mip < mipCount; mip++)
+			{
+				CopyWithGutter(mips[i][mip], positions[i * 2] >> mip, positions[i * 2 + 1] >> mip, gutter >> mip, page.Slices[0][mip]);
+			}
+
+			placement.ScaleOffset[0] = static_cast<float>(mips[i][0].Width) / page.Width;
+			placement.ScaleOffset[1] = static_cast<float>(mips[i][0].Height) / page.Height;
+			placement.ScaleOffset[2] = static_cast<float>(positions[i * 2] + gutter) / page.Width;
+			placement.ScaleOffset[3] = static_cast<float>(positions[i * 2 + 1] + gutter) / page.Height;
+		}
+	}
+
+	void TexturePacker::CopyWithGutter(const PostProcessImage& source, unsigned int x, unsigned int y, unsigned int gutter, PostProcessImage& destination)
+	{
+		// The gutter repeats the nearest edge texel, as a clamped sampler would read it
+		for (unsigned int row = 0; row < source.Height + gutter * 2; row++)
+		{
+			unsigned int sourceRow = std::min(static_cast<unsigned int>(std::max(static_cast<int>(row) - static_cast<int>(gutter), 0)), source.Height - 1);
+			const float* sourceTexels = &source.Texels[static_cast<size_t>(sourceRow) * source.Width * 4];
+			float* destinationTexels = &destination.Texels[(static_cast<size_t>(y + row) * destination.Width + x) * 4];
+
+			for (unsigned int column = 0; column < gutter; column++)
+			{
+				memcpy(&destinationTexels[column * 4], &sourceTexels[0], sizeof(float) * 4);
+				memcpy(&destinationTexels[(gutter + source.Width + column) * 4], &sourceTexels[(source.Width - 1) * 4], sizeof(float) * 4);
+			}
+
+			memcpy(&destinationTexels[gutter * 4], sourceTexels, sizeof(float) * 4 * source.Width);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "MipChain.h"
+#include <string>
+
+namespace Library
+{
+	class ThreadPool;
+
+	enum TexturePackMode
+	{
+		TexturePackModeArray = 0,
+		TexturePackModeAtlas,
+		TexturePackModeEnd
+	};
+
+	typedef struct _TexturePackerSettings
+	{
+		unsigned int PageSize;
+		unsigned int Gutter;
+		unsigned int MaximumArraySize;
+	} TexturePackerSettings;
+
+	// A texture array or an atlas; an atlas is a single slice. Slices[slice][mip], every slice with the same mip count.
+	typedef struct _TexturePage
+	{
+		unsigned int Width;
+		unsigned int Height;
+		std::vector<std::vector<PostProcessImage>> Slices;
+	} TexturePage;
+
+	// Where a source texture ended up. Packed UVs are uv * (ScaleOffset[0], ScaleOffset[1]) + (ScaleOffset[2], ScaleOffset[3]).
+	typedef struct _TexturePlacement
+	{
+		unsigned int Page;
+		unsigned int Slice;
+		float ScaleOffset[4];
+	} TexturePlacement;
+
+	// Combines small textures so draws that differ only by texture can share one binding. Arrays group textures of the
+	// same size, one per slice, with complete mip chains; a draw selects its slice per instance. Atlases pack textures of
+	// any size onto shelves, each surrounded by a gutter of its own edge texels. Every rectangle is aligned to the gutter,
+	// so the first log2(Gutter) + 1 mips are filtered from each texture alone and never bleed into their neighbours;
+	// atlases stop there. Atlased texture coordinates must stay within [0, 1], since the gutters can't wrap.
+	class TexturePacker
+	{
+	public:
+		// Sources have channels in [0, 1]. In an atlas, textures that don't fit a page or whose sizes aren't multiples of
+		// the gutter are left out, with their placement's Page set to NotPacked. Throws std::runtime_error for bad settings.
+		static void Pack(const std::vector<PostProcessImage>& sources, TexturePackMode mode, TextureContent content, MipFilter filter, const TexturePackerSettings& settings,
+			std::vector<TexturePage>& pages, std::vector<TexturePlacement>& placements, ThreadPool* threadPool = nullptr);
+
+		static unsigned int AtlasMipCount(const TexturePackerSettings& settings);
+
+		// One line per texture: its name, page, slice and scale and offset. Names can't contain whitespace.
+		static void WritePlacements(const std::string& filename, const std::vector<std::string>& names, const std::vector<TexturePlacement>& placements);
+		static void ReadPlacements(const std::string& filename, std::vector<std::string>& names, std::vector<TexturePlacement>& placements);
+
+		static const TexturePackerSettings DefaultSettings;
+		static const unsigned int NotPacked;
+
+	private:
+		TexturePacker();
+		TexturePacker(const TexturePacker& rhs);
+		TexturePacker& operator=(const TexturePacker& rhs);
+
+		static void PackArrays(const std::vector<std::vector<PostProcessImage>>& mips, const TexturePackerSettings& settings, std::vector<TexturePage>& pages, std::vector<TexturePlacement>& placements);
+		static void PackAtlases(const std::vector<std::vector<PostProcessImage>>& mips, const TexturePackerSettings& settings, std::vector<TexturePage>& pages, std::vector<TexturePlacement>& placements);
+		static void CopyWithGutter(const PostProcessImage& source, unsigned int x, unsigned int y, unsigned int gutter, PostProcessImage& destination);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,355 @@
+#include "TextureResidency.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace Library
+{
+	const TextureResidencySettings TextureResidency::DefaultSettings = { 256ULL * 1024 * 1024, 8ULL * 1024 * 1024, 64, 60 };
+
+	namespace
+	{
+		const unsigned int NoTexture = 0xFFFFFFFF;
+		const float NoRequest = 1e30f;
+	}
+
+	TextureResidency::TextureResidency(const TextureResidencySettings& settings)
+		: mSettings(settings), mTextures(), mFreeTextures(), mChanges(), mStatistics(), mFrame(1), mFieldOfView(0.785398f), mScreenHeight(768)
+	{
+		memset(&mStatistics, 0, sizeof(mStatistics));
+	}
+
+	const TextureResidencySettings& TextureResidency::Settings() const
+	{
+		return mSettings;
+	}
+
+	void TextureResidency::SetSettings(const TextureResidencySettings& settings)
+	{
+		mSettings = settings;
+	}
+
+	unsigned int TextureResidency::AddTexture(unsigned int width, unsigned int height, const std::vector<unsigned long long>& mipSizes)
+	{
+		if (width == 0 || height == 0 || mipSizes.empty())
+		{
+			throw std::runtime_error("Invalid texture description.");
+		}
+
+		Texture texture;
+		texture.IsActive = true;
+		texture.Width = width;
+		texture.MipSizes = mipSizes;
+		texture.PinnedMip = static_cast<unsigned int>(mipSizes.size() - 1);
+		for (unsigned int mip = 0; mip < mipSizes.size(); mip++)
+		{
+			if (std::max(width >> mip, 1U) <= mSettings.PinnedMipSize && std::max(height >> mip, 1U) <= mSettings.PinnedMipSize)
+			{
+				texture.PinnedMip = mip;
+				break;
+			}
+		}
+
+		texture.ResidentMip = texture.PinnedMip;
+		texture.WantedMip = texture.PinnedMip;
+		texture.PreviousMip = texture.PinnedMip;
+		texture.RequestedMip = NoRequest;
+		texture.LastRequestFrame = 0;
+
+		if (mFreeTextures.empty())
+		{
+			mTextures.push_back(texture);
+			return static_cast<unsigned int>(mTextures.size() - 1);
+		}
+
+		unsigned int index = mFreeTextures.back();
+		mFreeTextures.pop_back();
+		mTextures[index] = texture;
+
+		return index;
+	}
+
+	void TextureResidency::RemoveTexture(unsigned int texture)
+	{
+		assert(mTextures.at(texture).IsActive);
+
+		mTextures[texture].IsActive = false;
+		mTextures[texture].MipSizes.clear();
+		mFreeTextures.push_back(texture);
+	}
+
+	unsigned int TextureResidency::ResidentMip(unsigned int texture) const
+	{
+		return mTextures.at(texture).ResidentMip;
+	}
+
+	unsigned int TextureResidency::WantedMip(unsigned int texture) const
+	{
+		return mTextures.at(texture).WantedMip;
+	}
+
+	unsigned int TextureResidency::PinnedMip(unsigned int texture) const
+	{
+		return mTextures.at(texture).PinnedMip;
+	}
+
+	void TextureResidency::Request(unsigned int texture, float mip)
+	{
+		Texture& requested = mTextures.at(texture);
+		if (requested.LastRequestFrame != mFrame)
+		{
+			requested.LastRequestFrame = mFrame;
+			requested.RequestedMip = mip;
+		}
+		else
+		{
+			requested.RequestedMip = std::min(requested.RequestedMip, mip);
+		}
+	}
+
+	void TextureResidency::RequestSurface(unsigned int texture, float worldUnitsPerUV, float distance)
+	{
+		Request(texture, RequiredMip(worldUnitsPerUV, distance, mTextures.at(texture).Width, mFieldOfView, mScreenHeight));
+	}
+
+	void TextureResidency::SetView(float fieldOfView, unsigned int screenHeight)
+	{
+		mFieldOfView = fieldOfView;
+		mScreenHeight = screenHeight;
+	}
+
+	const std::vector<TextureResidencyChange>& TextureResidency::Update()
+	{
+		mChanges.clear();
+		memset(&mStatistics, 0, sizeof(mStatistics));
+
+		unsigned long long residentBytes = 0;
+		for (Texture& texture : mTextures)
+		{
+			if (texture.IsActive == false)
+			{
+				continue;
+			}
+
+			texture.PreviousMip = texture.ResidentMip;
+			if (texture.LastRequestFrame == mFrame)
+			{
+				texture.WantedMip = std::min(static_cast<unsigned int>(std::max(texture.RequestedMip, 0.0f)), texture.PinnedMip);
+			}
+			else if (mFrame - texture.LastRequestFrame > mSettings.EvictionDelayFrames)
+			{
+				texture.WantedMip = texture.PinnedMip;
+			}
+
+			// Otherwise the last request stands, so detail isn't dropped the moment a surface leaves the view
+			residentBytes += ResidentSize(texture, texture.ResidentMip);
+		}
+
+		// A lowered budget takes back unwanted detail first, then the least recently used
+		while (residentBytes > mSettings.BudgetBytes)
+		{
+			int eviction = FindEviction(NoTexture, true);
+			if (eviction < 0)
+			{
+				break;
+			}
+
+			residentBytes -= Evict(eviction);
+		}
+
+		std::vector<bool> isBudgetLimited(mTextures.size(), false);
+		unsigned long long uploadedBytes = 0;
+		for (;;)
+		{
+			// Textures used this frame first, then whichever is furthest from the detail it wants
+			int load = -1;
+			for (unsigned int i = 0; i < mTextures.size(); i++)
+			{
+				const Texture& texture = mTextures[i];
+				if (texture.IsActive == false || texture.ResidentMip <= texture.WantedMip || isBudgetLimited[i])
+				{
+					continue;
+				}
+
+				if (load < 0)
+				{
+					load = i;
+					continue;
+				}
+
+				const Texture& best = mTextures[load];
+				bool isCurrent = (texture.LastRequestFrame == mFrame);
+				bool isBestCurrent = (best.LastRequestFrame == mFrame);
+				if (isCurrent != isBestCurrent ? isCurrent : texture.ResidentMip - texture.WantedMip > best.ResidentMip - best.WantedMip)
+				{
+					load = i;
+				}
+			}
+
+			if (load < 0)
+			{
+				break;
+			}
+
+			Texture& texture = mTextures[load];
+			unsigned long long size = texture.MipSizes[texture.ResidentMip - 1];
+
+			// At least one mip a frame, however large, so big textures can't starve
+			if (uploadedBytes > 0 && uploadedBytes + size > mSettings.UploadBytesPerFrame)
+			{
+				break;
+			}
+
+			while (residentBytes + size > mSettings.BudgetBytes)
+			{
+				int eviction = FindEviction(load, false);
+				if (eviction < 0)
+				{
+					break;
+				}
+
+				residentBytes -= Evict(eviction);
+			}
+
+			if (residentBytes + size > mSettings.BudgetBytes)
+			{
+				isBudgetLimited[load] = true;
+				mStatistics.BudgetLimitedCount++;
+				continue;
+			}
+
+			texture.ResidentMip--;
+			residentBytes += size;
+			uploadedBytes += size;
+			mStatistics.LoadedBytes += size;
+			mStatistics.LoadedMipCount++;
+		}
+
+		for (unsigned int i = 0; i < mTextures.size(); i++)
+		{
+			const Texture& texture = mTextures[i];
+			if (texture.IsActive == false)
+			{
+				continue;
+			}
+
+			mStatistics.TextureCount++;
+			mStatistics.WantedBytes += ResidentSize(texture, texture.WantedMip);
+			mStatistics.MissingMipCount += (texture.ResidentMip > texture.WantedMip ? texture.ResidentMip - texture.WantedMip : 0);
+
+			if (texture.ResidentMip != texture.PreviousMip)
+			{
+				TextureResidencyChange change = { i, texture.PreviousMip, texture.ResidentMip };
+				mChanges.push_back(change);
+			}
+		}
+
+		mStatistics.ResidentBytes = residentBytes;
+		mFrame++;
+
+		return mChanges;
+	}
+
+	const TextureResidencyStatistics& TextureResidency::Statistics() const
+	{
+		return mStatistics;
+	}
+
+	float TextureResidency::RequiredMip(float worldUnitsPerUV, float distance, unsigned int textureSize, float fieldOfView, unsigned int screenHeight)
+	{
+		if (worldUnitsPerUV <= 0.0f || screenHeight == 0)
+		{
+			return 0.0f;
+		}
+
+		float pixelSize = std::max(distance, 0.0f) * 2.0f * tan(fieldOfView * 0.5f) / screenHeight;
+		float texelSize = worldUnitsPerUV / textureSize;
+		float texelsPerPixel = pixelSize / texelSize;
+
+		return (texelsPerPixel > 1.0f ? log(texelsPerPixel) / log(2.0f) : 0.0f);
+	}
+
+	float TextureResidency::UVDensity(const float* positions, unsigned int positionStride, const float* textureCoordinates, unsigned int textureCoordinateStride, const unsigned int* indices, unsigned int triangleCount)
+	{
+		const unsigned char* positionBytes = reinterpret_cast<const unsigned char*>(positions);
+		const unsigned char* textureCoordinateBytes = reinterpret_cast<const unsigned char*>(textureCoordinates);
+
+		double worldArea = 0.0;
+		double uvArea = 0.0;
+		for (unsigned int triangle = 0; triangle < triangleCount; triangle++)
+		{
+			const float* p[3];
+			const float* uv[3];
+			for (unsigned int corner = 0; corner < 3; corner++)
+			{
+				unsigned int index = indices[triangle * 3 + corner];
+				p[corner] = reinterpret_cast<const float*>(positionBytes + static_cast<size_t>(index) * positionStride);
+				uv[corner] = reinterpret_cast<const float*>(textureCoordinateBytes + static_cast<size_t>(index) * textureCoordinateStride);
+			}
+
+			float edge0[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+			float edge1[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+			float cross[3] = { edge0[1] * edge1[2] - edge0[2] * edge1[1], edge0[2] * edge1[0] - edge0[0] * edge1[2], edge0[0] * edge1[1] - edge0[1] * edge1[0] };
+			worldArea += 0.5 * sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+
+			float uvCross = (uv[1][0] - uv[0][0]) * (uv[2][1] - uv[0][1]) - (uv[1][1] - uv[0][1]) * (uv[2][0] - uv[0][0]);
+			uvArea += 0.5 * fabs(uvCross);
+		}
+
+		return (uvArea > 0.0 ? static_cast<float>(sqrt(worldArea / uvArea)) : 0.0f);
+	}
+
+	unsigned long long TextureResidency::ResidentSize(const Texture& texture, unsigned int mip) const
+	{
+		unsigned long long size = 0;
+		for (unsigned int i = mip; i < texture.MipSizes.size(); i++)
+		{
+			size += texture.MipSizes[i];
+		}
+
+		return size;
+	}
+
+	int TextureResidency::FindEviction(unsigned int excludedTexture, bool isWantedEvictable) const
+	{
+		// Detail beyond what's wanted goes before wanted detail; within each, the least recently used goes first
+		int eviction = -1;
+		for (unsigned int i = 0; i < mTextures.size(); i++)
+		{
+			const Texture& texture = mTextures[i];
+			bool isUnwanted = (texture.ResidentMip < texture.WantedMip);
+			if (texture.IsActive == false || i == excludedTexture || texture.ResidentMip >= texture.PinnedMip || (isUnwanted == false && isWantedEvictable == false))
+			{
+				continue;
+			}
+
+			if (eviction < 0)
+			{
+				eviction = i;
+				continue;
+			}
+
+			const Texture& best = mTextures[eviction];
+			bool isBestUnwanted = (best.ResidentMip < best.WantedMip);
+			if (isUnwanted != isBestUnwanted ? isUnwanted : texture.LastRequestFrame < best.LastRequestFrame)
+			{
+				eviction = i;
+			}
+		}
+
+		return eviction;
+	}
+
+	unsigned long long TextureResidency::Evict(unsigned int texture)
+	{
+		Texture& evicted = mTextures[texture];
+		unsigned long long size = evicted.MipSizes[evicted.ResidentMip];
+		evicted.ResidentMip++;
+		mStatistics.EvictedBytes += size;
+		mStatistics.EvictedMipCount++;
+
+		return size;
+	}
+}
\ No newline at end of file
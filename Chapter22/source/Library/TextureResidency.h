@@ -0,0 +1,106 @@
+#pragma once
+
+// Portable, like OcclusionBuffer: the budget and feedback logic runs without a device
+#include <vector>
+
+namespace Library
+{
+	typedef struct _TextureResidencySettings
+	{
+		unsigned long long BudgetBytes;
+		unsigned long long UploadBytesPerFrame;
+		unsigned int PinnedMipSize;
+		unsigned int EvictionDelayFrames;
+	} TextureResidencySettings;
+
+	typedef struct _TextureResidencyStatistics
+	{
+		unsigned int TextureCount;
+		unsigned long long ResidentBytes;
+		unsigned long long WantedBytes;
+		unsigned int MissingMipCount;
+		unsigned int BudgetLimitedCount;
+		unsigned long long LoadedBytes;
+		unsigned long long EvictedBytes;
+		unsigned int LoadedMipCount;
+		unsigned int EvictedMipCount;
+	} TextureResidencyStatistics;
+
+	typedef struct _TextureResidencyChange
+	{
+		unsigned int Texture;
+		unsigned int PreviousMip;
+		unsigned int ResidentMip;
+	} TextureResidencyChange;
+
+	// Decides which mips of which textures are resident. Each frame, surfaces request the mip their screen-space
+	// texel density needs; Update() then loads the missing levels, most needed first, and pays for them by evicting
+	// detail nobody has asked for, least recently used first. Mips of PinnedMipSize and smaller are never evicted,
+	// so every texture can always be sampled. Budgets and statistics are in bytes, and mips are indices, 0 the largest.
+	class TextureResidency
+	{
+	public:
+		TextureResidency(const TextureResidencySettings& settings = DefaultSettings);
+
+		const TextureResidencySettings& Settings() const;
+		void SetSettings(const TextureResidencySettings& settings);
+
+		// mipSizes are in bytes, most detailed first; only the pinned mips start resident
+		unsigned int AddTexture(unsigned int width, unsigned int height, const std::vector<unsigned long long>& mipSizes);
+		void RemoveTexture(unsigned int texture);
+
+		unsigned int ResidentMip(unsigned int texture) const;
+		unsigned int WantedMip(unsigned int texture) const;
+		unsigned int PinnedMip(unsigned int texture) const;
+
+		// Records a use in the current frame; the most detailed request of the frame wins
+		void Request(unsigned int texture, float mip);
+
+		// As Request(), for a surface with the given UV density at a distance from a camera set with SetView()
+		void RequestSurface(unsigned int texture, float worldUnitsPerUV, float distance);
+		void SetView(float fieldOfView, unsigned int screenHeight);
+
+		// Ends the frame, returning the textures whose resident mip changed
+		const std::vector<TextureResidencyChange>& Update();
+
+		const TextureResidencyStatistics& Statistics() const;
+
+		// log2 of the texels per pixel covering a surface, for a texture textureSize texels across
+		static float RequiredMip(float worldUnitsPerUV, float distance, unsigned int textureSize, float fieldOfView, unsigned int screenHeight);
+
+		// World units per unit of UV over a triangle list, from the ratio of the total world and UV areas
+		static float UVDensity(const float* positions, unsigned int positionStride, const float* textureCoordinates, unsigned int textureCoordinateStride, const unsigned int* indices, unsigned int triangleCount);
+
+		static const TextureResidencySettings DefaultSettings;
+
+	private:
+		typedef struct _Texture
+		{
+			bool IsActive;
+			unsigned int Width;
+			std::vector<unsigned long long> MipSizes;
+			unsigned int PinnedMip;
+			unsigned int ResidentMip;
+			unsigned int WantedMip;
+			unsigned int PreviousMip;
+			float RequestedMip;
+			unsigned int LastRequestFrame;
+		} Texture;
+
+		TextureResidency(const TextureResidency& rhs);
+		TextureResidency& operator=(const TextureResidency& rhs);
+
+		unsigned long long ResidentSize(const Texture& texture, unsigned int mip) const;
+		int FindEviction(unsigned int excludedTexture, bool isWantedEvictable) const;
+		unsigned long long Evict(unsigned int texture);
+
+		TextureResidencySettings mSettings;
+		std::vector<Texture> mTextures;
+		std::vector<unsigned int> mFreeTextures;
+		std::vector<TextureResidencyChange> mChanges;
+		TextureResidencyStatistics mStatistics;
+		unsigned int mFrame;
+		float mFieldOfView;
+		unsigned int mScreenHeight;
+	};
+}
\ No newline at end of file
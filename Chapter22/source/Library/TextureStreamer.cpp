@@ -0,0 +1,199 @@
+#include "TextureStreamer.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Camera.h"
+#include "Mesh.h"
+#include <stdexcept>
+
+namespace Library
+{
+	RTTI_DEFINITIONS(TextureStreamer)
+
+	StreamedTexture::StreamedTexture(Game& game, const std::wstring& filename)
+		: mGame(&game), mFilename(filename), mMappedFile(), mFile(nullptr), mTexture(nullptr), mShaderResourceView(nullptr), mResidentMip(0), mResidencyIndex(0)
+	{
+		try
+		{
+			mMappedFile.Open(filename);
+			mFile = new DDSFile(mMappedFile.Data(), mMappedFile.Size());
+		}
+		catch (std::runtime_error& ex)
+		{
+			throw GameException(ex.what());
+		}
+
+		if (mFile->Dimension() != DDSDimensionTexture2D || mFile->ItemCount() != 1)
+		{
+			DeleteObject(mFile);
+			throw GameException("Only single 2D textures can be streamed.");
+		}
+
+		mResidentMip = mFile->MipCount();
+	}
+
+	StreamedTexture::~StreamedTexture()
+	{
+		ReleaseObject(mShaderResourceView);
+		ReleaseObject(mTexture);
+		DeleteObject(mFile);
+	}
+
+	const std::wstring& StreamedTexture::Filename() const
+	{
+		return mFilename;
+	}
+
+	const DDSFile& StreamedTexture::File() const
+	{
+		return *mFile;
+	}
+
+	ID3D11ShaderResourceView* StreamedTexture::ShaderResourceView() const
+	{
+		return mShaderResourceView;
+	}
+
+	UINT StreamedTexture::ResidentMip() const
+	{
+		return mResidentMip;
+	}
+
+	void StreamedTexture::SetResidentMip(UINT residentMip)
+	{
+		assert(residentMip < mFile->MipCount());
+
+		// Block-compressed textures need a top level that's whole blocks, so a little more may stay resident
+		while (residentMip > 0 && DDSFile::IsBlockCompressed(mFile->Format()) && (mFile->Subresource(0, residentMip).Width % 4 != 0 || mFile->Subresource(0, residentMip).Height % 4 != 0))
+		{
+			residentMip--;
+		}
+
+		if (residentMip == mResidentMip)
+		{
+			return;
+		}
+
+		const DDSSubresource& topLevel = mFile->Subresource(0, residentMip);
+		D3D11_TEXTURE2D_DESC textureDesc;
+		ZeroMemory(&textureDesc, sizeof(textureDesc));
+		textureDesc.Width = topLevel.Width;
+		textureDesc.Height = topLevel.Height;
+		textureDesc.MipLevels = mFile->MipCount() - residentMip;
+		textureDesc.ArraySize = 1;
+		textureDesc.Format = static_cast<DXGI_FORMAT>(mFile->Format());
+		textureDesc.SampleDesc.Count = 1;
+		textureDesc.SampleDesc.Quality = 0;
+		textureDesc.Usage = D3D11_USAGE_DEFAULT;
+		textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+		HRESULT hr;
+		ID3D11Texture2D* texture = nullptr;
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateTexture2D(&textureDesc, nullptr, &texture)))
+		{
+			throw GameException("ID3D11Device::CreateTexture2D() failed.", hr);
+		}
+
+		ID3D11DeviceContext* direct3DDeviceContext = mGame->Direct3DDeviceContext();
+		for (UINT level = 0; level < textureDesc.MipLevels; level++)
+		{
+			UINT mip = residentMip + level;
+			if (mTexture != nullptr && mip >= mResidentMip)
+			{
+				direct3DDeviceContext->CopySubresourceRegion(texture, level, 0, 0, 0, mTexture, mip - mResidentMip, nullptr);
+			}
+			else
+			{
+				const DDSSubresource& subresource = mFile->Subresource(0, mip);
+				direct3DDeviceContext->UpdateSubresource(texture, level, nullptr, mFile->SubresourceData(0, mip), subresource.RowPitch, subresource.SlicePitch);
+			}
+		}
+
+		ID3D11ShaderResourceView* shaderResourceView = nullptr;
+		if (FAILED(hr = mGame->Direct3DDevice()->CreateShaderResourceView(texture, nullptr, &shaderResourceView)))
+		{
+			ReleaseObject(texture);
+			throw GameException("ID3D11Device::CreateShaderResourceView() failed.", hr);
+		}
+
+		ReleaseObject(mShaderResourceView);
+		ReleaseObject(mTexture);
+		mTexture = texture;
+		mShaderResourceView = shaderResourceView;
+		mResidentMip = residentMip;
+	}
+
+	TextureStreamer::TextureStreamer(Game& game, Camera& camera, const TextureResidencySettings& settings)
+		: GameComponent(game), mCamera(&camera), mResidency(settings), mTextures()
+	{
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+	}
+
+	std::shared_ptr<StreamedTexture> TextureStreamer::LoadTexture(const std::wstring& filename)
+	{
+		std::shared_ptr<StreamedTexture> texture(new StreamedTexture(*mGame, filename));
+
+		const DDSFile& file = texture->File();
+		std::vector<unsigned long long> mipSizes(file.MipCount());
+		for (UINT mip = 0; mip < file.MipCount(); mip++)
+		{
+			mipSizes[mip] = file.Subresource(0, mip).Size;
+		}
+
+		texture->mResidencyIndex = mResidency.AddTexture(file.Width(), file.Height(), mipSizes);
+		texture->SetResidentMip(mResidency.ResidentMip(texture->mResidencyIndex));
+		mTextures[texture->mResidencyIndex] = texture;
+
+		return texture;
+	}
+
+	void TextureStreamer::Request(const StreamedTexture& texture, float worldUnitsPerUV, const XMFLOAT3& position)
+	{
+		XMVECTOR offset = XMLoadFloat3(&position) - mCamera->PositionVector();
+		mResidency.RequestSurface(texture.mResidencyIndex, worldUnitsPerUV, XMVectorGetX(XMVector3Length(offset)));
+	}
+
+	void TextureStreamer::RequestMesh(const StreamedTexture& texture, const Mesh& mesh, const XMFLOAT3& position, float scale)
+	{
+		Request(texture, mesh.UVDensity() * scale, position);
+	}
+
+	TextureResidency& TextureStreamer::Residency()
+	{
+		return mResidency;
+	}
+
+	const TextureResidencyStatistics& TextureStreamer::Statistics() const
+	{
+		return mResidency.Statistics();
+	}
+
+	void TextureStreamer::Update(const GameTime& gameTime)
+	{
+		// Textures nobody holds any more give their budget back
+		for (auto it = mTextures.begin(); it != mTextures.end();)
+		{
+			if (it->second.expired())
+			{
+				mResidency.RemoveTexture(it->first);
+				it = mTextures.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		mResidency.SetView(mCamera->FieldOfView(), static_cast<unsigned int>(mGame->ScreenHeight()));
+		for (const TextureResidencyChange& change : mResidency.Update())
+		{
+			std::shared_ptr<StreamedTexture> texture = mTextures[change.Texture].lock();
+			if (texture != nullptr)
+			{
+				texture->SetResidentMip(change.ResidentMip);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Common.h"
+#include "GameComponent.h"
+#include "MappedFile.h"
+#include "DDSFile.h"
+#include "TextureResidency.h"
+
+namespace Library
+{
+	class Camera;
+	class Mesh;
+
+	// A 2D DDS texture whose GPU copy holds only its resident mips. Changing residency reallocates the texture, so
+	// evicted mips really return their memory; mips already on the GPU are copied across, the rest come from the mapping.
+	class StreamedTexture
+	{
+		friend class TextureStreamer;
+
+	public:
+		~StreamedTexture();
+
+		const std::wstring& Filename() const;
+		const DDSFile& File() const;
+
+		// Changes whenever the resident mips do, so look it up every frame
+		ID3D11ShaderResourceView* ShaderResourceView() const;
+		UINT ResidentMip() const;
+
+	private:
+		StreamedTexture(Game& game, const std::wstring& filename);
+		StreamedTexture();
+		StreamedTexture(const StreamedTexture& rhs);
+		StreamedTexture& operator=(const StreamedTexture& rhs);
+
+		void SetResidentMip(UINT residentMip);
+
+		Game* mGame;
+		std::wstring mFilename;
+		MappedFile mMappedFile;
+		DDSFile* mFile;
+		ID3D11Texture2D* mTexture;
+		ID3D11ShaderResourceView* mShaderResourceView;
+		UINT mResidentMip;
+		UINT mResidencyIndex;
+	};
+
+	// Streams StreamedTexture mips in and out under TextureResidency's memory budget. Draw code requests the detail
+	// each surface needs, and Update() applies the residency changes.
+	class TextureStreamer : public GameComponent
+	{
+		RTTI_DECLARATIONS(TextureStreamer, GameComponent)
+
+	public:
+		TextureStreamer(Game& game, Camera& camera, const TextureResidencySettings& settings = TextureResidency::DefaultSettings);
+		~TextureStreamer();
+
+		// Only the pinned mips are uploaded here; the rest arrive as they're requested
+		std::shared_ptr<StreamedTexture> LoadTexture(const std::wstring& filename);
+
+		// Asks for the detail a surface with the given UV density needs at position, as seen from the camera
+		void Request(const StreamedTexture& texture, float worldUnitsPerUV, const XMFLOAT3& position);
+		void RequestMesh(const StreamedTexture& texture, const Mesh& mesh, const XMFLOAT3& position, float scale = 1.0f);
+
+		TextureResidency& Residency();
+		const TextureResidencyStatistics& Statistics() const;
+
+		virtual void Update(const GameTime& gameTime) override;
+
+	private:
+		TextureStreamer();
+		TextureStreamer(const TextureStreamer& rhs);
+		TextureStreamer& operator=(const TextureStreamer& rhs);
+
+		Camera* mCamera;
+		TextureResidency mResidency;
+		std::map<UINT, std::weak_ptr<StreamedTexture>> mTextures;
+	};
+}
\ No newline at end of file
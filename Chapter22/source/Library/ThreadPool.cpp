@@ -0,0 +1,203 @@
+#include "ThreadPool.h"
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+namespace Library
+{
+	ThreadPool::ThreadPool(unsigned int threadCount)
+		: mThreads(), mTasks(), mMutex(), mTaskAvailable(), mTasksCompleted(), mException(), mActiveTaskCount(0), mIsShuttingDown(false)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = DefaultThreadCount();
+		}
+
+		mThreads.reserve(threadCount);
+		for (unsigned int i = 0; i < threadCount; i++)
+		{
+			mThreads.push_back(std::thread(&ThreadPool::WorkerThread, this));
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mIsShuttingDown = true;
+		}
+
+		mTaskAvailable.notify_all();
+
+		for (std::thread& thread : mThreads)
+		{
+			thread.join();
+		}
+	}
+
+	unsigned int ThreadPool::ThreadCount() const
+	{
+		return static_cast<unsigned int>(mThreads.size());
+	}
+
+	void ThreadPool::Enqueue(const std::function<void()>& task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mTasks.push_back(task);
+		}
+
+		mTaskAvailable.notify_one();
+	}
+
+	void ThreadPool::Wait()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		while (mTasks.empty() == false || mActiveTaskCount > 0)
+		{
+			mTasksCompleted.wait(lock);
+		}
+
+		if (mException != nullptr)
+		{
+			std::exception_ptr exception = mException;
+			mException = nullptr;
+			std::rethrow_exception(exception);
+		}
+	}
+
+	void ThreadPool::ParallelFor(unsigned int begin, unsigned int end, const std::function<void(unsigned int begin, unsigned int end)>& body, unsigned int minimumBatchSize)
+	{
+		if (end <= begin)
+		{
+			return;
+		}
+
+		unsigned int count = end - begin;
+		unsigned int batchSize = std::max(minimumBatchSize, (count + ThreadCount() * 4 - 1) / (ThreadCount() * 4));
+		unsigned int batchCount = (count + batchSize - 1) / batchSize;
+
+		if (batchCount <= 1 || mThreads.empty())
+		{
+			body(begin, end);
+			return;
+		}
+
+		// Batches are claimed through a shared counter, so the calling thread works alongside the pool
+		// and finishes on its own if every worker is busy (e.g. ParallelFor called from within a task).
+		struct ParallelForState
+		{
+			std::atomic<unsigned int> NextBatch;
+			std::atomic<unsigned int> CompletedBatches;
+			std::mutex Mutex;
+			std::condition_variable Completed;
+			std::exception_ptr Exception;
+		};
+
+		std::shared_ptr<ParallelForState> state(new ParallelForState());
+		state->NextBatch = 0;
+		state->CompletedBatches = 0;
+
+		std::function<void()> runBatches = [state, begin, end, batchSize, batchCount, body]()
+		{
+			unsigned int batch;
+			while ((batch = state->NextBatch++) < batchCount)
+			{
+				unsigned int batchBegin = begin + batch * batchSize;
+				unsigned int batchEnd = std::min(end, batchBegin + batchSize);
+				try
+				{
+					body(batchBegin, batchEnd);
+				}
+				catch (...)
+				{
+					// The batch still counts as completed, or the caller would wait forever
+					std::lock_guard<std::mutex> lock(state->Mutex);
+					if (state->Exception == nullptr)
+					{
+						state->Exception = std::current_exception();
+					}
+				}
+
+				if (++state->CompletedBatches == batchCount)
+				{
+					std::lock_guard<std::mutex> lock(state->Mutex);
+					state->Completed.notify_all();
+				}
+			}
+		};
+
+		unsigned int helperCount = std::min(ThreadCount(), batchCount - 1);
+		for (unsigned int i = 0; i < helperCount; i++)
+		{
+			Enqueue(runBatches);
+		}
+
+		runBatches();
+
+		std::unique_lock<std::mutex> lock(state->Mutex);
+		while (state->CompletedBatches < batchCount)
+		{
+			state->Completed.wait(lock);
+		}
+
+		if (state->Exception != nullptr)
+		{
+			std::rethrow_exception(state->Exception);
+		}
+	}
+
+	unsigned int ThreadPool::DefaultThreadCount()
+	{
+		unsigned int hardwareThreadCount = std::thread::hardware_concurrency();
+
+		return (hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 1);
+	}
+
+	void ThreadPool::WorkerThread()
+	{
+		for (;;)
+		{
+			std::function<void()> task;
+
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				while (mTasks.empty() && mIsShuttingDown == false)
+				{
+					mTaskAvailable.wait(lock);
+				}
+
+				if (mTasks.empty())
+				{
+					return;
+				}
+
+				task = mTasks.front();
+				mTasks.pop_front();
+				mActiveTaskCount++;
+			}
+
+			std::exception_ptr exception;
+			try
+			{
+				task();
+			}
+			catch (...)
+			{
+				exception = std::current_exception();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				if (exception != nullptr && mException == nullptr)
+				{
+					mException = exception;
+				}
+
+				mActiveTaskCount--;
+			}
+
+			mTasksCompleted.notify_all();
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace Library
+{
+	class ThreadPool
+	{
+	public:
+		ThreadPool(unsigned int threadCount = 0);
+		~ThreadPool();
+
+		unsigned int ThreadCount() const;
+
+		void Enqueue(const std::function<void()>& task);
+
+		// Rethrows the first exception a task threw since the last Wait(); the worker that caught it carries on
+		void Wait();
+
+		// Rethrows the first exception a batch threw, once every batch has run
+		void ParallelFor(unsigned int begin, unsigned int end, const std::function<void(unsigned int begin, unsigned int end)>& body, unsigned int minimumBatchSize = 1);
+
+		static unsigned int DefaultThreadCount();
+
+	private:
+		ThreadPool(const ThreadPool& rhs);
+		ThreadPool& operator=(const ThreadPool& rhs);
+
+		void WorkerThread();
+
+		std::vector<std::thread> mThreads;
+		std::deque<std::function<void()>> mTasks;
+		std::mutex mMutex;
+		std::condition_variable mTaskAvailable;
+		std::condition_variable mTasksCompleted;
+		std::exception_ptr mException;
+		unsigned int mActiveTaskCount;
+		bool mIsShuttingDown;
+	};
+}
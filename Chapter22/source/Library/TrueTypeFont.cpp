@@ -0,0 +1,571 @@
+#include "TrueTypeFont.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace Library
+{
+	const unsigned int TrueTypeFont::MaximumCompositeDepth = 8;
+
+	namespace
+	{
+		const unsigned int TrueTypeVersion = 0x00010000;
+		const unsigned int AppleTrueTypeVersion = 0x74727565;
+		const unsigned int OpenTypeCFFVersion = 0x4F54544F;
+
+		// Simple glyph point flags
+		const unsigned char PointOnCurve = 0x01;
+		const unsigned char PointXIsShort = 0x02;
+		const unsigned char PointYIsShort = 0x04;
+		const unsigned char PointRepeats = 0x08;
+		const unsigned char PointXIsSameOrPositive = 0x10;
+		const unsigned char PointYIsSameOrPositive = 0x20;
+
+		// Composite glyph component flags
+		const unsigned int ComponentArgumentsAreWords = 0x0001;
+		const unsigned int ComponentArgumentsAreOffsets = 0x0002;
+		const unsigned int ComponentHasScale = 0x0008;
+		const unsigned int ComponentHasMoreComponents = 0x0020;
+		const unsigned int ComponentHasXYScale = 0x0040;
+		const unsigned int ComponentHasTwoByTwo = 0x0080;
+
+		typedef struct _OutlinePoint
+		{
+			float Position[2];
+			bool IsOnCurve;
+		} OutlinePoint;
+
+		void Midpoint(const float a[2], const float b[2], float midpoint[2])
+		{
+			midpoint[0] = (a[0] + b[0]) * 0.5f;
+			midpoint[1] = (a[1] + b[1]) * 0.5f;
+		}
+
+		void AddSegment(const float start[2], const float* control, const float end[2], std::vector<OutlineSegment>& segments)
+		{
+			if (control == nullptr && start[0] == end[0] && start[1] == end[1])
+			{
+				return;
+			}
+
+			OutlineSegment segment;
+			memcpy(segment.Points[0], start, sizeof(segment.Points[0]));
+			memcpy(segment.Points[2], end, sizeof(segment.Points[2]));
+			if (control != nullptr)
+			{
+				memcpy(segment.Points[1], control, sizeof(segment.Points[1]));
+			}
+			else
+			{
+				Midpoint(start, end, segment.Points[1]);
+			}
+
+			segment.IsCurve = (control != nullptr);
+			segments.push_back(segment);
+		}
+
+		// Two off-curve points in a row imply an on-curve point between them, and a contour may start off the curve
+		void AddContour(const OutlinePoint* points, unsigned int count, std::vector<OutlineSegment>& segments)
+		{
+			if (count < 2)
+			{
+				return;
+			}
+
+			float start[2];
+			unsigned int first;
+			unsigned int last;
+			if (points[0].IsOnCurve)
+			{
+				memcpy(start, points[0].Position, sizeof(start));
+				first = 1;
+				last = count - 1;
+			}
+			else if (points[count - 1].IsOnCurve)
+			{
+				memcpy(start, points[count - 1].Position, sizeof(start));
+				first = 0;
+				last = count - 2;
+			}
+			else
+			{
+				Midpoint(points[count - 1].Position, points[0].Position, start);
+				first = 0;
+				last = count - 1;
+			}
+
+			float current[2];
+			float control[2];
+			bool hasControl = false;
+			memcpy(current, start, sizeof(current));
+
+			for (unsigned int i = first; i <= last && i < count; i++)
+			{
+				const OutlinePoint& point = points[i];
+				if (point.IsOnCurve)
+				{
+					AddSegment(current, (hasControl ? control : nullptr), point.Position, segments);
+					memcpy(current, point.Position, sizeof(current));
+					hasControl = false;
+				}
+				else if (hasControl)
+				{
+					float midpoint[2];
+					Midpoint(control, point.Position, midpoint);
+					AddSegment(current, control, midpoint, segments);
+					memcpy(current, midpoint, sizeof(current));
+					memcpy(control, point.Position, sizeof(control));
+				}
+				else
+				{
+					memcpy(control, point.Position, sizeof(control));
+					hasControl = true;
+				}
+			}
+
+			AddSegment(current, (hasControl ? control : nullptr), start, segments);
+		}
+	}
+
+	TrueTypeFont::TrueTypeFont(const unsigned char* data, size_t size)
+		: mData(data), mSize(size), mGlyphDataOffset(0), mGlyphDataSize(0), mGlyphLocationOffset(0), mHorizontalMetricsOffset(0),
+		  mCharacterMapOffset(0), mCharacterMapFormat(0), mGlyphCount(0), mHorizontalMetricCount(0), mHasLongGlyphLocations(false),
+		  mUnitsPerEm(0.0f), mAscender(0.0f), mDescender(0.0f), mLineGap(0.0f)
+	{
+		unsigned int version = ReadULong(0);
+		if (version == OpenTypeCFFVersion)
+		{
+			throw std::runtime_error("The font has CFF outlines; only TrueType outlines are supported.");
+		}
+
+		if (version != TrueTypeVersion && version != AppleTrueTypeVersion)
+		{
+			throw std::runtime_error("Not a TrueType font.");
+		}
+
+		size_t header = FindTable("head", 54);
+		mUnitsPerEm = static_cast<float>(ReadUShort(header + 18));
+		mHasLongGlyphLocations = (ReadShort(header + 50) != 0);
+		if (mUnitsPerEm == 0.0f)
+		{
+			throw std::runtime_error("The font has no units per em.");
+		}
+
+		mGlyphCount = ReadUShort(FindTable("maxp", 6) + 4);
+
+		size_t horizontalHeader = FindTable("hhea", 36);
+		mAscender = static_cast<float>(ReadShort(horizontalHeader + 4));
+		mDescender = static_cast<float>(ReadShort(horizontalHeader + 6));
+		mLineGap = static_cast<float>(ReadShort(horizontalHeader + 8));
+		mHorizontalMetricCount = ReadUShort(horizontalHeader + 34);
+		if (mHorizontalMetricCount == 0)
+		{
+			throw std::runtime_error("The font has no horizontal metrics.");
+		}
+
+		mHorizontalMetricsOffset = FindTable("hmtx", mHorizontalMetricCount * 4);
+		mGlyphLocationOffset = FindTable("loca", (mGlyphCount + 1) * (mHasLongGlyphLocations ? 4 : 2));
+		mGlyphDataOffset = FindTable("glyf", 0, &mGlyphDataSize);
+
+		// The Unicode subtable: full repertoire (format 12) first, then the Basic Multilingual Plane (format 4)
+		size_t characterMap = FindTable("cmap", 4);
+		unsigned int subtableCount = ReadUShort(characterMap + 2);
+		for (unsigned int i = 0; i < subtableCount; i++)
+		{
+			size_t record = characterMap + 4 + i * 8;
+			unsigned int platform = ReadUShort(record);
+			unsigned int encoding = ReadUShort(record + 2);
+			size_t subtable = characterMap + ReadULong(record + 4);
+			unsigned int format = ReadUShort(subtable);
+
+			bool isUnicode = (platform == 0 || (platform == 3 && (encoding == 0 || encoding == 1 || encoding == 10)));
+			if (isUnicode && format == 12)
+			{
+				mCharacterMapOffset = subtable;
+				mCharacterMapFormat = format;
+				break;
+			}
+
+			if (isUnicode && format == 4 && mCharacterMapFormat != 4)
+			{
+				mCharacterMapOffset = subtable;
+				mCharacterMapFormat = format;
+			}
+		}
+
+		if (mCharacterMapFormat == 0)
+		{
+			throw std::runtime_error("The font has no Unicode character map.");
+		}
+	}
+
+	unsigned int TrueTypeFont::GlyphCount() const
+	{
+		return mGlyphCount;
+	}
+
+	float TrueTypeFont::UnitsPerEm() const
+	{
+		return mUnitsPerEm;
+	}
+
+	float TrueTypeFont::Ascender() const
+	{
+		return mAscender;
+	}
+
+	float TrueTypeFont::Descender() const
+	{
+		return mDescender;
+	}
+
+	float TrueTypeFont::LineGap() const
+	{
+		return mLineGap;
+	}
+
+	unsigned int TrueTypeFont::GlyphIndex(unsigned int character) const
+	{
+		size_t subtable = mCharacterMapOffset;
+		if (mCharacterMapFormat == 12)
+		{
+			unsigned int groupCount = ReadULong(subtable + 12);
+			unsigned int low = 0;
+			unsigned int high = groupCount;
+			while (low < high)
+			{
+				unsigned int middle = (low + high) / 2;
+				size_t group = subtable + 16 + static_cast<size_t>(middle) * 12;
+				if (character < ReadULong(group))
+				{
+					high = middle;
+				}
+				else if (character > ReadULong(group + 4))
+				{
+					low = middle + 1;
+				}
+				else
+				{
+					return ReadULong(group + 8) + (character - ReadULong(group));
+				}
+			}
+
+			return 0;
+		}
+
+		if (character > 0xFFFF)
+		{
+			return 0;
+		}
+
+		// Segments sorted by end code; the first ending at or after the character may contain it
+		unsigned int segmentCount = ReadUShort(subtable + 6) / 2;
+		size_t endCodes = subtable + 14;
+		size_t startCodes = endCodes + segmentCount * 2 + 2;
+		size_t deltas = startCodes + segmentCount * 2;
+		size_t rangeOffsets = deltas + segmentCount * 2;
+
+		unsigned int low = 0;
+		unsigned int high = segmentCount;
+		while (low < high)
+		{
+			unsigned int middle = (low + high) / 2;
+			if (ReadUShort(endCodes + middle * 2) < character)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+
+		if (low == segmentCount || ReadUShort(startCodes + low * 2) > character)
+		{
+			return 0;
+		}
+
+		unsigned int delta = ReadUShort(deltas + low * 2);
+		size_t rangeOffsetAddress = rangeOffsets + low * 2;
+		unsigned int rangeOffset = ReadUShort(rangeOffsetAddress);
+		if (rangeOffset == 0)
+		{
+			return (character + delta) & 0xFFFF;
+		}
+
+		unsigned int glyphIndex = ReadUShort(rangeOffsetAddress + rangeOffset + (character - ReadUShort(startCodes + low * 2)) * 2);
+
+		return (glyphIndex != 0 ? (glyphIndex + delta) & 0xFFFF : 0);
+	}
+
+	void TrueTypeFont::Outline(unsigned int glyphIndex, GlyphOutline& outline) const
+	{
+		outline.Segments.clear();
+		memset(outline.Bounds, 0, sizeof(outline.Bounds));
+
+		unsigned int metric = (glyphIndex < mHorizontalMetricCount ? glyphIndex : mHorizontalMetricCount - 1);
+		outline.AdvanceWidth = static_cast<float>(ReadUShort(mHorizontalMetricsOffset + metric * 4));
+
+		const float identity[6] = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+		AppendOutline(glyphIndex, identity, 0, outline);
+
+		if (outline.Segments.empty() == false)
+		{
+			outline.Bounds[0] = outline.Bounds[2] = outline.Segments[0].Points[0][0];
+			outline.Bounds[1] = outline.Bounds[3] = outline.Segments[0].Points[0][1];
+			for (const OutlineSegment& segment : outline.Segments)
+			{
+				// A curve stays within its control points' hull
+				for (unsigned int i = 0; i < 3; i++)
+				{
+					outline.Bounds[0] = (segment.Points[i][0] < outline.Bounds[0] ? segment.Points[i][0] : outline.Bounds[0]);
+					outline.Bounds[1] = (segment.Points[i][1] < outline.Bounds[1] ? segment.Points[i][1] : outline.Bounds[1]);
+					outline.Bounds[2] = (segment.Points[i][0] > outline.Bounds[2] ? segment.Points[i][0] : outline.Bounds[2]);
+					outline.Bounds[3] = (segment.Points[i][1] > outline.Bounds[3] ? segment.Points[i][1] : outline.Bounds[3]);
+				}
+			}
+		}
+	}
+
+	size_t TrueTypeFont::FindTable(const char* tag, size_t minimumSize, size_t* tableSize) const
+	{
+		unsigned int tableCount = ReadUShort(4);
+		for (unsigned int i = 0; i < tableCount; i++)
+		{
+			size_t record = 12 + i * 16;
+			if (record + 16 > mSize)
+			{
+				throw std::runtime_error("The font is truncated.");
+			}
+
+			if (memcmp(mData + record, tag, 4) != 0)
+			{
+				continue;
+			}
+
+			size_t offset = ReadULong(record + 8);
+			size_t size = ReadULong(record + 12);
+			if (offset > mSize || size > mSize - offset || size < minimumSize)
+			{
+				throw std::runtime_error("A font table is truncated.");
+			}
+
+			if (tableSize != nullptr)
+			{
+				*tableSize = size;
+			}
+
+			return offset;
+		}
+
+		throw std::runtime_error("The font is missing a required table.");
+	}
+
+	void TrueTypeFont::AppendOutline(unsigned int glyphIndex, const float transform[6], unsigned int depth, GlyphOutline& outline) const
+	{
+		if (glyphIndex >= mGlyphCount || depth > MaximumCompositeDepth)
+		{
+			return;
+		}
+
+		size_t start;
+		size_t end;
+		if (mHasLongGlyphLocations)
+		{
+			start = ReadULong(mGlyphLocationOffset + glyphIndex * 4);
+			end = ReadULong(mGlyphLocationOffset + glyphIndex * 4 + 4);
+		}
+		else
+		{
+			start = ReadUShort(mGlyphLocationOffset + glyphIndex * 2) * 2;
+			end = ReadUShort(mGlyphLocationOffset + glyphIndex * 2 + 2) * 2;
+		}
+
+		if (end <= start)
+		{
+			return;
+		}
+
+		if (end > mGlyphDataSize)
+		{
+			throw std::runtime_error("The glyph data is truncated.");
+		}
+
+		size_t glyph = mGlyphDataOffset + start;
+		int contourCount = ReadShort(glyph);
+		if (contourCount >= 0)
+		{
+			size_t endPoints = glyph + 10;
+			unsigned int pointCount = (contourCount > 0 ? ReadUShort(endPoints + (contourCount - 1) * 2) + 1 : 0);
+			size_t flagOffset = endPoints + contourCount * 2 + 2 + ReadUShort(endPoints + contourCount * 2);
+
+			std::vector<unsigned char> flags(pointCount);
+			for (unsigned int i = 0; i < pointCount;)
+			{
+				if (flagOffset >= mSize)
+				{
+					throw std::runtime_error("The glyph data is truncated.");
+				}
+
+				unsigned char flag = mData[flagOffset++];
+				unsigned int repeatCount = 1;
+				if ((flag & PointRepeats) != 0)
+				{
+					if (flagOffset >= mSize)
+					{
+						throw std::runtime_error("The glyph data is truncated.");
+					}
+
+					repeatCount += mData[flagOffset++];
+				}
+
+				for (; repeatCount > 0 && i < pointCount; repeatCount--)
+				{
+					flags[i++] = flag;
+				}
+			}
+
+			// Coordinates are deltas: a byte with a sign flag, nothing (repeat the last), or a signed word
+			std::vector<OutlinePoint> points(pointCount);
+			size_t coordinateOffset = flagOffset;
+			for (unsigned int axis = 0; axis < 2; axis++)
+			{
+				unsigned char isShort = (axis == 0 ? PointXIsShort : PointYIsShort);
+				unsigned char isSameOrPositive = (axis == 0 ? PointXIsSameOrPositive : PointYIsSameOrPositive);
+				int value = 0;
+				for (unsigned int i = 0; i < pointCount; i++)
+				{
+					if ((flags[i] & isShort) != 0)
+					{
+						if (coordinateOffset >= mSize)
+						{
+							throw std::runtime_error("The glyph data is truncated.");
+						}
+
+						int delta = mData[coordinateOffset++];
+						value += ((flags[i] & isSameOrPositive) != 0 ? delta : -delta);
+					}
+					else if ((flags[i] & isSameOrPositive) == 0)
+					{
+						value += ReadShort(coordinateOffset);
+						coordinateOffset += 2;
+					}
+
+					points[i].Position[axis] = static_cast<float>(value);
+				}
+			}
+
+			for (unsigned int i = 0; i < pointCount; i++)
+			{
+				float x = points[i].Position[0];
+				float y = points[i].Position[1];
+				points[i].Position[0] = transform[0] * x + transform[2] * y + transform[4];
+				points[i].Position[1] = transform[1] * x + transform[3] * y + transform[5];
+				points[i].IsOnCurve = ((flags[i] & PointOnCurve) != 0);
+			}
+
+			unsigned int firstPoint = 0;
+			for (int contour = 0; contour < contourCount; contour++)
+			{
+				unsigned int lastPoint = ReadUShort(endPoints + contour * 2);
+				if (lastPoint < firstPoint || lastPoint >= pointCount)
+				{
+					throw std::runtime_error("A glyph contour is malformed.");
+				}
+
+				AddContour(&points[firstPoint], lastPoint - firstPoint + 1, outline.Segments);
+				firstPoint = lastPoint + 1;
+			}
+
+			return;
+		}
+
+		// A composite: components are other glyphs, each placed with an offset and an optional 2x2 transform
+		size_t component = glyph + 10;
+		unsigned int componentFlags;
+		do
+		{
+			componentFlags = ReadUShort(component);
+			unsigned int componentGlyph = ReadUShort(component + 2);
+			component += 4;
+
+			float offset[2] = { 0.0f, 0.0f };
+			if ((componentFlags & ComponentArgumentsAreWords) != 0)
+			{
+				offset[0] = static_cast<float>(ReadShort(component));
+				offset[1] = static_cast<float>(ReadShort(component + 2));
+				component += 4;
+			}
+			else
+			{
+				if (component + 2 > mSize)
+				{
+					throw std::runtime_error("The glyph data is truncated.");
+				}
+
+				offset[0] = static_cast<float>(static_cast<signed char>(mData[component]));
+				offset[1] = static_cast<float>(static_cast<signed char>(mData[component + 1]));
+				component += 2;
+			}
+
+			// Components positioned by matching points rather than by offset are placed at the origin
+			if ((componentFlags & ComponentArgumentsAreOffsets) == 0)
+			{
+				offset[0] = 0.0f;
+				offset[1] = 0.0f;
+			}
+
+			float matrix[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
+			if ((componentFlags & ComponentHasScale) != 0)
+			{
+				matrix[0] = matrix[3] = ReadShort(component) / 16384.0f;
+				component += 2;
+			}
+			else if ((componentFlags & ComponentHasXYScale) != 0)
+			{
+				matrix[0] = ReadShort(component) / 16384.0f;
+				matrix[3] = ReadShort(component + 2) / 16384.0f;
+				component += 4;
+			}
+			else if ((componentFlags & ComponentHasTwoByTwo) != 0)
+			{
+				for (unsigned int i = 0; i < 4; i++)
+				{
+					matrix[i] = ReadShort(component + i * 2) / 16384.0f;
+				}
+
+				component += 8;
+			}
+
+			// The parent's transform applied after the component's
+			float combined[6];
+			combined[0] = transform[0] * matrix[0] + transform[2] * matrix[1];
+			combined[1] = transform[1] * matrix[0] + transform[3] * matrix[1];
+			combined[2] = transform[0] * matrix[2] + transform[2] * matrix[3];
+			combined[3] = transform[1] * matrix[2] + transform[3] * matrix[3];
+			combined[4] = transform[0] * offset[0] + transform[2] * offset[1] + transform[4];
+			combined[5] = transform[1] * offset[0] + transform[3] * offset[1] + transform[5];
+
+			AppendOutline(componentGlyph, combined, depth + 1, outline);
+		} while ((componentFlags & ComponentHasMoreComponents) != 0);
+	}
+
+	unsigned int TrueTypeFont::ReadUShort(size_t offset) const
+	{
+		if (offset > mSize || mSize - offset < 2)
+		{
+			throw std::runtime_error("The font is truncated.");
+		}
+
+		return (static_cast<unsigned int>(mData[offset]) << 8) | mData[offset + 1];
+	}
+
+	unsigned int TrueTypeFont::ReadULong(size_t offset) const
+	{
+		return (ReadUShort(offset) << 16) | ReadUShort(offset + 2);
+	}
+
+	int TrueTypeFont::ReadShort(size_t offset) const
+	{
+		return static_cast<short>(ReadUShort(offset));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+// Portable, like DDSFile: a font tool has to run without Windows' font rasterizer
+#include <cstddef>
+#include <vector>
+
+namespace Library
+{
+	// A line (Points[0] to Points[2], Points[1] its midpoint) or a quadratic Bezier through control point Points[1]
+	typedef struct _OutlineSegment
+	{
+		float Points[3][2];
+		bool IsCurve;
+	} OutlineSegment;
+
+	// A glyph's closed contours in font units, y up. Bounds is xMin, yMin, xMax and yMax; an empty glyph has no segments.
+	typedef struct _GlyphOutline
+	{
+		std::vector<OutlineSegment> Segments;
+		float Bounds[4];
+		float AdvanceWidth;
+	} GlyphOutline;
+
+	// Reads glyph outlines from a TrueType (glyf) font: the cmap's Unicode subtable, format 4 or 12, maps characters to
+	// glyphs, and simple and composite glyphs are flattened into segments. Hinting instructions are ignored, as they
+	// don't apply to distance fields. Like DDSFile the data isn't copied, so the caller's buffer must outlive the font.
+	class TrueTypeFont
+	{
+	public:
+		// Throws std::runtime_error for anything that isn't a complete TrueType font with glyph outlines
+		TrueTypeFont(const unsigned char* data, size_t size);
+
+		unsigned int GlyphCount() const;
+		float UnitsPerEm() const;
+		float Ascender() const;
+		float Descender() const;
+		float LineGap() const;
+
+		// 0, the missing glyph, for characters the font doesn't map
+		unsigned int GlyphIndex(unsigned int character) const;
+		void Outline(unsigned int glyphIndex, GlyphOutline& outline) const;
+
+	private:
+		TrueTypeFont();
+		TrueTypeFont(const TrueTypeFont& rhs);
+		TrueTypeFont& operator=(const TrueTypeFont& rhs);
+
+		size_t FindTable(const char* tag, size_t minimumSize, size_t* tableSize = nullptr) const;
+		void AppendOutline(unsigned int glyphIndex, const float transform[6], unsigned int depth, GlyphOutline& outline) const;
+		unsigned int ReadUShort(size_t offset) const;
+		unsigned int ReadULong(size_t offset) const;
+		int ReadShort(size_t offset) const;
+
+		static const unsigned int MaximumCompositeDepth;
+
+		const unsigned char* mData;
+		size_t mSize;
+		size_t mGlyphDataOffset;
+		size_t mGlyphDataSize;
+		size_t mGlyphLocationOffset;
+		size_t mHorizontalMetricsOffset;
+		size_t mCharacterMapOffset;
+		unsigned int mCharacterMapFormat;
+		unsigned int mGlyphCount;
+		unsigned int mHorizontalMetricCount;
+		bool mHasLongGlyphLocations;
+		float mUnitsPerEm;
+		float mAscender;
+		float mDescender;
+		float mLineGap;
+	};
+}
\ No newline at end of file
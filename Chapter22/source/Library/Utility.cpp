@@ -123,4 +123,18 @@ namespace Library
 	{
 		dest = PathFindExtension(source.c_str());
 	}
+
+	UINT64 Utility::Fnv1aHash(const void* data, size_t size, UINT64 hash)
+	{
+		static const UINT64 Fnv1aPrime = 1099511628211ULL;
+
+		const byte* bytes = reinterpret_cast<const byte*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= Fnv1aPrime;
+		}
+
+		return hash;
+	}
 }
\ No newline at end of file
@@ -17,6 +17,9 @@ namespace Library
 		static std::wstring ToWideString(const std::string& source);
 		static void PathJoin(std::wstring& dest, const std::wstring& sourceDirectory, const std::wstring& sourceFile);
 		static void GetPathExtension(const std::wstring& source, std::wstring& dest);
+		static UINT64 Fnv1aHash(const void* data, size_t size, UINT64 hash = Fnv1aOffsetBasis);
+
+		static const UINT64 Fnv1aOffsetBasis = 14695981039346656037ULL;
 
 	private:
 		Utility();
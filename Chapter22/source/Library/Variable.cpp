@@ -42,6 +42,18 @@ namespace Library
 		return mName;
 	}
 
+	void Variable::Rebind(ID3DX11EffectVariable* variable)
+	{
+		mVariable = variable;
+		mType = mVariable->GetType();
+
+		if (mVariable->IsValid())
+		{
+			mVariable->GetDesc(&mVariableDesc);
+			mType->GetDesc(&mTypeDesc);
+		}
+	}
+
 	Variable& Variable::operator<<(CXMMATRIX value)
 	{
 		ID3DX11EffectMatrixVariable* variable = mVariable->AsMatrix();
@@ -18,6 +18,8 @@ namespace Library
         const D3DX11_EFFECT_TYPE_DESC& TypeDesc() const;
         const std::string& Name() const;
 
+        void Rebind(ID3DX11EffectVariable* variable);
+
         Variable& operator<<(CXMMATRIX value);
         Variable& operator<<(ID3D11ShaderResourceView* value);
 		Variable& operator<<(ID3D11UnorderedAccessView* value);
@@ -12,6 +12,10 @@ cbuffer CBufferPerObject
     float BloomSaturation = 1.0f;
     float SceneIntensity = 1.0f;
     float SceneSaturation = 1.0f;
+    float ThresholdKnee = 0.1f;
+    float2 SourceTexelSize;
+    float LevelWeight = 1.0f;
+    float CoarserLevelWeight = 1.0f;
 };
 
 SamplerState TrilinearSampler
@@ -21,6 +25,13 @@ SamplerState TrilinearSampler
     AddressV = WRAP;
 };
 
+SamplerState BilinearClampSampler
+{
+    Filter = MIN_MAG_MIP_LINEAR;
+    AddressU = CLAMP;
+    AddressV = CLAMP;
+};
+
 /************* Data Structures *************/
 
 struct VS_INPUT
@@ -44,6 +55,37 @@ float4 AdjustSaturation(float4 color, float saturation)
     return float4(lerp(intensity.rrr, color.rgb, saturation), color.a);
 }
 
+// 13 bilinear taps: the inner 2x2 box weighted 1/2 and four overlapping corner boxes 1/8 each
+float4 SampleDownsample13(Texture2D source, float2 uv)
+{
+    float2 texel = SourceTexelSize;
+
+    float4 a = source.Sample(BilinearClampSampler, uv + texel * float2(-2, -2));
+    float4 b = source.Sample(BilinearClampSampler, uv + texel * float2(0, -2));
+    float4 c = source.Sample(BilinearClampSampler, uv + texel * float2(2, -2));
+    float4 d = source.Sample(BilinearClampSampler, uv + texel * float2(-1, -1));
+    float4 e = source.Sample(BilinearClampSampler, uv + texel * float2(1, -1));
+    float4 f = source.Sample(BilinearClampSampler, uv + texel * float2(-2, 0));
+    float4 g = source.Sample(BilinearClampSampler, uv);
+    float4 h = source.Sample(BilinearClampSampler, uv + texel * float2(2, 0));
+    float4 i = source.Sample(BilinearClampSampler, uv + texel * float2(-1, 1));
+    float4 j = source.Sample(BilinearClampSampler, uv + texel * float2(1, 1));
+    float4 k = source.Sample(BilinearClampSampler, uv + texel * float2(-2, 2));
+    float4 l = source.Sample(BilinearClampSampler, uv + texel * float2(0, 2));
+    float4 m = source.Sample(BilinearClampSampler, uv + texel * float2(2, 2));
+
+    return (d + e + i + j) * (0.5f / 4) + (a + c + k + m) * (0.125f / 4) + (b + f + h + l) * (0.125f * 2 / 4) + g * (0.125f * 4 / 4);
+}
+
+// Quadratic ease over [BloomThreshold - ThresholdKnee, BloomThreshold + ThresholdKnee], linear above
+float SoftThreshold(float brightness)
+{
+    float soft = clamp(brightness - BloomThreshold + ThresholdKnee, 0, 2 * ThresholdKnee);
+    soft = soft * soft / (4 * ThresholdKnee + 1e-5f);
+
+    return max(soft, brightness - BloomThreshold) / max(brightness, 1e-5f);
+}
+
 /************* Vertex Shader *************/
 
 VS_OUTPUT vertex_shader(VS_INPUT IN)
@@ -78,6 +120,37 @@ float4 bloom_composite_pixel_shader(VS_OUTPUT IN) : SV_Target
     return sceneColor + bloomColor;
 }
 
+float4 bloom_prefilter_pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    float4 color = SampleDownsample13(ColorTexture, IN.TextureCoordinate);
+
+    return color * SoftThreshold(max(color.r, max(color.g, color.b)));
+}
+
+float4 bloom_downsample_pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    return SampleDownsample13(ColorTexture, IN.TextureCoordinate);
+}
+
+// ColorTexture is this level's downsample; BloomTexture is the coarser level, read through a 3x3 tent
+float4 bloom_upsample_pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    float2 uv = IN.TextureCoordinate;
+    float2 texel = SourceTexelSize;
+
+    float4 tent = BloomTexture.Sample(BilinearClampSampler, uv + texel * float2(-1, -1));
+    tent += BloomTexture.Sample(BilinearClampSampler, uv + texel * float2(1, -1));
+    tent += BloomTexture.Sample(BilinearClampSampler, uv + texel * float2(-1, 1));
+    tent += BloomTexture.Sample(BilinearClampSampler, uv + texel * float2(1, 1));
+    tent += BloomTexture.Sample(BilinearClampSampler, uv + texel * float2(0, -1)) * 2;
+    tent += BloomTexture.Sample(BilinearClampSampler, uv + texel * float2(-1, 0)) * 2;
+    tent += BloomTexture.Sample(BilinearClampSampler, uv + texel * float2(1, 0)) * 2;
+    tent += BloomTexture.Sample(BilinearClampSampler, uv + texel * float2(0, 1)) * 2;
+    tent += BloomTexture.Sample(BilinearClampSampler, uv) * 4;
+
+    return ColorTexture.Sample(BilinearClampSampler, uv) * LevelWeight + tent * (CoarserLevelWeight / 16);
+}
+
 float4 no_bloom_pixel_shader(VS_OUTPUT IN) : SV_Target
 {
     return ColorTexture.Sample(TrilinearSampler, IN.TextureCoordinate);
@@ -114,3 +187,33 @@ technique11 no_bloom
         SetPixelShader(CompileShader(ps_5_0, no_bloom_pixel_shader()));
     }
 }
+
+technique11 bloom_prefilter
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, bloom_prefilter_pixel_shader()));
+    }
+}
+
+technique11 bloom_downsample
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, bloom_downsample_pixel_shader()));
+    }
+}
+
+technique11 bloom_upsample
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, bloom_upsample_pixel_shader()));
+    }
+}
@@ -0,0 +1,313 @@
+#include "include\\Common.fxh"
+
+/************* Resources *************/
+
+static const float MaximumSpecularPower = 2048.0f;
+
+cbuffer CBufferPerFrame
+{
+    float4 AmbientColor = { 1.0f, 1.0f, 1.0f, 0.0f };
+    float4 LightColor = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float3 LightPosition = { 0.0f, 0.0f, 0.0f };
+    float LightRadius = 10.0f;
+    float3 LightDirection = { 0.0f, 0.0f, -1.0f };
+    float SpotLightOuterAngle = -1.0f;
+    float SpotLightInnerAngle = -1.0f;
+    float3 CameraPosition;
+
+    float4x4 InverseViewMatrix;
+    float4 ProjectionParameters; // tan(fov / 2) * aspect, tan(fov / 2), near, far
+}
+
+cbuffer CBufferPerObject
+{
+    float4x4 WorldViewProjection : WORLDVIEWPROJECTION;
+    float4x4 World : WORLD;
+    float4 SpecularColor : SPECULAR = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float SpecularPower : SPECULARPOWER = 25.0f;
+}
+
+Texture2D ColorTexture;
+Texture2D AlbedoBuffer;
+Texture2D NormalBuffer;
+Texture2D SpecularBuffer;
+Texture2D DepthBuffer;
+
+SamplerState ColorSampler
+{
+    Filter = MIN_MAG_MIP_LINEAR;
+    AddressU = WRAP;
+    AddressV = WRAP;
+};
+
+RasterizerState BackFaceCulling
+{
+    CullMode = BACK;
+};
+
+// Light passes are full-screen quads clipped to each light's screen bounds
+RasterizerState ScissorTest
+{
+    CullMode = NONE;
+    ScissorEnable = TRUE;
+};
+
+BlendState AdditiveBlending
+{
+    BlendEnable[0] = TRUE;
+    SrcBlend = ONE;
+    DestBlend = ONE;
+    BlendOp = ADD;
+};
+
+BlendState NoBlending
+{
+    BlendEnable[0] = FALSE;
+};
+
+DepthStencilState DepthTestDisabled
+{
+    DepthEnable = FALSE;
+    DepthWriteMask = ZERO;
+};
+
+DepthStencilState DepthTestEnabled
+{
+    DepthEnable = TRUE;
+    DepthWriteMask = ALL;
+    DepthFunc = LESS;
+};
+
+/************* Data Structures *************/
+
+struct VS_INPUT
+{
+    float4 ObjectPosition : POSITION;
+    float2 TextureCoordinate : TEXCOORD;
+    float3 Normal : NORMAL;
+};
+
+struct VS_OUTPUT
+{
+    float4 Position : SV_Position;
+    float3 Normal : NORMAL;
+    float2 TextureCoordinate : TEXCOORD;
+};
+
+struct GBUFFER_OUTPUT
+{
+    float4 Albedo : SV_Target0;
+    float2 Normal : SV_Target1;
+    float4 Specular : SV_Target2;
+};
+
+struct QUAD_VS_INPUT
+{
+    float4 Position : POSITION;
+    float2 TextureCoordinate : TEXCOORD;
+};
+
+struct QUAD_VS_OUTPUT
+{
+    float4 Position : SV_Position;
+    float2 TextureCoordinate : TEXCOORD;
+};
+
+struct SURFACE
+{
+    float4 Albedo;
+    float3 Normal;
+    float4 SpecularColor;
+    float SpecularPower;
+    float3 WorldPosition;
+};
+
+/************* Utility Functions *************/
+
+// Octahedral normal encoding; GBufferPacking implements the same mapping on the CPU
+float2 encode_normal(float3 normal)
+{
+    float2 encoded = normal.xy / (abs(normal.x) + abs(normal.y) + abs(normal.z));
+    if (normal.z < 0.0f)
+    {
+        encoded = (1.0f - abs(encoded.yx)) * (encoded >= 0.0f ? 1.0f : -1.0f);
+    }
+
+    return encoded;
+}
+
+float3 decode_normal(float2 encoded)
+{
+    float3 normal = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float unfold = saturate(-normal.z);
+    normal.xy += (normal.xy >= 0.0f ? -unfold : unfold);
+
+    return normalize(normal);
+}
+
+float encode_specular_power(float specularPower)
+{
+    return log2(clamp(specularPower, 1.0f, MaximumSpecularPower)) / log2(MaximumSpecularPower);
+}
+
+float decode_specular_power(float encoded)
+{
+    return exp2(encoded * log2(MaximumSpecularPower));
+}
+
+float3 get_world_position(float2 textureCoordinate, float depth)
+{
+    float linearDepth = (ProjectionParameters.z * ProjectionParameters.w) / (ProjectionParameters.w - depth * (ProjectionParameters.w - ProjectionParameters.z));
+    float3 viewPosition = float3((textureCoordinate.x * 2.0f - 1.0f) * ProjectionParameters.x, (1.0f - textureCoordinate.y * 2.0f) * ProjectionParameters.y, -1.0f) * linearDepth;
+
+    return mul(float4(viewPosition, 1.0f), InverseViewMatrix).xyz;
+}
+
+bool load_surface(QUAD_VS_OUTPUT IN, out SURFACE surface)
+{
+    int3 texel = int3(IN.Position.xy, 0);
+    float depth = DepthBuffer.Load(texel).x;
+    float4 specular = SpecularBuffer.Load(texel);
+
+    surface.Albedo = AlbedoBuffer.Load(texel);
+    surface.Normal = decode_normal(NormalBuffer.Load(texel).xy);
+    surface.SpecularColor = float4(specular.rgb, 1.0f);
+    surface.SpecularPower = decode_specular_power(specular.a);
+    surface.WorldPosition = get_world_position(IN.TextureCoordinate, depth);
+
+    // Nothing was drawn where the depth buffer still holds its clear value
+    return (depth < 1.0f);
+}
+
+float3 get_surface_light_contribution(SURFACE surface, float4 lightDirection)
+{
+    LIGHT_CONTRIBUTION_DATA lightContributionData;
+    lightContributionData.Color = surface.Albedo;
+    lightContributionData.Normal = surface.Normal;
+    lightContributionData.ViewDirection = normalize(CameraPosition - surface.WorldPosition);
+    lightContributionData.LightColor = LightColor;
+    lightContributionData.LightDirection = lightDirection;
+    lightContributionData.SpecularColor = surface.SpecularColor;
+    lightContributionData.SpecularPower = surface.SpecularPower;
+
+    return get_light_contribution(lightContributionData);
+}
+
+/************* Vertex Shaders *************/
+
+VS_OUTPUT geometry_vertex_shader(VS_INPUT IN)
+{
+    VS_OUTPUT OUT = (VS_OUTPUT)0;
+
+    OUT.Position = mul(IN.ObjectPosition, WorldViewProjection);
+    OUT.Normal = normalize(mul(float4(IN.Normal, 0), World).xyz);
+    OUT.TextureCoordinate = get_corrected_texture_coordinate(IN.TextureCoordinate);
+
+    return OUT;
+}
+
+QUAD_VS_OUTPUT quad_vertex_shader(QUAD_VS_INPUT IN)
+{
+    QUAD_VS_OUTPUT OUT = (QUAD_VS_OUTPUT)0;
+
+    OUT.Position = IN.Position;
+    OUT.TextureCoordinate = IN.TextureCoordinate;
+
+    return OUT;
+}
+
+/************* Pixel Shaders *************/
+
+GBUFFER_OUTPUT geometry_pixel_shader(VS_OUTPUT IN)
+{
+    GBUFFER_OUTPUT OUT = (GBUFFER_OUTPUT)0;
+
+    OUT.Albedo = ColorTexture.Sample(ColorSampler, IN.TextureCoordinate);
+    OUT.Normal = encode_normal(normalize(IN.Normal));
+    OUT.Specular = float4(SpecularColor.rgb * SpecularColor.a, encode_specular_power(SpecularPower));
+
+    return OUT;
+}
+
+float4 directional_light_pixel_shader(QUAD_VS_OUTPUT IN) : SV_Target
+{
+    SURFACE surface;
+    if (load_surface(IN, surface) == false)
+    {
+        discard;
+    }
+
+    float3 ambient = get_vector_color_contribution(AmbientColor, surface.Albedo.rgb);
+    float3 directional = get_surface_light_contribution(surface, float4(-LightDirection, 1.0f));
+
+    return float4(ambient + directional, 1.0f);
+}
+
+float4 point_light_pixel_shader(QUAD_VS_OUTPUT IN) : SV_Target
+{
+    SURFACE surface;
+    if (load_surface(IN, surface) == false)
+    {
+        discard;
+    }
+
+    float4 lightDirection = get_light_data(LightPosition, surface.WorldPosition, LightRadius);
+    if (lightDirection.w <= 0.0f)
+    {
+        discard;
+    }
+
+    // Point lights carry an outer angle of -1
+    float spotFactor = 1.0f;
+    if (SpotLightOuterAngle > -1.0f)
+    {
+        float lightAngle = dot(-LightDirection, lightDirection.xyz);
+        spotFactor = (lightAngle > 0.0f ? smoothstep(SpotLightOuterAngle, SpotLightInnerAngle, lightAngle) : 0.0f);
+    }
+
+    return float4(spotFactor * get_surface_light_contribution(surface, lightDirection), 1.0f);
+}
+
+/************* Techniques *************/
+
+technique11 deferred_geometry
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, geometry_vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, geometry_pixel_shader()));
+
+        SetRasterizerState(BackFaceCulling);
+        SetBlendState(NoBlending, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetDepthStencilState(DepthTestEnabled, 0);
+    }
+}
+
+technique11 deferred_directional_light
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, quad_vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, directional_light_pixel_shader()));
+
+        SetRasterizerState(BackFaceCulling);
+        SetBlendState(NoBlending, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetDepthStencilState(DepthTestDisabled, 0);
+    }
+}
+
+technique11 deferred_point_light
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, quad_vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, point_light_pixel_shader()));
+
+        SetRasterizerState(ScissorTest);
+        SetBlendState(AdditiveBlending, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetDepthStencilState(DepthTestDisabled, 0);
+    }
+}
\ No newline at end of file
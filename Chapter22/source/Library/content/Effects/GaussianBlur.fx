@@ -1,11 +1,13 @@
 /************* Resources *************/
 
-#define SAMPLE_COUNT 9
+#define MAX_SAMPLE_COUNT 33
 
 cbuffer CBufferPerFrame
 {
-    float2 SampleOffsets[SAMPLE_COUNT];
-    float SampleWeights[SAMPLE_COUNT];
+    float2 SampleOffsets[MAX_SAMPLE_COUNT];
+    float SampleWeights[MAX_SAMPLE_COUNT];
+    int SampleCount = 1;
+    float2 SourceTexelSize;
 }
 
 Texture2D ColorTexture;
@@ -13,8 +15,8 @@ Texture2D ColorTexture;
 SamplerState TrilinearSampler
 {
     Filter = MIN_MAG_MIP_LINEAR;
-    AddressU = WRAP;
-    AddressV = WRAP;
+    AddressU = CLAMP;
+    AddressV = CLAMP;
 };
 
 /************* Data Structures *************/
@@ -49,7 +51,8 @@ float4 blur_pixel_shader(VS_OUTPUT IN) : SV_Target
 {
     float4 color = (float4)0;
 
-    for (int i = 0; i < SAMPLE_COUNT; i++)
+    // Each sample sits between two texels so one bilinear fetch returns their weighted sum
+    for (int i = 0; i < SampleCount; i++)
     {
         color += ColorTexture.Sample(TrilinearSampler, IN.TextureCoordinate + SampleOffsets[i]) * SampleWeights[i];
     }
@@ -62,6 +65,34 @@ float4 no_blur_pixel_shader(VS_OUTPUT IN) : SV_Target
     return ColorTexture.Sample(TrilinearSampler, IN.TextureCoordinate);
 }
 
+// Dual Kawase: the centre plus four diagonal samples one source texel away
+float4 kawase_downsample_pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    float2 uv = IN.TextureCoordinate;
+    float4 color = ColorTexture.Sample(TrilinearSampler, uv) * 4;
+    color += ColorTexture.Sample(TrilinearSampler, uv + float2(-1, -1) * SourceTexelSize);
+    color += ColorTexture.Sample(TrilinearSampler, uv + float2(1, -1) * SourceTexelSize);
+    color += ColorTexture.Sample(TrilinearSampler, uv + float2(-1, 1) * SourceTexelSize);
+    color += ColorTexture.Sample(TrilinearSampler, uv + float2(1, 1) * SourceTexelSize);
+
+    return color / 8;
+}
+
+float4 kawase_upsample_pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    float2 uv = IN.TextureCoordinate;
+    float4 color = ColorTexture.Sample(TrilinearSampler, uv + float2(-1, 0) * SourceTexelSize);
+    color += ColorTexture.Sample(TrilinearSampler, uv + float2(1, 0) * SourceTexelSize);
+    color += ColorTexture.Sample(TrilinearSampler, uv + float2(0, -1) * SourceTexelSize);
+    color += ColorTexture.Sample(TrilinearSampler, uv + float2(0, 1) * SourceTexelSize);
+    color += ColorTexture.Sample(TrilinearSampler, uv + float2(-0.5f, -0.5f) * SourceTexelSize) * 2;
+    color += ColorTexture.Sample(TrilinearSampler, uv + float2(0.5f, -0.5f) * SourceTexelSize) * 2;
+    color += ColorTexture.Sample(TrilinearSampler, uv + float2(-0.5f, 0.5f) * SourceTexelSize) * 2;
+    color += ColorTexture.Sample(TrilinearSampler, uv + float2(0.5f, 0.5f) * SourceTexelSize) * 2;
+
+    return color / 12;
+}
+
 /************* Techniques *************/
 
 technique11 blur
@@ -82,4 +113,24 @@ technique11 no_blur
         SetGeometryShader(NULL);
         SetPixelShader(CompileShader(ps_5_0, no_blur_pixel_shader()));
     }
+}
+
+technique11 kawase_downsample
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, kawase_downsample_pixel_shader()));
+    }
+}
+
+technique11 kawase_upsample
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, kawase_upsample_pixel_shader()));
+    }
 }
\ No newline at end of file
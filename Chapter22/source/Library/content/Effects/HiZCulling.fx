@@ -0,0 +1,234 @@
+/************* Resources *************/
+
+#define PYRAMID_THREADS_PER_GROUP 8
+#define CULL_THREADS_PER_GROUP 64
+
+// Byte offsets of the two phases' D3D11_DRAW_INDEXED_INSTANCED_INDIRECT_ARGS in DrawArguments
+#define FIRST_PHASE_ARGUMENTS 0
+#define SECOND_PHASE_ARGUMENTS 20
+
+#define PROJECTION_INSIDE 0
+#define PROJECTION_OUTSIDE 1
+#define PROJECTION_CROSSES_NEAR_PLANE 2
+
+struct BOUNDS
+{
+    float3 Minimum;
+    float3 Maximum;
+};
+
+cbuffer CBufferPerFrame
+{
+    float4x4 ViewProjection;
+    uint InstanceCount;
+    uint InstanceStride;
+    float2 HiZSize;
+    uint HiZLevelCount;
+};
+
+Texture2D<float> SourceDepth;
+RWTexture2D<float> OutputDepth;
+Texture2D<float> HiZTexture;
+
+StructuredBuffer<BOUNDS> InstanceBounds;
+ByteAddressBuffer Instances;
+RWByteAddressBuffer VisibleInstances;
+RWByteAddressBuffer DrawArguments;
+RWByteAddressBuffer VisibilityHistory;
+
+/************* Hi-Z Pyramid *************/
+
+[numthreads(PYRAMID_THREADS_PER_GROUP, PYRAMID_THREADS_PER_GROUP, 1)]
+void copy_depth(uint3 threadID : SV_DispatchThreadID)
+{
+    uint2 outputSize;
+    OutputDepth.GetDimensions(outputSize.x, outputSize.y);
+
+    if (all(threadID.xy < outputSize))
+    {
+        OutputDepth[threadID.xy] = SourceDepth.Load(int3(threadID.xy, 0));
+    }
+}
+
+// Mip sizes truncate, so the last texel of an odd-sized level also takes the source's last row or column
+[numthreads(PYRAMID_THREADS_PER_GROUP, PYRAMID_THREADS_PER_GROUP, 1)]
+void reduce_depth(uint3 threadID : SV_DispatchThreadID)
+{
+    uint2 sourceSize;
+    uint2 outputSize;
+    SourceDepth.GetDimensions(sourceSize.x, sourceSize.y);
+    OutputDepth.GetDimensions(outputSize.x, outputSize.y);
+
+    if (any(threadID.xy >= outputSize))
+    {
+        return;
+    }
+
+    uint2 first = threadID.xy * 2;
+    uint2 last = (threadID.xy == outputSize - 1 ? sourceSize - 1 : first + 1);
+
+    float farthest = 0.0f;
+    for (uint y = first.y; y <= last.y; y++)
+    {
+        for (uint x = first.x; x <= last.x; x++)
+        {
+            farthest = max(farthest, SourceDepth.Load(int3(x, y, 0)));
+        }
+    }
+
+    OutputDepth[threadID.xy] = farthest;
+}
+
+technique11 copy_depth
+{
+    pass p0
+    {
+        SetVertexShader(NULL);
+        SetGeometryShader(NULL);
+        SetPixelShader(NULL);
+        SetComputeShader(CompileShader(cs_5_0, copy_depth()));
+    }
+}
+
+technique11 reduce_depth
+{
+    pass p0
+    {
+        SetVertexShader(NULL);
+        SetGeometryShader(NULL);
+        SetPixelShader(NULL);
+        SetComputeShader(CompileShader(cs_5_0, reduce_depth()));
+    }
+}
+
+/************* Culling *************/
+
+// Inclusive texel rectangle of the pyramid's first level and the box's nearest depth
+uint project_box(uint instance, out uint4 rectangle, out float minimumDepth)
+{
+    BOUNDS bounds = InstanceBounds[instance];
+    float2 minimumPosition = 1e30f;
+    float2 maximumPosition = -1e30f;
+    uint4 outside = 0;
+    rectangle = 0;
+    minimumDepth = 1e30f;
+
+    [unroll]
+    for (uint corner = 0; corner < 8; corner++)
+    {
+        float3 position = float3((corner & 1) ? bounds.Maximum.x : bounds.Minimum.x, (corner & 2) ? bounds.Maximum.y : bounds.Minimum.y, (corner & 4) ? bounds.Maximum.z : bounds.Minimum.z);
+        float4 clip = mul(float4(position, 1.0f), ViewProjection);
+
+        if (clip.z <= 0.0f)
+        {
+            return PROJECTION_CROSSES_NEAR_PLANE;
+        }
+
+        outside += uint4(clip.x < -clip.w, clip.x > clip.w, clip.y < -clip.w, clip.y > clip.w);
+
+        float2 screenPosition = float2(clip.x / clip.w * 0.5f + 0.5f, 0.5f - clip.y / clip.w * 0.5f);
+        minimumPosition = min(minimumPosition, screenPosition);
+        maximumPosition = max(maximumPosition, screenPosition);
+        minimumDepth = min(minimumDepth, clip.z / clip.w);
+    }
+
+    if (any(outside == 8) || minimumDepth > 1.0f)
+    {
+        return PROJECTION_OUTSIDE;
+    }
+
+    rectangle.xy = (uint2)min(max(minimumPosition * HiZSize, 0.0f), HiZSize - 1.0f);
+    rectangle.zw = max((uint2)min(max(ceil(maximumPosition * HiZSize) - 1.0f, 0.0f), HiZSize - 1.0f), rectangle.xy);
+
+    return PROJECTION_INSIDE;
+}
+
+bool is_visible(uint instance)
+{
+    uint4 rectangle;
+    float minimumDepth;
+    uint projection = project_box(instance, rectangle, minimumDepth);
+    if (projection != PROJECTION_INSIDE)
+    {
+        return (projection == PROJECTION_CROSSES_NEAR_PLANE);
+    }
+
+    // The smallest level where the rectangle spans at most two texels each way, so four loads cover it
+    uint span = max(rectangle.z - rectangle.x, rectangle.w - rectangle.y) + 1;
+    uint level = min(span > 1 ? firstbithigh(span - 1) + 1 : 0, HiZLevelCount - 1);
+    uint2 levelSize = max((uint2)HiZSize >> level, 1);
+    uint4 texels = min(rectangle >> level, levelSize.xyxy - 1);
+
+    float farthest = max(max(HiZTexture.Load(int3(texels.xy, level)), HiZTexture.Load(int3(texels.zy, level))),
+        max(HiZTexture.Load(int3(texels.xw, level)), HiZTexture.Load(int3(texels.zw, level))));
+
+    return (minimumDepth <= farthest);
+}
+
+void append_instance(uint instance, uint argumentsOffset)
+{
+    uint slot;
+    DrawArguments.InterlockedAdd(argumentsOffset + 4, 1, slot);
+
+    for (uint offset = 0; offset < InstanceStride; offset += 4)
+    {
+        VisibleInstances.Store(slot * InstanceStride + offset, Instances.Load(instance * InstanceStride + offset));
+    }
+}
+
+[numthreads(CULL_THREADS_PER_GROUP, 1, 1)]
+void cull_first_phase(uint3 threadID : SV_DispatchThreadID)
+{
+    uint instance = threadID.x;
+    if (instance >= InstanceCount || VisibilityHistory.Load(instance * 4) == 0)
+    {
+        return;
+    }
+
+    uint4 rectangle;
+    float minimumDepth;
+    if (project_box(instance, rectangle, minimumDepth) != PROJECTION_OUTSIDE)
+    {
+        append_instance(instance, FIRST_PHASE_ARGUMENTS);
+    }
+}
+
+[numthreads(CULL_THREADS_PER_GROUP, 1, 1)]
+void cull_second_phase(uint3 threadID : SV_DispatchThreadID)
+{
+    uint instance = threadID.x;
+    if (instance >= InstanceCount)
+    {
+        return;
+    }
+
+    bool isVisible = is_visible(instance);
+    if (isVisible && VisibilityHistory.Load(instance * 4) == 0)
+    {
+        append_instance(instance, SECOND_PHASE_ARGUMENTS);
+    }
+
+    VisibilityHistory.Store(instance * 4, isVisible ? 1 : 0);
+}
+
+technique11 cull_first_phase
+{
+    pass p0
+    {
+        SetVertexShader(NULL);
+        SetGeometryShader(NULL);
+        SetPixelShader(NULL);
+        SetComputeShader(CompileShader(cs_5_0, cull_first_phase()));
+    }
+}
+
+technique11 cull_second_phase
+{
+    pass p0
+    {
+        SetVertexShader(NULL);
+        SetGeometryShader(NULL);
+        SetPixelShader(NULL);
+        SetComputeShader(CompileShader(cs_5_0, cull_second_phase()));
+    }
+}
\ No newline at end of file
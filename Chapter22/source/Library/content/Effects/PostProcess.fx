@@ -0,0 +1,247 @@
+/************* Resources *************/
+
+#define THREADS_PER_GROUP 16
+#define BLUR_RADIUS 4
+#define BLUR_TAP_COUNT (BLUR_RADIUS * 2 + 1)
+
+static const float3 GrayScaleIntensity = { 0.299f, 0.587f, 0.114f };
+
+Texture2D ColorTexture;
+Texture2D BloomTexture;
+RWTexture2D<float4> OutputTexture;
+
+cbuffer CBufferPerPass
+{
+    float2 SourceSize;
+    float2 DestinationSize;
+    int Ratio;
+    float BloomThreshold;
+    float BlurWeights[BLUR_TAP_COUNT];
+};
+
+cbuffer CBufferPerObject
+{
+    float BloomIntensity = 1.25f;
+    float BloomSaturation = 1.0f;
+    float SceneIntensity = 1.0f;
+    float SceneSaturation = 1.0f;
+};
+
+SamplerState BilinearClampSampler
+{
+    Filter = MIN_MAG_LINEAR_MIP_POINT;
+    AddressU = CLAMP;
+    AddressV = CLAMP;
+};
+
+/************* Data Structures *************/
+
+struct VS_INPUT
+{
+    float4 Position : POSITION;
+    float2 TextureCoordinate : TEXCOORD;
+};
+
+struct VS_OUTPUT
+{
+    float4 Position : SV_Position;
+    float2 TextureCoordinate : TEXCOORD;
+};
+
+/************* Utility Functions *************/
+
+float4 AdjustSaturation(float4 color, float saturation)
+{
+    float intensity = dot(color.rgb, GrayScaleIntensity);
+
+    return float4(lerp(intensity.rrr, color.rgb, saturation), color.a);
+}
+
+float4 Extract(float4 color)
+{
+    return saturate((color - BloomThreshold) / (1 - BloomThreshold));
+}
+
+// Averages the Ratio x Ratio block of source texels covered by a destination texel
+float4 BoxFilter(uint2 destination, bool extract)
+{
+    uint2 sourceSize = uint2(SourceSize);
+    uint2 blockStart = destination * Ratio;
+    uint2 blockEnd = min(blockStart + Ratio, sourceSize);
+
+    float4 sum = 0;
+    for (uint y = blockStart.y; y < blockEnd.y; y++)
+    {
+        for (uint x = blockStart.x; x < blockEnd.x; x++)
+        {
+            float4 color = ColorTexture.Load(int3(x, y, 0));
+            sum += (extract ? Extract(color) : color);
+        }
+    }
+
+    uint2 blockSize = blockEnd - blockStart;
+
+    return sum / (blockSize.x * blockSize.y);
+}
+
+float4 Blur(int2 destination, int2 direction)
+{
+    int2 maximum = int2(SourceSize) - 1;
+
+    float4 sum = 0;
+    [unroll]
+    for (int i = 0; i < BLUR_TAP_COUNT; i++)
+    {
+        int2 location = clamp(destination + direction * (i - BLUR_RADIUS), 0, maximum);
+        sum += ColorTexture.Load(int3(location, 0)) * BlurWeights[i];
+    }
+
+    return sum;
+}
+
+/************* Compute Shaders *************/
+
+[numthreads(THREADS_PER_GROUP, THREADS_PER_GROUP, 1)]
+void extract_compute_shader(uint3 threadID : SV_DispatchThreadID)
+{
+    if (any(threadID.xy >= uint2(DestinationSize)))
+    {
+        return;
+    }
+
+    OutputTexture[threadID.xy] = BoxFilter(threadID.xy, true);
+}
+
+[numthreads(THREADS_PER_GROUP, THREADS_PER_GROUP, 1)]
+void downsample_compute_shader(uint3 threadID : SV_DispatchThreadID)
+{
+    if (any(threadID.xy >= uint2(DestinationSize)))
+    {
+        return;
+    }
+
+    OutputTexture[threadID.xy] = BoxFilter(threadID.xy, false);
+}
+
+[numthreads(THREADS_PER_GROUP, THREADS_PER_GROUP, 1)]
+void horizontal_blur_compute_shader(uint3 threadID : SV_DispatchThreadID)
+{
+    if (any(threadID.xy >= uint2(DestinationSize)))
+    {
+        return;
+    }
+
+    OutputTexture[threadID.xy] = Blur(threadID.xy, int2(1, 0));
+}
+
+[numthreads(THREADS_PER_GROUP, THREADS_PER_GROUP, 1)]
+void vertical_blur_compute_shader(uint3 threadID : SV_DispatchThreadID)
+{
+    if (any(threadID.xy >= uint2(DestinationSize)))
+    {
+        return;
+    }
+
+    OutputTexture[threadID.xy] = Blur(threadID.xy, int2(0, 1));
+}
+
+/************* Vertex Shader *************/
+
+VS_OUTPUT vertex_shader(VS_INPUT IN)
+{
+    VS_OUTPUT OUT = (VS_OUTPUT)0;
+
+    OUT.Position = IN.Position;
+    OUT.TextureCoordinate = IN.TextureCoordinate;
+
+    return OUT;
+}
+
+/************* Pixel Shaders *************/
+
+// The composite writes straight to the bound render target, so the final full-resolution image is never stored twice
+float4 composite_pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    float4 sceneColor = ColorTexture.Load(int3(IN.Position.xy, 0));
+    float4 bloomColor = BloomTexture.SampleLevel(BilinearClampSampler, IN.TextureCoordinate, 0);
+
+    sceneColor = AdjustSaturation(sceneColor, SceneSaturation) * SceneIntensity;
+    bloomColor = AdjustSaturation(bloomColor, BloomSaturation) * BloomIntensity;
+
+    sceneColor *= (1 - saturate(bloomColor));
+
+    return sceneColor + bloomColor;
+}
+
+float4 copy_pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    return ColorTexture.Load(int3(IN.Position.xy, 0));
+}
+
+/************* Techniques *************/
+
+technique11 extract
+{
+    pass p0
+    {
+        SetVertexShader(NULL);
+        SetGeometryShader(NULL);
+        SetPixelShader(NULL);
+        SetComputeShader(CompileShader(cs_5_0, extract_compute_shader()));
+    }
+}
+
+technique11 downsample
+{
+    pass p0
+    {
+        SetVertexShader(NULL);
+        SetGeometryShader(NULL);
+        SetPixelShader(NULL);
+        SetComputeShader(CompileShader(cs_5_0, downsample_compute_shader()));
+    }
+}
+
+technique11 horizontal_blur
+{
+    pass p0
+    {
+        SetVertexShader(NULL);
+        SetGeometryShader(NULL);
+        SetPixelShader(NULL);
+        SetComputeShader(CompileShader(cs_5_0, horizontal_blur_compute_shader()));
+    }
+}
+
+technique11 vertical_blur
+{
+    pass p0
+    {
+        SetVertexShader(NULL);
+        SetGeometryShader(NULL);
+        SetPixelShader(NULL);
+        SetComputeShader(CompileShader(cs_5_0, vertical_blur_compute_shader()));
+    }
+}
+
+technique11 composite
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, composite_pixel_shader()));
+        SetComputeShader(NULL);
+    }
+}
+
+technique11 copy
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, copy_pixel_shader()));
+        SetComputeShader(NULL);
+    }
+}
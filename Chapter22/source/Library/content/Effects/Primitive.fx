@@ -0,0 +1,94 @@
+/************* Resources *************/
+
+cbuffer CBufferPerFrame
+{
+    float4x4 ViewProjection : VIEWPROJECTION;
+    float3 LightDirection = { -0.3f, -0.8f, -0.5f };
+    float AmbientIntensity = 0.35f;
+}
+
+// DirectXTK's right-handed winding, culled as GeometricPrimitive culls it
+RasterizerState Solid
+{
+    FillMode = SOLID;
+    CullMode = BACK;
+};
+
+RasterizerState Wireframe
+{
+    FillMode = WIREFRAME;
+    CullMode = NONE;
+};
+
+/************* Data Structures *************/
+
+struct VS_INPUT
+{
+    float3 ObjectPosition : POSITION;
+    float3 Normal : NORMAL;
+    float2 TextureCoordinate : TEXCOORD;
+    row_major float4x4 World : WORLD;
+    float4 Color : COLOR;
+};
+
+struct VS_OUTPUT
+{
+    float4 Position : SV_Position;
+    float3 Normal : NORMAL;
+    float4 Color : COLOR;
+};
+
+/************* Vertex Shader *************/
+
+VS_OUTPUT vertex_shader(VS_INPUT IN)
+{
+    VS_OUTPUT OUT = (VS_OUTPUT)0;
+
+    float3 worldPosition = mul(float4(IN.ObjectPosition, 1.0f), IN.World).xyz;
+    OUT.Position = mul(float4(worldPosition, 1.0f), ViewProjection);
+    OUT.Normal = mul(float4(IN.Normal, 0.0f), IN.World).xyz;
+    OUT.Color = IN.Color;
+
+    return OUT;
+}
+
+/************* Pixel Shaders *************/
+
+// Light proxies and bounds only need their shape to read, so one fixed light shades them
+float4 solid_pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    float n_dot_l = saturate(dot(normalize(IN.Normal), -normalize(LightDirection)));
+
+    return float4(IN.Color.rgb * (AmbientIntensity + (1.0f - AmbientIntensity) * n_dot_l), IN.Color.a);
+}
+
+float4 wireframe_pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    return IN.Color;
+}
+
+/************* Techniques *************/
+
+technique11 solid
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, solid_pixel_shader()));
+
+        SetRasterizerState(Solid);
+    }
+}
+
+technique11 wireframe
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, wireframe_pixel_shader()));
+
+        SetRasterizerState(Wireframe);
+    }
+}
\ No newline at end of file
@@ -5,6 +5,8 @@ static const float4 ColorWhite = { 1, 1, 1, 1 };
 static const float3 ColorBlack = { 0, 0, 0 };
 static const float DepthBias = 0.005;
 
+#define CASCADE_COUNT 4
+
 cbuffer CBufferPerFrame
 {
     float4 AmbientColor = { 1.0f, 1.0f, 1.0f, 0.0f };
@@ -13,6 +15,12 @@ cbuffer CBufferPerFrame
     float LightRadius = 10.0f;
     float3 CameraPosition;
     float2 ShadowMapSize = { 1024.0f, 1024.0f };
+
+    float3 LightDirection = { 0.0f, -1.0f, 0.0f };
+    float3 CameraDirection;
+    float4 CascadeDistances;
+    float4x4 CascadeTextureMatrices[CASCADE_COUNT];
+    int CascadeCount = CASCADE_COUNT;
 }
 
 cbuffer CBufferPerObject
@@ -27,6 +35,7 @@ cbuffer CBufferPerObject
 
 Texture2D ColorTexture;
 Texture2D ShadowMap;
+Texture2DArray CascadedShadowMap;
 
 SamplerComparisonState PcfShadowMapSampler
 {
@@ -219,6 +228,46 @@ float4 shadow_pcf_pixel_shader(VS_OUTPUT IN) : SV_Target
     return OUT;
 }
 
+// Directional light; the cascade is chosen by view depth against each cascade's far distance
+float4 shadow_cascaded_pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    float4 OUT = (float4)0;
+
+    float3 lightDirection = normalize(-LightDirection);
+    float3 viewDirection = normalize(CameraPosition - IN.WorldPosition);
+
+    float3 normal = normalize(IN.Normal);
+    float n_dot_l = dot(normal, lightDirection);
+    float3 halfVector = normalize(lightDirection + viewDirection);
+    float n_dot_h = dot(normal, halfVector);
+
+    float4 color = ColorTexture.Sample(ColorSampler, IN.TextureCoordinate);
+    float4 lightCoefficients = lit(n_dot_l, n_dot_h, SpecularPower);
+
+    float3 ambient = get_vector_color_contribution(AmbientColor, color.rgb);
+    float3 diffuse = get_vector_color_contribution(LightColor, lightCoefficients.y * color.rgb);
+    float3 specular = get_scalar_color_contribution(SpecularColor, min(lightCoefficients.z, color.w));
+
+    float viewDepth = dot(IN.WorldPosition - CameraPosition, CameraDirection);
+    int cascade = 0;
+
+    [unroll]
+    for (int i = 0; i < CASCADE_COUNT - 1; i++)
+    {
+        cascade += (i + 1 < CascadeCount && viewDepth > CascadeDistances[i] ? 1 : 0);
+    }
+
+    float4 shadowTextureCoordinate = mul(float4(IN.WorldPosition, 1.0f), CascadeTextureMatrices[cascade]);
+    float shadow = CascadedShadowMap.SampleCmpLevelZero(PcfShadowMapSampler, float3(shadowTextureCoordinate.xy, cascade), shadowTextureCoordinate.z).x;
+    diffuse *= shadow;
+    specular *= shadow;
+
+    OUT.rgb = ambient + diffuse + specular;
+    OUT.a = 1.0f;
+
+    return OUT;
+}
+
 /************* Techniques *************/
 
 technique11 shadow_mapping
@@ -253,6 +302,18 @@ technique11 shadow_mapping_pcf
         SetGeometryShader(NULL);
         SetPixelShader(CompileShader(ps_5_0, shadow_pcf_pixel_shader()));
 
+        SetRasterizerState(BackFaceCulling);
+    }
+}
+
+technique11 shadow_mapping_cascaded
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, shadow_cascaded_pixel_shader()));
+
         SetRasterizerState(BackFaceCulling);
     }
 }
\ No newline at end of file
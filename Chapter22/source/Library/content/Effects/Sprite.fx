@@ -0,0 +1,114 @@
+/************* Resources *************/
+
+cbuffer CBufferPerFrame
+{
+    float4x4 Transform;
+}
+
+Texture2D SpriteTexture;
+
+SamplerState TrilinearSampler
+{
+    Filter = MIN_MAG_MIP_LINEAR;
+    AddressU = CLAMP;
+    AddressV = CLAMP;
+};
+
+RasterizerState DisableCulling
+{
+    CullMode = NONE;
+};
+
+// Premultiplied alpha, as SpriteBatch blends by default
+BlendState PremultipliedAlphaBlending
+{
+    BlendEnable[0] = TRUE;
+    SrcBlend = ONE;
+    DestBlend = INV_SRC_ALPHA;
+    BlendOp = ADD;
+    SrcBlendAlpha = ONE;
+    DestBlendAlpha = INV_SRC_ALPHA;
+    BlendOpAlpha = ADD;
+};
+
+DepthStencilState DepthTestDisabled
+{
+    DepthEnable = FALSE;
+    DepthWriteMask = ZERO;
+};
+
+/************* Data Structures *************/
+
+struct VS_INPUT
+{
+    float3 Position : POSITION;
+    float4 Color : COLOR;
+    float2 TextureCoordinate : TEXCOORD;
+};
+
+struct VS_OUTPUT
+{
+    float4 Position : SV_Position;
+    float4 Color : COLOR;
+    float2 TextureCoordinate : TEXCOORD;
+};
+
+/************* Vertex Shader *************/
+
+VS_OUTPUT vertex_shader(VS_INPUT IN)
+{
+    VS_OUTPUT OUT = (VS_OUTPUT)0;
+
+    OUT.Position = mul(float4(IN.Position, 1.0f), Transform);
+    OUT.Color = IN.Color;
+    OUT.TextureCoordinate = IN.TextureCoordinate;
+
+    return OUT;
+}
+
+/************* Pixel Shader *************/
+
+float4 pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    return SpriteTexture.Sample(TrilinearSampler, IN.TextureCoordinate) * IN.Color;
+}
+
+// Distance field fonts store 0.5 on the outline; the edge is blended over about a pixel at any scale
+float4 distance_field_pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    float distance = SpriteTexture.Sample(TrilinearSampler, IN.TextureCoordinate).r;
+    float width = max(fwidth(distance), 0.0001f);
+    float coverage = smoothstep(0.5f - width, 0.5f + width, distance);
+
+    return IN.Color * coverage;
+}
+
+/************* Techniques *************/
+
+technique11 sprite
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, pixel_shader()));
+
+        SetRasterizerState(DisableCulling);
+        SetBlendState(PremultipliedAlphaBlending, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetDepthStencilState(DepthTestDisabled, 0);
+    }
+}
+
+technique11 distance_field
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, distance_field_pixel_shader()));
+
+        SetRasterizerState(DisableCulling);
+        SetBlendState(PremultipliedAlphaBlending, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetDepthStencilState(DepthTestDisabled, 0);
+    }
+}
\ No newline at end of file
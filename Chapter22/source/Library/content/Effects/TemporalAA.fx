@@ -0,0 +1,150 @@
+/************* Resources *************/
+
+#define THREADS_PER_GROUP 16
+
+cbuffer CBufferPerFrame
+{
+    float4x4 Reprojection;
+    float2 JitterOffset;
+    float2 ScreenSize;
+    float BlendFactor = 0.1f;
+    uint HistoryValid;
+};
+
+Texture2D ColorTexture;
+Texture2D HistoryTexture;
+Texture2D<float> DepthTexture;
+Texture2D<float2> VelocityTexture;
+RWTexture2D<float2> OutputVelocity;
+RWTexture2D<float4> OutputColor;
+
+SamplerState BilinearClampSampler
+{
+    Filter = MIN_MAG_LINEAR_MIP_POINT;
+    AddressU = CLAMP;
+    AddressV = CLAMP;
+};
+
+/************* Data Structures *************/
+
+struct VS_INPUT
+{
+    float4 Position : POSITION;
+    float2 TextureCoordinate : TEXCOORD;
+};
+
+struct VS_OUTPUT
+{
+    float4 Position : SV_Position;
+    float2 TextureCoordinate : TEXCOORD;
+};
+
+/************* Compute Shaders *************/
+
+// Motion of static geometry under the camera; Reprojection takes jittered NDC to last frame's unjittered clip space
+[numthreads(THREADS_PER_GROUP, THREADS_PER_GROUP, 1)]
+void velocity_compute_shader(uint3 threadID : SV_DispatchThreadID)
+{
+    if (any(threadID.xy >= uint2(ScreenSize)))
+    {
+        return;
+    }
+
+    float2 textureCoordinate = (threadID.xy + 0.5f) / ScreenSize;
+    float depth = DepthTexture.Load(int3(threadID.xy, 0));
+    float4 previousPosition = mul(float4(textureCoordinate.x * 2.0f - 1.0f, 1.0f - textureCoordinate.y * 2.0f, depth, 1.0f), Reprojection);
+    float2 previousTextureCoordinate = float2(previousPosition.x / previousPosition.w * 0.5f + 0.5f, 0.5f - previousPosition.y / previousPosition.w * 0.5f);
+
+    OutputVelocity[threadID.xy] = (textureCoordinate - JitterOffset) - previousTextureCoordinate;
+}
+
+[numthreads(THREADS_PER_GROUP, THREADS_PER_GROUP, 1)]
+void resolve_compute_shader(uint3 threadID : SV_DispatchThreadID)
+{
+    if (any(threadID.xy >= uint2(ScreenSize)))
+    {
+        return;
+    }
+
+    float4 color = ColorTexture.Load(int3(threadID.xy, 0));
+    float2 historyTextureCoordinate = (threadID.xy + 0.5f) / ScreenSize - VelocityTexture.Load(int3(threadID.xy, 0));
+    if (HistoryValid == 0 || any(historyTextureCoordinate < 0.0f) || any(historyTextureCoordinate > 1.0f))
+    {
+        OutputColor[threadID.xy] = color;
+        return;
+    }
+
+    // Clamping to the neighbourhood rejects history the current frame can't have produced, which is what removes ghosting
+    int2 maximum = int2(ScreenSize) - 1;
+    float4 minimumColor = color;
+    float4 maximumColor = color;
+
+    [unroll]
+    for (int y = -1; y <= 1; y++)
+    {
+        [unroll]
+        for (int x = -1; x <= 1; x++)
+        {
+            float4 neighbour = ColorTexture.Load(int3(clamp(int2(threadID.xy) + int2(x, y), 0, maximum), 0));
+            minimumColor = min(minimumColor, neighbour);
+            maximumColor = max(maximumColor, neighbour);
+        }
+    }
+
+    float4 previousColor = clamp(HistoryTexture.SampleLevel(BilinearClampSampler, historyTextureCoordinate, 0), minimumColor, maximumColor);
+    OutputColor[threadID.xy] = lerp(previousColor, color, BlendFactor);
+}
+
+/************* Vertex Shader *************/
+
+VS_OUTPUT vertex_shader(VS_INPUT IN)
+{
+    VS_OUTPUT OUT = (VS_OUTPUT)0;
+
+    OUT.Position = IN.Position;
+    OUT.TextureCoordinate = IN.TextureCoordinate;
+
+    return OUT;
+}
+
+/************* Pixel Shader *************/
+
+float4 copy_pixel_shader(VS_OUTPUT IN) : SV_Target
+{
+    return ColorTexture.Load(int3(IN.Position.xy, 0));
+}
+
+/************* Techniques *************/
+
+technique11 velocity
+{
+    pass p0
+    {
+        SetVertexShader(NULL);
+        SetGeometryShader(NULL);
+        SetPixelShader(NULL);
+        SetComputeShader(CompileShader(cs_5_0, velocity_compute_shader()));
+    }
+}
+
+technique11 resolve
+{
+    pass p0
+    {
+        SetVertexShader(NULL);
+        SetGeometryShader(NULL);
+        SetPixelShader(NULL);
+        SetComputeShader(CompileShader(cs_5_0, resolve_compute_shader()));
+    }
+}
+
+technique11 copy
+{
+    pass p0
+    {
+        SetVertexShader(CompileShader(vs_5_0, vertex_shader()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, copy_pixel_shader()));
+        SetComputeShader(NULL);
+    }
+}
\ No newline at end of file
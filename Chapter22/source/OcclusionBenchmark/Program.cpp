@@ -0,0 +1,407 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "OcclusionBuffer.h"
+#include "ThreadPool.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: OcclusionBenchmark [-iterations count] [-resolution width height] [-verify] [city sizes...]\n"
+		"Times occluder rasterization and box queries for a street-level view of a square grid of buildings (default 16 32 64 per side).\n";
+
+	const float FieldOfView = 1.0471976f;
+	const float NearPlaneDistance = 0.5f;
+	const float FarPlaneDistance = 1000.0f;
+	const float BlockSize = 20.0f;
+	const float StreetWidth = 8.0f;
+	const unsigned int ObjectsPerBlock = 16;
+
+	// Fixed-seed generator, so every run draws the same city
+	float Random(unsigned int& seed)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		return (seed >> 8) / 16777216.0f;
+	}
+
+	void Cross(const float a[3], const float b[3], float result[3])
+	{
+		result[0] = a[1] * b[2] - a[2] * b[1];
+		result[1] = a[2] * b[0] - a[0] * b[2];
+		result[2] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	void Normalize(float vector[3])
+	{
+		float length = sqrtf(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+		for (int i = 0; i < 3; i++)
+		{
+			vector[i] /= length;
+		}
+	}
+
+	// Same layout and conventions as XMMatrixLookToRH * XMMatrixPerspectiveFovRH
+	void ViewProjectionMatrix(const float eye[3], const float direction[3], float aspectRatio, float matrix[16])
+	{
+		float up[3] = { 0.0f, 1.0f, 0.0f };
+		float zAxis[3] = { -direction[0], -direction[1], -direction[2] };
+		Normalize(zAxis);
+		float xAxis[3];
+		Cross(up, zAxis, xAxis);
+		Normalize(xAxis);
+		float yAxis[3];
+		Cross(zAxis, xAxis, yAxis);
+
+		float view[16] =
+		{
+			xAxis[0], yAxis[0], zAxis[0], 0.0f,
+			xAxis[1], yAxis[1], zAxis[1], 0.0f,
+			xAxis[2], yAxis[2], zAxis[2], 0.0f,
+			-(xAxis[0] * eye[0] + xAxis[1] * eye[1] + xAxis[2] * eye[2]),
+			-(yAxis[0] * eye[0] + yAxis[1] * eye[1] + yAxis[2] * eye[2]),
+			-(zAxis[0] * eye[0] + zAxis[1] * eye[1] + zAxis[2] * eye[2]), 1.0f
+		};
+
+		float height = 1.0f / tanf(FieldOfView * 0.5f);
+		float range = FarPlaneDistance / (NearPlaneDistance - FarPlaneDistance);
+		float projection[16] =
+		{
+			height / aspectRatio, 0.0f, 0.0f, 0.0f,
+			0.0f, height, 0.0f, 0.0f,
+			0.0f, 0.0f, range, -1.0f,
+			0.0f, 0.0f, range * NearPlaneDistance, 0.0f
+		};
+
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				matrix[row * 4 + column] = 0.0f;
+				for (int i = 0; i < 4; i++)
+				{
+					matrix[row * 4 + column] += view[row * 4 + i] * projection[i * 4 + column];
+				}
+			}
+		}
+	}
+
+	// Buildings are boxes wound clockwise seen from outside, like the Library's models after FlipWindingOrder
+	void CreateCity(unsigned int citySize, std::vector<float>& vertices, std::vector<unsigned int>& indices, std::vector<OcclusionBox>& objects)
+	{
+		static const unsigned int FaceIndices[] =
+		{
+			0, 1, 3, 0, 3, 2,	4, 6, 7, 4, 7, 5,	0, 4, 5, 0, 5, 1,
+			2, 3, 7, 2, 7, 6,	0, 2, 6, 0, 6, 4,	1, 5, 7, 1, 7, 3
+		};
+
+		unsigned int seed = 12345;
+		for (unsigned int blockZ = 0; blockZ < citySize; blockZ++)
+		{
+			for (unsigned int blockX = 0; blockX < citySize; blockX++)
+			{
+				float minimum[3] = { blockX * (BlockSize + StreetWidth), 0.0f, -(blockZ * (BlockSize + StreetWidth) + BlockSize) };
+				float maximum[3] = { minimum[0] + BlockSize, 10.0f + Random(seed) * 40.0f, minimum[2] + BlockSize };
+
+				unsigned int baseVertex = static_cast<unsigned int>(vertices.size() / 3);
+				for (unsigned int corner = 0; corner < 8; corner++)
+				{
+					vertices.push_back(corner & 1 ? maximum[0] : minimum[0]);
+					vertices.push_back(corner & 2 ? maximum[1] : minimum[1]);
+					vertices.push_back(corner & 4 ? maximum[2] : minimum[2]);
+				}
+
+				for (unsigned int index : FaceIndices)
+				{
+					indices.push_back(baseVertex + index);
+				}
+
+				// Small objects along the streets and on the roofs
+				for (unsigned int i = 0; i < ObjectsPerBlock; i++)
+				{
+					OcclusionBox object;
+					bool isOnRoof = (Random(seed) < 0.25f);
+					float x = minimum[0] - StreetWidth + Random(seed) * (BlockSize + StreetWidth);
+					float z = minimum[2] + Random(seed) * (BlockSize + StreetWidth);
+					float size = 0.5f + Random(seed) * 1.5f;
+					if (isOnRoof)
+					{
+						x = minimum[0] + Random(seed) * (BlockSize - size);
+						z = minimum[2] + Random(seed) * (BlockSize - size);
+					}
+
+					object.Minimum[0] = x;
+					object.Minimum[1] = (isOnRoof ? maximum[1] : 0.0f);
+					object.Minimum[2] = z;
+					object.Maximum[0] = x + size;
+					object.Maximum[1] = object.Minimum[1] + size;
+					object.Maximum[2] = z + size;
+					objects.push_back(object);
+				}
+			}
+		}
+	}
+
+	// Exact depth at every pixel centre from all faces of every occluder, in double precision and without the guard band
+	void ReferenceDepth(const std::vector<float>& vertices, const std::vector<unsigned int>& indices, const float* matrix, unsigned int width, unsigned int height, std::vector<double>& depth)
+	{
+		depth.assign(width * height, 1.0);
+
+		for (size_t triangle = 0; triangle < indices.size(); triangle += 3)
+		{
+			double clip[4][4];
+			unsigned int clipCount = 0;
+			double input[3][4];
+			for (int i = 0; i < 3; i++)
+			{
+				const float* position = &vertices[indices[triangle + i] * 3];
+				for (int j = 0; j < 4; j++)
+				{
+					input[i][j] = position[0] * matrix[j] + position[1] * matrix[4 + j] + position[2] * matrix[8 + j] + matrix[12 + j];
+				}
+			}
+
+			for (int i = 0; i < 3; i++)
+			{
+				const double* current = input[i];
+				const double* next = input[(i + 1) % 3];
+				if (current[2] >= 0.0)
+				{
+					memcpy(clip[clipCount++], current, sizeof(clip[0]));
+				}
+
+				if ((current[2] >= 0.0) != (next[2] >= 0.0))
+				{
+					double t = current[2] / (current[2] - next[2]);
+					for (int j = 0; j < 4; j++)
+					{
+						clip[clipCount][j] = current[j] + (next[j] - current[j]) * t;
+					}
+
+					clipCount++;
+				}
+			}
+
+			double screen[4][3];
+			for (unsigned int i = 0; i < clipCount; i++)
+			{
+				screen[i][0] = (clip[i][0] / clip[i][3] * 0.5 + 0.5) * width;
+				screen[i][1] = (0.5 - clip[i][1] / clip[i][3] * 0.5) * height;
+				screen[i][2] = clip[i][2] / clip[i][3];
+			}
+
+			for (unsigned int i = 1; i + 1 < clipCount; i++)
+			{
+				const double* p0 = screen[0];
+				const double* p1 = screen[i];
+				const double* p2 = screen[i + 1];
+				double area = (p1[0] - p0[0]) * (p2[1] - p0[1]) - (p2[0] - p0[0]) * (p1[1] - p0[1]);
+				if (fabs(area) < 1e-12)
+				{
+					continue;
+				}
+
+				int minimumX = std::max(static_cast<int>(floor(std::min(std::min(p0[0], p1[0]), p2[0]))), 0);
+				int minimumY = std::max(static_cast<int>(floor(std::min(std::min(p0[1], p1[1]), p2[1]))), 0);
+				int maximumX = std::min(static_cast<int>(ceil(std::max(std::max(p0[0], p1[0]), p2[0]))), static_cast<int>(width) - 1);
+				int maximumY = std::min(static_cast<int>(ceil(std::max(std::max(p0[1], p1[1]), p2[1]))), static_cast<int>(height) - 1);
+
+				for (int y = minimumY; y <= maximumY; y++)
+				{
+					for (int x = minimumX; x <= maximumX; x++)
+					{
+						double px = x + 0.5;
+						double py = y + 0.5;
+						double w0 = ((p1[0] - px) * (p2[1] - py) - (p2[0] - px) * (p1[1] - py)) / area;
+						double w1 = ((p2[0] - px) * (p0[1] - py) - (p0[0] - px) * (p2[1] - py)) / area;
+						double w2 = 1.0 - w0 - w1;
+
+						// Slightly inclusive, so pixel centres on shared edges never go uncovered here
+						if (w0 >= -1e-6 && w1 >= -1e-6 && w2 >= -1e-6)
+						{
+							double& pixelDepth = depth[y * width + x];
+							pixelDepth = std::min(pixelDepth, w0 * p0[2] + w1 * p1[2] + w2 * p2[2]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// The buffer must never claim a pixel is nearer than it is, and every box it hides must be behind the exact depth
+	// over the whole of its screen rectangle
+	bool Verify(const OcclusionBuffer& buffer, const std::vector<float>& vertices, const std::vector<unsigned int>& indices, const float* matrix,
+		const std::vector<OcclusionBox>& objects, const std::vector<OcclusionResult>& results)
+	{
+		unsigned int width = buffer.Width();
+		unsigned int height = buffer.Height();
+		std::vector<double> reference;
+		ReferenceDepth(vertices, indices, matrix, width, height, reference);
+
+		std::vector<float> resolved;
+		buffer.ResolveDepth(resolved);
+		for (unsigned int pixel = 0; pixel < width * height; pixel++)
+		{
+			if (reference[pixel] > resolved[pixel] + 1e-5)
+			{
+				fprintf(stderr, "pixel (%u, %u): buffer depth %g is nearer than the exact depth %g\n", pixel % width, pixel / width, resolved[pixel], reference[pixel]);
+				return false;
+			}
+		}
+
+		for (size_t i = 0; i < objects.size(); i++)
+		{
+			if (results[i] != OcclusionResultOccluded)
+			{
+				continue;
+			}
+
+			double minimumX = 1e30;
+			double minimumY = 1e30;
+			double maximumX = -1e30;
+			double maximumY = -1e30;
+			double minimumDepth = 1e30;
+			for (unsigned int corner = 0; corner < 8; corner++)
+			{
+				const OcclusionBox& box = objects[i];
+				double position[3] = { (corner & 1 ? box.Maximum[0] : box.Minimum[0]), (corner & 2 ? box.Maximum[1] : box.Minimum[1]), (corner & 4 ? box.Maximum[2] : box.Minimum[2]) };
+				double clip[4];
+				for (int j = 0; j < 4; j++)
+				{
+					clip[j] = position[0] * matrix[j] + position[1] * matrix[4 + j] + position[2] * matrix[8 + j] + matrix[12 + j];
+				}
+
+				minimumX = std::min(minimumX, (clip[0] / clip[3] * 0.5 + 0.5) * width);
+				maximumX = std::max(maximumX, (clip[0] / clip[3] * 0.5 + 0.5) * width);
+				minimumY = std::min(minimumY, (0.5 - clip[1] / clip[3] * 0.5) * height);
+				maximumY = std::max(maximumY, (0.5 - clip[1] / clip[3] * 0.5) * height);
+				minimumDepth = std::min(minimumDepth, clip[2] / clip[3]);
+			}
+
+			for (int y = std::max(static_cast<int>(floor(minimumY)), 0); y < std::min(static_cast<int>(ceil(maximumY)), static_cast<int>(height)); y++)
+			{
+				for (int x = std::max(static_cast<int>(floor(minimumX)), 0); x < std::min(static_cast<int>(ceil(maximumX)), static_cast<int>(width)); x++)
+				{
+					if (reference[y * width + x] >= minimumDepth - 1e-5)
+					{
+						fprintf(stderr, "object %u: reported occluded but visible at pixel (%d, %d)\n", static_cast<unsigned int>(i), x, y);
+						return false;
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int iterationCount = 20;
+	unsigned int width = 1280;
+	unsigned int height = 720;
+	bool isVerifying = false;
+	std::vector<unsigned int> citySizes;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-iterations") == 0 && i + 1 < argc)
+		{
+			iterationCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-resolution") == 0 && i + 2 < argc)
+		{
+			width = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+			height = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-verify") == 0)
+		{
+			isVerifying = true;
+		}
+		else if (argv[i][0] == '-' || atoi(argv[i]) <= 0)
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+		else
+		{
+			citySizes.push_back(static_cast<unsigned int>(atoi(argv[i])));
+		}
+	}
+
+	if (citySizes.empty())
+	{
+		unsigned int defaultCitySizes[] = { 16, 32, 64 };
+		citySizes.assign(defaultCitySizes, defaultCitySizes + 3);
+	}
+
+	ThreadPool threadPool;
+	OcclusionBuffer buffer(width, height);
+
+	printf("%u x %u buffer, %u x %u tiles, %u worker threads, best of %u frames\n\n", width, height, buffer.TileCountX(), buffer.TileCountY(), threadPool.ThreadCount(), iterationCount);
+	printf("%6s %10s %10s %12s %12s %12s %12s %10s %10s\n", "city", "triangles", "objects", "raster ms", "pooled ms", "query ms", "pooled ms", "occluded", "off view");
+
+	int result = 0;
+	for (unsigned int citySize : citySizes)
+	{
+		std::vector<float> vertices;
+		std::vector<unsigned int> indices;
+		std::vector<OcclusionBox> objects;
+		CreateCity(citySize, vertices, indices, objects);
+
+		// Standing in the street at one corner of the city, looking across it
+		float eye[3] = { -StreetWidth * 0.5f, 1.7f, StreetWidth * 0.5f };
+		float direction[3] = { 1.0f, -0.05f, -1.0f };
+		float viewProjectionMatrix[16];
+		ViewProjectionMatrix(eye, direction, static_cast<float>(width) / height, viewProjectionMatrix);
+
+		unsigned int triangleCount = static_cast<unsigned int>(indices.size() / 3);
+		std::vector<OcclusionResult> results;
+		double rasterizeTime[2] = { 1e30, 1e30 };
+		double queryTime[2] = { 1e30, 1e30 };
+		for (unsigned int i = 0; i < iterationCount; i++)
+		{
+			for (int pooled = 0; pooled < 2; pooled++)
+			{
+				ThreadPool* pool = (pooled ? &threadPool : nullptr);
+
+				auto start = std::chrono::high_resolution_clock::now();
+				buffer.Clear();
+				buffer.AddOccluder(&vertices[0], sizeof(float) * 3, &indices[0], triangleCount, viewProjectionMatrix);
+				buffer.Rasterize(pool);
+				rasterizeTime[pooled] = std::min(rasterizeTime[pooled], Milliseconds(std::chrono::high_resolution_clock::now() - start));
+
+				start = std::chrono::high_resolution_clock::now();
+				buffer.TestBoxes(objects, viewProjectionMatrix, results, pool);
+				queryTime[pooled] = std::min(queryTime[pooled], Milliseconds(std::chrono::high_resolution_clock::now() - start));
+			}
+		}
+
+		unsigned int counts[OcclusionResultEnd] = { 0 };
+		for (OcclusionResult objectResult : results)
+		{
+			counts[objectResult]++;
+		}
+
+		printf("%6u %10u %10u %12.3f %12.3f %12.3f %12.3f %10u %10u\n", citySize, triangleCount, static_cast<unsigned int>(objects.size()),
+			rasterizeTime[0], rasterizeTime[1], queryTime[0], queryTime[1], counts[OcclusionResultOccluded], counts[OcclusionResultViewCulled]);
+
+		if (isVerifying && Verify(buffer, vertices, indices, viewProjectionMatrix, objects, results) == false)
+		{
+			fprintf(stderr, "city %u: occlusion results do not match the exact depth buffer\n", citySize);
+			result = 1;
+		}
+	}
+
+	return result;
+}
\ No newline at end of file
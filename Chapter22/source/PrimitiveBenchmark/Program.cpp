@@ -0,0 +1,234 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "PrimitiveGeometry.h"
+#include "ThreadPool.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: PrimitiveBenchmark [-iterations count] [-threads count]\n"
+		"Times generating each GeometricPrimitive shape, at DirectXTK's default tessellation and a fine one, on one thread as\n"
+		"every Create call does (default 20 iterations), on the thread pool, and finding it in a ContentManager-style cache.\n"
+		"Checks the parallel meshes match, the left-handed ones mirror the right-handed, and the closed shapes' volumes.\n";
+
+	const double Pi = 3.14159265358979;
+
+	// Unit sizes as PrimitiveGeometry generates them; the teapot isn't closed, so it has no volume to check
+	const double Volumes[] = { 1.0, Pi / 6.0, Pi / 6.0, Pi / 4.0, Pi / 12.0, 2.0 * Pi * Pi * 0.5 * 0.1665 * 0.1665, 0.0 };
+	const unsigned int FineTessellations[] = { 0, 128, 7, 1024, 1024, 256, 64 };
+	const unsigned int LookupCount = 100000;
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	// Negative for DirectXTK's right-handed winding
+	double SignedVolume(const std::vector<PrimitiveVertex>& vertices, const std::vector<unsigned int>& indices)
+	{
+		double volume = 0.0;
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const float* a = vertices[indices[i]].Position;
+			const float* b = vertices[indices[i + 1]].Position;
+			const float* c = vertices[indices[i + 2]].Position;
+			volume += a[0] * (static_cast<double>(b[1]) * c[2] - static_cast<double>(b[2]) * c[1]) +
+				a[1] * (static_cast<double>(b[2]) * c[0] - static_cast<double>(b[0]) * c[2]) +
+				a[2] * (static_cast<double>(b[0]) * c[1] - static_cast<double>(b[1]) * c[0]);
+		}
+
+		return volume / 6.0;
+	}
+
+	const char* CheckMesh(const std::vector<PrimitiveVertex>& vertices, const std::vector<unsigned int>& indices)
+	{
+		if (indices.size() % 3 != 0)
+		{
+			return "a partial triangle";
+		}
+
+		for (unsigned int index : indices)
+		{
+			if (index >= vertices.size())
+			{
+				return "an index out of range";
+			}
+		}
+
+		for (const PrimitiveVertex& vertex : vertices)
+		{
+			float length = sqrtf(vertex.Normal[0] * vertex.Normal[0] + vertex.Normal[1] * vertex.Normal[1] + vertex.Normal[2] * vertex.Normal[2]);
+			if (fabsf(length - 1.0f) > 1e-3f)
+			{
+				return "a normal that isn't unit length";
+			}
+		}
+
+		return nullptr;
+	}
+
+	// DirectXTK flips the right-handed mesh: each triangle's first and last index swapped, and u mirrored
+	bool IsMirrored(const std::vector<PrimitiveVertex>& rightHandedVertices, const std::vector<unsigned int>& rightHandedIndices,
+		const std::vector<PrimitiveVertex>& vertices, const std::vector<unsigned int>& indices)
+	{
+		if (vertices.size() != rightHandedVertices.size() || indices.size() != rightHandedIndices.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			if (indices[i] != rightHandedIndices[i + 2] || indices[i + 1] != rightHandedIndices[i + 1] || indices[i + 2] != rightHandedIndices[i])
+			{
+				return false;
+			}
+		}
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			if (memcmp(vertices[i].Position, rightHandedVertices[i].Position, sizeof(float) * 6) != 0 ||
+				vertices[i].TextureCoordinates[0] != 1.0f - rightHandedVertices[i].TextureCoordinates[0])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int iterationCount = 20;
+	unsigned int threadCount = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-iterations") == 0 && i + 1 < argc)
+		{
+			iterationCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc)
+		{
+			threadCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+	}
+
+	ThreadPool threadPool(threadCount);
+
+	// ContentManager::DemandCreate(): a lock, the key, a map lookup and a weak pointer promoted
+	typedef std::pair<std::vector<PrimitiveVertex>, std::vector<unsigned int>> Mesh;
+	std::map<std::wstring, std::weak_ptr<Mesh>> cache;
+	std::vector<std::shared_ptr<Mesh>> liveMeshes;
+	std::mutex cacheMutex;
+
+	printf("%u iterations, %u threads\n\n", iterationCount, threadPool.ThreadCount());
+	printf("%-10s %6s %9s %10s %10s %11s %11s %10s %8s\n", "shape", "tess", "vertices", "triangles", "create ms", "parallel ms", "cached us", "speedup", "volume");
+
+	int result = 0;
+	for (unsigned int shapeIndex = 0; shapeIndex < PrimitiveShapeEnd; shapeIndex++)
+	{
+		PrimitiveShape shape = static_cast<PrimitiveShape>(shapeIndex);
+		unsigned int tessellations[2] = { PrimitiveGeometry::DefaultTessellation(shape), FineTessellations[shape] };
+
+		for (unsigned int detail = 0; detail < (shape == PrimitiveShapeCube ? 1U : 2U); detail++)
+		{
+			unsigned int tessellation = tessellations[detail];
+			std::vector<PrimitiveVertex> vertices;
+			std::vector<unsigned int> indices;
+			std::vector<PrimitiveVertex> parallelVertices;
+			std::vector<unsigned int> parallelIndices;
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (unsigned int i = 0; i < iterationCount; i++)
+			{
+				PrimitiveGeometry::Generate(shape, tessellation, true, vertices, indices);
+			}
+
+			double createTime = Milliseconds(std::chrono::high_resolution_clock::now() - start) / iterationCount;
+
+			start = std::chrono::high_resolution_clock::now();
+			for (unsigned int i = 0; i < iterationCount; i++)
+			{
+				PrimitiveGeometry::Generate(shape, tessellation, true, parallelVertices, parallelIndices, &threadPool);
+			}
+
+			double parallelTime = Milliseconds(std::chrono::high_resolution_clock::now() - start) / iterationCount;
+
+			std::wstring key = PrimitiveGeometry::CacheKey(shape, tessellation, true);
+			std::shared_ptr<Mesh> mesh(new Mesh(vertices, indices));
+			cache[key] = mesh;
+			liveMeshes.push_back(mesh);
+
+			start = std::chrono::high_resolution_clock::now();
+			size_t foundCount = 0;
+			for (unsigned int i = 0; i < LookupCount; i++)
+			{
+				std::lock_guard<std::mutex> lock(cacheMutex);
+				auto it = cache.find(PrimitiveGeometry::CacheKey(shape, tessellation, true));
+				std::shared_ptr<Mesh> found = (it != cache.end() ? it->second.lock() : nullptr);
+				foundCount += (found != nullptr ? 1 : 0);
+			}
+
+			double lookupTime = Milliseconds(std::chrono::high_resolution_clock::now() - start) * 1000.0 / LookupCount;
+
+			double volume = SignedVolume(vertices, indices);
+			printf("%-10s %6u %9u %10u %10.3f %11.3f %11.3f %9.0fx %8.4f\n", PrimitiveGeometry::ShapeNames[shape], tessellation,
+				static_cast<unsigned int>(vertices.size()), static_cast<unsigned int>(indices.size() / 3), createTime, parallelTime, lookupTime,
+				createTime * 1000.0 / lookupTime, -volume);
+
+			const char* meshError = CheckMesh(vertices, indices);
+			if (meshError != nullptr)
+			{
+				fprintf(stderr, "%s %u: %s\n", PrimitiveGeometry::ShapeNames[shape], tessellation, meshError);
+				result = 1;
+			}
+
+			if (parallelVertices.size() != vertices.size() || parallelIndices != indices ||
+				memcmp(&parallelVertices[0], &vertices[0], sizeof(PrimitiveVertex) * vertices.size()) != 0)
+			{
+				fprintf(stderr, "%s %u: the parallel mesh differs\n", PrimitiveGeometry::ShapeNames[shape], tessellation);
+				result = 1;
+			}
+
+			std::vector<PrimitiveVertex> leftHandedVertices;
+			std::vector<unsigned int> leftHandedIndices;
+			PrimitiveGeometry::Generate(shape, tessellation, false, leftHandedVertices, leftHandedIndices, &threadPool);
+			if (IsMirrored(vertices, indices, leftHandedVertices, leftHandedIndices) == false)
+			{
+				fprintf(stderr, "%s %u: the left-handed mesh doesn't mirror the right-handed\n", PrimitiveGeometry::ShapeNames[shape], tessellation);
+				result = 1;
+			}
+
+			if (Volumes[shape] > 0.0 && fabs(-volume - Volumes[shape]) > Volumes[shape] * 0.05)
+			{
+				fprintf(stderr, "%s %u: encloses %g rather than %g\n", PrimitiveGeometry::ShapeNames[shape], tessellation, -volume, Volumes[shape]);
+				result = 1;
+			}
+
+			if (foundCount != LookupCount)
+			{
+				fprintf(stderr, "%s %u: cache lookups failed\n", PrimitiveGeometry::ShapeNames[shape], tessellation);
+				result = 1;
+			}
+		}
+	}
+
+	return result;
+}
\ No newline at end of file
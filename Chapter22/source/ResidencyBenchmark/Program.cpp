@@ -0,0 +1,224 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "TextureResidency.h"
+#include "DDSFile.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: ResidencyBenchmark [-budget megabytes] [-upload megabytes] [-textures count] [-frames count]\n"
+		"Flies a camera down a street of textured objects and streams their mips under the budget (default 128 MB,\n"
+		"8 MB a frame, 400 textures, 600 frames), checking every residency change against the budget and upload limit.\n";
+
+	const float FieldOfView = 0.785398f;
+	const unsigned int ScreenHeight = 1080;
+	const float StreetLength = 2000.0f;
+	const float StreetWidth = 8.0f;
+	const float ViewDistance = 200.0f;
+	const unsigned int SettleFrameCount = 300;
+
+	typedef struct _SceneObject
+	{
+		float Position[2];
+		float UVDensity;
+		unsigned int Texture;
+	} SceneObject;
+
+	// Fixed-seed generator, so every run streams the same scene
+	float Random(unsigned int& seed)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		return (seed >> 8) / 16777216.0f;
+	}
+
+	void MipSizes(unsigned int size, unsigned int format, std::vector<unsigned long long>& mipSizes)
+	{
+		mipSizes.clear();
+		for (unsigned int mipSize = size; ; mipSize /= 2)
+		{
+			unsigned int rowPitch;
+			unsigned int rowCount;
+			DDSFile::SurfaceInfo(mipSize, mipSize, format, rowPitch, rowCount);
+			mipSizes.push_back(static_cast<unsigned long long>(rowPitch) * rowCount);
+
+			if (mipSize == 1)
+			{
+				break;
+			}
+		}
+	}
+
+	double Megabytes(unsigned long long bytes)
+	{
+		return bytes / 1048576.0;
+	}
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	TextureResidencySettings settings = TextureResidency::DefaultSettings;
+	settings.BudgetBytes = 128ULL * 1024 * 1024;
+	unsigned int textureCount = 400;
+	unsigned int frameCount = 600;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-budget") == 0 && i + 1 < argc)
+		{
+			settings.BudgetBytes = static_cast<unsigned long long>(std::max(atoi(argv[++i]), 1)) * 1024 * 1024;
+		}
+		else if (strcmp(argv[i], "-upload") == 0 && i + 1 < argc)
+		{
+			settings.UploadBytesPerFrame = static_cast<unsigned long long>(std::max(atoi(argv[++i]), 1)) * 1024 * 1024;
+		}
+		else if (strcmp(argv[i], "-textures") == 0 && i + 1 < argc)
+		{
+			textureCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc)
+		{
+			frameCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+	}
+
+	// Objects line both sides of the street, each with its own BC1 or BC7 texture of 512 to 4096 texels
+	TextureResidency residency(settings);
+	residency.SetView(FieldOfView, ScreenHeight);
+
+	unsigned int seed = 12345;
+	std::vector<SceneObject> objects(textureCount);
+	std::vector<unsigned long long> mipSizes;
+	std::vector<std::vector<unsigned long long>> textureMipSizes(textureCount);
+	std::vector<unsigned int> residentMips(textureCount);
+	unsigned long long fullSize = 0;
+	for (unsigned int i = 0; i < textureCount; i++)
+	{
+		SceneObject& object = objects[i];
+		object.Position[0] = (i % 2 == 0 ? -1.0f : 1.0f) * StreetWidth * (0.5f + Random(seed));
+		object.Position[1] = Random(seed) * StreetLength;
+		object.UVDensity = 1.0f + Random(seed) * 3.0f;
+
+		unsigned int size = 512U << static_cast<unsigned int>(Random(seed) * 4.0f);
+		MipSizes(size, (Random(seed) < 0.5f ? DDSFormatBC1Unorm : DDSFormatBC7Unorm), mipSizes);
+		object.Texture = residency.AddTexture(size, size, mipSizes);
+		textureMipSizes[object.Texture] = mipSizes;
+		residentMips[object.Texture] = residency.ResidentMip(object.Texture);
+
+		for (unsigned long long mipSize : mipSizes)
+		{
+			fullSize += mipSize;
+		}
+	}
+
+	printf("%u textures, %.0f MB with every mip, budget %.0f MB, %.0f MB a frame\n\n", textureCount, Megabytes(fullSize), Megabytes(settings.BudgetBytes), Megabytes(settings.UploadBytesPerFrame));
+	printf("%6s %10s %10s %10s %10s %10s %10s %10s\n", "frame", "resident", "wanted", "missing", "loaded", "evicted", "limited", "update us");
+
+	int result = 0;
+	double updateTime = 0.0;
+	double maximumUpdateTime = 0.0;
+	unsigned long long maximumResidentBytes = 0;
+	for (unsigned int frame = 0; frame < frameCount + SettleFrameCount; frame++)
+	{
+		// Down the street and back, then standing still at the far end while streaming settles
+		float progress = std::min(static_cast<float>(frame) / frameCount, 1.0f);
+		float cameraZ = StreetLength * (progress < 0.5f ? progress * 2.0f : 2.0f - progress * 2.0f);
+
+		for (const SceneObject& object : objects)
+		{
+			float distance = sqrtf(object.Position[0] * object.Position[0] + (object.Position[1] - cameraZ) * (object.Position[1] - cameraZ));
+			if (distance < ViewDistance)
+			{
+				residency.RequestSurface(object.Texture, object.UVDensity, distance);
+			}
+		}
+
+		auto start = std::chrono::high_resolution_clock::now();
+		const std::vector<TextureResidencyChange>& changes = residency.Update();
+		double elapsed = Milliseconds(std::chrono::high_resolution_clock::now() - start);
+		updateTime += elapsed;
+		maximumUpdateTime = std::max(maximumUpdateTime, elapsed);
+
+		// Replays the changes as a renderer would, checking them against the limits
+		unsigned long long loadedBytes = 0;
+		for (const TextureResidencyChange& change : changes)
+		{
+			if (change.PreviousMip != residentMips[change.Texture])
+			{
+				fprintf(stderr, "frame %u: texture %u changed from mip %u, but mip %u was resident\n", frame, change.Texture, change.PreviousMip, residentMips[change.Texture]);
+				result = 1;
+			}
+
+			for (unsigned int mip = change.ResidentMip; mip < change.PreviousMip; mip++)
+			{
+				loadedBytes += textureMipSizes[change.Texture][mip];
+			}
+
+			residentMips[change.Texture] = change.ResidentMip;
+		}
+
+		unsigned long long residentBytes = 0;
+		unsigned long long pinnedBytes = 0;
+		for (unsigned int texture = 0; texture < textureCount; texture++)
+		{
+			for (unsigned int mip = 0; mip < textureMipSizes[texture].size(); mip++)
+			{
+				residentBytes += (mip >= residentMips[texture] ? textureMipSizes[texture][mip] : 0);
+				pinnedBytes += (mip >= residency.PinnedMip(texture) ? textureMipSizes[texture][mip] : 0);
+			}
+		}
+
+		const TextureResidencyStatistics& statistics = residency.Statistics();
+		maximumResidentBytes = std::max(maximumResidentBytes, residentBytes);
+		if (residentBytes != statistics.ResidentBytes || residentBytes > std::max(settings.BudgetBytes, pinnedBytes))
+		{
+			fprintf(stderr, "frame %u: %llu bytes resident, %llu reported, budget %llu\n", frame, residentBytes, statistics.ResidentBytes, settings.BudgetBytes);
+			result = 1;
+		}
+
+		// A mip evicted for a lowered budget can be loaded back in the same update, so the net change may be smaller
+		if (loadedBytes > statistics.LoadedBytes)
+		{
+			fprintf(stderr, "frame %u: %llu bytes loaded, %llu reported\n", frame, loadedBytes, statistics.LoadedBytes);
+			result = 1;
+		}
+
+		if (statistics.LoadedBytes > settings.UploadBytesPerFrame && statistics.LoadedMipCount > 1)
+		{
+			fprintf(stderr, "frame %u: %llu bytes loaded over %u mips, past the upload limit\n", frame, statistics.LoadedBytes, statistics.LoadedMipCount);
+			result = 1;
+		}
+
+		if (frame % 60 == 0 || frame + 1 == frameCount + SettleFrameCount)
+		{
+			printf("%6u %8.1fMB %8.1fMB %10u %8.1fMB %8.1fMB %10u %10.1f\n", frame, Megabytes(statistics.ResidentBytes), Megabytes(statistics.WantedBytes),
+				statistics.MissingMipCount, Megabytes(statistics.LoadedBytes), Megabytes(statistics.EvictedBytes), statistics.BudgetLimitedCount, elapsed * 1000.0);
+		}
+	}
+
+	const TextureResidencyStatistics& statistics = residency.Statistics();
+	printf("\npeak %.1f MB resident, update %.3f ms average, %.3f ms worst\n", Megabytes(maximumResidentBytes), updateTime / (frameCount + SettleFrameCount), maximumUpdateTime);
+	if (statistics.WantedBytes <= settings.BudgetBytes && statistics.MissingMipCount > 0)
+	{
+		fprintf(stderr, "%u mips still missing after settling, though the wanted %.1f MB fit the budget\n", statistics.MissingMipCount, Megabytes(statistics.WantedBytes));
+		result = 1;
+	}
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "SpriteQueue.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: SpriteBenchmark [-sprites count] [-textures count] [-frames count]\n"
+		"Times sorting and vertex generation for a frame of sprites (default 100000 sprites over 64 textures, 20 frames) in\n"
+		"each sort mode, SpriteQueue against a SpriteBatch-style comparison sort and scalar corners, and checks they agree.\n";
+
+	const char* const SortModeNames[] = { "deferred", "texture", "back to front", "front to back" };
+	const unsigned int SpriteBatchMaximumBatchSize = 2048;
+	const float ScreenWidth = 1920.0f;
+	const float ScreenHeight = 1080.0f;
+
+	// Fixed-seed generator, so every run draws the same sprites
+	float Random(unsigned int& seed)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		return (seed >> 8) / 16777216.0f;
+	}
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	// The comparisons SpriteBatch sorts its queue with; ties go to the texture, as SpriteQueue's keys do
+	bool IsBefore(const Sprite& lhs, const Sprite& rhs, SpriteSortMode sortMode)
+	{
+		switch (sortMode)
+		{
+			case SpriteSortModeTexture:
+				return lhs.Texture < rhs.Texture;
+
+			case SpriteSortModeBackToFront:
+				return (lhs.Depth != rhs.Depth ? lhs.Depth > rhs.Depth : lhs.Texture < rhs.Texture);
+
+			case SpriteSortModeFrontToBack:
+				return (lhs.Depth != rhs.Depth ? lhs.Depth < rhs.Depth : lhs.Texture < rhs.Texture);
+
+			default:
+				return false;
+		}
+	}
+
+	// One corner at a time, as SpriteBatch::Impl::RenderSprite computes them
+	void ScalarVertices(const Sprite& sprite, SpriteVertex* vertices)
+	{
+		const float cornerX[4] = { 0.0f, 1.0f, 0.0f, 1.0f };
+		const float cornerY[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+		float cosine = cosf(sprite.Rotation);
+		float sine = sinf(sprite.Rotation);
+
+		for (unsigned int corner = 0; corner < 4; corner++)
+		{
+			float offsetX = (cornerX[corner] - sprite.Origin[0]) * sprite.Destination[2];
+			float offsetY = (cornerY[corner] - sprite.Origin[1]) * sprite.Destination[3];
+
+			SpriteVertex& vertex = vertices[corner];
+			vertex.Position[0] = sprite.Destination[0] + offsetX * cosine - offsetY * sine;
+			vertex.Position[1] = sprite.Destination[1] + offsetX * sine + offsetY * cosine;
+			vertex.Position[2] = sprite.Depth;
+			vertex.Color = sprite.Color;
+			vertex.TextureCoordinates[0] = sprite.Source[0] + (sprite.Source[2] - sprite.Source[0]) * cornerX[corner];
+			vertex.TextureCoordinates[1] = sprite.Source[1] + (sprite.Source[3] - sprite.Source[1]) * cornerY[corner];
+		}
+	}
+
+	float MaximumDifference(const SpriteVertex& lhs, const SpriteVertex& rhs)
+	{
+		float difference = (lhs.Color != rhs.Color ? 1.0f : 0.0f);
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			difference = std::max(difference, std::abs(lhs.Position[i] - rhs.Position[i]));
+		}
+
+		for (unsigned int i = 0; i < 2; i++)
+		{
+			difference = std::max(difference, std::abs(lhs.TextureCoordinates[i] - rhs.TextureCoordinates[i]));
+		}
+
+		return difference;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int spriteCount = 100000;
+	unsigned int textureCount = 64;
+	unsigned int frameCount = 20;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-sprites") == 0 && i + 1 < argc)
+		{
+			spriteCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-textures") == 0 && i + 1 < argc)
+		{
+			textureCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc)
+		{
+			frameCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+	}
+
+	// Particles and HUD glyphs: small, a quarter of them rotated, each from a region of one of the textures
+	unsigned int seed = 12345;
+	std::vector<Sprite> sprites(spriteCount);
+	for (Sprite& sprite : sprites)
+	{
+		float size = 4.0f + Random(seed) * 60.0f;
+		sprite.Destination[0] = Random(seed) * ScreenWidth;
+		sprite.Destination[1] = Random(seed) * ScreenHeight;
+		sprite.Destination[2] = size;
+		sprite.Destination[3] = size * (0.5f + Random(seed));
+		sprite.Source[0] = Random(seed) * 0.5f;
+		sprite.Source[1] = Random(seed) * 0.5f;
+		sprite.Source[2] = sprite.Source[0] + 0.5f;
+		sprite.Source[3] = sprite.Source[1] + 0.5f;
+		sprite.Origin[0] = 0.5f;
+		sprite.Origin[1] = 0.5f;
+		sprite.Rotation = (Random(seed) < 0.25f ? Random(seed) * 6.2831853f : 0.0f);
+		sprite.Depth = Random(seed);
+		sprite.Color = static_cast<unsigned int>(Random(seed) * 16777216.0f) | 0xFF000000;
+		sprite.Texture = static_cast<unsigned int>(Random(seed) * textureCount);
+	}
+
+	// SpriteQueue memory as a frame arena would hand it out: sized up front, 16-byte aligned
+	std::vector<unsigned char> arena(SpriteQueue::MemorySize(spriteCount) + 16);
+	void* memory = &arena[(16 - reinterpret_cast<size_t>(&arena[0]) % 16) % 16];
+
+	std::vector<SpriteVertex> vertices(static_cast<size_t>(spriteCount) * 4);
+	std::vector<SpriteVertex> referenceVertices(vertices.size());
+	std::vector<Sprite> spriteBatchQueue;
+	std::vector<const Sprite*> sortedSprites;
+	std::vector<unsigned int> stableOrder(spriteCount);
+
+	printf("%u sprites, %u textures, %u frames\n\n", spriteCount, textureCount, frameCount);
+	printf("%-14s %-39s %-39s\n", "", "SpriteBatch-style", "SpriteQueue");
+	printf("%-14s %9s %9s %9s %9s %9s %9s %9s %9s %8s\n", "sort mode", "sort ms", "verts ms", "Msprite/s", "batches", "sort ms", "verts ms", "Msprite/s", "batches", "speedup");
+
+	int result = 0;
+	for (unsigned int mode = 0; mode < SpriteSortModeEnd; mode++)
+	{
+		SpriteSortMode sortMode = static_cast<SpriteSortMode>(mode);
+		double baselineSortTime = 0.0;
+		double baselineVertexTime = 0.0;
+		double sortTime = 0.0;
+		double vertexTime = 0.0;
+		unsigned int baselineBatchCount = 0;
+		SpriteQueue queue;
+
+		for (unsigned int frame = 0; frame < frameCount; frame++)
+		{
+			// SpriteBatch keeps its queue's capacity between frames and sorts pointers into it
+			auto start = std::chrono::high_resolution_clock::now();
+			spriteBatchQueue.clear();
+			for (const Sprite& sprite : sprites)
+			{
+				spriteBatchQueue.push_back(sprite);
+			}
+
+			sortedSprites.resize(spriteBatchQueue.size());
+			for (size_t i = 0; i < spriteBatchQueue.size(); i++)
+			{
+				sortedSprites[i] = &spriteBatchQueue[i];
+			}
+
+			if (sortMode != SpriteSortModeDeferred)
+			{
+				std::sort(sortedSprites.begin(), sortedSprites.end(), [sortMode](const Sprite* lhs, const Sprite* rhs)
+				{
+					return IsBefore(*lhs, *rhs, sortMode);
+				});
+			}
+
+			auto sorted = std::chrono::high_resolution_clock::now();
+			baselineBatchCount = 0;
+			for (size_t i = 0; i < sortedSprites.size(); i++)
+			{
+				ScalarVertices(*sortedSprites[i], &referenceVertices[i * 4]);
+				if (i % SpriteBatchMaximumBatchSize == 0 || sortedSprites[i]->Texture != sortedSprites[i - 1]->Texture)
+				{
+					baselineBatchCount++;
+				}
+			}
+
+			auto end = std::chrono::high_resolution_clock::now();
+			baselineSortTime += Milliseconds(sorted - start);
+			baselineVertexTime += Milliseconds(end - sorted);
+
+			start = std::chrono::high_resolution_clock::now();
+			queue.Reset(memory, spriteCount, sortMode);
+			for (const Sprite& sprite : sprites)
+			{
+				queue.Push(sprite);
+			}
+
+			queue.Sort();
+			sorted = std::chrono::high_resolution_clock::now();
+			for (const SpriteBatchRange& batch : queue.Batches())
+			{
+				queue.GenerateVertices(batch.First, batch.Count, &vertices[static_cast<size_t>(batch.First) * 4]);
+			}
+
+			end = std::chrono::high_resolution_clock::now();
+			sortTime += Milliseconds(sorted - start);
+			vertexTime += Milliseconds(end - sorted);
+		}
+
+		// Both sorts are stable here, so the vertices must match one for one
+		for (unsigned int i = 0; i < spriteCount; i++)
+		{
+			stableOrder[i] = i;
+		}
+
+		std::stable_sort(stableOrder.begin(), stableOrder.end(), [&sprites, sortMode](unsigned int lhs, unsigned int rhs)
+		{
+			return IsBefore(sprites[lhs], sprites[rhs], sortMode);
+		});
+
+		float maximumDifference = 0.0f;
+		for (unsigned int i = 0; i < spriteCount; i++)
+		{
+			SpriteVertex corners[4];
+			ScalarVertices(sprites[stableOrder[i]], corners);
+			for (unsigned int corner = 0; corner < 4; corner++)
+			{
+				maximumDifference = std::max(maximumDifference, MaximumDifference(corners[corner], vertices[static_cast<size_t>(i) * 4 + corner]));
+			}
+		}
+
+		double baselineTime = (baselineSortTime + baselineVertexTime) / frameCount;
+		double time = (sortTime + vertexTime) / frameCount;
+		printf("%-14s %9.2f %9.2f %9.1f %9u %9.2f %9.2f %9.1f %9u %7.1fx\n", SortModeNames[mode],
+			baselineSortTime / frameCount, baselineVertexTime / frameCount, spriteCount / baselineTime / 1000.0, baselineBatchCount,
+			sortTime / frameCount, vertexTime / frameCount, spriteCount / time / 1000.0, static_cast<unsigned int>(queue.Batches().size()), baselineTime / time);
+
+		if (maximumDifference > 1e-3f)
+		{
+			fprintf(stderr, "%s: vertices differ from the stable reference by %g\n", SortModeNames[mode], maximumDifference);
+			result = 1;
+		}
+	}
+
+	return result;
+}
\ No newline at end of file
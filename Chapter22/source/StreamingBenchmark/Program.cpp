@@ -0,0 +1,240 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include "StreamingQueue.h"
+#include "ThreadPool.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: StreamingBenchmark [-items count] [-budget megabytes] [-frames count] [-threads count]\n"
+		"Requests every object along a street at once and streams them through StreamingQueue while a camera flies past\n"
+		"at 60 frames a second (default 400 objects of 64 KB to 1 MB, 2 MB of uploads a frame, 240 frames, a worker per\n"
+		"core), nearest first and then in request order. Reports load latency percentiles, the upload time each frame\n"
+		"spends, and how many object-frames showed a placeholder. Every object must arrive within the upload budget.\n";
+
+	const float StreetLength = 2000.0f;
+	const float StreetWidth = 8.0f;
+	const float ViewDistance = 200.0f;
+	const unsigned int SettleFrameCount = 600;
+	const std::chrono::microseconds FrameTime(16667);
+
+	typedef struct _SceneObject
+	{
+		float Position[2];
+		unsigned int Size;
+	} SceneObject;
+
+	// Fixed-seed generator, so every run streams the same scene
+	float Random(unsigned int& seed)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		return (seed >> 8) / 16777216.0f;
+	}
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	double Megabytes(unsigned long long bytes)
+	{
+		return bytes / 1048576.0;
+	}
+
+	// Stands in for a texture: Load() "decodes" by generating every byte, and Upload() copies them into a staging
+	// buffer the way UpdateSubresource() would
+	class SyntheticItem : public StreamingItem
+	{
+	public:
+		SyntheticItem(unsigned int object, unsigned int size, std::vector<unsigned char>& staging)
+			: StreamingItem(), mObject(object), mSize(size), mData(), mStaging(&staging)
+		{
+		}
+
+		unsigned int Object() const
+		{
+			return mObject;
+		}
+
+	protected:
+		virtual void Load() override
+		{
+			mData.resize(mSize);
+			unsigned int seed = mObject;
+			for (unsigned char& value : mData)
+			{
+				seed = seed * 1664525U + 1013904223U;
+				value = static_cast<unsigned char>(seed >> 24);
+			}
+		}
+
+		virtual unsigned int UploadSize() const override
+		{
+			return static_cast<unsigned int>(mData.size());
+		}
+
+		virtual void Upload() override
+		{
+			memcpy(&(*mStaging)[0], &mData[0], mData.size());
+			std::vector<unsigned char>().swap(mData);
+		}
+
+	private:
+		SyntheticItem();
+		SyntheticItem(const SyntheticItem& rhs);
+		SyntheticItem& operator=(const SyntheticItem& rhs);
+
+		unsigned int mObject;
+		unsigned int mSize;
+		std::vector<unsigned char> mData;
+		std::vector<unsigned char>* mStaging;
+	};
+
+	float CameraZ(unsigned int frame, unsigned int frameCount)
+	{
+		return StreetLength * std::min(static_cast<float>(frame) / frameCount, 1.0f);
+	}
+
+	float DistanceSquared(const SceneObject& object, float cameraZ)
+	{
+		return object.Position[0] * object.Position[0] + (object.Position[1] - cameraZ) * (object.Position[1] - cameraZ);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int itemCount = 400;
+	unsigned int uploadBudget = 2 * 1024 * 1024;
+	unsigned int frameCount = 240;
+	unsigned int threadCount = ThreadPool::DefaultThreadCount();
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-items") == 0 && i + 1 < argc)
+		{
+			itemCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-budget") == 0 && i + 1 < argc)
+		{
+			uploadBudget = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1)) * 1024 * 1024;
+		}
+		else if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc)
+		{
+			frameCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc)
+		{
+			threadCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+	}
+
+	unsigned int seed = 12345;
+	std::vector<SceneObject> objects(itemCount);
+	unsigned long long totalSize = 0;
+	unsigned int largestSize = 0;
+	for (SceneObject& object : objects)
+	{
+		object.Position[0] = (Random(seed) < 0.5f ? -1.0f : 1.0f) * StreetWidth * (0.5f + Random(seed));
+		object.Position[1] = Random(seed) * StreetLength;
+		object.Size = (64U << static_cast<unsigned int>(Random(seed) * 5.0f)) * 1024;
+		totalSize += object.Size;
+		largestSize = std::max(largestSize, object.Size);
+	}
+
+	std::vector<unsigned char> staging(largestSize);
+
+	printf("%u objects, %.1f MB, %.1f MB a frame, %u frames, %u threads\n\n", itemCount, Megabytes(totalSize), Megabytes(uploadBudget), frameCount, threadCount);
+	printf("%-8s %7s %9s %9s %9s %9s %10s %10s %10s %12s\n", "order", "frames", "p50 ms", "p95 ms", "p99 ms", "max ms", "upload ms", "worst ms", "worst MB", "placeholder");
+
+	int result = 0;
+	for (unsigned int pass = 0; pass < 2; pass++)
+	{
+		bool isNearestFirst = (pass == 0);
+		const char* order = (isNearestFirst ? "nearest" : "request");
+
+		ThreadPool threadPool(threadCount);
+		StreamingQueue queue(threadPool);
+		queue.SetUploadBudget(uploadBudget);
+
+		std::vector<std::shared_ptr<SyntheticItem>> items(itemCount);
+		for (unsigned int i = 0; i < itemCount; i++)
+		{
+			items[i] = std::shared_ptr<SyntheticItem>(new SyntheticItem(i, objects[i].Size, staging));
+			queue.Enqueue(items[i], (isNearestFirst ? DistanceSquared(objects[i], CameraZ(0, frameCount)) : static_cast<float>(i)));
+		}
+
+		double uploadTime = 0.0;
+		double worstUploadTime = 0.0;
+		unsigned int worstUploadSize = 0;
+		unsigned int placeholderCount = 0;
+		unsigned int frame = 0;
+		auto frameStart = std::chrono::high_resolution_clock::now();
+		for (; frame < frameCount + SettleFrameCount && (frame < frameCount || queue.IsIdle() == false); frame++)
+		{
+			float cameraZ = CameraZ(frame, frameCount);
+			if (isNearestFirst)
+			{
+				queue.UpdatePriorities([&](const StreamingItem& item)
+				{
+					return DistanceSquared(objects[static_cast<const SyntheticItem&>(item).Object()], cameraZ);
+				});
+			}
+
+			auto start = std::chrono::high_resolution_clock::now();
+			const std::vector<std::shared_ptr<StreamingItem>>& uploads = queue.Update();
+			double elapsed = Milliseconds(std::chrono::high_resolution_clock::now() - start);
+			uploadTime += elapsed;
+			worstUploadTime = std::max(worstUploadTime, elapsed);
+
+			StreamingStatistics statistics = queue.Statistics();
+			worstUploadSize = std::max(worstUploadSize, statistics.UploadedBytesLastFrame);
+			if (statistics.UploadedBytesLastFrame > uploadBudget && uploads.size() > 1)
+			{
+				fprintf(stderr, "%s, frame %u: %u bytes uploaded over %u items, past the budget\n", order, frame, statistics.UploadedBytesLastFrame, static_cast<unsigned int>(uploads.size()));
+				result = 1;
+			}
+
+			// An object in view that hasn't arrived is drawn with a placeholder this frame
+			for (unsigned int i = 0; i < itemCount; i++)
+			{
+				placeholderCount += (items[i]->IsReady() == false && DistanceSquared(objects[i], cameraZ) < ViewDistance * ViewDistance ? 1 : 0);
+			}
+
+			frameStart += FrameTime;
+			std::this_thread::sleep_until(frameStart);
+		}
+
+		StreamingStatistics statistics = queue.Statistics();
+		printf("%-8s %7u %9.1f %9.1f %9.1f %9.1f %10.3f %10.3f %10.2f %12u\n", order, frame, statistics.LatencyPercentile50, statistics.LatencyPercentile95,
+			statistics.LatencyPercentile99, statistics.LatencyMaximum, uploadTime / frame, worstUploadTime, Megabytes(worstUploadSize), placeholderCount);
+
+		// Every request ends completed, failed or cancelled; any other shortfall was lost by the queue
+		if (statistics.CompletedCount + statistics.FailedCount + statistics.CancelledCount != statistics.RequestedCount)
+		{
+			fprintf(stderr, "%s: %u requests, of which %u completed, %u failed and %u were cancelled; the rest were lost\n", order, statistics.RequestedCount,
+				statistics.CompletedCount, statistics.FailedCount, statistics.CancelledCount);
+			result = 1;
+		}
+		else if (statistics.CompletedCount != itemCount || statistics.FailedCount > 0 || statistics.CancelledCount > 0)
+		{
+			fprintf(stderr, "%s: %u of %u objects arrived, %u failed, %u cancelled\n", order, statistics.CompletedCount, itemCount, statistics.FailedCount,
+				statistics.CancelledCount);
+			result = 1;
+		}
+	}
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,344 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <cwctype>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "SpriteFontFile.h"
+#include "TextLayout.h"
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: TextBenchmark [-labels count] [-frames count] font.spritefont\n"
+		"Times a frame of static help labels (default 32 labels, 2000 frames) laid out as SpriteFont does, with binary\n"
+		"searched glyphs, against the glyph table, the layout cache and a kept run, and checks the layouts agree.\n";
+
+	const wchar_t* const LabelFormats[] =
+	{
+		L"Ambient Intensity (+PgUp/-PgDn): %d\nPoint Light Intensity (+Home/-End): %d\nMove Point Light (8/2, 4/6, 3/9)\n",
+		L"Frame Rate: %d    Total Elapsed Time: %d.25",
+		L"Color Offset: 0.%d",
+		L"Cascades (+C/-V): %d    Shadow Caster Cache (Space): On\nDepth Bias: 0.00%d"
+	};
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	bool ReadFile(const std::string& filename, std::vector<unsigned char>& data)
+	{
+		FILE* file = fopen(filename.c_str(), "rb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		data.resize(static_cast<size_t>(std::max(size, 0L)));
+		bool isValid = (size > 0 && fread(&data[0], 1, data.size(), file) == data.size());
+		fclose(file);
+
+		return isValid;
+	}
+
+	// SpriteFont::Impl::FindGlyph: a binary search of the glyphs, sorted by character, for every character
+	const Glyph* FindGlyph(const std::vector<Glyph>& sortedGlyphs, unsigned int character, const Glyph* defaultGlyph)
+	{
+		auto it = std::lower_bound(sortedGlyphs.begin(), sortedGlyphs.end(), character, [](const Glyph& glyph, unsigned int value)
+		{
+			return glyph.Character < value;
+		});
+
+		return (it != sortedGlyphs.end() && it->Character == character ? &*it : defaultGlyph);
+	}
+
+	// SpriteFont::Impl::ForEachGlyph and DrawString, rebuilt every frame
+	void ReferenceLayout(const std::vector<Glyph>& sortedGlyphs, const Glyph* defaultGlyph, float lineSpacing, float textureWidth, float textureHeight,
+		const wchar_t* text, TextRun& run)
+	{
+		float x = 0.0f;
+		float y = 0.0f;
+		run.Glyphs.clear();
+		run.Width = 0.0f;
+		run.Height = 0.0f;
+
+		for (; *text != L'\0'; text++)
+		{
+			unsigned int character = static_cast<unsigned int>(*text);
+			if (character == L'\r')
+			{
+				continue;
+			}
+
+			if (character == L'\n')
+			{
+				x = 0.0f;
+				y += lineSpacing;
+				continue;
+			}
+
+			const Glyph* glyph = FindGlyph(sortedGlyphs, character, defaultGlyph);
+			x = std::max(x + glyph->XOffset, 0.0f);
+			float glyphWidth = static_cast<float>(glyph->Subrect[2] - glyph->Subrect[0]);
+			float glyphHeight = static_cast<float>(glyph->Subrect[3] - glyph->Subrect[1]);
+
+			if (iswspace(static_cast<wint_t>(character)) == 0)
+			{
+				Sprite sprite;
+				memset(&sprite, 0, sizeof(sprite));
+				sprite.Destination[0] = x;
+				sprite.Destination[1] = y + glyph->YOffset;
+				sprite.Destination[2] = glyphWidth;
+				sprite.Destination[3] = glyphHeight;
+				sprite.Source[0] = glyph->Subrect[0] / textureWidth;
+				sprite.Source[1] = glyph->Subrect[1] / textureHeight;
+				sprite.Source[2] = glyph->Subrect[2] / textureWidth;
+				sprite.Source[3] = glyph->Subrect[3] / textureHeight;
+				sprite.Color = 0xFFFFFFFF;
+				run.Glyphs.push_back(sprite);
+
+				run.Width = std::max(run.Width, x + glyphWidth);
+				run.Height = std::max(run.Height, y + std::max(glyphHeight + glyph->YOffset, lineSpacing));
+			}
+
+			x += glyphWidth + glyph->XAdvance;
+		}
+	}
+
+	bool IsSameRun(const TextRun& lhs, const TextRun& rhs)
+	{
+		if (lhs.Glyphs.size() != rhs.Glyphs.size() || lhs.Width != rhs.Width || lhs.Height != rhs.Height)
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < lhs.Glyphs.size(); i++)
+		{
+			if (memcmp(lhs.Glyphs[i].Destination, rhs.Glyphs[i].Destination, sizeof(lhs.Glyphs[i].Destination)) != 0 ||
+				memcmp(lhs.Glyphs[i].Source, rhs.Glyphs[i].Source, sizeof(lhs.Glyphs[i].Source)) != 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int labelCount = 32;
+	unsigned int frameCount = 2000;
+	std::string fontFilename;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-labels") == 0 && i + 1 < argc)
+		{
+			labelCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc)
+		{
+			frameCount = static_cast<unsigned int>(std::max(atoi(argv[++i]), 1));
+		}
+		else if (argv[i][0] != '-' && fontFilename.empty())
+		{
+			fontFilename = argv[i];
+		}
+		else
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+	}
+
+	if (fontFilename.empty())
+	{
+		fputs(Usage, stderr);
+		return 1;
+	}
+
+	std::vector<unsigned char> fileData;
+	SpriteFontData font;
+	GlyphTable glyphTable;
+	try
+	{
+		if (ReadFile(fontFilename, fileData) == false)
+		{
+			fprintf(stderr, "Could not read %s\n", fontFilename.c_str());
+			return 1;
+		}
+
+		SpriteFontFile::Read(&fileData[0], fileData.size(), font);
+		glyphTable.Build(font.Glyphs, font.DefaultCharacter, font.LineSpacing, font.TextureWidth, font.TextureHeight);
+	}
+	catch (std::exception& ex)
+	{
+		fprintf(stderr, "%s: %s\n", fontFilename.c_str(), ex.what());
+		return 1;
+	}
+
+	std::vector<Glyph> sortedGlyphs = font.Glyphs;
+	std::sort(sortedGlyphs.begin(), sortedGlyphs.end(), [](const Glyph& lhs, const Glyph& rhs)
+	{
+		return lhs.Character < rhs.Character;
+	});
+
+	const Glyph* defaultGlyph = (font.DefaultCharacter != 0 ? FindGlyph(sortedGlyphs, font.DefaultCharacter, nullptr) : nullptr);
+	float textureWidth = static_cast<float>(std::max(font.TextureWidth, 1U));
+	float textureHeight = static_cast<float>(std::max(font.TextureHeight, 1U));
+
+	// Every character of the Basic Multilingual Plane must find the glyph the binary search does
+	int result = 0;
+	for (unsigned int character = 0; character < 0x10000; character++)
+	{
+		const Glyph* expected = FindGlyph(sortedGlyphs, character, defaultGlyph);
+		const Glyph* glyph = glyphTable.Find(character);
+		if ((expected == nullptr) != (glyph == nullptr) || (expected != nullptr && memcmp(expected, glyph, sizeof(Glyph)) != 0))
+		{
+			fprintf(stderr, "Glyph table lookup of U+%04X differs from the binary search\n", character);
+			result = 1;
+			break;
+		}
+	}
+
+	// A character beyond the plane, as a surrogate pair, through the hashed glyphs
+	if (sortedGlyphs.empty() == false)
+	{
+		std::vector<Glyph> glyphs = font.Glyphs;
+		Glyph supplementaryGlyph = sortedGlyphs.back();
+		supplementaryGlyph.Character = 0x1F600;
+		glyphs.push_back(supplementaryGlyph);
+
+		GlyphTable supplementaryTable;
+		supplementaryTable.Build(glyphs, 0, font.LineSpacing, font.TextureWidth, font.TextureHeight);
+
+		TextRun pairRun;
+		TextRun singleRun;
+		const wchar_t pairText[] = { 0xD83D, 0xDE00, 0 };
+		const wchar_t singleText[] = { static_cast<wchar_t>(sortedGlyphs.back().Character), 0 };
+		TextLayout::Build(supplementaryTable, pairText, 1.0f, pairRun);
+		TextLayout::Build(supplementaryTable, singleText, 1.0f, singleRun);
+		if (supplementaryTable.Find(0x1F600) == nullptr || IsSameRun(pairRun, singleRun) == false)
+		{
+			fprintf(stderr, "Surrogate pair layout differs from its glyph's\n");
+			result = 1;
+		}
+	}
+
+	std::vector<std::wstring> labels(labelCount);
+	unsigned int glyphCount = 0;
+	for (unsigned int i = 0; i < labelCount; i++)
+	{
+		wchar_t label[256];
+		swprintf(label, sizeof(label) / sizeof(label[0]), LabelFormats[i % (sizeof(LabelFormats) / sizeof(LabelFormats[0]))], 10 + i, 20 + i);
+		labels[i] = label;
+	}
+
+	TextRun referenceRun;
+	TextRun run;
+	TextLayoutCache cache(labelCount);
+	std::vector<TextRun> keptRuns(labelCount);
+	for (unsigned int i = 0; i < labelCount; i++)
+	{
+		ReferenceLayout(sortedGlyphs, defaultGlyph, font.LineSpacing, textureWidth, textureHeight, labels[i].c_str(), referenceRun);
+		TextLayout::Build(glyphTable, labels[i].c_str(), 1.0f, keptRuns[i]);
+		glyphCount += static_cast<unsigned int>(referenceRun.Glyphs.size());
+
+		if (IsSameRun(referenceRun, keptRuns[i]) == false || IsSameRun(referenceRun, cache.Find(glyphTable, labels[i].c_str())) == false)
+		{
+			fprintf(stderr, "Layout of label %u differs from SpriteFont's\n", i);
+			result = 1;
+		}
+	}
+
+	// A frame's labels, with the glyph quads copied out as a draw would
+	std::vector<Sprite> sprites;
+	sprites.reserve(glyphCount);
+	double times[4] = { 0.0 };
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (unsigned int frame = 0; frame < frameCount; frame++)
+	{
+		sprites.clear();
+		for (const std::wstring& label : labels)
+		{
+			ReferenceLayout(sortedGlyphs, defaultGlyph, font.LineSpacing, textureWidth, textureHeight, label.c_str(), referenceRun);
+			sprites.insert(sprites.end(), referenceRun.Glyphs.begin(), referenceRun.Glyphs.end());
+		}
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	times[0] = Milliseconds(end - start);
+
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int frame = 0; frame < frameCount; frame++)
+	{
+		sprites.clear();
+		for (const std::wstring& label : labels)
+		{
+			TextLayout::Build(glyphTable, label.c_str(), 1.0f, run);
+			sprites.insert(sprites.end(), run.Glyphs.begin(), run.Glyphs.end());
+		}
+	}
+
+	end = std::chrono::high_resolution_clock::now();
+	times[1] = Milliseconds(end - start);
+
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int frame = 0; frame < frameCount; frame++)
+	{
+		sprites.clear();
+		for (const std::wstring& label : labels)
+		{
+			const TextRun& cachedRun = cache.Find(glyphTable, label.c_str());
+			sprites.insert(sprites.end(), cachedRun.Glyphs.begin(), cachedRun.Glyphs.end());
+		}
+	}
+
+	end = std::chrono::high_resolution_clock::now();
+	times[2] = Milliseconds(end - start);
+
+	// TextComponent: the new text is compared with the current one and the kept run drawn
+	start = std::chrono::high_resolution_clock::now();
+	unsigned int changeCount = 0;
+	for (unsigned int frame = 0; frame < frameCount; frame++)
+	{
+		sprites.clear();
+		for (unsigned int i = 0; i < labelCount; i++)
+		{
+			changeCount += (labels[i].compare(labels[i].c_str()) != 0 ? 1 : 0);
+			sprites.insert(sprites.end(), keptRuns[i].Glyphs.begin(), keptRuns[i].Glyphs.end());
+		}
+	}
+
+	end = std::chrono::high_resolution_clock::now();
+	times[3] = Milliseconds(end - start);
+
+	if (cache.MissCount() != labelCount || changeCount != 0)
+	{
+		fprintf(stderr, "Static labels were laid out again: %llu cache misses for %u labels\n", cache.MissCount(), labelCount);
+		result = 1;
+	}
+
+	const char* const pathNames[] = { "SpriteFont-style", "glyph table", "layout cache", "kept run" };
+	printf("%u labels, %u glyphs, %u frames, %u font glyphs\n\n", labelCount, glyphCount, frameCount, static_cast<unsigned int>(font.Glyphs.size()));
+	printf("%-18s %10s %10s %8s\n", "path", "us/frame", "ns/glyph", "speedup");
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		double microseconds = times[i] * 1000.0 / frameCount;
+		printf("%-18s %10.2f %10.2f %7.1fx\n", pathNames[i], microseconds, microseconds * 1000.0 / std::max(glyphCount, 1U), times[0] / times[i]);
+	}
+
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,463 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "MipChain.h"
+#include "BlockCompressor.h"
+#include "DDSFile.h"
+#include "DDSWriter.h"
+#include "TexturePacker.h"
+#include "ThreadPool.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#include <wincodec.h>
+#pragma comment(lib, "windowscodecs.lib")
+#endif
+
+using namespace Library;
+
+namespace
+{
+	const char* const Usage =
+		"Usage: TextureTool [-content color|linear|normal] [-format auto|bc1|bc3|bc5|bc7|rgba] [-filter kaiser|box] [-srgb] [-output directory]\n"
+		"                   [-pack array|atlas name] [-page size] [-gutter texels] files...\n"
+		"Builds DDS textures with complete mip chains. Reads binary PPM (P6) and PAM (P7) images, and on Windows anything WIC decodes.\n"
+		"The auto format is BC5 for normal maps, BC1 for opaque images and BC3 for the rest. -srgb tags color textures as sRGB.\n"
+		"-pack combines the files into texture arrays or atlases (default pages 2048 texels, gutters 8), written as name0.dds,\n"
+		"name1.dds and so on, with each file's page, slice and UV scale and offset listed in name.txt.\n";
+
+	const char* const PackModeNames[] = { "array", "atlas" };
+
+	const char* const ContentNames[] = { "color", "linear", "normal" };
+	const char* const FilterNames[] = { "box", "kaiser" };
+
+	typedef struct _FormatName
+	{
+		const char* Name;
+		unsigned int Format;
+		unsigned int SrgbFormat;
+	} FormatName;
+
+	const FormatName FormatNames[] =
+	{
+		{ "bc1", DDSFormatBC1Unorm, DDSFormatBC1UnormSrgb },
+		{ "bc3", DDSFormatBC3Unorm, DDSFormatBC3UnormSrgb },
+		{ "bc5", DDSFormatBC5Unorm, DDSFormatBC5Unorm },
+		{ "bc7", DDSFormatBC7Unorm, DDSFormatBC7UnormSrgb },
+		{ "rgba", DDSFormatR8G8B8A8Unorm, DDSFormatR8G8B8A8UnormSrgb }
+	};
+
+	const unsigned int FormatNameCount = sizeof(FormatNames) / sizeof(FormatNames[0]);
+
+	bool ReadNetpbmImage(const std::string& filename, PostProcessImage& image)
+	{
+		FILE* file = fopen(filename.c_str(), "rb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		char magic[3] = { 0 };
+		unsigned int width = 0;
+		unsigned int height = 0;
+		unsigned int channelCount = 0;
+		unsigned int maximumValue = 0;
+		bool isValid = (fscanf(file, "%2s", magic) == 1);
+
+		if (isValid && strcmp(magic, "P6") == 0)
+		{
+			channelCount = 3;
+			isValid = (fscanf(file, "%u %u %u", &width, &height, &maximumValue) == 3);
+		}
+		else if (isValid && strcmp(magic, "P7") == 0)
+		{
+			// PAM headers are keyword lines ending at ENDHDR; TUPLTYPE is implied by DEPTH
+			char keyword[16];
+			while (isValid && fscanf(file, "%15s", keyword) == 1 && strcmp(keyword, "ENDHDR") != 0)
+			{
+				if (strcmp(keyword, "WIDTH") == 0)
+				{
+					isValid = (fscanf(file, "%u", &width) == 1);
+				}
+				else if (strcmp(keyword, "HEIGHT") == 0)
+				{
+					isValid = (fscanf(file, "%u", &height) == 1);
+				}
+				else if (strcmp(keyword, "DEPTH") == 0)
+				{
+					isValid = (fscanf(file, "%u", &channelCount) == 1);
+				}
+				else if (strcmp(keyword, "MAXVAL") == 0)
+				{
+					isValid = (fscanf(file, "%u", &maximumValue) == 1);
+				}
+				else
+				{
+					isValid = (fscanf(file, "%*[^\n]") != EOF);
+				}
+			}
+		}
+		else
+		{
+			isValid = false;
+		}
+
+		isValid = isValid && width > 0 && height > 0 && maximumValue == 255 && (channelCount == 3 || channelCount == 4);
+
+		// A single whitespace character separates the header from the texels
+		isValid = isValid && (fgetc(file) != EOF);
+
+		if (isValid)
+		{
+			PostProcessReference::ResizeImage(image, width, height);
+
+			std::vector<unsigned char> row(width * channelCount);
+			for (unsigned int y = 0; isValid && y < height; y++)
+			{
+				isValid = (fread(&row[0], 1, row.size(), file) == row.size());
+				float* texels = &image.Texels[static_cast<size_t>(y) * width * 4];
+				for (unsigned int x = 0; isValid && x < width; x++)
+				{
+					texels[x * 4 + 0] = row[x * channelCount + 0] / 255.0f;
+					texels[x * 4 + 1] = row[x * channelCount + 1] / 255.0f;
+					texels[x * 4 + 2] = row[x * channelCount + 2] / 255.0f;
+					texels[x * 4 + 3] = (channelCount == 4 ? row[x * channelCount + 3] / 255.0f : 1.0f);
+				}
+			}
+		}
+
+		fclose(file);
+
+		return isValid;
+	}
+
+#if defined(_WIN32)
+	bool ReadWICImage(const std::string& filename, PostProcessImage& image)
+	{
+		std::wstring wideFilename(filename.begin(), filename.end());
+		IWICImagingFactory* factory = nullptr;
+		IWICBitmapDecoder* decoder = nullptr;
+		IWICBitmapFrameDecode* frame = nullptr;
+		IWICFormatConverter* converter = nullptr;
+		UINT width = 0;
+		UINT height = 0;
+
+		bool isValid = SUCCEEDED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory)))
+			&& SUCCEEDED(factory->CreateDecoderFromFilename(wideFilename.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder))
+			&& SUCCEEDED(decoder->GetFrame(0, &frame))
+			&& SUCCEEDED(factory->CreateFormatConverter(&converter))
+			&& SUCCEEDED(converter->Initialize(frame, GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom))
+			&& SUCCEEDED(converter->GetSize(&width, &height));
+
+		if (isValid)
+		{
+			std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4);
+			isValid = SUCCEEDED(converter->CopyPixels(nullptr, width * 4, static_cast<UINT>(pixels.size()), &pixels[0]));
+
+			PostProcessReference::ResizeImage(image, width, height);
+			for (size_t i = 0; isValid && i < pixels.size(); i++)
+			{
+				image.Texels[i] = pixels[i] / 255.0f;
+			}
+		}
+
+		IUnknown* objects[] = { converter, frame, decoder, factory };
+		for (IUnknown* object : objects)
+		{
+			if (object != nullptr)
+			{
+				object->Release();
+			}
+		}
+
+		return isValid;
+	}
+#endif
+
+	bool ReadImage(const std::string& filename, PostProcessImage& image)
+	{
+		if (ReadNetpbmImage(filename, image))
+		{
+			return true;
+		}
+
+#if defined(_WIN32)
+		return ReadWICImage(filename, image);
+#else
+		return false;
+#endif
+	}
+
+	bool HasTranslucency(const PostProcessImage& image)
+	{
+		for (size_t i = 3; i < image.Texels.size(); i += 4)
+		{
+			if (image.Texels[i] < 1.0f)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// The output replaces the input's extension with .dds
+	std::string OutputFilename(const std::string& directory, const std::string& path)
+	{
+		std::string::size_type separator = path.find_last_of("\\/");
+		std::string filename = (separator == std::string::npos ? path : path.substr(separator + 1));
+		std::string::size_type extension = filename.find_last_of('.');
+
+		return directory + "/" + filename.substr(0, extension) + ".dds";
+	}
+
+	template <typename T>
+	int FindName(const std::string& name, const T* names, unsigned int count)
+	{
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (name == names[i])
+			{
+				return static_cast<int>(i);
+			}
+		}
+
+		return -1;
+	}
+
+	double Milliseconds(std::chrono::high_resolution_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	std::string BaseName(const std::string& path)
+	{
+		std::string::size_type separator = path.find_last_of("\\/");
+		std::string filename = (separator == std::string::npos ? path : path.substr(separator + 1));
+
+		return filename.substr(0, filename.find_last_of('.'));
+	}
+
+	// Packs every source into arrays or atlases, all in one format
+	void WritePack(const std::vector<PostProcessImage>& sources, const std::vector<std::string>& filenames, TexturePackMode mode, TextureContent content, MipFilter filter,
+		const TexturePackerSettings& settings, unsigned int format, const std::string& directory, const std::string& name, ThreadPool& threadPool)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		std::vector<TexturePage> pages;
+		std::vector<TexturePlacement> placements;
+		TexturePacker::Pack(sources, mode, content, filter, settings, pages, placements, &threadPool);
+		double packTime = Milliseconds(std::chrono::high_resolution_clock::now() - start);
+
+		start = std::chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < pages.size(); i++)
+		{
+			const TexturePage& page = pages[i];
+			std::vector<std::vector<std::vector<unsigned char>>> slices(page.Slices.size());
+			size_t compressedSize = 0;
+			for (size_t slice = 0; slice < page.Slices.size(); slice++)
+			{
+				slices[slice].resize(page.Slices[slice].size());
+				for (size_t mip = 0; mip < page.Slices[slice].size(); mip++)
+				{
+					BlockCompressor::Compress(page.Slices[slice][mip], format, slices[slice][mip], &threadPool);
+					compressedSize += slices[slice][mip].size();
+				}
+			}
+
+			std::string outputFilename = directory + "/" + name + std::to_string(i) + ".dds";
+			DDSWriter::WriteArray(outputFilename, format, page.Width, page.Height, slices);
+			printf("%s: %u x %u, %u slices, %u mips, %.0f KB\n", outputFilename.c_str(), page.Width, page.Height,
+				static_cast<unsigned int>(page.Slices.size()), static_cast<unsigned int>(page.Slices[0].size()), compressedSize / 1024.0);
+		}
+
+		std::vector<std::string> names;
+		for (size_t i = 0; i < filenames.size(); i++)
+		{
+			names.push_back(BaseName(filenames[i]));
+			if (placements[i].Page == TexturePacker::NotPacked)
+			{
+				fprintf(stderr, "%s: %u x %u doesn't fit an atlas page in whole gutters, left unpacked\n", filenames[i].c_str(), sources[i].Width, sources[i].Height);
+			}
+		}
+
+		std::string placementFilename = directory + "/" + name + ".txt";
+		TexturePacker::WritePlacements(placementFilename, names, placements);
+		printf("%u textures packed %s into %u pages, packing %.1f ms, compression %.1f ms -> %s\n", static_cast<unsigned int>(sources.size()), PackModeNames[mode],
+			static_cast<unsigned int>(pages.size()), packTime, Milliseconds(std::chrono::high_resolution_clock::now() - start), placementFilename.c_str());
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string contentName = "color";
+	std::string formatName = "auto";
+	std::string filterName = "kaiser";
+	bool isSrgb = false;
+	std::string outputDirectory = ".";
+	std::string packModeName;
+	std::string packName;
+	TexturePackerSettings packSettings = TexturePacker::DefaultSettings;
+	std::vector<std::string> filenames;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-content") == 0 && i + 1 < argc)
+		{
+			contentName = argv[++i];
+		}
+		else if (strcmp(argv[i], "-format") == 0 && i + 1 < argc)
+		{
+			formatName = argv[++i];
+		}
+		else if (strcmp(argv[i], "-filter") == 0 && i + 1 < argc)
+		{
+			filterName = argv[++i];
+		}
+		else if (strcmp(argv[i], "-srgb") == 0)
+		{
+			isSrgb = true;
+		}
+		else if (strcmp(argv[i], "-output") == 0 && i + 1 < argc)
+		{
+			outputDirectory = argv[++i];
+		}
+		else if (strcmp(argv[i], "-pack") == 0 && i + 2 < argc)
+		{
+			packModeName = argv[++i];
+			packName = argv[++i];
+		}
+		else if (strcmp(argv[i], "-page") == 0 && i + 1 < argc)
+		{
+			int pageSize = atoi(argv[++i]);
+			packSettings.PageSize = static_cast<unsigned int>(pageSize > 0 ? pageSize : 0);
+		}
+		else if (strcmp(argv[i], "-gutter") == 0 && i + 1 < argc)
+		{
+			int gutter = atoi(argv[++i]);
+			packSettings.Gutter = static_cast<unsigned int>(gutter > 0 ? gutter : 0);
+		}
+		else if (argv[i][0] == '-')
+		{
+			fputs(Usage, stderr);
+			return 1;
+		}
+		else
+		{
+			filenames.push_back(argv[i]);
+		}
+	}
+
+	int content = FindName(contentName, ContentNames, TextureContentEnd);
+	int filter = FindName(filterName, FilterNames, MipFilterEnd);
+	int packMode = (packModeName.empty() ? TexturePackModeEnd : FindName(packModeName, PackModeNames, TexturePackModeEnd));
+	int formatIndex = -1;
+	for (unsigned int i = 0; i < FormatNameCount; i++)
+	{
+		if (formatName == FormatNames[i].Name)
+		{
+			formatIndex = static_cast<int>(i);
+		}
+	}
+
+	if (filenames.empty() || content < 0 || filter < 0 || packMode < 0 || (formatIndex < 0 && formatName != "auto"))
+	{
+		fputs(Usage, stderr);
+		return 1;
+	}
+
+#if defined(_WIN32)
+	CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+#endif
+
+	ThreadPool threadPool;
+	int failedCount = 0;
+	std::vector<PostProcessImage> packSources;
+	std::vector<std::string> packFilenames;
+	bool isPackTranslucent = false;
+	for (const std::string& filename : filenames)
+	{
+		PostProcessImage source;
+		if (ReadImage(filename, source) == false)
+		{
+			fprintf(stderr, "%s: could not be decoded\n", filename.c_str());
+			failedCount++;
+			continue;
+		}
+
+		if (packMode != TexturePackModeEnd)
+		{
+			isPackTranslucent = isPackTranslucent || HasTranslucency(source);
+			packSources.push_back(source);
+			packFilenames.push_back(filename);
+			continue;
+		}
+
+		const FormatName* format = (formatIndex >= 0 ? &FormatNames[formatIndex] : nullptr);
+		if (format == nullptr)
+		{
+			unsigned int automaticIndex = (content == TextureContentNormal ? 2 : (HasTranslucency(source) ? 1 : 0));
+			format = &FormatNames[automaticIndex];
+		}
+
+		unsigned int dxgiFormat = (isSrgb && content == TextureContentColor ? format->SrgbFormat : format->Format);
+
+		try
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			std::vector<PostProcessImage> mips;
+			MipChain::Generate(source, static_cast<TextureContent>(content), static_cast<MipFilter>(filter), mips, &threadPool);
+			double mipTime = Milliseconds(std::chrono::high_resolution_clock::now() - start);
+
+			start = std::chrono::high_resolution_clock::now();
+			std::vector<std::vector<unsigned char>> compressedMips(mips.size());
+			size_t compressedSize = 0;
+			for (size_t mip = 0; mip < mips.size(); mip++)
+			{
+				BlockCompressor::Compress(mips[mip], dxgiFormat, compressedMips[mip], &threadPool);
+				compressedSize += compressedMips[mip].size();
+			}
+			double compressTime = Milliseconds(std::chrono::high_resolution_clock::now() - start);
+
+			std::string outputFilename = OutputFilename(outputDirectory, filename);
+			DDSWriter::Write(outputFilename, dxgiFormat, source.Width, source.Height, compressedMips);
+
+			printf("%s: %u x %u %s, %u mips, %s%s, %.0f KB (%.0f KB as RGBA8 with autogen mips), mips %.1f ms, compression %.1f ms -> %s\n",
+				filename.c_str(), source.Width, source.Height, ContentNames[content], static_cast<unsigned int>(mips.size()), format->Name,
+				(dxgiFormat != format->Format ? " sRGB" : ""), compressedSize / 1024.0, source.Width * source.Height * 4 * 4.0 / 3.0 / 1024.0,
+				mipTime, compressTime, outputFilename.c_str());
+		}
+		catch (std::runtime_error& ex)
+		{
+			fprintf(stderr, "%s: %s\n", filename.c_str(), ex.what());
+			failedCount++;
+		}
+	}
+
+	if (packSources.empty() == false)
+	{
+		const FormatName* format = &FormatNames[formatIndex >= 0 ? formatIndex : (content == TextureContentNormal ? 2 : (isPackTranslucent ? 1 : 0))];
+		unsigned int dxgiFormat = (isSrgb && content == TextureContentColor ? format->SrgbFormat : format->Format);
+
+		try
+		{
+			WritePack(packSources, packFilenames, static_cast<TexturePackMode>(packMode), static_cast<TextureContent>(content), static_cast<MipFilter>(filter),
+				packSettings, dxgiFormat, outputDirectory, packName, threadPool);
+		}
+		catch (std::runtime_error& ex)
+		{
+			fprintf(stderr, "%s: %s\n", packName.c_str(), ex.what());
+			failedCount++;
+		}
+	}
+
+#if defined(_WIN32)
+	CoUninitialize();
+#endif
+
+	return (failedCount > 0 ? 1 : 0);
+}
\ No newline at end of file
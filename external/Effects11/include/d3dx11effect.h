@@ -182,9 +182,16 @@ struct D3DX11_STATE_BLOCK_MASK
 // D3DX11_EFFECT_CLONE_FORCE_NONSINGLE
 //   Ignore all "single" qualifiers on cbuffers.  All cbuffers will have their
 //   own ID3D11Buffer's created in the cloned effect.
+//
+// D3DX11_EFFECT_CLONE_SHARE_TYPES
+//   Point the clone at the types, and the type and member name strings, of
+//   the effect being cloned instead of copying them.  The clone holds a
+//   reference to that effect.  Neither effect can be Optimize()'d while the
+//   types are shared.
 //----------------------------------------------------------------------------
 
 #define D3DX11_EFFECT_CLONE_FORCE_NONSINGLE        	    (1 << 0)
+#define D3DX11_EFFECT_CLONE_SHARE_TYPES                (1 << 1)
 
 
 //////////////////////////////////////////////////////////////////////////////
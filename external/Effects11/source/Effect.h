@@ -1062,7 +1062,8 @@ class CEffect : public ID3DX11Effect
     
 protected:
 
-    uint32_t                m_RefCount;
+    // Clones of one effect may be made, and released, on several threads
+    volatile LONG           m_RefCount;
     uint32_t                m_Flags;
 
     // Private heap - all pointers should point into here
@@ -1157,6 +1158,10 @@ protected:
     // After Optimize() is called, the type/string pools should be deleted and all
     // remaining data should be migrated into the optimized type heap
     CEffectHeap             *m_pOptimizedTypeHeap;
+    // Set on a clone made with D3DX11_EFFECT_CLONE_SHARE_TYPES: the effect whose pools its types and strings are in.
+    // That effect counts its sharers, as neither may Optimize() while they exist.
+    CEffect                 *m_pTypeSource;
+    volatile LONG           m_TypeSharerCount;
 
     // Pools a string or type and modifies the pointer
     void AddStringToPool(const char **ppString);
@@ -758,7 +758,7 @@ HRESULT CEffectLoader::LoadEffect(CEffect *pEffect, const void *pEffectBuffer, u
 {
 
     HRESULT hr = S_OK;
-    uint32_t  i, varSize, cMemberDataBlocks;
+    uint32_t  i, varSize, cMemberDataBlocks, cbBulkHeap;
     CCheckedDword chkVariables = 0;
 
     // Used for cloning
@@ -826,6 +826,17 @@ HRESULT CEffectLoader::LoadEffect(CEffect *pEffect, const void *pEffectBuffer, u
     chkVariables += m_pHeader->Effect.cCBs; // SRV (for TBuffers)
     VHD( chkVariables.GetValue(&cMemberDataBlocks), "Overflow: too many Effect variables." );
 
+    // Size the heaps from the header so a typical effect parses into one block each instead of a chain of 8K blocks.
+    // The bulk heap holds runtime structures (larger than their binary form) plus the variables; the pooled heap
+    // holds the types and strings found in the unstructured section.
+    chkVariables = varSize;
+    chkVariables += cbEffectBuffer;
+    if( SUCCEEDED( chkVariables.GetValue(&cbBulkHeap) ) )
+    {
+        VH( m_BulkHeap.Reserve(cbBulkHeap) );
+    }
+    VH( m_pEffect->m_pPooledHeap->Reserve(m_pHeader->cbUnstructured) );
+
     // Allocate effect resources
     VN( m_pEffect->m_pCBs = PRIVATENEW SConstantBuffer[m_pHeader->Effect.cCBs] );
     VN( m_pEffect->m_pDepthStencilBlocks = PRIVATENEW SDepthStencilBlock[m_pHeader->cDepthStencilBlocks] );
@@ -761,6 +761,8 @@ CEffect::CEffect( uint32_t Flags )
     m_pStringPool = nullptr;
     m_pPooledHeap = nullptr;
     m_pOptimizedTypeHeap = nullptr;
+    m_pTypeSource = nullptr;
+    m_TypeSharerCount = 0;
 }
 
 void CEffect::ReleaseShaderRefection()
@@ -914,6 +916,12 @@ CEffect::~CEffect()
     SAFE_RELEASE( m_pClassLinkage );
     assert( m_pContext == nullptr );
 
+    if( nullptr != m_pTypeSource )
+    {
+        InterlockedDecrement( &m_pTypeSource->m_TypeSharerCount );
+        SAFE_RELEASE( m_pTypeSource );
+    }
+
     // Restore debug spew
     if (pInfoQueue)
     {
@@ -1074,14 +1082,15 @@ EXIT:
 
 ULONG CEffect::AddRef()
 {
-    return ++ m_RefCount;
+    return InterlockedIncrement( &m_RefCount );
 }
 
 ULONG CEffect::Release()
 {
-    if (-- m_RefCount > 0)
+    LONG RefCount = InterlockedDecrement( &m_RefCount );
+    if (RefCount > 0)
     {
-        return m_RefCount;
+        return RefCount;
     }
     else
     {
@@ -2055,7 +2064,7 @@ HRESULT CEffect::FixupMemberInterface( SMember* pMember, CEffect* pEffectSource,
         {
             pMember->pName = (char*)((UINT_PTR)pMember->pName - (UINT_PTR)pEffectSource->m_pReflection->m_Heap.GetDataStart() + (UINT_PTR)m_pReflection->m_Heap.GetDataStart());
         }
-        else
+        else if( nullptr == m_pTypeSource )
         {
             VH( RemapString(&pMember->pName, &mappingTableStrings) );
         }
@@ -2066,7 +2075,7 @@ HRESULT CEffect::FixupMemberInterface( SMember* pMember, CEffect* pEffectSource,
         {
             pMember->pSemantic = (char*)((UINT_PTR)pMember->pSemantic - (UINT_PTR)pEffectSource->m_pReflection->m_Heap.GetDataStart() + (UINT_PTR)m_pReflection->m_Heap.GetDataStart());
         }
-        else
+        else if( nullptr == m_pTypeSource )
         {
             VH( RemapString(&pMember->pSemantic, &mappingTableStrings) );
         }
@@ -2088,6 +2097,10 @@ HRESULT CEffect::CloneEffect(_In_ uint32_t Flags, _Outptr_ ID3DX11Effect** ppClo
     CEffect* pNewEffect = nullptr;    
     CDataBlockStore* pTempHeap = nullptr;
 
+    // A clone that shares types leaves them in the pools of the effect it was cloned from
+    CEffect* pTypeSource = (nullptr != m_pTypeSource) ? m_pTypeSource : this;
+    bool ShareTypes = (Flags & D3DX11_EFFECT_CLONE_SHARE_TYPES) != 0;
+
 
     VN( pNewEffect = new CEffect( m_Flags ) );
     if( Flags & D3DX11_EFFECT_CLONE_FORCE_NONSINGLE )
@@ -2175,23 +2188,34 @@ HRESULT CEffect::CloneEffect(_In_ uint32_t Flags, _Outptr_ ID3DX11Effect** ppClo
     VH( mappingTableTypes.AutoGrow() );
     VH( mappingTableStrings.AutoGrow() );
 
-    if( !IsOptimized() )
+    if( ShareTypes )
+    {
+        // The variables, members and annotations already point at the source's types and pooled strings
+        pNewEffect->m_pTypeSource = pTypeSource;
+        pTypeSource->AddRef();
+        InterlockedIncrement( &pTypeSource->m_TypeSharerCount );
+    }
+    else if( !IsOptimized() )
     {
         // Let's re-create the type pool and string pool
         VN( pNewEffect->m_pPooledHeap = new CDataBlockStore );
         pNewEffect->m_pPooledHeap->EnableAlignment();
 
-        VH( pNewEffect->CopyStringPool( this, mappingTableStrings ) );
-        VH( pNewEffect->CopyTypePool( this, mappingTableTypes, mappingTableStrings ) );
+        VH( pNewEffect->CopyStringPool( pTypeSource, mappingTableStrings ) );
+        VH( pNewEffect->CopyTypePool( pTypeSource, mappingTableTypes, mappingTableStrings ) );
     }
     else
     {
         // There's no string pool after optimizing.  Let's re-create the type pool
-        VH( pNewEffect->CopyOptimizedTypePool( this, mappingTableTypes ) );
+        VH( pNewEffect->CopyOptimizedTypePool( pTypeSource, mappingTableTypes ) );
     }
 
     // fixup this effect's variable's types
-    VH( pNewEffect->OptimizeTypes(&mappingTableTypes, true) );
+    if( !ShareTypes )
+    {
+        VH( pNewEffect->OptimizeTypes(&mappingTableTypes, true) );
+    }
+
     VH( pNewEffect->RecreateCBs() );
 
 
@@ -2290,6 +2314,12 @@ HRESULT CEffect::Optimize()
         return S_OK;
     }
 
+    if (nullptr != m_pTypeSource || m_TypeSharerCount > 0)
+    {
+        DPF(0, "ID3DX11Effect::Optimize: Effect shares its types with the effect it was cloned from, or with a clone");
+        return D3DERR_INVALIDCALL;
+    }
+
     // Delete annotations, names, semantics, and string data on variables
     
     for (size_t i = 0; i < m_VariableCount; ++ i)
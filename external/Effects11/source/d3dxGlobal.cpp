@@ -255,6 +255,23 @@ void* CDataBlock::Allocate(uint32_t bufferSize, CDataBlock **ppBlock)
     return pRetValue;
 }
 
+_Use_decl_annotations_
+HRESULT CDataBlock::Reserve(uint32_t bufferSize)
+{
+    HRESULT hr = S_OK;
+
+    if (m_maxSize == 0)
+    {
+        m_maxSize = std::max<uint32_t>(8192, bufferSize);
+
+        VN( m_pData = new uint8_t[m_maxSize] );
+        memset(m_pData, 0xDD, m_maxSize);
+    }
+
+lExit:
+    return hr;
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -368,6 +385,30 @@ uint32_t CDataBlockStore::GetSize()
     return m_Size;
 }
 
+_Use_decl_annotations_
+HRESULT CDataBlockStore::Reserve(uint32_t bufferSize)
+{
+    HRESULT hr = S_OK;
+
+    // Only meaningful before the first allocation; existing blocks are never resized
+    if (m_pFirst)
+    {
+        goto lExit;
+    }
+
+    VN( m_pFirst = new CDataBlock() );
+    if (m_IsAligned)
+    {
+        m_pFirst->EnableAlignment();
+    }
+    m_pLast = m_pFirst;
+
+    VH( m_pFirst->Reserve(bufferSize) );
+
+lExit:
+    return hr;
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 
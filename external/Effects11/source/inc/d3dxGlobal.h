@@ -577,6 +577,9 @@ public:
     // Allocate reserves bufferSize bytes of contiguous memory and returns a pointer to the user
     void*   Allocate(_In_ uint32_t bufferSize, _Outptr_ CDataBlock **ppBlock);
 
+    // Reserve sizes a brand new block up front so later AddData/Allocate calls don't spill
+    HRESULT Reserve(_In_ uint32_t bufferSize);
+
     void    EnableAlignment();
 
     CDataBlock();
@@ -610,6 +613,9 @@ public:
     // Memory allocator support
     void*   Allocate(_In_ uint32_t bufferSize);
     uint32_t GetSize();
+
+    // Pre-sizes the first block; a store filled from data of known size then lives in a single allocation
+    HRESULT Reserve(_In_ uint32_t bufferSize);
     void    EnableAlignment();
 
     CDataBlockStore();